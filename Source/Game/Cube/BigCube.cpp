@@ -2,5 +2,5 @@
 
 void BigCube::Update(_In_ FLOAT deltaTime)
 {
-    m_world = XMMatrixRotationY(deltaTime);
+    SetWorldMatrix(XMMatrixRotationY(deltaTime));
 }
\ No newline at end of file
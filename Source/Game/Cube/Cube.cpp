@@ -36,7 +36,7 @@ HRESULT Cube::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* p
   Args:     FLOAT deltaTime
               Elapsed time
 
-  Modifies: [m_world].
+  Modifies: [m_transform].
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 void Cube::Update(_In_ FLOAT deltaTime)
 {
@@ -16,5 +16,5 @@ void CustomCube::Update(_In_ FLOAT deltaTime)
 	XMMATRIX mTranslate = XMMatrixTranslation(4.0f, 0.0f, 0.0f);
 	XMMATRIX mScale = XMMatrixScaling(0.5f, 0.5f, 0.3f);
 
-	m_world = mScale * mSpin * mTranslate * mOrbit;
+	SetWorldMatrix(mScale * mSpin * mTranslate * mOrbit);
 }
\ No newline at end of file
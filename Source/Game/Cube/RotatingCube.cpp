@@ -8,9 +8,5 @@ RotatingCube::RotatingCube(const XMFLOAT4& outputColor)
 void RotatingCube::Update(_In_ FLOAT deltaTime)
 {
     // Rotate cube around the origin
-    static FLOAT t = 0.0f;
-    t += deltaTime;
-
-    XMMATRIX rotate = XMMatrixRotationY(-2.0f * deltaTime);
-    m_world = m_world * rotate;
+    RotateY(-2.0f * deltaTime);
 }
\ No newline at end of file
@@ -7,5 +7,5 @@ void SmallCube::Update(_In_ FLOAT deltaTime)
 	XMMATRIX mTranslate = XMMatrixTranslation(-4.0f, 0.0f, 0.0f);
 	XMMATRIX mScale = XMMatrixScaling(0.3f, 0.3f, 0.3f);
 
-	m_world = mScale * mSpin * mTranslate * mOrbit;
+	SetWorldMatrix(mScale * mSpin * mTranslate * mOrbit);
 }
\ No newline at end of file
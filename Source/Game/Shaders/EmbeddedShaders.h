@@ -0,0 +1,254 @@
+/*+===================================================================
+  File:      EMBEDDEDSHADERS.H
+
+  Summary:   EmbeddedShaders header file contains the table of the
+             shader bytecode compiled into the executable, and the
+             function creating the shaders of the game from it. The
+             bytecode headers are generated by the CompileEmbeddedShaders
+             build step when EMBEDDED_SHADERS is defined; otherwise
+             shaders are compiled from the .fxh files at runtime.
+
+  Classes: EmbeddedShader, ShaderEntryPoint
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <span>
+#include <string_view>
+
+#include "Shader/ShaderPermutation.h"
+
+#ifdef EMBEDDED_SHADERS
+#include "EmbeddedShaders/g_VSPhong.h"
+#include "EmbeddedShaders/g_VSPhongShadows.h"
+#include "EmbeddedShaders/g_VSPhongNormalMapShadows.h"
+#include "EmbeddedShaders/g_VSPhongShadowsPacked.h"
+#include "EmbeddedShaders/g_VSPhongNormalMapShadowsPacked.h"
+#include "EmbeddedShaders/g_PSPhong.h"
+#include "EmbeddedShaders/g_PSPhongShadows.h"
+#include "EmbeddedShaders/g_PSPhongNormalMapShadows.h"
+#include "EmbeddedShaders/g_VSLightCube.h"
+#include "EmbeddedShaders/g_PSLightCube.h"
+#include "EmbeddedShaders/g_VSVoxel.h"
+#include "EmbeddedShaders/g_VSVoxelShadows.h"
+#include "EmbeddedShaders/g_VSVoxelNormalMapShadows.h"
+#include "EmbeddedShaders/g_PSVoxel.h"
+#include "EmbeddedShaders/g_PSVoxelShadows.h"
+#include "EmbeddedShaders/g_PSVoxelNormalMapShadows.h"
+#include "EmbeddedShaders/g_VSCubeMap.h"
+#include "EmbeddedShaders/g_PSCubeMap.h"
+#include "EmbeddedShaders/g_VSEnvironmentMap.h"
+#include "EmbeddedShaders/g_VSEnvironmentMapShadows.h"
+#include "EmbeddedShaders/g_VSEnvironmentMapNormalMapShadows.h"
+#include "EmbeddedShaders/g_PSEnvironmentMap.h"
+#include "EmbeddedShaders/g_PSEnvironmentMapShadows.h"
+#include "EmbeddedShaders/g_PSEnvironmentMapNormalMapShadows.h"
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   EmbeddedShader
+
+  Summary:  Bytecode of one permutation of an entry point. Features
+            of 0 is the default permutation
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct EmbeddedShader
+{
+    std::string_view szEntryPoint;
+    UINT uFeatures;
+    std::span<const BYTE> bytecode;
+};
+
+constexpr const UINT EMBEDDED_SHADOWS = static_cast<UINT>(library::eShaderFeature::SHADOWS);
+constexpr const UINT EMBEDDED_NORMAL_MAP_SHADOWS = static_cast<UINT>(library::eShaderFeature::NORMAL_MAP) | EMBEDDED_SHADOWS;
+constexpr const UINT EMBEDDED_SHADOWS_PACKED = static_cast<UINT>(library::eShaderFeature::PACKED_VERTICES) | EMBEDDED_SHADOWS;
+constexpr const UINT EMBEDDED_NORMAL_MAP_SHADOWS_PACKED = static_cast<UINT>(library::eShaderFeature::PACKED_VERTICES) | EMBEDDED_NORMAL_MAP_SHADOWS;
+
+// Has to match the EmbeddedShader items of Game.vcxproj. The light cube
+// and sky box shaders do not read SHADOWS, so their SHADOWS permutation
+// reuses the default bytecode
+constexpr const EmbeddedShader EMBEDDED_SHADER_TABLE[] =
+{
+    { "VSPhong", 0u, g_VSPhong },
+    { "VSPhong", EMBEDDED_SHADOWS, g_VSPhongShadows },
+    { "VSPhong", EMBEDDED_NORMAL_MAP_SHADOWS, g_VSPhongNormalMapShadows },
+    { "VSPhong", EMBEDDED_SHADOWS_PACKED, g_VSPhongShadowsPacked },
+    { "VSPhong", EMBEDDED_NORMAL_MAP_SHADOWS_PACKED, g_VSPhongNormalMapShadowsPacked },
+    { "PSPhong", 0u, g_PSPhong },
+    { "PSPhong", EMBEDDED_SHADOWS, g_PSPhongShadows },
+    { "PSPhong", EMBEDDED_NORMAL_MAP_SHADOWS, g_PSPhongNormalMapShadows },
+    { "VSLightCube", 0u, g_VSLightCube },
+    { "VSLightCube", EMBEDDED_SHADOWS, g_VSLightCube },
+    { "PSLightCube", 0u, g_PSLightCube },
+    { "PSLightCube", EMBEDDED_SHADOWS, g_PSLightCube },
+    { "VSVoxel", 0u, g_VSVoxel },
+    { "VSVoxel", EMBEDDED_SHADOWS, g_VSVoxelShadows },
+    { "VSVoxel", EMBEDDED_NORMAL_MAP_SHADOWS, g_VSVoxelNormalMapShadows },
+    { "PSVoxel", 0u, g_PSVoxel },
+    { "PSVoxel", EMBEDDED_SHADOWS, g_PSVoxelShadows },
+    { "PSVoxel", EMBEDDED_NORMAL_MAP_SHADOWS, g_PSVoxelNormalMapShadows },
+    { "VSCubeMap", 0u, g_VSCubeMap },
+    { "VSCubeMap", EMBEDDED_SHADOWS, g_VSCubeMap },
+    { "PSCubeMap", 0u, g_PSCubeMap },
+    { "PSCubeMap", EMBEDDED_SHADOWS, g_PSCubeMap },
+    { "VSEnvironmentMap", 0u, g_VSEnvironmentMap },
+    { "VSEnvironmentMap", EMBEDDED_SHADOWS, g_VSEnvironmentMapShadows },
+    { "VSEnvironmentMap", EMBEDDED_NORMAL_MAP_SHADOWS, g_VSEnvironmentMapNormalMapShadows },
+    { "PSEnvironmentMap", 0u, g_PSEnvironmentMap },
+    { "PSEnvironmentMap", EMBEDDED_SHADOWS, g_PSEnvironmentMapShadows },
+    { "PSEnvironmentMap", EMBEDDED_NORMAL_MAP_SHADOWS, g_PSEnvironmentMapNormalMapShadows },
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: FindEmbeddedShader
+
+  Summary:  Looks up the bytecode of an entry point. Usable in
+            constant expressions
+
+  Args:     std::string_view szEntryPoint
+              Name of the entry point
+            UINT uFeatures
+              Features of the permutation
+
+  Returns:  std::span<const BYTE>
+              Bytecode, empty if it was not embedded
+-----------------------------------------------------------------F-F*/
+constexpr std::span<const BYTE> FindEmbeddedShader(_In_ std::string_view szEntryPoint, _In_ UINT uFeatures = 0u)
+{
+    for (const EmbeddedShader& embeddedShader : EMBEDDED_SHADER_TABLE)
+    {
+        if (embeddedShader.szEntryPoint == szEntryPoint && embeddedShader.uFeatures == uFeatures)
+        {
+            return embeddedShader.bytecode;
+        }
+    }
+
+    return {};
+}
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   EmbeddedShaderRequest
+
+  Summary:  Permutations the renderables of the game may ask an entry
+            point for: the required features plus any subset of the
+            optional ones
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct EmbeddedShaderRequest
+{
+    std::string_view szEntryPoint;
+    UINT uRequiredFeatures;
+    UINT uOptionalFeatures;
+};
+
+constexpr const UINT EMBEDDED_NORMAL_MAP = static_cast<UINT>(library::eShaderFeature::NORMAL_MAP);
+constexpr const UINT EMBEDDED_PACKED = static_cast<UINT>(library::eShaderFeature::PACKED_VERTICES);
+
+// Renderable::GetPermutation always enables SHADOWS and adds NORMAL_MAP
+// for normal mapped meshes, Model adds PACKED_VERTICES, and pixel shaders
+// never see PACKED_VERTICES. Has to cover the scene built by Main.cpp
+constexpr const EmbeddedShaderRequest EMBEDDED_SHADER_REQUESTS[] =
+{
+    { "VSPhong", EMBEDDED_SHADOWS, EMBEDDED_NORMAL_MAP | EMBEDDED_PACKED },
+    { "PSPhong", EMBEDDED_SHADOWS, EMBEDDED_NORMAL_MAP },
+    { "VSLightCube", EMBEDDED_SHADOWS, 0u },
+    { "PSLightCube", EMBEDDED_SHADOWS, 0u },
+    { "VSVoxel", EMBEDDED_SHADOWS, EMBEDDED_NORMAL_MAP },
+    { "PSVoxel", EMBEDDED_SHADOWS, EMBEDDED_NORMAL_MAP },
+    { "VSCubeMap", EMBEDDED_SHADOWS, 0u },
+    { "PSCubeMap", EMBEDDED_SHADOWS, 0u },
+    { "VSEnvironmentMap", EMBEDDED_SHADOWS, EMBEDDED_NORMAL_MAP },
+    { "PSEnvironmentMap", EMBEDDED_SHADOWS, EMBEDDED_NORMAL_MAP },
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: IsEveryRequestEmbedded
+
+  Summary:  Returns whether every permutation of
+            EMBEDDED_SHADER_REQUESTS has bytecode in
+            EMBEDDED_SHADER_TABLE
+
+  Returns:  BOOL
+              TRUE if nothing is missing
+-----------------------------------------------------------------F-F*/
+consteval BOOL IsEveryRequestEmbedded()
+{
+    for (const EmbeddedShaderRequest& request : EMBEDDED_SHADER_REQUESTS)
+    {
+        // Walks every subset of the optional features
+        UINT uOptionalFeatures = request.uOptionalFeatures;
+        do
+        {
+            if (FindEmbeddedShader(request.szEntryPoint, request.uRequiredFeatures | uOptionalFeatures).empty())
+            {
+                return FALSE;
+            }
+            uOptionalFeatures = (uOptionalFeatures - 1u) & request.uOptionalFeatures;
+        } while (uOptionalFeatures != request.uOptionalFeatures);
+    }
+
+    return TRUE;
+}
+
+static_assert(IsEveryRequestEmbedded(), "A permutation of EMBEDDED_SHADER_REQUESTS is not in EMBEDDED_SHADER_TABLE");
+#endif
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   ShaderEntryPoint
+
+  Summary:  Name of an entry point, checked at compile time. When the
+            bytecode is embedded, naming an entry point missing from
+            the table fails the build
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct ShaderEntryPoint
+{
+    consteval ShaderEntryPoint(_In_ PCSTR pszEntryPoint)
+        : pszName(pszEntryPoint)
+    {
+#ifdef EMBEDDED_SHADERS
+        if (FindEmbeddedShader(pszEntryPoint).empty())
+        {
+            throw "The entry point is not in EMBEDDED_SHADER_TABLE";
+        }
+#endif
+    }
+
+    PCSTR pszName;
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: CreateShader
+
+  Summary:  Creates a shader from the embedded bytecode and its
+            permutations, or from the shader file
+
+  Args:     PCWSTR pszFileName
+              Name of the file that contains the shader code
+            ShaderEntryPoint entryPoint
+              Name of the shader entry point
+            PCSTR pszShaderModel
+              Shader target
+
+  Returns:  std::shared_ptr<T>
+              Shader
+-----------------------------------------------------------------F-F*/
+template <class T>
+std::shared_ptr<T> CreateShader(_In_ PCWSTR pszFileName, _In_ ShaderEntryPoint entryPoint, _In_ PCSTR pszShaderModel)
+{
+#ifdef EMBEDDED_SHADERS
+    UNREFERENCED_PARAMETER(pszFileName);
+
+    std::shared_ptr<T> shader = std::make_shared<T>(FindEmbeddedShader(entryPoint.pszName), entryPoint.pszName, pszShaderModel);
+    for (const EmbeddedShader& embeddedShader : EMBEDDED_SHADER_TABLE)
+    {
+        if (embeddedShader.uFeatures != 0u && embeddedShader.szEntryPoint == entryPoint.pszName)
+        {
+            shader->AddPermutation(library::ShaderPermutation(embeddedShader.uFeatures, NUM_LIGHTS), embeddedShader.bytecode);
+        }
+    }
+
+    return shader;
+#else
+    return std::make_shared<T>(pszFileName, entryPoint.pszName, pszShaderModel);
+#endif
+}
@@ -41,6 +41,7 @@
 #include <vector>
 
 #include "Resource.h"
+#include "Scene/BlockType.h"
 
 constexpr LPCWSTR PSZ_COURSE_TITLE = L"Game Graphics Programming";
 
@@ -67,35 +68,14 @@ namespace library
 
     /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
         Struct:   MouseRelativeMovement
-        Summary:  Data structure that stores mouse relative movement data
+        Summary:  Data structure that stores mouse relative movement data,
+                  and the buttons pressed since it was last reset
     S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
     struct MouseRelativeMovement
     {
         LONG X;
         LONG Y;
-    };
-
-    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
-        Enum:     eBlockType
-        Summary:  Enumeration of block types
-    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
-    enum class eBlockType : CHAR
-    {
-        GRASSLAND = 21,
-        SNOW,
-        OCEAN,
-        SAND,
-        SCORCHED,
-        BARE,
-        TUNDRA,
-        TEMPERATE_DESERT,
-        SHRUBLAND,
-        TAIGA,
-        TEMPERATE_DECIDUOUS_FOREST,
-        TEMPERATE_RAIN_FOREST,
-        SUBTROPICAL_DESERT,
-        TROPICAL_SEASONAL_FOREST,
-        TROPICAL_RAIN_FOREST,
-        COUNT,
+        BOOL bLeftClick;
+        BOOL bRightClick;
     };
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Game/Game.h"
 
+#include "Utility/Profiler.h"
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -10,12 +12,14 @@ namespace library
       Args:     PCWSTR pszGameName
                   Name of the game
 
-      Modifies: [m_pszGameName, m_mainWindow, m_renderer].
+      Modifies: [m_pszGameName, m_mainWindow, m_renderer,
+                 m_simulation].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Game::Game(_In_ PCWSTR pszGameName)
         : m_pszGameName(pszGameName)
         , m_mainWindow(std::make_unique<MainWindow>())
         , m_renderer(std::make_unique<Renderer>())
+        , m_simulation(std::make_unique<SimulationLoop>(DEFAULT_TICK_RATE, DEFAULT_MAX_TICKS_PER_FRAME))
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -36,6 +40,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Game::Initialize(_In_ HINSTANCE hInstance, _In_ INT nCmdShow)
     {
+        Profiler::SetThreadName("Main");
+#if defined(_DEBUG) || defined(PROFILE)
+        Profiler::SetEnabled(true);
+#endif
+
         HRESULT hr = m_mainWindow->Initialize(hInstance, nCmdShow, m_pszGameName);
 
         if (FAILED(hr))
@@ -56,7 +65,11 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Game::Run
 
-      Summary:  Runs the game loop
+      Summary:  Runs the game loop. Input and the camera follow the
+                frame rate, the scene is simulated in fixed ticks and
+                drawn interpolated between its last two ticks. Debug
+                and PROFILE builds write the profile of the last frames
+                to Profile.json on exit
 
       Returns:  INT
                   Status code to return to the operating system
@@ -72,6 +85,12 @@ namespace library
         QueryPerformanceFrequency(&frequency);
         QueryPerformanceCounter(&startingTime);
 
+        // Ticks run on this thread, inside Pump, since the scene is also read by the renderer
+        m_simulation->SetTickFunction([this](double tickSeconds)
+        {
+            m_renderer->Tick(static_cast<FLOAT>(tickSeconds));
+        });
+
         // message loop
         MSG msg = { 0 };
         while (WM_QUIT != msg.message)
@@ -83,6 +102,8 @@ namespace library
             }
             else
             {
+                PROFILE_ZONE("Frame");
+
                 QueryPerformanceCounter(&endingTime);
                 elapsedTime = (FLOAT)(endingTime.QuadPart - startingTime.QuadPart) / (FLOAT)(frequency.QuadPart);
 
@@ -92,10 +113,33 @@ namespace library
 
                 m_mainWindow->ResetMouseMovement();
                 m_renderer->Update(elapsedTime);
-                m_renderer->Render();
+                m_simulation->Pump();
+                m_renderer->Render(static_cast<FLOAT>(m_simulation->GetAlpha()));
             }
         }
 
+        SkinningStats skinningStats = m_renderer->GetSkinningStats();
+        if (skinningStats.uNumSkinnedDraws > 0ull)
+        {
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"Skinning: %llu draws, %llu bytes uploaded per draw instead of %llu\n",
+                skinningStats.uNumSkinnedDraws,
+                skinningStats.uUploadedBytes / skinningStats.uNumSkinnedDraws,
+                skinningStats.uFullPaletteBytes / skinningStats.uNumSkinnedDraws
+            );
+            OutputDebugString(szMessage);
+        }
+
+#if defined(_DEBUG) || defined(PROFILE)
+        // Last frames of the session, open in chrome://tracing or Perfetto
+        if (!Profiler::ExportChromeTrace(L"Profile.json"))
+        {
+            OutputDebugString(L"Can't write the profile to Profile.json\n");
+        }
+#endif
+
         return static_cast<INT>(msg.wParam);
     }
 
@@ -137,4 +181,18 @@ namespace library
     {
         return m_renderer;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Game::GetSimulation
+
+      Summary:  Returns the fixed-timestep simulation loop, to change
+                its tick rate or catch-up limit
+
+      Returns:  std::unique_ptr<SimulationLoop>&
+                  The simulation loop
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::unique_ptr<SimulationLoop>& Game::GetSimulation()
+    {
+        return m_simulation;
+    }
 }
\ No newline at end of file
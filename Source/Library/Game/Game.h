@@ -14,6 +14,7 @@
 #include "Common.h"
 
 #include "Renderer/Renderer.h"
+#include "Utility/FixedTimestep.h"
 #include "Window/MainWindow.h"
 
 namespace library
@@ -35,6 +36,9 @@ namespace library
                 GetRenderer
                   Returns the reference to the unique pointer to the 
                   renderer
+                GetSimulation
+                  Returns the reference to the unique pointer to the
+                  fixed-timestep simulation loop
                 Game
                   Constructor.
                 ~Game
@@ -56,9 +60,14 @@ namespace library
         PCWSTR GetGameName() const;
         std::unique_ptr<MainWindow>& GetWindow();
         std::unique_ptr<Renderer>& GetRenderer();
+        std::unique_ptr<SimulationLoop>& GetSimulation();
+
+        static constexpr double DEFAULT_TICK_RATE = 60.0;
+        static constexpr uint32_t DEFAULT_MAX_TICKS_PER_FRAME = 5u;
     private:
         PCWSTR m_pszGameName;
         std::unique_ptr<MainWindow> m_mainWindow;
         std::unique_ptr<Renderer> m_renderer;
+        std::unique_ptr<SimulationLoop> m_simulation;
     };
 }
\ No newline at end of file
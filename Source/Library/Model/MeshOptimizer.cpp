@@ -0,0 +1,502 @@
+#include "Model/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "Utility/Hash.h"
+
+namespace library
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FileHeader
+          Summary:  Header of a mesh cache file
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FileHeader
+        {
+            uint32_t uMagic;
+            uint32_t uVersion;
+            uint32_t uNumVertices;
+            uint32_t uNumIndices;
+            uint64_t uKey;
+            uint64_t uChecksum;
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: hashCacheData
+          Summary:  Checksum of the renumbering and the indices
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        uint64_t hashCacheData(const std::vector<uint32_t>& auRemap, const std::vector<uint16_t>& aIndices)
+        {
+            uint64_t uHash = Hash::Fnv1a(auRemap.data(), auRemap.size() * sizeof(uint32_t));
+            return Hash::Fnv1a(aIndices.data(), aIndices.size() * sizeof(uint16_t), uHash);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeVertexCache
+      Summary:  Reorders the triangles with Tipsify. The triangles
+                around the current fan vertex are emitted, then the
+                next fan vertex is the one of them that will still be
+                in the cache after its remaining triangles are drawn
+                and entered it earliest. When no such vertex exists the
+                fan restarts from the last vertices emitted, or from
+                the next vertex in input order, and a new run begins
+      Args:     uint16_t* aIndices
+                  Triangle list, reordered in place
+                uint32_t uNumIndices
+                  Number of indices
+                uint32_t uNumVertices
+                  Number of vertices the indices refer to
+                std::vector<uint32_t>& auClusters
+                  First triangle of every run, starting with 0
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeVertexCache(uint16_t* aIndices, uint32_t uNumIndices, uint32_t uNumVertices, std::vector<uint32_t>& auClusters)
+    {
+        auClusters.clear();
+
+        const uint32_t uNumTriangles = uNumIndices / 3u;
+        if (uNumTriangles == 0u)
+        {
+            return;
+        }
+
+        // Triangles of every vertex, in input order
+        std::vector<uint32_t> auLiveCounts(uNumVertices, 0u);
+        for (uint32_t i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            ++auLiveCounts[aIndices[i]];
+        }
+
+        std::vector<uint32_t> auOffsets(uNumVertices + 1u, 0u);
+        for (uint32_t v = 0u; v < uNumVertices; ++v)
+        {
+            auOffsets[v + 1u] = auOffsets[v] + auLiveCounts[v];
+        }
+
+        std::vector<uint32_t> auAdjacency(uNumTriangles * 3u);
+        std::vector<uint32_t> auFill(auOffsets.begin(), auOffsets.end() - 1);
+        for (uint32_t i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            auAdjacency[auFill[aIndices[i]]++] = i / 3u;
+        }
+
+        std::vector<uint32_t> auTimestamps(uNumVertices, 0u);
+        std::vector<uint8_t> aIsEmitted(uNumTriangles, 0u);
+        std::vector<uint32_t> auDeadEnds;
+        std::vector<uint32_t> auCandidates;
+        std::vector<uint16_t> aOutput;
+        aOutput.reserve(uNumTriangles * 3u);
+
+        uint32_t uTime = CACHE_SIZE + 1u;
+        uint32_t uCursor = 0u;
+
+        const auto skipDeadEnd = [&]()
+        {
+            while (!auDeadEnds.empty())
+            {
+                uint32_t uVertex = auDeadEnds.back();
+                auDeadEnds.pop_back();
+                if (auLiveCounts[uVertex] > 0u)
+                {
+                    return uVertex;
+                }
+            }
+
+            for (; uCursor < uNumVertices; ++uCursor)
+            {
+                if (auLiveCounts[uCursor] > 0u)
+                {
+                    return uCursor;
+                }
+            }
+
+            return INVALID_INDEX;
+        };
+
+        auClusters.push_back(0u);
+        uint32_t uFanning = skipDeadEnd();
+
+        while (uFanning != INVALID_INDEX)
+        {
+            auCandidates.clear();
+
+            for (uint32_t k = auOffsets[uFanning]; k < auOffsets[uFanning + 1u]; ++k)
+            {
+                uint32_t uTriangle = auAdjacency[k];
+                if (aIsEmitted[uTriangle])
+                {
+                    continue;
+                }
+
+                for (uint32_t c = 0u; c < 3u; ++c)
+                {
+                    uint16_t uVertex = aIndices[uTriangle * 3u + c];
+                    aOutput.push_back(uVertex);
+                    auDeadEnds.push_back(uVertex);
+                    auCandidates.push_back(uVertex);
+                    --auLiveCounts[uVertex];
+
+                    if (uTime - auTimestamps[uVertex] > CACHE_SIZE)
+                    {
+                        auTimestamps[uVertex] = uTime++;
+                    }
+                }
+
+                aIsEmitted[uTriangle] = 1u;
+            }
+
+            uint32_t uNext = INVALID_INDEX;
+            int32_t bestPriority = -1;
+            for (uint32_t uVertex : auCandidates)
+            {
+                if (auLiveCounts[uVertex] == 0u)
+                {
+                    continue;
+                }
+
+                // Vertices that would leave the cache before their fan is done are worth the least
+                int32_t priority = 0;
+                if (uTime - auTimestamps[uVertex] + 2u * auLiveCounts[uVertex] <= CACHE_SIZE)
+                {
+                    priority = static_cast<int32_t>(uTime - auTimestamps[uVertex]);
+                }
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    uNext = uVertex;
+                }
+            }
+
+            if (uNext == INVALID_INDEX)
+            {
+                uNext = skipDeadEnd();
+                if (uNext != INVALID_INDEX)
+                {
+                    auClusters.push_back(static_cast<uint32_t>(aOutput.size() / 3u));
+                }
+            }
+
+            uFanning = uNext;
+        }
+
+        std::copy(aOutput.begin(), aOutput.end(), aIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeOverdraw
+      Summary:  Sorts the runs of triangles by how much they face away
+                from the center of the mesh, measured as the dot
+                product of their mean normal with the offset of their
+                centroid. Runs on the outside are drawn first, so the
+                depth test rejects more of the pixels behind them. The
+                order inside a run is kept for the vertex cache
+      Args:     const SimpleVertex* aVertices
+                  Vertices the indices refer to
+                uint16_t* aIndices
+                  Triangle list, reordered in place
+                uint32_t uNumIndices
+                  Number of indices
+                const std::vector<uint32_t>& auClusters
+                  First triangle of every run, from OptimizeVertexCache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeOverdraw(const SimpleVertex* aVertices, uint16_t* aIndices, uint32_t uNumIndices, const std::vector<uint32_t>& auClusters)
+    {
+        const uint32_t uNumTriangles = uNumIndices / 3u;
+        const uint32_t uNumClusters = static_cast<uint32_t>(auClusters.size());
+        if (uNumClusters < 2u)
+        {
+            return;
+        }
+
+        // Area weighted centroid and normal of every run, and of the whole mesh
+        std::vector<double> aClusterData(uNumClusters * 7u, 0.0);
+        double meshCentroid[3] = { 0.0, 0.0, 0.0 };
+        double meshArea = 0.0;
+
+        for (uint32_t uCluster = 0u; uCluster < uNumClusters; ++uCluster)
+        {
+            uint32_t uEnd = uCluster + 1u < uNumClusters ? auClusters[uCluster + 1u] : uNumTriangles;
+            double* data = &aClusterData[uCluster * 7u];
+
+            for (uint32_t t = auClusters[uCluster]; t < uEnd; ++t)
+            {
+                const XMFLOAT3& p0 = aVertices[aIndices[t * 3u]].Position;
+                const XMFLOAT3& p1 = aVertices[aIndices[t * 3u + 1u]].Position;
+                const XMFLOAT3& p2 = aVertices[aIndices[t * 3u + 2u]].Position;
+
+                const double e1[3] = { static_cast<double>(p1.x) - p0.x, static_cast<double>(p1.y) - p0.y, static_cast<double>(p1.z) - p0.z };
+                const double e2[3] = { static_cast<double>(p2.x) - p0.x, static_cast<double>(p2.y) - p0.y, static_cast<double>(p2.z) - p0.z };
+                const double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+                const double area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                const double centroid[3] =
+                {
+                    (static_cast<double>(p0.x) + p1.x + p2.x) / 3.0,
+                    (static_cast<double>(p0.y) + p1.y + p2.y) / 3.0,
+                    (static_cast<double>(p0.z) + p1.z + p2.z) / 3.0
+                };
+
+                for (uint32_t k = 0u; k < 3u; ++k)
+                {
+                    data[k] += centroid[k] * area;
+                    data[3u + k] += n[k];
+                    meshCentroid[k] += centroid[k] * area;
+                }
+                data[6] += area;
+                meshArea += area;
+            }
+        }
+
+        if (meshArea <= 0.0)
+        {
+            return;
+        }
+
+        for (uint32_t k = 0u; k < 3u; ++k)
+        {
+            meshCentroid[k] /= meshArea;
+        }
+
+        std::vector<double> aSortKeys(uNumClusters, 0.0);
+        for (uint32_t uCluster = 0u; uCluster < uNumClusters; ++uCluster)
+        {
+            const double* data = &aClusterData[uCluster * 7u];
+            const double normalLength = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+            if (data[6] <= 0.0 || normalLength <= 0.0)
+            {
+                continue;
+            }
+
+            for (uint32_t k = 0u; k < 3u; ++k)
+            {
+                aSortKeys[uCluster] += (data[k] / data[6] - meshCentroid[k]) * data[3u + k] / normalLength;
+            }
+        }
+
+        std::vector<uint32_t> auOrder(uNumClusters);
+        for (uint32_t uCluster = 0u; uCluster < uNumClusters; ++uCluster)
+        {
+            auOrder[uCluster] = uCluster;
+        }
+        std::stable_sort(auOrder.begin(), auOrder.end(), [&](uint32_t a, uint32_t b)
+        {
+            return aSortKeys[a] > aSortKeys[b];
+        });
+
+        std::vector<uint16_t> aOutput;
+        aOutput.reserve(uNumTriangles * 3u);
+        for (uint32_t uCluster : auOrder)
+        {
+            uint32_t uEnd = uCluster + 1u < uNumClusters ? auClusters[uCluster + 1u] : uNumTriangles;
+            aOutput.insert(aOutput.end(), aIndices + auClusters[uCluster] * 3u, aIndices + uEnd * 3u);
+        }
+
+        std::copy(aOutput.begin(), aOutput.end(), aIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeVertexFetch
+      Summary:  Renumbers the vertices in the order the triangles first
+                use them, so the vertex fetch walks memory forward.
+                Vertices no triangle uses are moved to the end
+      Args:     uint16_t* aIndices
+                  Triangle list, renumbered in place
+                uint32_t uNumIndices
+                  Number of indices
+                uint32_t uNumVertices
+                  Number of vertices the indices refer to
+                std::vector<uint32_t>& auRemap
+                  New index of every old vertex
+      Returns:  uint32_t
+                  Number of vertices the triangles use
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t MeshOptimizer::OptimizeVertexFetch(uint16_t* aIndices, uint32_t uNumIndices, uint32_t uNumVertices, std::vector<uint32_t>& auRemap)
+    {
+        auRemap.assign(uNumVertices, INVALID_INDEX);
+
+        uint32_t uNumUsed = 0u;
+        for (uint32_t i = 0u; i < uNumIndices; ++i)
+        {
+            uint32_t& uNewIndex = auRemap[aIndices[i]];
+            if (uNewIndex == INVALID_INDEX)
+            {
+                uNewIndex = uNumUsed++;
+            }
+            aIndices[i] = static_cast<uint16_t>(uNewIndex);
+        }
+
+        uint32_t uNext = uNumUsed;
+        for (uint32_t& uNewIndex : auRemap)
+        {
+            if (uNewIndex == INVALID_INDEX)
+            {
+                uNewIndex = uNext++;
+            }
+        }
+
+        return uNumUsed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::AnalyzeVertexCache
+      Summary:  Runs an index list through a FIFO post-transform cache
+                and counts the vertices it has to transform
+      Args:     const uint16_t* aIndices
+                  Triangle list
+                uint32_t uNumIndices
+                  Number of indices
+                uint32_t uNumVertices
+                  Number of vertices the indices refer to
+                uint32_t uCacheSize
+                  Number of entries of the cache
+      Returns:  VertexCacheStats
+                  Transforms, ACMR and ATVR
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint16_t* aIndices, uint32_t uNumIndices, uint32_t uNumVertices, uint32_t uCacheSize)
+    {
+        std::vector<uint32_t> auTimestamps(uNumVertices, 0u);
+        std::vector<uint8_t> aIsUsed(uNumVertices, 0u);
+        uint32_t uTime = uCacheSize + 1u;
+        uint32_t uNumTransforms = 0u;
+        uint32_t uNumUsed = 0u;
+
+        for (uint32_t i = 0u; i < uNumIndices; ++i)
+        {
+            uint16_t uVertex = aIndices[i];
+            if (uTime - auTimestamps[uVertex] > uCacheSize)
+            {
+                auTimestamps[uVertex] = uTime++;
+                ++uNumTransforms;
+            }
+
+            if (!aIsUsed[uVertex])
+            {
+                aIsUsed[uVertex] = 1u;
+                ++uNumUsed;
+            }
+        }
+
+        const uint32_t uNumTriangles = uNumIndices / 3u;
+        return VertexCacheStats
+        {
+            .uNumTransforms = uNumTransforms,
+            .acmr = uNumTriangles > 0u ? static_cast<float>(uNumTransforms) / static_cast<float>(uNumTriangles) : 0.0f,
+            .atvr = uNumUsed > 0u ? static_cast<float>(uNumTransforms) / static_cast<float>(uNumUsed) : 0.0f
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::LoadCache
+      Summary:  Reads the optimized indices and vertex renumbering of a
+                model. The file must carry the key of the imported data
+                and an intact checksum
+      Args:     const std::filesystem::path& filePath
+                  Path to the cache file
+                uint64_t uKey
+                  Hash of the imported vertices, indices and meshes
+                std::vector<uint32_t>& auRemap
+                  New index of every old vertex
+                std::vector<uint16_t>& aIndices
+                  Optimized index buffer
+      Returns:  bool
+                  true if the file existed and was valid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool MeshOptimizer::LoadCache(const std::filesystem::path& filePath, uint64_t uKey, std::vector<uint32_t>& auRemap, std::vector<uint16_t>& aIndices)
+    {
+        auRemap.clear();
+        aIndices.clear();
+
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        FileHeader header = {};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.uMagic != FILE_MAGIC || header.uVersion != FILE_VERSION || header.uKey != uKey)
+        {
+            return false;
+        }
+
+        auRemap.resize(header.uNumVertices);
+        aIndices.resize(header.uNumIndices);
+        file.read(reinterpret_cast<char*>(auRemap.data()), static_cast<std::streamsize>(auRemap.size() * sizeof(uint32_t)));
+        file.read(reinterpret_cast<char*>(aIndices.data()), static_cast<std::streamsize>(aIndices.size() * sizeof(uint16_t)));
+        if (!file || hashCacheData(auRemap, aIndices) != header.uChecksum)
+        {
+            auRemap.clear();
+            aIndices.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::SaveCache
+      Summary:  Writes the optimized indices and vertex renumbering of a
+                model to a temporary file and moves it over the cache
+                file, so a crash never leaves half a file behind
+      Args:     const std::filesystem::path& filePath
+                  Path to the cache file
+                uint64_t uKey
+                  Hash of the imported vertices, indices and meshes
+                const std::vector<uint32_t>& auRemap
+                  New index of every old vertex
+                const std::vector<uint16_t>& aIndices
+                  Optimized index buffer
+      Returns:  bool
+                  true if the file was written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool MeshOptimizer::SaveCache(const std::filesystem::path& filePath, uint64_t uKey, const std::vector<uint32_t>& auRemap, const std::vector<uint16_t>& aIndices)
+    {
+        std::error_code errorCode;
+        if (filePath.has_parent_path())
+        {
+            std::filesystem::create_directories(filePath.parent_path(), errorCode);
+        }
+
+        std::filesystem::path temporaryPath = filePath;
+        temporaryPath += ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return false;
+            }
+
+            FileHeader header =
+            {
+                .uMagic = FILE_MAGIC,
+                .uVersion = FILE_VERSION,
+                .uNumVertices = static_cast<uint32_t>(auRemap.size()),
+                .uNumIndices = static_cast<uint32_t>(aIndices.size()),
+                .uKey = uKey,
+                .uChecksum = hashCacheData(auRemap, aIndices)
+            };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(auRemap.data()), static_cast<std::streamsize>(auRemap.size() * sizeof(uint32_t)));
+            file.write(reinterpret_cast<const char*>(aIndices.data()), static_cast<std::streamsize>(aIndices.size() * sizeof(uint16_t)));
+
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, filePath, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,89 @@
+/*+===================================================================
+  File:      MESHOPTIMIZER.H
+
+  Summary:   MeshOptimizer header file contains declaration of class
+             MeshOptimizer used to reorder the triangles and vertices
+             of a mesh for the post-transform vertex cache, overdraw
+             and vertex fetch, and to keep the result on disk. It only
+             depends on DirectXMath and the standard library.
+
+  Classes:  VertexCacheStats, MeshOptimizer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Renderer/VertexTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VertexCacheStats
+      Summary:  Result of running an index list through a simulated
+                FIFO post-transform cache. ACMR is the number of
+                transformed vertices per triangle, ATVR per vertex used
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VertexCacheStats
+    {
+        uint32_t uNumTransforms;
+        float acmr;
+        float atvr;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshOptimizer
+      Summary:  Import-time mesh optimizations that only change the
+                order of the data, never the image. Triangles are
+                ordered with Tipsify, which fans around the vertex that
+                stays longest in a cache of CACHE_SIZE entries and
+                restarts where a fan ends. The runs between restarts
+                are then sorted so that the ones facing away from the
+                center of the mesh come first and hide the others.
+                Vertices are finally renumbered in the order the
+                triangles first use them. The new indices and the
+                vertex renumbering can be stored in a cache file named
+                after a hash of the imported data, so a model is only
+                optimized the first time it is loaded
+      Methods:  OptimizeVertexCache
+                  Reorders triangles for the post-transform cache
+                OptimizeOverdraw
+                  Reorders the runs of triangles for early depth
+                  rejection
+                OptimizeVertexFetch
+                  Renumbers vertices in first-use order
+                AnalyzeVertexCache
+                  Simulates a FIFO cache over an index list
+                LoadCache
+                  Reads the optimized indices and renumbering
+                SaveCache
+                  Writes the optimized indices and renumbering
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshOptimizer
+    {
+    public:
+        static constexpr const uint32_t CACHE_SIZE = 16u;
+        static constexpr const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+        static constexpr const uint32_t FILE_MAGIC = 0x4F4D5348u; // "HSMO"
+        static constexpr const uint32_t FILE_VERSION = 1u;
+
+    public:
+        MeshOptimizer() = delete;
+        MeshOptimizer(const MeshOptimizer& other) = delete;
+        MeshOptimizer(MeshOptimizer&& other) = delete;
+        MeshOptimizer& operator=(const MeshOptimizer& other) = delete;
+        MeshOptimizer& operator=(MeshOptimizer&& other) = delete;
+        ~MeshOptimizer() = delete;
+
+        static void OptimizeVertexCache(uint16_t* aIndices, uint32_t uNumIndices, uint32_t uNumVertices, std::vector<uint32_t>& auClusters);
+        static void OptimizeOverdraw(const SimpleVertex* aVertices, uint16_t* aIndices, uint32_t uNumIndices, const std::vector<uint32_t>& auClusters);
+        static uint32_t OptimizeVertexFetch(uint16_t* aIndices, uint32_t uNumIndices, uint32_t uNumVertices, std::vector<uint32_t>& auRemap);
+        static VertexCacheStats AnalyzeVertexCache(const uint16_t* aIndices, uint32_t uNumIndices, uint32_t uNumVertices, uint32_t uCacheSize = CACHE_SIZE);
+
+        static bool LoadCache(const std::filesystem::path& filePath, uint64_t uKey, std::vector<uint32_t>& auRemap, std::vector<uint16_t>& aIndices);
+        static bool SaveCache(const std::filesystem::path& filePath, uint64_t uKey, const std::vector<uint32_t>& auRemap, const std::vector<uint16_t>& aIndices);
+    };
+}
@@ -0,0 +1,652 @@
+#include "Model/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace library
+{
+    using namespace DirectX;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::MeshSimplifier
+      Summary:  Constructor. Welds the vertices twice: once by all of
+                their attributes, because an importer may keep a copy of
+                a vertex per triangle corner, and once by position only.
+                A position reached by more than one welded vertex lies
+                on a seam
+      Args:     const SimpleVertex* aVertices
+                  Vertices of the mesh, kept by pointer
+                uint32_t uNumVertices
+                  Number of vertices
+      Modifies: [m_aVertices, m_uNumVertices, m_auCanonical,
+                 m_auPositions, m_aIsSeam].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshSimplifier::MeshSimplifier(const SimpleVertex* aVertices, uint32_t uNumVertices)
+        : m_aVertices(aVertices)
+        , m_uNumVertices(uNumVertices)
+        , m_auCanonical(uNumVertices)
+        , m_auPositions(uNumVertices)
+        , m_aIsSeam(uNumVertices, 0u)
+    {
+        // Keys are the bits of the attributes, so welding never depends on a tolerance
+        std::unordered_map<std::string, uint32_t> vertexIndices;
+        std::unordered_map<std::string, uint32_t> positionIndices;
+        vertexIndices.reserve(uNumVertices);
+        positionIndices.reserve(uNumVertices);
+
+        for (uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            const SimpleVertex& vertex = aVertices[i];
+
+            std::string vertexKey(sizeof(float) * 8u, '\0');
+            std::memcpy(&vertexKey[0], &vertex.Position, sizeof(XMFLOAT3));
+            std::memcpy(&vertexKey[sizeof(XMFLOAT3)], &vertex.TexCoord, sizeof(XMFLOAT2));
+            std::memcpy(&vertexKey[sizeof(XMFLOAT3) + sizeof(XMFLOAT2)], &vertex.Normal, sizeof(XMFLOAT3));
+
+            auto vertexIt = vertexIndices.emplace(vertexKey, i).first;
+            m_auCanonical[i] = vertexIt->second;
+
+            if (vertexIt->second != i)
+            {
+                m_auPositions[i] = m_auPositions[vertexIt->second];
+                continue;
+            }
+
+            auto positionIt = positionIndices.emplace(vertexKey.substr(0u, sizeof(XMFLOAT3)), i).first;
+            m_auPositions[i] = positionIt->second;
+
+            if (positionIt->second != i)
+            {
+                m_aIsSeam[positionIt->second] = 1u;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::Simplify
+      Summary:  Collapses edges until the number of indices reaches the
+                target or no collapse is allowed. Collapses run in
+                passes: each pass finds the cheapest collapse of every
+                position, sorts them by cost and applies those whose
+                neighbourhood no earlier collapse of the pass touched.
+                The surviving triangles keep their order and only refer
+                to vertices of the input
+      Args:     const uint16_t* aIndices
+                  Triangle list of the mesh
+                uint32_t uNumIndices
+                  Number of indices
+                uint32_t uTargetNumIndices
+                  Number of indices to reach
+                std::vector<uint16_t>& aOutIndices
+                  Triangle list of the simpler level
+      Returns:  float
+                  Distance, in model units, of the worst collapse
+                  from the planes it merged; an estimate of how far
+                  the level strays from the original surface
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float MeshSimplifier::Simplify(const uint16_t* aIndices, uint32_t uNumIndices, uint32_t uTargetNumIndices, std::vector<uint16_t>& aOutIndices) const
+    {
+        aOutIndices.clear();
+
+        const uint32_t uNumTriangles = uNumIndices / 3u;
+        std::vector<uint32_t> auCorners(uNumTriangles * 3u);
+        std::vector<uint32_t> auCornerPositions(uNumTriangles * 3u);
+        std::vector<uint8_t> aIsAlive(uNumTriangles, 0u);
+        std::vector<std::vector<uint32_t>> aauTriangles(m_uNumVertices);
+        uint32_t uNumAlive = 0u;
+
+        for (uint32_t t = 0u; t < uNumTriangles; ++t)
+        {
+            for (uint32_t k = 0u; k < 3u; ++k)
+            {
+                const uint32_t uVertex = m_auCanonical[aIndices[t * 3u + k]];
+                auCorners[t * 3u + k] = uVertex;
+                auCornerPositions[t * 3u + k] = m_auPositions[uVertex];
+            }
+
+            const uint32_t* p = &auCornerPositions[t * 3u];
+            if (p[0] == p[1] || p[1] == p[2] || p[2] == p[0])
+            {
+                continue;
+            }
+
+            aIsAlive[t] = 1u;
+            ++uNumAlive;
+            for (uint32_t k = 0u; k < 3u; ++k)
+            {
+                aauTriangles[p[k]].push_back(t);
+            }
+        }
+
+        const uint32_t uTargetNumTriangles = uTargetNumIndices / 3u;
+        if (uNumAlive <= uTargetNumTriangles)
+        {
+            aOutIndices.assign(aIndices, aIndices + uNumTriangles * 3u);
+            return 0.0f;
+        }
+
+        // Directed edges between positions find the open borders and the non-manifold edges
+        std::unordered_map<uint64_t, uint32_t> edgeCounts;
+        edgeCounts.reserve(uNumAlive * 3u);
+        for (uint32_t t = 0u; t < uNumTriangles; ++t)
+        {
+            if (!aIsAlive[t])
+            {
+                continue;
+            }
+
+            for (uint32_t k = 0u; k < 3u; ++k)
+            {
+                const uint64_t uA = auCornerPositions[t * 3u + k];
+                const uint64_t uB = auCornerPositions[t * 3u + (k + 1u) % 3u];
+                ++edgeCounts[(uA << 32u) | uB];
+            }
+        }
+
+        std::vector<Quadric> aQuadrics(m_uNumVertices, Quadric{});
+        std::vector<uint8_t> aIsLocked(m_uNumVertices, 0u);
+        std::vector<uint8_t> aIsRemoved(m_uNumVertices, 0u);
+        std::vector<uint32_t> auBorderNext(m_uNumVertices, INVALID_VERTEX);
+        std::vector<uint32_t> auBorderPrev(m_uNumVertices, INVALID_VERTEX);
+        std::vector<uint32_t> auNumBorderEdges(m_uNumVertices, 0u);
+
+        for (uint32_t t = 0u; t < uNumTriangles; ++t)
+        {
+            if (!aIsAlive[t])
+            {
+                continue;
+            }
+
+            const uint32_t* p = &auCornerPositions[t * 3u];
+            const XMFLOAT3& p0 = m_aVertices[p[0]].Position;
+            const XMFLOAT3& p1 = m_aVertices[p[1]].Position;
+            const XMFLOAT3& p2 = m_aVertices[p[2]].Position;
+
+            const Quadric plane = makePlaneQuadric(p0, p1, p2, 1.0);
+            for (uint32_t k = 0u; k < 3u; ++k)
+            {
+                addQuadric(aQuadrics[p[k]], plane);
+            }
+
+            for (uint32_t k = 0u; k < 3u; ++k)
+            {
+                const uint32_t uA = p[k];
+                const uint32_t uB = p[(k + 1u) % 3u];
+                const uint32_t uC = p[(k + 2u) % 3u];
+                const uint32_t uNumForward = edgeCounts[(static_cast<uint64_t>(uA) << 32u) | uB];
+                const auto backward = edgeCounts.find((static_cast<uint64_t>(uB) << 32u) | uA);
+
+                if (uNumForward > 1u || (backward != edgeCounts.end() && backward->second > 1u))
+                {
+                    aIsLocked[uA] = 1u;
+                    aIsLocked[uB] = 1u;
+                    continue;
+                }
+
+                if (backward != edgeCounts.end() && backward->second > 0u)
+                {
+                    continue;
+                }
+
+                const Quadric border = makeBorderQuadric(m_aVertices[uA].Position, m_aVertices[uB].Position, m_aVertices[uC].Position, BORDER_WEIGHT);
+                addQuadric(aQuadrics[uA], border);
+                addQuadric(aQuadrics[uB], border);
+
+                auBorderNext[uA] = uB;
+                auBorderPrev[uB] = uA;
+                ++auNumBorderEdges[uA];
+                ++auNumBorderEdges[uB];
+            }
+        }
+
+        for (uint32_t i = 0u; i < m_uNumVertices; ++i)
+        {
+            if (m_aIsSeam[i] || (auNumBorderEdges[i] != 0u && auNumBorderEdges[i] != 2u))
+            {
+                aIsLocked[i] = 1u;
+            }
+        }
+
+        std::vector<uint32_t> auNeighbors;
+        std::vector<uint32_t> auOtherNeighbors;
+        const auto gatherNeighbors = [&](uint32_t uPosition, std::vector<uint32_t>& auOut)
+        {
+            auOut.clear();
+            for (uint32_t t : aauTriangles[uPosition])
+            {
+                if (!aIsAlive[t])
+                {
+                    continue;
+                }
+
+                for (uint32_t k = 0u; k < 3u; ++k)
+                {
+                    if (auCornerPositions[t * 3u + k] != uPosition)
+                    {
+                        auOut.push_back(auCornerPositions[t * 3u + k]);
+                    }
+                }
+            }
+
+            std::sort(auOut.begin(), auOut.end());
+            auOut.erase(std::unique(auOut.begin(), auOut.end()), auOut.end());
+        };
+
+        // Returns the copy of the target every triangle of the edge uses, or INVALID_VERTEX if they differ
+        const auto findTargetVertex = [&](uint32_t uFrom, uint32_t uTo)
+        {
+            uint32_t uToVertex = INVALID_VERTEX;
+            for (uint32_t t : aauTriangles[uFrom])
+            {
+                if (!aIsAlive[t])
+                {
+                    continue;
+                }
+
+                for (uint32_t k = 0u; k < 3u; ++k)
+                {
+                    if (auCornerPositions[t * 3u + k] == uTo)
+                    {
+                        if (uToVertex != INVALID_VERTEX && uToVertex != auCorners[t * 3u + k])
+                        {
+                            return INVALID_VERTEX;
+                        }
+                        uToVertex = auCorners[t * 3u + k];
+                    }
+                }
+            }
+            return uToVertex;
+        };
+
+        const auto isFlipped = [&](uint32_t uFrom, uint32_t uTo)
+        {
+            const XMVECTOR to = XMLoadFloat3(&m_aVertices[uTo].Position);
+            for (uint32_t t : aauTriangles[uFrom])
+            {
+                const uint32_t* p = &auCornerPositions[t * 3u];
+                if (!aIsAlive[t] || p[0] == uTo || p[1] == uTo || p[2] == uTo)
+                {
+                    continue;
+                }
+
+                XMVECTOR aCorners[3];
+                XMVECTOR aMoved[3];
+                for (uint32_t k = 0u; k < 3u; ++k)
+                {
+                    aCorners[k] = XMLoadFloat3(&m_aVertices[p[k]].Position);
+                    aMoved[k] = p[k] == uFrom ? to : aCorners[k];
+                }
+
+                const XMVECTOR before = XMVector3Cross(aCorners[1] - aCorners[0], aCorners[2] - aCorners[0]);
+                const XMVECTOR after = XMVector3Cross(aMoved[1] - aMoved[0], aMoved[2] - aMoved[0]);
+                if (XMVectorGetX(XMVector3Dot(before, after)) <= 0.0f)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        std::vector<Collapse> aCollapses;
+        std::vector<uint8_t> aIsTouched(m_uNumVertices, 0u);
+        double maxError = 0.0;
+
+        while (uNumAlive > uTargetNumTriangles)
+        {
+            aCollapses.clear();
+
+            for (uint32_t uFrom = 0u; uFrom < m_uNumVertices; ++uFrom)
+            {
+                if (m_auPositions[uFrom] != uFrom || aIsLocked[uFrom] || aIsRemoved[uFrom] || aauTriangles[uFrom].empty())
+                {
+                    continue;
+                }
+
+                const bool bIsBorder = auNumBorderEdges[uFrom] != 0u;
+                const XMFLOAT3& from = m_aVertices[uFrom].Position;
+                uint32_t uFromVertex = INVALID_VERTEX;
+                for (uint32_t t : aauTriangles[uFrom])
+                {
+                    if (aIsAlive[t])
+                    {
+                        const uint32_t k = auCornerPositions[t * 3u] == uFrom ? 0u : (auCornerPositions[t * 3u + 1u] == uFrom ? 1u : 2u);
+                        uFromVertex = auCorners[t * 3u + k];
+                        break;
+                    }
+                }
+
+                if (uFromVertex == INVALID_VERTEX)
+                {
+                    continue;
+                }
+
+                gatherNeighbors(uFrom, auNeighbors);
+
+                Collapse best = { uFrom, INVALID_VERTEX, INVALID_VERTEX, 0.0, 0.0 };
+                for (uint32_t uTo : auNeighbors)
+                {
+                    if (bIsBorder && uTo != auBorderNext[uFrom] && uTo != auBorderPrev[uFrom])
+                    {
+                        continue;
+                    }
+
+                    const uint32_t uToVertex = findTargetVertex(uFrom, uTo);
+                    if (uToVertex == INVALID_VERTEX)
+                    {
+                        continue;
+                    }
+
+                    Quadric sum = aQuadrics[uFrom];
+                    addQuadric(sum, aQuadrics[uTo]);
+
+                    const XMFLOAT3& to = m_aVertices[uTo].Position;
+                    const double error = (std::max)(evaluateQuadric(sum, to) / (std::max)(sum.weight, 1e-30), 0.0);
+                    const double dx = static_cast<double>(to.x) - from.x;
+                    const double dy = static_cast<double>(to.y) - from.y;
+                    const double dz = static_cast<double>(to.z) - from.z;
+                    const double cost = error + attributeDistance(uFromVertex, uToVertex) * (dx * dx + dy * dy + dz * dz);
+
+                    if (best.uTo == INVALID_VERTEX || cost < best.cost)
+                    {
+                        best = { uFrom, uTo, uToVertex, cost, error };
+                    }
+                }
+
+                if (best.uTo != INVALID_VERTEX)
+                {
+                    aCollapses.push_back(best);
+                }
+            }
+
+            std::sort(aCollapses.begin(), aCollapses.end(), [](const Collapse& a, const Collapse& b)
+            {
+                return a.cost < b.cost || (a.cost == b.cost && a.uFrom < b.uFrom);
+            });
+
+            std::fill(aIsTouched.begin(), aIsTouched.end(), static_cast<uint8_t>(0u));
+            uint32_t uNumCollapsed = 0u;
+
+            for (const Collapse& collapse : aCollapses)
+            {
+                if (uNumAlive <= uTargetNumTriangles)
+                {
+                    break;
+                }
+
+                const uint32_t uFrom = collapse.uFrom;
+                const uint32_t uTo = collapse.uTo;
+                if (aIsTouched[uFrom] || aIsTouched[uTo])
+                {
+                    continue;
+                }
+
+                // Link condition: the edge must only share the corners of the triangles on it
+                gatherNeighbors(uFrom, auNeighbors);
+                gatherNeighbors(uTo, auOtherNeighbors);
+
+                uint32_t uNumShared = 0u;
+                for (uint32_t uNeighbor : auNeighbors)
+                {
+                    uNumShared += std::binary_search(auOtherNeighbors.begin(), auOtherNeighbors.end(), uNeighbor) ? 1u : 0u;
+                }
+
+                // A border loop of three would close into a single triangle and vanish
+                const bool bIsBorderEdge = auBorderNext[uFrom] == uTo || auBorderPrev[uFrom] == uTo;
+                const bool bIsBorderTriangle = bIsBorderEdge && auBorderNext[auBorderNext[uFrom]] == auBorderPrev[uFrom];
+                if (uNumShared != (bIsBorderEdge ? 1u : 2u) || bIsBorderTriangle || isFlipped(uFrom, uTo))
+                {
+                    continue;
+                }
+
+                for (uint32_t uNeighbor : auNeighbors)
+                {
+                    aIsTouched[uNeighbor] = 1u;
+                }
+                for (uint32_t uNeighbor : auOtherNeighbors)
+                {
+                    aIsTouched[uNeighbor] = 1u;
+                }
+                aIsTouched[uFrom] = 1u;
+                aIsTouched[uTo] = 1u;
+
+                for (uint32_t t : aauTriangles[uFrom])
+                {
+                    if (!aIsAlive[t])
+                    {
+                        continue;
+                    }
+
+                    uint32_t* p = &auCornerPositions[t * 3u];
+                    if (p[0] == uTo || p[1] == uTo || p[2] == uTo)
+                    {
+                        aIsAlive[t] = 0u;
+                        --uNumAlive;
+                        continue;
+                    }
+
+                    for (uint32_t k = 0u; k < 3u; ++k)
+                    {
+                        if (p[k] == uFrom)
+                        {
+                            p[k] = uTo;
+                            auCorners[t * 3u + k] = collapse.uToVertex;
+                        }
+                    }
+                    aauTriangles[uTo].push_back(t);
+                }
+
+                if (bIsBorderEdge)
+                {
+                    if (auBorderNext[uFrom] == uTo)
+                    {
+                        auBorderNext[auBorderPrev[uFrom]] = uTo;
+                        auBorderPrev[uTo] = auBorderPrev[uFrom];
+                    }
+                    else
+                    {
+                        auBorderPrev[auBorderNext[uFrom]] = uTo;
+                        auBorderNext[uTo] = auBorderNext[uFrom];
+                    }
+                }
+
+                addQuadric(aQuadrics[uTo], aQuadrics[uFrom]);
+                aauTriangles[uFrom].clear();
+                aIsRemoved[uFrom] = 1u;
+                maxError = (std::max)(maxError, collapse.error);
+                ++uNumCollapsed;
+            }
+
+            if (uNumCollapsed == 0u)
+            {
+                break;
+            }
+        }
+
+        aOutIndices.reserve(uNumAlive * 3u);
+        for (uint32_t t = 0u; t < uNumTriangles; ++t)
+        {
+            if (aIsAlive[t])
+            {
+                aOutIndices.push_back(static_cast<uint16_t>(auCorners[t * 3u]));
+                aOutIndices.push_back(static_cast<uint16_t>(auCorners[t * 3u + 1u]));
+                aOutIndices.push_back(static_cast<uint16_t>(auCorners[t * 3u + 2u]));
+            }
+        }
+
+        return static_cast<float>(std::sqrt(maxError));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::GetNumLockedVertices
+      Summary:  Returns the number of vertices on a seam
+      Returns:  uint32_t
+                  Number of welded positions that never move
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t MeshSimplifier::GetNumLockedVertices() const
+    {
+        return static_cast<uint32_t>(std::count(m_aIsSeam.begin(), m_aIsSeam.end(), static_cast<uint8_t>(1u)));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::makePlaneQuadric
+      Summary:  Returns the quadric of the plane of a triangle, weighted
+                by its area
+      Args:     const XMFLOAT3& p0
+                  First corner
+                const XMFLOAT3& p1
+                  Second corner
+                const XMFLOAT3& p2
+                  Third corner
+                double weight
+                  Scale of the area
+      Returns:  Quadric
+                  Quadric of the plane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshSimplifier::Quadric MeshSimplifier::makePlaneQuadric(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2, double weight)
+    {
+        const double e1[3] = { static_cast<double>(p1.x) - p0.x, static_cast<double>(p1.y) - p0.y, static_cast<double>(p1.z) - p0.z };
+        const double e2[3] = { static_cast<double>(p2.x) - p0.x, static_cast<double>(p2.y) - p0.y, static_cast<double>(p2.z) - p0.z };
+        double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+        const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length <= 0.0)
+        {
+            return Quadric{};
+        }
+
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+        const double d = -(n[0] * p0.x + n[1] * p0.y + n[2] * p0.z);
+        const double w = weight * length * 0.5;
+
+        return Quadric{
+            w * n[0] * n[0], w * n[0] * n[1], w * n[0] * n[2], w * n[0] * d,
+            w * n[1] * n[1], w * n[1] * n[2], w * n[1] * d,
+            w * n[2] * n[2], w * n[2] * d,
+            w * d * d,
+            w
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::makeBorderQuadric
+      Summary:  Returns the quadric of the plane through a border edge
+                that is perpendicular to its triangle, so moving a
+                vertex off the border costs as much as moving it off the
+                surface. Weighted by the squared length of the edge
+      Args:     const XMFLOAT3& p0
+                  Start of the border edge
+                const XMFLOAT3& p1
+                  End of the border edge
+                const XMFLOAT3& p2
+                  Third corner of the triangle of the edge
+                double weight
+                  Scale of the squared length
+      Returns:  Quadric
+                  Quadric of the plane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshSimplifier::Quadric MeshSimplifier::makeBorderQuadric(const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2, double weight)
+    {
+        const double e[3] = { static_cast<double>(p1.x) - p0.x, static_cast<double>(p1.y) - p0.y, static_cast<double>(p1.z) - p0.z };
+        const double f[3] = { static_cast<double>(p2.x) - p0.x, static_cast<double>(p2.y) - p0.y, static_cast<double>(p2.z) - p0.z };
+        const double t[3] = { e[1] * f[2] - e[2] * f[1], e[2] * f[0] - e[0] * f[2], e[0] * f[1] - e[1] * f[0] };
+        double n[3] = { e[1] * t[2] - e[2] * t[1], e[2] * t[0] - e[0] * t[2], e[0] * t[1] - e[1] * t[0] };
+
+        const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length <= 0.0)
+        {
+            return Quadric{};
+        }
+
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+        const double d = -(n[0] * p0.x + n[1] * p0.y + n[2] * p0.z);
+        const double w = weight * (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+
+        // The weight of a border plane only steers the collapse, it is not part of the mean
+        return Quadric{
+            w * n[0] * n[0], w * n[0] * n[1], w * n[0] * n[2], w * n[0] * d,
+            w * n[1] * n[1], w * n[1] * n[2], w * n[1] * d,
+            w * n[2] * n[2], w * n[2] * d,
+            w * d * d,
+            0.0
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::addQuadric
+      Summary:  Adds a quadric to a sum
+      Args:     Quadric& sum
+                  Sum to add to
+                const Quadric& quadric
+                  Quadric to add
+      Modifies: [sum].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshSimplifier::addQuadric(Quadric& sum, const Quadric& quadric)
+    {
+        sum.a2 += quadric.a2;
+        sum.ab += quadric.ab;
+        sum.ac += quadric.ac;
+        sum.ad += quadric.ad;
+        sum.b2 += quadric.b2;
+        sum.bc += quadric.bc;
+        sum.bd += quadric.bd;
+        sum.c2 += quadric.c2;
+        sum.cd += quadric.cd;
+        sum.d2 += quadric.d2;
+        sum.weight += quadric.weight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::evaluateQuadric
+      Summary:  Returns the weighted sum of the squared distances from a
+                position to the planes of a quadric
+      Args:     const Quadric& quadric
+                  Quadric to evaluate
+                const XMFLOAT3& position
+                  Position to measure
+      Returns:  double
+                  Weighted sum of the squared distances
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double MeshSimplifier::evaluateQuadric(const Quadric& quadric, const XMFLOAT3& position)
+    {
+        const double x = position.x;
+        const double y = position.y;
+        const double z = position.z;
+
+        return quadric.a2 * x * x + 2.0 * quadric.ab * x * y + 2.0 * quadric.ac * x * z + 2.0 * quadric.ad * x
+            + quadric.b2 * y * y + 2.0 * quadric.bc * y * z + 2.0 * quadric.bd * y
+            + quadric.c2 * z * z + 2.0 * quadric.cd * z
+            + quadric.d2;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::attributeDistance
+      Summary:  Returns how much the normal and texture coordinates of a
+                vertex change when it is replaced by another one
+      Args:     uint32_t uFrom
+                  Vertex that goes away
+                uint32_t uTo
+                  Vertex that replaces it
+      Returns:  double
+                  Weighted squared distance of the attributes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double MeshSimplifier::attributeDistance(uint32_t uFrom, uint32_t uTo) const
+    {
+        const SimpleVertex& from = m_aVertices[uFrom];
+        const SimpleVertex& to = m_aVertices[uTo];
+
+        const double nx = static_cast<double>(to.Normal.x) - from.Normal.x;
+        const double ny = static_cast<double>(to.Normal.y) - from.Normal.y;
+        const double nz = static_cast<double>(to.Normal.z) - from.Normal.z;
+        const double u = static_cast<double>(to.TexCoord.x) - from.TexCoord.x;
+        const double v = static_cast<double>(to.TexCoord.y) - from.TexCoord.y;
+
+        return NORMAL_WEIGHT * (nx * nx + ny * ny + nz * nz) + TEXCOORD_WEIGHT * (u * u + v * v);
+    }
+}
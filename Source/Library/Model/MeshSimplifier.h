@@ -0,0 +1,105 @@
+/*+===================================================================
+  File:      MESHSIMPLIFIER.H
+
+  Summary:   MeshSimplifier header file contains declaration of class
+             MeshSimplifier used to build the levels of detail of a
+             mesh by collapsing edges in quadric error order. It only
+             depends on DirectXMath and the standard library.
+
+  Classes:  MeshSimplifier
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Renderer/VertexTypes.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshSimplifier
+      Summary:  Simplifies the triangles of one mesh by moving vertices
+                onto a neighbour, so a level of detail is only a new
+                index list over the original vertices. Every vertex
+                keeps the plane quadric of the triangles around it,
+                and the collapse that adds the least mean squared
+                distance goes first. Vertices that share a position but
+                not their texture coordinates or normal lie on a seam
+                and never move; vertices on an open border only slide
+                along it. A collapse is also rejected when it would
+                flip a triangle or pinch the surface. The output only
+                depends on the input, not on hash or thread order
+      Methods:  Simplify
+                  Builds the index list of a simpler level
+                GetNumLockedVertices
+                  Returns the number of vertices that never move
+                MeshSimplifier
+                  Constructor.
+                ~MeshSimplifier
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshSimplifier
+    {
+    public:
+        static constexpr const double BORDER_WEIGHT = 10.0;
+        static constexpr const double NORMAL_WEIGHT = 0.25;
+        static constexpr const double TEXCOORD_WEIGHT = 1.0;
+        static constexpr const uint32_t INVALID_VERTEX = 0xFFFFFFFFu;
+
+    public:
+        MeshSimplifier() = delete;
+        MeshSimplifier(const SimpleVertex* aVertices, uint32_t uNumVertices);
+        MeshSimplifier(const MeshSimplifier& other) = delete;
+        MeshSimplifier(MeshSimplifier&& other) = delete;
+        MeshSimplifier& operator=(const MeshSimplifier& other) = delete;
+        MeshSimplifier& operator=(MeshSimplifier&& other) = delete;
+        ~MeshSimplifier() = default;
+
+        float Simplify(const uint16_t* aIndices, uint32_t uNumIndices, uint32_t uTargetNumIndices, std::vector<uint16_t>& aOutIndices) const;
+        uint32_t GetNumLockedVertices() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Quadric
+          Summary:  Sum of the squared distances to weighted planes, as
+                    the upper triangle of a symmetric 4x4 matrix, and
+                    the sum of the weights to turn it into a mean
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Quadric
+        {
+            double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+            double weight;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Collapse
+          Summary:  Cheapest move of a position onto a neighbour. The
+                    cost orders the collapses and includes the change
+                    of attributes, the error is only the distance
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Collapse
+        {
+            uint32_t uFrom;
+            uint32_t uTo;
+            uint32_t uToVertex;
+            double cost;
+            double error;
+        };
+
+        static Quadric makePlaneQuadric(const DirectX::XMFLOAT3& p0, const DirectX::XMFLOAT3& p1, const DirectX::XMFLOAT3& p2, double weight);
+        static Quadric makeBorderQuadric(const DirectX::XMFLOAT3& p0, const DirectX::XMFLOAT3& p1, const DirectX::XMFLOAT3& p2, double weight);
+        static void addQuadric(Quadric& sum, const Quadric& quadric);
+        static double evaluateQuadric(const Quadric& quadric, const DirectX::XMFLOAT3& position);
+        double attributeDistance(uint32_t uFrom, uint32_t uTo) const;
+
+    private:
+        const SimpleVertex* m_aVertices;
+        uint32_t m_uNumVertices;
+        std::vector<uint32_t> m_auCanonical;
+        std::vector<uint32_t> m_auPositions;
+        std::vector<uint8_t> m_aIsSeam;
+    };
+}
@@ -4,6 +4,11 @@
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
 
+#include "Model/MeshOptimizer.h"
+#include "Model/MeshSimplifier.h"
+#include "Utility/Hash.h"
+#include "Utility/Profiler.h"
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -54,45 +59,61 @@ namespace library
         return XMLoadFloat4(&float4);
     }
 
-    std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Model
       Summary:  Constructor
       Args:     const std::filesystem::path& filePath
                   Path to the model to load
-      Modifies: [m_filePath, m_animationBuffer, m_skinningConstantBuffer,
-                 m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
-                 m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
-                 m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-                 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+      Modifies: [m_filePath, m_textureCache, m_animationBuffer, m_skinningBuffer,
+                 m_skinningShaderResourceView, m_aVertices, m_aAnimationData,
+                 m_aIndices, m_aMeshLods, m_skinWeights, m_aBoneInfo, m_aTransforms,
+                 m_aBoneInfo, m_aTransforms, m_aPreviousTransforms,
+                 m_boneNameToIndexMap, m_pImporter, m_pScene, m_timeSinceLoaded,
+                 m_globalInverseTransform, m_positionScale, m_positionOffset,
+                 m_bHasPackedVertices].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Model::Model(_In_ const std::filesystem::path& filePath) :
         Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)),
         m_filePath(filePath),
+        m_textureCache(),
         m_animationBuffer(nullptr),
-        m_skinningConstantBuffer(nullptr),
+        m_skinningBuffer(nullptr),
+        m_skinningShaderResourceView(nullptr),
         m_aVertices(std::vector<SimpleVertex>()),
         m_aAnimationData(std::vector<AnimationData>()),
         m_aIndices(std::vector<WORD>()),
-        m_aBoneData(std::vector<VertexBoneData>()),
+        m_aMeshLods(std::vector<std::vector<MeshLod>>()),
+        m_skinWeights(),
         m_aBoneInfo(std::vector<BoneInfo>()),
         m_aTransforms(std::vector<XMMATRIX>()),
+        m_aPreviousTransforms(std::vector<XMMATRIX>()),
         m_boneNameToIndexMap(std::unordered_map<std::string, UINT>()),
+        m_pImporter(std::make_unique<Assimp::Importer>()),
         m_pScene(),
         m_timeSinceLoaded(0.0f),
-        m_globalInverseTransform(XMMATRIX())
+        m_globalInverseTransform(XMMATRIX()),
+        m_positionScale(1.0f, 1.0f, 1.0f, 0.0f),
+        m_positionOffset(0.0f, 0.0f, 0.0f, 0.0f),
+        m_bHasPackedVertices(FALSE)
     {}
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::~Model
+      Summary:  Destructor. Defined where the importer is a complete
+                type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Model::~Model() = default;
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Initialize
-      Summary:  Load and initialize the 3d model and create buffers
+      Summary:  Load and initialize the 3d model and create buffers.
+                A model without a texture cache gets one of its own
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
-      Modifies: [m_pScene, m_globalInverseTransform, m_animationBuffer,
-                 m_skinningConstantBuffer].
+      Modifies: [m_textureCache, m_pScene, m_globalInverseTransform, m_animationBuffer,
+                 m_skinningBuffer, m_skinningShaderResourceView].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -100,8 +121,14 @@ namespace library
     {
         HRESULT hr = S_OK;
 
-        m_pScene = sm_pImporter->ReadFile(m_filePath.string().c_str(), aiProcess_Triangulate | aiProcess_GenSmoothNormals |
-            aiProcess_CalcTangentSpace | aiProcess_ConvertToLeftHanded);
+        if (!m_textureCache)
+        {
+            m_textureCache = std::make_shared<TextureCache>();
+        }
+
+        // Triangles and vertices are reordered by optimizeMeshes, so only identical vertices are merged here
+        m_pScene = m_pImporter->ReadFile(m_filePath.string().c_str(), aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+            aiProcess_CalcTangentSpace | aiProcess_JoinIdenticalVertices | aiProcess_ConvertToLeftHanded);
 
         if (m_pScene != nullptr)
         {
@@ -121,14 +148,30 @@ namespace library
             OutputDebugString(L"Error parsing ");
             OutputDebugString(m_filePath.c_str());
             OutputDebugString(L": ");
-            OutputDebugStringA(sm_pImporter->GetErrorString());
+            OutputDebugStringA(m_pImporter->GetErrorString());
             OutputDebugString(L"\n");
 
             return E_FAIL;
         }
 
+        // Packed bone data keeps the full one on the CPU, like the vertices
+        std::vector<PackedAnimationData> aPackedAnimationData;
+        const void* pAnimationData = m_aAnimationData.data();
+        UINT uAnimationDataStride = sizeof(AnimationData);
+        if (m_bHasPackedVertices)
+        {
+            aPackedAnimationData.reserve(m_aAnimationData.size());
+            for (const AnimationData& animationData : m_aAnimationData)
+            {
+                aPackedAnimationData.push_back(VertexCompression::PackAnimationData(animationData));
+            }
+
+            pAnimationData = aPackedAnimationData.data();
+            uAnimationDataStride = sizeof(PackedAnimationData);
+        }
+
         D3D11_BUFFER_DESC animationBd = {
-            .ByteWidth = sizeof(AnimationData) * (UINT)m_aAnimationData.size(),
+            .ByteWidth = uAnimationDataStride * (UINT)m_aAnimationData.size(),
             .Usage = D3D11_USAGE_DEFAULT,
             .BindFlags = D3D11_BIND_VERTEX_BUFFER,
             .CPUAccessFlags = 0,
@@ -137,7 +180,7 @@ namespace library
         };
 
         D3D11_SUBRESOURCE_DATA animationInitData = {
-            .pSysMem = m_aAnimationData.data(),
+            .pSysMem = pAnimationData,
             .SysMemPitch = 0,
             .SysMemSlicePitch = 0
         };
@@ -149,20 +192,57 @@ namespace library
             return hr;
         }
 
-        D3D11_BUFFER_DESC cbSkinning = {
-            .ByteWidth = sizeof(CBSkinning),
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
-            .CPUAccessFlags = 0,
-            .MiscFlags = 0,
-            .StructureByteStride = 0
-        };
+        // The bone palette holds exactly the bones of the skeleton, identity until the first upload
+        if (!m_aBoneInfo.empty())
+        {
+            const BoneTransform3x4 identity =
+            {
+                .Rows =
+                {
+                    XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f),
+                    XMFLOAT4(0.0f, 1.0f, 0.0f, 0.0f),
+                    XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f)
+                }
+            };
+            std::vector<BoneTransform3x4> aIdentityPalette(m_aBoneInfo.size(), identity);
+
+            D3D11_BUFFER_DESC skinningBd = {
+                .ByteWidth = static_cast<UINT>(sizeof(BoneTransform3x4) * m_aBoneInfo.size()),
+                .Usage = D3D11_USAGE_DYNAMIC,
+                .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+                .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+                .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+                .StructureByteStride = sizeof(BoneTransform3x4)
+            };
 
-        hr = pDevice->CreateBuffer(&cbSkinning, nullptr, m_skinningConstantBuffer.GetAddressOf());
+            D3D11_SUBRESOURCE_DATA skinningInitData = {
+                .pSysMem = aIdentityPalette.data(),
+                .SysMemPitch = 0,
+                .SysMemSlicePitch = 0
+            };
 
-        if (FAILED(hr))
-        {
-            return hr;
+            hr = pDevice->CreateBuffer(&skinningBd, &skinningInitData, m_skinningBuffer.GetAddressOf());
+
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            D3D11_SHADER_RESOURCE_VIEW_DESC skinningSrvDesc = {
+                .Format = DXGI_FORMAT_UNKNOWN,
+                .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+                .Buffer = {
+                    .FirstElement = 0u,
+                    .NumElements = static_cast<UINT>(m_aBoneInfo.size())
+                }
+            };
+
+            hr = pDevice->CreateShaderResourceView(m_skinningBuffer.Get(), &skinningSrvDesc, m_skinningShaderResourceView.GetAddressOf());
+
+            if (FAILED(hr))
+            {
+                return hr;
+            }
         }
 
         return hr;
@@ -208,13 +288,61 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::GetSkinningConstantBuffer
-      Summary:  Returns the skinning constant buffer
+      Method:   Model::GetSkinningBuffer
+      Summary:  Returns the structured buffer of the bone palette, null
+                for models without bones
       Returns:  ComPtr<ID3D11Buffer>&
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11Buffer>& Model::GetSkinningConstantBuffer()
+    ComPtr<ID3D11Buffer>& Model::GetSkinningBuffer()
+    {
+        return m_skinningBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetSkinningShaderResourceView
+      Summary:  Returns the view the vertex shader reads the bone
+                palette through, null for models without bones
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& Model::GetSkinningShaderResourceView()
+    {
+        return m_skinningShaderResourceView;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::UploadBonePalette
+      Summary:  Replaces the bone palette with the given bones. Only
+                the bones of the skeleton are written, the buffer is
+                discarded and renamed by the driver
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to map the buffer with
+                const BoneTransform3x4* aBoneTransforms
+                  Transposed bone transforms
+                UINT uNumBones
+                  Number of bones, at most the size of the skeleton
+      Modifies: [m_skinningBuffer].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::UploadBonePalette(_In_ ID3D11DeviceContext* pImmediateContext, _In_ const BoneTransform3x4* aBoneTransforms, _In_ UINT uNumBones)
     {
-        return m_skinningConstantBuffer;
+        if (!m_skinningBuffer || uNumBones == 0u)
+        {
+            return S_OK;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mappedPalette;
+        HRESULT hr = pImmediateContext->Map(m_skinningBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mappedPalette);
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        memcpy(mappedPalette.pData, aBoneTransforms, sizeof(BoneTransform3x4) * (std::min)(uNumBones, static_cast<UINT>(m_aBoneInfo.size())));
+        pImmediateContext->Unmap(m_skinningBuffer.Get(), 0u);
+
+        return hr;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -237,6 +365,149 @@ namespace library
         return static_cast<UINT>(m_aIndices.size());
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetNumLods
+      Summary:  Returns the number of levels of detail of a mesh
+      Args:     UINT uMesh
+                  Index of the mesh
+      Returns:  UINT
+                  Number of levels, at least one
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumLods(_In_ UINT uMesh) const
+    {
+        return static_cast<UINT>(m_aMeshLods[uMesh].size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetMeshLod
+      Summary:  Returns the index range of a level of detail
+      Args:     UINT uMesh
+                  Index of the mesh
+                UINT uLod
+                  Level of detail, 0 is the mesh itself
+      Returns:  const MeshLod&
+                  Index range and error of the level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Model::MeshLod& Model::GetMeshLod(_In_ UINT uMesh, _In_ UINT uLod) const
+    {
+        return m_aMeshLods[uMesh][uLod];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SelectLod
+      Summary:  Returns the coarsest level of a mesh whose error, once
+                projected, stays under MAX_LOD_ERROR_PIXELS
+      Args:     UINT uMesh
+                  Index of the mesh
+                FLOAT pixelsPerUnit
+                  Pixels covered by one model unit at the distance of
+                  the model
+      Returns:  UINT
+                  Level of detail to draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::SelectLod(_In_ UINT uMesh, _In_ FLOAT pixelsPerUnit) const
+    {
+        const std::vector<MeshLod>& aLods = m_aMeshLods[uMesh];
+        for (UINT uLod = static_cast<UINT>(aLods.size()) - 1u; uLod > 0u; --uLod)
+        {
+            if (aLods[uLod].error * pixelsPerUnit <= MAX_LOD_ERROR_PIXELS)
+            {
+                return uLod;
+            }
+        }
+
+        return 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetPermutation
+      Summary:  Returns the shader features of the model, with skinning
+                when it has bones
+      Returns:  ShaderPermutation
+                  Features and light count
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderPermutation Model::GetPermutation() const
+    {
+        ShaderPermutation permutation = Renderable::GetPermutation();
+        if (!m_aBoneInfo.empty())
+        {
+            permutation.Enable(eShaderFeature::SKINNING);
+        }
+
+        if (m_bHasPackedVertices)
+        {
+            permutation.Enable(eShaderFeature::PACKED_VERTICES);
+        }
+
+        return permutation;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetPackedVertices
+      Summary:  Selects whether the vertex, normal and animation buffers
+                hold the packed formats of VertexCompression. Has to be
+                called before Initialize, and the vertex shader of the
+                model has to support PACKED_VERTICES
+      Args:     BOOL bHasPackedVertices
+                  TRUE to pack the vertices
+      Modifies: [m_bHasPackedVertices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetPackedVertices(_In_ BOOL bHasPackedVertices)
+    {
+        m_bHasPackedVertices = bHasPackedVertices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::HasPackedVertices
+      Summary:  Returns whether the buffers hold packed vertices
+      Returns:  BOOL
+                  TRUE if the vertices are packed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Model::HasPackedVertices() const
+    {
+        return m_bHasPackedVertices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetPositionScale
+      Summary:  Returns the decode scale of the packed positions. One
+                when the vertices are not packed
+      Returns:  const XMFLOAT4&
+                  Size of the bounding box of the model
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& Model::GetPositionScale() const
+    {
+        return m_positionScale;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetPositionOffset
+      Summary:  Returns the decode offset of the packed positions. Zero
+                when the vertices are not packed
+      Returns:  const XMFLOAT4&
+                  Minimum corner of the bounding box of the model
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& Model::GetPositionOffset() const
+    {
+        return m_positionOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetPositionDecodeMatrix
+      Summary:  Returns the decode of the packed positions as a matrix,
+                for passes that read the position alone and can fold it
+                into the world matrix. Identity when the vertices are
+                not packed
+      Returns:  XMMATRIX
+                  Scale by GetPositionScale, then translation by
+                  GetPositionOffset
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX Model::GetPositionDecodeMatrix() const
+    {
+        return XMMatrixScaling(m_positionScale.x, m_positionScale.y, m_positionScale.z)
+            * XMMatrixTranslation(m_positionOffset.x, m_positionOffset.y, m_positionOffset.z);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
        Method:   Model::GetBoneTransforms
        Summary:  Returns the vector containing bone transforms
@@ -247,6 +518,40 @@ namespace library
         return m_aTransforms;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+       Method:   Model::GetInterpolatedBoneTransform
+       Summary:  Returns a bone transform between the one of the tick
+                 before last and the current one
+       Args:     UINT uIndex
+                   Index of the bone, below GetBoneTransforms().size()
+                 FLOAT alpha
+                   Weight of the current transform
+       Returns:  XMMATRIX
+                   Interpolated bone transform
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX Model::GetInterpolatedBoneTransform(_In_ UINT uIndex, _In_ FLOAT alpha) const
+    {
+        if (uIndex >= m_aPreviousTransforms.size())
+        {
+            return m_aTransforms[uIndex];
+        }
+
+        return interpolateMatrix(m_aPreviousTransforms[uIndex], m_aTransforms[uIndex], alpha);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+       Method:   Model::StorePreviousState
+       Summary:  Keeps the world matrix and the bone transforms before a
+                 simulation tick changes them
+       Modifies: [m_previousWorld, m_bHasPreviousState,
+                  m_aPreviousTransforms].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::StorePreviousState()
+    {
+        Renderable::StorePreviousState();
+        m_aPreviousTransforms = m_aTransforms;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::GetBoneNameToIndexMap
         Summary:  Returns the bone name to index map
@@ -257,6 +562,40 @@ namespace library
         return m_boneNameToIndexMap;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetFilePath
+        Summary:  Returns the path of the model file
+        Returns:  const std::filesystem::path&
+                    Path to the model file
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Model::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::SetTextureCache
+        Summary:  Sets the texture cache the textures of the materials
+                  are loaded through. Has to be called before Initialize
+        Args:     const std::shared_ptr<TextureCache>& textureCache
+                    Texture cache, usually the one of the renderer
+        Modifies: [m_textureCache].
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetTextureCache(_In_ const std::shared_ptr<TextureCache>& textureCache)
+    {
+        m_textureCache = textureCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+        Method:   Model::GetTextureCache
+        Summary:  Returns the texture cache of the model
+        Returns:  const std::shared_ptr<TextureCache>&
+     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<TextureCache>& Model::GetTextureCache() const
+    {
+        return m_textureCache;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::countVerticesAndIndices
         Summary:  Fill the BasicMeshEntry information
@@ -387,6 +726,80 @@ namespace library
         return 0u;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::generateLods
+      Summary:  Simplifies every mesh to half, a quarter and an eighth
+                of its triangles. The levels only index the vertices of
+                the mesh, so they are appended to the index buffer and
+                drawn with the base vertex of the mesh. Their triangles
+                are ordered like the mesh by MeshOptimizer. A level that
+                keeps more than three quarters of the previous one ends
+                the chain, as on meshes that are mostly seams
+      Modifies: [m_aIndices, m_aMeshLods].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::generateLods()
+    {
+        PROFILE_ZONE("Model::generateLods");
+
+        m_aMeshLods.resize(m_aMeshes.size());
+
+        // Kept apart so the mesh indices are not moved while they are read
+        std::vector<WORD> aLodIndices;
+        std::vector<WORD> aSimplifiedIndices;
+        std::vector<UINT> auClusters;
+        const UINT uNumMeshIndices = static_cast<UINT>(m_aIndices.size());
+
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            std::vector<MeshLod>& aLods = m_aMeshLods[i];
+            aLods.assign(1u, MeshLod{ mesh.uBaseIndex, mesh.uNumIndices, 0.0f });
+
+            const UINT uEndVertex = i + 1u < m_aMeshes.size() ? m_aMeshes[i + 1u].uBaseVertex : static_cast<UINT>(m_aVertices.size());
+            if (uEndVertex <= mesh.uBaseVertex || mesh.uNumIndices == 0u)
+            {
+                continue;
+            }
+
+            MeshSimplifier simplifier(&m_aVertices[mesh.uBaseVertex], uEndVertex - mesh.uBaseVertex);
+            for (UINT uLod = 1u; uLod < MAX_NUM_LODS; ++uLod)
+            {
+                FLOAT error = simplifier.Simplify(&m_aIndices[mesh.uBaseIndex], mesh.uNumIndices, mesh.uNumIndices >> uLod, aSimplifiedIndices);
+                if (aSimplifiedIndices.size() * 4u > aLods.back().uNumIndices * 3u)
+                {
+                    break;
+                }
+
+                MeshOptimizer::OptimizeVertexCache(aSimplifiedIndices.data(), static_cast<UINT>(aSimplifiedIndices.size()), uEndVertex - mesh.uBaseVertex, auClusters);
+                MeshOptimizer::OptimizeOverdraw(&m_aVertices[mesh.uBaseVertex], aSimplifiedIndices.data(), static_cast<UINT>(aSimplifiedIndices.size()), auClusters);
+
+                aLods.push_back(
+                    MeshLod
+                    {
+                        .uBaseIndex = uNumMeshIndices + static_cast<UINT>(aLodIndices.size()),
+                        .uNumIndices = static_cast<UINT>(aSimplifiedIndices.size()),
+                        .error = (std::max)(error, aLods.back().error)
+                    }
+                );
+                aLodIndices.insert(aLodIndices.end(), aSimplifiedIndices.begin(), aSimplifiedIndices.end());
+            }
+
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"Mesh %u: %zu levels of detail, %u to %u triangles, error %f\n",
+                i,
+                aLods.size(),
+                aLods.front().uNumIndices / 3u,
+                aLods.back().uNumIndices / 3u,
+                aLods.back().error
+            );
+            OutputDebugString(szMessage);
+        }
+
+        m_aIndices.insert(m_aIndices.end(), aLodIndices.begin(), aLodIndices.end());
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::getBoneId
         Summary:  Find the the index of the bone
@@ -484,21 +897,30 @@ namespace library
 
         initAllMeshes(pScene);
 
+        optimizeMeshes();
+
+        generateLods();
+
         hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
         if (FAILED(hr))
         {
             return hr;
         }
 
-        for (size_t i = 0; i < m_aVertices.size(); ++i)
+        m_skinWeights.Build(m_aAnimationData);
+
+        if (m_skinWeights.GetNumDroppedWeights() > 0u)
         {
-            m_aAnimationData.push_back(
-                AnimationData
-                {
-                    .aBoneIndices = XMUINT4(m_aBoneData.at(i).aBoneIds),
-                    .aBoneWeights = XMFLOAT4(m_aBoneData.at(i).aWeights)
-                }
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"%s: %u bone weights beyond %u per vertex dropped, largest %f\n",
+                m_filePath.filename().c_str(),
+                m_skinWeights.GetNumDroppedWeights(),
+                static_cast<UINT>(MAX_NUM_BONES_PER_VERTEX),
+                m_skinWeights.GetMaxDroppedWeight()
             );
+            OutputDebugString(szMessage);
         }
 
         hr = initialize(pDevice, pImmediateContext);
@@ -590,7 +1012,7 @@ namespace library
         {
             const aiVertexWeight& vertexWeight = pBone->mWeights[i];
             UINT uGlobalVertexId = m_aMeshes[uMeshIndex].uBaseVertex + vertexWeight.mVertexId;
-            m_aBoneData[uGlobalVertexId].AddBoneData(uBoneId, vertexWeight.mWeight);
+            m_skinWeights.AddWeight(uGlobalVertexId, uBoneId, vertexWeight.mWeight);
         }
     }
 
@@ -645,6 +1067,108 @@ namespace library
         initMeshBones(uMeshIndex, pMesh);
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initializeVertexBuffers
+      Summary:  Creates the vertex and normal buffers, packed when
+                SetPackedVertices was called. The full vertices stay on
+                the CPU for the levels of detail and the bounds. The
+                sizes of both formats are reported to the debug output
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+      Modifies: [m_vertexBuffer, m_normalBuffer, m_positionScale,
+                 m_positionOffset].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initializeVertexBuffers(_In_ ID3D11Device* pDevice)
+    {
+        if (!m_bHasPackedVertices)
+        {
+            return Renderable::initializeVertexBuffers(pDevice);
+        }
+
+        HRESULT hr = S_OK;
+
+        VertexCompression::ComputePositionBounds(m_aVertices.data(), static_cast<UINT>(m_aVertices.size()), m_positionScale, m_positionOffset);
+
+        std::vector<PackedVertex> aPackedVertices;
+        std::vector<PackedNormalData> aPackedNormalData;
+        aPackedVertices.reserve(m_aVertices.size());
+        aPackedNormalData.reserve(m_aNormalData.size());
+        for (UINT i = 0u; i < m_aVertices.size(); ++i)
+        {
+            aPackedVertices.push_back(VertexCompression::PackVertex(m_aVertices[i], m_positionScale, m_positionOffset));
+            if (i < m_aNormalData.size())
+            {
+                aPackedNormalData.push_back(VertexCompression::PackNormalData(m_aVertices[i].Normal, m_aNormalData[i]));
+            }
+        }
+
+        D3D11_BUFFER_DESC vertexBufferDesc =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(PackedVertex) * aPackedVertices.size()),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA vertexInitData =
+        {
+            .pSysMem = aPackedVertices.data(),
+            .SysMemPitch = 0u,
+            .SysMemSlicePitch = 0u
+        };
+
+        hr = pDevice->CreateBuffer(&vertexBufferDesc, &vertexInitData, m_vertexBuffer.GetAddressOf());
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_BUFFER_DESC normalBufferDesc =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(PackedNormalData) * aPackedNormalData.size()),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA normalInitData =
+        {
+            .pSysMem = aPackedNormalData.data(),
+            .SysMemPitch = 0u,
+            .SysMemSlicePitch = 0u
+        };
+
+        hr = pDevice->CreateBuffer(&normalBufferDesc, &normalInitData, m_normalBuffer.GetAddressOf());
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        const size_t uFullSize = sizeof(SimpleVertex) + sizeof(NormalData) + sizeof(AnimationData);
+        const size_t uPackedSize = sizeof(PackedVertex) + sizeof(PackedNormalData) + sizeof(PackedAnimationData);
+
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"%s: packed vertices, %zu to %zu bytes for %zu vertices\n",
+            m_filePath.filename().c_str(),
+            uFullSize * m_aVertices.size(),
+            uPackedSize * m_aVertices.size(),
+            m_aVertices.size()
+        );
+        OutputDebugString(szMessage);
+
+        return S_OK;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::interpolatePosition
       Summary:  Interpolate two keyframes to find translate vector
@@ -794,9 +1318,7 @@ namespace library
 
                 std::filesystem::path fullPath = parentDirectory / szPath;
 
-                m_aMaterials[uIndex]->pDiffuse = std::make_shared<Texture>(fullPath);
-
-                hr = m_aMaterials[uIndex]->pDiffuse->Initialize(pDevice, pImmediateContext);
+                hr = m_textureCache->GetOrLoad(pDevice, pImmediateContext, fullPath, eTextureSamplerType::TRILINEAR_WRAP, m_aMaterials[uIndex]->pDiffuse);
                 if (FAILED(hr))
                 {
                     OutputDebugString(L"Error loading diffuse texture \"");
@@ -856,9 +1378,7 @@ namespace library
 
                 std::filesystem::path fullPath = parentDirectory / szPath;
 
-                m_aMaterials[uIndex]->pSpecularExponent = std::make_shared<Texture>(fullPath);
-
-                hr = m_aMaterials[uIndex]->pSpecularExponent->Initialize(pDevice, pImmediateContext);
+                hr = m_textureCache->GetOrLoad(pDevice, pImmediateContext, fullPath, eTextureSamplerType::TRILINEAR_WRAP, m_aMaterials[uIndex]->pSpecularExponent);
                 if (FAILED(hr))
                 {
                     OutputDebugString(L"Error loading specular texture \"");
@@ -913,9 +1433,7 @@ namespace library
 
                 std::filesystem::path fullPath = parentDirectory / szPath;
 
-                m_aMaterials[uIndex]->pNormal = std::make_shared<Texture>(fullPath);
-                m_bHasNormalMap = true;
-
+                hr = m_textureCache->GetOrLoad(pDevice, pImmediateContext, fullPath, eTextureSamplerType::TRILINEAR_WRAP, m_aMaterials[uIndex]->pNormal);
                 if (FAILED(hr))
                 {
                     OutputDebugString(L"Error loading normal texture \"");
@@ -925,6 +1443,8 @@ namespace library
                     return hr;
                 }
 
+                m_bHasNormalMap = true;
+
                 OutputDebugString(L"Loaded normal texture \"");
                 OutputDebugString(fullPath.c_str());
                 OutputDebugString(L"\"\n");
@@ -971,6 +1491,115 @@ namespace library
 
         return hr;
     }
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::optimizeMeshes
+      Summary:  Reorders the triangles of every mesh for the vertex
+                cache and overdraw, then renumbers its vertices in
+                first-use order, moving the normal and bone data with
+                them. The result is kept in MESH_CACHE_DIRECTORY under
+                a hash of the imported data, so later loads only read
+                it back. The simulated cache misses before and after are
+                reported to the debug output
+      Modifies: [m_aVertices, m_aNormalData, m_aIndices, m_skinWeights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::optimizeMeshes()
+    {
+        PROFILE_ZONE("Model::optimizeMeshes");
+
+        uint64_t uKey = Hash::Fnv1a(m_aVertices.data(), m_aVertices.size() * sizeof(SimpleVertex));
+        uKey = Hash::Fnv1a(m_aIndices.data(), m_aIndices.size() * sizeof(WORD), uKey);
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            uKey = Hash::Combine(uKey, mesh.uBaseVertex);
+            uKey = Hash::Combine(uKey, mesh.uBaseIndex);
+            uKey = Hash::Combine(uKey, mesh.uNumIndices);
+        }
+        uKey = Hash::Combine(uKey, MeshOptimizer::CACHE_SIZE);
+
+        WCHAR szFileName[32];
+        swprintf_s(szFileName, L"%016llx.mesh", static_cast<unsigned long long>(uKey));
+        std::filesystem::path cachePath = std::filesystem::path(MESH_CACHE_DIRECTORY) / szFileName;
+
+        const UINT uNumVertices = static_cast<UINT>(m_aVertices.size());
+        std::vector<UINT> auRemap;
+        std::vector<WORD> aIndices;
+        BOOL bIsCached = MeshOptimizer::LoadCache(cachePath, uKey, auRemap, aIndices)
+            && auRemap.size() == m_aVertices.size() && aIndices.size() == m_aIndices.size();
+
+        if (!bIsCached)
+        {
+            auRemap.resize(uNumVertices);
+            aIndices = m_aIndices;
+
+            std::vector<UINT> auClusters;
+            std::vector<UINT> auMeshRemap;
+            for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+            {
+                const BasicMeshEntry& mesh = m_aMeshes[i];
+                const UINT uEndVertex = i + 1u < m_aMeshes.size() ? m_aMeshes[i + 1u].uBaseVertex : uNumVertices;
+                WORD* aMeshIndices = aIndices.data() + mesh.uBaseIndex;
+
+                MeshOptimizer::OptimizeVertexCache(aMeshIndices, mesh.uNumIndices, uEndVertex - mesh.uBaseVertex, auClusters);
+                MeshOptimizer::OptimizeOverdraw(&m_aVertices[mesh.uBaseVertex], aMeshIndices, mesh.uNumIndices, auClusters);
+                MeshOptimizer::OptimizeVertexFetch(aMeshIndices, mesh.uNumIndices, uEndVertex - mesh.uBaseVertex, auMeshRemap);
+
+                for (UINT v = 0u; v < auMeshRemap.size(); ++v)
+                {
+                    auRemap[mesh.uBaseVertex + v] = mesh.uBaseVertex + auMeshRemap[v];
+                }
+            }
+
+            MeshOptimizer::SaveCache(cachePath, uKey, auRemap, aIndices);
+        }
+
+        UINT uNumTrianglesTotal = 0u;
+        UINT uNumTransformsBefore = 0u;
+        UINT uNumTransformsAfter = 0u;
+        UINT uNumVerticesTotal = 0u;
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            const UINT uEndVertex = i + 1u < m_aMeshes.size() ? m_aMeshes[i + 1u].uBaseVertex : uNumVertices;
+
+            uNumTransformsBefore += MeshOptimizer::AnalyzeVertexCache(&m_aIndices[mesh.uBaseIndex], mesh.uNumIndices, uEndVertex - mesh.uBaseVertex).uNumTransforms;
+            uNumTransformsAfter += MeshOptimizer::AnalyzeVertexCache(&aIndices[mesh.uBaseIndex], mesh.uNumIndices, uEndVertex - mesh.uBaseVertex).uNumTransforms;
+            uNumTrianglesTotal += mesh.uNumIndices / 3u;
+            uNumVerticesTotal += uEndVertex - mesh.uBaseVertex;
+        }
+
+        m_aIndices = std::move(aIndices);
+
+        std::vector<SimpleVertex> aVertices(uNumVertices);
+        std::vector<NormalData> aNormalData(m_aNormalData.size());
+        for (UINT v = 0u; v < uNumVertices; ++v)
+        {
+            aVertices[auRemap[v]] = m_aVertices[v];
+            if (v < aNormalData.size())
+            {
+                aNormalData[auRemap[v]] = m_aNormalData[v];
+            }
+        }
+        m_aVertices = std::move(aVertices);
+        m_aNormalData = std::move(aNormalData);
+        m_skinWeights.Remap(auRemap);
+
+        if (uNumTrianglesTotal > 0u && uNumVerticesTotal > 0u)
+        {
+            WCHAR szMessage[256];
+            swprintf_s(
+                szMessage,
+                L"%s %s: ACMR %.3f to %.3f, ATVR %.3f to %.3f\n",
+                m_filePath.filename().c_str(),
+                bIsCached ? L"(cached)" : L"(optimized)",
+                static_cast<FLOAT>(uNumTransformsBefore) / static_cast<FLOAT>(uNumTrianglesTotal),
+                static_cast<FLOAT>(uNumTransformsAfter) / static_cast<FLOAT>(uNumTrianglesTotal),
+                static_cast<FLOAT>(uNumTransformsBefore) / static_cast<FLOAT>(uNumVerticesTotal),
+                static_cast<FLOAT>(uNumTransformsAfter) / static_cast<FLOAT>(uNumVerticesTotal)
+            );
+            OutputDebugString(szMessage);
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
      Method:   Model::readNodeHierarchy
      Summary:  Calculate bone transformation of the given assimp node
@@ -983,6 +1612,8 @@ namespace library
    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform)
     {
+        PROFILE_ZONE("Model::readNodeHierarchy");
+
         assert(pNode);
         const aiNodeAnim* pNodeAnim = findNodeAnimOrNull(m_pScene->mAnimations[0], pNode->mName.C_Str());
         XMMATRIX nodeTransformation = ConvertMatrix(pNode->mTransformation);
@@ -1034,6 +1665,6 @@ namespace library
     {
         m_aVertices.reserve(uNumVertices);
         m_aIndices.reserve(uNumIndices);
-        m_aBoneData.resize(uNumVertices);
+        m_skinWeights.Resize(uNumVertices);
     }
 }
\ No newline at end of file
@@ -9,11 +9,14 @@
 #pragma once
 
 #include "Common.h"
+#include "Model/SkinWeightBuilder.h"
 #include "Renderer/DataTypes.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/VertexCompression.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
+#include "Texture/TextureCache.h"
 
 struct aiScene;
 struct aiMesh;
@@ -52,6 +55,46 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetPermutation
+                  Returns the shader features, with skinning for
+                  models that have bones
+                SetPackedVertices
+                  Selects the packed vertex formats, before Initialize
+                HasPackedVertices
+                  Returns whether the buffers hold packed vertices
+                GetPositionScale
+                  Returns the decode scale of the packed positions
+                GetPositionOffset
+                  Returns the decode offset of the packed positions
+                GetPositionDecodeMatrix
+                  Returns the decode of the packed positions as a
+                  matrix
+                GetNumLods
+                  Returns the number of levels of detail of a mesh
+                GetMeshLod
+                  Returns the index range of a level of detail
+                SelectLod
+                  Returns the coarsest level of a mesh whose error
+                  stays under a pixel
+                GetSkinningBuffer
+                  Returns the bone palette of the vertex shader
+                GetSkinningShaderResourceView
+                  Returns the view of the bone palette
+                UploadBonePalette
+                  Writes the bones of the skeleton to the palette
+                GetInterpolatedBoneTransform
+                  Returns a bone transform between the last two
+                  simulation ticks
+                StorePreviousState
+                  Keeps the world matrix and bone transforms of the
+                  last tick
+                GetFilePath
+                  Returns the path of the model file
+                SetTextureCache
+                  Sets the texture cache the textures are loaded
+                  through, before Initialize
+                GetTextureCache
+                  Returns the texture cache of the model
                 Model
                   Constructor.
                 ~Model
@@ -59,6 +102,25 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Model : public Renderable
     {
+    public:
+        static constexpr const UINT MAX_NUM_LODS = 4u;
+        static constexpr const FLOAT MAX_LOD_ERROR_PIXELS = 1.0f;
+        static constexpr const PCWSTR MESH_CACHE_DIRECTORY = L"MeshCache";
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   MeshLod
+          Summary:  Range of the index buffer that draws one level of
+                    detail of a mesh, and how far, in model units, the
+                    level strays from the original surface. Level 0 is
+                    the mesh itself
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct MeshLod
+        {
+            UINT uBaseIndex;
+            UINT uNumIndices;
+            FLOAT error;
+        };
+
     public:
         Model() = delete;
         Model(_In_ const std::filesystem::path& filePath);
@@ -66,51 +128,40 @@ namespace library
         Model(Model&& other) = delete;
         Model& operator=(const Model& other) = delete;
         Model& operator=(Model&& other) = delete;
-        virtual ~Model() = default;
+        virtual ~Model();
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         virtual void Update(_In_ FLOAT deltaTime) override;
 
         ComPtr<ID3D11Buffer>& GetAnimationBuffer();
-        ComPtr<ID3D11Buffer>& GetSkinningConstantBuffer();
+        ComPtr<ID3D11Buffer>& GetSkinningBuffer();
+        ComPtr<ID3D11ShaderResourceView>& GetSkinningShaderResourceView();
+        HRESULT UploadBonePalette(_In_ ID3D11DeviceContext* pImmediateContext, _In_ const BoneTransform3x4* aBoneTransforms, _In_ UINT uNumBones);
 
         virtual UINT GetNumVertices() const override;
         virtual UINT GetNumIndices() const override;
+        virtual ShaderPermutation GetPermutation() const override;
 
-        std::vector<XMMATRIX>& GetBoneTransforms();
-        const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
+        void SetPackedVertices(_In_ BOOL bHasPackedVertices);
+        BOOL HasPackedVertices() const;
+        const XMFLOAT4& GetPositionScale() const;
+        const XMFLOAT4& GetPositionOffset() const;
+        XMMATRIX GetPositionDecodeMatrix() const;
 
-    protected:
-        struct VertexBoneData
-        {
-            VertexBoneData()
-                : aBoneIds{ 0u, }
-                , aWeights{ 0.0f, }
-                , uNumBones(0u)
-            {
-                ZeroMemory(aBoneIds, ARRAYSIZE(aBoneIds) * sizeof(aBoneIds[0]));
-                ZeroMemory(aWeights, ARRAYSIZE(aWeights) * sizeof(aWeights[0]));
-            }
+        UINT GetNumLods(_In_ UINT uMesh) const;
+        const MeshLod& GetMeshLod(_In_ UINT uMesh, _In_ UINT uLod) const;
+        UINT SelectLod(_In_ UINT uMesh, _In_ FLOAT pixelsPerUnit) const;
 
-            void AddBoneData(_In_ UINT uBoneId, _In_ FLOAT weight)
-            {
-                assert(uNumBones < ARRAYSIZE(aBoneIds));
-
-                aBoneIds[uNumBones] = uBoneId;
-                aWeights[uNumBones] = weight;
-
-                static CHAR szDebugMessage[256];
-                sprintf_s(szDebugMessage, "\t\t\tBone %d, weight: %f, index %u\n", uBoneId, weight, uNumBones);
-                OutputDebugStringA(szDebugMessage);
+        std::vector<XMMATRIX>& GetBoneTransforms();
+        XMMATRIX GetInterpolatedBoneTransform(_In_ UINT uIndex, _In_ FLOAT alpha) const;
+        virtual void StorePreviousState() override;
+        const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
+        const std::filesystem::path& GetFilePath() const;
 
-                ++uNumBones;
-            }
-
-            UINT aBoneIds[MAX_NUM_BONES_PER_VERTEX];
-            FLOAT aWeights[MAX_NUM_BONES_PER_VERTEX];
-            UINT uNumBones;
-        };
+        void SetTextureCache(_In_ const std::shared_ptr<TextureCache>& textureCache);
+        const std::shared_ptr<TextureCache>& GetTextureCache() const;
 
+    protected:
         struct BoneInfo
         {
             BoneInfo() = default;
@@ -129,6 +180,7 @@ namespace library
         UINT findPosition(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         UINT findRotation(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         UINT findScaling(_In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
+        void generateLods();
         UINT getBoneId(_In_ const aiBone* pBone);
         const virtual SimpleVertex* getVertices() const override;
         virtual const WORD* getIndices() const override;
@@ -147,7 +199,9 @@ namespace library
         );
         void initMeshBones(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
         void initMeshSingleBone(_In_ UINT uBoneIndex, _In_ const aiBone* pBone);
+        void optimizeMeshes();
         virtual void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
+        virtual HRESULT initializeVertexBuffers(_In_ ID3D11Device* pDevice) override;
         void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
@@ -182,29 +236,36 @@ namespace library
         void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform);
         void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
 
-    protected:
-        static std::unique_ptr<Assimp::Importer> sm_pImporter;
-
     protected:
         std::filesystem::path m_filePath;
+        std::shared_ptr<TextureCache> m_textureCache;
 
         ComPtr<ID3D11Buffer> m_animationBuffer;
-        ComPtr<ID3D11Buffer> m_skinningConstantBuffer;
+        ComPtr<ID3D11Buffer> m_skinningBuffer;
+        ComPtr<ID3D11ShaderResourceView> m_skinningShaderResourceView;
 
         std::vector<SimpleVertex> m_aVertices;
         std::vector<AnimationData> m_aAnimationData;
         std::vector<WORD> m_aIndices;
-        std::vector<VertexBoneData> m_aBoneData;
+        std::vector<std::vector<MeshLod>> m_aMeshLods;
+        SkinWeightBuilder m_skinWeights;
         std::vector<BoneInfo> m_aBoneInfo;
         std::vector<XMMATRIX> m_aTransforms;
+        std::vector<XMMATRIX> m_aPreviousTransforms;
         std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
 
+        // Owns m_pScene. Every model has its own, so models can be loaded concurrently
+        std::unique_ptr<Assimp::Importer> m_pImporter;
         const aiScene* m_pScene;
 
         float m_timeSinceLoaded;
 
         XMMATRIX m_globalInverseTransform;
 
+        XMFLOAT4 m_positionScale;
+        XMFLOAT4 m_positionOffset;
+        BOOL m_bHasPackedVertices;
+
         //BYTE m_padding[8];
     };
 }
\ No newline at end of file
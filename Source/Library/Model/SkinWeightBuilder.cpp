@@ -0,0 +1,174 @@
+#include "Model/SkinWeightBuilder.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Renderer/VertexCompression.h"
+
+namespace library
+{
+    using namespace DirectX;
+
+    static_assert(MAX_NUM_BONES_PER_VERTEX == 4, "AnimationData holds four influences");
+    static_assert(MAX_NUM_BONES <= 256, "Bone indices do not fit in SkinWeightBuilder::Influences");
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::SkinWeightBuilder
+      Summary:  Constructor
+      Modifies: [m_aInfluences, m_uNumDroppedWeights,
+                 m_maxDroppedWeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SkinWeightBuilder::SkinWeightBuilder()
+        : m_aInfluences()
+        , m_uNumDroppedWeights(0u)
+        , m_maxDroppedWeight(0.0f)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::Resize
+      Summary:  Sets the number of vertices. New vertices have no
+                weights
+      Args:     uint32_t uNumVertices
+                  Number of vertices
+      Modifies: [m_aInfluences].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinWeightBuilder::Resize(uint32_t uNumVertices)
+    {
+        m_aInfluences.resize(uNumVertices, Influences{});
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::AddWeight
+      Summary:  Adds the weight of a bone to a vertex, keeping its
+                weights sorted from the largest. When all slots are
+                taken the smallest weight is dropped
+      Args:     uint32_t uVertex
+                  Index of the vertex
+                uint32_t uBoneId
+                  Index of the bone, below MAX_NUM_BONES
+                float weight
+                  Weight of the bone
+      Modifies: [m_aInfluences, m_uNumDroppedWeights,
+                 m_maxDroppedWeight].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinWeightBuilder::AddWeight(uint32_t uVertex, uint32_t uBoneId, float weight)
+    {
+        assert(uVertex < m_aInfluences.size());
+        assert(uBoneId < MAX_NUM_BONES);
+
+        if (!(weight > 0.0f))
+        {
+            return;
+        }
+
+        Influences& influences = m_aInfluences[uVertex];
+
+        constexpr const uint32_t uLast = MAX_NUM_BONES_PER_VERTEX - 1u;
+        if (weight <= influences.aWeights[uLast])
+        {
+            ++m_uNumDroppedWeights;
+            m_maxDroppedWeight = (std::max)(m_maxDroppedWeight, weight);
+            return;
+        }
+
+        if (influences.aWeights[uLast] > 0.0f)
+        {
+            ++m_uNumDroppedWeights;
+            m_maxDroppedWeight = (std::max)(m_maxDroppedWeight, influences.aWeights[uLast]);
+        }
+
+        // Insertion into the sorted slots, the smallest falls off the end
+        uint32_t uSlot = uLast;
+        while (uSlot > 0u && influences.aWeights[uSlot - 1u] < weight)
+        {
+            influences.aWeights[uSlot] = influences.aWeights[uSlot - 1u];
+            influences.aBoneIds[uSlot] = influences.aBoneIds[uSlot - 1u];
+            --uSlot;
+        }
+
+        influences.aWeights[uSlot] = weight;
+        influences.aBoneIds[uSlot] = static_cast<uint8_t>(uBoneId);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::Remap
+      Summary:  Moves the weights of vertex v to auRemap[v], after the
+                vertices of the model were renumbered
+      Args:     const std::vector<uint32_t>& auRemap
+                  New index of every vertex
+      Modifies: [m_aInfluences].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinWeightBuilder::Remap(const std::vector<uint32_t>& auRemap)
+    {
+        std::vector<Influences> aInfluences(m_aInfluences.size(), Influences{});
+        for (uint32_t v = 0u; v < m_aInfluences.size() && v < auRemap.size(); ++v)
+        {
+            aInfluences[auRemap[v]] = m_aInfluences[v];
+        }
+
+        m_aInfluences = std::move(aInfluences);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::Build
+      Summary:  Returns the animation data of every vertex. The kept
+                weights are renormalized to add up to one and rounded
+                to multiples of 1/255 the way PackAnimationData does.
+                Vertices without weights keep zero weights
+      Args:     std::vector<AnimationData>& aAnimationData
+                  Receives one entry per vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SkinWeightBuilder::Build(std::vector<AnimationData>& aAnimationData) const
+    {
+        aAnimationData.resize(m_aInfluences.size());
+
+        for (size_t i = 0; i < m_aInfluences.size(); ++i)
+        {
+            const Influences& influences = m_aInfluences[i];
+
+            AnimationData animationData =
+            {
+                .aBoneIndices = XMUINT4(influences.aBoneIds[0], influences.aBoneIds[1], influences.aBoneIds[2], influences.aBoneIds[3]),
+                .aBoneWeights = XMFLOAT4(influences.aWeights)
+            };
+
+            aAnimationData[i] = VertexCompression::UnpackAnimationData(VertexCompression::PackAnimationData(animationData));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::GetNumVertices
+      Summary:  Returns the number of vertices
+      Returns:  uint32_t
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t SkinWeightBuilder::GetNumVertices() const
+    {
+        return static_cast<uint32_t>(m_aInfluences.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::GetNumDroppedWeights
+      Summary:  Returns the number of weights that did not fit in the
+                slots of their vertex
+      Returns:  uint32_t
+                  Number of dropped weights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t SkinWeightBuilder::GetNumDroppedWeights() const
+    {
+        return m_uNumDroppedWeights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkinWeightBuilder::GetMaxDroppedWeight
+      Summary:  Returns the largest weight that did not fit, before
+                renormalization
+      Returns:  float
+                  Largest dropped weight, zero when none was dropped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float SkinWeightBuilder::GetMaxDroppedWeight() const
+    {
+        return m_maxDroppedWeight;
+    }
+}
@@ -0,0 +1,87 @@
+/*+===================================================================
+  File:      SKINWEIGHTBUILDER.H
+
+  Summary:   SkinWeightBuilder header file contains declaration of class
+             SkinWeightBuilder used to collect the bone weights of a
+             skinned model at import and turn them into AnimationData.
+             It only depends on DirectXMath and the standard library.
+
+  Classes:  SkinWeightBuilder
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Renderer/VertexTypes.h"
+#include "Shaders/ShaderConstants.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SkinWeightBuilder
+      Summary:  Keeps the MAX_NUM_BONES_PER_VERTEX largest weights of
+                every vertex, sorted from the largest, in 20 bytes per
+                vertex. A weight that does not fit replaces the smallest
+                one when it is larger, and the dropped weight is only
+                counted, so adding a weight never logs or allocates.
+                Build renormalizes the kept weights and rounds them to
+                the 8-bit weights of the packed vertex format, so the
+                full and packed vertices skin the same
+      Methods:  Resize
+                  Sets the number of vertices, without weights
+                AddWeight
+                  Adds the weight of a bone to a vertex
+                Remap
+                  Moves the weights along with renumbered vertices
+                Build
+                  Returns the animation data of every vertex
+                GetNumVertices
+                  Returns the number of vertices
+                GetNumDroppedWeights
+                  Returns the number of weights that did not fit
+                GetMaxDroppedWeight
+                  Returns the largest weight that did not fit
+                SkinWeightBuilder
+                  Constructor.
+                ~SkinWeightBuilder
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SkinWeightBuilder
+    {
+    public:
+        SkinWeightBuilder();
+        SkinWeightBuilder(const SkinWeightBuilder& other) = delete;
+        SkinWeightBuilder(SkinWeightBuilder&& other) = delete;
+        SkinWeightBuilder& operator=(const SkinWeightBuilder& other) = delete;
+        SkinWeightBuilder& operator=(SkinWeightBuilder&& other) = delete;
+        ~SkinWeightBuilder() = default;
+
+        void Resize(uint32_t uNumVertices);
+        void AddWeight(uint32_t uVertex, uint32_t uBoneId, float weight);
+        void Remap(const std::vector<uint32_t>& auRemap);
+        void Build(std::vector<AnimationData>& aAnimationData) const;
+
+        uint32_t GetNumVertices() const;
+        uint32_t GetNumDroppedWeights() const;
+        float GetMaxDroppedWeight() const;
+
+    protected:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Influences
+          Summary:  Largest weights of a vertex, unused slots are zero
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Influences
+        {
+            float aWeights[MAX_NUM_BONES_PER_VERTEX];
+            uint8_t aBoneIds[MAX_NUM_BONES_PER_VERTEX];
+        };
+
+    protected:
+        std::vector<Influences> m_aInfluences;
+        uint32_t m_uNumDroppedWeights;
+        float m_maxDroppedWeight;
+    };
+}
@@ -0,0 +1,66 @@
+#include "Renderer/BonePalette.h"
+
+#include "Shaders/ShaderConstants.h"
+
+namespace library
+{
+    using namespace DirectX;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BonePalette::StoreTransposed3x4
+      Summary:  Stores the first three rows of the transpose of an
+                affine matrix, the columns the vertex shader dots the
+                position with. Three shuffle stages like
+                XMMatrixTranspose, without the fourth row
+      Args:     FXMMATRIX matrix
+                  Affine bone matrix, for row vectors
+                BoneTransform3x4& outBoneTransform
+                  Receives the transposed rows
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BonePalette::StoreTransposed3x4(FXMMATRIX matrix, BoneTransform3x4& outBoneTransform)
+    {
+        // x0 x2 y0 y2, x1 x3 y1 y3, z0 z2 w0 w2, z1 z3 w1 w3
+        XMVECTOR xy02 = XMVectorMergeXY(matrix.r[0], matrix.r[2]);
+        XMVECTOR xy13 = XMVectorMergeXY(matrix.r[1], matrix.r[3]);
+        XMVECTOR zw02 = XMVectorMergeZW(matrix.r[0], matrix.r[2]);
+        XMVECTOR zw13 = XMVectorMergeZW(matrix.r[1], matrix.r[3]);
+
+        XMStoreFloat4(&outBoneTransform.Rows[0], XMVectorMergeXY(xy02, xy13));
+        XMStoreFloat4(&outBoneTransform.Rows[1], XMVectorMergeZW(xy02, xy13));
+        XMStoreFloat4(&outBoneTransform.Rows[2], XMVectorMergeXY(zw02, zw13));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BonePalette::SkinPosition
+      Summary:  Sums the weighted rows of the bones of a vertex and
+                dots the position with them, like the skinning vertex
+                shader
+      Args:     const BoneTransform3x4* aBoneTransforms
+                  Bone palette of the model
+                const AnimationData& animationData
+                  Bone indices and weights of the vertex
+                FXMVECTOR position
+                  Position in the bind pose, w is ignored
+      Returns:  XMVECTOR
+                  Skinned position, w is 1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR BonePalette::SkinPosition(const BoneTransform3x4* aBoneTransforms, const AnimationData& animationData, FXMVECTOR position)
+    {
+        const uint32_t auBoneIndices[MAX_NUM_BONES_PER_VERTEX] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+        const float aBoneWeights[MAX_NUM_BONES_PER_VERTEX] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+
+        XMVECTOR aSkinRows[3] = { XMVectorZero(), XMVectorZero(), XMVectorZero() };
+        for (uint32_t i = 0u; i < MAX_NUM_BONES_PER_VERTEX; ++i)
+        {
+            const BoneTransform3x4& bone = aBoneTransforms[auBoneIndices[i]];
+            for (uint32_t uRow = 0u; uRow < 3u; ++uRow)
+            {
+                aSkinRows[uRow] = XMVectorMultiplyAdd(XMVectorReplicate(aBoneWeights[i]), XMLoadFloat4(&bone.Rows[uRow]), aSkinRows[uRow]);
+            }
+        }
+
+        XMVECTOR homogeneous = XMVectorSetW(position, 1.0f);
+        return XMVectorSet(XMVectorGetX(XMVector4Dot(aSkinRows[0], homogeneous)), XMVectorGetX(XMVector4Dot(aSkinRows[1], homogeneous)),
+            XMVectorGetX(XMVector4Dot(aSkinRows[2], homogeneous)), 1.0f);
+    }
+}
@@ -0,0 +1,46 @@
+/*+===================================================================
+  File:      BONEPALETTE.H
+
+  Summary:   BonePalette header file contains declaration of class
+             BonePalette used to write the 3x4 bone transforms the
+             skinning vertex shader reads, and to skin positions with
+             them on the CPU the way the shader does. It only depends
+             on DirectXMath and the standard library.
+
+  Classes:  BonePalette
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Renderer/VertexTypes.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BonePalette
+      Summary:  Converts affine bone matrices to BoneTransform3x4. The
+                fourth column of an affine row-vector matrix is always
+                (0, 0, 0, 1), so the transposed matrix only needs its
+                first three rows, and skinning is three dot products
+      Methods:  StoreTransposed3x4
+                  Stores the first three rows of the transpose of a
+                  bone matrix
+                SkinPosition
+                  Blends the bone transforms of a vertex and applies
+                  them to a position
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BonePalette
+    {
+    public:
+        BonePalette() = delete;
+        BonePalette(const BonePalette& other) = delete;
+        BonePalette(BonePalette&& other) = delete;
+        BonePalette& operator=(const BonePalette& other) = delete;
+        BonePalette& operator=(BonePalette&& other) = delete;
+        ~BonePalette() = delete;
+
+        static void StoreTransposed3x4(DirectX::FXMMATRIX matrix, BoneTransform3x4& outBoneTransform);
+        static DirectX::XMVECTOR SkinPosition(const BoneTransform3x4* aBoneTransforms, const AnimationData& animationData, DirectX::FXMVECTOR position);
+    };
+}
@@ -1,72 +1,56 @@
 #pragma once
 
-#include "Common.h"
+#include <cstdint>
 
-namespace library
-{
-#define NUM_LIGHTS (1)
-#define MAX_NUM_BONES (256)
-#define MAX_NUM_BONES_PER_VERTEX (16)
+#include <DirectXMath.h>
 
-	struct SimpleVertex
-	{
-		XMFLOAT3 Position;
-		XMFLOAT2 TexCoord;
-		XMFLOAT3 Normal;
-	};
+#include "Renderer/VertexTypes.h"
+#include "Shaders/ShaderConstants.h"
 
+namespace library
+{
 	struct InstanceData
 	{
-		XMMATRIX Transformation;
-	};
-
-	struct AnimationData
-	{
-		XMUINT4 aBoneIndices;
-		XMFLOAT4 aBoneWeights;
-	};
-
-	struct NormalData
-	{
-		XMFLOAT3 Tangent;
-		XMFLOAT3 Bitangent;
+		DirectX::XMMATRIX Transformation;
 	};
 
 	struct CBChangeOnCameraMovement
 	{
-		XMMATRIX View;
-		XMFLOAT4 CameraPosition;
+		DirectX::XMMATRIX View;
+		DirectX::XMFLOAT4 CameraPosition;
 	};
 
 	struct CBChangeOnResize
 	{
-		XMMATRIX Projection;
+		DirectX::XMMATRIX Projection;
 	};
 
 	struct CBChangesEveryFrame
 	{
-		XMMATRIX World;
-		XMFLOAT4 OutputColor;
-		BOOL HasNormalMap;
-	};
+		DirectX::XMMATRIX World;
+		DirectX::XMFLOAT4 OutputColor;
 
-	struct CBSkinning
-	{
-		XMMATRIX BoneTransforms[MAX_NUM_BONES];
+		// HLSL bools take 4 bytes, like BOOL
+		int32_t HasNormalMap;
+		uint8_t Padding[12];
+
+		// Decode of the packed positions, in a new register as in HLSL
+		DirectX::XMFLOAT4 PositionScale;
+		DirectX::XMFLOAT4 PositionOffset;
 	};
 
 	struct CBLights
 	{
-		XMFLOAT4 LightPositions[NUM_LIGHTS];
-		XMFLOAT4 LightColors[NUM_LIGHTS];
-		XMFLOAT4 LightAttenuationDistance[NUM_LIGHTS];
+		DirectX::XMFLOAT4 LightPositions[NUM_LIGHTS];
+		DirectX::XMFLOAT4 LightColors[NUM_LIGHTS];
+		DirectX::XMFLOAT4 LightAttenuationDistance[NUM_LIGHTS];
 	};
 
 	struct CBShadowMatrix
 	{
-		XMMATRIX World;
-		XMMATRIX View;
-		XMMATRIX Projection;
-		BOOL IsVoxel;
+		DirectX::XMMATRIX World;
+		DirectX::XMMATRIX View;
+		DirectX::XMMATRIX Projection;
+		int32_t IsVoxel;
 	};
 }
\ No newline at end of file
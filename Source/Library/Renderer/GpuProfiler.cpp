@@ -0,0 +1,289 @@
+#include "Renderer/GpuProfiler.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::GpuProfiler
+      Summary:  Constructor
+      Modifies: [m_aFrames, m_uFrameIndex, m_uDepth, m_auOpenZones,
+                 m_uTrack, m_bIsTiming].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    GpuProfiler::GpuProfiler()
+        : m_aFrames()
+        , m_uFrameIndex(0u)
+        , m_uDepth(0u)
+        , m_auOpenZones{ 0u }
+        , m_uTrack(0u)
+        , m_bIsTiming(FALSE)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::Initialize
+      Summary:  Creates the queries of every frame in flight and the
+                profiler track the results go to
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the queries
+      Modifies: [m_aFrames, m_uTrack].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT GpuProfiler::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
+        std::unique_ptr<Frame[]> aFrames = std::make_unique<Frame[]>(NUM_FRAMES);
+
+        D3D11_QUERY_DESC disjointDesc =
+        {
+            .Query = D3D11_QUERY_TIMESTAMP_DISJOINT,
+            .MiscFlags = 0u
+        };
+        D3D11_QUERY_DESC timestampDesc =
+        {
+            .Query = D3D11_QUERY_TIMESTAMP,
+            .MiscFlags = 0u
+        };
+
+        for (UINT i = 0u; i < NUM_FRAMES; ++i)
+        {
+            Frame& frame = aFrames[i];
+            frame.uNumZones = 0u;
+            frame.uCpuBeginNs = 0u;
+            frame.bIsPending = FALSE;
+
+            hr = pDevice->CreateQuery(&disjointDesc, frame.disjointQuery.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            hr = pDevice->CreateQuery(&timestampDesc, frame.beginQuery.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            for (UINT uZone = 0u; uZone < MAX_ZONES_PER_FRAME; ++uZone)
+            {
+                frame.aZones[uZone].pszName = nullptr;
+                frame.aZones[uZone].uDepth = 0u;
+
+                hr = pDevice->CreateQuery(&timestampDesc, frame.aZones[uZone].beginQuery.GetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                hr = pDevice->CreateQuery(&timestampDesc, frame.aZones[uZone].endQuery.GetAddressOf());
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        m_aFrames = std::move(aFrames);
+        m_uTrack = Profiler::AddTrack("GPU");
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::BeginFrame
+      Summary:  Reads back the frame whose queries are about to be
+                reused, then starts timing a new one. Nothing is timed
+                while the Profiler is disabled
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to issue the queries on
+      Modifies: [m_aFrames, m_uDepth, m_bIsTiming].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GpuProfiler::BeginFrame(_In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        m_bIsTiming = FALSE;
+        if (!m_aFrames || !Profiler::IsEnabled())
+        {
+            return;
+        }
+
+        Frame& frame = m_aFrames[m_uFrameIndex];
+        if (frame.bIsPending)
+        {
+            resolve(pImmediateContext, frame);
+        }
+
+        frame.uNumZones = 0u;
+        frame.uCpuBeginNs = Profiler::GetTimeNs();
+
+        pImmediateContext->Begin(frame.disjointQuery.Get());
+        pImmediateContext->End(frame.beginQuery.Get());
+
+        m_uDepth = 0u;
+        m_bIsTiming = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::EndFrame
+      Summary:  Stops timing the frame and moves to the next set of
+                queries
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to issue the queries on
+      Modifies: [m_aFrames, m_uFrameIndex, m_bIsTiming].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GpuProfiler::EndFrame(_In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_bIsTiming)
+        {
+            return;
+        }
+
+        Frame& frame = m_aFrames[m_uFrameIndex];
+        pImmediateContext->End(frame.disjointQuery.Get());
+        frame.bIsPending = TRUE;
+
+        m_uFrameIndex = (m_uFrameIndex + 1u) % NUM_FRAMES;
+        m_bIsTiming = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::BeginZone
+      Summary:  Opens a zone nested in the open ones. Zones past
+                MAX_ZONES_PER_FRAME are not timed
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to issue the queries on
+                const char* pszName
+                  Name of the zone, kept as a pointer
+      Modifies: [m_aFrames, m_uDepth, m_auOpenZones].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GpuProfiler::BeginZone(_In_ ID3D11DeviceContext* pImmediateContext, _In_ const char* pszName)
+    {
+        if (!m_bIsTiming)
+        {
+            return;
+        }
+
+        if (m_uDepth < Profiler::MAX_DEPTH)
+        {
+            Frame& frame = m_aFrames[m_uFrameIndex];
+            UINT uZone = UINT_MAX;
+            if (frame.uNumZones < MAX_ZONES_PER_FRAME)
+            {
+                uZone = frame.uNumZones++;
+                frame.aZones[uZone].pszName = pszName;
+                frame.aZones[uZone].uDepth = m_uDepth;
+                pImmediateContext->End(frame.aZones[uZone].beginQuery.Get());
+            }
+            m_auOpenZones[m_uDepth] = uZone;
+        }
+        ++m_uDepth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::EndZone
+      Summary:  Closes the innermost open zone
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to issue the queries on
+      Modifies: [m_uDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GpuProfiler::EndZone(_In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_bIsTiming || m_uDepth == 0u)
+        {
+            return;
+        }
+
+        --m_uDepth;
+        if (m_uDepth < Profiler::MAX_DEPTH && m_auOpenZones[m_uDepth] != UINT_MAX)
+        {
+            pImmediateContext->End(m_aFrames[m_uFrameIndex].aZones[m_auOpenZones[m_uDepth]].endQuery.Get());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfiler::resolve
+      Summary:  Adds the zones of a finished frame to the profiler.
+                Timestamps are converted with the frequency of the
+                disjoint query and offset so that the first one lands
+                on the CPU time the frame began. A frame whose results
+                are not ready yet, or whose clock changed, is dropped
+      Args:     ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to read the queries from
+                Frame& frame
+                  Frame to read
+      Modifies: [frame].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void GpuProfiler::resolve(_In_ ID3D11DeviceContext* pImmediateContext, _Inout_ Frame& frame)
+    {
+        frame.bIsPending = FALSE;
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData = {};
+        if (pImmediateContext->GetData(frame.disjointQuery.Get(), &disjointData, sizeof(disjointData), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK
+            || disjointData.Disjoint
+            || disjointData.Frequency == 0u)
+        {
+            return;
+        }
+
+        UINT64 uFrameBegin = 0u;
+        if (pImmediateContext->GetData(frame.beginQuery.Get(), &uFrameBegin, sizeof(uFrameBegin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            return;
+        }
+
+        DOUBLE nsPerTick = 1.0e9 / static_cast<DOUBLE>(disjointData.Frequency);
+        for (UINT uZone = 0u; uZone < frame.uNumZones; ++uZone)
+        {
+            const Zone& zone = frame.aZones[uZone];
+
+            UINT64 uBegin = 0u;
+            UINT64 uEnd = 0u;
+            if (pImmediateContext->GetData(zone.beginQuery.Get(), &uBegin, sizeof(uBegin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK
+                || pImmediateContext->GetData(zone.endQuery.Get(), &uEnd, sizeof(uEnd), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK
+                || uBegin < uFrameBegin
+                || uEnd < uBegin)
+            {
+                continue;
+            }
+
+            Profiler::AddZone(
+                m_uTrack,
+                zone.pszName,
+                frame.uCpuBeginNs + static_cast<uint64_t>(static_cast<DOUBLE>(uBegin - uFrameBegin) * nsPerTick),
+                frame.uCpuBeginNs + static_cast<uint64_t>(static_cast<DOUBLE>(uEnd - uFrameBegin) * nsPerTick),
+                zone.uDepth
+            );
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfileZone::GpuProfileZone
+      Summary:  Constructor. Opens a GPU zone
+      Args:     GpuProfiler* pGpuProfiler
+                  Profiler to time with, may be null
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context the timed work is issued on
+                const char* pszName
+                  Name of the zone, a string literal
+      Modifies: [m_pGpuProfiler, m_pImmediateContext].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    GpuProfileZone::GpuProfileZone(_In_opt_ GpuProfiler* pGpuProfiler, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const char* pszName)
+        : m_pGpuProfiler(pGpuProfiler)
+        , m_pImmediateContext(pImmediateContext)
+    {
+        if (m_pGpuProfiler)
+        {
+            m_pGpuProfiler->BeginZone(m_pImmediateContext, pszName);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   GpuProfileZone::~GpuProfileZone
+      Summary:  Destructor. Closes the GPU zone
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    GpuProfileZone::~GpuProfileZone()
+    {
+        if (m_pGpuProfiler)
+        {
+            m_pGpuProfiler->EndZone(m_pImmediateContext);
+        }
+    }
+}
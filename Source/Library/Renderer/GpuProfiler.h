@@ -0,0 +1,128 @@
+/*+===================================================================
+  File:      GPUPROFILER.H
+
+  Summary:   GpuProfiler header file contains declaration of class
+             GpuProfiler used to time render passes on the GPU with
+             timestamp queries, and of class GpuProfileZone that times
+             a scope.
+
+  Classes:  GpuProfiler, GpuProfileZone
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Utility/Profiler.h"
+
+// Times the GPU work issued in the rest of the enclosing scope, next to a CPU zone of the same name
+#define PROFILE_GPU_ZONE(gpuProfiler, pContext, pszName) \
+    PROFILE_ZONE(pszName); \
+    library::GpuProfileZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(gpuProfiler, pContext, pszName)
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    GpuProfiler
+      Summary:  Brackets the zones of a frame with timestamp queries
+                inside a disjoint query. Results are read NUM_FRAMES
+                frames later without flushing, so the CPU never waits
+                on the GPU, and are added to the "GPU" track of the
+                Profiler, aligned on the CPU time the frame started
+      Methods:  Initialize
+                  Creates the queries
+                BeginFrame
+                  Starts timing a frame
+                EndFrame
+                  Stops timing a frame
+                BeginZone
+                  Opens a zone
+                EndZone
+                  Closes the innermost zone
+                GpuProfiler
+                  Constructor.
+                ~GpuProfiler
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class GpuProfiler
+    {
+    public:
+        static constexpr UINT NUM_FRAMES = 4u;
+        static constexpr UINT MAX_ZONES_PER_FRAME = 64u;
+
+        GpuProfiler();
+        GpuProfiler(const GpuProfiler& other) = delete;
+        GpuProfiler(GpuProfiler&& other) = delete;
+        GpuProfiler& operator=(const GpuProfiler& other) = delete;
+        GpuProfiler& operator=(GpuProfiler&& other) = delete;
+        virtual ~GpuProfiler() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+        void BeginFrame(_In_ ID3D11DeviceContext* pImmediateContext);
+        void EndFrame(_In_ ID3D11DeviceContext* pImmediateContext);
+        void BeginZone(_In_ ID3D11DeviceContext* pImmediateContext, _In_ const char* pszName);
+        void EndZone(_In_ ID3D11DeviceContext* pImmediateContext);
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Zone
+          Summary:  Timestamps taken at the start and end of a zone
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Zone
+        {
+            const char* pszName;
+            UINT uDepth;
+            ComPtr<ID3D11Query> beginQuery;
+            ComPtr<ID3D11Query> endQuery;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Frame
+          Summary:  Queries of one frame in flight
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Frame
+        {
+            ComPtr<ID3D11Query> disjointQuery;
+            ComPtr<ID3D11Query> beginQuery;
+            Zone aZones[MAX_ZONES_PER_FRAME];
+            UINT uNumZones;
+            uint64_t uCpuBeginNs;
+            BOOL bIsPending;
+        };
+
+        void resolve(_In_ ID3D11DeviceContext* pImmediateContext, _Inout_ Frame& frame);
+
+    private:
+        std::unique_ptr<Frame[]> m_aFrames;
+        UINT m_uFrameIndex;
+        UINT m_uDepth;
+        UINT m_auOpenZones[Profiler::MAX_DEPTH];
+        uint32_t m_uTrack;
+        BOOL m_bIsTiming;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    GpuProfileZone
+      Summary:  Opens a GPU zone on construction and closes it on
+                destruction. Does nothing without a profiler
+      Methods:  GpuProfileZone
+                  Constructor.
+                ~GpuProfileZone
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class GpuProfileZone
+    {
+    public:
+        GpuProfileZone(_In_opt_ GpuProfiler* pGpuProfiler, _In_ ID3D11DeviceContext* pImmediateContext, _In_ const char* pszName);
+        GpuProfileZone(const GpuProfileZone& other) = delete;
+        GpuProfileZone(GpuProfileZone&& other) = delete;
+        GpuProfileZone& operator=(const GpuProfileZone& other) = delete;
+        GpuProfileZone& operator=(GpuProfileZone&& other) = delete;
+        ~GpuProfileZone();
+
+    private:
+        GpuProfiler* m_pGpuProfiler;
+        ID3D11DeviceContext* m_pImmediateContext;
+    };
+}
@@ -0,0 +1,453 @@
+#include "Renderer/HotReloader.h"
+
+#include "Texture/StreamingTexture.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const std::chrono::milliseconds POLL_INTERVAL(250);
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: runOnWorker
+          Summary:  Calls a rebuild function with COM initialized, which
+                    the WIC decoder of the textures needs on the thread
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        template <class Function>
+        HRESULT runOnWorker(Function&& function)
+        {
+            HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+            HRESULT hr = function();
+            if (SUCCEEDED(hrCom))
+            {
+                CoUninitialize();
+            }
+
+            return hr;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::HotReloader
+      Summary:  Constructor
+      Modifies: [m_device, m_scene, m_dependencyGraph, m_fileWatcher,
+                 m_aResources, m_jobs, m_changedWhileReloading].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HotReloader::HotReloader()
+        : m_device(nullptr)
+        , m_scene()
+        , m_dependencyGraph()
+        , m_fileWatcher(POLL_INTERVAL)
+        , m_aResources()
+        , m_jobs()
+        , m_changedWhileReloading()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::~HotReloader
+      Summary:  Destructor. Stops watching and waits for the running
+                rebuilds, whose results are dropped
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HotReloader::~HotReloader()
+    {
+        m_fileWatcher.Stop();
+
+        for (auto& [uResource, job] : m_jobs)
+        {
+            job->result.wait();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::Initialize
+      Summary:  Registers the shaders, the textures of the materials,
+                the models and the voxels of an initialized scene, and
+                starts watching their files. Shaders built from embedded
+                bytecode and streamed textures are left out
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to rebuild the resources with
+                const std::shared_ptr<Scene>& scene
+                  Scene whose resources are replaced
+      Modifies: [m_device, m_scene, m_aResources].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HotReloader::Initialize(_In_ ID3D11Device* pDevice, _In_ const std::shared_ptr<Scene>& scene)
+    {
+        if (!pDevice || !scene)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_device = pDevice;
+        m_scene = scene;
+
+        for (auto& vertexShader : m_scene->GetVertexShaders())
+        {
+            AddShader(vertexShader);
+        }
+
+        for (auto& pixelShader : m_scene->GetPixelShaders())
+        {
+            AddShader(pixelShader);
+        }
+
+        std::unordered_set<Texture*> addedTextures;
+        for (auto& material : m_scene->GetMaterials())
+        {
+            addTexture(material->pDiffuse, addedTextures);
+            addTexture(material->pSpecularExponent, addedTextures);
+            addTexture(material->pNormal, addedTextures);
+        }
+
+        for (auto& renderable : m_scene->GetRenderables())
+        {
+            addMaterialTextures(*renderable, addedTextures);
+        }
+
+        ResourceTable<std::shared_ptr<Model>>& models = m_scene->GetModels();
+        for (uint32_t uModel = 0u; uModel < models.GetSize(); ++uModel)
+        {
+            const std::shared_ptr<Model>& model = models.Get(uModel);
+            addMaterialTextures(*model, addedTextures);
+
+            std::vector<std::filesystem::path> aFilePaths = { model->GetFilePath() };
+            // Obj files keep their materials in a library next to them
+            std::filesystem::path materialLibraryPath = std::filesystem::path(model->GetFilePath()).replace_extension(L".mtl");
+            if (std::filesystem::exists(materialLibraryPath))
+            {
+                aFilePaths.push_back(materialLibraryPath);
+            }
+
+            addResource(Resource{ .type = eResourceType::MODEL, .filePath = model->GetFilePath(), .uModel = uModel });
+            m_dependencyGraph.SetDependencies(static_cast<uint32_t>(m_aResources.size() - 1u), aFilePaths);
+        }
+
+        if (m_scene->GetSkyBox())
+        {
+            addMaterialTextures(*m_scene->GetSkyBox(), addedTextures);
+        }
+
+        addMaterialTextures(*m_scene->GetVoxelPrototype(), addedTextures);
+        addResource(Resource{ .type = eResourceType::VOXELS, .filePath = m_scene->GetFilePath() });
+
+        watchFiles();
+        m_fileWatcher.Start();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::AddShader
+      Summary:  Registers a shader with the file it is compiled from and
+                every file it includes. Shaders without a file and
+                shaders already registered are skipped
+      Args:     const std::shared_ptr<Shader>& shader
+                  Initialized shader
+      Modifies: [m_aResources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::AddShader(_In_ const std::shared_ptr<Shader>& shader)
+    {
+        if (!shader || shader->GetFileName()[0] == L'\0')
+        {
+            return;
+        }
+
+        for (const Resource& resource : m_aResources)
+        {
+            if (resource.shader == shader)
+            {
+                return;
+            }
+        }
+
+        addResource(Resource{ .type = eResourceType::SHADER, .filePath = shader->GetFileName(), .shader = shader });
+        updateDependencies(static_cast<uint32_t>(m_aResources.size() - 1u));
+
+        if (m_device)
+        {
+            watchFiles();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::Update
+      Summary:  Starts a rebuild of every resource affected by the
+                files that changed, and replaces the resources whose
+                rebuild finished. Must be called between two frames. A
+                resource changed again while rebuilding is rebuilt once
+                more after the running rebuild is applied
+      Modifies: [m_jobs, m_changedWhileReloading].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::Update()
+    {
+        std::vector<std::filesystem::path> aChangedFilePaths;
+        m_fileWatcher.ConsumeChanges(aChangedFilePaths);
+
+        if (!aChangedFilePaths.empty())
+        {
+            std::vector<uint32_t> aResources;
+            m_dependencyGraph.GetAffectedResources(aChangedFilePaths, aResources);
+
+            for (uint32_t uResource : aResources)
+            {
+                if (m_jobs.contains(uResource))
+                {
+                    m_changedWhileReloading.insert(uResource);
+                }
+                else
+                {
+                    dispatch(uResource);
+                }
+            }
+        }
+
+        std::vector<uint32_t> aRedispatchedResources;
+        bool bHasReloadedShaders = false;
+        for (auto it = m_jobs.begin(); it != m_jobs.end();)
+        {
+            if (it->second->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                ++it;
+                continue;
+            }
+
+            uint32_t uResource = it->first;
+            HRESULT hr = it->second->result.get();
+            if (SUCCEEDED(hr))
+            {
+                hr = apply(uResource, *it->second);
+            }
+
+            OutputDebugString(SUCCEEDED(hr) ? L"Reloaded \"" : L"Can't reload \"");
+            OutputDebugString(m_aResources[uResource].filePath.c_str());
+            OutputDebugString(L"\"\n");
+
+            bHasReloadedShaders |= SUCCEEDED(hr) && m_aResources[uResource].type == eResourceType::SHADER;
+
+            it = m_jobs.erase(it);
+            if (m_changedWhileReloading.erase(uResource) > 0u)
+            {
+                aRedispatchedResources.push_back(uResource);
+            }
+        }
+
+        // Includes may have been added or removed by the edit
+        if (bHasReloadedShaders)
+        {
+            watchFiles();
+        }
+
+        for (uint32_t uResource : aRedispatchedResources)
+        {
+            dispatch(uResource);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::addResource
+      Summary:  Appends a resource, built from its file path. Its index
+                identifies it in the dependency graph
+      Args:     Resource&& resource
+                  Resource to add
+      Modifies: [m_aResources, m_dependencyGraph].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::addResource(_In_ Resource&& resource)
+    {
+        uint32_t uResource = static_cast<uint32_t>(m_aResources.size());
+        m_dependencyGraph.SetDependencies(uResource, { resource.filePath });
+        m_aResources.push_back(std::move(resource));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::addMaterialTextures
+      Summary:  Registers the textures of every material of an object
+      Args:     const Renderable& renderable
+                  Object whose materials are registered
+                std::unordered_set<Texture*>& addedTextures
+                  Textures registered so far
+      Modifies: [m_aResources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::addMaterialTextures(_In_ const Renderable& renderable, _Inout_ std::unordered_set<Texture*>& addedTextures)
+    {
+        for (UINT i = 0u; i < renderable.GetNumMaterials(); ++i)
+        {
+            const std::shared_ptr<Material>& material = renderable.GetMaterial(i);
+            if (material)
+            {
+                addTexture(material->pDiffuse, addedTextures);
+                addTexture(material->pSpecularExponent, addedTextures);
+                addTexture(material->pNormal, addedTextures);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::addTexture
+      Summary:  Registers a texture once. Streamed textures are skipped
+                because their residency manager keeps reading mips from
+                the file they were created with
+      Args:     const std::shared_ptr<Texture>& texture
+                  Texture, could be a nullptr
+                std::unordered_set<Texture*>& addedTextures
+                  Textures registered so far
+      Modifies: [m_aResources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::addTexture(_In_ const std::shared_ptr<Texture>& texture, _Inout_ std::unordered_set<Texture*>& addedTextures)
+    {
+        if (!texture || dynamic_cast<StreamingTexture*>(texture.get()) || !addedTextures.insert(texture.get()).second)
+        {
+            return;
+        }
+
+        addResource(Resource{ .type = eResourceType::TEXTURE, .filePath = texture->GetFilePath(), .texture = texture });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::updateDependencies
+      Summary:  Records the files included by a shader, as seen by its
+                last compilation
+      Args:     uint32_t uResource
+                  Index of the shader resource
+      Modifies: [m_dependencyGraph].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::updateDependencies(_In_ uint32_t uResource)
+    {
+        const Resource& resource = m_aResources[uResource];
+        if (resource.type != eResourceType::SHADER)
+        {
+            return;
+        }
+
+        for (const auto& [filePath, aIncludedFilePaths] : resource.shader->GetIncludes())
+        {
+            m_dependencyGraph.SetIncludes(filePath, aIncludedFilePaths);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::dispatch
+      Summary:  Starts the rebuild of a resource on a worker thread.
+                Shaders are compiled into the shader cache, textures
+                and models are created as new objects, and the voxel
+                world is loaded and meshed. Workers get no immediate
+                context, which is not thread safe
+      Args:     uint32_t uResource
+                  Index of the resource
+      Modifies: [m_jobs].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::dispatch(_In_ uint32_t uResource)
+    {
+        const Resource& resource = m_aResources[uResource];
+        std::shared_ptr<ReloadJob> job = std::make_shared<ReloadJob>();
+
+        switch (resource.type)
+        {
+        case eResourceType::SHADER:
+        {
+            std::vector<UINT> aPermutationKeys;
+            resource.shader->GetPermutationKeys(aPermutationKeys);
+
+            job->result = std::async(std::launch::async, [shader = resource.shader, aPermutationKeys]()
+            {
+                return shader->Precompile(aPermutationKeys);
+            });
+            break;
+        }
+        case eResourceType::TEXTURE:
+            job->texture = std::make_shared<Texture>(resource.filePath, resource.texture->GetSamplerType());
+            job->result = std::async(std::launch::async, [device = m_device, texture = job->texture]()
+            {
+                return runOnWorker([&]() { return texture->Initialize(device.Get(), nullptr); });
+            });
+            break;
+        case eResourceType::MODEL:
+            job->model = std::make_shared<Model>(resource.filePath);
+            job->model->SetTextureCache(m_scene->GetTextureCache());
+            job->result = std::async(std::launch::async, [device = m_device, model = job->model]()
+            {
+                return runOnWorker([&]() { return model->Initialize(device.Get(), nullptr); });
+            });
+            break;
+        case eResourceType::VOXELS:
+            // Only the blocks and meshes are built here, the voxels own transforms the frame reads
+            job->voxelWorld = std::make_shared<VoxelWorld>();
+            job->result = std::async(std::launch::async, [filePath = resource.filePath, pJob = job.get()]()
+            {
+                return Scene::LoadVoxels(filePath, *pJob->voxelWorld, pJob->aChunkMeshes, pJob->aOccluders);
+            });
+            break;
+        default:
+            return;
+        }
+
+        m_jobs[uResource] = job;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::apply
+      Summary:  Replaces a resource with its rebuilt version. Shaders
+                and textures are updated in place so every object using
+                them sees the change, models are swapped in the scene
+                and take over the state of the old ones, and the voxels
+                of the new meshes are created and swapped in
+      Args:     uint32_t uResource
+                  Index of the resource
+                ReloadJob& job
+                  Finished rebuild
+      Modifies: [m_scene, m_dependencyGraph].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT HotReloader::apply(_In_ uint32_t uResource, _In_ ReloadJob& job)
+    {
+        Resource& resource = m_aResources[uResource];
+
+        switch (resource.type)
+        {
+        case eResourceType::SHADER:
+        {
+            HRESULT hr = resource.shader->Reload(m_device.Get());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            updateDependencies(uResource);
+            return S_OK;
+        }
+        case eResourceType::TEXTURE:
+            resource.texture->ReplaceWith(*job.texture);
+            return S_OK;
+        case eResourceType::MODEL:
+        {
+            ResourceTable<std::shared_ptr<Model>>& models = m_scene->GetModels();
+            if (resource.uModel >= models.GetSize())
+            {
+                return E_FAIL;
+            }
+
+            job.model->CopyStateFrom(*models.Get(resource.uModel));
+            models.Get(resource.uModel) = job.model;
+            return S_OK;
+        }
+        case eResourceType::VOXELS:
+            return m_scene->ReplaceVoxels(m_device.Get(), std::move(job.voxelWorld), std::move(job.aChunkMeshes), std::move(job.aOccluders));
+        default:
+            return E_FAIL;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HotReloader::watchFiles
+      Summary:  Hands every file of the dependency graph to the watcher
+      Modifies: [m_fileWatcher].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HotReloader::watchFiles()
+    {
+        std::vector<std::filesystem::path> aFilePaths;
+        m_dependencyGraph.GetFilePaths(aFilePaths);
+
+        m_fileWatcher.Watch(aFilePaths);
+    }
+}
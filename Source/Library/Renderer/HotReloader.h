@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      HOTRELOADER.H
+
+  Summary:   HotReloader header file contains declaration of class
+             HotReloader used to rebuild the shaders, textures, models
+             and voxels of a scene when their files are edited while
+             the game runs.
+
+  Classes:  HotReloader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <future>
+
+#include "Scene/Scene.h"
+#include "Shader/Shader.h"
+#include "Utility/DependencyGraph.h"
+#include "Utility/FileWatcher.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HotReloader
+      Summary:  Watches the files the resources of a scene are built
+                from. The resources affected by a change are rebuilt on
+                worker threads, and the results replace the old ones in
+                Update, between two frames. A failed rebuild keeps the
+                old resource
+      Methods:  Initialize
+                  Registers the resources of a scene and starts watching
+                AddShader
+                  Registers a shader that is not part of the scene
+                Update
+                  Starts the rebuilds of changed files and swaps in the
+                  finished ones
+                HotReloader
+                  Constructor.
+                ~HotReloader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HotReloader
+    {
+    public:
+        HotReloader();
+        HotReloader(const HotReloader& other) = delete;
+        HotReloader(HotReloader&& other) = delete;
+        HotReloader& operator=(const HotReloader& other) = delete;
+        HotReloader& operator=(HotReloader&& other) = delete;
+        virtual ~HotReloader();
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ const std::shared_ptr<Scene>& scene);
+        void AddShader(_In_ const std::shared_ptr<Shader>& shader);
+        void Update();
+
+    private:
+        enum class eResourceType
+        {
+            SHADER,
+            TEXTURE,
+            MODEL,
+            VOXELS,
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Resource
+          Summary:  Resource that can be rebuilt. Only the member of
+                    its type is set
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Resource
+        {
+            eResourceType type;
+            std::filesystem::path filePath;
+            std::shared_ptr<Shader> shader;
+            std::shared_ptr<Texture> texture;
+            uint32_t uModel;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ReloadJob
+          Summary:  Rebuild running on a worker thread. The worker only
+                    touches the new objects of the job, which the main
+                    thread reads once the result is ready
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ReloadJob
+        {
+            std::future<HRESULT> result;
+            std::shared_ptr<Texture> texture;
+            std::shared_ptr<Model> model;
+            std::shared_ptr<VoxelWorld> voxelWorld;
+            std::vector<std::vector<VoxelMesh>> aChunkMeshes;
+            std::vector<AxisAlignedBox> aOccluders;
+        };
+
+        void addResource(_In_ Resource&& resource);
+        void addMaterialTextures(_In_ const Renderable& renderable, _Inout_ std::unordered_set<Texture*>& addedTextures);
+        void addTexture(_In_ const std::shared_ptr<Texture>& texture, _Inout_ std::unordered_set<Texture*>& addedTextures);
+        void updateDependencies(_In_ uint32_t uResource);
+        void dispatch(_In_ uint32_t uResource);
+        HRESULT apply(_In_ uint32_t uResource, _In_ ReloadJob& job);
+        void watchFiles();
+
+    private:
+        ComPtr<ID3D11Device> m_device;
+        std::shared_ptr<Scene> m_scene;
+        DependencyGraph m_dependencyGraph;
+        FileWatcher m_fileWatcher;
+        std::vector<Resource> m_aResources;
+        std::unordered_map<uint32_t, std::shared_ptr<ReloadJob>> m_jobs;
+        std::unordered_set<uint32_t> m_changedWhileReloading;
+    };
+}
@@ -0,0 +1,464 @@
+#include "Renderer/OcclusionCuller.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include "Utility/JobSystem.h"
+#include "Utility/Profiler.h"
+
+namespace library
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        // Corner i of a box is at -1 or +1 extents along x, y and z following bits 0, 1 and 2
+        constexpr const uint32_t NUM_BOX_CORNERS = 8u;
+        constexpr const uint32_t NUM_BOX_FACES = 6u;
+
+        // Wound so that cross(v1 - v0, v2 - v0) points out of the box
+        constexpr const uint32_t BOX_FACES[NUM_BOX_FACES][4] =
+        {
+            { 0u, 4u, 6u, 2u },
+            { 1u, 3u, 7u, 5u },
+            { 0u, 1u, 5u, 4u },
+            { 2u, 6u, 7u, 3u },
+            { 0u, 2u, 3u, 1u },
+            { 4u, 5u, 7u, 6u }
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: transformCorners
+          Summary:  Transforms the corners of a box to clip space
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void transformCorners(const AxisAlignedBox& box, FXMMATRIX viewProjection, XMVECTOR* aClipCorners)
+        {
+            XMVECTOR center = XMLoadFloat3(&box.Center);
+            XMVECTOR extents = XMLoadFloat3(&box.Extents);
+
+            for (uint32_t i = 0u; i < NUM_BOX_CORNERS; ++i)
+            {
+                XMVECTOR sign = XMVectorSet(
+                    (i & 1u) ? 1.0f : -1.0f,
+                    (i & 2u) ? 1.0f : -1.0f,
+                    (i & 4u) ? 1.0f : -1.0f,
+                    0.0f
+                );
+                XMVECTOR corner = XMVectorSetW(XMVectorMultiplyAdd(extents, sign, center), 1.0f);
+                aClipCorners[i] = XMVector4Transform(corner, viewProjection);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: toScreen
+          Summary:  Projects a clip space position to pixels, y going
+                    down, with its depth in z
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        XMFLOAT3 toScreen(FXMVECTOR clipPosition)
+        {
+            XMFLOAT4 clip;
+            XMStoreFloat4(&clip, clipPosition);
+            float invW = 1.0f / clip.w;
+
+            return XMFLOAT3(
+                (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(OcclusionCuller::WIDTH),
+                (0.5f - clip.y * invW * 0.5f) * static_cast<float>(OcclusionCuller::HEIGHT),
+                clip.z * invW
+            );
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: clampToInt
+          Summary:  Rounds down and clamps a pixel coordinate, which can
+                    be far outside the buffer close to the near plane
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        int32_t clampToInt(float value, int32_t minValue, int32_t maxValue)
+        {
+            return static_cast<int32_t>(std::clamp(std::floor(value), static_cast<float>(minValue), static_cast<float>(maxValue)));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::OcclusionCuller
+      Summary:  Constructor
+      Modifies: [m_viewProjection, m_aOccluders, m_aTriangles,
+                 m_auNumTriangles, m_aDepth, m_aTileMaxDepth,
+                 m_uNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::OcclusionCuller()
+        : m_viewProjection(XMMatrixIdentity())
+        , m_aOccluders()
+        , m_aTriangles()
+        , m_auNumTriangles()
+        , m_aDepth(WIDTH * HEIGHT / 4u, XMFLOAT4A(1.0f, 1.0f, 1.0f, 1.0f))
+        , m_aTileMaxDepth(NUM_TILES_X * NUM_TILES_Y, 1.0f)
+        , m_uNumTriangles(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::BeginFrame
+      Summary:  Forgets the occluders of the last frame and sets the
+                camera the next ones are seen from
+      Args:     FXMMATRIX viewProjection
+                  View matrix times projection matrix
+      Modifies: [m_viewProjection, m_aOccluders].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::BeginFrame(FXMMATRIX viewProjection)
+    {
+        m_viewProjection = viewProjection;
+        m_aOccluders.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::AddOccluders
+      Summary:  Adds boxes that are solid all the way through, in world
+                space
+      Args:     const std::vector<AxisAlignedBox>& aBoxes
+                  Occluder boxes
+      Modifies: [m_aOccluders].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::AddOccluders(const std::vector<AxisAlignedBox>& aBoxes)
+    {
+        m_aOccluders.insert(m_aOccluders.end(), aBoxes.begin(), aBoxes.end());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::Rasterize
+      Summary:  Projects the faces of the occluders in parallel, then
+                rasterizes them band by band, so that no two jobs write
+                the same pixel
+      Modifies: [m_aTriangles, m_auNumTriangles, m_aDepth,
+                 m_aTileMaxDepth, m_uNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::Rasterize()
+    {
+        PROFILE_ZONE("OcclusionCuller::Rasterize");
+
+        JobSystem& jobSystem = JobSystem::GetDefault();
+
+        m_aTriangles.resize(m_aOccluders.size() * MAX_TRIANGLES_PER_BOX);
+        m_auNumTriangles.resize(m_aOccluders.size());
+        jobSystem.ParallelFor(static_cast<uint32_t>(m_aOccluders.size()), OCCLUDER_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                setupBox(i);
+            }
+        });
+
+        m_uNumTriangles = 0u;
+        for (uint32_t uNumTriangles : m_auNumTriangles)
+        {
+            m_uNumTriangles += uNumTriangles;
+        }
+
+        jobSystem.ParallelFor(NUM_TILES_Y, 1u, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t uTileRow = uBegin; uTileRow < uEnd; ++uTileRow)
+            {
+                rasterizeBand(uTileRow);
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::IsVisible
+      Summary:  Returns whether a box may be seen past the occluders.
+                Boxes that reach behind the near plane are visible, and
+                boxes entirely off the screen are not
+      Args:     const AxisAlignedBox& box
+                  Box in world space
+      Returns:  bool
+                  false when the occluders hide the whole box
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionCuller::IsVisible(const AxisAlignedBox& box) const
+    {
+        XMVECTOR aClipCorners[NUM_BOX_CORNERS];
+        transformCorners(box, m_viewProjection, aClipCorners);
+
+        float minX = FLT_MAX;
+        float minY = FLT_MAX;
+        float maxX = -FLT_MAX;
+        float maxY = -FLT_MAX;
+        float nearestDepth = FLT_MAX;
+        for (uint32_t i = 0u; i < NUM_BOX_CORNERS; ++i)
+        {
+            if (XMVectorGetW(aClipCorners[i]) < NEAR_W)
+            {
+                return true;
+            }
+
+            XMFLOAT3 screen = toScreen(aClipCorners[i]);
+            minX = (std::min)(minX, screen.x);
+            minY = (std::min)(minY, screen.y);
+            maxX = (std::max)(maxX, screen.x);
+            maxY = (std::max)(maxY, screen.y);
+            nearestDepth = (std::min)(nearestDepth, screen.z);
+        }
+
+        if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(WIDTH) || minY >= static_cast<float>(HEIGHT))
+        {
+            return false;
+        }
+
+        // Every pixel the rectangle touches, not only those whose center it covers
+        int32_t iMinX = clampToInt(minX, 0, WIDTH - 1);
+        int32_t iMinY = clampToInt(minY, 0, HEIGHT - 1);
+        int32_t iMaxX = clampToInt(maxX, 0, WIDTH - 1);
+        int32_t iMaxY = clampToInt(maxY, 0, HEIGHT - 1);
+
+        const float* aDepth = reinterpret_cast<const float*>(m_aDepth.data());
+        for (int32_t iTileY = iMinY / static_cast<int32_t>(TILE_SIZE); iTileY <= iMaxY / static_cast<int32_t>(TILE_SIZE); ++iTileY)
+        {
+            for (int32_t iTileX = iMinX / static_cast<int32_t>(TILE_SIZE); iTileX <= iMaxX / static_cast<int32_t>(TILE_SIZE); ++iTileX)
+            {
+                if (nearestDepth > m_aTileMaxDepth[iTileY * NUM_TILES_X + iTileX])
+                {
+                    continue;
+                }
+
+                int32_t iBeginY = (std::max)(iMinY, iTileY * static_cast<int32_t>(TILE_SIZE));
+                int32_t iEndY = (std::min)(iMaxY, (iTileY + 1) * static_cast<int32_t>(TILE_SIZE) - 1);
+                int32_t iBeginX = (std::max)(iMinX, iTileX * static_cast<int32_t>(TILE_SIZE));
+                int32_t iEndX = (std::min)(iMaxX, (iTileX + 1) * static_cast<int32_t>(TILE_SIZE) - 1);
+                for (int32_t y = iBeginY; y <= iEndY; ++y)
+                {
+                    for (int32_t x = iBeginX; x <= iEndX; ++x)
+                    {
+                        if (nearestDepth <= aDepth[y * WIDTH + x])
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumOccluders
+      Summary:  Returns the number of occluder boxes of the frame
+      Returns:  uint32_t
+                  Number of occluders
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t OcclusionCuller::GetNumOccluders() const
+    {
+        return static_cast<uint32_t>(m_aOccluders.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumTriangles
+      Summary:  Returns the number of front facing triangles the last
+                Rasterize projected
+      Returns:  uint32_t
+                  Number of triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t OcclusionCuller::GetNumTriangles() const
+    {
+        return m_uNumTriangles;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetDepth
+      Summary:  Returns the depth of a pixel, 1 where no occluder is
+      Args:     uint32_t uX
+                  Column, below WIDTH
+                uint32_t uY
+                  Row from the top, below HEIGHT
+      Returns:  float
+                  Depth between 0 and 1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float OcclusionCuller::GetDepth(uint32_t uX, uint32_t uY) const
+    {
+        assert(uX < WIDTH && uY < HEIGHT);
+
+        return reinterpret_cast<const float*>(m_aDepth.data())[uY * WIDTH + uX];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::setupBox
+      Summary:  Clips the faces of an occluder against the near plane
+                and keeps the triangles that face the camera, in pixels
+      Args:     uint32_t uBox
+                  Index of the occluder
+      Modifies: [m_aTriangles, m_auNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::setupBox(uint32_t uBox)
+    {
+        XMVECTOR aClipCorners[NUM_BOX_CORNERS];
+        transformCorners(m_aOccluders[uBox], m_viewProjection, aClipCorners);
+
+        ScreenTriangle* aTriangles = &m_aTriangles[uBox * MAX_TRIANGLES_PER_BOX];
+        uint32_t uNumTriangles = 0u;
+        for (uint32_t uFace = 0u; uFace < NUM_BOX_FACES; ++uFace)
+        {
+            // Sutherland-Hodgman against w = NEAR_W turns the quad into at most a pentagon
+            XMVECTOR aPolygon[5];
+            uint32_t uNumCorners = 0u;
+            for (uint32_t i = 0u; i < 4u; ++i)
+            {
+                XMVECTOR current = aClipCorners[BOX_FACES[uFace][i]];
+                XMVECTOR next = aClipCorners[BOX_FACES[uFace][(i + 1u) % 4u]];
+                float currentW = XMVectorGetW(current) - NEAR_W;
+                float nextW = XMVectorGetW(next) - NEAR_W;
+
+                if (currentW >= 0.0f)
+                {
+                    aPolygon[uNumCorners++] = current;
+                }
+                if ((currentW >= 0.0f) != (nextW >= 0.0f))
+                {
+                    aPolygon[uNumCorners++] = XMVectorLerp(current, next, currentW / (currentW - nextW));
+                }
+            }
+
+            if (uNumCorners < 3u)
+            {
+                continue;
+            }
+
+            XMFLOAT3 aScreen[5];
+            for (uint32_t i = 0u; i < uNumCorners; ++i)
+            {
+                aScreen[i] = toScreen(aPolygon[i]);
+            }
+
+            // The face turns away from the camera when its area is not positive
+            for (uint32_t i = 1u; i + 1u < uNumCorners; ++i)
+            {
+                const XMFLOAT3& v0 = aScreen[0];
+                const XMFLOAT3& v1 = aScreen[i];
+                const XMFLOAT3& v2 = aScreen[i + 1u];
+                float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+                if (area <= 0.0f)
+                {
+                    continue;
+                }
+
+                aTriangles[uNumTriangles++] = ScreenTriangle{ .aCorners = { v0, v1, v2 } };
+            }
+        }
+
+        m_auNumTriangles[uBox] = uNumTriangles;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeBand
+      Summary:  Clears a row of tiles, rasterizes every occluder
+                triangle that overlaps it keeping the nearest depth,
+                and stores the farthest depth of each of its tiles.
+                Pixels are sampled at their centers, four at a time
+      Args:     uint32_t uTileRow
+                  Row of tiles, below NUM_TILES_Y
+      Modifies: [m_aDepth, m_aTileMaxDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeBand(uint32_t uTileRow)
+    {
+        constexpr const uint32_t uGroupsPerRow = WIDTH / 4u;
+        const int32_t iBandBegin = static_cast<int32_t>(uTileRow * TILE_SIZE);
+        const int32_t iBandEnd = iBandBegin + static_cast<int32_t>(TILE_SIZE) - 1;
+
+        std::fill(m_aDepth.begin() + iBandBegin * uGroupsPerRow, m_aDepth.begin() + (iBandEnd + 1) * uGroupsPerRow, XMFLOAT4A(1.0f, 1.0f, 1.0f, 1.0f));
+
+        const XMVECTOR pixelOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+        const XMVECTOR zero = XMVectorZero();
+
+        for (uint32_t uBox = 0u; uBox < m_aOccluders.size(); ++uBox)
+        {
+            for (uint32_t uTriangle = 0u; uTriangle < m_auNumTriangles[uBox]; ++uTriangle)
+            {
+                const XMFLOAT3* v = m_aTriangles[uBox * MAX_TRIANGLES_PER_BOX + uTriangle].aCorners;
+
+                // Rows and columns whose pixel centers the bounding rectangle holds
+                float minY = (std::min)({ v[0].y, v[1].y, v[2].y });
+                float maxY = (std::max)({ v[0].y, v[1].y, v[2].y });
+                int32_t iBeginY = (std::max)(iBandBegin, clampToInt(minY + 0.5f, 0, HEIGHT));
+                int32_t iEndY = (std::min)(iBandEnd, clampToInt(maxY - 0.5f, -1, HEIGHT - 1));
+                if (iBeginY > iEndY)
+                {
+                    continue;
+                }
+
+                float minX = (std::min)({ v[0].x, v[1].x, v[2].x });
+                float maxX = (std::max)({ v[0].x, v[1].x, v[2].x });
+                int32_t iBeginX = clampToInt(minX + 0.5f, 0, WIDTH) & ~3;
+                int32_t iEndX = clampToInt(maxX - 0.5f, -1, WIDTH - 1);
+                if (iBeginX > iEndX)
+                {
+                    continue;
+                }
+
+                // Edge i is inside when A * x + B * y + C >= 0, the depth is a plane in x and y
+                float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+                float aA[3];
+                float aB[3];
+                float aC[3];
+                for (uint32_t i = 0u; i < 3u; ++i)
+                {
+                    const XMFLOAT3& a = v[i];
+                    const XMFLOAT3& b = v[(i + 1u) % 3u];
+                    aA[i] = a.y - b.y;
+                    aB[i] = b.x - a.x;
+                    aC[i] = (b.y - a.y) * a.x - (b.x - a.x) * a.y;
+                }
+
+                float depthDx = ((v[1].z - v[0].z) * (v[2].y - v[0].y) - (v[2].z - v[0].z) * (v[1].y - v[0].y)) / area;
+                float depthDy = ((v[2].z - v[0].z) * (v[1].x - v[0].x) - (v[1].z - v[0].z) * (v[2].x - v[0].x)) / area;
+                float depthC = v[0].z - depthDx * v[0].x - depthDy * v[0].y;
+
+                XMVECTOR firstX = XMVectorAdd(XMVectorReplicate(static_cast<float>(iBeginX)), pixelOffsets);
+                XMVECTOR edgeStep0 = XMVectorReplicate(aA[0] * 4.0f);
+                XMVECTOR edgeStep1 = XMVectorReplicate(aA[1] * 4.0f);
+                XMVECTOR edgeStep2 = XMVectorReplicate(aA[2] * 4.0f);
+                XMVECTOR depthStep = XMVectorReplicate(depthDx * 4.0f);
+
+                for (int32_t y = iBeginY; y <= iEndY; ++y)
+                {
+                    float centerY = static_cast<float>(y) + 0.5f;
+                    XMVECTOR edge0 = XMVectorMultiplyAdd(XMVectorReplicate(aA[0]), firstX, XMVectorReplicate(aB[0] * centerY + aC[0]));
+                    XMVECTOR edge1 = XMVectorMultiplyAdd(XMVectorReplicate(aA[1]), firstX, XMVectorReplicate(aB[1] * centerY + aC[1]));
+                    XMVECTOR edge2 = XMVectorMultiplyAdd(XMVectorReplicate(aA[2]), firstX, XMVectorReplicate(aB[2] * centerY + aC[2]));
+                    XMVECTOR depth = XMVectorMultiplyAdd(XMVectorReplicate(depthDx), firstX, XMVectorReplicate(depthDy * centerY + depthC));
+
+                    XMFLOAT4A* pGroup = &m_aDepth[y * uGroupsPerRow + iBeginX / 4];
+                    for (int32_t x = iBeginX; x <= iEndX; x += 4, ++pGroup)
+                    {
+                        XMVECTOR inside = XMVectorAndInt(
+                            XMVectorAndInt(XMVectorGreaterOrEqual(edge0, zero), XMVectorGreaterOrEqual(edge1, zero)),
+                            XMVectorGreaterOrEqual(edge2, zero)
+                        );
+
+                        XMVECTOR current = XMLoadFloat4A(pGroup);
+                        XMStoreFloat4A(pGroup, XMVectorSelect(current, XMVectorMin(current, XMVectorSaturate(depth)), inside));
+
+                        edge0 = XMVectorAdd(edge0, edgeStep0);
+                        edge1 = XMVectorAdd(edge1, edgeStep1);
+                        edge2 = XMVectorAdd(edge2, edgeStep2);
+                        depth = XMVectorAdd(depth, depthStep);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t uTileX = 0u; uTileX < NUM_TILES_X; ++uTileX)
+        {
+            XMVECTOR maxDepth = XMVectorZero();
+            for (int32_t y = iBandBegin; y <= iBandEnd; ++y)
+            {
+                for (uint32_t uGroup = 0u; uGroup < TILE_SIZE / 4u; ++uGroup)
+                {
+                    maxDepth = XMVectorMax(maxDepth, XMLoadFloat4A(&m_aDepth[y * uGroupsPerRow + uTileX * (TILE_SIZE / 4u) + uGroup]));
+                }
+            }
+
+            XMFLOAT4A tileDepths;
+            XMStoreFloat4A(&tileDepths, maxDepth);
+            m_aTileMaxDepth[uTileRow * NUM_TILES_X + uTileX] = (std::max)((std::max)(tileDepths.x, tileDepths.y), (std::max)(tileDepths.z, tileDepths.w));
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+
+  Summary:   OcclusionCuller header file contains declaration of class
+             OcclusionCuller used to hide the objects that solid
+             occluders cover, with a depth buffer rasterized on the CPU.
+             It only depends on DirectXMath and the standard library.
+
+  Classes:  AxisAlignedBox, OcclusionCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   AxisAlignedBox
+      Summary:  Box in world space, laid out like AxisAlignedBox
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct AxisAlignedBox
+    {
+        DirectX::XMFLOAT3 Center;
+        DirectX::XMFLOAT3 Extents;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionCuller
+      Summary:  Rasterizes the front faces of solid occluder boxes into
+                a WIDTH x HEIGHT depth buffer, four pixels at a time,
+                and keeps the farthest depth of every TILE_SIZE square
+                tile. A box is hidden when its nearest depth lies
+                behind every pixel its screen rectangle covers, which
+                the tiles answer for most of them without looking at
+                the pixels. Occluders are clipped against the near
+                plane, while boxes that cross it are always visible.
+                Rasterization runs on the job system, one band of tile
+                rows per job, and IsVisible may be called from any
+                thread once it returned
+      Methods:  BeginFrame
+                  Clears the occluders and sets the camera
+                AddOccluders
+                  Adds solid boxes to rasterize
+                Rasterize
+                  Fills the depth buffer and its tiles
+                IsVisible
+                  Returns whether a box may be seen
+                GetNumOccluders
+                  Returns the number of occluder boxes
+                GetNumTriangles
+                  Returns the number of triangles rasterized
+                GetDepth
+                  Returns the depth of a pixel
+                OcclusionCuller
+                  Constructor.
+                ~OcclusionCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionCuller
+    {
+    public:
+        static constexpr const uint32_t WIDTH = 256u;
+        static constexpr const uint32_t HEIGHT = 144u;
+        static constexpr const uint32_t TILE_SIZE = 8u;
+        static constexpr const uint32_t NUM_TILES_X = WIDTH / TILE_SIZE;
+        static constexpr const uint32_t NUM_TILES_Y = HEIGHT / TILE_SIZE;
+        static constexpr const uint32_t OCCLUDER_GRAIN_SIZE = 64u;
+        static constexpr const float NEAR_W = 1e-3f;
+
+    public:
+        OcclusionCuller();
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller() = default;
+
+        void BeginFrame(DirectX::FXMMATRIX viewProjection);
+        void AddOccluders(const std::vector<AxisAlignedBox>& aBoxes);
+        void Rasterize();
+        bool IsVisible(const AxisAlignedBox& box) const;
+
+        uint32_t GetNumOccluders() const;
+        uint32_t GetNumTriangles() const;
+        float GetDepth(uint32_t uX, uint32_t uY) const;
+
+    private:
+        static constexpr const uint32_t MAX_TRIANGLES_PER_BOX = 9u;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ScreenTriangle
+          Summary:  Triangle in pixels, with the depth of its corners,
+                    wound so that its area is positive
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ScreenTriangle
+        {
+            DirectX::XMFLOAT3 aCorners[3];
+        };
+
+    private:
+        void setupBox(uint32_t uBox);
+        void rasterizeBand(uint32_t uTileRow);
+
+    private:
+        DirectX::XMMATRIX m_viewProjection;
+        std::vector<AxisAlignedBox> m_aOccluders;
+        std::vector<ScreenTriangle> m_aTriangles;
+        std::vector<uint32_t> m_auNumTriangles;
+        std::vector<DirectX::XMFLOAT4A> m_aDepth;
+        std::vector<float> m_aTileMaxDepth;
+        uint32_t m_uNumTriangles;
+    };
+}
@@ -0,0 +1,71 @@
+#include "Renderer/RenderBackend.h"
+
+#include <fstream>
+
+#include "Texture/DDSWriter.h"
+
+namespace library
+{
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: writePortablePixmap
+          Summary:  Writes the color of an image, without its alpha, to
+                    a binary PPM file that any image viewer opens
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        bool writePortablePixmap(const std::filesystem::path& filePath, const Image& image)
+        {
+            std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return false;
+            }
+
+            file << "P6\n" << image.uWidth << ' ' << image.uHeight << "\n255\n";
+
+            std::vector<uint8_t> aRow(static_cast<size_t>(image.uWidth) * 3u);
+            for (uint32_t y = 0u; y < image.uHeight; ++y)
+            {
+                const uint8_t* pPixel = &image.aPixels[static_cast<size_t>(y) * image.uWidth * 4u];
+                for (uint32_t x = 0u; x < image.uWidth; ++x, pPixel += 4)
+                {
+                    aRow[x * 3u] = pPixel[0];
+                    aRow[x * 3u + 1u] = pPixel[1];
+                    aRow[x * 3u + 2u] = pPixel[2];
+                }
+                file.write(reinterpret_cast<const char*>(aRow.data()), static_cast<std::streamsize>(aRow.size()));
+            }
+
+            return static_cast<bool>(file);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RenderBackend::WriteFrame
+      Summary:  Writes the last rendered frame to a binary PPM file
+                when the path ends in .ppm, and otherwise to an
+                uncompressed DDS file in the format of the swap chain
+      Args:     const std::filesystem::path& filePath
+                  Path of the file
+      Returns:  bool
+                  true if the whole file was written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool RenderBackend::WriteFrame(const std::filesystem::path& filePath) const
+    {
+        const Image& frame = GetFrame();
+        if (filePath.extension() == ".ppm")
+        {
+            return writePortablePixmap(filePath, frame);
+        }
+
+        DDSImageDesc desc =
+        {
+            .uWidth = frame.uWidth,
+            .uHeight = frame.uHeight,
+            .uNumMips = 1u,
+            .Format = eDDSFormat::R8G8B8A8_UNORM
+        };
+
+        return DDSWriter::Write(filePath, desc, { frame.aPixels });
+    }
+}
@@ -0,0 +1,127 @@
+/*+===================================================================
+  File:      RENDERBACKEND.H
+
+  Summary:   RenderBackend header file contains declaration of the
+             interface frames are submitted to the software renderer
+             through, in the constant buffers and vertex formats of
+             the Direct3D path, so frames can be drawn and checked on
+             the CPU where there is no Direct3D device. It only
+             depends on DirectXMath and the standard library.
+
+  Classes:  DrawCommand, RenderBackend
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include <DirectXMath.h>
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/VertexCompression.h"
+#include "Texture/Image.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eDrawShading
+      Summary:  Pixel shader a draw is shaded with: PSPhong, PSVoxel
+                or PSLightCube
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eDrawShading : uint32_t
+    {
+        PHONG,
+        VOXEL,
+        LIGHT_CUBE,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DrawCommand
+      Summary:  Indexed triangle list to draw and the constants to draw
+                it with, filled like their Direct3D counterparts: the
+                world matrix of Constants is transposed, instance
+                transforms are not. aNormalData is read only with a
+                normal map, aAnimationData only with bone transforms,
+                and aAmbientOcclusion only by PSVoxel, which treats a
+                missing one as unoccluded. When aPackedVertices is set
+                the packed streams are read instead of aVertices,
+                aNormalData and aAnimationData, and decoded like the
+                PACKED_VERTICES permutation does, with the
+                PositionScale and PositionOffset of Constants. Without
+                instance data the mesh is drawn once. The arrays and images are not
+                copied, they must live until RenderBackend::Render
+                returned
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DrawCommand
+    {
+        const SimpleVertex* aVertices;
+        const NormalData* aNormalData;
+        const AnimationData* aAnimationData;
+        const uint8_t* aAmbientOcclusion;
+        const PackedVertex* aPackedVertices;
+        const PackedNormalData* aPackedNormalData;
+        const PackedAnimationData* aPackedAnimationData;
+        uint32_t uNumVertices;
+        const uint16_t* aIndices;
+        uint32_t uNumIndices;
+        const InstanceData* aInstanceData;
+        uint32_t uNumInstances;
+        const BoneTransform3x4* aBoneTransforms;
+        uint32_t uNumBones;
+        CBChangesEveryFrame Constants;
+        const Image* pDiffuse;
+        const Image* pNormalMap;
+        eDrawShading Shading;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RenderBackend
+      Summary:  Draws frames out of the constant buffers and draws the
+                Direct3D path builds: a frame is begun, given its camera
+                and lights and its draws in order, then rendered and
+                read back. SoftwareRenderer implements it. The Direct3D
+                Renderer does not, it still drives its device itself
+      Methods:  BeginFrame
+                  Pure virtual function that clears the frame and
+                  forgets the draws
+                SetCamera
+                  Pure virtual function that sets the view and
+                  projection constants
+                SetLights
+                  Pure virtual function that sets the light constants
+                Draw
+                  Pure virtual function that adds a draw to the frame
+                Render
+                  Pure virtual function that draws the frame
+                GetFrame
+                  Pure virtual function that returns the pixels of the
+                  last rendered frame
+                WriteFrame
+                  Writes the last rendered frame to an image file
+                RenderBackend
+                  Constructor.
+                ~RenderBackend
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RenderBackend
+    {
+    public:
+        RenderBackend() = default;
+        RenderBackend(const RenderBackend& other) = delete;
+        RenderBackend(RenderBackend&& other) = delete;
+        RenderBackend& operator=(const RenderBackend& other) = delete;
+        RenderBackend& operator=(RenderBackend&& other) = delete;
+        virtual ~RenderBackend() = default;
+
+        virtual void BeginFrame(const DirectX::XMFLOAT4& clearColor) = 0;
+        virtual void SetCamera(const CBChangeOnCameraMovement& cbCamera, const CBChangeOnResize& cbResize) = 0;
+        virtual void SetLights(const CBLights& cbLights) = 0;
+        virtual void Draw(const DrawCommand& draw) = 0;
+        virtual void Render() = 0;
+        virtual const Image& GetFrame() const = 0;
+
+        bool WriteFrame(const std::filesystem::path& filePath) const;
+    };
+}
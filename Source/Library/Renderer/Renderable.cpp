@@ -4,6 +4,7 @@
 #include "assimp/scene.h"		// output data structure
 #include "assimp/postprocess.h"	// post processing flags
 
+#include "Renderer/TangentGenerator.h"
 #include "Texture/DDSTextureLoader.h"
 
 namespace library
@@ -15,8 +16,9 @@ namespace library
                   Default color to shader the renderable
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
                  m_normalBuffer, m_aMeshes, m_aMaterials, m_vertexShader,
-                 m_pixelShader, m_outputColor, m_world, m_bHasNormalMap
-                 m_aNormalData].
+                 m_pixelShader, m_outputColor, m_transform,
+                 m_previousWorld, m_bHasNormalMap, m_aNormalData,
+                 m_bHasPreviousState, m_bIsStatic].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderable::Renderable(_In_ const XMFLOAT4& outputColor)
         : m_vertexBuffer(nullptr)
@@ -29,11 +31,24 @@ namespace library
         , m_vertexShader(std::shared_ptr<VertexShader>())
         , m_pixelShader(std::shared_ptr<PixelShader>())
         , m_outputColor(outputColor)
-        , m_world(XMMatrixIdentity())
         , m_padding()
+        , m_transform(TransformSystem::GetDefault().Create())
+        , m_previousWorld(XMMatrixIdentity())
+        , m_boundingSphere()
         , m_bHasNormalMap(FALSE)
+        , m_bHasPreviousState(FALSE)
+        , m_bIsStatic(FALSE)
     { }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::~Renderable
+      Summary:  Destructor. Frees the transform
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Renderable::~Renderable()
+    {
+        TransformSystem::GetDefault().Destroy(m_transform);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::initialize
       Summary:  Initializes the buffers and the world matrix
@@ -44,7 +59,7 @@ namespace library
                 PCWSTR pszTextureFileName
                   File name of the texture to usen
       Modifies: [m_vertexBuffer, m_normalBuffer, m_indexBuffer
-                 m_constantBuffer].
+                 m_constantBuffer, m_boundingSphere].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -52,25 +67,12 @@ namespace library
     {
         HRESULT hr = S_OK;
 
-        // Create the vertex buffer
-        D3D11_BUFFER_DESC vertexBufferDesc =
-        {
-            .ByteWidth = sizeof(SimpleVertex) * GetNumVertices(),
-            .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
-            .CPUAccessFlags = 0u,
-            .MiscFlags = 0u,
-            .StructureByteStride = 0u
-        };
-
-        D3D11_SUBRESOURCE_DATA vertexInitData =
+        if (m_aNormalData.empty())
         {
-            .pSysMem = getVertices(),
-            .SysMemPitch = 0u,
-            .SysMemSlicePitch = 0u
-        };
+            calculateNormalMapVectors();
+        }
 
-        hr = pDevice->CreateBuffer(&vertexBufferDesc, &vertexInitData, m_vertexBuffer.GetAddressOf());
+        hr = initializeVertexBuffers(pDevice);
 
         if (FAILED(hr))
         {
@@ -100,15 +102,50 @@ namespace library
             return hr;
         }
 
-        if (m_aNormalData.empty())
+        // Create the constant buffer
+        D3D11_BUFFER_DESC constantBufferDesc =
         {
-            calculateNormalMapVectors();
+            .ByteWidth = sizeof(CBChangesEveryFrame),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        hr = pDevice->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.GetAddressOf());
+
+        if (FAILED(hr))
+        {
+            return hr;
         }
 
-        // Create the normal buffer
-        D3D11_BUFFER_DESC normalBufferDesc =
+        // Bounding sphere used to estimate the on-screen size of the textures
+        if (GetNumVertices() > 0u)
         {
-            .ByteWidth = sizeof(NormalData) * static_cast<UINT>(m_aNormalData.size()),
+            BoundingSphere::CreateFromPoints(m_boundingSphere, GetNumVertices(), &getVertices()->Position, sizeof(SimpleVertex));
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::initializeVertexBuffers
+      Summary:  Creates the vertex buffer and the normal buffer
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+      Modifies: [m_vertexBuffer, m_normalBuffer].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderable::initializeVertexBuffers(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
+        // Create the vertex buffer
+        D3D11_BUFFER_DESC vertexBufferDesc =
+        {
+            .ByteWidth = sizeof(SimpleVertex) * GetNumVertices(),
             .Usage = D3D11_USAGE_DEFAULT,
             .BindFlags = D3D11_BIND_VERTEX_BUFFER,
             .CPUAccessFlags = 0u,
@@ -116,134 +153,52 @@ namespace library
             .StructureByteStride = 0u
         };
 
-        D3D11_SUBRESOURCE_DATA normalInitData =
+        D3D11_SUBRESOURCE_DATA vertexInitData =
         {
-            .pSysMem = m_aNormalData.data(),
+            .pSysMem = getVertices(),
             .SysMemPitch = 0u,
             .SysMemSlicePitch = 0u
         };
 
-        hr = pDevice->CreateBuffer(&normalBufferDesc, &normalInitData, m_normalBuffer.GetAddressOf());
+        hr = pDevice->CreateBuffer(&vertexBufferDesc, &vertexInitData, m_vertexBuffer.GetAddressOf());
 
         if (FAILED(hr))
         {
             return hr;
         }
 
-        // Create the constant buffer
-        D3D11_BUFFER_DESC constantBufferDesc =
+        // Create the normal buffer
+        D3D11_BUFFER_DESC normalBufferDesc =
         {
-            .ByteWidth = sizeof(CBChangesEveryFrame),
+            .ByteWidth = sizeof(NormalData) * static_cast<UINT>(m_aNormalData.size()),
             .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
-            .CPUAccessFlags = 0,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0u,
             .MiscFlags = 0u,
             .StructureByteStride = 0u
         };
 
-        hr = pDevice->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.GetAddressOf());
-
-        if (FAILED(hr))
+        D3D11_SUBRESOURCE_DATA normalInitData =
         {
-            return hr;
-        }
+            .pSysMem = m_aNormalData.data(),
+            .SysMemPitch = 0u,
+            .SysMemSlicePitch = 0u
+        };
 
-        return S_OK;
+        return pDevice->CreateBuffer(&normalBufferDesc, &normalInitData, m_normalBuffer.GetAddressOf());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::calculateNormalMapVectors
-      Summary:  Calculate tangent and bitangent vectors of every vertex
+      Summary:  Calculate tangent and bitangent vectors of every vertex,
+                accumulated over the faces that share it
       Modifies: [m_aNormalData].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::calculateNormalMapVectors()
     {
-        UINT uNumFaces = GetNumIndices() / 3;
-        const SimpleVertex* aVertices = getVertices();
-        const WORD* aIndices = getIndices();
-
         m_aNormalData.resize(GetNumVertices(), NormalData());
 
-        XMFLOAT3 tangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
-        XMFLOAT3 bitangent = XMFLOAT3(0.0f, 0.0f, 0.0f);
-
-        for (UINT i = 0u; i < uNumFaces; ++i)
-        {
-            calculateTangentBitangent(aVertices[aIndices[i * 3]], aVertices[aIndices[i * 3 + 1]], aVertices[aIndices[i * 3 + 2]], tangent, bitangent);
-            m_aNormalData[aIndices[i * 3]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3]].Bitangent = bitangent;
-
-            m_aNormalData[aIndices[i * 3 + 1]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3 + 1]].Bitangent = bitangent;
-
-            m_aNormalData[aIndices[i * 3 + 2]].Tangent = tangent;
-            m_aNormalData[aIndices[i * 3 + 2]].Bitangent = bitangent;
-        }
-
-    }
-
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Renderable::calculateTangentBitangent
-      Summary:  Calculate tangent/bitangent vectors of the given face
-      Args:     SimpleVertex& v1
-                  The first vertex of the face
-                SimpleVertex& v2
-                  The second vertex of the face
-                SimpleVertex& v3
-                  The third vertex of the face
-                XMFLOAT3& tangent
-                  Calculated tangent vector
-                XMFLOAT3& bitangent
-                  Calculated bitangent vector
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Renderable::calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent)
-    {
-        XMFLOAT3 vector1, vector2;
-        XMFLOAT2 tuVector, tvVector;
-
-        // Calculate the two vectors for this face.
-        vector1.x = v2.Position.x - v1.Position.x;
-        vector1.y = v2.Position.y - v1.Position.y;
-        vector1.z = v2.Position.z - v1.Position.z;
-
-        vector2.x = v3.Position.x - v1.Position.x;
-        vector2.y = v3.Position.y - v1.Position.y;
-        vector2.z = v3.Position.z - v1.Position.z;
-
-        // Calculate the tu and tv texture space vectors.
-        tuVector.x = v2.TexCoord.x - v1.TexCoord.x;
-        tvVector.x = v2.TexCoord.y - v1.TexCoord.y;
-
-        tuVector.y = v3.TexCoord.x - v1.TexCoord.x;
-        tvVector.y = v3.TexCoord.y - v1.TexCoord.y;
-
-        // Calculate the denominator of the tangent/binormal equation.
-        float den = 1.0f / (tuVector.x * tvVector.y - tuVector.y * tvVector.x);
-
-        // Calculate the cross products and multiply by the coefficient to get the tangent and binormal.
-        tangent.x = (tvVector.y * vector1.x - tvVector.x * vector2.x) * den;
-        tangent.y = (tvVector.y * vector1.y - tvVector.x * vector2.y) * den;
-        tangent.z = (tvVector.y * vector1.z - tvVector.x * vector2.z) * den;
-
-        bitangent.x = (tuVector.x * vector2.x - tuVector.y * vector1.x) * den;
-        bitangent.y = (tuVector.x * vector2.y - tuVector.y * vector1.y) * den;
-        bitangent.z = (tuVector.x * vector2.z - tuVector.y * vector1.z) * den;
-
-        // Calculate the length of this normal.
-        float length = sqrt((tangent.x * tangent.x) + (tangent.y * tangent.y) + (tangent.z * tangent.z));
-
-        // Normalize the normal and then store it
-        tangent.x = tangent.x / length;
-        tangent.y = tangent.y / length;
-        tangent.z = tangent.z / length;
-
-        // Calculate the length of this normal.
-        length = sqrt((bitangent.x * bitangent.x) + (bitangent.y * bitangent.y) + (bitangent.z * bitangent.z));
-
-        // Normalize the normal and then store it
-        bitangent.x = bitangent.x / length;
-        bitangent.y = bitangent.y / length;
-        bitangent.z = bitangent.z / length;
+        TangentGenerator::Generate(getVertices(), GetNumVertices(), getIndices(), GetNumIndices(), m_aNormalData.data());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -312,37 +267,61 @@ namespace library
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetPermutation
+      Summary:  Returns the shader features the renderable is drawn
+                with. The scene always holds NUM_LIGHTS lights
+      Returns:  ShaderPermutation
+                  Features and light count
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderPermutation Renderable::GetPermutation() const
+    {
+        ShaderPermutation permutation(static_cast<UINT>(eShaderFeature::SHADOWS), NUM_LIGHTS);
+        if (m_bHasNormalMap)
+        {
+            permutation.Enable(eShaderFeature::NORMAL_MAP);
+        }
+
+        return permutation;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetVertexShader
-      Summary:  Returns the vertex shader
+      Summary:  Returns the vertex shader variant of the renderable
       Returns:  ComPtr<ID3D11VertexShader>&
                   Vertex shader. Could be a nullptr
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     ComPtr<ID3D11VertexShader>& Renderable::GetVertexShader()
     {
-        return m_vertexShader->GetVertexShader();
+        return m_vertexShader->GetVertexShader(GetPermutation());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetPixelShader
-      Summary:  Returns the vertex shader
+      Summary:  Returns the pixel shader variant of the renderable. The
+                vertex format never reaches the pixel stage, so packed
+                vertices share the variant of the full ones
       Returns:  ComPtr<ID3D11PixelShader>&
                   Pixel shader. Could be a nullptr
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     ComPtr<ID3D11PixelShader>& Renderable::GetPixelShader()
     {
-        return m_pixelShader->GetPixelShader();
+        ShaderPermutation permutation = GetPermutation();
+        permutation.Disable(eShaderFeature::PACKED_VERTICES);
+
+        return m_pixelShader->GetPixelShader(permutation);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetVertexLayout
-      Summary:  Returns the vertex input layout
+      Summary:  Returns the vertex input layout of the vertex format of
+                the renderable
       Returns:  ComPtr<ID3D11InputLayout>&
                   Vertex input layout
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     ComPtr<ID3D11InputLayout>& Renderable::GetVertexLayout()
     {
-        return m_vertexShader->GetVertexLayout();
+        return m_vertexShader->GetVertexLayout(GetPermutation());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -391,13 +370,81 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetWorldMatrix
-      Summary:  Returns the world matrix
-      Returns:  const XMMATRIX&
+      Summary:  Returns the world matrix of the last transform rebuild
+      Returns:  XMMATRIX
                   World matrix
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const XMMATRIX& Renderable::GetWorldMatrix() const
+    XMMATRIX Renderable::GetWorldMatrix() const
+    {
+        return TransformSystem::GetDefault().GetWorldMatrix(m_transform);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetWorldMatrix
+      Summary:  Replaces the transform with the scale, rotation and
+                translation of an affine matrix, seen by GetWorldMatrix
+                after the next rebuild
+      Args:     const XMMATRIX& world
+                  New world matrix
+      Modifies: [m_transform].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetWorldMatrix(_In_ const XMMATRIX& world)
+    {
+        TransformSystem::GetDefault().SetLocalMatrix(m_transform, world);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetTransform
+      Summary:  Returns the handle into the transform system
+      Returns:  const TransformHandle&
+                  Transform of the renderable
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TransformHandle& Renderable::GetTransform() const
+    {
+        return m_transform;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetInterpolatedWorldMatrix
+      Summary:  Returns the world matrix between the one of the tick
+                before last and the current one. Objects that were
+                never ticked return the current one
+      Args:     FLOAT alpha
+                  Weight of the current world matrix
+      Returns:  XMMATRIX
+                  Interpolated world matrix
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX Renderable::GetInterpolatedWorldMatrix(_In_ FLOAT alpha) const
+    {
+        if (!m_bHasPreviousState)
+        {
+            return GetWorldMatrix();
+        }
+
+        return interpolateMatrix(m_previousWorld, GetWorldMatrix(), alpha);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::StorePreviousState
+      Summary:  Keeps the world matrix before a simulation tick changes
+                it
+      Modifies: [m_previousWorld, m_bHasPreviousState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::StorePreviousState()
+    {
+        m_previousWorld = GetWorldMatrix();
+        m_bHasPreviousState = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetBoundingSphere
+      Summary:  Returns the bounding sphere in object space
+      Returns:  const BoundingSphere&
+                  Bounding sphere of the vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BoundingSphere& Renderable::GetBoundingSphere() const
     {
-        return m_world;
+        return m_boundingSphere;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -460,11 +507,11 @@ namespace library
       Summary:  Rotates around the x-axis
       Args:     FLOAT angle
                   Angle of rotation around the x-axis, in radians
-      Modifies: [m_world].
+      Modifies: [m_transform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::RotateX(_In_ FLOAT angle)
     {
-        m_world *= XMMatrixRotationX(angle);
+        TransformSystem::GetDefault().Rotate(m_transform, XMQuaternionRotationNormal(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), angle));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -472,11 +519,11 @@ namespace library
       Summary:  Rotates around the y-axis
       Args:     FLOAT angle
                   Angle of rotation around the y-axis, in radians
-      Modifies: [m_world].
+      Modifies: [m_transform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::RotateY(_In_ FLOAT angle)
     {
-        m_world *= XMMatrixRotationY(angle);
+        TransformSystem::GetDefault().Rotate(m_transform, XMQuaternionRotationNormal(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), angle));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -484,11 +531,11 @@ namespace library
       Summary:  Rotates around the z-axis
       Args:     FLOAT angle
                   Angle of rotation around the z-axis, in radians
-      Modifies: [m_world].
+      Modifies: [m_transform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::RotateZ(_In_ FLOAT angle)
     {
-        m_world *= XMMatrixRotationZ(angle);
+        TransformSystem::GetDefault().Rotate(m_transform, XMQuaternionRotationNormal(XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), angle));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -500,27 +547,28 @@ namespace library
                   Angle of rotation around the y-axis, in radians
                 FLOAT roll
                   Angle of rotation around the z-axis, in radians
-      Modifies: [m_world].
+      Modifies: [m_transform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::RotateRollPitchYaw(_In_ FLOAT roll, _In_ FLOAT pitch, _In_ FLOAT yaw)
     {
-        m_world *= XMMatrixRotationRollPitchYaw(pitch, yaw, roll);
+        TransformSystem::GetDefault().Rotate(m_transform, XMQuaternionRotationRollPitchYaw(pitch, yaw, roll));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::Scale
-      Summary:  Scales along the x-axis, y-axis, and z-axis
+      Summary:  Scales along the x-axis, y-axis, and z-axis of the
+                object and its position about the origin
       Args:     FLOAT scaleX
                   Scaling factor along the x-axis.
                 FLOAT scaleY
                   Scaling factor along the y-axis.
                 FLOAT scaleZ
                   Scaling factor along the z-axis.
-      Modifies: [m_world].
+      Modifies: [m_transform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::Scale(_In_ FLOAT scaleX, _In_ FLOAT scaleY, _In_ FLOAT scaleZ)
     {
-        m_world *= XMMatrixScaling(scaleX, scaleY, scaleZ);
+        TransformSystem::GetDefault().Scale(m_transform, XMVectorSet(scaleX, scaleY, scaleZ, 1.0f));
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -528,11 +576,96 @@ namespace library
       Summary:  Translates matrix from a vector
       Args:     const XMVECTOR& offset
                   3D vector describing the translations along the x-axis, y-axis, and z-axis
-      Modifies: [m_world].
+      Modifies: [m_transform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderable::Translate(_In_ const XMVECTOR& offset)
     {
-        m_world *= XMMatrixTranslationFromVector(offset);
+        TransformSystem::GetDefault().Translate(m_transform, offset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::CopyStateFrom
+      Summary:  Takes the shaders and the world matrix of the object a
+                reloaded one replaces. Meshes and materials are not
+                copied since they come from the reloaded file
+      Args:     const Renderable& other
+                  Object being replaced
+      Modifies: [m_vertexShader, m_pixelShader, m_transform,
+                 m_previousWorld, m_bHasPreviousState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::CopyStateFrom(_In_ const Renderable& other)
+    {
+        m_vertexShader = other.m_vertexShader;
+        m_pixelShader = other.m_pixelShader;
+        TransformSystem& transformSystem = TransformSystem::GetDefault();
+        transformSystem.SetPosition(m_transform, transformSystem.GetPosition(other.m_transform));
+        transformSystem.SetRotation(m_transform, transformSystem.GetRotation(other.m_transform));
+        transformSystem.SetScale(m_transform, transformSystem.GetScale(other.m_transform));
+        m_previousWorld = other.m_previousWorld;
+        m_bHasPreviousState = other.m_bHasPreviousState;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetStatic
+      Summary:  Marks the renderable as never moving. The scene merges
+                static renderables into static batches when it is
+                initialized, so this has to be set before
+      Args:     BOOL bIsStatic
+                  Whether the renderable never moves
+      Modifies: [m_bIsStatic].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetStatic(_In_ BOOL bIsStatic)
+    {
+        m_bIsStatic = bIsStatic;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::IsStatic
+      Summary:  Returns whether the renderable never moves
+      Returns:  BOOL
+                  Whether the renderable is static
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderable::IsStatic() const
+    {
+        return m_bIsStatic;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::interpolateMatrix
+      Summary:  Blends two affine transforms part by part: scale and
+                translation linearly, rotation along the shortest arc.
+                Blending the matrices element-wise would shrink objects
+                mid-rotation
+      Args:     const XMMATRIX& from
+                  Transform at alpha 0
+                const XMMATRIX& to
+                  Transform at alpha 1, returned as is when either
+                  transform can't be decomposed
+                FLOAT alpha
+                  Blend weight
+      Returns:  XMMATRIX
+                  Blended transform
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX Renderable::interpolateMatrix(_In_ const XMMATRIX& from, _In_ const XMMATRIX& to, _In_ FLOAT alpha)
+    {
+        if (alpha >= 1.0f)
+        {
+            return to;
+        }
+
+        XMVECTOR fromScale, fromRotation, fromTranslation;
+        XMVECTOR toScale, toRotation, toTranslation;
+        if (!XMMatrixDecompose(&fromScale, &fromRotation, &fromTranslation, from) || !XMMatrixDecompose(&toScale, &toRotation, &toTranslation, to))
+        {
+            return to;
+        }
+
+        return XMMatrixAffineTransformation(
+            XMVectorLerp(fromScale, toScale, alpha),
+            XMVectorZero(),
+            XMQuaternionSlerp(fromRotation, toRotation, alpha),
+            XMVectorLerp(fromTranslation, toTranslation, alpha)
+        );
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -10,7 +10,10 @@
 
 #include "Common.h"
 
+#include <DirectXCollision.h>
+
 #include "Renderer/DataTypes.h"
+#include "Renderer/TransformSystem.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
@@ -33,6 +36,26 @@ namespace library
                   Returns the constant buffer
                 GetWorldMatrix
                   Returns the world matrix
+                SetWorldMatrix
+                  Replaces the transform with an affine matrix
+                GetTransform
+                  Returns the handle into the transform system
+                GetInterpolatedWorldMatrix
+                  Returns the world matrix between the last two
+                  simulation ticks
+                StorePreviousState
+                  Keeps the state of the last tick for interpolation
+                GetPermutation
+                  Returns the shader features the object is drawn with
+                GetBoundingSphere
+                  Returns the bounding sphere in object space
+                CopyStateFrom
+                  Takes the shaders and placement of another object
+                SetStatic
+                  Marks the object as never moving, so the scene may
+                  merge it into a static batch
+                IsStatic
+                  Returns whether the object never moves
                 GetNumVertices
                   Pure virtual function that returns the number of
                   vertices
@@ -46,6 +69,8 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Renderable
     {
+        friend class StaticBatch;
+
     public:
         static constexpr const UINT INVALID_MATERIAL = (0xFFFFFFFF);
 
@@ -72,7 +97,7 @@ namespace library
         Renderable(Renderable&& other) = delete;
         Renderable& operator=(const Renderable& other) = delete;
         Renderable& operator=(Renderable&& other) = delete;
-        virtual ~Renderable() = default;
+        virtual ~Renderable();
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) = 0;
         virtual void Update(_In_ FLOAT deltaTime) = 0;
@@ -83,6 +108,7 @@ namespace library
         void AddMaterial(_In_ const std::shared_ptr<Material>& material);
         HRESULT SetMaterialOfMesh(_In_ const UINT uMeshIndex, _In_ const UINT uMaterialIndex);
 
+        virtual ShaderPermutation GetPermutation() const;
         ComPtr<ID3D11VertexShader>& GetVertexShader();
         ComPtr<ID3D11PixelShader>& GetPixelShader();
         ComPtr<ID3D11InputLayout>& GetVertexLayout();
@@ -91,7 +117,12 @@ namespace library
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
         ComPtr<ID3D11Buffer>& GetNormalBuffer();
 
-        const XMMATRIX& GetWorldMatrix() const;
+        XMMATRIX GetWorldMatrix() const;
+        void SetWorldMatrix(_In_ const XMMATRIX& world);
+        const TransformHandle& GetTransform() const;
+        XMMATRIX GetInterpolatedWorldMatrix(_In_ FLOAT alpha) const;
+        virtual void StorePreviousState();
+        const BoundingSphere& GetBoundingSphere() const;
         const XMFLOAT4& GetOutputColor() const;
         BOOL HasTexture() const;
         const std::shared_ptr<Material>& GetMaterial(UINT uIndex) const;
@@ -103,6 +134,9 @@ namespace library
         void RotateRollPitchYaw(_In_ FLOAT roll, _In_ FLOAT pitch, _In_ FLOAT yaw);
         void Scale(_In_ FLOAT scaleX, _In_ FLOAT scaleY, _In_ FLOAT scaleZ);
         void Translate(_In_ const XMVECTOR& offset);
+        void CopyStateFrom(_In_ const Renderable& other);
+        void SetStatic(_In_ BOOL bIsStatic);
+        BOOL IsStatic() const;
 
         virtual UINT GetNumVertices() const = 0;
         virtual UINT GetNumIndices() const = 0;
@@ -118,9 +152,10 @@ namespace library
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext
         );
+        virtual HRESULT initializeVertexBuffers(_In_ ID3D11Device* pDevice);
 
         void calculateNormalMapVectors();
-        void calculateTangentBitangent(_In_ const SimpleVertex& v1, _In_ const SimpleVertex& v2, _In_ const SimpleVertex& v3, _Out_ XMFLOAT3& tangent, _Out_ XMFLOAT3& bitangent);
+        static XMMATRIX interpolateMatrix(_In_ const XMMATRIX& from, _In_ const XMMATRIX& to, _In_ FLOAT alpha);
 
     protected:
         ComPtr<ID3D11Buffer> m_vertexBuffer;
@@ -137,7 +172,11 @@ namespace library
 
         XMFLOAT4 m_outputColor;
         BYTE m_padding[8];
-        XMMATRIX m_world;
+        TransformHandle m_transform;
+        XMMATRIX m_previousWorld;
+        BoundingSphere m_boundingSphere;
         BOOL m_bHasNormalMap;
+        BOOL m_bHasPreviousState;
+        BOOL m_bIsStatic;
     };
 }
\ No newline at end of file
@@ -1,8 +1,9 @@
 #include "Renderer/Renderer.h"
 
+#include "Renderer/BonePalette.h"
+
 namespace library
 {
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Renderer
       Summary:  Constructor
@@ -10,9 +11,10 @@ namespace library
                   m_immediateContext, m_immediateContext1, m_swapChain,
                   m_swapChain1, m_renderTargetView, m_depthStencil,
                   m_depthStencilView, m_cbChangeOnResize, m_cbShadowMatrix,
-                  m_pszMainSceneName, m_camera, m_projection, m_scenes
-                  m_invalidTexture, m_shadowMapTexture, m_shadowVertexShader,
-                  m_shadowPixelShader].
+                  m_mainSceneName, m_camera, m_projection,
+                  m_projectedSizeScale, m_interpolationAlpha, m_scenes, m_mainScene, m_invalidTexture, m_shadowMapTexture, m_shadowVertexShader,
+                  m_shadowPixelShader, m_hotReloader, m_gpuProfiler, m_occlusionCuller,
+                  m_aDrawLists, m_skinningStats].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderer::Renderer()
         : m_driverType(D3D_DRIVER_TYPE_NULL)
@@ -29,15 +31,24 @@ namespace library
         , m_cbChangeOnResize(nullptr)
         , m_cbLights(nullptr)
         , m_cbShadowMatrix(nullptr)
-        , m_pszMainSceneName(nullptr)
+        , m_mainSceneName()
         , m_padding{ '\0' }
         , m_camera(XMVectorSet(0.0f, 3.0f, -6.0f, 0.0f))
         , m_projection()
+        , m_projectedSizeScale(1.0f)
+        , m_interpolationAlpha(1.0f)
         , m_scenes()
+        , m_mainScene()
         , m_invalidTexture(std::make_shared<Texture>(L"Content/Common/InvalidTexture.png"))
+        , m_textureCache(std::make_shared<TextureCache>())
         , m_shadowMapTexture()
         , m_shadowVertexShader()
         , m_shadowPixelShader()
+        , m_hotReloader()
+        , m_gpuProfiler()
+        , m_occlusionCuller(std::make_shared<OcclusionCuller>())
+        , m_aDrawLists()
+        , m_skinningStats()
     { }
 
 
@@ -261,7 +272,10 @@ namespace library
         }
 
         // Initialize the projection matrix
-        m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), 0.01f, 1000.0f);
+        m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(uWidth) / static_cast<FLOAT>(uHeight), NEAR_PLANE, FAR_PLANE);
+
+        // Pixels covered by a unit radius at unit distance, used to size streamed textures
+        m_projectedSizeScale = static_cast<FLOAT>(uHeight) / tanf(XM_PIDIV4 * 0.5f);
 
         CBChangeOnResize cbChangesOnResize =
         {
@@ -306,19 +320,22 @@ namespace library
             return hr;
         }
 
-        if (!m_scenes.contains(m_pszMainSceneName))
+        if (!m_mainScene)
         {
             return E_FAIL;
         }
 
         for (UINT i = 0u; i < NUM_LIGHTS; i++)
         {
-            m_scenes[m_pszMainSceneName]->GetPointLight(i)->Initialize(uWidth, uHeight);
+            m_mainScene->GetPointLight(i)->Initialize(uWidth, uHeight);
         }
 
         m_camera.Initialize(m_d3dDevice.Get());
 
-        hr = m_scenes[m_pszMainSceneName]->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+        // Warm starts take the bytecode of every unchanged shader from the disk
+        Shader::GetShaderCache()->Load();
+
+        hr = m_mainScene->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
 
         if (FAILED(hr))
         {
@@ -332,6 +349,83 @@ namespace library
             return hr;
         }
 
+        // Compile the shader permutations of the scene before the first frame, so they are saved with the cache
+        for (auto& renderable : m_mainScene->GetRenderables())
+        {
+            renderable->GetVertexShader();
+            renderable->GetPixelShader();
+        }
+
+        for (auto& batch : m_mainScene->GetStaticBatches())
+        {
+            batch->GetVertexShader();
+            batch->GetPixelShader();
+        }
+
+        for (auto& model : m_mainScene->GetModels())
+        {
+            model->GetVertexShader();
+            model->GetPixelShader();
+        }
+
+        for (auto& voxel : m_mainScene->GetVoxels())
+        {
+            voxel->GetVertexShader();
+            voxel->GetPixelShader();
+        }
+
+        TextureCacheStats textureCacheStats = m_textureCache->GetStats();
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Texture cache: %llu hits, %llu misses, %llu textures resident (%llu KB), %llu KB saved\n",
+            textureCacheStats.uNumHits,
+            textureCacheStats.uNumMisses,
+            textureCacheStats.uNumResidentTextures,
+            textureCacheStats.uResidentBytes / 1024ull,
+            textureCacheStats.uSavedBytes / 1024ull
+        );
+        OutputDebugString(szMessage);
+
+        if (!Shader::GetShaderCache()->Save())
+        {
+            OutputDebugString(L"Can't save the shader cache\n");
+        }
+
+        ShaderCacheStats shaderCacheStats = Shader::GetShaderCache()->GetStats();
+        swprintf_s(
+            szMessage,
+            L"Shader cache: %llu hits, %llu misses, %llu entries, %.1f ms preprocessing, %.1f ms compiling\n",
+            shaderCacheStats.uNumHits,
+            shaderCacheStats.uNumMisses,
+            shaderCacheStats.uNumEntries,
+            shaderCacheStats.preprocessSeconds * 1000.0,
+            shaderCacheStats.compileSeconds * 1000.0
+        );
+        OutputDebugString(szMessage);
+
+        m_gpuProfiler = std::make_shared<GpuProfiler>();
+        hr = m_gpuProfiler->Initialize(m_d3dDevice.Get());
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+#ifdef _DEBUG
+        // Edited shaders, textures, models and scene files replace the running ones
+        m_hotReloader = std::make_shared<HotReloader>();
+        m_hotReloader->AddShader(m_shadowVertexShader);
+        m_hotReloader->AddShader(m_shadowPixelShader);
+
+        hr = m_hotReloader->Initialize(m_d3dDevice.Get(), m_mainScene);
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+#endif
+
         return S_OK;
     }
 
@@ -348,12 +442,12 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, _In_ const std::shared_ptr<Scene>& scene)
     {
-        if (m_scenes.contains(pszSceneName))
+        if (m_scenes.Add(StringId::Intern(pszSceneName), scene) == INVALID_RESOURCE_HANDLE)
         {
             return E_FAIL;
         }
 
-        m_scenes[pszSceneName] = scene;
+        scene->SetTextureCache(m_textureCache);
 
         return S_OK;
     }
@@ -368,9 +462,10 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     std::shared_ptr<Scene> Renderer::GetSceneOrNull(_In_ PCWSTR pszSceneName)
     {
-        if (m_scenes.contains(pszSceneName))
+        std::shared_ptr<Scene>* pScene = m_scenes.TryGet(StringId(pszSceneName));
+        if (pScene)
         {
-            return m_scenes[pszSceneName];
+            return *pScene;
         }
 
         return nullptr;
@@ -381,18 +476,22 @@ namespace library
       Summary:  Set the main scene
       Args:     PCWSTR pszSceneName
                   The name of the scene
-      Modifies: [m_pszMainSceneName].
+      Modifies: [m_mainSceneName, m_mainScene].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Renderer::SetMainScene(_In_ PCWSTR pszSceneName)
     {
-        if (!m_scenes.contains(pszSceneName))
+        m_mainSceneName = StringId(pszSceneName);
+
+        std::shared_ptr<Scene>* pScene = m_scenes.TryGet(m_mainSceneName);
+        if (!pScene)
         {
             return E_FAIL;
         }
 
-        m_pszMainSceneName = pszSceneName;
+        // The frame uses the scene itself, so it never looks the name up again
+        m_mainScene = *pScene;
 
         return S_OK;
     }
@@ -414,7 +513,9 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::HandleInput
-      Summary:  Handle user mouse input
+      Summary:  Handle user mouse input. A left click removes the
+                block the camera looks at, a right click puts a block
+                of the same type in front of the face it looks at
       Args:     DirectionsInput& directions
                 MouseRelativeMovement& mouseRelativeMovement
                 FLOAT deltaTime
@@ -422,31 +523,98 @@ namespace library
     void Renderer::HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime)
     {
         m_camera.HandleInput(directions, mouseRelativeMovement, deltaTime);
+
+        if (m_mainScene && (mouseRelativeMovement.bLeftClick || mouseRelativeMovement.bRightClick))
+        {
+            VoxelWorld& voxelWorld = m_mainScene->GetVoxelWorld();
+
+            VoxelHit hit;
+            if (voxelWorld.Raycast(m_camera.GetEye(), m_camera.GetAt() - m_camera.GetEye(), PICK_DISTANCE, hit))
+            {
+                if (mouseRelativeMovement.bLeftClick)
+                {
+                    voxelWorld.ClearBlock(hit.Block.x, hit.Block.y, hit.Block.z);
+                }
+                else if (hit.Normal.x != 0 || hit.Normal.y != 0 || hit.Normal.z != 0)
+                {
+                    voxelWorld.SetBlock(
+                        hit.Block.x + hit.Normal.x,
+                        hit.Block.y + hit.Normal.y,
+                        hit.Block.z + hit.Normal.z,
+                        static_cast<eBlockType>(voxelWorld.GetBlock(hit.Block.x, hit.Block.y, hit.Block.z))
+                    );
+                }
+            }
+        }
     }
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Update
-      Summary:  Update the renderables each frame
+      Summary:  Update the camera, the reloaded resources and the
+                edited voxel chunks each frame, and release the cached
+                textures that reloads left unused
       Args:     FLOAT deltaTime
                   Time difference of a frame
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::Update(_In_ FLOAT deltaTime)
     {
-        m_scenes[m_pszMainSceneName]->Update(deltaTime);
+        PROFILE_ZONE("Renderer::Update");
+
+        // Between two frames, so nothing in flight uses the resources being replaced
+        if (m_hotReloader)
+        {
+            m_hotReloader->Update();
+        }
+        m_textureCache->EvictUnused();
 
         m_camera.Update(deltaTime);
+
+        if (m_mainScene && FAILED(m_mainScene->UpdateVoxels(m_d3dDevice.Get())))
+        {
+            OutputDebugString(L"Can't remesh the voxels\n");
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::Tick
+      Summary:  Advances the simulation of the main scene by one fixed
+                tick
+      Args:     FLOAT tickTime
+                  Length of a tick
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::Tick(_In_ FLOAT tickTime)
+    {
+        m_mainScene->Update(tickTime);
     }
 
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Render
       Summary:  Render the frame
+      Args:     FLOAT alpha
+                  Fraction of a tick the frame is past the last
+                  simulation tick, used to interpolate the objects
+                  between their last two states
+      Modifies: [m_interpolationAlpha].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Renderer::Render()
+    void Renderer::Render(_In_ FLOAT alpha)
     {
+        PROFILE_ZONE("Renderer::Render");
+        m_interpolationAlpha = alpha;
+        m_gpuProfiler->BeginFrame(m_immediateContext.Get());
+
+        // Pick up transforms changed outside of a simulation tick
+        TransformSystem::GetDefault().UpdateWorldMatrices();
+
         // RenderSceneToTexture();
 
+        // Swap in streamed texture mips and schedule the next loads
+        if (FAILED(m_textureCache->UpdateStreaming(m_d3dDevice.Get(), m_immediateContext.Get())))
+        {
+            OutputDebugString(L"Can't update texture streaming\n");
+        }
+
         // Clear the back buffer
         m_immediateContext->ClearRenderTargetView(m_renderTargetView.Get(), Colors::MidnightBlue);
 
@@ -468,19 +636,23 @@ namespace library
 
         for (UINT i = 0u; i < NUM_LIGHTS; ++i)
         {
-            FLOAT attenuationDistance = m_scenes[m_pszMainSceneName]->GetPointLight(i)->GetAttenuationDistance();
+            FLOAT attenuationDistance = m_mainScene->GetPointLight(i)->GetAttenuationDistance();
             FLOAT attenuationDistanceSquared = attenuationDistance * attenuationDistance;
 
             
-            cbLights.LightPositions[i] = m_scenes[m_pszMainSceneName]->GetPointLight(i)->GetPosition();
-            cbLights.LightColors[i] = m_scenes[m_pszMainSceneName]->GetPointLight(i)->GetColor();
+            cbLights.LightPositions[i] = m_mainScene->GetPointLight(i)->GetPosition();
+            cbLights.LightColors[i] = m_mainScene->GetPointLight(i)->GetColor();
             cbLights.LightAttenuationDistance[i] = XMFLOAT4(attenuationDistance, attenuationDistance, attenuationDistanceSquared, attenuationDistanceSquared);
         }
 
         m_immediateContext->UpdateSubresource(m_cbLights.Get(), 0u, nullptr, &cbLights, 0u, 0u);
 
-        if (m_scenes[m_pszMainSceneName]->GetSkyBox())
+        buildDrawLists();
+
+        if (m_mainScene->GetSkyBox())
         {
+            PROFILE_GPU_ZONE(m_gpuProfiler.get(), m_immediateContext.Get(), "Skybox");
+
             UINT aStrides[2] =
             {
                 sizeof(SimpleVertex),
@@ -490,369 +662,397 @@ namespace library
 
             ComPtr<ID3D11Buffer> aBuffers[2] =
             {
-                m_scenes[m_pszMainSceneName]->GetSkyBox()->GetVertexBuffer().Get(),
-                m_scenes[m_pszMainSceneName]->GetSkyBox()->GetNormalBuffer().Get()
+                m_mainScene->GetSkyBox()->GetVertexBuffer().Get(),
+                m_mainScene->GetSkyBox()->GetNormalBuffer().Get()
             };
 
             // Set the vertex buffer
             m_immediateContext->IASetVertexBuffers(0u, 2u, aBuffers->GetAddressOf(), aStrides, aOffsets);
 
             // Set the index buffer
-            m_immediateContext->IASetIndexBuffer(m_scenes[m_pszMainSceneName]->GetSkyBox()->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+            m_immediateContext->IASetIndexBuffer(m_mainScene->GetSkyBox()->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
 
             // Set the input layout
-            m_immediateContext->IASetInputLayout(m_scenes[m_pszMainSceneName]->GetSkyBox()->GetVertexLayout().Get());
+            m_immediateContext->IASetInputLayout(m_mainScene->GetSkyBox()->GetVertexLayout().Get());
 
             CBChangesEveryFrame cbChangesEveryFrame =
             {
-                .World = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetSkyBox()->GetWorldMatrix()),
-                .OutputColor = m_scenes[m_pszMainSceneName]->GetSkyBox()->GetOutputColor(),
-                .HasNormalMap = m_scenes[m_pszMainSceneName]->GetSkyBox()->HasNormalMap()
+                .World = XMMatrixTranspose(m_mainScene->GetSkyBox()->GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+                .OutputColor = m_mainScene->GetSkyBox()->GetOutputColor(),
+                .HasNormalMap = m_mainScene->GetSkyBox()->HasNormalMap()
             };
-            m_immediateContext->UpdateSubresource(m_scenes[m_pszMainSceneName]->GetSkyBox()->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
+            m_immediateContext->UpdateSubresource(m_mainScene->GetSkyBox()->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
 
-            m_immediateContext->VSSetShader(m_scenes[m_pszMainSceneName]->GetSkyBox()->GetVertexShader().Get(), nullptr, 0u);
+            m_immediateContext->VSSetShader(m_mainScene->GetSkyBox()->GetVertexShader().Get(), nullptr, 0u);
             m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
             m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-            m_immediateContext->VSSetConstantBuffers(2u, 1u, m_scenes[m_pszMainSceneName]->GetSkyBox()->GetConstantBuffer().GetAddressOf());
+            m_immediateContext->VSSetConstantBuffers(2u, 1u, m_mainScene->GetSkyBox()->GetConstantBuffer().GetAddressOf());
             m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
 
             m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
             m_immediateContext->PSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-            m_immediateContext->PSSetConstantBuffers(2u, 1u, m_scenes[m_pszMainSceneName]->GetSkyBox()->GetConstantBuffer().GetAddressOf());
-            m_immediateContext->PSSetShader(m_scenes[m_pszMainSceneName]->GetSkyBox()->GetPixelShader().Get(), nullptr, 0u);
+            m_immediateContext->PSSetConstantBuffers(2u, 1u, m_mainScene->GetSkyBox()->GetConstantBuffer().GetAddressOf());
+            m_immediateContext->PSSetShader(m_mainScene->GetSkyBox()->GetPixelShader().Get(), nullptr, 0u);
 
-            if (m_scenes[m_pszMainSceneName]->GetSkyBox()->HasTexture())
+            if (m_mainScene->GetSkyBox()->HasTexture())
             {
-                for (UINT i = 0u; i < m_scenes[m_pszMainSceneName]->GetSkyBox()->GetNumMeshes(); ++i)
+                for (UINT i = 0u; i < m_mainScene->GetSkyBox()->GetNumMeshes(); ++i)
                 {
-                    UINT materialIndex = m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMesh(i).uMaterialIndex;
+                    UINT materialIndex = m_mainScene->GetSkyBox()->GetMesh(i).uMaterialIndex;
 
-                    if (m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse)
+                    if (m_mainScene->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse)
                     {
-                        eTextureSamplerType textureSamplerType = m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+                        eTextureSamplerType textureSamplerType = m_mainScene->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
 
-                        m_immediateContext->PSSetShaderResources(0u, 1u, m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                        m_immediateContext->PSSetShaderResources(0u, 1u, m_mainScene->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
                         m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                     }
 
-                    if (m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMaterial(materialIndex)->pNormal)
+                    if (m_mainScene->GetSkyBox()->GetMaterial(materialIndex)->pNormal)
                     {
-                        eTextureSamplerType textureSamplerType = m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+                        eTextureSamplerType textureSamplerType = m_mainScene->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetSamplerType();
 
-                        m_immediateContext->PSSetShaderResources(1u, 1u, m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
+                        m_immediateContext->PSSetShaderResources(1u, 1u, m_mainScene->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
                         m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
                     }
 
                     m_immediateContext->DrawIndexed(
-                        m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMesh(i).uNumIndices,
-                        m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMesh(i).uBaseIndex,
-                        m_scenes[m_pszMainSceneName]->GetSkyBox()->GetMesh(i).uBaseVertex
+                        m_mainScene->GetSkyBox()->GetMesh(i).uNumIndices,
+                        m_mainScene->GetSkyBox()->GetMesh(i).uBaseIndex,
+                        m_mainScene->GetSkyBox()->GetMesh(i).uBaseVertex
                     );
                 }
             }
         }
 
-        for (auto scene = m_scenes.begin(); scene != m_scenes.end(); ++scene)
+        UINT uScene = 0u;
+        for (auto scene = m_scenes.begin(); scene != m_scenes.end(); ++scene, ++uScene)
         {
-            for (auto renderable = scene->second->GetRenderables().begin(); renderable != scene->second->GetRenderables().end(); ++renderable)
+            const DrawList& drawList = m_aDrawLists[uScene];
+
             {
-                // Set the vertex buffer
-                UINT aStrides[2] =
-                {
-                    static_cast<UINT>(sizeof(SimpleVertex)),
-                    static_cast<UINT>(sizeof(NormalData))
-                };
-                UINT aOffsets[2] = { 0u, 0u };
-                ComPtr<ID3D11Buffer> aBuffers[2]
+                PROFILE_GPU_ZONE(m_gpuProfiler.get(), m_immediateContext.Get(), "Renderables");
+
+                for (UINT uRenderable = 0u; uRenderable < drawList.apRenderables.size(); ++uRenderable)
                 {
-                   renderable->second->GetVertexBuffer(),
-                   renderable->second->GetNormalBuffer()
-                };
+                    if (!drawList.abIsVisible[uRenderable])
+                    {
+                        continue;
+                    }
 
-                m_immediateContext->IASetVertexBuffers(0u, 2u, aBuffers->GetAddressOf(), aStrides, aOffsets);
+                    Renderable* renderable = drawList.apRenderables[uRenderable];
+                    reportTextureUsage(*renderable, drawList.aRenderableWorlds[uRenderable]);
 
-                // Set the index buffer
-                m_immediateContext->IASetIndexBuffer(renderable->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+                    // Set the vertex buffer
+                    UINT aStrides[2] =
+                    {
+                        static_cast<UINT>(sizeof(SimpleVertex)),
+                        static_cast<UINT>(sizeof(NormalData))
+                    };
+                    UINT aOffsets[2] = { 0u, 0u };
+                    ComPtr<ID3D11Buffer> aBuffers[2]
+                    {
+                       renderable->GetVertexBuffer(),
+                       renderable->GetNormalBuffer()
+                    };
 
-                // Set the input layout
-                m_immediateContext->IASetInputLayout(renderable->second->GetVertexLayout().Get());
+                    m_immediateContext->IASetVertexBuffers(0u, 2u, aBuffers->GetAddressOf(), aStrides, aOffsets);
 
-                // Create renderable constant buffer and update
-                CBChangesEveryFrame cbChangesEveryFrame =
-                {
-                    .World = XMMatrixTranspose(renderable->second->GetWorldMatrix()),
-                    .OutputColor = renderable->second->GetOutputColor(),
-                    .HasNormalMap = renderable->second->HasNormalMap()
-                };
-                m_immediateContext->UpdateSubresource(renderable->second->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
-
-                // Render
-                m_immediateContext->VSSetShader(renderable->second->GetVertexShader().Get(), nullptr, 0u);
-                m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(2u, 1u, renderable->second->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
-
-                m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(2u, 1u, renderable->second->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
-                m_immediateContext->PSSetShader(renderable->second->GetPixelShader().Get(), nullptr, 0u);
-
-                if (renderable->second->HasTexture())
-                {
-                    for (UINT i = 0u; i < renderable->second->GetNumMeshes(); ++i)
-                    {
-                        UINT materialIndex = renderable->second->GetMesh(i).uMaterialIndex;
+                    // Set the index buffer
+                    m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
 
-                        if (scene->second->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse)
-                        {
-                            eTextureSamplerType textureSamplerType = scene->second->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+                    // Set the input layout
+                    m_immediateContext->IASetInputLayout(renderable->GetVertexLayout().Get());
 
-                            m_immediateContext->PSSetShaderResources(0u, 1u, scene->second->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
+                    // Update the renderable constant buffer
+                    m_immediateContext->UpdateSubresource(renderable->GetConstantBuffer().Get(), 0u, nullptr, &drawList.aRenderableConstants[uRenderable], 0u, 0u);
 
-                        if (scene->second->GetSkyBox()->GetMaterial(materialIndex)->pNormal)
-                        {
-                            eTextureSamplerType textureSamplerType = scene->second->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+                    // Render
+                    m_immediateContext->VSSetShader(renderable->GetVertexShader().Get(), nullptr, 0u);
+                    m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(2u, 1u, renderable->GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
 
-                            m_immediateContext->PSSetShaderResources(1u, 1u, scene->second->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
-                    }
+                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(2u, 1u, renderable->GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
+                    m_immediateContext->PSSetShader(renderable->GetPixelShader().Get(), nullptr, 0u);
 
-                    for (UINT i = 0u; i < renderable->second->GetNumMeshes(); ++i)
+                    if (renderable->HasTexture())
                     {
-                        UINT materialIndex = renderable->second->GetMesh(i).uMaterialIndex;
-
-                        if (renderable->second->GetMaterial(materialIndex)->pDiffuse)
+                        for (UINT i = 0u; i < renderable->GetNumMeshes(); ++i)
                         {
-                            eTextureSamplerType textureSamplerType = renderable->second->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+                            UINT materialIndex = renderable->GetMesh(i).uMaterialIndex;
 
-                            m_immediateContext->PSSetShaderResources(0u, 1u, renderable->second->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(2u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
+                            if ((*scene)->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse)
+                            {
+                                eTextureSamplerType textureSamplerType = (*scene)->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
 
-                        if (renderable->second->GetMaterial(materialIndex)->pNormal)
-                        {
-                            eTextureSamplerType textureSamplerType = renderable->second->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+                                m_immediateContext->PSSetShaderResources(0u, 1u, (*scene)->GetSkyBox()->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
 
-                            m_immediateContext->PSSetShaderResources(1u, 1u, renderable->second->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(3u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            if ((*scene)->GetSkyBox()->GetMaterial(materialIndex)->pNormal)
+                            {
+                                eTextureSamplerType textureSamplerType = (*scene)->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(1u, 1u, (*scene)->GetSkyBox()->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
                         }
 
-                        if (m_shadowMapTexture != nullptr)
+                        for (UINT i = 0u; i < renderable->GetNumMeshes(); ++i)
                         {
-                            m_immediateContext->PSSetShaderResources(4u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(4u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+                            UINT materialIndex = renderable->GetMesh(i).uMaterialIndex;
+
+                            if (renderable->GetMaterial(materialIndex)->pDiffuse)
+                            {
+                                eTextureSamplerType textureSamplerType = renderable->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(0u, 1u, renderable->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(2u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
+
+                            if (renderable->GetMaterial(materialIndex)->pNormal)
+                            {
+                                eTextureSamplerType textureSamplerType = renderable->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(1u, 1u, renderable->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(3u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
+
+                            if (m_shadowMapTexture != nullptr)
+                            {
+                                m_immediateContext->PSSetShaderResources(4u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(4u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+                            }
+
+                            m_immediateContext->DrawIndexed(
+                                renderable->GetMesh(i).uNumIndices,
+                                renderable->GetMesh(i).uBaseIndex,
+                                renderable->GetMesh(i).uBaseVertex
+                            );
                         }
-
-                        m_immediateContext->DrawIndexed(
-                            renderable->second->GetMesh(i).uNumIndices,
-                            renderable->second->GetMesh(i).uBaseIndex,
-                            renderable->second->GetMesh(i).uBaseVertex
-                        );
                     }
-                }
-                else
-                {
-                    m_immediateContext->DrawIndexed(renderable->second->GetNumIndices(), 0u, 0);
+                    else
+                    {
+                        m_immediateContext->DrawIndexed(renderable->GetNumIndices(), 0u, 0);
+                    }
                 }
             }
 
             // Render the voxels
-            for (auto voxel : scene->second->GetVoxels())
             {
-                UINT aStrides[3] =
-                {
-                    static_cast<UINT>(sizeof(SimpleVertex)),
-                    static_cast<UINT>(sizeof(NormalData)),
-                    static_cast<UINT>(sizeof(InstanceData))
-                };
-                UINT aOffsets[3] = { 0u, 0u, 0u };
-
-                ComPtr<ID3D11Buffer> aBuffers[3] =
-                {
-                    voxel->GetVertexBuffer(),
-                    voxel->GetNormalBuffer(),
-                    voxel->GetInstanceBuffer()
-                };
+                PROFILE_GPU_ZONE(m_gpuProfiler.get(), m_immediateContext.Get(), "Voxels");
 
-                // Set the vertex buffer
-                m_immediateContext->IASetVertexBuffers(0u, 3u, aBuffers->GetAddressOf(), aStrides, aOffsets);
-
-                // Set the index buffer
-                m_immediateContext->IASetIndexBuffer(voxel->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-
-                // Set the input layout
-                m_immediateContext->IASetInputLayout(voxel->GetVertexLayout().Get());
-
-                // Set the constant buffer
-                CBChangesEveryFrame cbChangesEveryFrame =
+                for (auto voxel : (*scene)->GetVoxels())
                 {
-                    .World = XMMatrixTranspose(voxel->GetWorldMatrix()),
-                    .OutputColor = voxel->GetOutputColor(),
-                    .HasNormalMap = voxel->HasNormalMap()
-                };
-
-                m_immediateContext->UpdateSubresource(voxel->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
+                    UINT aStrides[4] =
+                    {
+                        static_cast<UINT>(sizeof(SimpleVertex)),
+                        static_cast<UINT>(sizeof(NormalData)),
+                        static_cast<UINT>(sizeof(InstanceData)),
+                        static_cast<UINT>(sizeof(BYTE))
+                    };
+                    UINT aOffsets[4] = { 0u, 0u, 0u, 0u };
+
+                    ComPtr<ID3D11Buffer> aBuffers[4] =
+                    {
+                        voxel->GetVertexBuffer(),
+                        voxel->GetNormalBuffer(),
+                        voxel->GetInstanceBuffer(),
+                        voxel->GetAmbientOcclusionBuffer()
+                    };
 
-                m_immediateContext->VSSetShader(voxel->GetVertexShader().Get(), nullptr, 0u);
-                m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(2u, 1u, voxel->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
+                    // Set the vertex buffer
+                    m_immediateContext->IASetVertexBuffers(0u, 4u, aBuffers->GetAddressOf(), aStrides, aOffsets);
 
-                m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(2u, 1u, voxel->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
-                m_immediateContext->PSSetShader(voxel->GetPixelShader().Get(), nullptr, 0u);
+                    // Set the index buffer
+                    m_immediateContext->IASetIndexBuffer(voxel->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
 
+                    // Set the input layout
+                    m_immediateContext->IASetInputLayout(voxel->GetVertexLayout().Get());
 
-                if (voxel->HasTexture())
-                {
-                    for (UINT i = 0; i < voxel->GetNumMeshes(); ++i)
+                    // Set the constant buffer
+                    CBChangesEveryFrame cbChangesEveryFrame =
                     {
-                        UINT materialIndex = voxel->GetMesh(i).uMaterialIndex;
+                        .World = XMMatrixTranspose(voxel->GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+                        .OutputColor = voxel->GetOutputColor(),
+                        .HasNormalMap = voxel->HasNormalMap()
+                    };
 
-                        if (voxel->GetMaterial(materialIndex)->pDiffuse)
-                        {
-                            eTextureSamplerType textureSamplerType = voxel->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+                    m_immediateContext->UpdateSubresource(voxel->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
 
-                            m_immediateContext->PSSetShaderResources(0u, 1u, voxel->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
+                    m_immediateContext->VSSetShader(voxel->GetVertexShader().Get(), nullptr, 0u);
+                    m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(2u, 1u, voxel->GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
 
-                        if (voxel->GetMaterial(materialIndex)->pNormal)
-                        {
-                            eTextureSamplerType textureSamplerType = voxel->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(2u, 1u, voxel->GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
+                    m_immediateContext->PSSetShader(voxel->GetPixelShader().Get(), nullptr, 0u);
 
-                            m_immediateContext->PSSetShaderResources(1u, 1u, voxel->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
-                        }
 
-                        if (m_shadowMapTexture != nullptr)
+                    if (voxel->HasTexture())
+                    {
+                        for (UINT i = 0; i < voxel->GetNumMeshes(); ++i)
                         {
-                            m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+                            UINT materialIndex = voxel->GetMesh(i).uMaterialIndex;
+
+                            if (voxel->GetMaterial(materialIndex)->pDiffuse)
+                            {
+                                eTextureSamplerType textureSamplerType = voxel->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(0u, 1u, voxel->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
+
+                            if (voxel->GetMaterial(materialIndex)->pNormal)
+                            {
+                                eTextureSamplerType textureSamplerType = voxel->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(1u, 1u, voxel->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
+
+                            if (m_shadowMapTexture != nullptr)
+                            {
+                                m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+                            }
+
+                            m_immediateContext->DrawIndexedInstanced(
+                                voxel->GetMesh(i).uNumIndices,
+                                voxel->GetNumInstances(),
+                                voxel->GetMesh(i).uBaseIndex,
+                                voxel->GetMesh(i).uBaseVertex,
+                                0
+                            );
                         }
-
-                        m_immediateContext->DrawIndexedInstanced(
-                            voxel->GetMesh(i).uNumIndices,
-                            voxel->GetNumInstances(),
-                            voxel->GetMesh(i).uBaseIndex,
-                            voxel->GetMesh(i).uBaseVertex,
-                            0
-                        );
                     }
-                }
-                else
-                {
-                    // Draw
-                    m_immediateContext->DrawIndexedInstanced(voxel->GetNumIndices(), voxel->GetNumInstances(), 0u, 0, 0u);
+                    else
+                    {
+                        // Draw
+                        m_immediateContext->DrawIndexedInstanced(voxel->GetNumIndices(), voxel->GetNumInstances(), 0u, 0, 0u);
+                    }
                 }
             }
 
             // Render the models
-            for (auto model = scene->second->GetModels().begin(); model != scene->second->GetModels().end(); ++model)
             {
-                // Set the vertex buffer
-                UINT aStrides[3] =
-                {
-                    static_cast<UINT>(sizeof(SimpleVertex)),
-                    static_cast<UINT>(sizeof(NormalData)),
-                    static_cast<UINT>(sizeof(AnimationData))
-                };
-                UINT aOffsets[3] = { 0u, 0u, 0u };
+                PROFILE_GPU_ZONE(m_gpuProfiler.get(), m_immediateContext.Get(), "Models");
 
-                ComPtr<ID3D11Buffer> aBuffers[3]
+                for (UINT uModel = 0u; uModel < drawList.apModels.size(); ++uModel)
                 {
-                   model->second->GetVertexBuffer(),
-                   model->second->GetNormalBuffer(),
-                   model->second->GetAnimationBuffer()
-                };
+                    Model* model = drawList.apModels[uModel];
+                    // The constants hold the transposed interpolated world matrix the model is drawn with
+                    reportTextureUsage(*model, XMMatrixTranspose(drawList.aModelConstants[uModel].World));
 
-                m_immediateContext->IASetVertexBuffers(0u, 3u, aBuffers->GetAddressOf(), aStrides, aOffsets);
-                m_immediateContext->IASetIndexBuffer(model->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
-                m_immediateContext->IASetInputLayout(model->second->GetVertexLayout().Get());
+                    // Set the vertex buffer
+                    UINT aStrides[3] =
+                    {
+                        static_cast<UINT>(model->HasPackedVertices() ? sizeof(PackedVertex) : sizeof(SimpleVertex)),
+                        static_cast<UINT>(model->HasPackedVertices() ? sizeof(PackedNormalData) : sizeof(NormalData)),
+                        static_cast<UINT>(model->HasPackedVertices() ? sizeof(PackedAnimationData) : sizeof(AnimationData))
+                    };
+                    UINT aOffsets[3] = { 0u, 0u, 0u };
 
-                // Create model's constant buffer and update
-                CBChangesEveryFrame cbChangesEveryFrame =
-                {
-                    .World = XMMatrixTranspose(model->second->GetWorldMatrix()),
-                    .OutputColor = model->second->GetOutputColor(),
-                    .HasNormalMap = model->second->HasNormalMap()
-                };
-                m_immediateContext->UpdateSubresource(model->second->GetConstantBuffer().Get(), 0u, nullptr, &cbChangesEveryFrame, 0u, 0u);
+                    ComPtr<ID3D11Buffer> aBuffers[3]
+                    {
+                       model->GetVertexBuffer(),
+                       model->GetNormalBuffer(),
+                       model->GetAnimationBuffer()
+                    };
 
-                CBSkinning cbSkinning =
-                {
-                    .BoneTransforms = {}
-                };
+                    m_immediateContext->IASetVertexBuffers(0u, 3u, aBuffers->GetAddressOf(), aStrides, aOffsets);
+                    m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+                    m_immediateContext->IASetInputLayout(model->GetVertexLayout().Get());
 
-                for (UINT i = 0u; i < model->second->GetBoneTransforms().size(); ++i)
-                {
-                    cbSkinning.BoneTransforms[i] = XMMatrixTranspose(model->second->GetBoneTransforms()[i]);
-                }
-                m_immediateContext->UpdateSubresource(model->second->GetSkinningConstantBuffer().Get(), 0u, nullptr, &cbSkinning, 0u, 0u);
-
-                // Render
-                m_immediateContext->VSSetShader(model->second->GetVertexShader().Get(), nullptr, 0);
-                m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(2u, 1u, model->second->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
-                m_immediateContext->VSSetConstantBuffers(4u, 1u, model->second->GetSkinningConstantBuffer().GetAddressOf());
-
-                m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(2u, 1u, model->second->GetConstantBuffer().GetAddressOf());
-                m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
-                m_immediateContext->PSSetShader(model->second->GetPixelShader().Get(), nullptr, 0);
-
-                if (model->second->HasTexture())
-                {
-                    for (UINT i = 0u; i < model->second->GetNumMeshes(); ++i)
-                    {
-                        UINT materialIndex = model->second->GetMesh(i).uMaterialIndex;
+                    // Update the model's constant buffer and the bones its skeleton uses
+                    m_immediateContext->UpdateSubresource(model->GetConstantBuffer().Get(), 0u, nullptr, &drawList.aModelConstants[uModel], 0u, 0u);
 
-                        if (model->second->GetMaterial(materialIndex)->pDiffuse)
+                    UINT uNumBones = drawList.auModelBoneOffsets[uModel + 1u] - drawList.auModelBoneOffsets[uModel];
+                    if (uNumBones > 0u)
+                    {
+                        if (FAILED(model->UploadBonePalette(m_immediateContext.Get(), &drawList.aBonePalettes[drawList.auModelBoneOffsets[uModel]], uNumBones)))
                         {
-                            eTextureSamplerType textureSamplerType = model->second->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
-
-                            m_immediateContext->PSSetShaderResources(0u, 1u, model->second->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            OutputDebugString(L"Can't upload the bone palette\n");
                         }
 
-                        if (model->second->GetMaterial(materialIndex)->pNormal)
-                        {
-                            eTextureSamplerType textureSamplerType = model->second->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+                        ++m_skinningStats.uNumSkinnedDraws;
+                        m_skinningStats.uUploadedBytes += sizeof(BoneTransform3x4) * uNumBones;
+                        m_skinningStats.uFullPaletteBytes += sizeof(XMMATRIX) * MAX_NUM_BONES;
+                    }
 
-                            m_immediateContext->PSSetShaderResources(1u, 1u, model->second->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(1u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                    // Render
+                    m_immediateContext->VSSetShader(model->GetVertexShader().Get(), nullptr, 0);
+                    m_immediateContext->VSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(2u, 1u, model->GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->VSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
+                    m_immediateContext->VSSetShaderResources(1u, 1u, model->GetSkinningShaderResourceView().GetAddressOf());
+
+                    m_immediateContext->PSSetConstantBuffers(0u, 1u, m_camera.GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(1u, 1u, m_cbChangeOnResize.GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(2u, 1u, model->GetConstantBuffer().GetAddressOf());
+                    m_immediateContext->PSSetConstantBuffers(3u, 1u, m_cbLights.GetAddressOf());
+                    m_immediateContext->PSSetShader(model->GetPixelShader().Get(), nullptr, 0);
+
+                    if (model->HasTexture())
+                    {
+                        for (UINT i = 0u; i < model->GetNumMeshes(); ++i)
+                        {
+                            UINT materialIndex = model->GetMesh(i).uMaterialIndex;
+
+                            if (model->GetMaterial(materialIndex)->pDiffuse)
+                            {
+                                eTextureSamplerType textureSamplerType = model->GetMaterial(materialIndex)->pDiffuse->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(0u, 1u, model->GetMaterial(materialIndex)->pDiffuse->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(0u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
+
+                            if (model->GetMaterial(materialIndex)->pNormal)
+                            {
+                                eTextureSamplerType textureSamplerType = model->GetMaterial(materialIndex)->pNormal->GetSamplerType();
+
+                                m_immediateContext->PSSetShaderResources(1u, 1u, model->GetMaterial(materialIndex)->pNormal->GetTextureResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(1u, 1u, Texture::s_samplers[static_cast<size_t>(textureSamplerType)].GetAddressOf());
+                            }
+
+                            if (m_shadowMapTexture != nullptr)
+                            {
+                                m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
+                                m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+                            }
+
+                            const Model::MeshLod& lod = model->GetMeshLod(i, drawList.aaModelMeshLods[uModel][i]);
+                            m_immediateContext->DrawIndexed(
+                                lod.uNumIndices,
+                                lod.uBaseIndex,
+                                model->GetMesh(i).uBaseVertex
+                            );
                         }
-
-                        if (m_shadowMapTexture != nullptr)
+                    }
+                    else
+                    {
+                        // The index buffer also holds the levels of detail, so only the selected ones are drawn
+                        for (UINT i = 0u; i < model->GetNumMeshes(); ++i)
                         {
-                            m_immediateContext->PSSetShaderResources(2u, 1u, m_shadowMapTexture->GetShaderResourceView().GetAddressOf());
-                            m_immediateContext->PSSetSamplers(2u, 1u, m_shadowMapTexture->GetSamplerState().GetAddressOf());
+                            const Model::MeshLod& lod = model->GetMeshLod(i, drawList.aaModelMeshLods[uModel][i]);
+                            m_immediateContext->DrawIndexed(lod.uNumIndices, lod.uBaseIndex, static_cast<INT>(model->GetMesh(i).uBaseVertex));
                         }
-
-                        m_immediateContext->DrawIndexed(
-                            model->second->GetMesh(i).uNumIndices,
-                            model->second->GetMesh(i).uBaseIndex,
-                            model->second->GetMesh(i).uBaseVertex
-                        );
                     }
                 }
-                else
-                {
-                    m_immediateContext->DrawIndexed(model->second->GetNumIndices(), 0u, 0);
-                }
             }
             // Present the information rendered to the back buffer to the front buffer
-            m_swapChain->Present(0u, 0u);
+            {
+                PROFILE_ZONE("Present");
+                m_swapChain->Present(0u, 0u);
+            }
 
             /*
             ComPtr<ID3D11ShaderResourceView> shaderResourceView[1] = { nullptr };
@@ -864,6 +1064,8 @@ namespace library
             m_immediateContext->IASetVertexBuffers(0u, 3u, vertexBuffers->GetAddressOf(), &zero, &zero);
             */
         }
+
+        m_gpuProfiler->EndFrame(m_immediateContext.Get());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -872,6 +1074,8 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::RenderSceneToTexture()
     {
+        PROFILE_GPU_ZONE(m_gpuProfiler.get(), m_immediateContext.Get(), "ShadowPass");
+
         m_immediateContext->OMSetRenderTargets(1u, m_shadowMapTexture->GetRenderTargetView().GetAddressOf(), m_depthStencilView.Get());
 
         m_immediateContext->ClearRenderTargetView(m_shadowMapTexture->GetRenderTargetView().Get(), Colors::White);
@@ -880,16 +1084,31 @@ namespace library
         m_immediateContext->VSSetShader(m_shadowVertexShader->GetVertexShader().Get(), nullptr, 0u);
         m_immediateContext->PSSetShader(m_shadowPixelShader->GetPixelShader().Get(), nullptr, 0u);
 
-        for (auto renderable : m_scenes[m_pszMainSceneName]->GetRenderables())
+        // Static renderables cast their shadows through their batches
+        std::vector<Renderable*> apShadowCasters;
+        for (auto& renderable : m_mainScene->GetRenderables())
+        {
+            if (!renderable->IsStatic())
+            {
+                apShadowCasters.push_back(renderable.get());
+            }
+        }
+
+        for (auto& batch : m_mainScene->GetStaticBatches())
+        {
+            apShadowCasters.push_back(batch.get());
+        }
+
+        for (Renderable* renderable : apShadowCasters)
         {
             // Set the vertex buffer
             UINT uStride = sizeof(SimpleVertex);
             UINT uOffset = 0;
 
-            m_immediateContext->IASetVertexBuffers(0u, 1u, renderable.second->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
+            m_immediateContext->IASetVertexBuffers(0u, 1u, renderable->GetVertexBuffer().GetAddressOf(), &uStride, &uOffset);
 
             // Set the index buffer
-            m_immediateContext->IASetIndexBuffer(renderable.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
+            m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0u);
 
             // Set the input layout
             m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
@@ -897,9 +1116,9 @@ namespace library
             // Shadow constant buffer
             CBShadowMatrix cbShadowMatrix =
             {
-                .World = XMMatrixTranspose(renderable.second->GetWorldMatrix()),
-                .View = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0)->GetViewMatrix()),
-                .Projection = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0)->GetProjectionMatrix()),
+                .World = XMMatrixTranspose(renderable->GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+                .View = XMMatrixTranspose(m_mainScene->GetPointLight(0)->GetViewMatrix()),
+                .Projection = XMMatrixTranspose(m_mainScene->GetPointLight(0)->GetProjectionMatrix()),
                 .IsVoxel = FALSE
             };
 
@@ -907,32 +1126,32 @@ namespace library
 
             m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
 
-            for (UINT i = 0; i < renderable.second->GetNumMeshes(); ++i)
+            for (UINT i = 0; i < renderable->GetNumMeshes(); ++i)
             {
-                m_immediateContext->DrawIndexed(renderable.second->GetMesh(i).uNumIndices, renderable.second->GetMesh(i).uBaseIndex, static_cast<INT>(renderable.second->GetMesh(i).uBaseVertex));
+                m_immediateContext->DrawIndexed(renderable->GetMesh(i).uNumIndices, renderable->GetMesh(i).uBaseIndex, static_cast<INT>(renderable->GetMesh(i).uBaseVertex));
             }
         }
 
-        for (auto model : m_scenes[m_pszMainSceneName]->GetModels())
+        for (auto model : m_mainScene->GetModels())
         {
             // Set the vertex buffer
-            UINT stride0 = sizeof(SimpleVertex);
+            UINT stride0 = model->HasPackedVertices() ? sizeof(PackedVertex) : sizeof(SimpleVertex);
             UINT offset0 = 0;
 
-            m_immediateContext->IASetVertexBuffers(0u, 1u,model.second->GetVertexBuffer().GetAddressOf(), &stride0, &offset0);
+            m_immediateContext->IASetVertexBuffers(0u, 1u,model->GetVertexBuffer().GetAddressOf(), &stride0, &offset0);
 
             // Set the index buffer
-            m_immediateContext->IASetIndexBuffer(model.second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+            m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
 
             // Set the input layout
-            m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout().Get());
+            m_immediateContext->IASetInputLayout(m_shadowVertexShader->GetVertexLayout(model->GetPermutation()).Get());
 
-            // Shadow constant buffer
+            // Shadow constant buffer, the decode of packed positions is folded into the world matrix
             CBShadowMatrix cbShadowMatrix =
             {
-                .World = XMMatrixTranspose(model.second->GetWorldMatrix()),
-                .View = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0)->GetViewMatrix()),
-                .Projection = XMMatrixTranspose(m_scenes[m_pszMainSceneName]->GetPointLight(0)->GetProjectionMatrix()),
+                .World = XMMatrixTranspose(model->GetPositionDecodeMatrix() * model->GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+                .View = XMMatrixTranspose(m_mainScene->GetPointLight(0)->GetViewMatrix()),
+                .Projection = XMMatrixTranspose(m_mainScene->GetPointLight(0)->GetProjectionMatrix()),
                 .IsVoxel = FALSE
             };
 
@@ -940,9 +1159,9 @@ namespace library
 
             m_immediateContext->VSSetConstantBuffers(0u, 1u, m_cbShadowMatrix.GetAddressOf());
 
-            for (UINT i = 0; i < model.second->GetNumMeshes(); ++i)
+            for (UINT i = 0; i < model->GetNumMeshes(); ++i)
             {
-                m_immediateContext->DrawIndexed(model.second->GetMesh(i).uNumIndices, model.second->GetMesh(i).uBaseIndex, static_cast<INT>(model.second->GetMesh(i).uBaseVertex));
+                m_immediateContext->DrawIndexed(model->GetMesh(i).uNumIndices, model->GetMesh(i).uBaseIndex, static_cast<INT>(model->GetMesh(i).uBaseVertex));
             }
         }
 
@@ -959,4 +1178,296 @@ namespace library
     {
         return m_driverType;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetSkinningStats
+      Summary:  Returns the bone palette uploads of the skinned draws
+                so far
+      Returns:  SkinningStats
+                  Number of skinned draws and their uploaded bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SkinningStats Renderer::GetSkinningStats() const
+    {
+        return m_skinningStats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetTextureCache
+      Summary:  Returns the texture cache the models of the scenes load
+                their textures through. It lives as long as the
+                renderer, so no texture outlives the device
+      Returns:  const std::shared_ptr<TextureCache>&
+                  Texture cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<TextureCache>& Renderer::GetTextureCache() const
+    {
+        return m_textureCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::buildDrawLists
+      Summary:  Runs the frame tasks that prepare the draw lists of
+                every scene on the job system. Culling tests the
+                interpolated bounding spheres of the renderables against
+                the view frustum while the voxel occluders are
+                rasterized, then the survivors are tested against the
+                occluders and the draw list build fills the constants
+                of the visible ones. The bone palettes of the
+                models do not depend on culling and are built alongside.
+                Only the Direct3D calls are left to the submission on
+                the calling thread
+      Modifies: [m_occlusionCuller, m_aDrawLists].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::buildDrawLists()
+    {
+        PROFILE_ZONE("Renderer::buildDrawLists");
+
+        m_aDrawLists.resize(m_scenes.GetSize());
+
+        UINT uScene = 0u;
+        for (auto scene = m_scenes.begin(); scene != m_scenes.end(); ++scene, ++uScene)
+        {
+            DrawList& drawList = m_aDrawLists[uScene];
+
+            drawList.apRenderables.clear();
+            for (auto renderable = (*scene)->GetRenderables().begin(); renderable != (*scene)->GetRenderables().end(); ++renderable)
+            {
+                // Static renderables are drawn by their batches
+                if (!(*renderable)->IsStatic())
+                {
+                    drawList.apRenderables.push_back(renderable->get());
+                }
+            }
+            for (auto batch = (*scene)->GetStaticBatches().begin(); batch != (*scene)->GetStaticBatches().end(); ++batch)
+            {
+                drawList.apRenderables.push_back(batch->get());
+            }
+            drawList.aRenderableWorlds.resize(drawList.apRenderables.size());
+            drawList.abIsVisible.assign(drawList.apRenderables.size(), FALSE);
+            drawList.aRenderableConstants.resize(drawList.apRenderables.size());
+
+            drawList.apModels.clear();
+            for (auto model = (*scene)->GetModels().begin(); model != (*scene)->GetModels().end(); ++model)
+            {
+                drawList.apModels.push_back(model->get());
+            }
+            drawList.aModelConstants.resize(drawList.apModels.size());
+            drawList.aaModelMeshLods.resize(drawList.apModels.size());
+
+            // Bones of the previous models, so every palette knows where it starts
+            drawList.auModelBoneOffsets.resize(drawList.apModels.size() + 1u);
+            drawList.auModelBoneOffsets[0] = 0u;
+            for (UINT i = 0u; i < drawList.apModels.size(); ++i)
+            {
+                UINT uNumBones = drawList.apModels[i]->GetSkinningBuffer() ? static_cast<UINT>(drawList.apModels[i]->GetBoneTransforms().size()) : 0u;
+                drawList.auModelBoneOffsets[i + 1u] = drawList.auModelBoneOffsets[i] + uNumBones;
+            }
+            drawList.aBonePalettes.resize(drawList.auModelBoneOffsets.back());
+        }
+
+        BoundingFrustum viewFrustum;
+        BoundingFrustum::CreateFromMatrix(viewFrustum, m_projection);
+        viewFrustum.Transform(viewFrustum, XMMatrixInverse(nullptr, m_camera.GetView()));
+
+        // Every scene is drawn from the same camera, so their occluders hide each other's objects
+        m_occlusionCuller->BeginFrame(m_camera.GetView() * m_projection);
+        for (auto scene = m_scenes.begin(); scene != m_scenes.end(); ++scene)
+        {
+            m_occlusionCuller->AddOccluders((*scene)->GetOccluders());
+        }
+
+        JobSystem& jobSystem = JobSystem::GetDefault();
+        TaskGraph frameGraph;
+
+        uint32_t uOcclusionRaster = frameGraph.AddTask("OcclusionRaster", [&]()
+        {
+            m_occlusionCuller->Rasterize();
+        });
+
+        uint32_t uCulling = frameGraph.AddTask("Culling", [&]()
+        {
+            for (DrawList& drawList : m_aDrawLists)
+            {
+                jobSystem.ParallelFor(static_cast<uint32_t>(drawList.apRenderables.size()), DRAW_LIST_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+                {
+                    for (uint32_t i = uBegin; i < uEnd; ++i)
+                    {
+                        drawList.aRenderableWorlds[i] = drawList.apRenderables[i]->GetInterpolatedWorldMatrix(m_interpolationAlpha);
+
+                        BoundingSphere worldSphere;
+                        drawList.apRenderables[i]->GetBoundingSphere().Transform(worldSphere, drawList.aRenderableWorlds[i]);
+                        drawList.abIsVisible[i] = viewFrustum.Intersects(worldSphere) ? TRUE : FALSE;
+                    }
+                });
+            }
+        });
+
+        uint32_t uOcclusionTest = frameGraph.AddTask("OcclusionTest", [&]()
+        {
+            if (m_occlusionCuller->GetNumOccluders() == 0u)
+            {
+                return;
+            }
+
+            for (DrawList& drawList : m_aDrawLists)
+            {
+                jobSystem.ParallelFor(static_cast<uint32_t>(drawList.apRenderables.size()), DRAW_LIST_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+                {
+                    for (uint32_t i = uBegin; i < uEnd; ++i)
+                    {
+                        if (!drawList.abIsVisible[i])
+                        {
+                            continue;
+                        }
+
+                        BoundingSphere worldSphere;
+                        drawList.apRenderables[i]->GetBoundingSphere().Transform(worldSphere, drawList.aRenderableWorlds[i]);
+
+                        AxisAlignedBox worldBox =
+                        {
+                            .Center = worldSphere.Center,
+                            .Extents = XMFLOAT3(worldSphere.Radius, worldSphere.Radius, worldSphere.Radius)
+                        };
+                        drawList.abIsVisible[i] = m_occlusionCuller->IsVisible(worldBox) ? TRUE : FALSE;
+                    }
+                });
+            }
+        }, { uCulling, uOcclusionRaster });
+
+        frameGraph.AddTask("DrawListBuild", [&]()
+        {
+            for (DrawList& drawList : m_aDrawLists)
+            {
+                jobSystem.ParallelFor(static_cast<uint32_t>(drawList.apRenderables.size()), DRAW_LIST_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+                {
+                    for (uint32_t i = uBegin; i < uEnd; ++i)
+                    {
+                        if (!drawList.abIsVisible[i])
+                        {
+                            continue;
+                        }
+
+                        drawList.aRenderableConstants[i] =
+                        {
+                            .World = XMMatrixTranspose(drawList.aRenderableWorlds[i]),
+                            .OutputColor = drawList.apRenderables[i]->GetOutputColor(),
+                            .HasNormalMap = drawList.apRenderables[i]->HasNormalMap()
+                        };
+                    }
+                });
+            }
+        }, { uOcclusionTest });
+
+        frameGraph.AddTask("SkinningBuild", [&]()
+        {
+            for (DrawList& drawList : m_aDrawLists)
+            {
+                jobSystem.ParallelFor(static_cast<uint32_t>(drawList.apModels.size()), 1u, [&](uint32_t uBegin, uint32_t uEnd)
+                {
+                    for (uint32_t i = uBegin; i < uEnd; ++i)
+                    {
+                        Model* model = drawList.apModels[i];
+
+                        drawList.aModelConstants[i] =
+                        {
+                            .World = XMMatrixTranspose(model->GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+                            .OutputColor = model->GetOutputColor(),
+                            .HasNormalMap = model->HasNormalMap(),
+                            .PositionScale = model->GetPositionScale(),
+                            .PositionOffset = model->GetPositionOffset()
+                        };
+
+                        BoneTransform3x4* aBonePalette = &drawList.aBonePalettes[drawList.auModelBoneOffsets[i]];
+                        UINT uNumBones = drawList.auModelBoneOffsets[i + 1u] - drawList.auModelBoneOffsets[i];
+                        for (UINT uBone = 0u; uBone < uNumBones; ++uBone)
+                        {
+                            BonePalette::StoreTransposed3x4(model->GetInterpolatedBoneTransform(uBone, m_interpolationAlpha), aBonePalette[uBone]);
+                        }
+                    }
+                });
+            }
+        });
+
+        frameGraph.AddTask("LodSelection", [&]()
+        {
+            for (DrawList& drawList : m_aDrawLists)
+            {
+                jobSystem.ParallelFor(static_cast<uint32_t>(drawList.apModels.size()), 1u, [&](uint32_t uBegin, uint32_t uEnd)
+                {
+                    for (uint32_t i = uBegin; i < uEnd; ++i)
+                    {
+                        Model* model = drawList.apModels[i];
+                        XMMATRIX world = model->GetInterpolatedWorldMatrix(m_interpolationAlpha);
+
+                        BoundingSphere worldSphere;
+                        model->GetBoundingSphere().Transform(worldSphere, world);
+
+                        // The error is in model units, so it grows with the largest scale of the world matrix
+                        FLOAT scale = (std::max)(
+                            XMVectorGetX(XMVector3Length(world.r[0])),
+                            (std::max)(XMVectorGetX(XMVector3Length(world.r[1])), XMVectorGetX(XMVector3Length(world.r[2])))
+                        );
+                        FLOAT distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&worldSphere.Center) - m_camera.GetEye())) - worldSphere.Radius;
+                        FLOAT pixelsPerUnit = 0.5f * m_projectedSizeScale * scale / (std::max)(distance, NEAR_PLANE);
+
+                        std::vector<UINT>& auMeshLods = drawList.aaModelMeshLods[i];
+                        auMeshLods.resize(model->GetNumMeshes());
+                        for (UINT uMesh = 0u; uMesh < model->GetNumMeshes(); ++uMesh)
+                        {
+                            auMeshLods[uMesh] = model->SelectLod(uMesh, pixelsPerUnit);
+                        }
+                    }
+                });
+            }
+        });
+
+        frameGraph.Run(jobSystem);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::reportTextureUsage
+      Summary:  Estimates the on-screen size of the renderable from its
+                bounding sphere and reports it to the textures of its
+                materials, so that streamed textures load only the mip
+                levels they need
+      Args:     const Renderable& renderable
+                  Renderable about to be drawn
+                FXMMATRIX world
+                  Interpolated world matrix the renderable is drawn with
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::reportTextureUsage(_In_ const Renderable& renderable, _In_ FXMMATRIX world)
+    {
+        BoundingSphere worldSphere;
+        renderable.GetBoundingSphere().Transform(worldSphere, world);
+
+        FLOAT distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&worldSphere.Center) - m_camera.GetEye()));
+
+        FLOAT projectedSize = m_projectedSizeScale;
+        if (distance > worldSphere.Radius)
+        {
+            projectedSize = worldSphere.Radius * m_projectedSizeScale / distance;
+        }
+
+        for (UINT i = 0u; i < renderable.GetNumMaterials(); ++i)
+        {
+            const std::shared_ptr<Material>& material = renderable.GetMaterial(i);
+            if (!material)
+            {
+                continue;
+            }
+
+            if (material->pDiffuse)
+            {
+                material->pDiffuse->ReportProjectedSize(projectedSize);
+            }
+            if (material->pSpecularExponent)
+            {
+                material->pSpecularExponent->ReportProjectedSize(projectedSize);
+            }
+            if (material->pNormal)
+            {
+                material->pNormal->ReportProjectedSize(projectedSize);
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
   Summary:   Renderer header file contains declarations of Renderer
              class used for the lab samples of Game Graphics
              Programming course.
-  Classes: Renderer
+  Classes: SkinningStats, Renderer
   2022 Kyung Hee University
 ===================================================================+*/
 #pragma once
@@ -14,6 +14,9 @@
 #include "Light/PointLight.h"
 #include "Model/Model.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/GpuProfiler.h"
+#include "Renderer/HotReloader.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/Renderable.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
@@ -21,10 +24,25 @@
 #include "Window/MainWindow.h"
 #include "Texture/RenderTexture.h"
 #include "Shader/ShadowVertexShader.h"
+#include "Utility/StringId.h"
+#include "Utility/TaskGraph.h"
 
 namespace library
 {
 
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SkinningStats
+      Summary:  Bone palette uploads of the skinned draws, next to what
+                a full MAX_NUM_BONES palette of 4x4 matrices would have
+                cost them
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SkinningStats
+    {
+        uint64_t uNumSkinnedDraws;
+        uint64_t uUploadedBytes;
+        uint64_t uFullPaletteBytes;
+    };
+
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    Renderer
       Summary:  Renderer initializes Direct3D, and renders renderable
@@ -34,11 +52,17 @@ namespace library
                 AddRenderable
                   Add a renderable object and initialize the object
                 Update
-                  Update the renderables each frame
+                  Update the camera each frame
+                Tick
+                  Update the renderables each simulation tick
                 Render
                   Renders the frame
                 GetDriverType
                   Returns the Direct3D driver type
+                GetSkinningStats
+                  Returns the bone palette uploads so far
+                GetTextureCache
+                  Returns the texture cache of the scenes
                 Renderer
                   Constructor.
                 ~Renderer
@@ -63,13 +87,47 @@ namespace library
 
         void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
         void Update(_In_ FLOAT deltaTime);
-        void Render();
+        void Tick(_In_ FLOAT tickTime);
+        void Render(_In_ FLOAT alpha);
         void RenderSceneToTexture();
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        SkinningStats GetSkinningStats() const;
+        const std::shared_ptr<TextureCache>& GetTextureCache() const;
 
         std::shared_ptr<MainWindow> WindowPtr;
 
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   DrawList
+          Summary:  Objects of a scene and the constants to draw them
+                    with, filled by the frame tasks before submission.
+                    The bone palettes of all models share one array,
+                    model i owning the bones from auModelBoneOffsets[i]
+                    to auModelBoneOffsets[i + 1].
+                    Models are not culled since their bounding sphere
+                    only covers the bind pose, but it is close enough
+                    to pick the level of detail of each mesh
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct DrawList
+        {
+            std::vector<Renderable*> apRenderables;
+            std::vector<XMMATRIX> aRenderableWorlds;
+            std::vector<BOOL> abIsVisible;
+            std::vector<CBChangesEveryFrame> aRenderableConstants;
+            std::vector<Model*> apModels;
+            std::vector<CBChangesEveryFrame> aModelConstants;
+            std::vector<UINT> auModelBoneOffsets;
+            std::vector<BoneTransform3x4> aBonePalettes;
+            std::vector<std::vector<UINT>> aaModelMeshLods;
+        };
+
+        static constexpr const UINT DRAW_LIST_GRAIN_SIZE = 64u;
+        static constexpr const FLOAT PICK_DISTANCE = 64.0f;
+
+    private:
+        void buildDrawLists();
+        void reportTextureUsage(_In_ const Renderable& renderable, _In_ FXMMATRIX world);
 
     private:
         D3D_DRIVER_TYPE m_driverType;
@@ -86,21 +144,25 @@ namespace library
         ComPtr<ID3D11Buffer> m_cbChangeOnResize;
         ComPtr<ID3D11Buffer> m_cbLights;
         ComPtr<ID3D11Buffer> m_cbShadowMatrix;
-        PCWSTR m_pszMainSceneName;
+        StringId m_mainSceneName;
         BYTE m_padding[8];
         Camera m_camera;
         XMMATRIX m_projection;
+        FLOAT m_projectedSizeScale;
+        FLOAT m_interpolationAlpha;
 
-        std::unordered_map<PCWSTR, std::shared_ptr<Renderable>> m_renderables;
-        std::unordered_map<PCWSTR, std::shared_ptr<Model>> m_models;
-        std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
-        std::unordered_map<PCWSTR, std::shared_ptr<VertexShader>> m_vertexShaders;
-        std::unordered_map<PCWSTR, std::shared_ptr<PixelShader>> m_pixelShaders;
-        std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
+        ResourceTable<std::shared_ptr<Scene>> m_scenes;
+        std::shared_ptr<Scene> m_mainScene;
         std::shared_ptr<Texture> m_invalidTexture;
+        std::shared_ptr<TextureCache> m_textureCache;
         std::shared_ptr<RenderTexture> m_shadowMapTexture;
         std::shared_ptr<ShadowVertexShader> m_shadowVertexShader;
         std::shared_ptr<PixelShader> m_shadowPixelShader;
+        std::shared_ptr<HotReloader> m_hotReloader;
+        std::shared_ptr<GpuProfiler> m_gpuProfiler;
+        std::shared_ptr<OcclusionCuller> m_occlusionCuller;
+        std::vector<DrawList> m_aDrawLists;
+        SkinningStats m_skinningStats;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,923 @@
+#include "Renderer/SoftwareRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Utility/JobSystem.h"
+#include "Utility/Profiler.h"
+
+namespace library
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        // Each clipping plane adds at most one corner to a triangle
+        constexpr const uint32_t NUM_CLIP_PLANES = 6u;
+        constexpr const uint32_t MAX_CLIPPED_CORNERS = 3u + NUM_CLIP_PLANES;
+
+        // Clipping to GUARD_BAND times the viewport keeps the subpixel coordinates below 2^24
+        constexpr const float GUARD_BAND = 4.0f;
+        constexpr const int64_t SUBPIXEL_SCALE = 256;
+
+        constexpr const float SPECULAR_POWER = 40.0f;
+        constexpr const float AMBIENT = 0.1f;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Edge
+          Summary:  Edge function of a screen triangle in subpixels.
+                    The integer math is exact, so two triangles sharing
+                    an edge evaluate it to opposite values and no pixel
+                    is covered twice or missed, and stepping one pixel
+                    to the right always adds iStepX. iBias is -1 for
+                    the edges the top-left rule leaves out, so a pixel
+                    is inside when all three values are not negative
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Edge
+        {
+            int64_t iX;
+            int64_t iY;
+            int64_t iDeltaX;
+            int64_t iDeltaY;
+            int64_t iStepX;
+            int64_t iBias;
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: toSubpixels
+          Summary:  Converts a pixel coordinate snapped to the subpixel
+                    grid, which converts exactly
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        int64_t toSubpixels(float coordinate)
+        {
+            return static_cast<int64_t>(coordinate * static_cast<float>(SUBPIXEL_SCALE));
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: makeEdge
+          Summary:  Sets up the edge from a to b of a triangle whose
+                    corners go clockwise on the screen
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        Edge makeEdge(const XMFLOAT4& a, const XMFLOAT4& b)
+        {
+            Edge edge;
+            edge.iX = toSubpixels(a.x);
+            edge.iY = toSubpixels(a.y);
+            edge.iDeltaX = toSubpixels(b.x) - edge.iX;
+            edge.iDeltaY = toSubpixels(b.y) - edge.iY;
+            edge.iStepX = -edge.iDeltaY * SUBPIXEL_SCALE;
+
+            // Clockwise with y going down: top edges go right, left edges go up
+            bool bIsTopLeft = (edge.iDeltaY == 0 && edge.iDeltaX > 0) || edge.iDeltaY < 0;
+            edge.iBias = bIsTopLeft ? 0 : -1;
+
+            return edge;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: evaluateEdge
+          Summary:  Twice the area of the triangle made of the edge and
+                    a point in subpixels, positive on the inner side
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        int64_t evaluateEdge(const Edge& edge, int64_t iX, int64_t iY)
+        {
+            return edge.iDeltaX * (iY - edge.iY) - edge.iDeltaY * (iX - edge.iX) + edge.iBias;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getClipDistance
+          Summary:  Signed distance of a clip space position to one of
+                    the planes triangles are clipped against: near,
+                    far, then the four sides of the guard band
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        float getClipDistance(const XMFLOAT4& clip, uint32_t uPlane)
+        {
+            switch (uPlane)
+            {
+            case 0u:
+                return clip.z;
+            case 1u:
+                return clip.w - clip.z;
+            case 2u:
+                return GUARD_BAND * clip.w + clip.x;
+            case 3u:
+                return GUARD_BAND * clip.w - clip.x;
+            case 4u:
+                return GUARD_BAND * clip.w + clip.y;
+            default:
+                return GUARD_BAND * clip.w - clip.y;
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: fetchTexel
+          Summary:  Reads a texel with wrapped coordinates
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        XMVECTOR fetchTexel(const Image& image, int32_t x, int32_t y)
+        {
+            int32_t iWidth = static_cast<int32_t>(image.uWidth);
+            int32_t iHeight = static_cast<int32_t>(image.uHeight);
+            x = ((x % iWidth) + iWidth) % iWidth;
+            y = ((y % iHeight) + iHeight) % iHeight;
+
+            const uint8_t* pTexel = &image.aPixels[(static_cast<size_t>(y) * image.uWidth + static_cast<size_t>(x)) * 4u];
+
+            return XMVectorScale(XMVectorSet(pTexel[0], pTexel[1], pTexel[2], pTexel[3]), 1.0f / 255.0f);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: sampleBilinear
+          Summary:  Samples the top mip of an image with the linear
+                    filter and wrapped addressing of the trilinear wrap
+                    sampler. Empty images read white
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        XMVECTOR sampleBilinear(const Image& image, const XMFLOAT2& texCoord)
+        {
+            if (image.uWidth == 0u || image.uHeight == 0u)
+            {
+                return XMVectorSplatOne();
+            }
+
+            float x = texCoord.x * static_cast<float>(image.uWidth) - 0.5f;
+            float y = texCoord.y * static_cast<float>(image.uHeight) - 0.5f;
+            float left = std::floor(x);
+            float top = std::floor(y);
+            float fractionX = x - left;
+            float fractionY = y - top;
+            int32_t iX = static_cast<int32_t>(left);
+            int32_t iY = static_cast<int32_t>(top);
+
+            XMVECTOR topRow = XMVectorLerp(fetchTexel(image, iX, iY), fetchTexel(image, iX + 1, iY), fractionX);
+            XMVECTOR bottomRow = XMVectorLerp(fetchTexel(image, iX, iY + 1), fetchTexel(image, iX + 1, iY + 1), fractionX);
+
+            return XMVectorLerp(topRow, bottomRow, fractionY);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: toPixelRange
+          Summary:  Returns the first and last pixels whose centers lie
+                    between two coordinates, clamped to the frame.
+                    Empty when the first is after the last
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void toPixelRange(float minimum, float maximum, uint32_t uSize, int32_t& iFirst, int32_t& iLast)
+        {
+            iFirst = static_cast<int32_t>(std::clamp(std::ceil(minimum - 0.5f), 0.0f, static_cast<float>(uSize)));
+            iLast = static_cast<int32_t>(std::clamp(std::floor(maximum - 0.5f), -1.0f, static_cast<float>(uSize) - 1.0f));
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: skin
+          Summary:  Blends the bone transforms of a vertex and applies
+                    them to a point or a direction, as in VSSkinning
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        XMVECTOR skin(const XMVECTOR* aSkinRows, FXMVECTOR vector)
+        {
+            return XMVectorSet(
+                XMVectorGetX(XMVector4Dot(aSkinRows[0], vector)),
+                XMVectorGetX(XMVector4Dot(aSkinRows[1], vector)),
+                XMVectorGetX(XMVector4Dot(aSkinRows[2], vector)),
+                XMVectorGetW(vector)
+            );
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::SoftwareRenderer
+      Summary:  Constructor
+      Args:     uint32_t uWidth
+                  Width of the frame
+                uint32_t uHeight
+                  Height of the frame
+      Modifies: [m_uWidth, m_uHeight, m_uNumTilesX, m_uNumTilesY,
+                 m_viewProjection, m_cameraPosition, m_clearColor,
+                 m_lights, m_aDraws, m_aBatches, m_aShadedVertices,
+                 m_aBins, m_frame, m_aDepth, m_uNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SoftwareRenderer::SoftwareRenderer(uint32_t uWidth, uint32_t uHeight)
+        : m_uWidth(uWidth)
+        , m_uHeight(uHeight)
+        , m_uNumTilesX((uWidth + TILE_SIZE - 1u) / TILE_SIZE)
+        , m_uNumTilesY((uHeight + TILE_SIZE - 1u) / TILE_SIZE)
+        , m_viewProjection(XMMatrixIdentity())
+        , m_cameraPosition(0.0f, 0.0f, 0.0f, 1.0f)
+        , m_clearColor(0.0f, 0.0f, 0.0f, 1.0f)
+        , m_lights()
+        , m_aDraws()
+        , m_aBatches()
+        , m_aShadedVertices()
+        , m_aBins()
+        , m_frame{ .uWidth = uWidth, .uHeight = uHeight, .aPixels = std::vector<uint8_t>(static_cast<size_t>(uWidth) * uHeight * 4u, 0u) }
+        , m_aDepth(static_cast<size_t>(uWidth) * uHeight, 1.0f)
+        , m_uNumTriangles(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::BeginFrame
+      Summary:  Forgets the draws of the last frame and sets the color
+                the next one is cleared to when it is rendered
+      Args:     const XMFLOAT4& clearColor
+                  Background color
+      Modifies: [m_clearColor, m_aDraws].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::BeginFrame(const XMFLOAT4& clearColor)
+    {
+        m_clearColor = clearColor;
+        m_aDraws.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::SetCamera
+      Summary:  Sets the camera from the constant buffers the Direct3D
+                path uploads, whose matrices are transposed
+      Args:     const CBChangeOnCameraMovement& cbCamera
+                  View matrix and position of the camera
+                const CBChangeOnResize& cbResize
+                  Projection matrix
+      Modifies: [m_viewProjection, m_cameraPosition].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::SetCamera(const CBChangeOnCameraMovement& cbCamera, const CBChangeOnResize& cbResize)
+    {
+        m_viewProjection = XMMatrixTranspose(cbCamera.View) * XMMatrixTranspose(cbResize.Projection);
+        m_cameraPosition = cbCamera.CameraPosition;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::SetLights
+      Summary:  Sets the point lights the draws are shaded with
+      Args:     const CBLights& cbLights
+                  Position, color and attenuation of the lights
+      Modifies: [m_lights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::SetLights(const CBLights& cbLights)
+    {
+        m_lights = cbLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::Draw
+      Summary:  Adds a draw to the frame. Draws are rasterized in the
+                order they were added
+      Args:     const DrawCommand& draw
+                  Mesh, constants and textures of the draw
+      Modifies: [m_aDraws].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::Draw(const DrawCommand& draw)
+    {
+        m_aDraws.push_back(draw);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::Render
+      Summary:  Lays the instances of the draws out one after another,
+                then runs the vertex, triangle setup and tile stages
+                on the job system, each stage waiting for the last
+      Modifies: [m_aBatches, m_aShadedVertices, m_aBins, m_frame,
+                 m_aDepth, m_uNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::Render()
+    {
+        PROFILE_ZONE("SoftwareRenderer::Render");
+
+        JobSystem& jobSystem = JobSystem::GetDefault();
+
+        uint32_t uNumVertices = 0u;
+        uint32_t uNumTriangles = 0u;
+        m_aBatches.clear();
+        for (uint32_t uDraw = 0u; uDraw < m_aDraws.size(); ++uDraw)
+        {
+            const DrawCommand& draw = m_aDraws[uDraw];
+            uint32_t uNumInstances = draw.aInstanceData ? draw.uNumInstances : 1u;
+            for (uint32_t uInstance = 0u; uInstance < uNumInstances; ++uInstance)
+            {
+                m_aBatches.push_back(Batch{ uDraw, uInstance, uNumVertices, uNumTriangles });
+                uNumVertices += draw.uNumVertices;
+                uNumTriangles += draw.uNumIndices / 3u;
+            }
+        }
+
+        m_aShadedVertices.resize(uNumVertices);
+        jobSystem.ParallelFor(uNumVertices, VERTEX_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            shadeVertices(uBegin, uEnd);
+        });
+
+        m_aBins.resize((uNumTriangles + TRIANGLE_GRAIN_SIZE - 1u) / TRIANGLE_GRAIN_SIZE);
+        jobSystem.ParallelFor(static_cast<uint32_t>(m_aBins.size()), 1u, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t uBins = uBegin; uBins < uEnd; ++uBins)
+            {
+                setupTriangles(uBins);
+            }
+        });
+
+        m_uNumTriangles = 0u;
+        for (const TriangleBins& bins : m_aBins)
+        {
+            m_uNumTriangles += static_cast<uint32_t>(bins.aTriangles.size());
+        }
+
+        jobSystem.ParallelFor(m_uNumTilesX * m_uNumTilesY, 1u, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t uTile = uBegin; uTile < uEnd; ++uTile)
+            {
+                rasterizeTile(uTile);
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetFrame
+      Summary:  Returns the pixels of the last rendered frame
+      Returns:  const Image&
+                  RGBA8 pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Image& SoftwareRenderer::GetFrame() const
+    {
+        return m_frame;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetDepth
+      Summary:  Returns the depth of a pixel of the last rendered frame
+      Args:     uint32_t uX
+                  Column of the pixel
+                uint32_t uY
+                  Row of the pixel
+      Returns:  float
+                  Depth between 0 and 1, 1 where nothing was drawn
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float SoftwareRenderer::GetDepth(uint32_t uX, uint32_t uY) const
+    {
+        return m_aDepth[static_cast<size_t>(uY) * m_uWidth + uX];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetNumTriangles
+      Summary:  Returns the number of triangles left to rasterize in
+                the last frame after clipping and back face culling
+      Returns:  uint32_t
+                  Number of triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t SoftwareRenderer::GetNumTriangles() const
+    {
+        return m_uNumTriangles;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadeVertices
+      Summary:  Runs the vertex stage of VSPhong and VSVoxel on a range
+                of the vertices of the frame: packed streams are
+                decoded first, then the bone transforms, the instance
+                transform, the world matrix and the camera are applied
+      Args:     uint32_t uBegin
+                  First vertex
+                uint32_t uEnd
+                  Vertex after the last
+      Modifies: [m_aShadedVertices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::shadeVertices(uint32_t uBegin, uint32_t uEnd)
+    {
+        auto batch = std::upper_bound(m_aBatches.begin(), m_aBatches.end(), uBegin, [](uint32_t uVertex, const Batch& candidate)
+        {
+            return uVertex < candidate.uFirstVertex;
+        }) - 1;
+
+        XMMATRIX world = XMMatrixTranspose(m_aDraws[batch->uDraw].Constants.World);
+        for (uint32_t uVertex = uBegin; uVertex < uEnd; ++uVertex)
+        {
+            bool bIsNewBatch = false;
+            while (batch + 1 != m_aBatches.end() && uVertex >= (batch + 1)->uFirstVertex)
+            {
+                ++batch;
+                bIsNewBatch = true;
+            }
+
+            if (bIsNewBatch)
+            {
+                world = XMMatrixTranspose(m_aDraws[batch->uDraw].Constants.World);
+            }
+
+            const DrawCommand& draw = m_aDraws[batch->uDraw];
+            const uint32_t uIndex = uVertex - batch->uFirstVertex;
+            const bool bIsPacked = draw.aPackedVertices != nullptr;
+            const SimpleVertex vertex = bIsPacked ? VertexCompression::UnpackVertex(draw.aPackedVertices[uIndex], draw.Constants.PositionScale, draw.Constants.PositionOffset) : draw.aVertices[uIndex];
+            const bool bHasNormalMap = draw.pNormalMap && (bIsPacked ? draw.aPackedNormalData != nullptr : draw.aNormalData != nullptr);
+
+            XMVECTOR position = XMVectorSetW(XMLoadFloat3(&vertex.Position), 1.0f);
+            XMVECTOR normal = XMLoadFloat3(&vertex.Normal);
+            XMVECTOR tangent = XMVectorZero();
+            XMVECTOR bitangent = XMVectorZero();
+            if (bHasNormalMap)
+            {
+                const NormalData normalData = bIsPacked ? VertexCompression::UnpackNormalData(vertex.Normal, draw.aPackedNormalData[uIndex]) : draw.aNormalData[uIndex];
+                tangent = XMLoadFloat3(&normalData.Tangent);
+                bitangent = XMLoadFloat3(&normalData.Bitangent);
+            }
+
+            if ((bIsPacked ? draw.aPackedAnimationData != nullptr : draw.aAnimationData != nullptr) && draw.aBoneTransforms)
+            {
+                const AnimationData animationData = bIsPacked ? VertexCompression::UnpackAnimationData(draw.aPackedAnimationData[uIndex]) : draw.aAnimationData[uIndex];
+                const uint32_t auBoneIndices[MAX_NUM_BONES_PER_VERTEX] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+                const float aBoneWeights[MAX_NUM_BONES_PER_VERTEX] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+
+                XMVECTOR aSkinRows[3] = { XMVectorZero(), XMVectorZero(), XMVectorZero() };
+                for (uint32_t i = 0u; i < MAX_NUM_BONES_PER_VERTEX; ++i)
+                {
+                    if (aBoneWeights[i] == 0.0f || auBoneIndices[i] >= draw.uNumBones)
+                    {
+                        continue;
+                    }
+
+                    const BoneTransform3x4& bone = draw.aBoneTransforms[auBoneIndices[i]];
+                    for (uint32_t uRow = 0u; uRow < 3u; ++uRow)
+                    {
+                        aSkinRows[uRow] = XMVectorMultiplyAdd(XMVectorReplicate(aBoneWeights[i]), XMLoadFloat4(&bone.Rows[uRow]), aSkinRows[uRow]);
+                    }
+                }
+
+                position = skin(aSkinRows, position);
+                normal = skin(aSkinRows, normal);
+                tangent = skin(aSkinRows, tangent);
+                bitangent = skin(aSkinRows, bitangent);
+            }
+
+            if (draw.aInstanceData)
+            {
+                position = XMVector4Transform(position, draw.aInstanceData[batch->uInstance].Transformation);
+            }
+
+            XMVECTOR worldPosition = XMVector4Transform(position, world);
+
+            ShadedVertex& shadedVertex = m_aShadedVertices[uVertex];
+            XMStoreFloat4(&shadedVertex.ClipPosition, XMVector4Transform(worldPosition, m_viewProjection));
+            XMStoreFloat3(&shadedVertex.WorldPosition, worldPosition);
+            XMStoreFloat3(&shadedVertex.Normal, XMVector3Normalize(XMVector3TransformNormal(normal, world)));
+            XMStoreFloat3(&shadedVertex.Tangent, XMVector3Normalize(XMVector3TransformNormal(tangent, world)));
+            XMStoreFloat3(&shadedVertex.Bitangent, XMVector3Normalize(XMVector3TransformNormal(bitangent, world)));
+            shadedVertex.TexCoord = vertex.TexCoord;
+            shadedVertex.AmbientOcclusion = draw.aAmbientOcclusion ? static_cast<float>(draw.aAmbientOcclusion[uIndex]) / 255.0f : 1.0f;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::setupTriangles
+      Summary:  Clips a range of TRIANGLE_GRAIN_SIZE triangles against
+                the near and far planes and the guard band, projects
+                them to the subpixel grid, drops the back faces, and
+                sorts what is left by the tiles it touches
+      Args:     uint32_t uBins
+                  Index of the range, and of the bins it fills
+      Modifies: [m_aBins].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::setupTriangles(uint32_t uBins)
+    {
+        TriangleBins& bins = m_aBins[uBins];
+        bins.aTriangles.clear();
+
+        const uint32_t uNumTriangles = m_aBatches.empty() ? 0u : m_aBatches.back().uFirstTriangle + m_aDraws[m_aBatches.back().uDraw].uNumIndices / 3u;
+        const uint32_t uBegin = uBins * TRIANGLE_GRAIN_SIZE;
+        const uint32_t uEnd = (std::min)(uBegin + TRIANGLE_GRAIN_SIZE, uNumTriangles);
+
+        auto batch = std::upper_bound(m_aBatches.begin(), m_aBatches.end(), uBegin, [](uint32_t uTriangle, const Batch& candidate)
+        {
+            return uTriangle < candidate.uFirstTriangle;
+        }) - 1;
+
+        for (uint32_t uTriangle = uBegin; uTriangle < uEnd; ++uTriangle)
+        {
+            while (batch + 1 != m_aBatches.end() && uTriangle >= (batch + 1)->uFirstTriangle)
+            {
+                ++batch;
+            }
+
+            const DrawCommand& draw = m_aDraws[batch->uDraw];
+            const uint16_t* aIndices = &draw.aIndices[(uTriangle - batch->uFirstTriangle) * 3u];
+            if (aIndices[0] >= draw.uNumVertices || aIndices[1] >= draw.uNumVertices || aIndices[2] >= draw.uNumVertices)
+            {
+                continue;
+            }
+
+            ShadedVertex aPolygon[MAX_CLIPPED_CORNERS];
+            uint32_t uNumCorners = 3u;
+            for (uint32_t i = 0u; i < 3u; ++i)
+            {
+                aPolygon[i] = m_aShadedVertices[batch->uFirstVertex + aIndices[i]];
+            }
+
+            // Triangles entirely outside one side of the frustum
+            bool bIsOutside = false;
+            for (uint32_t uAxis = 0u; uAxis < 3u && !bIsOutside; ++uAxis)
+            {
+                bool bIsBelow = true;
+                bool bIsAbove = true;
+                for (uint32_t i = 0u; i < 3u; ++i)
+                {
+                    const XMFLOAT4& clip = aPolygon[i].ClipPosition;
+                    float coordinate = uAxis == 0u ? clip.x : (uAxis == 1u ? clip.y : clip.z);
+                    float lowest = uAxis == 2u ? 0.0f : -clip.w;
+                    bIsBelow = bIsBelow && coordinate < lowest;
+                    bIsAbove = bIsAbove && coordinate > clip.w;
+                }
+                bIsOutside = bIsBelow || bIsAbove;
+            }
+
+            if (bIsOutside)
+            {
+                continue;
+            }
+
+            // Sutherland-Hodgman, the sides of the viewport are left to the scissor
+            for (uint32_t uPlane = 0u; uPlane < NUM_CLIP_PLANES && uNumCorners >= 3u; ++uPlane)
+            {
+                bool bIsCut = false;
+                for (uint32_t i = 0u; i < uNumCorners; ++i)
+                {
+                    bIsCut = bIsCut || getClipDistance(aPolygon[i].ClipPosition, uPlane) < 0.0f;
+                }
+
+                if (!bIsCut)
+                {
+                    continue;
+                }
+
+                ShadedVertex aClipped[MAX_CLIPPED_CORNERS];
+                uint32_t uNumClipped = 0u;
+                for (uint32_t i = 0u; i < uNumCorners; ++i)
+                {
+                    const ShadedVertex& current = aPolygon[i];
+                    const ShadedVertex& next = aPolygon[(i + 1u) % uNumCorners];
+                    float currentDistance = getClipDistance(current.ClipPosition, uPlane);
+                    float nextDistance = getClipDistance(next.ClipPosition, uPlane);
+
+                    if (currentDistance >= 0.0f)
+                    {
+                        aClipped[uNumClipped++] = current;
+                    }
+
+                    if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+                    {
+                        aClipped[uNumClipped++] = lerpVertex(current, next, currentDistance / (currentDistance - nextDistance));
+                    }
+                }
+
+                std::copy(aClipped, aClipped + uNumClipped, aPolygon);
+                uNumCorners = uNumClipped;
+            }
+
+            XMFLOAT4 aScreen[MAX_CLIPPED_CORNERS];
+            for (uint32_t i = 0u; i < uNumCorners; ++i)
+            {
+                const XMFLOAT4& clip = aPolygon[i].ClipPosition;
+                float invW = 1.0f / clip.w;
+
+                // Snapped to the subpixel grid of the hardware
+                aScreen[i] = XMFLOAT4(
+                    std::round((clip.x * invW * 0.5f + 0.5f) * static_cast<float>(m_uWidth * SUBPIXEL_SCALE)) / static_cast<float>(SUBPIXEL_SCALE),
+                    std::round((0.5f - clip.y * invW * 0.5f) * static_cast<float>(m_uHeight * SUBPIXEL_SCALE)) / static_cast<float>(SUBPIXEL_SCALE),
+                    clip.z * invW,
+                    invW
+                );
+            }
+
+            for (uint32_t i = 1u; i + 1u < uNumCorners; ++i)
+            {
+                const uint32_t auCorners[3] = { 0u, i, i + 1u };
+                const XMFLOAT4& a = aScreen[auCorners[0]];
+                const XMFLOAT4& b = aScreen[auCorners[1]];
+                const XMFLOAT4& c = aScreen[auCorners[2]];
+
+                // Clockwise on the screen is front facing
+                float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+                if (!(area > 0.0f))
+                {
+                    continue;
+                }
+
+                ScreenTriangle triangle;
+                for (uint32_t uCorner = 0u; uCorner < 3u; ++uCorner)
+                {
+                    triangle.aScreen[uCorner] = aScreen[auCorners[uCorner]];
+                    triangle.aCorners[uCorner] = aPolygon[auCorners[uCorner]];
+                }
+                triangle.uDraw = batch->uDraw;
+
+                bins.aTriangles.push_back(triangle);
+            }
+        }
+
+        // Counting sort of the triangles by tile, stable so each tile keeps the submission order
+        const uint32_t uNumTiles = m_uNumTilesX * m_uNumTilesY;
+        auto forEachTile = [&](const ScreenTriangle& triangle, auto&& function)
+        {
+            const XMFLOAT4* v = triangle.aScreen;
+            int32_t iFirstX;
+            int32_t iLastX;
+            int32_t iFirstY;
+            int32_t iLastY;
+            toPixelRange((std::min)({ v[0].x, v[1].x, v[2].x }), (std::max)({ v[0].x, v[1].x, v[2].x }), m_uWidth, iFirstX, iLastX);
+            toPixelRange((std::min)({ v[0].y, v[1].y, v[2].y }), (std::max)({ v[0].y, v[1].y, v[2].y }), m_uHeight, iFirstY, iLastY);
+
+            for (int32_t iTileY = iFirstY / static_cast<int32_t>(TILE_SIZE); iFirstY <= iLastY && iTileY <= iLastY / static_cast<int32_t>(TILE_SIZE); ++iTileY)
+            {
+                for (int32_t iTileX = iFirstX / static_cast<int32_t>(TILE_SIZE); iFirstX <= iLastX && iTileX <= iLastX / static_cast<int32_t>(TILE_SIZE); ++iTileX)
+                {
+                    function(static_cast<uint32_t>(iTileY) * m_uNumTilesX + static_cast<uint32_t>(iTileX));
+                }
+            }
+        };
+
+        bins.auTileOffsets.assign(uNumTiles + 1u, 0u);
+        for (const ScreenTriangle& triangle : bins.aTriangles)
+        {
+            forEachTile(triangle, [&](uint32_t uTile)
+            {
+                ++bins.auTileOffsets[uTile + 1u];
+            });
+        }
+
+        for (uint32_t uTile = 0u; uTile < uNumTiles; ++uTile)
+        {
+            bins.auTileOffsets[uTile + 1u] += bins.auTileOffsets[uTile];
+        }
+
+        std::vector<uint32_t> auCursors(bins.auTileOffsets.begin(), bins.auTileOffsets.end() - 1);
+        bins.auTileTriangles.resize(bins.auTileOffsets.back());
+        for (uint32_t uTriangle = 0u; uTriangle < bins.aTriangles.size(); ++uTriangle)
+        {
+            forEachTile(bins.aTriangles[uTriangle], [&](uint32_t uTile)
+            {
+                bins.auTileTriangles[auCursors[uTile]++] = uTriangle;
+            });
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::rasterizeTile
+      Summary:  Clears a tile, then rasterizes the triangles binned to
+                it in submission order. Pixels failing the depth test
+                are not shaded
+      Args:     uint32_t uTile
+                  Index of the tile, row by row
+      Modifies: [m_frame, m_aDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::rasterizeTile(uint32_t uTile)
+    {
+        const int32_t iTileLeft = static_cast<int32_t>((uTile % m_uNumTilesX) * TILE_SIZE);
+        const int32_t iTileTop = static_cast<int32_t>((uTile / m_uNumTilesX) * TILE_SIZE);
+        const int32_t iTileRight = (std::min)(iTileLeft + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(m_uWidth)) - 1;
+        const int32_t iTileBottom = (std::min)(iTileTop + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(m_uHeight)) - 1;
+
+        XMFLOAT4 clearColor;
+        XMStoreFloat4(&clearColor, XMVectorAdd(XMVectorScale(XMVectorSaturate(XMLoadFloat4(&m_clearColor)), 255.0f), XMVectorReplicate(0.5f)));
+        for (int32_t y = iTileTop; y <= iTileBottom; ++y)
+        {
+            for (int32_t x = iTileLeft; x <= iTileRight; ++x)
+            {
+                size_t uPixel = static_cast<size_t>(y) * m_uWidth + static_cast<size_t>(x);
+                uint8_t* pPixel = &m_frame.aPixels[uPixel * 4u];
+                pPixel[0] = static_cast<uint8_t>(clearColor.x);
+                pPixel[1] = static_cast<uint8_t>(clearColor.y);
+                pPixel[2] = static_cast<uint8_t>(clearColor.z);
+                pPixel[3] = static_cast<uint8_t>(clearColor.w);
+                m_aDepth[uPixel] = 1.0f;
+            }
+        }
+
+        for (const TriangleBins& bins : m_aBins)
+        {
+            for (uint32_t uBinned = bins.auTileOffsets[uTile]; uBinned < bins.auTileOffsets[uTile + 1u]; ++uBinned)
+            {
+                const ScreenTriangle& triangle = bins.aTriangles[bins.auTileTriangles[uBinned]];
+                const DrawCommand& draw = m_aDraws[triangle.uDraw];
+                const XMFLOAT4* v = triangle.aScreen;
+
+                int32_t iFirstX;
+                int32_t iLastX;
+                int32_t iFirstY;
+                int32_t iLastY;
+                toPixelRange((std::min)({ v[0].x, v[1].x, v[2].x }), (std::max)({ v[0].x, v[1].x, v[2].x }), m_uWidth, iFirstX, iLastX);
+                toPixelRange((std::min)({ v[0].y, v[1].y, v[2].y }), (std::max)({ v[0].y, v[1].y, v[2].y }), m_uHeight, iFirstY, iLastY);
+                iFirstX = (std::max)(iFirstX, iTileLeft);
+                iLastX = (std::min)(iLastX, iTileRight);
+                iFirstY = (std::max)(iFirstY, iTileTop);
+                iLastY = (std::min)(iLastY, iTileBottom);
+
+                // Edge i is opposite to corner i, so its value weighs that corner
+                const Edge aEdges[3] = { makeEdge(v[1], v[2]), makeEdge(v[2], v[0]), makeEdge(v[0], v[1]) };
+
+                for (int32_t y = iFirstY; y <= iLastY; ++y)
+                {
+                    const int64_t iCenterX = iFirstX * SUBPIXEL_SCALE + SUBPIXEL_SCALE / 2;
+                    const int64_t iCenterY = y * SUBPIXEL_SCALE + SUBPIXEL_SCALE / 2;
+                    int64_t aiValues[3];
+                    for (uint32_t i = 0u; i < 3u; ++i)
+                    {
+                        aiValues[i] = evaluateEdge(aEdges[i], iCenterX, iCenterY);
+                    }
+
+                    for (int32_t x = iFirstX; x <= iLastX; ++x, aiValues[0] += aEdges[0].iStepX, aiValues[1] += aEdges[1].iStepX, aiValues[2] += aEdges[2].iStepX)
+                    {
+                        if ((aiValues[0] | aiValues[1] | aiValues[2]) < 0)
+                        {
+                            continue;
+                        }
+
+                        float aWeights[3];
+                        float sum = 0.0f;
+                        for (uint32_t i = 0u; i < 3u; ++i)
+                        {
+                            aWeights[i] = static_cast<float>(aiValues[i]);
+                            sum += aWeights[i];
+                        }
+
+                        // Only slivers thinner than the bias have nothing left
+                        if (!(sum > 0.0f))
+                        {
+                            continue;
+                        }
+
+                        for (uint32_t i = 0u; i < 3u; ++i)
+                        {
+                            aWeights[i] /= sum;
+                        }
+
+                        size_t uPixel = static_cast<size_t>(y) * m_uWidth + static_cast<size_t>(x);
+                        float depth = aWeights[0] * v[0].z + aWeights[1] * v[1].z + aWeights[2] * v[2].z;
+                        if (!(depth < m_aDepth[uPixel]))
+                        {
+                            continue;
+                        }
+
+                        m_aDepth[uPixel] = depth;
+
+                        // Perspective correct weights of the attributes
+                        float perspectiveSum = 0.0f;
+                        for (uint32_t i = 0u; i < 3u; ++i)
+                        {
+                            aWeights[i] *= v[i].w;
+                            perspectiveSum += aWeights[i];
+                        }
+
+                        for (uint32_t i = 0u; i < 3u; ++i)
+                        {
+                            aWeights[i] /= perspectiveSum;
+                        }
+
+                        ShadedVertex pixel = blendVertices(triangle.aCorners, aWeights);
+
+                        XMFLOAT4 color;
+                        XMStoreFloat4(&color, XMVectorAdd(XMVectorScale(XMVectorSaturate(shadePixel(draw, pixel)), 255.0f), XMVectorReplicate(0.5f)));
+
+                        uint8_t* pPixel = &m_frame.aPixels[uPixel * 4u];
+                        pPixel[0] = static_cast<uint8_t>(color.x);
+                        pPixel[1] = static_cast<uint8_t>(color.y);
+                        pPixel[2] = static_cast<uint8_t>(color.z);
+                        pPixel[3] = static_cast<uint8_t>(color.w);
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadePixel
+      Summary:  Shades a pixel like the pixel shader of the draw.
+                PSVoxel is shaded with the CBLights layout the renderer
+                binds to it and darkened by the ambient occlusion, and
+                draws without a diffuse image read white
+      Args:     const DrawCommand& draw
+                  Draw the pixel belongs to
+                const ShadedVertex& pixel
+                  Interpolated attributes of the pixel
+      Returns:  XMVECTOR
+                  Color of the pixel, not saturated
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SoftwareRenderer::shadePixel(const DrawCommand& draw, const ShadedVertex& pixel) const
+    {
+        if (draw.Shading == eDrawShading::LIGHT_CUBE)
+        {
+            return XMLoadFloat4(&draw.Constants.OutputColor);
+        }
+
+        XMVECTOR worldPosition = XMLoadFloat3(&pixel.WorldPosition);
+        XMVECTOR interpolatedNormal = XMLoadFloat3(&pixel.Normal);
+        XMVECTOR normal = XMVector3Normalize(interpolatedNormal);
+
+        if (draw.pNormalMap && (draw.aPackedVertices ? draw.aPackedNormalData != nullptr : draw.aNormalData != nullptr))
+        {
+            XMFLOAT4 bumpMap;
+            XMStoreFloat4(&bumpMap, XMVectorSubtract(XMVectorScale(sampleBilinear(*draw.pNormalMap, pixel.TexCoord), 2.0f), XMVectorSplatOne()));
+
+            // BC5 normal maps only store x and y
+            bumpMap.z = std::sqrt(std::clamp(1.0f - bumpMap.x * bumpMap.x - bumpMap.y * bumpMap.y, 0.0f, 1.0f));
+
+            XMVECTOR bumpNormal = XMVectorScale(XMLoadFloat3(&pixel.Tangent), bumpMap.x);
+            bumpNormal = XMVectorMultiplyAdd(XMLoadFloat3(&pixel.Bitangent), XMVectorReplicate(bumpMap.y), bumpNormal);
+            bumpNormal = XMVectorMultiplyAdd(normal, XMVectorReplicate(bumpMap.z), bumpNormal);
+            normal = XMVector3Normalize(bumpNormal);
+        }
+
+        XMVECTOR albedo = draw.pDiffuse ? sampleBilinear(*draw.pDiffuse, pixel.TexCoord) : XMVectorSplatOne();
+        XMVECTOR viewDirection = XMVector3Normalize(XMVectorSubtract(XMLoadFloat4(&m_cameraPosition), worldPosition));
+
+        XMVECTOR ambient = draw.Shading == eDrawShading::PHONG ? XMVectorScale(albedo, AMBIENT) : XMVectorZero();
+        XMVECTOR diffuse = XMVectorZero();
+        XMVECTOR specular = XMVectorZero();
+        for (uint32_t i = 0u; i < NUM_LIGHTS; ++i)
+        {
+            XMVECTOR toLight = XMVectorSubtract(XMLoadFloat4(&m_lights.LightPositions[i]), worldPosition);
+            float attenuation = m_lights.LightAttenuationDistance[i].z / (XMVectorGetX(XMVector3LengthSq(toLight)) + 0.000001f);
+            XMVECTOR lightColor = XMVectorScale(XMLoadFloat4(&m_lights.LightColors[i]), attenuation);
+            XMVECTOR lightDirection = XMVector3Normalize(toLight);
+
+            ambient = XMVectorMultiplyAdd(lightColor, XMVectorReplicate(AMBIENT), ambient);
+            diffuse = XMVectorMultiplyAdd(lightColor, XMVectorSaturate(XMVector3Dot(normal, lightDirection)), diffuse);
+
+            if (draw.Shading == eDrawShading::PHONG)
+            {
+                XMVECTOR reflectDirection = XMVector3Reflect(XMVectorNegate(lightDirection), interpolatedNormal);
+                float highlight = std::pow(std::clamp(XMVectorGetX(XMVector3Dot(reflectDirection, viewDirection)), 0.0f, 1.0f), SPECULAR_POWER);
+                specular = XMVectorMultiplyAdd(XMVectorMultiply(lightColor, albedo), XMVectorReplicate(highlight), specular);
+            }
+        }
+
+        if (draw.Shading == eDrawShading::VOXEL && draw.aAmbientOcclusion)
+        {
+            ambient = XMVectorScale(ambient, pixel.AmbientOcclusion);
+            diffuse = XMVectorScale(diffuse, pixel.AmbientOcclusion);
+        }
+
+        return XMVectorMultiply(XMVectorSetW(XMVectorAdd(XMVectorAdd(ambient, diffuse), specular), 1.0f), albedo);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::lerpVertex
+      Summary:  Interpolates two vertices in clip space, where the
+                clipping planes cut edges linearly
+      Args:     const ShadedVertex& from
+                  Vertex at t = 0
+                const ShadedVertex& to
+                  Vertex at t = 1
+                float t
+                  Interpolation factor
+      Returns:  ShadedVertex
+                  Interpolated vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SoftwareRenderer::ShadedVertex SoftwareRenderer::lerpVertex(const ShadedVertex& from, const ShadedVertex& to, float t)
+    {
+        ShadedVertex result;
+        XMStoreFloat4(&result.ClipPosition, XMVectorLerp(XMLoadFloat4(&from.ClipPosition), XMLoadFloat4(&to.ClipPosition), t));
+        XMStoreFloat3(&result.WorldPosition, XMVectorLerp(XMLoadFloat3(&from.WorldPosition), XMLoadFloat3(&to.WorldPosition), t));
+        XMStoreFloat3(&result.Normal, XMVectorLerp(XMLoadFloat3(&from.Normal), XMLoadFloat3(&to.Normal), t));
+        XMStoreFloat3(&result.Tangent, XMVectorLerp(XMLoadFloat3(&from.Tangent), XMLoadFloat3(&to.Tangent), t));
+        XMStoreFloat3(&result.Bitangent, XMVectorLerp(XMLoadFloat3(&from.Bitangent), XMLoadFloat3(&to.Bitangent), t));
+        XMStoreFloat2(&result.TexCoord, XMVectorLerp(XMLoadFloat2(&from.TexCoord), XMLoadFloat2(&to.TexCoord), t));
+        result.AmbientOcclusion = from.AmbientOcclusion + (to.AmbientOcclusion - from.AmbientOcclusion) * t;
+
+        return result;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::blendVertices
+      Summary:  Weighs the attributes of the corners of a triangle.
+                The clip position is left out, pixels do not need it
+      Args:     const ShadedVertex* aCorners
+                  Three corners
+                const float* aWeights
+                  Weight of each corner, adding up to one
+      Returns:  ShadedVertex
+                  Blended vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SoftwareRenderer::ShadedVertex SoftwareRenderer::blendVertices(const ShadedVertex* aCorners, const float* aWeights)
+    {
+        XMVECTOR worldPosition = XMVectorZero();
+        XMVECTOR normal = XMVectorZero();
+        XMVECTOR tangent = XMVectorZero();
+        XMVECTOR bitangent = XMVectorZero();
+        XMVECTOR texCoord = XMVectorZero();
+        float ambientOcclusion = 0.0f;
+        for (uint32_t i = 0u; i < 3u; ++i)
+        {
+            XMVECTOR weight = XMVectorReplicate(aWeights[i]);
+            worldPosition = XMVectorMultiplyAdd(XMLoadFloat3(&aCorners[i].WorldPosition), weight, worldPosition);
+            normal = XMVectorMultiplyAdd(XMLoadFloat3(&aCorners[i].Normal), weight, normal);
+            tangent = XMVectorMultiplyAdd(XMLoadFloat3(&aCorners[i].Tangent), weight, tangent);
+            bitangent = XMVectorMultiplyAdd(XMLoadFloat3(&aCorners[i].Bitangent), weight, bitangent);
+            texCoord = XMVectorMultiplyAdd(XMLoadFloat2(&aCorners[i].TexCoord), weight, texCoord);
+            ambientOcclusion += aCorners[i].AmbientOcclusion * aWeights[i];
+        }
+
+        ShadedVertex result;
+        result.ClipPosition = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+        XMStoreFloat3(&result.WorldPosition, worldPosition);
+        XMStoreFloat3(&result.Normal, normal);
+        XMStoreFloat3(&result.Tangent, tangent);
+        XMStoreFloat3(&result.Bitangent, bitangent);
+        XMStoreFloat2(&result.TexCoord, texCoord);
+        result.AmbientOcclusion = ambientOcclusion;
+
+        return result;
+    }
+}
@@ -0,0 +1,170 @@
+/*+===================================================================
+  File:      SOFTWARERENDERER.H
+
+  Summary:   SoftwareRenderer header file contains declaration of class
+             SoftwareRenderer, the RenderBackend that draws frames on
+             the CPU without a Direct3D device. It only depends on
+             DirectXMath and the standard library.
+
+  Classes:  SoftwareRenderer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/RenderBackend.h"
+#include "Texture/Image.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SoftwareRenderer
+      Summary:  Reference rasterizer following the conventions of the
+                Direct3D path: clockwise front faces, back faces
+                culled, pixel centers at half pixels with the top-left
+                fill rule on a 1/256 subpixel grid, a LESS depth test
+                and bilinear wrapped texture sampling. Render transforms
+                the vertices in parallel, then clips the triangles
+                against the near and far planes and a guard band around
+                the viewport and bins them into TILE_SIZE square tiles,
+                one job per TRIANGLE_GRAIN_SIZE triangles, and finally
+                rasterizes and shades one tile per job, visiting its
+                triangles in submission order. No two jobs write the
+                same pixel, so a frame does not depend on the number of
+                workers
+      Methods:  BeginFrame
+                  Clears the frame and forgets the draws
+                SetCamera
+                  Sets the view and projection constants
+                SetLights
+                  Sets the light constants
+                Draw
+                  Adds a draw to the frame
+                Render
+                  Rasterizes the draws of the frame
+                GetFrame
+                  Returns the pixels of the frame
+                GetDepth
+                  Returns the depth of a pixel
+                GetNumTriangles
+                  Returns the number of triangles rasterized
+                SoftwareRenderer
+                  Constructor.
+                ~SoftwareRenderer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SoftwareRenderer final : public RenderBackend
+    {
+    public:
+        static constexpr const uint32_t TILE_SIZE = 32u;
+        static constexpr const uint32_t VERTEX_GRAIN_SIZE = 1024u;
+        static constexpr const uint32_t TRIANGLE_GRAIN_SIZE = 1024u;
+
+    public:
+        SoftwareRenderer(uint32_t uWidth, uint32_t uHeight);
+        SoftwareRenderer(const SoftwareRenderer& other) = delete;
+        SoftwareRenderer(SoftwareRenderer&& other) = delete;
+        SoftwareRenderer& operator=(const SoftwareRenderer& other) = delete;
+        SoftwareRenderer& operator=(SoftwareRenderer&& other) = delete;
+        virtual ~SoftwareRenderer() = default;
+
+        void BeginFrame(const DirectX::XMFLOAT4& clearColor) override;
+        void SetCamera(const CBChangeOnCameraMovement& cbCamera, const CBChangeOnResize& cbResize) override;
+        void SetLights(const CBLights& cbLights) override;
+        void Draw(const DrawCommand& draw) override;
+        void Render() override;
+        const Image& GetFrame() const override;
+
+        float GetDepth(uint32_t uX, uint32_t uY) const;
+        uint32_t GetNumTriangles() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ShadedVertex
+          Summary:  Output of the vertex stage, in clip space and in
+                    world space
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ShadedVertex
+        {
+            DirectX::XMFLOAT4 ClipPosition;
+            DirectX::XMFLOAT3 WorldPosition;
+            DirectX::XMFLOAT3 Normal;
+            DirectX::XMFLOAT3 Tangent;
+            DirectX::XMFLOAT3 Bitangent;
+            DirectX::XMFLOAT2 TexCoord;
+            float AmbientOcclusion;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ScreenTriangle
+          Summary:  Clipped front facing triangle. aScreen holds the
+                    corners in pixels with their depth in z and 1 / w
+                    in w
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ScreenTriangle
+        {
+            DirectX::XMFLOAT4 aScreen[3];
+            ShadedVertex aCorners[3];
+            uint32_t uDraw;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   TriangleBins
+          Summary:  Triangles set up by one job, and their indices
+                    sorted by tile: tile t holds the triangles from
+                    auTileOffsets[t] to auTileOffsets[t + 1] of
+                    auTileTriangles, in submission order
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct TriangleBins
+        {
+            std::vector<ScreenTriangle> aTriangles;
+            std::vector<uint32_t> auTileOffsets;
+            std::vector<uint32_t> auTileTriangles;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Batch
+          Summary:  One instance of a draw, with the offsets of its
+                    vertices and triangles in the whole frame
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Batch
+        {
+            uint32_t uDraw;
+            uint32_t uInstance;
+            uint32_t uFirstVertex;
+            uint32_t uFirstTriangle;
+        };
+
+    private:
+        void shadeVertices(uint32_t uBegin, uint32_t uEnd);
+        void setupTriangles(uint32_t uBins);
+        void rasterizeTile(uint32_t uTile);
+        DirectX::XMVECTOR shadePixel(const DrawCommand& draw, const ShadedVertex& pixel) const;
+
+        static ShadedVertex lerpVertex(const ShadedVertex& from, const ShadedVertex& to, float t);
+        static ShadedVertex blendVertices(const ShadedVertex* aCorners, const float* aWeights);
+
+    private:
+        uint32_t m_uWidth;
+        uint32_t m_uHeight;
+        uint32_t m_uNumTilesX;
+        uint32_t m_uNumTilesY;
+        DirectX::XMMATRIX m_viewProjection;
+        DirectX::XMFLOAT4 m_cameraPosition;
+        DirectX::XMFLOAT4 m_clearColor;
+        CBLights m_lights;
+        std::vector<DrawCommand> m_aDraws;
+        std::vector<Batch> m_aBatches;
+        std::vector<ShadedVertex> m_aShadedVertices;
+        std::vector<TriangleBins> m_aBins;
+        Image m_frame;
+        std::vector<float> m_aDepth;
+        uint32_t m_uNumTriangles;
+    };
+}
@@ -0,0 +1,259 @@
+#include "Renderer/StaticBatch.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::Build
+      Summary:  Merges renderables into batches. Renderables drawn with
+                the same state get the same state key, their meshes are
+                keyed by material, and StaticBatchBuilder merges the
+                geometry. The world matrices of the renderables must be
+                up to date
+      Args:     const std::vector<Renderable*>& apRenderables
+                  Renderables that never move
+                std::vector<std::shared_ptr<StaticBatch>>& aOutBatches
+                  Batches built from the renderables
+      Returns:  HRESULT
+                  Status code. E_INVALIDARG if a renderable has no
+                  shaders or more vertices than one batch can hold
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StaticBatch::Build(_In_ const std::vector<Renderable*>& apRenderables, _Out_ std::vector<std::shared_ptr<StaticBatch>>& aOutBatches)
+    {
+        aOutBatches.clear();
+
+        // First renderable of each state key, and every material met, by id
+        std::vector<const Renderable*> apStates;
+        std::vector<std::shared_ptr<Material>> aMaterials;
+
+        std::vector<StaticBatchSource> aSources;
+        aSources.reserve(apRenderables.size());
+        for (const Renderable* renderable : apRenderables)
+        {
+            if (!renderable->m_vertexShader || !renderable->m_pixelShader)
+            {
+                return E_INVALIDARG;
+            }
+
+            UINT uStateKey = 0u;
+            while (uStateKey < apStates.size() && !isSameState(*apStates[uStateKey], *renderable))
+            {
+                ++uStateKey;
+            }
+
+            if (uStateKey == apStates.size())
+            {
+                apStates.push_back(renderable);
+            }
+
+            StaticBatchSource source = {
+                .uStateKey = uStateKey,
+                .world = XMFLOAT4X4(),
+                .aVertices = std::span<const SimpleVertex>(renderable->getVertices(), renderable->GetNumVertices()),
+                .aIndices = std::span<const WORD>(renderable->getIndices(), renderable->GetNumIndices()),
+                .aNormalData = renderable->m_aNormalData,
+                .aMeshes = {},
+            };
+            XMStoreFloat4x4(&source.world, renderable->GetWorldMatrix());
+
+            if (renderable->HasTexture())
+            {
+                for (const BasicMeshEntry& mesh : renderable->m_aMeshes)
+                {
+                    // The renderer can not draw a mesh without a material either
+                    if (mesh.uMaterialIndex >= renderable->m_aMaterials.size())
+                    {
+                        continue;
+                    }
+
+                    const std::shared_ptr<Material>& material = renderable->m_aMaterials[mesh.uMaterialIndex];
+
+                    UINT uMaterial = 0u;
+                    while (uMaterial < aMaterials.size() && aMaterials[uMaterial] != material)
+                    {
+                        ++uMaterial;
+                    }
+
+                    if (uMaterial == aMaterials.size())
+                    {
+                        aMaterials.push_back(material);
+                    }
+
+                    source.aMeshes.push_back(StaticBatchMesh{
+                        .uNumIndices = mesh.uNumIndices,
+                        .uBaseVertex = mesh.uBaseVertex,
+                        .uBaseIndex = mesh.uBaseIndex,
+                        .uMaterial = uMaterial,
+                    });
+                }
+
+                if (source.aMeshes.empty())
+                {
+                    continue;
+                }
+            }
+
+            aSources.push_back(std::move(source));
+        }
+
+        std::vector<StaticBatchGeometry> aGeometries;
+        if (!StaticBatchBuilder::Build(aSources, aGeometries))
+        {
+            return E_INVALIDARG;
+        }
+
+        for (StaticBatchGeometry& geometry : aGeometries)
+        {
+            const Renderable* state = apStates[geometry.uStateKey];
+
+            std::shared_ptr<StaticBatch> batch = std::make_shared<StaticBatch>(state->m_outputColor);
+            batch->m_vertexShader = state->m_vertexShader;
+            batch->m_pixelShader = state->m_pixelShader;
+            batch->m_bHasNormalMap = state->m_bHasNormalMap;
+            batch->m_bHasSourceNormalData = !geometry.aNormalData.empty();
+            batch->m_uNumSources = static_cast<UINT>(geometry.auSources.size());
+            batch->m_aVertices = std::move(geometry.aVertices);
+            batch->m_aNormalData = std::move(geometry.aNormalData);
+            batch->m_aIndices = std::move(geometry.aIndices);
+
+            for (const StaticBatchMesh& mesh : geometry.aMeshes)
+            {
+                BasicMeshEntry entry;
+                entry.uNumIndices = mesh.uNumIndices;
+                entry.uBaseVertex = mesh.uBaseVertex;
+                entry.uBaseIndex = mesh.uBaseIndex;
+                if (mesh.uMaterial != StaticBatchBuilder::NO_MATERIAL)
+                {
+                    entry.uMaterialIndex = static_cast<UINT>(batch->m_aMaterials.size());
+                    batch->m_aMaterials.push_back(aMaterials[mesh.uMaterial]);
+                }
+                batch->m_aMeshes.push_back(entry);
+            }
+
+            aOutBatches.push_back(batch);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::StaticBatch
+      Summary:  Constructor
+      Args:     const XMFLOAT4& outputColor
+                  Output color shared by the merged renderables
+      Modifies: [m_aVertices, m_aIndices, m_uNumSources,
+                 m_bHasSourceNormalData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StaticBatch::StaticBatch(_In_ const XMFLOAT4& outputColor)
+        : Renderable(outputColor)
+        , m_aVertices()
+        , m_aIndices()
+        , m_uNumSources(0u)
+        , m_bHasSourceNormalData(FALSE)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::Initialize
+      Summary:  Creates the buffers of the merged geometry. Tangents are
+                computed from the world space vertices unless every
+                merged renderable brought its own
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StaticBatch::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        return initialize(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::Update
+      Summary:  Does nothing, the vertices are already in world space
+      Args:     FLOAT deltaTime
+                  Time difference of a frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatch::Update(_In_ FLOAT deltaTime)
+    {
+        UNREFERENCED_PARAMETER(deltaTime);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::GetNumSources
+      Summary:  Returns the number of renderables merged into the batch
+      Returns:  UINT
+                  Number of merged renderables
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StaticBatch::GetNumSources() const
+    {
+        return m_uNumSources;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::GetNumVertices
+      Summary:  Returns the number of vertices
+      Returns:  UINT
+                  Number of vertices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StaticBatch::GetNumVertices() const
+    {
+        return static_cast<UINT>(m_aVertices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::GetNumIndices
+      Summary:  Returns the number of indices
+      Returns:  UINT
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StaticBatch::GetNumIndices() const
+    {
+        return static_cast<UINT>(m_aIndices.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::getVertices
+      Summary:  Returns the pointer to the vertices data
+      Returns:  const SimpleVertex*
+                  Pointer to the vertices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SimpleVertex* StaticBatch::getVertices() const
+    {
+        return m_aVertices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::getIndices
+      Summary:  Returns the pointer to the indices data
+      Returns:  const WORD*
+                  Pointer to the indices data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const WORD* StaticBatch::getIndices() const
+    {
+        return m_aIndices.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatch::isSameState
+      Summary:  Returns whether two renderables are drawn with the same
+                shaders, permutation and constants
+      Args:     const Renderable& renderable
+                  First renderable
+                const Renderable& other
+                  Second renderable
+      Returns:  BOOL
+                  Whether the two can share a batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL StaticBatch::isSameState(_In_ const Renderable& renderable, _In_ const Renderable& other)
+    {
+        const XMFLOAT4& color = renderable.m_outputColor;
+        const XMFLOAT4& otherColor = other.m_outputColor;
+
+        return renderable.m_vertexShader == other.m_vertexShader
+            && renderable.m_pixelShader == other.m_pixelShader
+            && renderable.GetPermutation().GetKey() == other.GetPermutation().GetKey()
+            && renderable.HasTexture() == other.HasTexture()
+            && color.x == otherColor.x && color.y == otherColor.y && color.z == otherColor.z && color.w == otherColor.w;
+    }
+}
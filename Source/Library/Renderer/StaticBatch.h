@@ -0,0 +1,83 @@
+/*+===================================================================
+  File:      STATICBATCH.H
+
+  Summary:   StaticBatch header file contains declaration of class
+             StaticBatch that merges renderables which never move into
+             shared vertex and index buffers.
+
+  Classes:  StaticBatch
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/Renderable.h"
+#include "Renderer/StaticBatchBuilder.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StaticBatch
+      Summary:  Renderable made of the geometry of several static
+                renderables that share a shader pair, a shader
+                permutation and an output color. Their vertices are
+                moved to world space once, so the batch is drawn with an
+                identity world matrix, and their meshes are grouped into
+                one BasicMeshEntry per material. A scene of many small
+                props is then drawn with one state setup per batch and
+                one draw per material instead of one of each per object.
+                The geometry is merged by StaticBatchBuilder, which only
+                touches memory; buffers are created by Initialize
+      Methods:  Build
+                  Merges static renderables into batches
+                Initialize
+                  Creates the buffers of the merged geometry
+                Update
+                  Does nothing, a batch never moves
+                GetNumSources
+                  Returns the number of renderables merged
+                GetNumVertices
+                  Returns the number of vertices
+                GetNumIndices
+                  Returns the number of indices
+                StaticBatch
+                  Constructor.
+                ~StaticBatch
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StaticBatch final : public Renderable
+    {
+    public:
+        static HRESULT Build(_In_ const std::vector<Renderable*>& apRenderables, _Out_ std::vector<std::shared_ptr<StaticBatch>>& aOutBatches);
+
+        StaticBatch(_In_ const XMFLOAT4& outputColor);
+        StaticBatch(const StaticBatch& other) = delete;
+        StaticBatch(StaticBatch&& other) = delete;
+        StaticBatch& operator=(const StaticBatch& other) = delete;
+        StaticBatch& operator=(StaticBatch&& other) = delete;
+        ~StaticBatch() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+        void Update(_In_ FLOAT deltaTime) override;
+
+        UINT GetNumSources() const;
+        UINT GetNumVertices() const override;
+        UINT GetNumIndices() const override;
+
+    protected:
+        const SimpleVertex* getVertices() const override;
+        const WORD* getIndices() const override;
+
+    private:
+        static BOOL isSameState(_In_ const Renderable& renderable, _In_ const Renderable& other);
+
+    private:
+        std::vector<SimpleVertex> m_aVertices;
+        std::vector<WORD> m_aIndices;
+        UINT m_uNumSources;
+        BOOL m_bHasSourceNormalData;
+    };
+}
@@ -0,0 +1,192 @@
+#include "Renderer/StaticBatchBuilder.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatchBuilder::Build
+      Summary:  Merges sources into batches. Each source joins the first
+                batch it can be drawn with that still has room for its
+                vertices, or starts a new one
+      Args:     const std::vector<StaticBatchSource>& aSources
+                  Objects that never move
+                std::vector<StaticBatchGeometry>& aOutBatches
+                  Batches built from the sources
+      Returns:  bool
+                  False if a source has more vertices than one batch
+                  can hold
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool StaticBatchBuilder::Build(const std::vector<StaticBatchSource>& aSources, std::vector<StaticBatchGeometry>& aOutBatches)
+    {
+        aOutBatches.clear();
+
+        // Materials of every batch and their indices, joined once all sources are added
+        std::vector<std::vector<uint32_t>> aauMaterials;
+        std::vector<std::vector<std::vector<uint16_t>>> aaMaterialIndices;
+
+        for (uint32_t uSource = 0u; uSource < aSources.size(); ++uSource)
+        {
+            const StaticBatchSource& source = aSources[uSource];
+            if (source.aVertices.size() > MAX_NUM_VERTICES)
+            {
+                return false;
+            }
+
+            if (source.aVertices.empty() || source.aIndices.empty())
+            {
+                continue;
+            }
+
+            size_t uBatch = 0u;
+            for (; uBatch < aOutBatches.size(); ++uBatch)
+            {
+                if (canMerge(aOutBatches[uBatch], source))
+                {
+                    break;
+                }
+            }
+
+            if (uBatch == aOutBatches.size())
+            {
+                aOutBatches.emplace_back();
+                aOutBatches.back().uStateKey = source.uStateKey;
+                aauMaterials.emplace_back();
+                aaMaterialIndices.emplace_back();
+            }
+
+            append(source, uSource, aOutBatches[uBatch], aauMaterials[uBatch], aaMaterialIndices[uBatch]);
+        }
+
+        for (size_t i = 0u; i < aOutBatches.size(); ++i)
+        {
+            finish(aauMaterials[i], aaMaterialIndices[i], aOutBatches[i]);
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatchBuilder::canMerge
+      Summary:  Returns whether a source would be drawn with the same
+                state as the batch and its vertices still fit
+      Args:     const StaticBatchGeometry& batch
+                  Batch to add to
+                const StaticBatchSource& source
+                  Source to add
+      Returns:  bool
+                  Whether the source can join the batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool StaticBatchBuilder::canMerge(const StaticBatchGeometry& batch, const StaticBatchSource& source)
+    {
+        bool bHasNormalData = source.aNormalData.size() == source.aVertices.size();
+
+        return batch.uStateKey == source.uStateKey
+            && batch.aVertices.size() + source.aVertices.size() <= MAX_NUM_VERTICES
+            && batch.aNormalData.empty() != bHasNormalData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatchBuilder::append
+      Summary:  Moves the vertices of a source to world space and adds
+                them to the batch, and sorts its indices by material.
+                Normals and tangents go through the world matrix the
+                same way the vertex shaders transform them
+      Args:     const StaticBatchSource& source
+                  Source to add
+                uint32_t uSource
+                  Index of the source
+                StaticBatchGeometry& batch
+                  Batch to add to
+                std::vector<uint32_t>& auMaterials
+                  Materials of the batch
+                std::vector<std::vector<uint16_t>>& aMaterialIndices
+                  Indices of the batch, one list per material
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatchBuilder::append(const StaticBatchSource& source, uint32_t uSource, StaticBatchGeometry& batch, std::vector<uint32_t>& auMaterials, std::vector<std::vector<uint16_t>>& aMaterialIndices)
+    {
+        DirectX::XMMATRIX world = DirectX::XMLoadFloat4x4(&source.world);
+        uint32_t uBaseVertex = static_cast<uint32_t>(batch.aVertices.size());
+
+        for (const SimpleVertex& sourceVertex : source.aVertices)
+        {
+            SimpleVertex vertex = sourceVertex;
+            DirectX::XMStoreFloat3(&vertex.Position, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&vertex.Position), world));
+            DirectX::XMStoreFloat3(&vertex.Normal, DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&vertex.Normal), world)));
+            batch.aVertices.push_back(vertex);
+        }
+
+        if (source.aNormalData.size() == source.aVertices.size())
+        {
+            for (const NormalData& normalData : source.aNormalData)
+            {
+                NormalData worldNormalData;
+                DirectX::XMStoreFloat3(&worldNormalData.Tangent, DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&normalData.Tangent), world)));
+                DirectX::XMStoreFloat3(&worldNormalData.Bitangent, DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&normalData.Bitangent), world)));
+                batch.aNormalData.push_back(worldNormalData);
+            }
+        }
+
+        if (source.aMeshes.empty())
+        {
+            // Sources without meshes are drawn whole, so the batch keeps one range
+            auMaterials.resize(1u, NO_MATERIAL);
+            aMaterialIndices.resize(1u);
+            for (uint16_t uIndex : source.aIndices)
+            {
+                aMaterialIndices[0].push_back(static_cast<uint16_t>(uBaseVertex + uIndex));
+            }
+        }
+        else
+        {
+            for (const StaticBatchMesh& mesh : source.aMeshes)
+            {
+                size_t uMaterial = 0u;
+                while (uMaterial < auMaterials.size() && auMaterials[uMaterial] != mesh.uMaterial)
+                {
+                    ++uMaterial;
+                }
+
+                if (uMaterial == auMaterials.size())
+                {
+                    auMaterials.push_back(mesh.uMaterial);
+                    aMaterialIndices.emplace_back();
+                }
+
+                for (uint32_t i = mesh.uBaseIndex; i < mesh.uBaseIndex + mesh.uNumIndices; ++i)
+                {
+                    aMaterialIndices[uMaterial].push_back(static_cast<uint16_t>(uBaseVertex + mesh.uBaseVertex + source.aIndices[i]));
+                }
+            }
+        }
+
+        batch.auSources.push_back(uSource);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatchBuilder::finish
+      Summary:  Joins the index lists into the index array and makes a
+                mesh for each material
+      Args:     const std::vector<uint32_t>& auMaterials
+                  Materials of the batch
+                const std::vector<std::vector<uint16_t>>& aMaterialIndices
+                  Indices of the batch, one list per material
+                StaticBatchGeometry& batch
+                  Batch to finish
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatchBuilder::finish(const std::vector<uint32_t>& auMaterials, const std::vector<std::vector<uint16_t>>& aMaterialIndices, StaticBatchGeometry& batch)
+    {
+        batch.aIndices.clear();
+        batch.aMeshes.clear();
+
+        for (size_t uMaterial = 0u; uMaterial < aMaterialIndices.size(); ++uMaterial)
+        {
+            batch.aMeshes.push_back(StaticBatchMesh{
+                .uNumIndices = static_cast<uint32_t>(aMaterialIndices[uMaterial].size()),
+                .uBaseVertex = 0u,
+                .uBaseIndex = static_cast<uint32_t>(batch.aIndices.size()),
+                .uMaterial = auMaterials[uMaterial],
+            });
+
+            batch.aIndices.insert(batch.aIndices.end(), aMaterialIndices[uMaterial].begin(), aMaterialIndices[uMaterial].end());
+        }
+    }
+}
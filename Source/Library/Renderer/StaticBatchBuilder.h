@@ -0,0 +1,101 @@
+/*+===================================================================
+  File:      STATICBATCHBUILDER.H
+
+  Summary:   StaticBatchBuilder header file contains declaration of
+             class StaticBatchBuilder that merges the geometry of
+             objects which never move into shared vertex and index
+             arrays. It only depends on DirectXMath and the standard
+             library.
+
+  Classes:  StaticBatchBuilder
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Renderer/VertexTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   StaticBatchMesh
+      Summary:  Range of indices drawn with one material
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct StaticBatchMesh
+    {
+        uint32_t uNumIndices;
+        uint32_t uBaseVertex;
+        uint32_t uBaseIndex;
+        uint32_t uMaterial;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   StaticBatchSource
+      Summary:  Geometry of one static object. Objects with the same
+                state key are drawn with the same shaders and
+                constants. An object without meshes is drawn whole
+                without a material
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct StaticBatchSource
+    {
+        uint32_t uStateKey;
+        DirectX::XMFLOAT4X4 world;
+        std::span<const SimpleVertex> aVertices;
+        std::span<const uint16_t> aIndices;
+        std::span<const NormalData> aNormalData;
+        std::vector<StaticBatchMesh> aMeshes;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   StaticBatchGeometry
+      Summary:  Merged geometry of one batch in world space, with one
+                mesh per material in the order the materials were met.
+                Normal data is kept only when every source had it
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct StaticBatchGeometry
+    {
+        uint32_t uStateKey;
+        std::vector<SimpleVertex> aVertices;
+        std::vector<NormalData> aNormalData;
+        std::vector<uint16_t> aIndices;
+        std::vector<StaticBatchMesh> aMeshes;
+        std::vector<uint32_t> auSources;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StaticBatchBuilder
+      Summary:  Merges static objects that share a state key into
+                batches. Their vertices are moved to world space once,
+                so a batch is drawn with an identity world matrix, and
+                their meshes are grouped into one range per material.
+                Indices are 16-bit, so a batch is split once it would
+                hold more than MAX_NUM_VERTICES vertices
+      Methods:  Build
+                  Merges sources into batches
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StaticBatchBuilder
+    {
+    public:
+        static constexpr const uint32_t MAX_NUM_VERTICES = 65536u;
+        static constexpr const uint32_t NO_MATERIAL = 0xFFFFFFFFu;
+
+    public:
+        StaticBatchBuilder() = delete;
+        StaticBatchBuilder(const StaticBatchBuilder& other) = delete;
+        StaticBatchBuilder(StaticBatchBuilder&& other) = delete;
+        StaticBatchBuilder& operator=(const StaticBatchBuilder& other) = delete;
+        StaticBatchBuilder& operator=(StaticBatchBuilder&& other) = delete;
+        ~StaticBatchBuilder() = delete;
+
+        static bool Build(const std::vector<StaticBatchSource>& aSources, std::vector<StaticBatchGeometry>& aOutBatches);
+
+    private:
+        static bool canMerge(const StaticBatchGeometry& batch, const StaticBatchSource& source);
+        static void append(const StaticBatchSource& source, uint32_t uSource, StaticBatchGeometry& batch, std::vector<uint32_t>& auMaterials, std::vector<std::vector<uint16_t>>& aMaterialIndices);
+        static void finish(const std::vector<uint32_t>& auMaterials, const std::vector<std::vector<uint16_t>>& aMaterialIndices, StaticBatchGeometry& batch);
+    };
+}
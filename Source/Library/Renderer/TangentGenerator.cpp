@@ -0,0 +1,212 @@
+#include "Renderer/TangentGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Utility/JobSystem.h"
+
+namespace library
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        constexpr const float EPSILON = 1e-12f;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: projectOnPlane
+          Summary:  Removes the component along the unit normal and
+                    normalizes the rest. Zero when nothing is left
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        XMVECTOR projectOnPlane(FXMVECTOR vector, FXMVECTOR normal)
+        {
+            XMVECTOR projected = XMVectorSubtract(vector, XMVectorMultiply(normal, XMVector3Dot(normal, vector)));
+            float lengthSq = XMVectorGetX(XMVector3LengthSq(projected));
+
+            return lengthSq > EPSILON ? XMVectorScale(projected, 1.0f / std::sqrt(lengthSq)) : XMVectorZero();
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: accumulateFaces
+          Summary:  Adds the angle weighted texture space directions of
+                    a range of faces to the accumulators of its
+                    vertices. aAccumulators holds the tangent of vertex
+                    i at 2 * i and its bitangent at 2 * i + 1. The
+                    directions are only normalized after projection, so
+                    the 1 / determinant of the face is reduced to its
+                    sign, and the corner angle comes from the two
+                    projected edges with a single square root
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void accumulateFaces(const SimpleVertex* aVertices, const XMFLOAT4A* aNormals, const uint16_t* aIndices, uint32_t uBeginFace, uint32_t uEndFace, XMFLOAT4A* aAccumulators)
+        {
+            for (uint32_t uFace = uBeginFace; uFace < uEndFace; ++uFace)
+            {
+                const uint16_t* auCorners = &aIndices[uFace * 3u];
+                const SimpleVertex& v0 = aVertices[auCorners[0]];
+                const SimpleVertex& v1 = aVertices[auCorners[1]];
+                const SimpleVertex& v2 = aVertices[auCorners[2]];
+
+                float du1 = v1.TexCoord.x - v0.TexCoord.x;
+                float dv1 = v1.TexCoord.y - v0.TexCoord.y;
+                float du2 = v2.TexCoord.x - v0.TexCoord.x;
+                float dv2 = v2.TexCoord.y - v0.TexCoord.y;
+
+                // Faces without texture space area give no direction
+                float determinant = du1 * dv2 - du2 * dv1;
+                if (std::fabs(determinant) <= EPSILON)
+                {
+                    continue;
+                }
+
+                XMVECTOR p0 = XMLoadFloat3(&v0.Position);
+                XMVECTOR p1 = XMLoadFloat3(&v1.Position);
+                XMVECTOR p2 = XMLoadFloat3(&v2.Position);
+
+                // Edge k runs from corner k to the next corner
+                XMVECTOR aEdges[3] = { XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p1), XMVectorSubtract(p0, p2) };
+                XMVECTOR edge2 = XMVectorNegate(aEdges[2]);
+
+                float sign = determinant < 0.0f ? -1.0f : 1.0f;
+                XMVECTOR faceTangent = XMVectorScale(XMVectorSubtract(XMVectorScale(aEdges[0], dv2), XMVectorScale(edge2, dv1)), sign);
+                XMVECTOR faceBitangent = XMVectorScale(XMVectorSubtract(XMVectorScale(edge2, du1), XMVectorScale(aEdges[0], du2)), sign);
+
+                for (uint32_t uCorner = 0u; uCorner < 3u; ++uCorner)
+                {
+                    uint16_t uVertex = auCorners[uCorner];
+                    XMVECTOR normal = XMLoadFloat4A(&aNormals[uVertex]);
+
+                    // Angle of the corner, measured in the plane of the normal
+                    XMVECTOR toNext = XMVectorSubtract(aEdges[uCorner], XMVectorMultiply(normal, XMVector3Dot(normal, aEdges[uCorner])));
+                    XMVECTOR toPrevious = XMVectorSubtract(aEdges[(uCorner + 2u) % 3u], XMVectorMultiply(normal, XMVector3Dot(normal, aEdges[(uCorner + 2u) % 3u])));
+                    float nextLengthSq = XMVectorGetX(XMVector3LengthSq(toNext));
+                    float previousLengthSq = XMVectorGetX(XMVector3LengthSq(toPrevious));
+                    float cosine = 0.0f;
+                    if (nextLengthSq > EPSILON && previousLengthSq > EPSILON)
+                    {
+                        // toPrevious points from the previous corner to this one
+                        cosine = std::clamp(-XMVectorGetX(XMVector3Dot(toNext, toPrevious)) / std::sqrt(nextLengthSq * previousLengthSq), -1.0f, 1.0f);
+                    }
+                    XMVECTOR angle = XMVectorReplicate(XMScalarACos(cosine));
+
+                    XMFLOAT4A& tangent = aAccumulators[uVertex * 2u];
+                    XMFLOAT4A& bitangent = aAccumulators[uVertex * 2u + 1u];
+                    XMStoreFloat4A(&tangent, XMVectorMultiplyAdd(projectOnPlane(faceTangent, normal), angle, XMLoadFloat4A(&tangent)));
+                    XMStoreFloat4A(&bitangent, XMVectorMultiplyAdd(projectOnPlane(faceBitangent, normal), angle, XMLoadFloat4A(&bitangent)));
+                }
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: anyPerpendicular
+          Summary:  Unit vector perpendicular to the unit normal, for
+                    vertices that no face gave a direction
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        XMVECTOR anyPerpendicular(FXMVECTOR normal)
+        {
+            XMVECTOR axis = std::fabs(XMVectorGetX(normal)) < 0.9f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+
+            return XMVector3Normalize(XMVector3Cross(normal, axis));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TangentGenerator::Generate
+      Summary:  Builds the tangent frame of every vertex. Each job
+                accumulates a range of faces into its own copy of the
+                per-vertex sums, then the copies are added together per
+                vertex and orthonormalized. Vertices without a usable
+                face get any tangent perpendicular to their normal
+      Args:     const SimpleVertex* aVertices
+                  Vertices of the mesh
+                uint32_t uNumVertices
+                  Number of vertices
+                const uint16_t* aIndices
+                  Triangle list
+                uint32_t uNumIndices
+                  Number of indices
+                NormalData* aNormalData
+                  Receives the unit tangent and bitangent of every
+                  vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TangentGenerator::Generate(const SimpleVertex* aVertices, uint32_t uNumVertices, const uint16_t* aIndices, uint32_t uNumIndices, NormalData* aNormalData)
+    {
+        // Unit normals, the same for every face of a vertex
+        std::vector<XMFLOAT4A> aNormals(uNumVertices);
+        for (uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            XMVECTOR normal = XMLoadFloat3(&aVertices[i].Normal);
+            float lengthSq = XMVectorGetX(XMVector3LengthSq(normal));
+            XMStoreFloat4A(&aNormals[i], lengthSq > EPSILON ? XMVectorScale(normal, 1.0f / std::sqrt(lengthSq)) : XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f));
+        }
+
+        JobSystem& jobSystem = JobSystem::GetDefault();
+
+        // One range of faces per job, each with its own accumulators
+        const uint32_t uNumFaces = uNumIndices / 3u;
+        const uint32_t uNumRanges = std::clamp((uNumFaces + MIN_FACES_PER_RANGE - 1u) / MIN_FACES_PER_RANGE, 1u, jobSystem.GetNumWorkers() + 1u);
+        const uint32_t uFacesPerRange = (uNumFaces + uNumRanges - 1u) / uNumRanges;
+
+        std::vector<std::vector<XMFLOAT4A>> aaAccumulators(uNumRanges);
+        jobSystem.ParallelFor(uNumRanges, 1u, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t uRange = uBegin; uRange < uEnd; ++uRange)
+            {
+                aaAccumulators[uRange].assign(uNumVertices * 2u, XMFLOAT4A(0.0f, 0.0f, 0.0f, 0.0f));
+
+                uint32_t uBeginFace = (std::min)(uRange * uFacesPerRange, uNumFaces);
+                uint32_t uEndFace = (std::min)(uBeginFace + uFacesPerRange, uNumFaces);
+                accumulateFaces(aVertices, aNormals.data(), aIndices, uBeginFace, uEndFace, aaAccumulators[uRange].data());
+            }
+        });
+
+        jobSystem.ParallelFor(uNumVertices, VERTEX_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                XMVECTOR tangentSum = XMVectorZero();
+                XMVECTOR bitangentSum = XMVectorZero();
+                for (const std::vector<XMFLOAT4A>& aAccumulators : aaAccumulators)
+                {
+                    tangentSum = XMVectorAdd(tangentSum, XMLoadFloat4A(&aAccumulators[i * 2u]));
+                    bitangentSum = XMVectorAdd(bitangentSum, XMLoadFloat4A(&aAccumulators[i * 2u + 1u]));
+                }
+
+                XMVECTOR normal = XMLoadFloat4A(&aNormals[i]);
+                XMVECTOR tangent = projectOnPlane(tangentSum, normal);
+                if (XMVectorGetX(XMVector3LengthSq(tangent)) <= EPSILON)
+                {
+                    tangent = anyPerpendicular(normal);
+                }
+
+                XMVECTOR bitangent = XMVector3Cross(normal, tangent);
+                if (XMVectorGetX(XMVector3Dot(bitangent, bitangentSum)) < 0.0f)
+                {
+                    bitangent = XMVectorNegate(bitangent);
+                }
+
+                XMStoreFloat3(&aNormalData[i].Tangent, tangent);
+                XMStoreFloat3(&aNormalData[i].Bitangent, bitangent);
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TangentGenerator::GetHandedness
+      Summary:  Returns whether the bitangent of a frame is
+                cross(normal, tangent) or its opposite, which is what
+                the packed vertex formats store in place of it
+      Args:     const XMFLOAT3& normal
+                  Normal of the vertex
+                const NormalData& normalData
+                  Tangent and bitangent of the vertex
+      Returns:  float
+                  1 or -1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float TangentGenerator::GetHandedness(const XMFLOAT3& normal, const NormalData& normalData)
+    {
+        XMVECTOR crossed = XMVector3Cross(XMLoadFloat3(&normal), XMLoadFloat3(&normalData.Tangent));
+
+        return XMVectorGetX(XMVector3Dot(crossed, XMLoadFloat3(&normalData.Bitangent))) < 0.0f ? -1.0f : 1.0f;
+    }
+}
@@ -0,0 +1,58 @@
+/*+===================================================================
+  File:      TANGENTGENERATOR.H
+
+  Summary:   TangentGenerator header file contains declaration of class
+             TangentGenerator used to build the per-vertex tangent
+             frames that normal mapping needs. It only depends on
+             DirectXMath and the standard library.
+
+  Classes:  TangentGenerator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+#include "Renderer/VertexTypes.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TangentGenerator
+      Summary:  Builds a tangent frame per vertex the way MikkTSpace
+                does. Every face contributes its texture space
+                directions to its three corners, projected on the
+                plane of the vertex normal, normalized and weighted by
+                the angle of the corner. The sums are orthonormalized
+                against the normal, and the bitangent is rebuilt as
+                cross(normal, tangent) times the handedness, so that
+                only the tangent and a sign have to be stored.
+                Vertices are not split, so faces that disagree on a
+                shared vertex are averaged like the normals are.
+                Faces are cut into one range per job of the job
+                system, each with its own accumulators, which are
+                summed per vertex afterwards
+      Methods:  Generate
+                  Builds the tangent frames of an indexed mesh
+                GetHandedness
+                  Returns the sign of the bitangent of a frame
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TangentGenerator
+    {
+    public:
+        static constexpr const uint32_t MIN_FACES_PER_RANGE = 1024u;
+        static constexpr const uint32_t VERTEX_GRAIN_SIZE = 2048u;
+
+    public:
+        TangentGenerator() = delete;
+        TangentGenerator(const TangentGenerator& other) = delete;
+        TangentGenerator(TangentGenerator&& other) = delete;
+        TangentGenerator& operator=(const TangentGenerator& other) = delete;
+        TangentGenerator& operator=(TangentGenerator&& other) = delete;
+        ~TangentGenerator() = delete;
+
+        static void Generate(const SimpleVertex* aVertices, uint32_t uNumVertices, const uint16_t* aIndices, uint32_t uNumIndices, NormalData* aNormalData);
+        static float GetHandedness(const DirectX::XMFLOAT3& normal, const NormalData& normalData);
+    };
+}
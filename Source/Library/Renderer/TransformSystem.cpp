@@ -0,0 +1,512 @@
+#include "Renderer/TransformSystem.h"
+
+#include <cassert>
+
+#include "Utility/JobSystem.h"
+#include "Utility/Profiler.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::TransformSystem
+      Summary:  Constructor
+      Modifies: [m_apChunks, m_uNumTransforms, m_auFreeIndices,
+                 m_auBatch, m_uFirstDirty, m_uNumUpdated, m_mutex].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformSystem::TransformSystem()
+        : m_apChunks()
+        , m_uNumTransforms(0u)
+        , m_auFreeIndices()
+        , m_auBatch()
+        , m_uFirstDirty(INVALID_INDEX)
+        , m_uNumUpdated(0u)
+        , m_mutex()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::Create
+      Summary:  Adds an identity transform. A freed slot is reused
+                unless it lies before the parent, which would break the
+                parent-first order. A new slot past the last chunk
+                allocates a chunk; the slots already handed out stay
+                where they are
+      Args:     const TransformHandle& parent
+                  Transform the new one is relative to, INVALID_HANDLE
+                  for a root
+      Modifies: [m_apChunks, m_uNumTransforms, m_auFreeIndices,
+                 m_uFirstDirty].
+      Returns:  TransformHandle
+                  Handle to the new transform
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformHandle TransformSystem::Create(const TransformHandle& parent)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint32_t uParent = IsValid(parent) ? parent.uIndex : INVALID_INDEX;
+
+        uint32_t uIndex = INVALID_INDEX;
+        if (!m_auFreeIndices.empty() && (uParent == INVALID_INDEX || m_auFreeIndices.back() > uParent))
+        {
+            uIndex = m_auFreeIndices.back();
+            m_auFreeIndices.pop_back();
+        }
+        else
+        {
+            uIndex = m_uNumTransforms.load(std::memory_order_relaxed);
+            assert(uIndex < MAX_NUM_TRANSFORMS && "Too many transforms");
+
+            std::unique_ptr<Chunk>& pChunk = m_apChunks[uIndex / CHUNK_SIZE];
+            if (!pChunk)
+            {
+                pChunk = std::make_unique<Chunk>();
+            }
+            pChunk->auGenerations[uIndex % CHUNK_SIZE] = 0u;
+            pChunk->aIsDirty[uIndex % CHUNK_SIZE] = 0u;
+        }
+
+        Chunk& chunk = chunkOf(uIndex);
+        uint32_t uSlot = uIndex % CHUNK_SIZE;
+        chunk.aPositions[uSlot] = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+        chunk.aRotations[uSlot] = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+        chunk.aScales[uSlot] = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+        chunk.aWorlds[uSlot] = DirectX::XMMatrixIdentity();
+        chunk.auParents[uSlot] = uParent;
+        markDirty(uIndex);
+
+        if (uIndex == m_uNumTransforms.load(std::memory_order_relaxed))
+        {
+            m_uNumTransforms.store(uIndex + 1u, std::memory_order_release);
+        }
+
+        return TransformHandle{ .uIndex = uIndex, .uGeneration = chunk.auGenerations[uSlot] };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::Destroy
+      Summary:  Frees a transform. Its children become roots and keep
+                their local transform
+      Args:     const TransformHandle& handle
+                  Transform to free, ignored when already freed
+      Modifies: [m_apChunks, m_auFreeIndices, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::Destroy(const TransformHandle& handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!IsValid(handle))
+        {
+            return;
+        }
+
+        uint32_t uNumTransforms = m_uNumTransforms.load(std::memory_order_relaxed);
+        for (uint32_t i = handle.uIndex + 1u; i < uNumTransforms; ++i)
+        {
+            uint32_t& uParent = chunkOf(i).auParents[i % CHUNK_SIZE];
+            if (uParent == handle.uIndex)
+            {
+                uParent = INVALID_INDEX;
+                markDirty(i);
+            }
+        }
+
+        Chunk& chunk = chunkOf(handle.uIndex);
+        uint32_t uSlot = handle.uIndex % CHUNK_SIZE;
+        chunk.auParents[uSlot] = INVALID_INDEX;
+        chunk.aIsDirty[uSlot] = 0u;
+        ++chunk.auGenerations[uSlot];
+        m_auFreeIndices.push_back(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::IsValid
+      Summary:  Returns whether a handle refers to a live transform
+      Args:     const TransformHandle& handle
+                  Handle to check
+      Returns:  bool
+                  False for INVALID_HANDLE and destroyed transforms
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool TransformSystem::IsValid(const TransformHandle& handle) const
+    {
+        return handle.uIndex < m_uNumTransforms.load(std::memory_order_acquire)
+            && chunkOf(handle.uIndex).auGenerations[handle.uIndex % CHUNK_SIZE] == handle.uGeneration;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::SetPosition
+      Summary:  Changes the position relative to the parent
+      Args:     const TransformHandle& handle
+                  Transform to change
+                const XMFLOAT3& position
+                  New position
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::SetPosition(const TransformHandle& handle, const DirectX::XMFLOAT3& position)
+    {
+        chunkOf(handle.uIndex).aPositions[handle.uIndex % CHUNK_SIZE] = position;
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::SetRotation
+      Summary:  Changes the rotation relative to the parent
+      Args:     const TransformHandle& handle
+                  Transform to change
+                const XMFLOAT4& rotation
+                  New rotation, a unit quaternion
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::SetRotation(const TransformHandle& handle, const DirectX::XMFLOAT4& rotation)
+    {
+        chunkOf(handle.uIndex).aRotations[handle.uIndex % CHUNK_SIZE] = rotation;
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::SetScale
+      Summary:  Changes the scale relative to the parent
+      Args:     const TransformHandle& handle
+                  Transform to change
+                const XMFLOAT3& scale
+                  New scale along each axis
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::SetScale(const TransformHandle& handle, const DirectX::XMFLOAT3& scale)
+    {
+        chunkOf(handle.uIndex).aScales[handle.uIndex % CHUNK_SIZE] = scale;
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::SetLocalMatrix
+      Summary:  Changes the local transform to the scale, rotation and
+                translation of an affine matrix. Skew, which only comes
+                from scaling after rotating, is lost; use Scale to
+                scale a rotated transform
+      Args:     const TransformHandle& handle
+                  Transform to change
+                FXMMATRIX local
+                  New local transform. A matrix with a zero scale
+                  can't be decomposed: it asserts and is ignored
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::SetLocalMatrix(const TransformHandle& handle, DirectX::FXMMATRIX local)
+    {
+        DirectX::XMVECTOR scale;
+        DirectX::XMVECTOR rotation;
+        DirectX::XMVECTOR translation;
+        if (!DirectX::XMMatrixDecompose(&scale, &rotation, &translation, local))
+        {
+            assert(!"Local matrix can't be decomposed into scale, rotation and translation");
+            return;
+        }
+
+        Chunk& chunk = chunkOf(handle.uIndex);
+        uint32_t uSlot = handle.uIndex % CHUNK_SIZE;
+        DirectX::XMStoreFloat3(&chunk.aScales[uSlot], scale);
+        DirectX::XMStoreFloat4(&chunk.aRotations[uSlot], rotation);
+        DirectX::XMStoreFloat3(&chunk.aPositions[uSlot], translation);
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::Rotate
+      Summary:  Applies a rotation after the local transform, turning
+                the position about the parent origin as well
+      Args:     const TransformHandle& handle
+                  Transform to change
+                FXMVECTOR rotation
+                  Rotation to apply, a unit quaternion
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::Rotate(const TransformHandle& handle, DirectX::FXMVECTOR rotation)
+    {
+        Chunk& chunk = chunkOf(handle.uIndex);
+        uint32_t uSlot = handle.uIndex % CHUNK_SIZE;
+
+        DirectX::XMVECTOR current = DirectX::XMLoadFloat4(&chunk.aRotations[uSlot]);
+        DirectX::XMStoreFloat4(&chunk.aRotations[uSlot], DirectX::XMQuaternionNormalize(DirectX::XMQuaternionMultiply(current, rotation)));
+
+        DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&chunk.aPositions[uSlot]);
+        DirectX::XMStoreFloat3(&chunk.aPositions[uSlot], DirectX::XMVector3Rotate(position, rotation));
+
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::Translate
+      Summary:  Moves the local transform
+      Args:     const TransformHandle& handle
+                  Transform to change
+                FXMVECTOR offset
+                  Offset in the space of the parent
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::Translate(const TransformHandle& handle, DirectX::FXMVECTOR offset)
+    {
+        DirectX::XMFLOAT3& position = chunkOf(handle.uIndex).aPositions[handle.uIndex % CHUNK_SIZE];
+        DirectX::XMStoreFloat3(&position, DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&position), offset));
+
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::Scale
+      Summary:  Scales the local transform along its own axes and the
+                position about the parent origin. The scale is kept
+                apart from the rotation, so a non-uniform scale of a
+                rotated transform stays exact and a zero scale is kept
+                instead of being lost in a matrix that can't be
+                decomposed
+      Args:     const TransformHandle& handle
+                  Transform to change
+                FXMVECTOR scale
+                  Factor along each axis
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::Scale(const TransformHandle& handle, DirectX::FXMVECTOR scale)
+    {
+        Chunk& chunk = chunkOf(handle.uIndex);
+        uint32_t uSlot = handle.uIndex % CHUNK_SIZE;
+
+        DirectX::XMStoreFloat3(&chunk.aScales[uSlot], DirectX::XMVectorMultiply(DirectX::XMLoadFloat3(&chunk.aScales[uSlot]), scale));
+        DirectX::XMStoreFloat3(&chunk.aPositions[uSlot], DirectX::XMVectorMultiply(DirectX::XMLoadFloat3(&chunk.aPositions[uSlot]), scale));
+
+        markDirty(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetPosition
+      Summary:  Returns the position relative to the parent
+      Args:     const TransformHandle& handle
+                  Transform to read
+      Returns:  const XMFLOAT3&
+                  Local position
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DirectX::XMFLOAT3& TransformSystem::GetPosition(const TransformHandle& handle) const
+    {
+        return chunkOf(handle.uIndex).aPositions[handle.uIndex % CHUNK_SIZE];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetRotation
+      Summary:  Returns the rotation relative to the parent
+      Args:     const TransformHandle& handle
+                  Transform to read
+      Returns:  const XMFLOAT4&
+                  Local rotation quaternion
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DirectX::XMFLOAT4& TransformSystem::GetRotation(const TransformHandle& handle) const
+    {
+        return chunkOf(handle.uIndex).aRotations[handle.uIndex % CHUNK_SIZE];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetScale
+      Summary:  Returns the scale relative to the parent
+      Args:     const TransformHandle& handle
+                  Transform to read
+      Returns:  const XMFLOAT3&
+                  Local scale
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DirectX::XMFLOAT3& TransformSystem::GetScale(const TransformHandle& handle) const
+    {
+        return chunkOf(handle.uIndex).aScales[handle.uIndex % CHUNK_SIZE];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetLocalMatrix
+      Summary:  Returns the local transform, up to date even before the
+                next rebuild
+      Args:     const TransformHandle& handle
+                  Transform to read
+      Returns:  XMMATRIX
+                  Scale, then rotation, then translation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DirectX::XMMATRIX TransformSystem::GetLocalMatrix(const TransformHandle& handle) const
+    {
+        return composeLocal(handle.uIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetWorldMatrix
+      Summary:  Returns the world matrix as of the last rebuild
+      Args:     const TransformHandle& handle
+                  Transform to read
+      Returns:  const XMMATRIX&
+                  World matrix
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DirectX::XMMATRIX& TransformSystem::GetWorldMatrix(const TransformHandle& handle) const
+    {
+        return chunkOf(handle.uIndex).aWorlds[handle.uIndex % CHUNK_SIZE];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::UpdateWorldMatrices
+      Summary:  Rebuilds the world matrices of the dirty transforms and
+                of their descendants. A forward pass from the first
+                dirty slot collects the batch, marking a child dirty
+                when its parent is. The local matrices of the batch are
+                then built independently, split across the job system
+                when the batch is large, and a last pass in slot order
+                multiplies in the parent world matrices. Locks, so
+                Create and Destroy wait for the rebuild
+      Modifies: [m_apChunks, m_auBatch, m_uFirstDirty, m_uNumUpdated].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::UpdateWorldMatrices()
+    {
+        PROFILE_ZONE("TransformSystem::UpdateWorldMatrices");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_uNumUpdated = 0u;
+
+        uint32_t uFirstDirty = m_uFirstDirty.exchange(INVALID_INDEX);
+        if (uFirstDirty == INVALID_INDEX)
+        {
+            return;
+        }
+
+        m_auBatch.clear();
+        uint32_t uNumTransforms = m_uNumTransforms.load(std::memory_order_relaxed);
+        for (uint32_t i = uFirstDirty; i < uNumTransforms; ++i)
+        {
+            Chunk& chunk = chunkOf(i);
+            uint32_t uSlot = i % CHUNK_SIZE;
+            uint32_t uParent = chunk.auParents[uSlot];
+            if (chunk.aIsDirty[uSlot] || (uParent != INVALID_INDEX && chunkOf(uParent).aIsDirty[uParent % CHUNK_SIZE]))
+            {
+                chunk.aIsDirty[uSlot] = 1u;
+                m_auBatch.push_back(i);
+            }
+        }
+
+        uint32_t uBatchSize = static_cast<uint32_t>(m_auBatch.size());
+        auto buildLocals = [this](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                uint32_t uIndex = m_auBatch[i];
+                chunkOf(uIndex).aWorlds[uIndex % CHUNK_SIZE] = composeLocal(uIndex);
+            }
+        };
+
+        if (uBatchSize > PARALLEL_GRAIN_SIZE)
+        {
+            JobSystem::GetDefault().ParallelFor(uBatchSize, PARALLEL_GRAIN_SIZE, buildLocals);
+        }
+        else
+        {
+            buildLocals(0u, uBatchSize);
+        }
+
+        for (uint32_t uIndex : m_auBatch)
+        {
+            Chunk& chunk = chunkOf(uIndex);
+            uint32_t uSlot = uIndex % CHUNK_SIZE;
+            uint32_t uParent = chunk.auParents[uSlot];
+            if (uParent != INVALID_INDEX)
+            {
+                chunk.aWorlds[uSlot] = DirectX::XMMatrixMultiply(chunk.aWorlds[uSlot], chunkOf(uParent).aWorlds[uParent % CHUNK_SIZE]);
+            }
+        }
+
+        for (uint32_t uIndex : m_auBatch)
+        {
+            chunkOf(uIndex).aIsDirty[uIndex % CHUNK_SIZE] = 0u;
+        }
+
+        m_uNumUpdated = uBatchSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetNumTransforms
+      Summary:  Returns the number of slots, freed ones included
+      Returns:  uint32_t
+                  Number of slots
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TransformSystem::GetNumTransforms() const
+    {
+        return m_uNumTransforms.load(std::memory_order_acquire);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetNumUpdated
+      Summary:  Returns the number of world matrices the last rebuild
+                made
+      Returns:  uint32_t
+                  Size of the last batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TransformSystem::GetNumUpdated() const
+    {
+        return m_uNumUpdated;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::GetDefault
+      Summary:  Returns the transform system the renderables live in,
+                created on first use
+      Returns:  TransformSystem&
+                  Shared transform system
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformSystem& TransformSystem::GetDefault()
+    {
+        static TransformSystem transformSystem;
+        return transformSystem;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::chunkOf
+      Summary:  Returns the chunk a slot lives in
+      Args:     uint32_t uIndex
+                  Slot of the transform
+      Returns:  Chunk&
+                  Chunk holding the slot
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformSystem::Chunk& TransformSystem::chunkOf(uint32_t uIndex) const
+    {
+        return *m_apChunks[uIndex / CHUNK_SIZE];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::markDirty
+      Summary:  Flags a transform for the next rebuild and lowers the
+                slot the rebuild starts at
+      Args:     uint32_t uIndex
+                  Slot of the transform
+      Modifies: [m_apChunks, m_uFirstDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformSystem::markDirty(uint32_t uIndex)
+    {
+        chunkOf(uIndex).aIsDirty[uIndex % CHUNK_SIZE] = 1u;
+
+        uint32_t uFirstDirty = m_uFirstDirty.load(std::memory_order_relaxed);
+        while (uIndex < uFirstDirty && !m_uFirstDirty.compare_exchange_weak(uFirstDirty, uIndex, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformSystem::composeLocal
+      Summary:  Builds the local matrix straight from the rotation
+                matrix: the rows are scaled and the translation is
+                written in, instead of multiplying three matrices
+      Args:     uint32_t uIndex
+                  Slot of the transform
+      Returns:  XMMATRIX
+                  Scale, then rotation, then translation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DirectX::XMMATRIX TransformSystem::composeLocal(uint32_t uIndex) const
+    {
+        const Chunk& chunk = chunkOf(uIndex);
+        uint32_t uSlot = uIndex % CHUNK_SIZE;
+        DirectX::XMVECTOR scale = DirectX::XMLoadFloat3(&chunk.aScales[uSlot]);
+
+        DirectX::XMMATRIX local = DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&chunk.aRotations[uSlot]));
+        local.r[0] = DirectX::XMVectorMultiply(local.r[0], DirectX::XMVectorSplatX(scale));
+        local.r[1] = DirectX::XMVectorMultiply(local.r[1], DirectX::XMVectorSplatY(scale));
+        local.r[2] = DirectX::XMVectorMultiply(local.r[2], DirectX::XMVectorSplatZ(scale));
+        local.r[3] = DirectX::XMVectorSetW(DirectX::XMLoadFloat3(&chunk.aPositions[uSlot]), 1.0f);
+
+        return local;
+    }
+}
@@ -0,0 +1,171 @@
+/*+===================================================================
+  File:      TRANSFORMSYSTEM.H
+
+  Summary:   TransformSystem header file contains declaration of class
+             TransformSystem that stores the transforms of all objects
+             in contiguous arrays and rebuilds only the world matrices
+             that changed. It only depends on DirectXMath and the
+             standard library.
+
+  Classes:  TransformSystem
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TransformHandle
+      Summary:  Slot of a transform and the generation of the slot, so
+                a handle to a destroyed transform is detected when the
+                slot is reused
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TransformHandle
+    {
+        uint32_t uIndex;
+        uint32_t uGeneration;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TransformSystem
+      Summary:  Keeps positions, rotation quaternions, scales, parents
+                and cached world matrices in one array each, so a
+                rebuild walks memory linearly instead of chasing
+                objects. Setters only mark the transform dirty;
+                UpdateWorldMatrices rebuilds the dirty ones and their
+                descendants in one batch. A parent always has a lower
+                slot than its children, so one forward pass sees every
+                parent rebuilt before its children.
+                The arrays are split into chunks that never move once
+                allocated, so Create and Destroy, which lock, may run
+                while setters and getters on other live handles run on
+                other threads, and references returned by the getters
+                stay valid until the transform is destroyed. Setters on
+                different handles may run on different threads, but
+                not during UpdateWorldMatrices, which also locks
+      Methods:  Create
+                  Adds an identity transform
+                Destroy
+                  Frees a transform
+                IsValid
+                  Returns whether a handle refers to a live transform
+                SetPosition
+                  Changes the local position
+                SetRotation
+                  Changes the local rotation
+                SetScale
+                  Changes the local scale
+                SetLocalMatrix
+                  Changes the local transform from an affine matrix
+                Rotate
+                  Rotates the local transform about its parent origin
+                Scale
+                  Scales the local transform about its parent origin
+                Translate
+                  Moves the local transform
+                GetPosition
+                  Returns the local position
+                GetRotation
+                  Returns the local rotation
+                GetScale
+                  Returns the local scale
+                GetLocalMatrix
+                  Returns the local transform as a matrix
+                GetWorldMatrix
+                  Returns the world matrix of the last rebuild
+                UpdateWorldMatrices
+                  Rebuilds the world matrices that changed
+                GetNumTransforms
+                  Returns the number of slots
+                GetNumUpdated
+                  Returns the number of matrices the last rebuild made
+                GetDefault
+                  Returns the transform system shared by the library
+                TransformSystem
+                  Constructor.
+                ~TransformSystem
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TransformSystem
+    {
+    public:
+        static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+        static constexpr TransformHandle INVALID_HANDLE = { INVALID_INDEX, 0u };
+        static constexpr uint32_t PARALLEL_GRAIN_SIZE = 4096u;
+        static constexpr uint32_t CHUNK_SIZE = 4096u;
+        static constexpr uint32_t MAX_NUM_CHUNKS = 1024u;
+        static constexpr uint32_t MAX_NUM_TRANSFORMS = CHUNK_SIZE * MAX_NUM_CHUNKS;
+
+    public:
+        TransformSystem();
+        TransformSystem(const TransformSystem& other) = delete;
+        TransformSystem(TransformSystem&& other) = delete;
+        TransformSystem& operator=(const TransformSystem& other) = delete;
+        TransformSystem& operator=(TransformSystem&& other) = delete;
+        virtual ~TransformSystem() = default;
+
+        TransformHandle Create(const TransformHandle& parent = INVALID_HANDLE);
+        void Destroy(const TransformHandle& handle);
+        bool IsValid(const TransformHandle& handle) const;
+
+        void SetPosition(const TransformHandle& handle, const DirectX::XMFLOAT3& position);
+        void SetRotation(const TransformHandle& handle, const DirectX::XMFLOAT4& rotation);
+        void SetScale(const TransformHandle& handle, const DirectX::XMFLOAT3& scale);
+        void SetLocalMatrix(const TransformHandle& handle, DirectX::FXMMATRIX local);
+        void Rotate(const TransformHandle& handle, DirectX::FXMVECTOR rotation);
+        void Translate(const TransformHandle& handle, DirectX::FXMVECTOR offset);
+        void Scale(const TransformHandle& handle, DirectX::FXMVECTOR scale);
+
+        const DirectX::XMFLOAT3& GetPosition(const TransformHandle& handle) const;
+        const DirectX::XMFLOAT4& GetRotation(const TransformHandle& handle) const;
+        const DirectX::XMFLOAT3& GetScale(const TransformHandle& handle) const;
+        DirectX::XMMATRIX GetLocalMatrix(const TransformHandle& handle) const;
+        const DirectX::XMMATRIX& GetWorldMatrix(const TransformHandle& handle) const;
+
+        void UpdateWorldMatrices();
+        uint32_t GetNumTransforms() const;
+        uint32_t GetNumUpdated() const;
+
+        static TransformSystem& GetDefault();
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Chunk
+          Summary:  CHUNK_SIZE consecutive slots, one array per field
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Chunk
+        {
+            DirectX::XMMATRIX aWorlds[CHUNK_SIZE];
+            DirectX::XMFLOAT3 aPositions[CHUNK_SIZE];
+            DirectX::XMFLOAT4 aRotations[CHUNK_SIZE];
+            DirectX::XMFLOAT3 aScales[CHUNK_SIZE];
+            uint32_t auParents[CHUNK_SIZE];
+            uint32_t auGenerations[CHUNK_SIZE];
+            uint8_t aIsDirty[CHUNK_SIZE];
+        };
+
+    private:
+        Chunk& chunkOf(uint32_t uIndex) const;
+        void markDirty(uint32_t uIndex);
+        DirectX::XMMATRIX composeLocal(uint32_t uIndex) const;
+
+    private:
+        std::array<std::unique_ptr<Chunk>, MAX_NUM_CHUNKS> m_apChunks;
+        std::atomic<uint32_t> m_uNumTransforms;
+        std::vector<uint32_t> m_auFreeIndices;
+        std::vector<uint32_t> m_auBatch;
+        std::atomic<uint32_t> m_uFirstDirty;
+        uint32_t m_uNumUpdated;
+        std::mutex m_mutex;
+    };
+}
@@ -0,0 +1,295 @@
+#include "Renderer/VertexCompression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "Renderer/TangentGenerator.h"
+
+namespace library
+{
+    using namespace DirectX;
+    using namespace DirectX::PackedVector;
+
+    // Bone indices are stored in a byte
+    static_assert(MAX_NUM_BONES <= 256, "Bone indices do not fit in PackedAnimationData");
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::ComputePositionBounds
+      Summary:  Returns the bounding box of the vertices as the scale
+                and offset that decode a quantized position. An axis
+                without extent keeps a scale of 0 and decodes to the
+                offset
+      Args:     const SimpleVertex* aVertices
+                  Vertices
+                uint32_t uNumVertices
+                  Number of vertices
+                XMFLOAT4& outScale
+                  Size of the box, w is 0
+                XMFLOAT4& outOffset
+                  Minimum corner of the box, w is 0
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexCompression::ComputePositionBounds(const SimpleVertex* aVertices, uint32_t uNumVertices, XMFLOAT4& outScale, XMFLOAT4& outOffset)
+    {
+        outScale = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+        outOffset = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+        if (uNumVertices == 0u)
+        {
+            return;
+        }
+
+        XMVECTOR minimum = XMLoadFloat3(&aVertices[0].Position);
+        XMVECTOR maximum = minimum;
+        for (uint32_t i = 1u; i < uNumVertices; ++i)
+        {
+            XMVECTOR position = XMLoadFloat3(&aVertices[i].Position);
+            minimum = XMVectorMin(minimum, position);
+            maximum = XMVectorMax(maximum, position);
+        }
+
+        XMFLOAT3 extent;
+        XMFLOAT3 corner;
+        XMStoreFloat3(&extent, XMVectorSubtract(maximum, minimum));
+        XMStoreFloat3(&corner, minimum);
+
+        outScale = XMFLOAT4(extent.x, extent.y, extent.z, 0.0f);
+        outOffset = XMFLOAT4(corner.x, corner.y, corner.z, 0.0f);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::PackVertex
+      Summary:  Encodes a vertex
+      Args:     const SimpleVertex& vertex
+                  Vertex
+                const XMFLOAT4& scale
+                  Decode scale of the model
+                const XMFLOAT4& offset
+                  Decode offset of the model
+      Returns:  PackedVertex
+                  Encoded vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedVertex VertexCompression::PackVertex(const SimpleVertex& vertex, const XMFLOAT4& scale, const XMFLOAT4& offset)
+    {
+        XMFLOAT4 position(
+            scale.x > 0.0f ? (vertex.Position.x - offset.x) / scale.x : 0.0f,
+            scale.y > 0.0f ? (vertex.Position.y - offset.y) / scale.y : 0.0f,
+            scale.z > 0.0f ? (vertex.Position.z - offset.z) / scale.z : 0.0f,
+            1.0f
+        );
+        XMFLOAT2 normal = EncodeOctahedral(vertex.Normal);
+
+        PackedVertex packedVertex;
+        XMStoreUShortN4(&packedVertex.Position, XMLoadFloat4(&position));
+        XMStoreHalf2(&packedVertex.TexCoord, XMLoadFloat2(&vertex.TexCoord));
+        XMStoreShortN2(&packedVertex.Normal, XMLoadFloat2(&normal));
+
+        return packedVertex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::UnpackVertex
+      Summary:  Decodes a vertex
+      Args:     const PackedVertex& packedVertex
+                  Encoded vertex
+                const XMFLOAT4& scale
+                  Decode scale of the model
+                const XMFLOAT4& offset
+                  Decode offset of the model
+      Returns:  SimpleVertex
+                  Vertex, with a unit normal
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SimpleVertex VertexCompression::UnpackVertex(const PackedVertex& packedVertex, const XMFLOAT4& scale, const XMFLOAT4& offset)
+    {
+        XMVECTOR position = XMVectorMultiplyAdd(XMLoadUShortN4(&packedVertex.Position), XMLoadFloat4(&scale), XMLoadFloat4(&offset));
+
+        XMFLOAT2 normal;
+        XMStoreFloat2(&normal, XMLoadShortN2(&packedVertex.Normal));
+
+        SimpleVertex vertex;
+        XMStoreFloat3(&vertex.Position, position);
+        XMStoreFloat2(&vertex.TexCoord, XMLoadHalf2(&packedVertex.TexCoord));
+        vertex.Normal = DecodeOctahedral(normal);
+
+        return vertex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::PackNormalData
+      Summary:  Encodes the tangent and the side of the normal the
+                bitangent lies on. Its length and angle are dropped,
+                the shaders only use its direction
+      Args:     const XMFLOAT3& normal
+                  Normal of the vertex
+                const NormalData& normalData
+                  Tangent and bitangent of the vertex
+      Returns:  PackedNormalData
+                  Encoded tangent frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedNormalData VertexCompression::PackNormalData(const XMFLOAT3& normal, const NormalData& normalData)
+    {
+        float sign = TangentGenerator::GetHandedness(normal, normalData) * 0.5f + 0.5f;
+
+        XMFLOAT2 tangent = EncodeOctahedral(normalData.Tangent);
+
+        PackedNormalData packedNormalData;
+        XMStoreUDecN4(&packedNormalData.Tangent, XMVectorSet(tangent.x * 0.5f + 0.5f, tangent.y * 0.5f + 0.5f, 0.0f, sign));
+
+        return packedNormalData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::UnpackNormalData
+      Summary:  Decodes a tangent frame. The bitangent is rebuilt from
+                the normal the shader sees, so it is unit length and
+                orthogonal to it
+      Args:     const XMFLOAT3& normal
+                  Decoded normal of the vertex
+                const PackedNormalData& packedNormalData
+                  Encoded tangent frame
+      Returns:  NormalData
+                  Unit tangent and bitangent
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    NormalData VertexCompression::UnpackNormalData(const XMFLOAT3& normal, const PackedNormalData& packedNormalData)
+    {
+        XMFLOAT4 packedTangent;
+        XMStoreFloat4(&packedTangent, XMLoadUDecN4(&packedNormalData.Tangent));
+
+        NormalData normalData;
+        normalData.Tangent = DecodeOctahedral(XMFLOAT2(packedTangent.x * 2.0f - 1.0f, packedTangent.y * 2.0f - 1.0f));
+
+        XMVECTOR bitangent = XMVector3Cross(XMLoadFloat3(&normal), XMLoadFloat3(&normalData.Tangent));
+        XMStoreFloat3(&normalData.Bitangent, XMVectorScale(XMVector3Normalize(bitangent), packedTangent.w * 2.0f - 1.0f));
+
+        return normalData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::PackAnimationData
+      Summary:  Encodes the bone indices and weights. The weights are
+                normalized and rounded, and the rounding error is moved
+                to the largest one, so a skinned vertex never grows or
+                shrinks
+      Args:     const AnimationData& animationData
+                  Bone indices, below MAX_NUM_BONES, and weights
+      Returns:  PackedAnimationData
+                  Encoded bone indices and weights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PackedAnimationData VertexCompression::PackAnimationData(const AnimationData& animationData)
+    {
+        const uint32_t auIndices[4] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+        const float aWeights[4] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+
+        float sum = 0.0f;
+        uint32_t uLargest = 0u;
+        for (uint32_t i = 0u; i < 4u; ++i)
+        {
+            assert(auIndices[i] < MAX_NUM_BONES);
+
+            sum += (std::max)(aWeights[i], 0.0f);
+            if (aWeights[i] > aWeights[uLargest])
+            {
+                uLargest = i;
+            }
+        }
+
+        int32_t aQuantized[4] = { 0, 0, 0, 0 };
+        if (sum > 0.0f)
+        {
+            int32_t total = 0;
+            for (uint32_t i = 0u; i < 4u; ++i)
+            {
+                aQuantized[i] = static_cast<int32_t>(std::lround((std::max)(aWeights[i], 0.0f) * 255.0f / sum));
+                total += aQuantized[i];
+            }
+
+            aQuantized[uLargest] += 255 - total;
+        }
+
+        PackedAnimationData packedAnimationData;
+        packedAnimationData.aBoneIndices.x = static_cast<uint8_t>(auIndices[0]);
+        packedAnimationData.aBoneIndices.y = static_cast<uint8_t>(auIndices[1]);
+        packedAnimationData.aBoneIndices.z = static_cast<uint8_t>(auIndices[2]);
+        packedAnimationData.aBoneIndices.w = static_cast<uint8_t>(auIndices[3]);
+        packedAnimationData.aBoneWeights.x = static_cast<uint8_t>(aQuantized[0]);
+        packedAnimationData.aBoneWeights.y = static_cast<uint8_t>(aQuantized[1]);
+        packedAnimationData.aBoneWeights.z = static_cast<uint8_t>(aQuantized[2]);
+        packedAnimationData.aBoneWeights.w = static_cast<uint8_t>(aQuantized[3]);
+
+        return packedAnimationData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::UnpackAnimationData
+      Summary:  Decodes the bone indices and weights
+      Args:     const PackedAnimationData& packedAnimationData
+                  Encoded bone indices and weights
+      Returns:  AnimationData
+                  Bone indices and weights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AnimationData VertexCompression::UnpackAnimationData(const PackedAnimationData& packedAnimationData)
+    {
+        AnimationData animationData;
+        animationData.aBoneIndices = XMUINT4(
+            packedAnimationData.aBoneIndices.x,
+            packedAnimationData.aBoneIndices.y,
+            packedAnimationData.aBoneIndices.z,
+            packedAnimationData.aBoneIndices.w
+        );
+        XMStoreFloat4(&animationData.aBoneWeights, XMLoadUByteN4(&packedAnimationData.aBoneWeights));
+
+        return animationData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::EncodeOctahedral
+      Summary:  Projects a direction on the octahedron |x|+|y|+|z| = 1
+                and unfolds the lower half over the corners of the
+                square
+      Args:     const XMFLOAT3& direction
+                  Direction, of any length
+      Returns:  XMFLOAT2
+                  Point of [-1, 1]^2. A zero direction maps to the
+                  center, which decodes to +z
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT2 VertexCompression::EncodeOctahedral(const XMFLOAT3& direction)
+    {
+        float length = std::fabs(direction.x) + std::fabs(direction.y) + std::fabs(direction.z);
+        if (length <= 0.0f)
+        {
+            return XMFLOAT2(0.0f, 0.0f);
+        }
+
+        float x = direction.x / length;
+        float y = direction.y / length;
+        if (direction.z < 0.0f)
+        {
+            float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldedX;
+            y = foldedY;
+        }
+
+        return XMFLOAT2(x, y);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexCompression::DecodeOctahedral
+      Summary:  Inverse of EncodeOctahedral, as in the shaders
+      Args:     const XMFLOAT2& encoded
+                  Point of [-1, 1]^2
+      Returns:  XMFLOAT3
+                  Unit direction
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT3 VertexCompression::DecodeOctahedral(const XMFLOAT2& encoded)
+    {
+        XMFLOAT3 direction(encoded.x, encoded.y, 1.0f - std::fabs(encoded.x) - std::fabs(encoded.y));
+
+        float fold = (std::max)(-direction.z, 0.0f);
+        direction.x += direction.x >= 0.0f ? -fold : fold;
+        direction.y += direction.y >= 0.0f ? -fold : fold;
+
+        XMStoreFloat3(&direction, XMVector3Normalize(XMLoadFloat3(&direction)));
+
+        return direction;
+    }
+}
@@ -0,0 +1,111 @@
+/*+===================================================================
+  File:      VERTEXCOMPRESSION.H
+
+  Summary:   VertexCompression header file contains declarations of the
+             packed vertex formats and of class VertexCompression used
+             to encode the vertex streams of a model in them. It only
+             depends on DirectXMath and the standard library.
+
+  Classes:  PackedVertex, PackedNormalData, PackedAnimationData,
+            VertexCompression
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+#include <DirectXPackedVector.h>
+
+#include "Renderer/VertexTypes.h"
+#include "Shaders/ShaderConstants.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   PackedVertex
+      Summary:  SimpleVertex in 16 bytes. The position is quantized to
+                16 bits per axis inside the bounding box of the model,
+                w is always one. The texture coordinates are half
+                floats and the normal is an octahedral direction
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct PackedVertex
+    {
+        DirectX::PackedVector::XMUSHORTN4 Position;
+        DirectX::PackedVector::XMHALF2 TexCoord;
+        DirectX::PackedVector::XMSHORTN2 Normal;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   PackedNormalData
+      Summary:  NormalData in 4 bytes. x and y hold the octahedral
+                tangent, w whether the bitangent is cross(normal,
+                tangent) or its opposite
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct PackedNormalData
+    {
+        DirectX::PackedVector::XMUDECN4 Tangent;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   PackedAnimationData
+      Summary:  AnimationData in 8 bytes. The weights are rounded so
+                that they still add up to exactly 255
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct PackedAnimationData
+    {
+        DirectX::PackedVector::XMUBYTE4 aBoneIndices;
+        DirectX::PackedVector::XMUBYTEN4 aBoneWeights;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VertexCompression
+      Summary:  Encodes vertices in the packed formats, and decodes them
+                back the way the PACKED_VERTICES permutation of the
+                shaders does, so the error can be measured on the CPU.
+                The position is decoded as scale * position + offset
+                with the values of ComputePositionBounds
+      Methods:  ComputePositionBounds
+                  Returns the decode scale and offset of a model
+                PackVertex
+                  Encodes a vertex
+                UnpackVertex
+                  Decodes a vertex
+                PackNormalData
+                  Encodes a tangent frame
+                UnpackNormalData
+                  Decodes a tangent frame
+                PackAnimationData
+                  Encodes bone indices and weights
+                UnpackAnimationData
+                  Decodes bone indices and weights
+                EncodeOctahedral
+                  Maps a direction to the unit square
+                DecodeOctahedral
+                  Maps the unit square to a direction
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VertexCompression
+    {
+    public:
+        VertexCompression() = delete;
+        VertexCompression(const VertexCompression& other) = delete;
+        VertexCompression(VertexCompression&& other) = delete;
+        VertexCompression& operator=(const VertexCompression& other) = delete;
+        VertexCompression& operator=(VertexCompression&& other) = delete;
+        ~VertexCompression() = delete;
+
+        static void ComputePositionBounds(const SimpleVertex* aVertices, uint32_t uNumVertices, DirectX::XMFLOAT4& outScale, DirectX::XMFLOAT4& outOffset);
+
+        static PackedVertex PackVertex(const SimpleVertex& vertex, const DirectX::XMFLOAT4& scale, const DirectX::XMFLOAT4& offset);
+        static SimpleVertex UnpackVertex(const PackedVertex& packedVertex, const DirectX::XMFLOAT4& scale, const DirectX::XMFLOAT4& offset);
+
+        static PackedNormalData PackNormalData(const DirectX::XMFLOAT3& normal, const NormalData& normalData);
+        static NormalData UnpackNormalData(const DirectX::XMFLOAT3& normal, const PackedNormalData& packedNormalData);
+
+        static PackedAnimationData PackAnimationData(const AnimationData& animationData);
+        static AnimationData UnpackAnimationData(const PackedAnimationData& packedAnimationData);
+
+        static DirectX::XMFLOAT2 EncodeOctahedral(const DirectX::XMFLOAT3& direction);
+        static DirectX::XMFLOAT3 DecodeOctahedral(const DirectX::XMFLOAT2& encoded);
+    };
+}
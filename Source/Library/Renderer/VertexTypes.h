@@ -0,0 +1,43 @@
+/*+===================================================================
+  File:      VERTEXTYPES.H
+
+  Summary:   VertexTypes header file contains the vertex layouts shared
+             by the renderer and the CPU-side geometry code. It only
+             depends on DirectXMath.
+
+  Classes:  SimpleVertex, AnimationData, NormalData, BoneTransform3x4
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <DirectXMath.h>
+
+namespace library
+{
+    struct SimpleVertex
+    {
+        DirectX::XMFLOAT3 Position;
+        DirectX::XMFLOAT2 TexCoord;
+        DirectX::XMFLOAT3 Normal;
+    };
+
+    struct AnimationData
+    {
+        DirectX::XMUINT4 aBoneIndices;
+        DirectX::XMFLOAT4 aBoneWeights;
+    };
+
+    struct NormalData
+    {
+        DirectX::XMFLOAT3 Tangent;
+        DirectX::XMFLOAT3 Bitangent;
+    };
+
+    // Affine bone transform of a skinning palette: the first three rows of
+    // the transposed matrix, whose last row is always (0, 0, 0, 1)
+    struct BoneTransform3x4
+    {
+        DirectX::XMFLOAT4 Rows[3];
+    };
+}
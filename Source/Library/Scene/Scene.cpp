@@ -1,6 +1,10 @@
 #include "Scene/Scene.h"
 
+#include <algorithm>
+
 #include "Shader/SkyMapVertexShader.h"
+#include "Utility/Profiler.h"
+#include "Utility/TaskGraph.h"
 
 namespace library
 {
@@ -26,15 +30,60 @@ namespace library
 
     Scene::Scene(const std::filesystem::path& filePath)
         : m_filePath(filePath)
+        , m_voxelWorld(std::make_shared<VoxelWorld>())
+        , m_aChunkVoxels()
+        , m_voxelPrototype(std::make_shared<Voxel>(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)))
         , m_voxels()
+        , m_aOccluders()
         , m_renderables()
+        , m_aStaticBatches()
         , m_aPointLights{ nullptr }
         , m_vertexShaders()
         , m_pixelShaders()
         , m_skyBox()
+        , m_textureCache()
     {
+        std::vector<std::vector<VoxelMesh>> aChunkMeshes;
+        LoadVoxels(m_filePath, *m_voxelWorld, aChunkMeshes, m_aOccluders);
+        createVoxels(*m_voxelWorld, std::move(aChunkMeshes), m_aChunkVoxels);
+
+        for (const std::vector<std::shared_ptr<Voxel>>& aVoxels : m_aChunkVoxels)
+        {
+            m_voxels.insert(m_voxels.end(), aVoxels.begin(), aVoxels.end());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::LoadVoxels
+      Summary:  Reads the dimensions, block colors and heights of a
+                scene file into a voxel world, and meshes every chunk
+                into one mesh per block type it shows. The columns of
+                blocks are also merged into solid boxes for occlusion
+                culling. No scene object is created, so this may run
+                off the main thread
+      Args:     const std::filesystem::path& filePath
+                  Path to the scene file
+                VoxelWorld& outWorld
+                  Receives the blocks of the scene
+                std::vector<std::vector<VoxelMesh>>& aOutChunkMeshes
+                  Meshes of every chunk
+                std::vector<AxisAlignedBox>& aOutOccluders
+                  Boxes that the blocks fill entirely
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::LoadVoxels(_In_ const std::filesystem::path& filePath, _Out_ VoxelWorld& outWorld, _Out_ std::vector<std::vector<VoxelMesh>>& aOutChunkMeshes, _Out_ std::vector<AxisAlignedBox>& aOutOccluders)
+    {
+        outWorld.Resize(0u, 0u, 0u);
+        aOutChunkMeshes.clear();
+        aOutOccluders.clear();
+
         std::ifstream inputFile;
-        inputFile.open(m_filePath.string());
+        inputFile.open(filePath.string());
+        if (!inputFile)
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
 
         std::string trash;
         UINT aDimension[4] = { 0u, };
@@ -58,6 +107,8 @@ namespace library
             }
         }
 
+        outWorld.Resize(aDimension[0], aDimension[1], aDimension[2]);
+
         UINT uColorIdx = 0u;
         XMFLOAT4 color;
         while (!inputFile.eof() && uColorIdx < aDimension[3])
@@ -76,21 +127,14 @@ namespace library
             else
             {
                 color.w = 1.0f;
-                m_voxels.push_back(std::make_shared<Voxel>(color));
+                if (uColorIdx < VoxelWorld::NUM_BLOCK_TYPES)
+                {
+                    outWorld.SetBlockColor(static_cast<eBlockType>(static_cast<UINT>(eBlockType::GRASSLAND) + uColorIdx), color);
+                }
                 ++uColorIdx;
             }
         }
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
-        aInstanceData.reserve(m_voxels.size());
-        for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
-        {
-            aInstanceData.push_back(std::vector<InstanceData>());
-            aInstanceData.back().reserve(
-                static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
-            );
-        }
-
         UINT uDepthIdx = 0u;
         UINT uWidthIdx = 0u;
         CHAR voxelType;
@@ -112,16 +156,7 @@ namespace library
             {
                 for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
                 {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
-                        InstanceData
-                        {
-                            .Transformation = XMMatrixTranslation(
-                                2.0f * (static_cast<FLOAT>(uWidthIdx) - static_cast<FLOAT>(aDimension[0]) / 2.0f),
-                                2.0f * (static_cast<FLOAT>(heightIdx) - static_cast<FLOAT>(aDimension[1])) + (static_cast<FLOAT>(aDimension[1]) * 0.75f),
-                                2.0f * (static_cast<FLOAT>(uDepthIdx) - static_cast<FLOAT>(aDimension[2]) / 2.0f)
-                                )
-                        }
-                    );
+                    outWorld.SetBlock(static_cast<INT>(uWidthIdx), static_cast<INT>(heightIdx), static_cast<INT>(uDepthIdx), static_cast<eBlockType>(voxelType));
                 }
                 ++uWidthIdx;
                 if (uWidthIdx >= aDimension[0])
@@ -139,27 +174,199 @@ namespace library
 
         inputFile.close();
 
-        UINT uVoxelIdx = 0u;
-        auto it = m_voxels.begin();
-        while (it != m_voxels.end())
+        buildOccluders(outWorld, aOutOccluders);
+
+        std::vector<UINT> auChunks;
+        outWorld.TakeDirtyChunks(auChunks);
+        meshChunks(outWorld, auChunks, aOutChunkMeshes);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::initializeVoxels
+      Summary:  Gives chunk voxels the materials of the voxel prototype
+                and creates their buffers on the job system
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                const std::vector<std::vector<std::shared_ptr<Voxel>>>& aChunkVoxels
+                  Voxels of the chunks
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::initializeVoxels(_In_ ID3D11Device* pDevice, _In_ const std::vector<std::vector<std::shared_ptr<Voxel>>>& aChunkVoxels)
+    {
+        std::vector<HRESULT> aResults(aChunkVoxels.size(), S_OK);
+        JobSystem::GetDefault().ParallelFor(static_cast<uint32_t>(aChunkVoxels.size()), CHUNK_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
         {
-            if (aInstanceData[uVoxelIdx].size() <= 0)
+            for (uint32_t i = uBegin; i < uEnd && SUCCEEDED(aResults[i]); ++i)
             {
-                it = m_voxels.erase(it);
+                for (const std::shared_ptr<Voxel>& voxel : aChunkVoxels[i])
+                {
+                    for (UINT uMaterial = 0u; uMaterial < m_voxelPrototype->GetNumMaterials(); ++uMaterial)
+                    {
+                        voxel->AddMaterial(m_voxelPrototype->GetMaterial(uMaterial));
+                    }
+
+                    aResults[i] = voxel->Initialize(pDevice, nullptr);
+                    if (FAILED(aResults[i]))
+                    {
+                        break;
+                    }
+                }
             }
-            else
+        });
+
+        for (HRESULT hr : aResults)
+        {
+            if (FAILED(hr))
             {
-                (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
-                ++it;
+                return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::meshChunks
+      Summary:  Meshes chunks of a voxel world on the job system
+      Args:     const VoxelWorld& world
+                  World to mesh
+                const std::vector<UINT>& auChunks
+                  Indices of the chunks to mesh
+                std::vector<std::vector<VoxelMesh>>& aOutChunkMeshes
+                  Receives the meshes of every chunk, in the order of
+                  auChunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::meshChunks(_In_ const VoxelWorld& world, _In_ const std::vector<UINT>& auChunks, _Out_ std::vector<std::vector<VoxelMesh>>& aOutChunkMeshes)
+    {
+        aOutChunkMeshes.assign(auChunks.size(), std::vector<VoxelMesh>());
+
+        JobSystem::GetDefault().ParallelFor(static_cast<uint32_t>(auChunks.size()), CHUNK_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            PROFILE_ZONE("MeshChunks");
+
+            for (uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                world.MeshChunk(auChunks[i], aOutChunkMeshes[i]);
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::createVoxels
+      Summary:  Creates one voxel per chunk mesh, colored by its block
+                type. Every voxel creates a transform, so this must not
+                run while a frame reads them. The voxels are not
+                initialized
+      Args:     const VoxelWorld& world
+                  World the meshes were built from
+                std::vector<std::vector<VoxelMesh>>&& aChunkMeshes
+                  Meshes of every chunk, moved into the voxels
+                std::vector<std::vector<std::shared_ptr<Voxel>>>& aOutChunkVoxels
+                  Receives the voxels of every chunk, in the order of
+                  aChunkMeshes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::createVoxels(_In_ const VoxelWorld& world, _In_ std::vector<std::vector<VoxelMesh>>&& aChunkMeshes, _Out_ std::vector<std::vector<std::shared_ptr<Voxel>>>& aOutChunkVoxels)
+    {
+        aOutChunkVoxels.assign(aChunkMeshes.size(), std::vector<std::shared_ptr<Voxel>>());
+
+        JobSystem::GetDefault().ParallelFor(static_cast<uint32_t>(aChunkMeshes.size()), CHUNK_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                for (VoxelMesh& mesh : aChunkMeshes[i])
+                {
+                    aOutChunkVoxels[i].push_back(std::make_shared<Voxel>(std::move(mesh.aVertices), std::move(mesh.aIndices), std::move(mesh.aAmbientOcclusion), world.GetBlockColor(mesh.blockType)));
+                }
+            }
+        });
+
+        aChunkMeshes.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::buildOccluders
+      Summary:  Greedily merges neighbouring columns of the same height
+                into rectangles, first along the width then along the
+                depth, and returns the box each rectangle fills, in
+                world space. A column only counts the blocks it stacks
+                without a gap from the floor
+      Args:     const VoxelWorld& world
+                  Blocks of the scene
+                std::vector<AxisAlignedBox>& aOutOccluders
+                  Receives the boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::buildOccluders(_In_ const VoxelWorld& world, _Out_ std::vector<AxisAlignedBox>& aOutOccluders)
+    {
+        aOutOccluders.clear();
+
+        const UINT aDimension[3] = { world.GetWidth(), world.GetHeight(), world.GetDepth() };
+        const UINT uWidth = aDimension[0];
+        const UINT uDepth = aDimension[2];
+
+        std::vector<UINT> auColumnHeights;
+        world.GetColumnHeights(auColumnHeights);
+        std::vector<BOOL> abIsMerged(auColumnHeights.size(), FALSE);
+
+        for (UINT z = 0u; z < uDepth; ++z)
+        {
+            for (UINT x = 0u; x < uWidth; ++x)
+            {
+                UINT uHeight = auColumnHeights[z * uWidth + x];
+                if (uHeight == 0u || abIsMerged[z * uWidth + x])
+                {
+                    continue;
+                }
+
+                UINT uEndX = x + 1u;
+                while (uEndX < uWidth && auColumnHeights[z * uWidth + uEndX] == uHeight && !abIsMerged[z * uWidth + uEndX])
+                {
+                    ++uEndX;
+                }
+
+                UINT uEndZ = z + 1u;
+                for (; uEndZ < uDepth; ++uEndZ)
+                {
+                    BOOL bIsRowEqual = TRUE;
+                    for (UINT uX = x; uX < uEndX && bIsRowEqual; ++uX)
+                    {
+                        bIsRowEqual = auColumnHeights[uEndZ * uWidth + uX] == uHeight && !abIsMerged[uEndZ * uWidth + uX];
+                    }
+
+                    if (!bIsRowEqual)
+                    {
+                        break;
+                    }
+                }
+
+                for (UINT uZ = z; uZ < uEndZ; ++uZ)
+                {
+                    std::fill(abIsMerged.begin() + uZ * uWidth + x, abIsMerged.begin() + uZ * uWidth + uEndX, TRUE);
+                }
+
+                // Block (x, y, z) is the cube of half size 1 around VoxelWorld::GetBlockCenter
+                FLOAT minX = 2.0f * (static_cast<FLOAT>(x) - static_cast<FLOAT>(uWidth) / 2.0f) - 1.0f;
+                FLOAT maxX = 2.0f * (static_cast<FLOAT>(uEndX - 1u) - static_cast<FLOAT>(uWidth) / 2.0f) + 1.0f;
+                FLOAT minY = 2.0f * -static_cast<FLOAT>(aDimension[1]) + static_cast<FLOAT>(aDimension[1]) * 0.75f - 1.0f;
+                FLOAT maxY = 2.0f * (static_cast<FLOAT>(uHeight - 1u) - static_cast<FLOAT>(aDimension[1])) + static_cast<FLOAT>(aDimension[1]) * 0.75f + 1.0f;
+                FLOAT minZ = 2.0f * (static_cast<FLOAT>(z) - static_cast<FLOAT>(uDepth) / 2.0f) - 1.0f;
+                FLOAT maxZ = 2.0f * (static_cast<FLOAT>(uEndZ - 1u) - static_cast<FLOAT>(uDepth) / 2.0f) + 1.0f;
+
+                aOutOccluders.push_back(AxisAlignedBox{
+                    .Center = XMFLOAT3(0.5f * (minX + maxX), 0.5f * (minY + maxY), 0.5f * (minZ + maxZ)),
+                    .Extents = XMFLOAT3(0.5f * (maxX - minX), 0.5f * (maxY - minY), 0.5f * (maxZ - minZ))
+                });
             }
-            ++uVoxelIdx;
         }
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::Initialize
       Summary:  Initializes the voxels, shaders, renderables, models,
-                and skybox
+                and skybox, and merges the static renderables into
+                static batches
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
@@ -178,7 +385,7 @@ namespace library
 
         for (auto it = m_vertexShaders.begin(); it != m_vertexShaders.end(); ++it)
         {
-            HRESULT hr = it->second->Initialize(pDevice);
+            HRESULT hr = (*it)->Initialize(pDevice);
             if (FAILED(hr))
             {
                 return hr;
@@ -187,7 +394,7 @@ namespace library
 
         for (auto it = m_pixelShaders.begin(); it != m_pixelShaders.end(); ++it)
         {
-            HRESULT hr = it->second->Initialize(pDevice);
+            HRESULT hr = (*it)->Initialize(pDevice);
             if (FAILED(hr))
             {
                 return hr;
@@ -196,30 +403,38 @@ namespace library
 
         for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+            HRESULT hr = (*it)->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
             }
         }
 
+        HRESULT hr = buildStaticBatches(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
         for (auto it = m_models.begin(); it != m_models.end(); ++it)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+            (*it)->SetTextureCache(m_textureCache);
+
+            HRESULT hr = (*it)->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
             }
 
-            for (int i = 0; i < it->second->GetNumMaterials(); ++i)
+            for (int i = 0; i < (*it)->GetNumMaterials(); ++i)
             {
-                AddMaterial(it->second->GetMaterial(i));
+                AddMaterial((*it)->GetMaterial(i));
             }
         }
 
         for (auto it = m_materials.begin(); it != m_materials.end(); ++it)
         {
-            HRESULT hr = it->second->Initialize(pDevice, pImmediateContext);
+            HRESULT hr = (*it)->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
@@ -228,6 +443,8 @@ namespace library
 
         if (m_skyBox)
         {
+            m_skyBox->SetTextureCache(m_textureCache);
+
             HRESULT hr = m_skyBox->Initialize(pDevice, pImmediateContext);
 
             if (FAILED(hr))
@@ -268,13 +485,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable)
     {
-        if (m_renderables.contains(pszRenderableName))
+        if (m_renderables.Add(StringId::Intern(pszRenderableName), renderable) == INVALID_RESOURCE_HANDLE)
         {
             return E_FAIL;
         }
 
-        m_renderables[pszRenderableName] = renderable;
-
         return S_OK;
     }
 
@@ -291,13 +506,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel)
     {
-        if (m_models.contains(pszModelName))
+        if (m_models.Add(StringId::Intern(pszModelName), pModel) == INVALID_RESOURCE_HANDLE)
         {
             return E_FAIL;
         }
 
-        m_models[pszModelName] = pModel;
-
         return S_OK;
     }
 
@@ -339,13 +552,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader)
     {
-        if (m_vertexShaders.contains(pszVertexShaderName))
+        if (m_vertexShaders.Add(StringId::Intern(pszVertexShaderName), vertexShader) == INVALID_RESOURCE_HANDLE)
         {
             return E_FAIL;
         }
 
-        m_vertexShaders[pszVertexShaderName] = vertexShader;
-
         return S_OK;
     }
 
@@ -362,25 +573,21 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader)
     {
-        if (m_pixelShaders.contains(pszPixelShaderName))
+        if (m_pixelShaders.Add(StringId::Intern(pszPixelShaderName), pixelShader) == INVALID_RESOURCE_HANDLE)
         {
             return E_FAIL;
         }
 
-        m_pixelShaders[pszPixelShaderName] = pixelShader;
-
         return S_OK;
     }
 
     HRESULT Scene::AddMaterial(_In_ const std::shared_ptr<Material>& material)
     {
-        if (m_materials.contains(material->GetName()))
+        if (m_materials.Add(StringId::Intern(material->GetName()), material) == INVALID_RESOURCE_HANDLE)
         {
             return E_FAIL;
         }
 
-        m_materials[material->GetName()] = material;
-
         return S_OK;
     }
 
@@ -409,28 +616,244 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::Update
       Summary:  Update the renderables, models, point lights, skybox
-                each frame
+                each simulation tick, as tasks on the job system, then
+                rebuilds the world matrices that changed. The state
+                before the tick is kept so rendering can interpolate
       Args:     FLOAT deltaTime
-                  Time difference of a frame
+                  Length of a tick
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Scene::Update(_In_ FLOAT deltaTime)
     {
+        PROFILE_ZONE("Scene::Update");
+
+        std::vector<Renderable*> apRenderables;
+        apRenderables.reserve(m_renderables.GetSize());
         for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
         {
-            it->second->Update(deltaTime);
+            // Static renderables are drawn from their batch, moving them would change nothing
+            if (!(*it)->IsStatic())
+            {
+                apRenderables.push_back(it->get());
+            }
         }
 
+        std::vector<Model*> apModels;
+        apModels.reserve(m_models.GetSize());
         for (auto it = m_models.begin(); it != m_models.end(); ++it)
         {
-            it->second->Update(deltaTime);
+            apModels.push_back(it->get());
         }
 
-        for (UINT lightIdx = 0; lightIdx < NUM_LIGHTS; ++lightIdx)
+        // Every object only writes its own state, so the objects are
+        // split across the workers and the stages overlap
+        JobSystem& jobSystem = JobSystem::GetDefault();
+        TaskGraph updateGraph;
+
+        uint32_t uUpdateObjects = updateGraph.AddTask("UpdateObjects", [&]()
+        {
+            jobSystem.ParallelFor(static_cast<uint32_t>(apRenderables.size()), UPDATE_GRAIN_SIZE, [&](uint32_t uBegin, uint32_t uEnd)
+            {
+                for (uint32_t i = uBegin; i < uEnd; ++i)
+                {
+                    apRenderables[i]->StorePreviousState();
+                    apRenderables[i]->Update(deltaTime);
+                }
+            });
+        });
+
+        uint32_t uAnimation = updateGraph.AddTask("Animation", [&]()
+        {
+            jobSystem.ParallelFor(static_cast<uint32_t>(apModels.size()), 1u, [&](uint32_t uBegin, uint32_t uEnd)
+            {
+                for (uint32_t i = uBegin; i < uEnd; ++i)
+                {
+                    apModels[i]->StorePreviousState();
+                    apModels[i]->Update(deltaTime);
+                }
+            });
+        });
+
+        updateGraph.AddTask("Lights", [&]()
         {
-            m_aPointLights[lightIdx]->Update(deltaTime);
+            for (UINT lightIdx = 0; lightIdx < NUM_LIGHTS; ++lightIdx)
+            {
+                m_aPointLights[lightIdx]->Update(deltaTime);
+            }
+        });
+
+        uint32_t uSkyBox = updateGraph.AddTask("SkyBox", [&]()
+        {
+            m_skyBox->StorePreviousState();
+            m_skyBox->Update(deltaTime);
+        });
+
+        updateGraph.AddTask("Transforms", []()
+        {
+            TransformSystem::GetDefault().UpdateWorldMatrices();
+        }, { uUpdateObjects, uAnimation, uSkyBox });
+
+        updateGraph.Run(jobSystem);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::UpdateVoxels
+      Summary:  Remeshes the chunks edited since the last call. Their
+                meshes and buffers are built on the job system, then
+                their voxels take the shaders and materials of the voxel
+                prototype and replace the old ones, and the occluders
+                are rebuilt, so an edit shows in the frame that calls
+                this
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+      Modifies: [m_voxelWorld, m_aChunkVoxels, m_voxels, m_aOccluders].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::UpdateVoxels(_In_ ID3D11Device* pDevice)
+    {
+        std::vector<UINT> auChunks;
+        m_voxelWorld->TakeDirtyChunks(auChunks);
+        if (auChunks.empty())
+        {
+            return S_OK;
+        }
+
+        PROFILE_ZONE("UpdateVoxels");
+
+        std::vector<std::vector<VoxelMesh>> aChunkMeshes;
+        meshChunks(*m_voxelWorld, auChunks, aChunkMeshes);
+
+        std::vector<std::vector<std::shared_ptr<Voxel>>> aChunkVoxels;
+        createVoxels(*m_voxelWorld, std::move(aChunkMeshes), aChunkVoxels);
+
+        HRESULT hr = initializeVoxels(pDevice, aChunkVoxels);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        // Transforms are set on this thread, creating them is the only part that locks
+        std::vector<const Voxel*> apOldVoxels;
+        for (size_t i = 0; i < auChunks.size(); ++i)
+        {
+            for (const std::shared_ptr<Voxel>& voxel : m_aChunkVoxels[auChunks[i]])
+            {
+                apOldVoxels.push_back(voxel.get());
+            }
+
+            for (const std::shared_ptr<Voxel>& voxel : aChunkVoxels[i])
+            {
+                voxel->CopyStateFrom(*m_voxelPrototype);
+            }
+
+            m_aChunkVoxels[auChunks[i]] = std::move(aChunkVoxels[i]);
+        }
+
+        std::sort(apOldVoxels.begin(), apOldVoxels.end());
+        std::erase_if(m_voxels, [&apOldVoxels](const std::shared_ptr<Voxel>& voxel)
+        {
+            return std::binary_search(apOldVoxels.begin(), apOldVoxels.end(), voxel.get());
+        });
+
+        for (UINT uChunk : auChunks)
+        {
+            m_voxels.insert(m_voxels.end(), m_aChunkVoxels[uChunk].begin(), m_aChunkVoxels[uChunk].end());
+        }
+
+        buildOccluders(*m_voxelWorld, m_aOccluders);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::ReplaceVoxels
+      Summary:  Swaps in a voxel world loaded elsewhere with
+                LoadVoxels. The voxels of its chunk meshes are created
+                here, so this must be called on the thread that draws
+                the scene. They take the shaders and materials of the
+                voxel prototype. Voxels added with AddVoxel are kept
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                std::shared_ptr<VoxelWorld>&& voxelWorld
+                  New blocks
+                std::vector<std::vector<VoxelMesh>>&& aChunkMeshes
+                  Meshes of every chunk of the new world
+                std::vector<AxisAlignedBox>&& aOccluders
+                  Occluders of the new world
+      Modifies: [m_voxelWorld, m_aChunkVoxels, m_voxels, m_aOccluders].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::ReplaceVoxels(_In_ ID3D11Device* pDevice, _In_ std::shared_ptr<VoxelWorld>&& voxelWorld, _In_ std::vector<std::vector<VoxelMesh>>&& aChunkMeshes, _In_ std::vector<AxisAlignedBox>&& aOccluders)
+    {
+        PROFILE_ZONE("ReplaceVoxels");
+
+        std::vector<std::vector<std::shared_ptr<Voxel>>> aChunkVoxels;
+        createVoxels(*voxelWorld, std::move(aChunkMeshes), aChunkVoxels);
+
+        HRESULT hr = initializeVoxels(pDevice, aChunkVoxels);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        for (const std::vector<std::shared_ptr<Voxel>>& aVoxels : aChunkVoxels)
+        {
+            for (const std::shared_ptr<Voxel>& voxel : aVoxels)
+            {
+                voxel->CopyStateFrom(*m_voxelPrototype);
+            }
+        }
+
+        std::vector<const Voxel*> apOldVoxels;
+        for (const std::vector<std::shared_ptr<Voxel>>& aVoxels : m_aChunkVoxels)
+        {
+            for (const std::shared_ptr<Voxel>& voxel : aVoxels)
+            {
+                apOldVoxels.push_back(voxel.get());
+            }
         }
 
-        m_skyBox->Update(deltaTime);
+        std::sort(apOldVoxels.begin(), apOldVoxels.end());
+        std::erase_if(m_voxels, [&apOldVoxels](const std::shared_ptr<Voxel>& voxel)
+        {
+            return std::binary_search(apOldVoxels.begin(), apOldVoxels.end(), voxel.get());
+        });
+
+        m_voxelWorld = std::move(voxelWorld);
+        m_aChunkVoxels = std::move(aChunkVoxels);
+        m_aOccluders = std::move(aOccluders);
+
+        for (const std::vector<std::shared_ptr<Voxel>>& aVoxels : m_aChunkVoxels)
+        {
+            m_voxels.insert(m_voxels.end(), aVoxels.begin(), aVoxels.end());
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelWorld
+      Summary:  Returns the blocks of the scene. Edits show once
+                UpdateVoxels ran
+      Returns:  VoxelWorld&
+                  Voxel world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelWorld& Scene::GetVoxelWorld()
+    {
+        return *m_voxelWorld;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetVoxelPrototype
+      Summary:  Returns the voxel that is never drawn but holds the
+                shaders and materials every chunk voxel is given
+      Returns:  std::shared_ptr<Voxel>&
+                  Voxel prototype
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Voxel>& Scene::GetVoxelPrototype()
+    {
+        return m_voxelPrototype;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -444,24 +867,47 @@ namespace library
         return m_voxels;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetOccluders
+      Summary:  Returns the solid boxes the voxel columns fill
+      Returns:  std::vector<AxisAlignedBox>&
+                  Occluder boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<AxisAlignedBox>& Scene::GetOccluders()
+    {
+        return m_aOccluders;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetRenderables
       Summary:  Returns the vector of renderables
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<Renderable>>&
+      Returns:  ResourceTable<std::shared_ptr<Renderable>>&
                   Renderables
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& Scene::GetRenderables()
+    ResourceTable<std::shared_ptr<Renderable>>& Scene::GetRenderables()
     {
         return m_renderables;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetStaticBatches
+      Summary:  Returns the static batches that draw the static
+                renderables
+      Returns:  std::vector<std::shared_ptr<StaticBatch>>&
+                  Static batches
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<StaticBatch>>& Scene::GetStaticBatches()
+    {
+        return m_aStaticBatches;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetModels
       Summary:  Returns the vector of models
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<Model>>&
+      Returns:  ResourceTable<std::shared_ptr<Model>>&
                   Models
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<Model>>& Scene::GetModels()
+    ResourceTable<std::shared_ptr<Model>>& Scene::GetModels()
     {
         return m_models;
     }
@@ -483,27 +929,27 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetVertexShaders
-      Summary:  Returns a hash map of vertex shaders
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>&
+      Summary:  Returns the table of vertex shaders
+      Returns:  ResourceTable<std::shared_ptr<VertexShader>>&
                   Vertex shaders
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>& Scene::GetVertexShaders()
+    ResourceTable<std::shared_ptr<VertexShader>>& Scene::GetVertexShaders()
     {
         return m_vertexShaders;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetPixelShaders
-      Summary:  Returns a hash map of pixel shaders
-      Returns:  std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>&
+      Summary:  Returns the table of pixel shaders
+      Returns:  ResourceTable<std::shared_ptr<PixelShader>>&
                   Pixel shaders
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>& Scene::GetPixelShaders()
+    ResourceTable<std::shared_ptr<PixelShader>>& Scene::GetPixelShaders()
     {
         return m_pixelShaders;
     }
 
-    std::unordered_map<std::wstring, std::shared_ptr<Material>>& Scene::GetMaterials()
+    ResourceTable<std::shared_ptr<Material>>& Scene::GetMaterials()
     {
         return m_materials;
     }
@@ -519,6 +965,32 @@ namespace library
         return m_skyBox;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetTextureCache
+      Summary:  Sets the texture cache the models and the sky box load
+                their textures through. Has to be called before
+                Initialize
+      Args:     const std::shared_ptr<TextureCache>& textureCache
+                  Texture cache of the renderer
+      Modifies: [m_textureCache].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::SetTextureCache(_In_ const std::shared_ptr<TextureCache>& textureCache)
+    {
+        m_textureCache = textureCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::GetTextureCache
+      Summary:  Returns the texture cache of the models
+      Returns:  const std::shared_ptr<TextureCache>&
+                  Texture cache, null until the scene is added to a
+                  renderer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<TextureCache>& Scene::GetTextureCache() const
+    {
+        return m_textureCache;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Scene::GetFilePath
       Summary:  Returns the file path to the height map
@@ -554,12 +1026,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName)
     {
-        if (!m_renderables.contains(pszRenderableName) || !m_vertexShaders.contains(pszVertexShaderName))
+        std::shared_ptr<Renderable>* pRenderable = m_renderables.TryGet(StringId(pszRenderableName));
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.TryGet(StringId(pszVertexShaderName));
+        if (!pRenderable || !pVertexShader)
         {
             return E_FAIL;
         }
 
-        m_renderables[pszRenderableName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+        (*pRenderable)->SetVertexShader(*pVertexShader);
 
         return S_OK;
     }
@@ -577,12 +1051,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName)
     {
-        if (!m_renderables.contains(pszRenderableName) || !m_pixelShaders.contains(pszPixelShaderName))
+        std::shared_ptr<Renderable>* pRenderable = m_renderables.TryGet(StringId(pszRenderableName));
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.TryGet(StringId(pszPixelShaderName));
+        if (!pRenderable || !pPixelShader)
         {
             return E_FAIL;
         }
 
-        m_renderables[pszRenderableName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        (*pRenderable)->SetPixelShader(*pPixelShader);
 
         return S_OK;
     }
@@ -600,12 +1076,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName)
     {
-        if (!m_models.contains(pszModelName) || !m_vertexShaders.contains(pszVertexShaderName))
+        std::shared_ptr<Model>* pModel = m_models.TryGet(StringId(pszModelName));
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.TryGet(StringId(pszVertexShaderName));
+        if (!pModel || !pVertexShader)
         {
             return E_FAIL;
         }
 
-        m_models[pszModelName]->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+        (*pModel)->SetVertexShader(*pVertexShader);
 
         return S_OK;
     }
@@ -623,12 +1101,14 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName)
     {
-        if (!m_models.contains(pszModelName) || !m_pixelShaders.contains(pszPixelShaderName))
+        std::shared_ptr<Model>* pModel = m_models.TryGet(StringId(pszModelName));
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.TryGet(StringId(pszPixelShaderName));
+        if (!pModel || !pPixelShader)
         {
             return E_FAIL;
         }
 
-        m_models[pszModelName]->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+        (*pModel)->SetPixelShader(*pPixelShader);
 
         return S_OK;
     }
@@ -646,14 +1126,16 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetVertexShaderOfVoxel(_In_ PCWSTR pszVertexShaderName)
     {
-        if (!m_vertexShaders.contains(pszVertexShaderName))
+        std::shared_ptr<VertexShader>* pVertexShader = m_vertexShaders.TryGet(StringId(pszVertexShaderName));
+        if (!pVertexShader)
         {
             return E_FAIL;
         }
 
+        m_voxelPrototype->SetVertexShader(*pVertexShader);
         for (std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            voxel->SetVertexShader(m_vertexShaders[pszVertexShaderName]);
+            voxel->SetVertexShader(*pVertexShader);
         }
 
         return S_OK;
@@ -672,14 +1154,16 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Scene::SetPixelShaderOfVoxel(_In_ PCWSTR pszPixelShaderName)
     {
-        if (!m_pixelShaders.contains(pszPixelShaderName))
+        std::shared_ptr<PixelShader>* pPixelShader = m_pixelShaders.TryGet(StringId(pszPixelShaderName));
+        if (!pPixelShader)
         {
             return E_FAIL;
         }
 
+        m_voxelPrototype->SetPixelShader(*pPixelShader);
         for (std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            voxel->SetPixelShader(m_pixelShaders[pszPixelShaderName]);
+            voxel->SetPixelShader(*pPixelShader);
         }
 
         return S_OK;
@@ -687,16 +1171,84 @@ namespace library
 
     HRESULT Scene::SetMaterialOfVoxel(_In_ PCWSTR pszMaterialName)
     {
-        if (!m_materials.contains(pszMaterialName))
+        std::shared_ptr<Material>* pMaterial = m_materials.TryGet(StringId(pszMaterialName));
+        if (!pMaterial)
         {
             return E_FAIL;
         }
 
+        m_voxelPrototype->AddMaterial(*pMaterial);
         for (std::shared_ptr<Voxel>& voxel : m_voxels)
         {
-            voxel->AddMaterial(m_materials[pszMaterialName]);
+            voxel->AddMaterial(*pMaterial);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::buildStaticBatches
+      Summary:  Merges the static renderables into static batches and
+                reports how many draw calls that saves. The renderer
+                draws the batches in place of the static renderables
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to set buffers
+      Modifies: [m_aStaticBatches].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::buildStaticBatches(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        std::vector<Renderable*> apStaticRenderables;
+        UINT uNumDrawsBefore = 0u;
+        for (auto it = m_renderables.begin(); it != m_renderables.end(); ++it)
+        {
+            if ((*it)->IsStatic())
+            {
+                apStaticRenderables.push_back(it->get());
+                uNumDrawsBefore += (*it)->HasTexture() ? (*it)->GetNumMeshes() : 1u;
+            }
+        }
+
+        if (apStaticRenderables.empty())
+        {
+            return S_OK;
+        }
+
+        // The vertices are moved to world space with the placement set before initialization
+        TransformSystem::GetDefault().UpdateWorldMatrices();
+
+        HRESULT hr = StaticBatch::Build(apStaticRenderables, m_aStaticBatches);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        UINT uNumDrawsAfter = 0u;
+        for (const std::shared_ptr<StaticBatch>& batch : m_aStaticBatches)
+        {
+            hr = batch->Initialize(pDevice, pImmediateContext);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            uNumDrawsAfter += batch->HasTexture() ? batch->GetNumMeshes() : 1u;
         }
 
+        WCHAR szMessage[256];
+        swprintf_s(
+            szMessage,
+            L"Static batching: %zu renderables in %zu batches, %u draw calls instead of %u\n",
+            apStaticRenderables.size(),
+            m_aStaticBatches.size(),
+            uNumDrawsAfter,
+            uNumDrawsBefore
+        );
+        OutputDebugString(szMessage);
+
         return S_OK;
     }
 
@@ -14,9 +14,13 @@
 
 #include "Model/Model.h"
 #include "Light/PointLight.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/Skybox.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/StaticBatch.h"
 #include "Scene/Voxel.h"
+#include "Scene/VoxelWorld.h"
+#include "Utility/StringId.h"
 
 namespace library
 {
@@ -24,6 +28,7 @@ namespace library
     {
     public:
         static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
+        static HRESULT LoadVoxels(_In_ const std::filesystem::path& filePath, _Out_ VoxelWorld& outWorld, _Out_ std::vector<std::vector<VoxelMesh>>& aOutChunkMeshes, _Out_ std::vector<AxisAlignedBox>& aOutOccluders);
 
         Scene() = delete;
         Scene(const std::filesystem::path& filePath);
@@ -43,17 +48,26 @@ namespace library
         HRESULT AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader);
         HRESULT AddMaterial(_In_ const std::shared_ptr<Material>& material);
         HRESULT AddSkyBox(_In_ const std::shared_ptr<Skybox>& skybox);
+        void SetTextureCache(_In_ const std::shared_ptr<TextureCache>& textureCache);
 
         void Update(_In_ FLOAT deltaTime);
+        HRESULT UpdateVoxels(_In_ ID3D11Device* pDevice);
+        HRESULT ReplaceVoxels(_In_ ID3D11Device* pDevice, _In_ std::shared_ptr<VoxelWorld>&& voxelWorld, _In_ std::vector<std::vector<VoxelMesh>>&& aChunkMeshes, _In_ std::vector<AxisAlignedBox>&& aOccluders);
+
+        VoxelWorld& GetVoxelWorld();
+        std::shared_ptr<Voxel>& GetVoxelPrototype();
 
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
-        std::unordered_map<std::wstring, std::shared_ptr<Renderable>>& GetRenderables();
-        std::unordered_map<std::wstring, std::shared_ptr<Model>>& GetModels();
+        std::vector<AxisAlignedBox>& GetOccluders();
+        ResourceTable<std::shared_ptr<Renderable>>& GetRenderables();
+        std::vector<std::shared_ptr<StaticBatch>>& GetStaticBatches();
+        ResourceTable<std::shared_ptr<Model>>& GetModels();
         std::shared_ptr<PointLight>& GetPointLight(_In_ size_t index);
-        std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>& GetVertexShaders();
-        std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>& GetPixelShaders();
-        std::unordered_map<std::wstring, std::shared_ptr<Material>>& GetMaterials();
+        ResourceTable<std::shared_ptr<VertexShader>>& GetVertexShaders();
+        ResourceTable<std::shared_ptr<PixelShader>>& GetPixelShaders();
+        ResourceTable<std::shared_ptr<Material>>& GetMaterials();
         std::shared_ptr<Skybox>& GetSkyBox();
+        const std::shared_ptr<TextureCache>& GetTextureCache() const;
 
         const std::filesystem::path& GetFilePath() const;
         PCWSTR GetFileName() const;
@@ -69,12 +83,22 @@ namespace library
         HRESULT SetMaterialOfVoxel(_In_ PCWSTR pszMaterialName);
 
     private:
+        HRESULT buildStaticBatches(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
+        HRESULT initializeVoxels(_In_ ID3D11Device* pDevice, _In_ const std::vector<std::vector<std::shared_ptr<Voxel>>>& aChunkVoxels);
+
+        static void meshChunks(_In_ const VoxelWorld& world, _In_ const std::vector<UINT>& auChunks, _Out_ std::vector<std::vector<VoxelMesh>>& aOutChunkMeshes);
+        static void createVoxels(_In_ const VoxelWorld& world, _In_ std::vector<std::vector<VoxelMesh>>&& aChunkMeshes, _Out_ std::vector<std::vector<std::shared_ptr<Voxel>>>& aOutChunkVoxels);
+        static void buildOccluders(_In_ const VoxelWorld& world, _Out_ std::vector<AxisAlignedBox>& aOutOccluders);
+
         static FLOAT getNoise2(UINT x, UINT y);
         static FLOAT getNoise2d(FLOAT x, FLOAT y);
         static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
         static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
 
     private:
+        static constexpr const UINT UPDATE_GRAIN_SIZE = 16u;
+        static constexpr const UINT CHUNK_GRAIN_SIZE = 4u;
         static constexpr const UINT ms_aHashes[] =
         {
             208,34,231,213,32,248,233,56,161,78,24,140,71,48,140,254,245,255,247,247,40,
@@ -93,13 +117,19 @@ namespace library
 
     private:
         std::filesystem::path m_filePath;
+        std::shared_ptr<VoxelWorld> m_voxelWorld;
+        std::vector<std::vector<std::shared_ptr<Voxel>>> m_aChunkVoxels;
+        std::shared_ptr<Voxel> m_voxelPrototype;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
-        std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
-        std::unordered_map<std::wstring, std::shared_ptr<Model>> m_models;
+        std::vector<AxisAlignedBox> m_aOccluders;
+        ResourceTable<std::shared_ptr<Renderable>> m_renderables;
+        std::vector<std::shared_ptr<StaticBatch>> m_aStaticBatches;
+        ResourceTable<std::shared_ptr<Model>> m_models;
         std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
-        std::unordered_map<std::wstring, std::shared_ptr<VertexShader>> m_vertexShaders;
-        std::unordered_map<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders;
-        std::unordered_map<std::wstring, std::shared_ptr<Material>> m_materials;
+        ResourceTable<std::shared_ptr<VertexShader>> m_vertexShaders;
+        ResourceTable<std::shared_ptr<PixelShader>> m_pixelShaders;
+        ResourceTable<std::shared_ptr<Material>> m_materials;
         std::shared_ptr<Skybox> m_skyBox;
+        std::shared_ptr<TextureCache> m_textureCache;
     };
 }
\ No newline at end of file
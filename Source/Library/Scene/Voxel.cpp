@@ -12,6 +12,10 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Voxel::Voxel(_In_ const XMFLOAT4& outputColor)
         : InstancedRenderable(outputColor)
+        , m_aVertices()
+        , m_aIndices()
+        , m_aAmbientOcclusion()
+        , m_ambientOcclusionBuffer()
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -24,11 +28,37 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Voxel::Voxel(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor)
         : InstancedRenderable(std::move(aInstanceData), outputColor)
+        , m_aVertices()
+        , m_aIndices()
+        , m_aAmbientOcclusion()
+        , m_ambientOcclusionBuffer()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::Voxel
+      Summary:  Constructor of a voxel drawing a mesh once, in world
+                space
+      Args:     std::vector<SimpleVertex>&& aVertices
+                  Vertices of the mesh
+                std::vector<WORD>&& aIndices
+                  Indices of the mesh
+                std::vector<BYTE>&& aAmbientOcclusion
+                  Ambient light reaching each vertex, 255 when nothing
+                  occludes it
+                const XMFLOAT4& outputColor
+                  Color of the voxel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Voxel::Voxel(_In_ std::vector<SimpleVertex>&& aVertices, _In_ std::vector<WORD>&& aIndices, _In_ std::vector<BYTE>&& aAmbientOcclusion, _In_ const XMFLOAT4& outputColor)
+        : InstancedRenderable(std::vector<InstanceData>{ InstanceData{ .Transformation = XMMatrixIdentity() } }, outputColor)
+        , m_aVertices(std::move(aVertices))
+        , m_aIndices(std::move(aIndices))
+        , m_aAmbientOcclusion(std::move(aAmbientOcclusion))
+        , m_ambientOcclusionBuffer()
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Voxel::Initialize
-      Summary:  Initializes a voxel
+      Summary:  Initializes a voxel. The cube is not occluded
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
@@ -39,7 +69,7 @@ namespace library
     HRESULT Voxel::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
         BasicMeshEntry basicMeshEntry;
-        basicMeshEntry.uNumIndices = NUM_INDICES;
+        basicMeshEntry.uNumIndices = GetNumIndices();
 
         m_aMeshes.push_back(basicMeshEntry);
 
@@ -55,6 +85,34 @@ namespace library
             return hr;
         }
 
+        if (m_aAmbientOcclusion.empty())
+        {
+            m_aAmbientOcclusion.assign(GetNumVertices(), 255u);
+        }
+
+        D3D11_BUFFER_DESC ambientOcclusionBufferDesc =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(BYTE) * m_aAmbientOcclusion.size()),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA ambientOcclusionInitData =
+        {
+            .pSysMem = m_aAmbientOcclusion.data(),
+            .SysMemPitch = 0u,
+            .SysMemSlicePitch = 0u
+        };
+
+        hr = pDevice->CreateBuffer(&ambientOcclusionBufferDesc, &ambientOcclusionInitData, m_ambientOcclusionBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
         if (HasTexture() > 0)
         {
             hr = SetMaterialOfMesh(0, 0);
@@ -87,6 +145,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     UINT Voxel::GetNumVertices() const
     {
+        if (!m_aVertices.empty())
+        {
+            return static_cast<UINT>(m_aVertices.size());
+        }
+
         return NUM_VERTICES;
     }
 
@@ -99,9 +162,27 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     UINT Voxel::GetNumIndices() const
     {
+        if (!m_aIndices.empty())
+        {
+            return static_cast<UINT>(m_aIndices.size());
+        }
+
         return NUM_INDICES;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Voxel::GetAmbientOcclusionBuffer
+      Summary:  Returns the vertex buffer of the ambient occlusion, one
+                UNORM byte per vertex
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Ambient occlusion buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Voxel::GetAmbientOcclusionBuffer()
+    {
+        return m_ambientOcclusionBuffer;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Voxel::getVertices
       Summary:  Returns the pointer to the vertices data
@@ -111,6 +192,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     const SimpleVertex* Voxel::getVertices() const
     {
+        if (!m_aVertices.empty())
+        {
+            return m_aVertices.data();
+        }
+
         return VERTICES;
     }
 
@@ -123,6 +209,11 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     const WORD* Voxel::getIndices() const
     {
+        if (!m_aIndices.empty())
+        {
+            return m_aIndices.data();
+        }
+
         return INDICES;
     }
 }
\ No newline at end of file
@@ -17,8 +17,12 @@ namespace library
 {
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    Voxel
-      Summary:  Base class for renderable 3d cube object
-      Methods:  Voxel
+      Summary:  Base class for renderable 3d cube object. A voxel built
+                from a mesh draws it once instead of the cube, with
+                the ambient occlusion baked into its vertices
+      Methods:  GetAmbientOcclusionBuffer
+                  Returns the vertex buffer of the ambient occlusion
+                Voxel
                   Constructor.
                 ~Voxel
                   Destructor.
@@ -28,6 +32,7 @@ namespace library
     public:
         Voxel(_In_ const XMFLOAT4& outputColor);
         Voxel(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor);
+        Voxel(_In_ std::vector<SimpleVertex>&& aVertices, _In_ std::vector<WORD>&& aIndices, _In_ std::vector<BYTE>&& aAmbientOcclusion, _In_ const XMFLOAT4& outputColor);
         Voxel(const Voxel& other) = delete;
         Voxel(Voxel&& other) = delete;
         Voxel& operator=(const Voxel& other) = delete;
@@ -40,6 +45,8 @@ namespace library
         UINT GetNumVertices() const override;
         UINT GetNumIndices() const override;
 
+        ComPtr<ID3D11Buffer>& GetAmbientOcclusionBuffer();
+
     protected:
         const SimpleVertex* getVertices() const override;
         const WORD* getIndices() const override;
@@ -98,5 +105,10 @@ namespace library
             23,20,22
         };
         static constexpr const UINT NUM_INDICES = 36u;
+
+        std::vector<SimpleVertex> m_aVertices;
+        std::vector<WORD> m_aIndices;
+        std::vector<BYTE> m_aAmbientOcclusion;
+        ComPtr<ID3D11Buffer> m_ambientOcclusionBuffer;
     };
 }
\ No newline at end of file
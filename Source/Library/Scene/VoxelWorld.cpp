@@ -0,0 +1,757 @@
+#include "Scene/VoxelWorld.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+namespace library
+{
+    using namespace DirectX;
+
+    // Every (solid, empty) pair of neighbours inside a chunk, plus every block face on its boundary, as four vertices
+    static_assert(4u * (3u * VoxelWorld::CHUNK_SIZE * VoxelWorld::CHUNK_SIZE * (VoxelWorld::CHUNK_SIZE - 1u) + 6u * VoxelWorld::CHUNK_SIZE * VoxelWorld::CHUNK_SIZE) <= 65536u,
+        "The meshes of a chunk do not fit in 16-bit indices");
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::VoxelWorld
+      Summary:  Constructor
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_uNumChunksX,
+                 m_uNumChunksY, m_uNumChunksZ, m_origin, m_aBlocks,
+                 m_abIsChunkDirty, m_auDirtyChunks, m_aBlockColors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VoxelWorld::VoxelWorld()
+        : m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uDepth(0u)
+        , m_uNumChunksX(0u)
+        , m_uNumChunksY(0u)
+        , m_uNumChunksZ(0u)
+        , m_origin()
+        , m_aBlocks()
+        , m_abIsChunkDirty()
+        , m_auDirtyChunks()
+        , m_aBlockColors()
+    {
+        std::fill(m_aBlockColors, m_aBlockColors + NUM_BLOCK_TYPES, XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::Resize
+      Summary:  Sets the size of the world in blocks and empties every
+                block. Every chunk becomes dirty
+      Args:     uint32_t uWidth
+                  Number of blocks along x
+                uint32_t uHeight
+                  Number of blocks along y
+                uint32_t uDepth
+                  Number of blocks along z
+      Modifies: [m_uWidth, m_uHeight, m_uDepth, m_uNumChunksX,
+                 m_uNumChunksY, m_uNumChunksZ, m_origin, m_aBlocks,
+                 m_abIsChunkDirty, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::Resize(uint32_t uWidth, uint32_t uHeight, uint32_t uDepth)
+    {
+        m_uWidth = uWidth;
+        m_uHeight = uHeight;
+        m_uDepth = uDepth;
+        m_uNumChunksX = (uWidth + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+        m_uNumChunksY = (uHeight + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+        m_uNumChunksZ = (uDepth + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+
+        // Corner of block (0, 0, 0), the blocks are centered at
+        // (2 (x - width / 2), 2 (y - height) + 0.75 height, 2 (z - depth / 2))
+        m_origin = XMFLOAT3(
+            -static_cast<float>(uWidth) - 0.5f * BLOCK_SIZE,
+            -1.25f * static_cast<float>(uHeight) - 0.5f * BLOCK_SIZE,
+            -static_cast<float>(uDepth) - 0.5f * BLOCK_SIZE
+        );
+
+        m_aBlocks.assign(static_cast<size_t>(uWidth) * uHeight * uDepth, EMPTY_BLOCK);
+
+        m_abIsChunkDirty.assign(GetNumChunks(), true);
+        m_auDirtyChunks.resize(GetNumChunks());
+        for (uint32_t i = 0u; i < GetNumChunks(); ++i)
+        {
+            m_auDirtyChunks[i] = i;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetBlock
+      Summary:  Returns the type of a block
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block
+      Returns:  char
+                  eBlockType of the block, EMPTY_BLOCK when it is empty
+                  or outside the world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    char VoxelWorld::GetBlock(int32_t x, int32_t y, int32_t z) const
+    {
+        if (!isInside(x, y, z))
+        {
+            return EMPTY_BLOCK;
+        }
+
+        return m_aBlocks[getBlockIndex(x, y, z)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::SetBlock
+      Summary:  Fills a block and marks the chunks it shades dirty
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block
+                eBlockType blockType
+                  Type of the block
+      Modifies: [m_aBlocks, m_abIsChunkDirty, m_auDirtyChunks].
+      Returns:  bool
+                  Whether the block is inside the world and the type
+                  is valid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool VoxelWorld::SetBlock(int32_t x, int32_t y, int32_t z, eBlockType blockType)
+    {
+        if (!isInside(x, y, z) || blockType < eBlockType::GRASSLAND || blockType >= eBlockType::COUNT)
+        {
+            return false;
+        }
+
+        char& block = m_aBlocks[getBlockIndex(x, y, z)];
+        if (block != static_cast<char>(blockType))
+        {
+            block = static_cast<char>(blockType);
+            markDirty(x, y, z);
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::ClearBlock
+      Summary:  Empties a block and marks the chunks it shades dirty
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block
+      Modifies: [m_aBlocks, m_abIsChunkDirty, m_auDirtyChunks].
+      Returns:  bool
+                  Whether the block is inside the world
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool VoxelWorld::ClearBlock(int32_t x, int32_t y, int32_t z)
+    {
+        if (!isInside(x, y, z))
+        {
+            return false;
+        }
+
+        char& block = m_aBlocks[getBlockIndex(x, y, z)];
+        if (block != EMPTY_BLOCK)
+        {
+            block = EMPTY_BLOCK;
+            markDirty(x, y, z);
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::SetBlockColor
+      Summary:  Sets the color the meshes of a block type are drawn with
+      Args:     eBlockType blockType
+                  Type of the blocks
+                const XMFLOAT4& color
+                  Color of the blocks
+      Modifies: [m_aBlockColors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::SetBlockColor(eBlockType blockType, const XMFLOAT4& color)
+    {
+        assert(eBlockType::GRASSLAND <= blockType && blockType < eBlockType::COUNT);
+
+        m_aBlockColors[static_cast<uint32_t>(blockType) - static_cast<uint32_t>(eBlockType::GRASSLAND)] = color;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetBlockColor
+      Summary:  Returns the color of a block type, white unless it was
+                set
+      Args:     eBlockType blockType
+                  Type of the blocks
+      Returns:  const XMFLOAT4&
+                  Color of the blocks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& VoxelWorld::GetBlockColor(eBlockType blockType) const
+    {
+        assert(eBlockType::GRASSLAND <= blockType && blockType < eBlockType::COUNT);
+
+        return m_aBlockColors[static_cast<uint32_t>(blockType) - static_cast<uint32_t>(eBlockType::GRASSLAND)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::Raycast
+      Summary:  Walks the blocks a ray crosses in order, with the DDA
+                of Amanatides and Woo, and returns the first one that
+                is not empty. A ray starting outside the world is first
+                moved to where it enters it
+      Args:     FXMVECTOR origin
+                  Start of the ray, in world space
+                FXMVECTOR direction
+                  Direction of the ray, need not be normalized
+                float maxDistance
+                  Length of the ray, in world space
+                VoxelHit& outHit
+                  Receives the block that was hit
+      Returns:  bool
+                  Whether a block was hit
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool VoxelWorld::Raycast(FXMVECTOR origin, FXMVECTOR direction, float maxDistance, VoxelHit& outHit) const
+    {
+        outHit = VoxelHit{ .Block = XMINT3(0, 0, 0), .Normal = XMINT3(0, 0, 0), .distance = 0.0f };
+
+        if (m_aBlocks.empty() || XMVector3Equal(XMVector3LengthSq(direction), XMVectorZero()))
+        {
+            return false;
+        }
+
+        // Ray in blocks, s measures the distance in blocks along it
+        XMFLOAT3 start;
+        XMFLOAT3 step;
+        XMStoreFloat3(&start, (origin - XMLoadFloat3(&m_origin)) / BLOCK_SIZE);
+        XMStoreFloat3(&step, XMVector3Normalize(direction));
+
+        const float aStart[3] = { start.x, start.y, start.z };
+        const float aDirection[3] = { step.x, step.y, step.z };
+        const int32_t aiDimension[3] = { static_cast<int32_t>(m_uWidth), static_cast<int32_t>(m_uHeight), static_cast<int32_t>(m_uDepth) };
+
+        // Clip the ray to the box of the world
+        float enter = 0.0f;
+        float exit = maxDistance / BLOCK_SIZE;
+        int32_t iEnterAxis = -1;
+        for (int32_t a = 0; a < 3; ++a)
+        {
+            if (aDirection[a] == 0.0f)
+            {
+                if (aStart[a] < 0.0f || aStart[a] >= static_cast<float>(aiDimension[a]))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            float slabEnter = (0.0f - aStart[a]) / aDirection[a];
+            float slabExit = (static_cast<float>(aiDimension[a]) - aStart[a]) / aDirection[a];
+            if (slabEnter > slabExit)
+            {
+                std::swap(slabEnter, slabExit);
+            }
+
+            if (slabEnter > enter)
+            {
+                enter = slabEnter;
+                iEnterAxis = a;
+            }
+            exit = (std::min)(exit, slabExit);
+        }
+
+        if (enter > exit)
+        {
+            return false;
+        }
+
+        int32_t aiBlock[3];
+        int32_t aiStep[3];
+        int32_t aiNormal[3] = { 0, 0, 0 };
+        float aNextBoundary[3];
+        float aBoundaryDelta[3];
+        for (int32_t a = 0; a < 3; ++a)
+        {
+            aiStep[a] = aDirection[a] > 0.0f ? 1 : (aDirection[a] < 0.0f ? -1 : 0);
+
+            if (a == iEnterAxis)
+            {
+                // The entry point lies on a face of the world, rounding must not pick the block outside
+                aiBlock[a] = aiStep[a] > 0 ? 0 : aiDimension[a] - 1;
+                aiNormal[a] = -aiStep[a];
+            }
+            else
+            {
+                aiBlock[a] = std::clamp(static_cast<int32_t>(std::floor(aStart[a] + aDirection[a] * enter)), 0, aiDimension[a] - 1);
+            }
+
+            if (aiStep[a] == 0)
+            {
+                aNextBoundary[a] = FLT_MAX;
+                aBoundaryDelta[a] = FLT_MAX;
+            }
+            else
+            {
+                float boundary = static_cast<float>(aiStep[a] > 0 ? aiBlock[a] + 1 : aiBlock[a]);
+                aNextBoundary[a] = (boundary - aStart[a]) / aDirection[a];
+                aBoundaryDelta[a] = 1.0f / std::abs(aDirection[a]);
+            }
+        }
+
+        float distance = enter;
+        for (;;)
+        {
+            if (m_aBlocks[getBlockIndex(aiBlock[0], aiBlock[1], aiBlock[2])] != EMPTY_BLOCK)
+            {
+                outHit = VoxelHit
+                {
+                    .Block = XMINT3(aiBlock[0], aiBlock[1], aiBlock[2]),
+                    .Normal = XMINT3(aiNormal[0], aiNormal[1], aiNormal[2]),
+                    .distance = distance * BLOCK_SIZE
+                };
+                return true;
+            }
+
+            int32_t a = 0;
+            if (aNextBoundary[1] < aNextBoundary[a])
+            {
+                a = 1;
+            }
+            if (aNextBoundary[2] < aNextBoundary[a])
+            {
+                a = 2;
+            }
+
+            if (aNextBoundary[a] > exit)
+            {
+                return false;
+            }
+
+            distance = aNextBoundary[a];
+            aNextBoundary[a] += aBoundaryDelta[a];
+            aiBlock[a] += aiStep[a];
+            if (aiBlock[a] < 0 || aiBlock[a] >= aiDimension[a])
+            {
+                return false;
+            }
+
+            aiNormal[0] = aiNormal[1] = aiNormal[2] = 0;
+            aiNormal[a] = -aiStep[a];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetBlockCenter
+      Summary:  Returns the center of a block
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block
+      Returns:  XMVECTOR
+                  Center of the block, in world space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR VoxelWorld::GetBlockCenter(int32_t x, int32_t y, int32_t z) const
+    {
+        return XMVectorSet(
+            m_origin.x + BLOCK_SIZE * (static_cast<float>(x) + 0.5f),
+            m_origin.y + BLOCK_SIZE * (static_cast<float>(y) + 0.5f),
+            m_origin.z + BLOCK_SIZE * (static_cast<float>(z) + 0.5f),
+            1.0f
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetColumnHeights
+      Summary:  Returns how many blocks every column stacks without a
+                gap from y = 0, which is what the occluders cover
+      Args:     std::vector<uint32_t>& auOutHeights
+                  Receives the height of every column, row by row of
+                  depth
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::GetColumnHeights(std::vector<uint32_t>& auOutHeights) const
+    {
+        auOutHeights.assign(static_cast<size_t>(m_uWidth) * m_uDepth, 0u);
+
+        for (uint32_t z = 0u; z < m_uDepth; ++z)
+        {
+            for (uint32_t x = 0u; x < m_uWidth; ++x)
+            {
+                uint32_t uHeight = 0u;
+                while (uHeight < m_uHeight && m_aBlocks[getBlockIndex(x, uHeight, z)] != EMPTY_BLOCK)
+                {
+                    ++uHeight;
+                }
+
+                auOutHeights[static_cast<size_t>(z) * m_uWidth + x] = uHeight;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::TakeDirtyChunks
+      Summary:  Returns the chunks edited since the last call, and
+                marks them clean
+      Args:     std::vector<uint32_t>& auOutChunks
+                  Receives the indices of the dirty chunks
+      Modifies: [m_abIsChunkDirty, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::TakeDirtyChunks(std::vector<uint32_t>& auOutChunks)
+    {
+        auOutChunks = std::move(m_auDirtyChunks);
+        m_auDirtyChunks.clear();
+
+        for (uint32_t uChunk : auOutChunks)
+        {
+            m_abIsChunkDirty[uChunk] = false;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::MeshChunk
+      Summary:  Builds one mesh per block type of a chunk. For every
+                slice of the chunk and direction, the faces between a
+                block and an empty neighbour, which may lie in another
+                chunk, are collected in a mask with the occlusion of
+                their corners, and merged greedily: each rectangle
+                grows along the rows as far as the faces match, then
+                down the columns while whole rows match. A rectangle
+                only grows along a direction its occlusion does not
+                vary in, so it shades exactly like its faces would.
+                Faces are wound clockwise seen from outside, split
+                along the diagonal that keeps the occlusion isotropic,
+                and their texture repeats once per block
+      Args:     uint32_t uChunk
+                  Index of the chunk
+                std::vector<VoxelMesh>& aOutMeshes
+                  Receives the meshes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::MeshChunk(uint32_t uChunk, std::vector<VoxelMesh>& aOutMeshes) const
+    {
+        aOutMeshes.clear();
+
+        const int32_t aiChunkMin[3] =
+        {
+            static_cast<int32_t>(uChunk % m_uNumChunksX * CHUNK_SIZE),
+            static_cast<int32_t>(uChunk / (m_uNumChunksX * m_uNumChunksZ) * CHUNK_SIZE),
+            static_cast<int32_t>(uChunk / m_uNumChunksX % m_uNumChunksZ * CHUNK_SIZE)
+        };
+        const int32_t aiChunkSize[3] =
+        {
+            (std::min)(static_cast<int32_t>(CHUNK_SIZE), static_cast<int32_t>(m_uWidth) - aiChunkMin[0]),
+            (std::min)(static_cast<int32_t>(CHUNK_SIZE), static_cast<int32_t>(m_uHeight) - aiChunkMin[1]),
+            (std::min)(static_cast<int32_t>(CHUNK_SIZE), static_cast<int32_t>(m_uDepth) - aiChunkMin[2])
+        };
+
+        int32_t aiMeshOfType[NUM_BLOCK_TYPES];
+        std::fill(aiMeshOfType, aiMeshOfType + NUM_BLOCK_TYPES, -1);
+
+        // Block type in the low byte, then the occlusion level of each corner in two bits
+        uint16_t aMask[CHUNK_SIZE * CHUNK_SIZE];
+
+        for (int32_t d = 0; d < 3; ++d)
+        {
+            // Rows of the mask run along u, columns along v, u x v = d
+            const int32_t u = (d + 1) % 3;
+            const int32_t v = (d + 2) % 3;
+
+            for (int32_t iSign = -1; iSign <= 1; iSign += 2)
+            {
+                for (int32_t i = 0; i < aiChunkSize[d]; ++i)
+                {
+                    for (int32_t b = 0; b < aiChunkSize[v]; ++b)
+                    {
+                        for (int32_t a = 0; a < aiChunkSize[u]; ++a)
+                        {
+                            int32_t aiBlock[3];
+                            aiBlock[d] = aiChunkMin[d] + i;
+                            aiBlock[u] = aiChunkMin[u] + a;
+                            aiBlock[v] = aiChunkMin[v] + b;
+
+                            const char block = m_aBlocks[getBlockIndex(aiBlock[0], aiBlock[1], aiBlock[2])];
+
+                            aiBlock[d] += iSign;
+                            if (block == EMPTY_BLOCK || GetBlock(aiBlock[0], aiBlock[1], aiBlock[2]) != EMPTY_BLOCK)
+                            {
+                                aMask[b * CHUNK_SIZE + a] = 0u;
+                                continue;
+                            }
+
+                            aMask[b * CHUNK_SIZE + a] = static_cast<uint16_t>(static_cast<uint8_t>(block) | getFaceOcclusion(aiBlock, u, v) << 8u);
+                        }
+                    }
+
+                    for (int32_t b = 0; b < aiChunkSize[v]; ++b)
+                    {
+                        for (int32_t a = 0; a < aiChunkSize[u];)
+                        {
+                            const uint16_t face = aMask[b * CHUNK_SIZE + a];
+                            if (face == 0u)
+                            {
+                                ++a;
+                                continue;
+                            }
+
+                            const char block = static_cast<char>(face & 0xFFu);
+                            uint32_t auLevels[4];
+                            for (uint32_t uCorner = 0u; uCorner < 4u; ++uCorner)
+                            {
+                                auLevels[uCorner] = (face >> (8u + 2u * uCorner)) & 3u;
+                            }
+
+                            int32_t iWidth = 1;
+                            if (auLevels[0] == auLevels[1] && auLevels[3] == auLevels[2])
+                            {
+                                while (a + iWidth < aiChunkSize[u] && aMask[b * CHUNK_SIZE + a + iWidth] == face)
+                                {
+                                    ++iWidth;
+                                }
+                            }
+
+                            int32_t iHeight = 1;
+                            if (auLevels[0] == auLevels[3] && auLevels[1] == auLevels[2])
+                            {
+                                for (; b + iHeight < aiChunkSize[v]; ++iHeight)
+                                {
+                                    const uint16_t* pRow = aMask + (b + iHeight) * CHUNK_SIZE + a;
+                                    if (std::any_of(pRow, pRow + iWidth, [face](uint16_t other) { return other != face; }))
+                                    {
+                                        break;
+                                    }
+                                }
+                            }
+
+                            for (int32_t iRow = b; iRow < b + iHeight; ++iRow)
+                            {
+                                std::fill(aMask + iRow * CHUNK_SIZE + a, aMask + iRow * CHUNK_SIZE + a + iWidth, static_cast<uint16_t>(0u));
+                            }
+
+                            const uint32_t uType = static_cast<uint32_t>(block) - static_cast<uint32_t>(eBlockType::GRASSLAND);
+                            if (aiMeshOfType[uType] < 0)
+                            {
+                                aiMeshOfType[uType] = static_cast<int32_t>(aOutMeshes.size());
+                                aOutMeshes.emplace_back().blockType = static_cast<eBlockType>(block);
+                            }
+                            VoxelMesh& mesh = aOutMeshes[aiMeshOfType[uType]];
+
+                            float aNormal[3] = { 0.0f, 0.0f, 0.0f };
+                            aNormal[d] = static_cast<float>(iSign);
+
+                            // Corners counterclockwise in (u, v)
+                            const int32_t aaiCorners[4][2] = { { 0, 0 }, { iWidth, 0 }, { iWidth, iHeight }, { 0, iHeight } };
+
+                            const uint16_t uBase = static_cast<uint16_t>(mesh.aVertices.size());
+                            for (uint32_t uCorner = 0u; uCorner < 4u; ++uCorner)
+                            {
+                                const int32_t* aiCorner = aaiCorners[uCorner];
+
+                                float aPosition[3];
+                                aPosition[d] = static_cast<float>(aiChunkMin[d] + i + (iSign > 0 ? 1 : 0));
+                                aPosition[u] = static_cast<float>(aiChunkMin[u] + a + aiCorner[0]);
+                                aPosition[v] = static_cast<float>(aiChunkMin[v] + b + aiCorner[1]);
+
+                                mesh.aVertices.push_back(SimpleVertex
+                                {
+                                    .Position = XMFLOAT3(
+                                        m_origin.x + BLOCK_SIZE * aPosition[0],
+                                        m_origin.y + BLOCK_SIZE * aPosition[1],
+                                        m_origin.z + BLOCK_SIZE * aPosition[2]
+                                    ),
+                                    .TexCoord = XMFLOAT2(static_cast<float>(aiCorner[0]), static_cast<float>(aiCorner[1])),
+                                    .Normal = XMFLOAT3(aNormal)
+                                });
+                                mesh.aAmbientOcclusion.push_back(AMBIENT_OCCLUSION_LEVELS[auLevels[uCorner]]);
+                            }
+
+                            // Counterclockwise in (u, v) is clockwise seen from +d. The diagonal joins the
+                            // darker pair of opposite corners, so a single occluded corner fades over both
+                            // triangles instead of showing as one
+                            const uint16_t aaIndices[2][2][6] =
+                            {
+                                { { 0, 2, 1, 0, 3, 2 }, { 0, 1, 2, 0, 2, 3 } },
+                                { { 1, 3, 2, 1, 0, 3 }, { 1, 2, 3, 1, 3, 0 } },
+                            };
+                            const bool bIsFlipped = auLevels[0] + auLevels[2] > auLevels[1] + auLevels[3];
+                            for (uint16_t uIndex : aaIndices[bIsFlipped ? 1 : 0][iSign > 0 ? 1 : 0])
+                            {
+                                mesh.aIndices.push_back(uBase + uIndex);
+                            }
+
+                            a += iWidth;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetWidth
+      Summary:  Returns the width of the world
+      Returns:  uint32_t
+                  Number of blocks along x
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t VoxelWorld::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetHeight
+      Summary:  Returns the height of the world
+      Returns:  uint32_t
+                  Number of blocks along y
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t VoxelWorld::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetDepth
+      Summary:  Returns the depth of the world
+      Returns:  uint32_t
+                  Number of blocks along z
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t VoxelWorld::GetDepth() const
+    {
+        return m_uDepth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::GetNumChunks
+      Summary:  Returns the number of chunks
+      Returns:  uint32_t
+                  Number of chunks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t VoxelWorld::GetNumChunks() const
+    {
+        return m_uNumChunksX * m_uNumChunksY * m_uNumChunksZ;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::isInside
+      Summary:  Returns whether a block lies in the world
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block
+      Returns:  bool
+                  Whether the block is inside
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool VoxelWorld::isInside(int32_t x, int32_t y, int32_t z) const
+    {
+        return 0 <= x && x < static_cast<int32_t>(m_uWidth)
+            && 0 <= y && y < static_cast<int32_t>(m_uHeight)
+            && 0 <= z && z < static_cast<int32_t>(m_uDepth);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::getBlockIndex
+      Summary:  Returns where a block is stored, x varying fastest
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block, inside the world
+      Returns:  size_t
+                  Index of the block in m_aBlocks
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t VoxelWorld::getBlockIndex(int32_t x, int32_t y, int32_t z) const
+    {
+        return (static_cast<size_t>(y) * m_uDepth + static_cast<size_t>(z)) * m_uWidth + static_cast<size_t>(x);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::getFaceOcclusion
+      Summary:  Returns the occlusion of the corners of a face, from the
+                blocks around the empty block in front of it: a corner
+                between two solid sides is fully occluded, otherwise
+                each solid side and the solid diagonal darken it by one
+                level
+      Args:     const int32_t* aiFront
+                  Coordinates of the empty block in front of the face
+                int32_t u
+                  Axis the rows of the face run along
+                int32_t v
+                  Axis the columns of the face run along
+      Returns:  uint32_t
+                  Level of the corners (0, 0), (1, 0), (1, 1) and (0, 1)
+                  of the face in (u, v), two bits each from the lowest,
+                  3 being unoccluded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t VoxelWorld::getFaceOcclusion(const int32_t* aiFront, int32_t u, int32_t v) const
+    {
+        bool aabIsSolid[3][3];
+        for (int32_t j = -1; j <= 1; ++j)
+        {
+            for (int32_t i = -1; i <= 1; ++i)
+            {
+                int32_t aiBlock[3] = { aiFront[0], aiFront[1], aiFront[2] };
+                aiBlock[u] += i;
+                aiBlock[v] += j;
+                aabIsSolid[j + 1][i + 1] = (i != 0 || j != 0) && GetBlock(aiBlock[0], aiBlock[1], aiBlock[2]) != EMPTY_BLOCK;
+            }
+        }
+
+        // Corners counterclockwise in (u, v), as offsets into aabIsSolid
+        const int32_t aaiCorners[4][2] = { { 0, 0 }, { 2, 0 }, { 2, 2 }, { 0, 2 } };
+
+        uint32_t uOcclusion = 0u;
+        for (uint32_t uCorner = 0u; uCorner < 4u; ++uCorner)
+        {
+            const int32_t iU = aaiCorners[uCorner][0];
+            const int32_t iV = aaiCorners[uCorner][1];
+            const bool bIsSideUSolid = aabIsSolid[1][iU];
+            const bool bIsSideVSolid = aabIsSolid[iV][1];
+
+            uint32_t uLevel = 0u;
+            if (!bIsSideUSolid || !bIsSideVSolid)
+            {
+                uLevel = 3u - (bIsSideUSolid ? 1u : 0u) - (bIsSideVSolid ? 1u : 0u) - (aabIsSolid[iV][iU] ? 1u : 0u);
+            }
+
+            uOcclusion |= uLevel << (2u * uCorner);
+        }
+
+        return uOcclusion;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::markDirty
+      Summary:  Marks dirty the chunks of an edited block and of every
+                block around it, whose meshes show or hide faces
+                against it or shade their corners with it
+      Args:     int32_t x, int32_t y, int32_t z
+                  Coordinates of the block
+      Modifies: [m_abIsChunkDirty, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::markDirty(int32_t x, int32_t y, int32_t z)
+    {
+        const int32_t aiBlock[3] = { x, y, z };
+        int32_t aiChunkMin[3];
+        int32_t aiChunkMax[3];
+        for (int32_t a = 0; a < 3; ++a)
+        {
+            // Blocks are never negative, (x - 1) / CHUNK_SIZE would round towards zero
+            aiChunkMin[a] = aiBlock[a] > 0 ? (aiBlock[a] - 1) / static_cast<int32_t>(CHUNK_SIZE) : 0;
+            aiChunkMax[a] = (aiBlock[a] + 1) / static_cast<int32_t>(CHUNK_SIZE);
+        }
+
+        for (int32_t iChunkY = aiChunkMin[1]; iChunkY <= aiChunkMax[1]; ++iChunkY)
+        {
+            for (int32_t iChunkZ = aiChunkMin[2]; iChunkZ <= aiChunkMax[2]; ++iChunkZ)
+            {
+                for (int32_t iChunkX = aiChunkMin[0]; iChunkX <= aiChunkMax[0]; ++iChunkX)
+                {
+                    markChunkDirty(iChunkX, iChunkY, iChunkZ);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VoxelWorld::markChunkDirty
+      Summary:  Queues a chunk for remeshing once
+      Args:     int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ
+                  Coordinates of the chunk, ignored outside the world
+      Modifies: [m_abIsChunkDirty, m_auDirtyChunks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VoxelWorld::markChunkDirty(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ)
+    {
+        if (iChunkX < 0 || iChunkX >= static_cast<int32_t>(m_uNumChunksX)
+            || iChunkY < 0 || iChunkY >= static_cast<int32_t>(m_uNumChunksY)
+            || iChunkZ < 0 || iChunkZ >= static_cast<int32_t>(m_uNumChunksZ))
+        {
+            return;
+        }
+
+        const uint32_t uChunk = (static_cast<uint32_t>(iChunkY) * m_uNumChunksZ + static_cast<uint32_t>(iChunkZ)) * m_uNumChunksX + static_cast<uint32_t>(iChunkX);
+        if (!m_abIsChunkDirty[uChunk])
+        {
+            m_abIsChunkDirty[uChunk] = true;
+            m_auDirtyChunks.push_back(uChunk);
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/*+===================================================================
+  File:      VOXELWORLD.H
+
+  Summary:   VoxelWorld header file contains declaration of class
+             VoxelWorld used to store, query and edit the blocks of a
+             voxel scene, and to turn its chunks into meshes. It only
+             depends on DirectXMath and the standard library.
+
+  Classes:  VoxelHit, VoxelMesh, VoxelWorld
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "Renderer/VertexTypes.h"
+#include "Scene/BlockType.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelHit
+      Summary:  Block a ray stopped in. Block + Normal is the empty
+                block in front of the face the ray entered through.
+                Normal is zero when the ray started inside the block
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelHit
+    {
+        DirectX::XMINT3 Block;
+        DirectX::XMINT3 Normal;
+        float distance;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VoxelMesh
+      Summary:  Visible faces of the blocks of one type in a chunk, in
+                world space, with the ambient light reaching each
+                vertex, 255 when nothing occludes it
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VoxelMesh
+    {
+        eBlockType blockType;
+        std::vector<SimpleVertex> aVertices;
+        std::vector<uint16_t> aIndices;
+        std::vector<uint8_t> aAmbientOcclusion;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VoxelWorld
+      Summary:  Dense grid of blocks, split into CHUNK_SIZE cubed
+                chunks. Block (x, y, z) is the cube of size BLOCK_SIZE
+                centered where Scene::LoadVoxels used to place its
+                instance. Editing a block marks dirty every chunk
+                holding it or one of the 26 blocks around it. A chunk
+                is meshed by merging the visible faces of every slice
+                into rectangles of the same block type and corner
+                occlusion, baked from the neighbouring blocks at
+                AMBIENT_OCCLUSION_LEVELS. MeshChunk only
+                reads the blocks, so chunks may be meshed in parallel
+                as long as no block is edited meanwhile
+      Methods:  Resize
+                  Sets the size of the world and empties it
+                GetBlock
+                  Returns the type of a block
+                SetBlock
+                  Fills a block
+                ClearBlock
+                  Empties a block
+                SetBlockColor
+                  Sets the color of a block type
+                GetBlockColor
+                  Returns the color of a block type
+                Raycast
+                  Returns the first block along a ray
+                GetBlockCenter
+                  Returns the center of a block
+                GetColumnHeights
+                  Returns the number of blocks standing on the floor
+                TakeDirtyChunks
+                  Returns the chunks to remesh and forgets them
+                MeshChunk
+                  Builds the meshes of a chunk
+                GetWidth
+                  Returns the width of the world in blocks
+                GetHeight
+                  Returns the height of the world in blocks
+                GetDepth
+                  Returns the depth of the world in blocks
+                GetNumChunks
+                  Returns the number of chunks
+                VoxelWorld
+                  Constructor.
+                ~VoxelWorld
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VoxelWorld
+    {
+    public:
+        static constexpr const uint32_t CHUNK_SIZE = 16u;
+        static constexpr const float BLOCK_SIZE = 2.0f;
+        static constexpr const char EMPTY_BLOCK = 0;
+        static constexpr const uint32_t NUM_BLOCK_TYPES = static_cast<uint32_t>(eBlockType::COUNT) - static_cast<uint32_t>(eBlockType::GRASSLAND);
+        static constexpr const uint8_t AMBIENT_OCCLUSION_LEVELS[4] = { 89u, 140u, 191u, 255u };
+
+    public:
+        VoxelWorld();
+        VoxelWorld(const VoxelWorld& other) = delete;
+        VoxelWorld(VoxelWorld&& other) = delete;
+        VoxelWorld& operator=(const VoxelWorld& other) = delete;
+        VoxelWorld& operator=(VoxelWorld&& other) = delete;
+        ~VoxelWorld() = default;
+
+        void Resize(uint32_t uWidth, uint32_t uHeight, uint32_t uDepth);
+
+        char GetBlock(int32_t x, int32_t y, int32_t z) const;
+        bool SetBlock(int32_t x, int32_t y, int32_t z, eBlockType blockType);
+        bool ClearBlock(int32_t x, int32_t y, int32_t z);
+
+        void SetBlockColor(eBlockType blockType, const DirectX::XMFLOAT4& color);
+        const DirectX::XMFLOAT4& GetBlockColor(eBlockType blockType) const;
+
+        bool Raycast(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, VoxelHit& outHit) const;
+        DirectX::XMVECTOR GetBlockCenter(int32_t x, int32_t y, int32_t z) const;
+        void GetColumnHeights(std::vector<uint32_t>& auOutHeights) const;
+
+        void TakeDirtyChunks(std::vector<uint32_t>& auOutChunks);
+        void MeshChunk(uint32_t uChunk, std::vector<VoxelMesh>& aOutMeshes) const;
+
+        uint32_t GetWidth() const;
+        uint32_t GetHeight() const;
+        uint32_t GetDepth() const;
+        uint32_t GetNumChunks() const;
+
+    private:
+        bool isInside(int32_t x, int32_t y, int32_t z) const;
+        size_t getBlockIndex(int32_t x, int32_t y, int32_t z) const;
+        uint32_t getFaceOcclusion(const int32_t* aiFront, int32_t u, int32_t v) const;
+        void markDirty(int32_t x, int32_t y, int32_t z);
+        void markChunkDirty(int32_t iChunkX, int32_t iChunkY, int32_t iChunkZ);
+
+    private:
+        uint32_t m_uWidth;
+        uint32_t m_uHeight;
+        uint32_t m_uDepth;
+        uint32_t m_uNumChunksX;
+        uint32_t m_uNumChunksY;
+        uint32_t m_uNumChunksZ;
+        DirectX::XMFLOAT3 m_origin;
+        std::vector<char> m_aBlocks;
+        std::vector<bool> m_abIsChunkDirty;
+        std::vector<uint32_t> m_auDirtyChunks;
+        DirectX::XMFLOAT4 m_aBlockColors[NUM_BLOCK_TYPES];
+    };
+}
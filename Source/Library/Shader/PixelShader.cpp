@@ -16,11 +16,35 @@ namespace library
                   Specifies the shader target or set of shader features
                   to compile against
 
-      Modifies: [m_pixelShader].
+      Modifies: [m_pixelShader, m_permutations, m_variants].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     PixelShader::PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
         : Shader(pszFileName, pszEntryPoint, pszShaderModel)
         , m_pixelShader(nullptr)
+        , m_permutations()
+        , m_variants()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::PixelShader
+
+      Summary:  Constructor of a shader built from precompiled bytecode
+
+      Args:     std::span<const BYTE> bytecode
+                  Bytecode of the default permutation
+                PCSTR pszEntryPoint
+                  Name of the shader entry point the bytecode was
+                  compiled from
+                PCSTR pszShaderModel
+                  Shader target the bytecode was compiled against
+
+      Modifies: [m_pixelShader, m_permutations, m_variants].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PixelShader::PixelShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+        : Shader(bytecode, pszEntryPoint, pszShaderModel)
+        , m_pixelShader(nullptr)
+        , m_permutations()
+        , m_variants()
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -72,4 +96,125 @@ namespace library
     {
         return m_pixelShader;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::GetPixelShader
+
+      Summary:  Returns the variant of a permutation. It is compiled
+                on first use, and permutations that preprocess to the
+                same source share one shader. Falls back to the default
+                variant when the permutation cannot be compiled
+                or is not embedded, which compile reports
+
+      Args:     const ShaderPermutation& permutation
+                  Features and light count of the variant
+
+      Modifies: [m_permutations, m_variants].
+
+      Returns:  ComPtr<ID3D11PixelShader>&
+                  Pixel shader. Could be a nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11PixelShader>& PixelShader::GetPixelShader(_In_ const ShaderPermutation& permutation)
+    {
+        auto it = m_permutations.find(permutation.GetKey());
+        if (it != m_permutations.end())
+        {
+            return it->second;
+        }
+
+        ComPtr<ID3D11PixelShader>& pixelShader = m_permutations[permutation.GetKey()];
+        pixelShader = m_pixelShader;
+        if (!m_pixelShader)
+        {
+            return pixelShader;
+        }
+
+        ComPtr<ID3DBlob> pPSBlob = nullptr;
+        UINT64 uSourceKey = 0ull;
+        if (FAILED(compile(permutation, pPSBlob.GetAddressOf(), uSourceKey)) || uSourceKey == m_uSourceKey)
+        {
+            return pixelShader;
+        }
+
+        auto variant = m_variants.find(uSourceKey);
+        if (variant != m_variants.end())
+        {
+            pixelShader = variant->second;
+            return pixelShader;
+        }
+
+        // Variants are created on the device of the default one
+        ComPtr<ID3D11Device> device = nullptr;
+        m_pixelShader->GetDevice(device.GetAddressOf());
+
+        ComPtr<ID3D11PixelShader> compiledPixelShader = nullptr;
+        if (SUCCEEDED(device->CreatePixelShader(pPSBlob->GetBufferPointer(), pPSBlob->GetBufferSize(), nullptr, compiledPixelShader.GetAddressOf())))
+        {
+            m_variants[uSourceKey] = compiledPixelShader;
+            pixelShader = compiledPixelShader;
+        }
+
+        return pixelShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::Reload
+
+      Summary:  Initializes the shader again from its file and recreates
+                the permutations that were in use. The previous shader
+                is restored if anything fails. Must be called between
+                two frames
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the pixel shader
+
+      Modifies: [m_pixelShader, m_permutations, m_variants,
+                 m_uSourceKey].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT PixelShader::Reload(_In_ ID3D11Device* pDevice)
+    {
+        std::vector<UINT> aPermutationKeys;
+        GetPermutationKeys(aPermutationKeys);
+
+        ComPtr<ID3D11PixelShader> previousPixelShader = std::move(m_pixelShader);
+        UINT64 uPreviousSourceKey = m_uSourceKey;
+
+        HRESULT hr = Initialize(pDevice);
+        if (FAILED(hr))
+        {
+            m_pixelShader = std::move(previousPixelShader);
+            m_uSourceKey = uPreviousSourceKey;
+            return hr;
+        }
+
+        m_permutations.clear();
+        m_variants.clear();
+        for (UINT uPermutationKey : aPermutationKeys)
+        {
+            GetPixelShader(ShaderPermutation::FromKey(uPermutationKey));
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::GetPermutationKeys
+
+      Summary:  Returns the keys of the permutations requested so far
+
+      Args:     std::vector<UINT>& aOutPermutationKeys
+                  Keys of the permutations
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PixelShader::GetPermutationKeys(_Out_ std::vector<UINT>& aOutPermutationKeys) const
+    {
+        aOutPermutationKeys.clear();
+        aOutPermutationKeys.reserve(m_permutations.size());
+        for (const auto& [uPermutationKey, pixelShader] : m_permutations)
+        {
+            aOutPermutationKeys.push_back(uPermutationKey);
+        }
+    }
 }
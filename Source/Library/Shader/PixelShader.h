@@ -25,7 +25,14 @@ namespace library
       Methods:  Initialize
                   Initializes and compiles the pixel shader
                 GetPixelShader
-                  Returns the reference to the D3D11 pixel shader
+                  Returns the reference to the D3D11 pixel shader, or
+                  to the variant of a permutation, compiled on first
+                  use
+                Reload
+                  Recreates the shader and the permutations in use,
+                  keeping the old ones on failure
+                GetPermutationKeys
+                  Returns the keys of the permutations in use
                 Game
                   Constructor.
                 ~Game
@@ -36,6 +43,7 @@ namespace library
     public:
         PixelShader() = delete;
         PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        PixelShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
         PixelShader(const PixelShader& other) = delete;
         PixelShader(PixelShader&& other) = delete;
         PixelShader& operator=(const PixelShader& other) = delete;
@@ -43,10 +51,15 @@ namespace library
         virtual ~PixelShader() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+        virtual HRESULT Reload(_In_ ID3D11Device* pDevice) override;
+        virtual void GetPermutationKeys(_Out_ std::vector<UINT>& aOutPermutationKeys) const override;
 
         ComPtr<ID3D11PixelShader>& GetPixelShader();
+        ComPtr<ID3D11PixelShader>& GetPixelShader(_In_ const ShaderPermutation& permutation);
 
     protected:
         ComPtr<ID3D11PixelShader> m_pixelShader;
+        std::unordered_map<UINT, ComPtr<ID3D11PixelShader>> m_permutations;
+        std::unordered_map<UINT64, ComPtr<ID3D11PixelShader>> m_variants;
     };
 }
\ No newline at end of file
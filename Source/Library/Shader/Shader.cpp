@@ -1,7 +1,89 @@
 #include "Shader.h"
 
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+#include "Utility/Hash.h"
+
 namespace library
 {
+    namespace
+    {
+        /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+          Class:    IncludeRecorder
+
+          Summary:  Include handler resolving includes relative to the
+                    including file, like the standard one, and recording
+                    which file included which. The opened sources live as
+                    long as the handler
+
+          Methods:  Open
+                      Reads an included file
+                    Close
+                      Does nothing, sources are released with the handler
+        C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+        class IncludeRecorder : public ID3DInclude
+        {
+        public:
+            IncludeRecorder(_In_ const std::filesystem::path& sourcePath)
+                : m_sourcePath(sourcePath)
+                , m_aSources()
+                , m_openedFiles()
+                , m_includes()
+            { }
+
+            HRESULT __stdcall Open(
+                _In_ D3D_INCLUDE_TYPE includeType,
+                _In_ LPCSTR pszFileName,
+                _In_ LPCVOID pParentData,
+                _Outptr_ LPCVOID* ppData,
+                _Out_ UINT* puBytes
+            ) override
+            {
+                UNREFERENCED_PARAMETER(includeType);
+
+                auto parent = m_openedFiles.find(pParentData);
+                const std::filesystem::path& parentPath = parent != m_openedFiles.end() ? parent->second : m_sourcePath;
+                std::filesystem::path filePath = (parentPath.parent_path() / pszFileName).lexically_normal();
+
+                std::ifstream file(filePath, std::ios::binary);
+                if (!file)
+                {
+                    return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+                }
+
+                m_aSources.push_back(std::make_unique<std::string>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+                *ppData = m_aSources.back()->data();
+                *puBytes = static_cast<UINT>(m_aSources.back()->size());
+
+                m_includes[parentPath].push_back(filePath);
+                m_openedFiles[*ppData] = std::move(filePath);
+
+                return S_OK;
+            }
+
+            HRESULT __stdcall Close(_In_ LPCVOID pData) override
+            {
+                UNREFERENCED_PARAMETER(pData);
+                return S_OK;
+            }
+
+            std::map<std::filesystem::path, std::vector<std::filesystem::path>>& GetIncludes()
+            {
+                return m_includes;
+            }
+
+        private:
+            std::filesystem::path m_sourcePath;
+            std::vector<std::unique_ptr<std::string>> m_aSources;
+            std::unordered_map<LPCVOID, std::filesystem::path> m_openedFiles;
+            std::map<std::filesystem::path, std::vector<std::filesystem::path>> m_includes;
+        };
+    }
+
+    std::shared_ptr<ShaderCache> Shader::sm_pShaderCache = std::make_shared<ShaderCache>(L"ShaderCache/Shaders.cache");
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Shader::Shader
 
@@ -16,12 +98,47 @@ namespace library
                   Specifies the shader target or set of shader features
                   to compile against
 
-      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel].
+      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel,
+                 m_uSourceKey, m_bytecode, m_embeddedPermutations,
+                 m_includes].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Shader::Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
         : m_pszFileName(pszFileName)
         , m_pszEntryPoint(pszEntryPoint)
         , m_pszShaderModel(pszShaderModel)
+        , m_uSourceKey(0ull)
+        , m_bytecode()
+        , m_embeddedPermutations()
+        , m_includes()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::Shader
+
+      Summary:  Constructor of a shader built from precompiled bytecode.
+                Nothing is read from the disk or compiled at runtime
+
+      Args:     std::span<const BYTE> bytecode
+                  Bytecode of the default permutation. It must outlive
+                  the shader
+                PCSTR pszEntryPoint
+                  Name of the shader entry point the bytecode was
+                  compiled from
+                PCSTR pszShaderModel
+                  Shader target the bytecode was compiled against
+
+      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel,
+                 m_uSourceKey, m_bytecode, m_embeddedPermutations,
+                 m_includes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Shader::Shader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+        : m_pszFileName(L"")
+        , m_pszEntryPoint(pszEntryPoint)
+        , m_pszShaderModel(pszShaderModel)
+        , m_uSourceKey(0ull)
+        , m_bytecode(bytecode)
+        , m_embeddedPermutations()
+        , m_includes()
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -37,21 +154,179 @@ namespace library
         return m_pszFileName;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::AddPermutation
+
+      Summary:  Adds the precompiled bytecode of a permutation to a
+                shader built from bytecode. Requesting a permutation
+                without bytecode is reported and asserts
+
+      Args:     const ShaderPermutation& permutation
+                  Features and light count the bytecode was compiled
+                  with
+                std::span<const BYTE> bytecode
+                  Bytecode. It must outlive the shader
+
+      Modifies: [m_embeddedPermutations].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Shader::AddPermutation(_In_ const ShaderPermutation& permutation, _In_ std::span<const BYTE> bytecode)
+    {
+        m_embeddedPermutations[permutation.GetKey()] = bytecode;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::Precompile
+
+      Summary:  Compiles the default permutation and the given ones
+                into the shader cache. No member is written, so it can
+                run on a worker thread while the shader is in use, and
+                the Reload that follows only hits the cache
+
+      Args:     const std::vector<UINT>& aPermutationKeys
+                  Keys of the permutations to compile
+
+      Returns:  HRESULT
+                  Status code of the first failed compilation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Shader::Precompile(_In_ const std::vector<UINT>& aPermutationKeys)
+    {
+        ComPtr<ID3DBlob> pBlob = nullptr;
+        UINT64 uSourceKey = 0ull;
+
+        HRESULT hr = compile(ShaderPermutation(), pBlob.GetAddressOf(), uSourceKey);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        for (UINT uPermutationKey : aPermutationKeys)
+        {
+            hr = compile(ShaderPermutation::FromKey(uPermutationKey), pBlob.ReleaseAndGetAddressOf(), uSourceKey);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetIncludes
+
+      Summary:  Returns the files included while compiling the default
+                permutation, keyed by the file including them
+
+      Returns:  const std::map<std::filesystem::path, std::vector<std::filesystem::path>>&
+                  Included files. Empty for shaders built from bytecode
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::map<std::filesystem::path, std::vector<std::filesystem::path>>& Shader::GetIncludes() const
+    {
+        return m_includes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetShaderCache
+
+      Summary:  Returns the bytecode cache shared by every shader
+
+      Returns:  const std::shared_ptr<ShaderCache>&
+                  Shader cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<ShaderCache>& Shader::GetShaderCache()
+    {
+        return sm_pShaderCache;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Shader::compile
 
-      Summary:  Compiles the given shader file
+      Summary:  Compiles the default permutation of the shader file,
+                the one every define falls back to
 
       Args:     ID3DBlob** ppOutBlob
                   Receives a pointer to the ID3DBlob interface that you
                   can use to access the compiled code
 
+      Modifies: [m_uSourceKey, m_includes].
+
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Shader::compile(_Outptr_ ID3DBlob** ppOutBlob)
+    {
+        return compile(ShaderPermutation(), ppOutBlob, m_uSourceKey, &m_includes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::compile
+
+      Summary:  Preprocesses the given shader file with the defines of
+                a permutation and looks the result up in the shader
+                cache. Only compiles on a miss, from the preprocessed
+                source, and stores the bytecode
+
+      Args:     const ShaderPermutation& permutation
+                  Features and light count to compile with
+                ID3DBlob** ppOutBlob
+                  Receives a pointer to the ID3DBlob interface that you
+                  can use to access the compiled code
+                UINT64& uOutSourceKey
+                  Key of the preprocessed source. Permutations whose
+                  defines the file does not read share the same key
+                std::map<std::filesystem::path, std::vector<std::filesystem::path>>* pOutIncludes
+                  Receives the files included by each file, if not
+                  a nullptr
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Shader::compile(
+        _In_ const ShaderPermutation& permutation,
+        _Outptr_ ID3DBlob** ppOutBlob,
+        _Out_ UINT64& uOutSourceKey,
+        _Out_opt_ std::map<std::filesystem::path, std::vector<std::filesystem::path>>* pOutIncludes
+    )
     {
         HRESULT hr = S_OK;
+        uOutSourceKey = 0ull;
+        if (pOutIncludes)
+        {
+            pOutIncludes->clear();
+        }
+
+        if (!m_bytecode.empty())
+        {
+            std::span<const BYTE> bytecode = m_bytecode;
+            if (permutation.GetKey() != ShaderPermutation().GetKey())
+            {
+                auto it = m_embeddedPermutations.find(permutation.GetKey());
+                if (it == m_embeddedPermutations.end())
+                {
+                    // EMBEDDED_SHADER_REQUESTS misses a permutation the scene asks for
+                    CHAR szMessage[128];
+                    sprintf_s(szMessage, "Permutation 0x%X of %s is not embedded\n", permutation.GetKey(), m_pszEntryPoint);
+                    OutputDebugStringA(szMessage);
+                    assert(!"Requested a shader permutation that is not embedded");
+
+                    return HRESULT_FROM_WIN32(ERROR_NOT_FOUND);
+                }
+                bytecode = it->second;
+            }
+
+            // Identical bytecode gets the same key, so duplicated permutations share a shader
+            uOutSourceKey = Hash::Fnv1a(bytecode.data(), bytecode.size());
+
+            hr = D3DCreateBlob(bytecode.size(), ppOutBlob);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            memcpy((*ppOutBlob)->GetBufferPointer(), bytecode.data(), bytecode.size());
+
+            return S_OK;
+        }
 
         DWORD dwShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
 #ifdef _DEBUG
@@ -59,9 +334,93 @@ namespace library
         dwShaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        std::ifstream file(m_pszFileName, std::ios::binary);
+        if (!file)
+        {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::string szSourceName = std::filesystem::path(m_pszFileName).string();
+        IncludeRecorder includeRecorder(std::filesystem::path(m_pszFileName).lexically_normal());
+
+        std::vector<ShaderDefine> aDefines;
+        permutation.GetDefines(aDefines);
+
+        std::vector<D3D_SHADER_MACRO> aMacros;
+        aMacros.reserve(aDefines.size() + 1u);
+        for (const ShaderDefine& define : aDefines)
+        {
+            aMacros.push_back({ .Name = define.szName.c_str(), .Definition = define.szValue.c_str() });
+        }
+        aMacros.push_back({ .Name = nullptr, .Definition = nullptr });
+
+        ComPtr<ID3DBlob> pPreprocessedBlob = nullptr;
         ComPtr<ID3DBlob> pErrorBlob = nullptr;
 
-        hr = D3DCompileFromFile(m_pszFileName, nullptr, nullptr, m_pszEntryPoint, m_pszShaderModel, dwShaderFlags, 0u, ppOutBlob, pErrorBlob.GetAddressOf());
+        hr = D3DPreprocess(
+            source.data(),
+            source.size(),
+            szSourceName.c_str(),
+            aMacros.data(),
+            &includeRecorder,
+            pPreprocessedBlob.GetAddressOf(),
+            pErrorBlob.GetAddressOf()
+        );
+
+        if (FAILED(hr))
+        {
+            if (pErrorBlob)
+            {
+                OutputDebugStringA(reinterpret_cast<const char*>(pErrorBlob->GetBufferPointer()));
+            }
+            return hr;
+        }
+
+        if (pOutIncludes)
+        {
+            *pOutIncludes = std::move(includeRecorder.GetIncludes());
+        }
+
+        std::string_view preprocessedSource(static_cast<const char*>(pPreprocessedBlob->GetBufferPointer()), pPreprocessedBlob->GetBufferSize());
+        // The defines are already expanded in the preprocessed source, so they are left out of the key
+        UINT64 uKey = ShaderCache::ComputeKey(preprocessedSource, m_pszEntryPoint, m_pszShaderModel, {}, dwShaderFlags, D3D_COMPILER_VERSION);
+        uOutSourceKey = uKey;
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        sm_pShaderCache->AddPreprocessTime(elapsed.count());
+
+        std::vector<uint8_t> aBytecode;
+        if (sm_pShaderCache->Find(uKey, aBytecode))
+        {
+            hr = D3DCreateBlob(aBytecode.size(), ppOutBlob);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            memcpy((*ppOutBlob)->GetBufferPointer(), aBytecode.data(), aBytecode.size());
+
+            return S_OK;
+        }
+
+        start = std::chrono::steady_clock::now();
+
+        hr = D3DCompile(
+            preprocessedSource.data(),
+            preprocessedSource.size(),
+            szSourceName.c_str(),
+            nullptr,
+            nullptr,
+            m_pszEntryPoint,
+            m_pszShaderModel,
+            dwShaderFlags,
+            0u,
+            ppOutBlob,
+            pErrorBlob.ReleaseAndGetAddressOf()
+        );
 
         if (FAILED(hr))
         {
@@ -72,6 +431,9 @@ namespace library
             return hr;
         }
 
+        elapsed = std::chrono::steady_clock::now() - start;
+        sm_pShaderCache->Store(uKey, (*ppOutBlob)->GetBufferPointer(), (*ppOutBlob)->GetBufferSize(), elapsed.count());
+
         return S_OK;
     }
 }
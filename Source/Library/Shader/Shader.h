@@ -13,6 +13,12 @@
 
 #include "Common.h"
 
+#include <map>
+#include <span>
+
+#include "Shader/ShaderCache.h"
+#include "Shader/ShaderPermutation.h"
+
 namespace library
 {
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
@@ -24,8 +30,24 @@ namespace library
                   Pure virtual function that initializes the shader
                 GetFileName
                   Returns the name of the shader file to be compiled
+                AddPermutation
+                  Adds the precompiled bytecode of a permutation
+                Precompile
+                  Fills the shader cache with the given permutations
+                  without creating any shader. Safe on worker threads
+                Reload
+                  Pure virtual function that recreates the shader and
+                  its permutations from the changed file
+                GetPermutationKeys
+                  Pure virtual function that returns the keys of the
+                  permutations in use
+                GetIncludes
+                  Returns the files included by the shader file
+                GetShaderCache
+                  Returns the bytecode cache shared by every shader
                 compile
-                  Compiles the given shader file
+                  Compiles the given shader file, or one permutation
+                  of it, or fetches its bytecode from the shader cache
                 Game
                   Constructor.
                 ~Game
@@ -36,6 +58,7 @@ namespace library
     public:
         Shader() = delete;
         Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        Shader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
         Shader(const Shader& other) = delete;
         Shader(Shader&& other) = delete;
         Shader& operator=(const Shader& other) = delete;
@@ -44,12 +67,32 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) = 0;
         PCWSTR GetFileName() const;
+        void AddPermutation(_In_ const ShaderPermutation& permutation, _In_ std::span<const BYTE> bytecode);
+
+        HRESULT Precompile(_In_ const std::vector<UINT>& aPermutationKeys);
+        virtual HRESULT Reload(_In_ ID3D11Device* pDevice) = 0;
+        virtual void GetPermutationKeys(_Out_ std::vector<UINT>& aOutPermutationKeys) const = 0;
+        const std::map<std::filesystem::path, std::vector<std::filesystem::path>>& GetIncludes() const;
+
+        static const std::shared_ptr<ShaderCache>& GetShaderCache();
 
     protected:
         HRESULT compile(_Outptr_ ID3DBlob** ppOutBlob);
+        HRESULT compile(
+            _In_ const ShaderPermutation& permutation,
+            _Outptr_ ID3DBlob** ppOutBlob,
+            _Out_ UINT64& uOutSourceKey,
+            _Out_opt_ std::map<std::filesystem::path, std::vector<std::filesystem::path>>* pOutIncludes = nullptr
+        );
 
         PCWSTR m_pszFileName;
         PCSTR m_pszEntryPoint;
         PCSTR m_pszShaderModel;
+        UINT64 m_uSourceKey;
+        std::span<const BYTE> m_bytecode;
+        std::unordered_map<UINT, std::span<const BYTE>> m_embeddedPermutations;
+        std::map<std::filesystem::path, std::vector<std::filesystem::path>> m_includes;
+
+        static std::shared_ptr<ShaderCache> sm_pShaderCache;
     };
 }
\ No newline at end of file
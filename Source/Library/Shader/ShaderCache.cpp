@@ -0,0 +1,323 @@
+#include "Shader/ShaderCache.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "Utility/Hash.h"
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FileHeader
+          Summary:  Header of the cache file
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FileHeader
+        {
+            uint32_t uMagic;
+            uint32_t uVersion;
+            uint32_t uNumEntries;
+            uint32_t uReserved;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   EntryHeader
+          Summary:  Header preceding the bytecode of every entry
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct EntryHeader
+        {
+            uint64_t uKey;
+            uint64_t uChecksum;
+            uint64_t uSize;
+        };
+
+        constexpr const uint64_t MAX_ENTRY_SIZE = 64ull * 1024ull * 1024ull;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: hashString
+          Summary:  Mixes a string and its length into a running hash, so
+                    that neighbouring strings cannot trade characters
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        uint64_t hashString(uint64_t uHash, std::string_view sz)
+        {
+            return Hash::Fnv1a(sz, Hash::Combine(uHash, sz.size()));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::ShaderCache
+      Summary:  Constructor
+      Args:     const std::filesystem::path& filePath
+                  Path to the cache file
+      Modifies: [m_filePath, m_mutex, m_entries, m_stats, m_bIsDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCache::ShaderCache(const std::filesystem::path& filePath)
+        : m_filePath(filePath)
+        , m_mutex()
+        , m_entries()
+        , m_stats()
+        , m_bIsDirty(false)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::ComputeKey
+      Summary:  Returns the key of a compilation. Every string is
+                hashed with its length so no two different inputs share
+                a byte stream
+      Args:     std::string_view preprocessedSource
+                  Source after the preprocessor, includes expanded
+                std::string_view szEntryPoint
+                  Entry point function
+                std::string_view szShaderModel
+                  Shader target
+                const std::vector<ShaderDefine>& aDefines
+                  Defines in the order they are passed
+                uint32_t uFlags
+                  Compile flags
+                uint32_t uCompilerVersion
+                  Version of the compiler
+      Returns:  uint64_t
+                  Key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t ShaderCache::ComputeKey(
+        std::string_view preprocessedSource,
+        std::string_view szEntryPoint,
+        std::string_view szShaderModel,
+        const std::vector<ShaderDefine>& aDefines,
+        uint32_t uFlags,
+        uint32_t uCompilerVersion
+    )
+    {
+        uint64_t uHash = Hash::FNV_OFFSET_BASIS;
+        uHash = hashString(uHash, preprocessedSource);
+        uHash = hashString(uHash, szEntryPoint);
+        uHash = hashString(uHash, szShaderModel);
+
+        uHash = Hash::Combine(uHash, aDefines.size());
+        for (const ShaderDefine& define : aDefines)
+        {
+            uHash = hashString(uHash, define.szName);
+            uHash = hashString(uHash, define.szValue);
+        }
+
+        uHash = Hash::Combine(uHash, uFlags);
+        uHash = Hash::Combine(uHash, uCompilerVersion);
+
+        return uHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Load
+      Summary:  Reads every entry of the cache file. Entries are only
+                kept when the whole file is intact
+      Modifies: [m_entries, m_stats, m_bIsDirty].
+      Returns:  bool
+                  true if the file existed and was valid
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool ShaderCache::Load()
+    {
+        std::ifstream file(m_filePath, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        FileHeader header = {};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.uMagic != FILE_MAGIC || header.uVersion != FILE_VERSION)
+        {
+            return false;
+        }
+
+        std::unordered_map<uint64_t, std::vector<uint8_t>> entries;
+        entries.reserve(header.uNumEntries);
+        for (uint32_t i = 0u; i < header.uNumEntries; ++i)
+        {
+            EntryHeader entryHeader = {};
+            file.read(reinterpret_cast<char*>(&entryHeader), sizeof(entryHeader));
+            if (!file || entryHeader.uSize > MAX_ENTRY_SIZE)
+            {
+                return false;
+            }
+
+            std::vector<uint8_t> aBytecode(static_cast<size_t>(entryHeader.uSize));
+            file.read(reinterpret_cast<char*>(aBytecode.data()), static_cast<std::streamsize>(aBytecode.size()));
+            if (!file || Hash::Fnv1a(aBytecode.data(), aBytecode.size()) != entryHeader.uChecksum)
+            {
+                return false;
+            }
+
+            entries[entryHeader.uKey] = std::move(aBytecode);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries = std::move(entries);
+        m_stats.uNumEntries = m_entries.size();
+        m_bIsDirty = false;
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Save
+      Summary:  Writes every entry to a temporary file and moves it over
+                the cache file, so a crash never leaves half a cache
+                behind. Does nothing when no shader was compiled
+      Modifies: [m_bIsDirty].
+      Returns:  bool
+                  true if the file is up to date
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool ShaderCache::Save()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_bIsDirty)
+        {
+            return true;
+        }
+
+        std::error_code errorCode;
+        if (m_filePath.has_parent_path())
+        {
+            std::filesystem::create_directories(m_filePath.parent_path(), errorCode);
+        }
+
+        std::filesystem::path temporaryPath = m_filePath;
+        temporaryPath += ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return false;
+            }
+
+            FileHeader header =
+            {
+                .uMagic = FILE_MAGIC,
+                .uVersion = FILE_VERSION,
+                .uNumEntries = static_cast<uint32_t>(m_entries.size()),
+                .uReserved = 0u
+            };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for (const auto& [uKey, aBytecode] : m_entries)
+            {
+                EntryHeader entryHeader =
+                {
+                    .uKey = uKey,
+                    .uChecksum = Hash::Fnv1a(aBytecode.data(), aBytecode.size()),
+                    .uSize = aBytecode.size()
+                };
+                file.write(reinterpret_cast<const char*>(&entryHeader), sizeof(entryHeader));
+                file.write(reinterpret_cast<const char*>(aBytecode.data()), static_cast<std::streamsize>(aBytecode.size()));
+            }
+
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, m_filePath, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+
+        m_bIsDirty = false;
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Find
+      Summary:  Copies the bytecode stored under a key
+      Args:     uint64_t uKey
+                  Key returned by ComputeKey
+                std::vector<uint8_t>& aOutBytecode
+                  Bytecode
+      Modifies: [m_stats].
+      Returns:  bool
+                  true on a hit
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool ShaderCache::Find(uint64_t uKey, std::vector<uint8_t>& aOutBytecode)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(uKey);
+        if (it == m_entries.end())
+        {
+            ++m_stats.uNumMisses;
+            return false;
+        }
+
+        ++m_stats.uNumHits;
+        aOutBytecode = it->second;
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Store
+      Summary:  Adds freshly compiled bytecode
+      Args:     uint64_t uKey
+                  Key returned by ComputeKey
+                const void* pBytecode
+                  Bytecode
+                size_t uSize
+                  Size of the bytecode
+                double compileSeconds
+                  Time the compiler took
+      Modifies: [m_entries, m_stats, m_bIsDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderCache::Store(uint64_t uKey, const void* pBytecode, size_t uSize, double compileSeconds)
+    {
+        const uint8_t* pBytes = static_cast<const uint8_t*>(pBytecode);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[uKey].assign(pBytes, pBytes + uSize);
+        m_stats.uNumEntries = m_entries.size();
+        m_stats.compileSeconds += compileSeconds;
+        m_bIsDirty = true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::AddPreprocessTime
+      Summary:  Accumulates the time spent preprocessing and hashing
+                sources, paid on hits as well as on misses
+      Args:     double seconds
+                  Time to add
+      Modifies: [m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderCache::AddPreprocessTime(double seconds)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.preprocessSeconds += seconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Clear
+      Summary:  Drops every entry. The file is emptied at the next Save
+      Modifies: [m_entries, m_stats, m_bIsDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_stats.uNumEntries = 0u;
+        m_bIsDirty = true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::GetStats
+      Summary:  Returns the hit, miss and timing counters
+      Returns:  ShaderCacheStats
+                  Counters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCacheStats ShaderCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+}
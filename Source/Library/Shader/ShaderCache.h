@@ -0,0 +1,118 @@
+/*+===================================================================
+  File:      SHADERCACHE.H
+
+  Summary:   ShaderCache header file contains declaration of class
+             ShaderCache used to keep compiled shader bytecode on disk
+             between runs. It only depends on the standard library.
+
+  Classes:  ShaderDefine, ShaderCacheStats, ShaderCache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderDefine
+      Summary:  Preprocessor define passed to the shader compiler
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderDefine
+    {
+        std::string szName;
+        std::string szValue;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCacheStats
+      Summary:  Counters and timings exposed by the shader cache
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCacheStats
+    {
+        uint64_t uNumHits;
+        uint64_t uNumMisses;
+        uint64_t uNumEntries;
+        double preprocessSeconds;
+        double compileSeconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShaderCache
+      Summary:  Bytecode store keyed by a hash of everything that can
+                change the output of the compiler: the preprocessed
+                source with its includes, the entry point, the shader
+                model, the defines, the flags and the compiler version.
+                Entries live in one file that is read whole at startup
+                and rewritten when new shaders were compiled. Every
+                entry carries a checksum, and a damaged file is ignored
+      Methods:  ComputeKey
+                  Returns the key of a compilation
+                Load
+                  Reads the cache file
+                Save
+                  Writes the cache file if it changed
+                Find
+                  Returns the bytecode of a key
+                Store
+                  Adds the bytecode of a key
+                AddPreprocessTime
+                  Accumulates the time spent hashing sources
+                Clear
+                  Drops every entry
+                GetStats
+                  Returns the hit, miss and timing counters
+                ShaderCache
+                  Constructor.
+                ~ShaderCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShaderCache
+    {
+    public:
+        static constexpr const uint32_t FILE_MAGIC = 0x43435348u; // "HSCC"
+        static constexpr const uint32_t FILE_VERSION = 1u;
+
+    public:
+        ShaderCache() = delete;
+        explicit ShaderCache(const std::filesystem::path& filePath);
+        ShaderCache(const ShaderCache& other) = delete;
+        ShaderCache(ShaderCache&& other) = delete;
+        ShaderCache& operator=(const ShaderCache& other) = delete;
+        ShaderCache& operator=(ShaderCache&& other) = delete;
+        virtual ~ShaderCache() = default;
+
+        static uint64_t ComputeKey(
+            std::string_view preprocessedSource,
+            std::string_view szEntryPoint,
+            std::string_view szShaderModel,
+            const std::vector<ShaderDefine>& aDefines,
+            uint32_t uFlags,
+            uint32_t uCompilerVersion
+        );
+
+        bool Load();
+        bool Save();
+
+        bool Find(uint64_t uKey, std::vector<uint8_t>& aOutBytecode);
+        void Store(uint64_t uKey, const void* pBytecode, size_t uSize, double compileSeconds);
+        void AddPreprocessTime(double seconds);
+        void Clear();
+
+        ShaderCacheStats GetStats() const;
+
+    private:
+        std::filesystem::path m_filePath;
+        mutable std::mutex m_mutex;
+        std::unordered_map<uint64_t, std::vector<uint8_t>> m_entries;
+        ShaderCacheStats m_stats;
+        bool m_bIsDirty;
+    };
+}
@@ -0,0 +1,171 @@
+#include "Shader/ShaderPermutation.h"
+
+#include <iterator>
+#include <string>
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FeatureDefine
+          Summary:  Name of the define of a feature
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FeatureDefine
+        {
+            eShaderFeature feature;
+            const char* pszName;
+        };
+
+        constexpr const FeatureDefine FEATURE_DEFINES[] =
+        {
+            { eShaderFeature::NORMAL_MAP, "NORMAL_MAP" },
+            { eShaderFeature::SKINNING, "SKINNING" },
+            { eShaderFeature::SHADOWS, "SHADOWS" },
+            { eShaderFeature::PACKED_VERTICES, "PACKED_VERTICES" },
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::ShaderPermutation
+      Summary:  Constructor of the variant without features, lit by
+                every light
+      Modifies: [m_uFeatures, m_uNumLights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderPermutation::ShaderPermutation()
+        : m_uFeatures(0u)
+        , m_uNumLights(NUM_LIGHTS)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::ShaderPermutation
+      Summary:  Constructor
+      Args:     uint32_t uFeatures
+                  Bitwise or of eShaderFeature values
+                uint32_t uNumLights
+                  Number of lights, rounded up to its bucket
+      Modifies: [m_uFeatures, m_uNumLights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderPermutation::ShaderPermutation(uint32_t uFeatures, uint32_t uNumLights)
+        : m_uFeatures(uFeatures & FEATURE_MASK)
+        , m_uNumLights(NUM_LIGHTS)
+    {
+        SetNumLights(uNumLights);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::Enable
+      Summary:  Adds a feature
+      Args:     eShaderFeature feature
+                  Feature to add
+      Modifies: [m_uFeatures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderPermutation::Enable(eShaderFeature feature)
+    {
+        m_uFeatures |= static_cast<uint32_t>(feature);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::Disable
+      Summary:  Removes a feature
+      Args:     eShaderFeature feature
+                  Feature to remove
+      Modifies: [m_uFeatures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderPermutation::Disable(eShaderFeature feature)
+    {
+        m_uFeatures &= ~static_cast<uint32_t>(feature);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::HasFeature
+      Summary:  Returns whether a feature is enabled
+      Args:     eShaderFeature feature
+                  Feature to test
+      Returns:  bool
+                  true if the feature is enabled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool ShaderPermutation::HasFeature(eShaderFeature feature) const
+    {
+        return (m_uFeatures & static_cast<uint32_t>(feature)) != 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::SetNumLights
+      Summary:  Selects the smallest power of two that holds the given
+                number of lights, capped at NUM_LIGHTS
+      Args:     uint32_t uNumLights
+                  Number of lights
+      Modifies: [m_uNumLights].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderPermutation::SetNumLights(uint32_t uNumLights)
+    {
+        uint32_t uBucket = 1u;
+        while (uBucket < uNumLights && uBucket < NUM_LIGHTS)
+        {
+            uBucket <<= 1u;
+        }
+
+        m_uNumLights = uBucket < NUM_LIGHTS ? uBucket : NUM_LIGHTS;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::GetNumLights
+      Summary:  Returns the light count of the bucket
+      Returns:  uint32_t
+                  Number of lights the variant loops over
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t ShaderPermutation::GetNumLights() const
+    {
+        return m_uNumLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::GetKey
+      Summary:  Packs the features in the low byte and the light count
+                above them. Two permutations are equal exactly when
+                their keys are
+      Returns:  uint32_t
+                  Key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t ShaderPermutation::GetKey() const
+    {
+        return m_uFeatures | (m_uNumLights << NUM_LIGHTS_SHIFT);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::GetDefines
+      Summary:  Returns one define per feature, set to 0 or 1, and
+                NUM_ACTIVE_LIGHTS. Every define is always present, in
+                the same order, so the source sees the same macros for
+                every variant
+      Args:     std::vector<ShaderDefine>& aOutDefines
+                  Defines
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ShaderPermutation::GetDefines(std::vector<ShaderDefine>& aOutDefines) const
+    {
+        aOutDefines.clear();
+        aOutDefines.reserve(std::size(FEATURE_DEFINES) + 1u);
+
+        for (const FeatureDefine& define : FEATURE_DEFINES)
+        {
+            aOutDefines.push_back({ .szName = define.pszName, .szValue = HasFeature(define.feature) ? "1" : "0" });
+        }
+
+        aOutDefines.push_back({ .szName = "NUM_ACTIVE_LIGHTS", .szValue = std::to_string(m_uNumLights) });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderPermutation::FromKey
+      Summary:  Unpacks a key returned by GetKey
+      Args:     uint32_t uKey
+                  Key
+      Returns:  ShaderPermutation
+                  Permutation with the features and light count of
+                  the key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderPermutation ShaderPermutation::FromKey(uint32_t uKey)
+    {
+        return ShaderPermutation(uKey & FEATURE_MASK, uKey >> NUM_LIGHTS_SHIFT);
+    }
+}
@@ -0,0 +1,94 @@
+/*+===================================================================
+  File:      SHADERPERMUTATION.H
+
+  Summary:   ShaderPermutation header file contains declaration of
+             class ShaderPermutation used to select a variant of a
+             shader with compile-time defines. It only depends on the
+             standard library.
+
+  Classes:  ShaderPermutation
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Shader/ShaderCache.h"
+#include "Shaders/ShaderConstants.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eShaderFeature
+      Summary:  Features a shader can be compiled with. Every feature
+                maps to a define of the same name
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eShaderFeature : uint32_t
+    {
+        NORMAL_MAP = 1u << 0u,
+        SKINNING = 1u << 1u,
+        SHADOWS = 1u << 2u,
+        PACKED_VERTICES = 1u << 3u,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShaderPermutation
+      Summary:  Feature bitset and light count of one shader variant.
+                The light count is rounded up to a power of two, capped
+                at NUM_LIGHTS, so scenes with a similar number of lights
+                share a variant
+      Methods:  Enable
+                  Adds a feature
+                Disable
+                  Removes a feature
+                HasFeature
+                  Returns whether a feature is enabled
+                SetNumLights
+                  Selects the light count bucket
+                GetNumLights
+                  Returns the light count of the bucket
+                GetKey
+                  Returns a key unique to the permutation
+                GetDefines
+                  Returns the defines of the permutation
+                FromKey
+                  Returns the permutation of a key
+                ShaderPermutation
+                  Constructor.
+                ~ShaderPermutation
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShaderPermutation
+    {
+    public:
+        static constexpr const uint32_t FEATURE_MASK = 0xFu;
+        static constexpr const uint32_t NUM_LIGHTS_SHIFT = 8u;
+
+    public:
+        ShaderPermutation();
+        ShaderPermutation(uint32_t uFeatures, uint32_t uNumLights);
+        ShaderPermutation(const ShaderPermutation& other) = default;
+        ShaderPermutation(ShaderPermutation&& other) = default;
+        ShaderPermutation& operator=(const ShaderPermutation& other) = default;
+        ShaderPermutation& operator=(ShaderPermutation&& other) = default;
+        virtual ~ShaderPermutation() = default;
+
+        void Enable(eShaderFeature feature);
+        void Disable(eShaderFeature feature);
+        bool HasFeature(eShaderFeature feature) const;
+
+        void SetNumLights(uint32_t uNumLights);
+        uint32_t GetNumLights() const;
+
+        uint32_t GetKey() const;
+        void GetDefines(std::vector<ShaderDefine>& aOutDefines) const;
+
+        static ShaderPermutation FromKey(uint32_t uKey);
+
+    private:
+        uint32_t m_uFeatures;
+        uint32_t m_uNumLights;
+    };
+}
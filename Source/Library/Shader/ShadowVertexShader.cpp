@@ -7,6 +7,11 @@ namespace library
     {
     }
 
+    ShadowVertexShader::ShadowVertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+        : VertexShader(bytecode, pszEntryPoint, pszShaderModel)
+    {
+    }
+
     HRESULT ShadowVertexShader::Initialize(_In_ ID3D11Device* pDevice)
     {
         ComPtr<ID3DBlob> vsBlob;
@@ -54,4 +59,20 @@ namespace library
 
         return hr;
     }
+
+    HRESULT ShadowVertexShader::createPackedVertexLayout(_In_ ID3D11Device* pDevice, _In_ ID3DBlob* pVSBlob)
+    {
+        // Only the position is read, its decode is folded into the world matrix
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "INSTANCE_TRANSFORM", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        };
+        UINT uNumElements = ARRAYSIZE(aLayouts);
+
+        return pDevice->CreateInputLayout(aLayouts, uNumElements, pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), m_packedVertexLayout.GetAddressOf());
+    }
 }
\ No newline at end of file
@@ -7,6 +7,11 @@ namespace library
     {
     }
 
+    SkinningVertexShader::SkinningVertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+        : VertexShader(bytecode, pszEntryPoint, pszShaderModel)
+    {
+    }
+
     HRESULT SkinningVertexShader::Initialize(_In_ ID3D11Device* pDevice)
     {
         ComPtr<ID3DBlob> vsBlob;
@@ -51,4 +56,20 @@ namespace library
 
         return hr;
     }
+
+    HRESULT SkinningVertexShader::createPackedVertexLayout(_In_ ID3D11Device* pDevice, _In_ ID3DBlob* pVSBlob)
+    {
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+        {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+
+            { "BONEINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "BONEWEIGHTS", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 4, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+        };
+        UINT uNumElements = ARRAYSIZE(aLayouts);
+
+        return pDevice->CreateInputLayout(aLayouts, uNumElements, pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), m_packedVertexLayout.GetAddressOf());
+    }
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ namespace library
     public:
         SkinningVertexShader() = delete;
         SkinningVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        SkinningVertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
         SkinningVertexShader(const SkinningVertexShader& other) = delete;
         SkinningVertexShader(SkinningVertexShader&& other) = delete;
         SkinningVertexShader& operator=(const SkinningVertexShader& other) = delete;
@@ -29,5 +30,8 @@ namespace library
         virtual ~SkinningVertexShader() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+
+    protected:
+        virtual HRESULT createPackedVertexLayout(_In_ ID3D11Device* pDevice, _In_ ID3DBlob* pVSBlob) override;
     };
 }
\ No newline at end of file
@@ -20,6 +20,23 @@ namespace library
         : VertexShader(pszFileName, pszEntryPoint, pszShaderModel)
     { }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SkyMapVertexShader::SkyMapVertexShader
+
+      Summary:  Constructor of a shader built from precompiled bytecode
+
+      Args:     std::span<const BYTE> bytecode
+                  Bytecode of the default permutation
+                PCSTR pszEntryPoint
+                  Name of the shader entry point the bytecode was
+                  compiled from
+                PCSTR pszShaderModel
+                  Shader target the bytecode was compiled against
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SkyMapVertexShader::SkyMapVertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+        : VertexShader(bytecode, pszEntryPoint, pszShaderModel)
+    { }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   SkyMapVertexShader::Initialize
 
@@ -34,6 +34,7 @@ namespace library
     public:
         SkyMapVertexShader() = delete;
         SkyMapVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        SkyMapVertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
         SkyMapVertexShader(const SkyMapVertexShader& other) = delete;
         SkyMapVertexShader(SkyMapVertexShader&& other) = delete;
         SkyMapVertexShader& operator=(const SkyMapVertexShader& other) = delete;
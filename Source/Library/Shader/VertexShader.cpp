@@ -16,12 +16,41 @@ namespace library
                   Specifies the shader target or set of shader features
                   to compile against
 
-      Modifies: [m_vertexShader].
+      Modifies: [m_vertexShader, m_permutations, m_variants,
+                 m_vertexLayout, m_packedVertexLayout].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     VertexShader::VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
         : Shader(pszFileName, pszEntryPoint, pszShaderModel)
+        , m_vertexShader(nullptr)
+        , m_permutations()
+        , m_variants()
         , m_vertexLayout(nullptr)
+        , m_packedVertexLayout(nullptr)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::VertexShader
+
+      Summary:  Constructor of a shader built from precompiled bytecode
+
+      Args:     std::span<const BYTE> bytecode
+                  Bytecode of the default permutation
+                PCSTR pszEntryPoint
+                  Name of the shader entry point the bytecode was
+                  compiled from
+                PCSTR pszShaderModel
+                  Shader target the bytecode was compiled against
+
+      Modifies: [m_vertexShader, m_permutations, m_variants,
+                 m_vertexLayout, m_packedVertexLayout].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    VertexShader::VertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+        : Shader(bytecode, pszEntryPoint, pszShaderModel)
         , m_vertexShader(nullptr)
+        , m_permutations()
+        , m_variants()
+        , m_vertexLayout(nullptr)
+        , m_packedVertexLayout(nullptr)
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -109,4 +138,208 @@ namespace library
     {
         return m_vertexLayout;
     }
-}
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::GetVertexLayout
+
+      Summary:  Returns the input layout of a permutation. Permutations
+                with PACKED_VERTICES read the packed vertex formats,
+                whose layout is created with the first of their variants
+
+      Args:     const ShaderPermutation& permutation
+                  Features and light count of the variant
+
+      Returns:  ComPtr<ID3D11InputLayout>&
+                  Vertex input layout. Could be a nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11InputLayout>& VertexShader::GetVertexLayout(_In_ const ShaderPermutation& permutation)
+    {
+        if (!permutation.HasFeature(eShaderFeature::PACKED_VERTICES))
+        {
+            return m_vertexLayout;
+        }
+
+        if (!m_packedVertexLayout)
+        {
+            GetVertexShader(permutation);
+        }
+
+        return m_packedVertexLayout;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::GetVertexShader
+
+      Summary:  Returns the variant of a permutation. It is compiled
+                on first use, and permutations that preprocess to the
+                same source share one shader. Falls back to the default
+                variant when the permutation cannot be compiled
+                or is not embedded, which compile reports. The
+                first permutation with PACKED_VERTICES also creates the
+                packed input layout, since its input signature differs
+
+      Args:     const ShaderPermutation& permutation
+                  Features and light count of the variant
+
+      Modifies: [m_permutations, m_variants, m_packedVertexLayout].
+
+      Returns:  ComPtr<ID3D11VertexShader>&
+                  Vertex shader. Could be a nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11VertexShader>& VertexShader::GetVertexShader(_In_ const ShaderPermutation& permutation)
+    {
+        auto it = m_permutations.find(permutation.GetKey());
+        if (it != m_permutations.end())
+        {
+            return it->second;
+        }
+
+        ComPtr<ID3D11VertexShader>& vertexShader = m_permutations[permutation.GetKey()];
+        vertexShader = m_vertexShader;
+        if (!m_vertexShader)
+        {
+            return vertexShader;
+        }
+
+        ComPtr<ID3DBlob> pVSBlob = nullptr;
+        UINT64 uSourceKey = 0ull;
+        if (FAILED(compile(permutation, pVSBlob.GetAddressOf(), uSourceKey)))
+        {
+            return vertexShader;
+        }
+
+        // Variants are created on the device of the default one
+        ComPtr<ID3D11Device> device = nullptr;
+        m_vertexShader->GetDevice(device.GetAddressOf());
+
+        if (permutation.HasFeature(eShaderFeature::PACKED_VERTICES) && !m_packedVertexLayout)
+        {
+            createPackedVertexLayout(device.Get(), pVSBlob.Get());
+        }
+
+        if (uSourceKey == m_uSourceKey)
+        {
+            return vertexShader;
+        }
+
+        auto variant = m_variants.find(uSourceKey);
+        if (variant != m_variants.end())
+        {
+            vertexShader = variant->second;
+            return vertexShader;
+        }
+
+        ComPtr<ID3D11VertexShader> compiledVertexShader = nullptr;
+        if (SUCCEEDED(device->CreateVertexShader(pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), nullptr, compiledVertexShader.GetAddressOf())))
+        {
+            m_variants[uSourceKey] = compiledVertexShader;
+            vertexShader = compiledVertexShader;
+        }
+
+        return vertexShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::Reload
+
+      Summary:  Initializes the shader again from its file and recreates
+                the permutations that were in use. The previous shader
+                and layout are restored if anything fails, so a broken
+                edit never leaves the renderables without a shader.
+                Must be called between two frames
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shader
+
+      Modifies: [m_vertexShader, m_permutations, m_variants,
+                 m_vertexLayout, m_packedVertexLayout, m_uSourceKey].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VertexShader::Reload(_In_ ID3D11Device* pDevice)
+    {
+        std::vector<UINT> aPermutationKeys;
+        GetPermutationKeys(aPermutationKeys);
+
+        // Initialize writes through GetAddressOf, which would leak the current objects
+        ComPtr<ID3D11VertexShader> previousVertexShader = std::move(m_vertexShader);
+        ComPtr<ID3D11InputLayout> previousVertexLayout = std::move(m_vertexLayout);
+        UINT64 uPreviousSourceKey = m_uSourceKey;
+
+        HRESULT hr = Initialize(pDevice);
+        if (FAILED(hr))
+        {
+            m_vertexShader = std::move(previousVertexShader);
+            m_vertexLayout = std::move(previousVertexLayout);
+            m_uSourceKey = uPreviousSourceKey;
+            return hr;
+        }
+
+        // The packed layout is recreated from the new variants
+        m_packedVertexLayout.Reset();
+        m_permutations.clear();
+        m_variants.clear();
+        for (UINT uPermutationKey : aPermutationKeys)
+        {
+            GetVertexShader(ShaderPermutation::FromKey(uPermutationKey));
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::GetPermutationKeys
+
+      Summary:  Returns the keys of the permutations requested so far
+
+      Args:     std::vector<UINT>& aOutPermutationKeys
+                  Keys of the permutations
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexShader::GetPermutationKeys(_Out_ std::vector<UINT>& aOutPermutationKeys) const
+    {
+        aOutPermutationKeys.clear();
+        aOutPermutationKeys.reserve(m_permutations.size());
+        for (const auto& [uPermutationKey, vertexShader] : m_permutations)
+        {
+            aOutPermutationKeys.push_back(uPermutationKey);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::createPackedVertexLayout
+
+      Summary:  Creates the input layout of PackedVertex and
+                PackedNormalData in the slots of SimpleVertex and
+                NormalData
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the input layout
+                ID3DBlob* pVSBlob
+                  Bytecode of a variant with PACKED_VERTICES
+
+      Modifies: [m_packedVertexLayout].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VertexShader::createPackedVertexLayout(_In_ ID3D11Device* pDevice, _In_ ID3DBlob* pVSBlob)
+    {
+        D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+        {
+            { "POSITION", 0u, DXGI_FORMAT_R16G16B16A16_UNORM, 0u, 0u, D3D11_INPUT_PER_VERTEX_DATA, 0u },
+            { "TEXCOORD", 0u, DXGI_FORMAT_R16G16_FLOAT, 0u, 8u, D3D11_INPUT_PER_VERTEX_DATA, 0u },
+            { "NORMAL", 0u, DXGI_FORMAT_R16G16_SNORM, 0u, 12u, D3D11_INPUT_PER_VERTEX_DATA, 0u },
+
+            { "TANGENT", 0u, DXGI_FORMAT_R10G10B10A2_UNORM, 1u, 0u, D3D11_INPUT_PER_VERTEX_DATA, 0u },
+
+            { "INSTANCE_TRANSFORM", 0u, DXGI_FORMAT_R32G32B32A32_FLOAT, 2u, 0u, D3D11_INPUT_PER_INSTANCE_DATA, 1u },
+            { "INSTANCE_TRANSFORM", 1u, DXGI_FORMAT_R32G32B32A32_FLOAT, 2u, 16u, D3D11_INPUT_PER_INSTANCE_DATA, 1u },
+            { "INSTANCE_TRANSFORM", 2u, DXGI_FORMAT_R32G32B32A32_FLOAT, 2u, 32u, D3D11_INPUT_PER_INSTANCE_DATA, 1u },
+            { "INSTANCE_TRANSFORM", 3u, DXGI_FORMAT_R32G32B32A32_FLOAT, 2u, 48u, D3D11_INPUT_PER_INSTANCE_DATA, 1u }
+        };
+        UINT numElements = ARRAYSIZE(aLayouts);
+
+        return pDevice->CreateInputLayout(aLayouts, numElements, pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), m_packedVertexLayout.GetAddressOf());
+    }
+}
\ No newline at end of file
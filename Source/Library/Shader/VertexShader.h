@@ -25,9 +25,16 @@ namespace library
       Methods:  Initialize
                   Initializes the vertex shader and the input layout
                 GetVertexShader
-                  Returns the vertex shader
+                  Returns the vertex shader, or the variant of a
+                  permutation, compiled on first use
                 GetVertexLayout
-                  Returns the vertex input layout
+                  Returns the vertex input layout, or the one of the
+                  packed vertex formats
+                Reload
+                  Recreates the shader, the layout and the permutations
+                  in use, keeping the old ones on failure
+                GetPermutationKeys
+                  Returns the keys of the permutations in use
                 Game
                   Constructor.
                 ~Game
@@ -38,6 +45,7 @@ namespace library
     public:
         VertexShader() = delete;
         VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        VertexShader(_In_ std::span<const BYTE> bytecode, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
         VertexShader(const VertexShader& other) = delete;
         VertexShader(VertexShader&& other) = delete;
         VertexShader& operator=(const VertexShader& other) = delete;
@@ -45,12 +53,22 @@ namespace library
         virtual ~VertexShader() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+        virtual HRESULT Reload(_In_ ID3D11Device* pDevice) override;
+        virtual void GetPermutationKeys(_Out_ std::vector<UINT>& aOutPermutationKeys) const override;
 
         ComPtr<ID3D11VertexShader>& GetVertexShader();
+        ComPtr<ID3D11VertexShader>& GetVertexShader(_In_ const ShaderPermutation& permutation);
         ComPtr<ID3D11InputLayout>& GetVertexLayout();
+        ComPtr<ID3D11InputLayout>& GetVertexLayout(_In_ const ShaderPermutation& permutation);
+
+    protected:
+        virtual HRESULT createPackedVertexLayout(_In_ ID3D11Device* pDevice, _In_ ID3DBlob* pVSBlob);
 
     protected:
         ComPtr<ID3D11VertexShader> m_vertexShader;
+        std::unordered_map<UINT, ComPtr<ID3D11VertexShader>> m_permutations;
+        std::unordered_map<UINT64, ComPtr<ID3D11VertexShader>> m_variants;
         ComPtr<ID3D11InputLayout> m_vertexLayout;
+        ComPtr<ID3D11InputLayout> m_packedVertexLayout;
     };
 }
\ No newline at end of file
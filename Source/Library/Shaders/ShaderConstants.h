@@ -0,0 +1,44 @@
+/*+===================================================================
+  File:      SHADERCONSTANTS.H
+
+  Summary:   ShaderConstants header file holds the constants shared by
+             the C++ code and the HLSL shaders. It is included by both,
+             so it may only contain preprocessor directives.
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#ifndef SHADERCONSTANTS_H
+#define SHADERCONSTANTS_H
+
+#define NUM_LIGHTS (1)
+#define MAX_NUM_BONES (256)
+#define MAX_NUM_BONES_PER_VERTEX (4)
+
+#define NEAR_PLANE (0.01f)
+#define FAR_PLANE (1000.0f)
+
+#ifndef __cplusplus
+// Permutation defines, set by ShaderPermutation::GetDefines. The
+// defaults are used when a shader is compiled without a permutation
+#ifndef NORMAL_MAP
+#define NORMAL_MAP (0)
+#endif
+
+#ifndef SKINNING
+#define SKINNING (0)
+#endif
+
+#ifndef SHADOWS
+#define SHADOWS (0)
+#endif
+
+#ifndef PACKED_VERTICES
+#define PACKED_VERTICES (0)
+#endif
+
+#ifndef NUM_ACTIVE_LIGHTS
+#define NUM_ACTIVE_LIGHTS NUM_LIGHTS
+#endif
+#endif
+
+#endif
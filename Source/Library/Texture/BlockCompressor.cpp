@@ -0,0 +1,903 @@
+#include "Texture/BlockCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BLOCK_COMPRESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "Utility/Parallel.h"
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ColorBlock
+          Summary:  Colour channels of a 4x4 block in structure of arrays
+                    layout so that four pixels are processed at once
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct alignas(16) ColorBlock
+        {
+            float aR[BlockCompressor::NUM_BLOCK_PIXELS];
+            float aG[BlockCompressor::NUM_BLOCK_PIXELS];
+            float aB[BlockCompressor::NUM_BLOCK_PIXELS];
+        };
+
+        uint16_t packRgb565(float r, float g, float b)
+        {
+            uint32_t uR = static_cast<uint32_t>(std::clamp(r * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f));
+            uint32_t uG = static_cast<uint32_t>(std::clamp(g * (63.0f / 255.0f) + 0.5f, 0.0f, 63.0f));
+            uint32_t uB = static_cast<uint32_t>(std::clamp(b * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f));
+
+            return static_cast<uint16_t>((uR << 11u) | (uG << 5u) | uB);
+        }
+
+        void unpackRgb565(uint16_t uColor, uint8_t* pOutRgb)
+        {
+            uint32_t uR = (uColor >> 11u) & 0x1Fu;
+            uint32_t uG = (uColor >> 5u) & 0x3Fu;
+            uint32_t uB = uColor & 0x1Fu;
+
+            pOutRgb[0] = static_cast<uint8_t>((uR << 3u) | (uR >> 2u));
+            pOutRgb[1] = static_cast<uint8_t>((uG << 2u) | (uG >> 4u));
+            pOutRgb[2] = static_cast<uint8_t>((uB << 3u) | (uB >> 2u));
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: buildPalette
+          Summary:  Decodes the four colours of a BC1 block in four colour
+                    mode, in the order of the index values
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void buildPalette(uint16_t uColor0, uint16_t uColor1, float aOutPalette[4][3])
+        {
+            uint8_t aRgb0[3];
+            uint8_t aRgb1[3];
+            unpackRgb565(uColor0, aRgb0);
+            unpackRgb565(uColor1, aRgb1);
+
+            for (uint32_t c = 0u; c < 3u; ++c)
+            {
+                aOutPalette[0][c] = static_cast<float>(aRgb0[c]);
+                aOutPalette[1][c] = static_cast<float>(aRgb1[c]);
+                aOutPalette[2][c] = static_cast<float>((2u * aRgb0[c] + aRgb1[c] + 1u) / 3u);
+                aOutPalette[3][c] = static_cast<float>((aRgb0[c] + 2u * aRgb1[c] + 1u) / 3u);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: selectIndices
+          Summary:  Picks the nearest palette colour for every pixel and
+                    returns the summed squared error of the block
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        float selectIndices(const ColorBlock& block, const float aPalette[4][3], uint32_t* pOutIndices)
+        {
+#if defined(BLOCK_COMPRESSOR_SSE2)
+            __m128 totalError = _mm_setzero_ps();
+            uint32_t uIndices = 0u;
+
+            for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; i += 4u)
+            {
+                __m128 r = _mm_load_ps(&block.aR[i]);
+                __m128 g = _mm_load_ps(&block.aG[i]);
+                __m128 b = _mm_load_ps(&block.aB[i]);
+
+                __m128 bestError = _mm_set1_ps(std::numeric_limits<float>::max());
+                __m128i bestIndex = _mm_setzero_si128();
+
+                for (uint32_t p = 0u; p < 4u; ++p)
+                {
+                    __m128 dR = _mm_sub_ps(r, _mm_set1_ps(aPalette[p][0]));
+                    __m128 dG = _mm_sub_ps(g, _mm_set1_ps(aPalette[p][1]));
+                    __m128 dB = _mm_sub_ps(b, _mm_set1_ps(aPalette[p][2]));
+                    __m128 error = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dR, dR), _mm_mul_ps(dG, dG)), _mm_mul_ps(dB, dB));
+
+                    __m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+                    bestError = _mm_min_ps(error, bestError);
+                    bestIndex = _mm_or_si128(_mm_andnot_si128(closer, bestIndex), _mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(p))));
+                }
+
+                totalError = _mm_add_ps(totalError, bestError);
+
+                alignas(16) uint32_t aIndices[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(aIndices), bestIndex);
+                for (uint32_t j = 0u; j < 4u; ++j)
+                {
+                    uIndices |= aIndices[j] << (2u * (i + j));
+                }
+            }
+
+            alignas(16) float aErrors[4];
+            _mm_store_ps(aErrors, totalError);
+
+            *pOutIndices = uIndices;
+            return aErrors[0] + aErrors[1] + aErrors[2] + aErrors[3];
+#else
+            float totalError = 0.0f;
+            uint32_t uIndices = 0u;
+
+            for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+            {
+                float bestError = std::numeric_limits<float>::max();
+                uint32_t uBestIndex = 0u;
+
+                for (uint32_t p = 0u; p < 4u; ++p)
+                {
+                    float dR = block.aR[i] - aPalette[p][0];
+                    float dG = block.aG[i] - aPalette[p][1];
+                    float dB = block.aB[i] - aPalette[p][2];
+                    float error = dR * dR + dG * dG + dB * dB;
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        uBestIndex = p;
+                    }
+                }
+
+                totalError += bestError;
+                uIndices |= uBestIndex << (2u * i);
+            }
+
+            *pOutIndices = uIndices;
+            return totalError;
+#endif
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: fitPrincipalAxis
+          Summary:  Returns the endpoints of the segment along the
+                    principal axis of the block colours, inset by a
+                    sixteenth of its length to reduce the rounding error
+                    of the end colours
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void fitPrincipalAxis(const ColorBlock& block, float aOutMax[3], float aOutMin[3])
+        {
+            float aMean[3] = { 0.0f, 0.0f, 0.0f };
+            float aMinColor[3] = { 255.0f, 255.0f, 255.0f };
+            float aMaxColor[3] = { 0.0f, 0.0f, 0.0f };
+            for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+            {
+                const float aColor[3] = { block.aR[i], block.aG[i], block.aB[i] };
+                for (uint32_t c = 0u; c < 3u; ++c)
+                {
+                    aMean[c] += aColor[c];
+                    aMinColor[c] = std::min(aMinColor[c], aColor[c]);
+                    aMaxColor[c] = std::max(aMaxColor[c], aColor[c]);
+                }
+            }
+            for (uint32_t c = 0u; c < 3u; ++c)
+            {
+                aMean[c] /= static_cast<float>(BlockCompressor::NUM_BLOCK_PIXELS);
+            }
+
+            // Covariance matrix, upper triangle
+            float aCovariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+            for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+            {
+                float r = block.aR[i] - aMean[0];
+                float g = block.aG[i] - aMean[1];
+                float b = block.aB[i] - aMean[2];
+
+                aCovariance[0] += r * r;
+                aCovariance[1] += r * g;
+                aCovariance[2] += r * b;
+                aCovariance[3] += g * g;
+                aCovariance[4] += g * b;
+                aCovariance[5] += b * b;
+            }
+
+            // Power iteration starting from the bounding box diagonal
+            float aAxis[3] =
+            {
+                aMaxColor[0] - aMinColor[0],
+                aMaxColor[1] - aMinColor[1],
+                aMaxColor[2] - aMinColor[2]
+            };
+            for (uint32_t uIteration = 0u; uIteration < 8u; ++uIteration)
+            {
+                float aNext[3] =
+                {
+                    aCovariance[0] * aAxis[0] + aCovariance[1] * aAxis[1] + aCovariance[2] * aAxis[2],
+                    aCovariance[1] * aAxis[0] + aCovariance[3] * aAxis[1] + aCovariance[4] * aAxis[2],
+                    aCovariance[2] * aAxis[0] + aCovariance[4] * aAxis[1] + aCovariance[5] * aAxis[2]
+                };
+
+                float length = std::max(std::max(std::fabs(aNext[0]), std::fabs(aNext[1])), std::fabs(aNext[2]));
+                if (length < 1.0e-6f)
+                {
+                    break;
+                }
+
+                for (uint32_t c = 0u; c < 3u; ++c)
+                {
+                    aAxis[c] = aNext[c] / length;
+                }
+            }
+
+            float length = std::sqrt(aAxis[0] * aAxis[0] + aAxis[1] * aAxis[1] + aAxis[2] * aAxis[2]);
+            if (length < 1.0e-6f)
+            {
+                for (uint32_t c = 0u; c < 3u; ++c)
+                {
+                    aOutMax[c] = aMean[c];
+                    aOutMin[c] = aMean[c];
+                }
+                return;
+            }
+
+            for (uint32_t c = 0u; c < 3u; ++c)
+            {
+                aAxis[c] /= length;
+            }
+
+            float minProjection = std::numeric_limits<float>::max();
+            float maxProjection = -std::numeric_limits<float>::max();
+            for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+            {
+                float projection = (block.aR[i] - aMean[0]) * aAxis[0] + (block.aG[i] - aMean[1]) * aAxis[1] + (block.aB[i] - aMean[2]) * aAxis[2];
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+
+            float inset = (maxProjection - minProjection) / 16.0f;
+            minProjection += inset;
+            maxProjection -= inset;
+
+            for (uint32_t c = 0u; c < 3u; ++c)
+            {
+                aOutMax[c] = std::clamp(aMean[c] + aAxis[c] * maxProjection, 0.0f, 255.0f);
+                aOutMin[c] = std::clamp(aMean[c] + aAxis[c] * minProjection, 0.0f, 255.0f);
+            }
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: refineEndpoints
+          Summary:  Solves the least squares problem for the two end
+                    colours that best reproduce the block with the given
+                    indices. Returns false if the indices do not span
+                    two distinct weights
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        bool refineEndpoints(const ColorBlock& block, uint32_t uIndices, float aOutColor0[3], float aOutColor1[3])
+        {
+            static constexpr const float WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+            float aa = 0.0f;
+            float bb = 0.0f;
+            float ab = 0.0f;
+            float aX[3] = { 0.0f, 0.0f, 0.0f };
+            float bX[3] = { 0.0f, 0.0f, 0.0f };
+
+            for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+            {
+                float a = WEIGHTS[(uIndices >> (2u * i)) & 0x3u];
+                float b = 1.0f - a;
+                const float aColor[3] = { block.aR[i], block.aG[i], block.aB[i] };
+
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (uint32_t c = 0u; c < 3u; ++c)
+                {
+                    aX[c] += a * aColor[c];
+                    bX[c] += b * aColor[c];
+                }
+            }
+
+            float determinant = aa * bb - ab * ab;
+            if (std::fabs(determinant) < 1.0e-6f)
+            {
+                return false;
+            }
+
+            float inverse = 1.0f / determinant;
+            for (uint32_t c = 0u; c < 3u; ++c)
+            {
+                aOutColor0[c] = std::clamp((aX[c] * bb - bX[c] * ab) * inverse, 0.0f, 255.0f);
+                aOutColor1[c] = std::clamp((bX[c] * aa - aX[c] * ab) * inverse, 0.0f, 255.0f);
+            }
+
+            return true;
+        }
+
+        void writeUint16(uint8_t* pOut, uint16_t uValue)
+        {
+            pOut[0] = static_cast<uint8_t>(uValue & 0xFFu);
+            pOut[1] = static_cast<uint8_t>(uValue >> 8u);
+        }
+
+        void writeUint32(uint8_t* pOut, uint32_t uValue)
+        {
+            for (uint32_t i = 0u; i < 4u; ++i)
+            {
+                pOut[i] = static_cast<uint8_t>((uValue >> (8u * i)) & 0xFFu);
+            }
+        }
+
+        uint32_t readUint32(const uint8_t* pIn)
+        {
+            return static_cast<uint32_t>(pIn[0]) | (static_cast<uint32_t>(pIn[1]) << 8u) | (static_cast<uint32_t>(pIn[2]) << 16u) | (static_cast<uint32_t>(pIn[3]) << 24u);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: buildChannelPalette
+          Summary:  Decodes the eight values of a BC4 block
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void buildChannelPalette(uint32_t uValue0, uint32_t uValue1, uint32_t aOutPalette[8])
+        {
+            aOutPalette[0] = uValue0;
+            aOutPalette[1] = uValue1;
+
+            if (uValue0 > uValue1)
+            {
+                for (uint32_t i = 1u; i < 7u; ++i)
+                {
+                    aOutPalette[i + 1u] = ((7u - i) * uValue0 + i * uValue1 + 3u) / 7u;
+                }
+            }
+            else
+            {
+                for (uint32_t i = 1u; i < 5u; ++i)
+                {
+                    aOutPalette[i + 1u] = ((5u - i) * uValue0 + i * uValue1 + 2u) / 5u;
+                }
+                aOutPalette[6] = 0u;
+                aOutPalette[7] = 255u;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::BlockCompressor
+      Summary:  Constructor
+      Args:     eBlockFormat format
+                  Block format to encode to
+      Modifies: [m_format, m_uNumThreads, m_uNumRefinements].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BlockCompressor::BlockCompressor(eBlockFormat format)
+        : m_format(format)
+        , m_uNumThreads(0u)
+        , m_uNumRefinements(DEFAULT_NUM_REFINEMENTS)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::Compress
+      Summary:  Encodes the image. Blocks on the right and bottom edges
+                of images whose size is not a multiple of 4 repeat the
+                last column and row
+      Args:     const Image& image
+                  RGBA8 image to encode
+                std::vector<uint8_t>& aOutBlocks
+                  Encoded blocks, row by row
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::Compress(const Image& image, std::vector<uint8_t>& aOutBlocks) const
+    {
+        uint32_t uNumBlocksX = (image.uWidth + BLOCK_DIMENSION - 1u) / BLOCK_DIMENSION;
+        uint32_t uNumBlocksY = (image.uHeight + BLOCK_DIMENSION - 1u) / BLOCK_DIMENSION;
+        uint32_t uBlockByteSize = GetBlockByteSize();
+
+        aOutBlocks.resize(static_cast<size_t>(uNumBlocksX) * uNumBlocksY * uBlockByteSize);
+        if (aOutBlocks.empty())
+        {
+            return;
+        }
+
+        Parallel::For(uNumBlocksY, 4u, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            uint8_t aRgba[NUM_BLOCK_PIXELS * 4u];
+
+            for (uint32_t uBlockY = uBegin; uBlockY < uEnd; ++uBlockY)
+            {
+                for (uint32_t uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+                {
+                    for (uint32_t y = 0u; y < BLOCK_DIMENSION; ++y)
+                    {
+                        uint32_t uSourceY = std::min(uBlockY * BLOCK_DIMENSION + y, image.uHeight - 1u);
+                        for (uint32_t x = 0u; x < BLOCK_DIMENSION; ++x)
+                        {
+                            uint32_t uSourceX = std::min(uBlockX * BLOCK_DIMENSION + x, image.uWidth - 1u);
+                            std::memcpy(&aRgba[(y * BLOCK_DIMENSION + x) * 4u], &image.aPixels[(static_cast<size_t>(uSourceY) * image.uWidth + uSourceX) * 4u], 4u);
+                        }
+                    }
+
+                    uint8_t* pBlock = &aOutBlocks[(static_cast<size_t>(uBlockY) * uNumBlocksX + uBlockX) * uBlockByteSize];
+                    encodeBlock(m_format, aRgba, pBlock, m_uNumRefinements);
+                }
+            }
+        }, m_uNumThreads);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::Decompress
+      Summary:  Decodes encoded blocks to an RGBA8 image. BC5 decodes
+                to red and green with blue 0 and alpha 255
+      Args:     uint32_t uWidth
+                  Width of the image
+                uint32_t uHeight
+                  Height of the image
+                const uint8_t* pBlocks
+                  Encoded blocks, row by row
+                Image& outImage
+                  Decoded image
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::Decompress(uint32_t uWidth, uint32_t uHeight, const uint8_t* pBlocks, Image& outImage) const
+    {
+        uint32_t uNumBlocksX = (uWidth + BLOCK_DIMENSION - 1u) / BLOCK_DIMENSION;
+        uint32_t uNumBlocksY = (uHeight + BLOCK_DIMENSION - 1u) / BLOCK_DIMENSION;
+        uint32_t uBlockByteSize = GetBlockByteSize();
+
+        outImage.uWidth = uWidth;
+        outImage.uHeight = uHeight;
+        outImage.aPixels.resize(static_cast<size_t>(uWidth) * uHeight * 4u);
+
+        Parallel::For(uNumBlocksY, 4u, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            uint8_t aRgba[NUM_BLOCK_PIXELS * 4u];
+
+            for (uint32_t uBlockY = uBegin; uBlockY < uEnd; ++uBlockY)
+            {
+                for (uint32_t uBlockX = 0u; uBlockX < uNumBlocksX; ++uBlockX)
+                {
+                    DecodeBlock(m_format, &pBlocks[(static_cast<size_t>(uBlockY) * uNumBlocksX + uBlockX) * uBlockByteSize], aRgba);
+
+                    for (uint32_t y = 0u; y < BLOCK_DIMENSION && uBlockY * BLOCK_DIMENSION + y < uHeight; ++y)
+                    {
+                        for (uint32_t x = 0u; x < BLOCK_DIMENSION && uBlockX * BLOCK_DIMENSION + x < uWidth; ++x)
+                        {
+                            size_t uDestination = (static_cast<size_t>(uBlockY * BLOCK_DIMENSION + y) * uWidth + uBlockX * BLOCK_DIMENSION + x) * 4u;
+                            std::memcpy(&outImage.aPixels[uDestination], &aRgba[(y * BLOCK_DIMENSION + x) * 4u], 4u);
+                        }
+                    }
+                }
+            }
+        }, m_uNumThreads);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::SetNumThreads
+      Summary:  Sets the number of threads Compress and Decompress use
+      Args:     uint32_t uNumThreads
+                  Number of threads, 0 for one per hardware thread
+      Modifies: [m_uNumThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::SetNumThreads(uint32_t uNumThreads)
+    {
+        m_uNumThreads = uNumThreads;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::SetNumRefinements
+      Summary:  Sets the number of least squares iterations of the
+                colour endpoints. 0 keeps the principal axis endpoints
+      Args:     uint32_t uNumRefinements
+                  Number of iterations
+      Modifies: [m_uNumRefinements].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::SetNumRefinements(uint32_t uNumRefinements)
+    {
+        m_uNumRefinements = uNumRefinements;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetFormat
+      Summary:  Returns the block format
+      Returns:  eBlockFormat
+                  Block format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eBlockFormat BlockCompressor::GetFormat() const
+    {
+        return m_format;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetBlockByteSize
+      Summary:  Returns the size of a block of the format
+      Returns:  uint32_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t BlockCompressor::GetBlockByteSize() const
+    {
+        return GetBlockByteSize(m_format);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetBlockByteSize
+      Summary:  Returns the size of a block of the given format
+      Args:     eBlockFormat format
+                  Block format
+      Returns:  uint32_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t BlockCompressor::GetBlockByteSize(eBlockFormat format)
+    {
+        return format == eBlockFormat::BC1 ? 8u : 16u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::ComputeCompressedByteSize
+      Summary:  Returns the size of an encoded surface
+      Args:     eBlockFormat format
+                  Block format
+                uint32_t uWidth
+                  Width of the surface
+                uint32_t uHeight
+                  Height of the surface
+      Returns:  uint64_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t BlockCompressor::ComputeCompressedByteSize(eBlockFormat format, uint32_t uWidth, uint32_t uHeight)
+    {
+        uint64_t uNumBlocksX = (uWidth + BLOCK_DIMENSION - 1u) / BLOCK_DIMENSION;
+        uint64_t uNumBlocksY = (uHeight + BLOCK_DIMENSION - 1u) / BLOCK_DIMENSION;
+
+        return uNumBlocksX * uNumBlocksY * GetBlockByteSize(format);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::EncodeBC1Block
+      Summary:  Encodes the colour of a 4x4 block in four colour mode.
+                Alpha is ignored
+      Args:     const uint8_t* pRgba
+                  16 RGBA8 pixels, row by row
+                uint8_t* pOutBlock
+                  8 bytes of the encoded block
+                uint32_t uNumRefinements
+                  Number of least squares iterations
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::EncodeBC1Block(const uint8_t* pRgba, uint8_t* pOutBlock, uint32_t uNumRefinements)
+    {
+        ColorBlock block;
+        for (uint32_t i = 0u; i < NUM_BLOCK_PIXELS; ++i)
+        {
+            block.aR[i] = static_cast<float>(pRgba[i * 4u + 0u]);
+            block.aG[i] = static_cast<float>(pRgba[i * 4u + 1u]);
+            block.aB[i] = static_cast<float>(pRgba[i * 4u + 2u]);
+        }
+
+        float aMax[3];
+        float aMin[3];
+        fitPrincipalAxis(block, aMax, aMin);
+
+        uint16_t uColor0 = packRgb565(aMax[0], aMax[1], aMax[2]);
+        uint16_t uColor1 = packRgb565(aMin[0], aMin[1], aMin[2]);
+
+        float aPalette[4][3];
+        buildPalette(uColor0, uColor1, aPalette);
+
+        uint32_t uIndices = 0u;
+        float bestError = selectIndices(block, aPalette, &uIndices);
+
+        for (uint32_t uIteration = 0u; uIteration < uNumRefinements && bestError > 0.0f; ++uIteration)
+        {
+            float aColor0[3];
+            float aColor1[3];
+            if (!refineEndpoints(block, uIndices, aColor0, aColor1))
+            {
+                break;
+            }
+
+            uint16_t uRefinedColor0 = packRgb565(aColor0[0], aColor0[1], aColor0[2]);
+            uint16_t uRefinedColor1 = packRgb565(aColor1[0], aColor1[1], aColor1[2]);
+            if (uRefinedColor0 == uColor0 && uRefinedColor1 == uColor1)
+            {
+                break;
+            }
+
+            buildPalette(uRefinedColor0, uRefinedColor1, aPalette);
+
+            uint32_t uRefinedIndices = 0u;
+            float error = selectIndices(block, aPalette, &uRefinedIndices);
+            if (error >= bestError)
+            {
+                break;
+            }
+
+            uColor0 = uRefinedColor0;
+            uColor1 = uRefinedColor1;
+            uIndices = uRefinedIndices;
+            bestError = error;
+        }
+
+        // Four colour mode requires color0 > color1, swapping the ends swaps indices 0<->1 and 2<->3
+        if (uColor0 < uColor1)
+        {
+            std::swap(uColor0, uColor1);
+            uIndices ^= 0x55555555u;
+        }
+        else if (uColor0 == uColor1)
+        {
+            uIndices = 0u;
+        }
+
+        writeUint16(&pOutBlock[0], uColor0);
+        writeUint16(&pOutBlock[2], uColor1);
+        writeUint32(&pOutBlock[4], uIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::EncodeBC3Block
+      Summary:  Encodes a 4x4 block as a BC4 alpha block followed by a
+                BC1 colour block
+      Args:     const uint8_t* pRgba
+                  16 RGBA8 pixels, row by row
+                uint8_t* pOutBlock
+                  16 bytes of the encoded block
+                uint32_t uNumRefinements
+                  Number of least squares iterations of the colour
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::EncodeBC3Block(const uint8_t* pRgba, uint8_t* pOutBlock, uint32_t uNumRefinements)
+    {
+        EncodeBC4Block(&pRgba[3], 4u, &pOutBlock[0]);
+        EncodeBC1Block(pRgba, &pOutBlock[8], uNumRefinements);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::EncodeBC4Block
+      Summary:  Encodes 16 single channel values with the eight value
+                interpolation between the block minimum and maximum
+      Args:     const uint8_t* pValues
+                  First value
+                uint32_t uStride
+                  Distance between consecutive values in bytes
+                uint8_t* pOutBlock
+                  8 bytes of the encoded block
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::EncodeBC4Block(const uint8_t* pValues, uint32_t uStride, uint8_t* pOutBlock)
+    {
+        uint32_t uMin = 255u;
+        uint32_t uMax = 0u;
+        for (uint32_t i = 0u; i < NUM_BLOCK_PIXELS; ++i)
+        {
+            uint32_t uValue = pValues[i * uStride];
+            uMin = std::min(uMin, uValue);
+            uMax = std::max(uMax, uValue);
+        }
+
+        pOutBlock[0] = static_cast<uint8_t>(uMax);
+        pOutBlock[1] = static_cast<uint8_t>(uMin);
+
+        uint64_t uIndices = 0ull;
+        if (uMax != uMin)
+        {
+            uint32_t aPalette[8];
+            buildChannelPalette(uMax, uMin, aPalette);
+
+            for (uint32_t i = 0u; i < NUM_BLOCK_PIXELS; ++i)
+            {
+                int value = static_cast<int>(pValues[i * uStride]);
+
+                uint32_t uBestIndex = 0u;
+                int bestError = 256;
+                for (uint32_t p = 0u; p < 8u; ++p)
+                {
+                    int error = std::abs(value - static_cast<int>(aPalette[p]));
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        uBestIndex = p;
+                    }
+                }
+
+                uIndices |= static_cast<uint64_t>(uBestIndex) << (3u * i);
+            }
+        }
+
+        for (uint32_t i = 0u; i < 6u; ++i)
+        {
+            pOutBlock[2u + i] = static_cast<uint8_t>((uIndices >> (8u * i)) & 0xFFu);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::EncodeBC5Block
+      Summary:  Encodes the red and green channels of a 4x4 block as two
+                BC4 blocks
+      Args:     const uint8_t* pRgba
+                  16 RGBA8 pixels, row by row
+                uint8_t* pOutBlock
+                  16 bytes of the encoded block
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::EncodeBC5Block(const uint8_t* pRgba, uint8_t* pOutBlock)
+    {
+        EncodeBC4Block(&pRgba[0], 4u, &pOutBlock[0]);
+        EncodeBC4Block(&pRgba[1], 4u, &pOutBlock[8]);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::DecodeBlock
+      Summary:  Decodes a block of the given format to 16 RGBA8 pixels
+      Args:     eBlockFormat format
+                  Block format
+                const uint8_t* pBlock
+                  Encoded block
+                uint8_t* pOutRgba
+                  16 RGBA8 pixels, row by row
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::DecodeBlock(eBlockFormat format, const uint8_t* pBlock, uint8_t* pOutRgba)
+    {
+        switch (format)
+        {
+        case eBlockFormat::BC1:
+            decodeBC1Block(pBlock, pOutRgba, false);
+            break;
+
+        case eBlockFormat::BC3:
+            decodeBC1Block(&pBlock[8], pOutRgba, true);
+            decodeBC4Block(&pBlock[0], &pOutRgba[3], 4u);
+            break;
+
+        case eBlockFormat::BC5:
+            decodeBC4Block(&pBlock[0], &pOutRgba[0], 4u);
+            decodeBC4Block(&pBlock[8], &pOutRgba[1], 4u);
+            for (uint32_t i = 0u; i < NUM_BLOCK_PIXELS; ++i)
+            {
+                pOutRgba[i * 4u + 2u] = 0u;
+                pOutRgba[i * 4u + 3u] = 255u;
+            }
+            break;
+
+        default:
+            std::memset(pOutRgba, 0, NUM_BLOCK_PIXELS * 4u);
+            break;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::ComputePsnr
+      Summary:  Returns the peak signal to noise ratio of an image
+                against its reference over the selected channels
+      Args:     const Image& reference
+                  Original image
+                const Image& image
+                  Image to measure, of the same size
+                uint32_t uChannelMask
+                  Combination of the CHANNEL_ flags
+      Returns:  double
+                  PSNR in dB, infinity for identical images and 0 for
+                  images of different sizes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double BlockCompressor::ComputePsnr(const Image& reference, const Image& image, uint32_t uChannelMask)
+    {
+        if (reference.uWidth != image.uWidth || reference.uHeight != image.uHeight || reference.aPixels.size() != image.aPixels.size() || uChannelMask == 0u)
+        {
+            return 0.0;
+        }
+
+        double sumSquaredError = 0.0;
+        uint64_t uNumSamples = 0ull;
+        for (size_t i = 0u; i < reference.aPixels.size(); ++i)
+        {
+            if ((uChannelMask & (1u << (i % 4u))) == 0u)
+            {
+                continue;
+            }
+
+            double error = static_cast<double>(reference.aPixels[i]) - static_cast<double>(image.aPixels[i]);
+            sumSquaredError += error * error;
+            ++uNumSamples;
+        }
+
+        if (uNumSamples == 0ull || sumSquaredError == 0.0)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        double meanSquaredError = sumSquaredError / static_cast<double>(uNumSamples);
+        return 10.0 * std::log10((255.0 * 255.0) / meanSquaredError);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::encodeBlock
+      Summary:  Encodes a 4x4 block to the given format
+      Args:     eBlockFormat format
+                  Block format
+                const uint8_t* pRgba
+                  16 RGBA8 pixels, row by row
+                uint8_t* pOutBlock
+                  Encoded block
+                uint32_t uNumRefinements
+                  Number of least squares iterations of the colour
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::encodeBlock(eBlockFormat format, const uint8_t* pRgba, uint8_t* pOutBlock, uint32_t uNumRefinements)
+    {
+        switch (format)
+        {
+        case eBlockFormat::BC1:
+            EncodeBC1Block(pRgba, pOutBlock, uNumRefinements);
+            break;
+
+        case eBlockFormat::BC3:
+            EncodeBC3Block(pRgba, pOutBlock, uNumRefinements);
+            break;
+
+        case eBlockFormat::BC5:
+            EncodeBC5Block(pRgba, pOutBlock);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::decodeBC1Block
+      Summary:  Decodes a BC1 colour block. Outside BC3, color0 <=
+                color1 selects three colours plus transparent black
+      Args:     const uint8_t* pBlock
+                  8 bytes of the encoded block
+                uint8_t* pOutRgba
+                  16 RGBA8 pixels, row by row
+                bool bAlwaysFourColors
+                  Whether the block is the colour part of BC3
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::decodeBC1Block(const uint8_t* pBlock, uint8_t* pOutRgba, bool bAlwaysFourColors)
+    {
+        uint16_t uColor0 = static_cast<uint16_t>(pBlock[0] | (pBlock[1] << 8u));
+        uint16_t uColor1 = static_cast<uint16_t>(pBlock[2] | (pBlock[3] << 8u));
+        uint32_t uIndices = readUint32(&pBlock[4]);
+
+        uint8_t aPalette[4][4];
+        unpackRgb565(uColor0, aPalette[0]);
+        unpackRgb565(uColor1, aPalette[1]);
+        aPalette[0][3] = 255u;
+        aPalette[1][3] = 255u;
+        aPalette[2][3] = 255u;
+        aPalette[3][3] = 255u;
+
+        for (uint32_t c = 0u; c < 3u; ++c)
+        {
+            uint32_t uValue0 = aPalette[0][c];
+            uint32_t uValue1 = aPalette[1][c];
+            if (bAlwaysFourColors || uColor0 > uColor1)
+            {
+                aPalette[2][c] = static_cast<uint8_t>((2u * uValue0 + uValue1 + 1u) / 3u);
+                aPalette[3][c] = static_cast<uint8_t>((uValue0 + 2u * uValue1 + 1u) / 3u);
+            }
+            else
+            {
+                aPalette[2][c] = static_cast<uint8_t>((uValue0 + uValue1) / 2u);
+                aPalette[3][c] = 0u;
+            }
+        }
+        if (!bAlwaysFourColors && uColor0 <= uColor1)
+        {
+            aPalette[3][3] = 0u;
+        }
+
+        for (uint32_t i = 0u; i < NUM_BLOCK_PIXELS; ++i)
+        {
+            std::memcpy(&pOutRgba[i * 4u], aPalette[(uIndices >> (2u * i)) & 0x3u], 4u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::decodeBC4Block
+      Summary:  Decodes a BC4 channel block
+      Args:     const uint8_t* pBlock
+                  8 bytes of the encoded block
+                uint8_t* pOutValues
+                  First decoded value
+                uint32_t uStride
+                  Distance between consecutive values in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::decodeBC4Block(const uint8_t* pBlock, uint8_t* pOutValues, uint32_t uStride)
+    {
+        uint32_t aPalette[8];
+        buildChannelPalette(pBlock[0], pBlock[1], aPalette);
+
+        uint64_t uIndices = 0ull;
+        for (uint32_t i = 0u; i < 6u; ++i)
+        {
+            uIndices |= static_cast<uint64_t>(pBlock[2u + i]) << (8u * i);
+        }
+
+        for (uint32_t i = 0u; i < NUM_BLOCK_PIXELS; ++i)
+        {
+            pOutValues[i * uStride] = static_cast<uint8_t>(aPalette[(uIndices >> (3u * i)) & 0x7u]);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSOR.H
+
+  Summary:   BlockCompressor header file contains declaration of class
+             BlockCompressor used to encode images to the BC1, BC3
+             and BC5 block compressed formats on the CPU. It only
+             depends on the standard library so the encoder can run
+             and be measured on any platform.
+
+  Classes:  BlockCompressor
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Texture/Image.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eBlockFormat
+      Summary:  Block compressed formats the encoder produces
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eBlockFormat : uint32_t
+    {
+        BC1,
+        BC3,
+        BC5,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BlockCompressor
+      Summary:  Encodes RGBA8 images block by block. BC1 stores RGB in
+                half a byte per pixel, BC3 adds an interpolated alpha
+                block and BC5 stores the red and green channels of a
+                normal map in two independent channel blocks. Colour
+                endpoints are fitted along the principal axis of the
+                block and refined by least squares; block rows are
+                encoded in parallel
+      Methods:  Compress
+                  Encodes a whole image
+                Decompress
+                  Decodes blocks back to an image
+                SetNumThreads
+                  Sets the number of encoding threads
+                SetNumRefinements
+                  Sets the number of least squares iterations
+                GetFormat
+                  Returns the block format
+                GetBlockByteSize
+                  Returns the size of a block of the format
+                ComputeCompressedByteSize
+                  Returns the size of an encoded surface
+                EncodeBC1Block
+                  Encodes a 4x4 block to BC1
+                EncodeBC3Block
+                  Encodes a 4x4 block to BC3
+                EncodeBC4Block
+                  Encodes 16 single channel values to a BC4 block
+                EncodeBC5Block
+                  Encodes the red and green channels to BC5
+                DecodeBlock
+                  Decodes a block of the given format
+                ComputePsnr
+                  Returns the peak signal to noise ratio of two images
+                BlockCompressor
+                  Constructor.
+                ~BlockCompressor
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BlockCompressor
+    {
+    public:
+        static constexpr const uint32_t BLOCK_DIMENSION = 4u;
+        static constexpr const uint32_t NUM_BLOCK_PIXELS = BLOCK_DIMENSION * BLOCK_DIMENSION;
+        static constexpr const uint32_t DEFAULT_NUM_REFINEMENTS = 2u;
+
+        static constexpr const uint32_t CHANNEL_R = 0x1u;
+        static constexpr const uint32_t CHANNEL_G = 0x2u;
+        static constexpr const uint32_t CHANNEL_B = 0x4u;
+        static constexpr const uint32_t CHANNEL_A = 0x8u;
+
+    public:
+        BlockCompressor() = delete;
+        explicit BlockCompressor(eBlockFormat format);
+        BlockCompressor(const BlockCompressor& other) = delete;
+        BlockCompressor(BlockCompressor&& other) = delete;
+        BlockCompressor& operator=(const BlockCompressor& other) = delete;
+        BlockCompressor& operator=(BlockCompressor&& other) = delete;
+        virtual ~BlockCompressor() = default;
+
+        void Compress(const Image& image, std::vector<uint8_t>& aOutBlocks) const;
+        void Decompress(uint32_t uWidth, uint32_t uHeight, const uint8_t* pBlocks, Image& outImage) const;
+
+        void SetNumThreads(uint32_t uNumThreads);
+        void SetNumRefinements(uint32_t uNumRefinements);
+
+        eBlockFormat GetFormat() const;
+        uint32_t GetBlockByteSize() const;
+
+        static uint32_t GetBlockByteSize(eBlockFormat format);
+        static uint64_t ComputeCompressedByteSize(eBlockFormat format, uint32_t uWidth, uint32_t uHeight);
+
+        static void EncodeBC1Block(const uint8_t* pRgba, uint8_t* pOutBlock, uint32_t uNumRefinements = DEFAULT_NUM_REFINEMENTS);
+        static void EncodeBC3Block(const uint8_t* pRgba, uint8_t* pOutBlock, uint32_t uNumRefinements = DEFAULT_NUM_REFINEMENTS);
+        static void EncodeBC4Block(const uint8_t* pValues, uint32_t uStride, uint8_t* pOutBlock);
+        static void EncodeBC5Block(const uint8_t* pRgba, uint8_t* pOutBlock);
+        static void DecodeBlock(eBlockFormat format, const uint8_t* pBlock, uint8_t* pOutRgba);
+
+        static double ComputePsnr(const Image& reference, const Image& image, uint32_t uChannelMask);
+
+    private:
+        static void encodeBlock(eBlockFormat format, const uint8_t* pRgba, uint8_t* pOutBlock, uint32_t uNumRefinements);
+        static void decodeBC1Block(const uint8_t* pBlock, uint8_t* pOutRgba, bool bAlwaysFourColors);
+        static void decodeBC4Block(const uint8_t* pBlock, uint8_t* pOutValues, uint32_t uStride);
+
+    private:
+        eBlockFormat m_format;
+        uint32_t m_uNumThreads;
+        uint32_t m_uNumRefinements;
+    };
+}
@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      DDSFORMAT.H
+
+  Summary:   DDSFormat header file contains the on-disk structures and
+             constants of the DDS file format shared by the DDS writer,
+             the DDS layout parser and the other readers. It only
+             depends on the standard library.
+
+  Classes:  DDSPixelFormat, DDSHeader, DDSHeaderDXT10
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eDDSFormat
+      Summary:  DXGI_FORMAT values stored in the DX10 extension header
+                of the formats the tools produce
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eDDSFormat : uint32_t
+    {
+        UNKNOWN = 0u,
+        R8G8B8A8_UNORM = 28u,
+        R8G8B8A8_UNORM_SRGB = 29u,
+        BC1_UNORM = 71u,
+        BC1_UNORM_SRGB = 72u,
+        BC3_UNORM = 77u,
+        BC3_UNORM_SRGB = 78u,
+        BC5_UNORM = 83u,
+    };
+
+    constexpr const uint32_t DDS_MAGIC = 0x20534444u; // "DDS "
+    constexpr const uint32_t DDS_FOURCC_DX10 = 0x30315844u; // "DX10"
+
+    constexpr const uint32_t DDS_PIXELFORMAT_ALPHA = 0x00000002u;
+    constexpr const uint32_t DDS_PIXELFORMAT_FOURCC = 0x00000004u;
+    constexpr const uint32_t DDS_PIXELFORMAT_RGB = 0x00000040u;
+    constexpr const uint32_t DDS_PIXELFORMAT_LUMINANCE = 0x00020000u;
+
+    constexpr const uint32_t DDS_HEADER_FLAGS_TEXTURE = 0x00001007u; // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT
+    constexpr const uint32_t DDS_HEADER_FLAGS_MIPMAP = 0x00020000u;
+    constexpr const uint32_t DDS_HEADER_FLAGS_VOLUME = 0x00800000u;
+    constexpr const uint32_t DDS_HEADER_FLAGS_PITCH = 0x00000008u;
+    constexpr const uint32_t DDS_HEADER_FLAGS_LINEARSIZE = 0x00080000u;
+
+    constexpr const uint32_t DDS_SURFACE_FLAGS_TEXTURE = 0x00001000u;
+    constexpr const uint32_t DDS_SURFACE_FLAGS_MIPMAP = 0x00400008u; // DDSCAPS_COMPLEX | DDSCAPS_MIPMAP
+    constexpr const uint32_t DDS_CUBEMAP = 0x00000200u;
+    constexpr const uint32_t DDS_CUBEMAP_ALLFACES = 0x0000FC00u; // DDSCAPS2_CUBEMAP_POSITIVEX ... NEGATIVEZ
+
+    constexpr const uint32_t DDS_DIMENSION_TEXTURE1D = 2u;
+    constexpr const uint32_t DDS_DIMENSION_TEXTURE2D = 3u;
+    constexpr const uint32_t DDS_DIMENSION_TEXTURE3D = 4u;
+    constexpr const uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSPixelFormat
+      Summary:  DDS_PIXELFORMAT of the legacy header
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSPixelFormat
+    {
+        uint32_t uSize;
+        uint32_t uFlags;
+        uint32_t uFourCC;
+        uint32_t uRGBBitCount;
+        uint32_t uRBitMask;
+        uint32_t uGBitMask;
+        uint32_t uBBitMask;
+        uint32_t uABitMask;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSHeader
+      Summary:  DDS_HEADER following the magic number
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSHeader
+    {
+        uint32_t uSize;
+        uint32_t uFlags;
+        uint32_t uHeight;
+        uint32_t uWidth;
+        uint32_t uPitchOrLinearSize;
+        uint32_t uDepth;
+        uint32_t uMipMapCount;
+        uint32_t auReserved1[11];
+        DDSPixelFormat PixelFormat;
+        uint32_t uCaps;
+        uint32_t uCaps2;
+        uint32_t uCaps3;
+        uint32_t uCaps4;
+        uint32_t uReserved2;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSHeaderDXT10
+      Summary:  DDS_HEADER_DXT10 present when the pixel format FourCC is
+                "DX10"
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSHeaderDXT10
+    {
+        uint32_t uDxgiFormat;
+        uint32_t uResourceDimension;
+        uint32_t uMiscFlag;
+        uint32_t uArraySize;
+        uint32_t uMiscFlags2;
+    };
+
+    static_assert(sizeof(DDSPixelFormat) == 32u, "DDS pixel format size mismatch");
+    static_assert(sizeof(DDSHeader) == 124u, "DDS header size mismatch");
+    static_assert(sizeof(DDSHeaderDXT10) == 20u, "DDS DX10 header size mismatch");
+}
@@ -0,0 +1,533 @@
+#include "Texture/DDSLayout.h"
+
+#include <cstring>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const uint32_t MAX_DIMENSION = 16384u;
+        constexpr const uint32_t MAX_ARRAY_SIZE = 2048u;
+        constexpr const uint32_t NUM_CUBE_FACES = 6u;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: makeFourCC
+          Summary:  Packs four characters the way DDS stores FourCC codes
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        constexpr uint32_t makeFourCC(char ch0, char ch1, char ch2, char ch3)
+        {
+            return static_cast<uint32_t>(static_cast<uint8_t>(ch0))
+                | (static_cast<uint32_t>(static_cast<uint8_t>(ch1)) << 8u)
+                | (static_cast<uint32_t>(static_cast<uint8_t>(ch2)) << 16u)
+                | (static_cast<uint32_t>(static_cast<uint8_t>(ch3)) << 24u);
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: hasMasks
+          Summary:  Returns whether the bit masks of a legacy pixel format
+                    match
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        bool hasMasks(const DDSPixelFormat& pixelFormat, uint32_t uRMask, uint32_t uGMask, uint32_t uBMask, uint32_t uAMask)
+        {
+            return pixelFormat.uRBitMask == uRMask
+                && pixelFormat.uGBitMask == uGMask
+                && pixelFormat.uBBitMask == uBMask
+                && pixelFormat.uABitMask == uAMask;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: computeNumMips
+          Summary:  Returns the length of a full mip chain
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        uint32_t computeNumMips(uint32_t uWidth, uint32_t uHeight, uint32_t uDepth)
+        {
+            uint32_t uLargest = uWidth > uHeight ? uWidth : uHeight;
+            uLargest = uLargest > uDepth ? uLargest : uDepth;
+
+            uint32_t uNumMips = 1u;
+            while (uLargest > 1u)
+            {
+                uLargest >>= 1u;
+                ++uNumMips;
+            }
+
+            return uNumMips;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSLayout::ReadHeader
+      Summary:  Parses the magic number, the legacy header and the DX10
+                header when present. Nothing is copied but the fields
+                of the description
+      Args:     const uint8_t* pData
+                  Bytes of the file, usually a mapped view
+                size_t uSize
+                  Size of the file
+                DDSTextureDesc& outDesc
+                  Shape and format of the texture
+                size_t& uOutDataOffset
+                  Offset of the first subresource
+      Returns:  bool
+                  false if the file is not a DDS file this parser
+                  understands
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DDSLayout::ReadHeader(const uint8_t* pData, size_t uSize, DDSTextureDesc& outDesc, size_t& uOutDataOffset)
+    {
+        outDesc = {};
+        uOutDataOffset = 0u;
+
+        if (!pData || uSize < sizeof(uint32_t) + sizeof(DDSHeader))
+        {
+            return false;
+        }
+
+        uint32_t uMagic = 0u;
+        memcpy(&uMagic, pData, sizeof(uMagic));
+        if (uMagic != DDS_MAGIC)
+        {
+            return false;
+        }
+
+        // The mapping may not be aligned for the structures, so read them through copies
+        DDSHeader header;
+        memcpy(&header, pData + sizeof(uint32_t), sizeof(header));
+        if (header.uSize != sizeof(DDSHeader) || header.PixelFormat.uSize != sizeof(DDSPixelFormat))
+        {
+            return false;
+        }
+
+        size_t uDataOffset = sizeof(uint32_t) + sizeof(DDSHeader);
+
+        outDesc.uWidth = header.uWidth;
+        outDesc.uHeight = header.uHeight;
+        outDesc.uDepth = 1u;
+        outDesc.uArraySize = 1u;
+        outDesc.uNumMips = header.uMipMapCount == 0u ? 1u : header.uMipMapCount;
+
+        if ((header.PixelFormat.uFlags & DDS_PIXELFORMAT_FOURCC) && header.PixelFormat.uFourCC == DDS_FOURCC_DX10)
+        {
+            if (uSize < uDataOffset + sizeof(DDSHeaderDXT10))
+            {
+                return false;
+            }
+
+            DDSHeaderDXT10 headerDxt10;
+            memcpy(&headerDxt10, pData + uDataOffset, sizeof(headerDxt10));
+            uDataOffset += sizeof(DDSHeaderDXT10);
+
+            outDesc.uDimension = headerDxt10.uResourceDimension;
+            outDesc.uDxgiFormat = headerDxt10.uDxgiFormat;
+            outDesc.uArraySize = headerDxt10.uArraySize;
+
+            switch (outDesc.uDimension)
+            {
+            case DDS_DIMENSION_TEXTURE1D:
+                outDesc.uHeight = 1u;
+                break;
+
+            case DDS_DIMENSION_TEXTURE2D:
+                outDesc.bIsCubemap = (headerDxt10.uMiscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) != 0u;
+                break;
+
+            case DDS_DIMENSION_TEXTURE3D:
+                if (!(header.uFlags & DDS_HEADER_FLAGS_VOLUME) || outDesc.uArraySize != 1u)
+                {
+                    return false;
+                }
+                outDesc.uDepth = header.uDepth;
+                break;
+
+            default:
+                return false;
+            }
+        }
+        else
+        {
+            outDesc.uDxgiFormat = legacyFormat(header.PixelFormat);
+
+            if (header.uFlags & DDS_HEADER_FLAGS_VOLUME)
+            {
+                outDesc.uDimension = DDS_DIMENSION_TEXTURE3D;
+                outDesc.uDepth = header.uDepth;
+            }
+            else
+            {
+                outDesc.uDimension = DDS_DIMENSION_TEXTURE2D;
+
+                if (header.uCaps2 & DDS_CUBEMAP)
+                {
+                    // Legacy files may omit faces, which Direct3D cannot represent
+                    if ((header.uCaps2 & DDS_CUBEMAP_ALLFACES) != DDS_CUBEMAP_ALLFACES)
+                    {
+                        return false;
+                    }
+                    outDesc.bIsCubemap = true;
+                }
+            }
+        }
+
+        uint32_t uBitsPerBlock = 0u;
+        uint32_t uBlockDimension = 0u;
+        if (!GetFormatInfo(outDesc.uDxgiFormat, uBitsPerBlock, uBlockDimension))
+        {
+            return false;
+        }
+
+        if (outDesc.uWidth == 0u || outDesc.uHeight == 0u || outDesc.uDepth == 0u || outDesc.uArraySize == 0u
+            || outDesc.uWidth > MAX_DIMENSION || outDesc.uHeight > MAX_DIMENSION || outDesc.uDepth > MAX_DIMENSION
+            || outDesc.uArraySize > MAX_ARRAY_SIZE
+            || outDesc.uNumMips > computeNumMips(outDesc.uWidth, outDesc.uHeight, outDesc.uDepth))
+        {
+            return false;
+        }
+
+        uOutDataOffset = uDataOffset;
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSLayout::GetSubresources
+      Summary:  Walks the subresources in file order, every mip level of
+                the first slice (or cube face) then of the next one,
+                and returns the ones of the range in the order
+                D3D11CalcSubresource expects
+      Args:     const DDSTextureDesc& desc
+                  Description returned by ReadHeader
+                size_t uDataOffset
+                  Offset returned by ReadHeader
+                size_t uSize
+                  Size of the file
+                const DDSRange& range
+                  Mip levels and array slices to load
+                DDSTextureDesc& outRangeDesc
+                  Description of the texture holding only the range
+                std::vector<DDSSubresource>& aOutSubresources
+                  Subresources of the range
+      Returns:  bool
+                  false if the range is empty or the file is truncated
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DDSLayout::GetSubresources(
+        const DDSTextureDesc& desc,
+        size_t uDataOffset,
+        size_t uSize,
+        const DDSRange& range,
+        DDSTextureDesc& outRangeDesc,
+        std::vector<DDSSubresource>& aOutSubresources
+    )
+    {
+        aOutSubresources.clear();
+
+        if (range.uFirstMip >= desc.uNumMips || range.uFirstSlice >= desc.uArraySize)
+        {
+            return false;
+        }
+
+        uint32_t uNumMips = range.uNumMips == 0u ? desc.uNumMips - range.uFirstMip : range.uNumMips;
+        uint32_t uNumSlices = range.uNumSlices == 0u ? desc.uArraySize - range.uFirstSlice : range.uNumSlices;
+        if (uNumMips > desc.uNumMips - range.uFirstMip || uNumSlices > desc.uArraySize - range.uFirstSlice)
+        {
+            return false;
+        }
+
+        uint32_t uNumFaces = desc.bIsCubemap ? NUM_CUBE_FACES : 1u;
+        aOutSubresources.reserve(static_cast<size_t>(uNumSlices) * uNumFaces * uNumMips);
+
+        uint64_t uOffset = uDataOffset;
+        for (uint32_t uSlice = 0u; uSlice < desc.uArraySize * uNumFaces; ++uSlice)
+        {
+            uint32_t uWidth = desc.uWidth;
+            uint32_t uHeight = desc.uHeight;
+            uint32_t uDepth = desc.uDepth;
+
+            bool bIsSliceInRange = uSlice / uNumFaces >= range.uFirstSlice && uSlice / uNumFaces < range.uFirstSlice + uNumSlices;
+
+            for (uint32_t uMip = 0u; uMip < desc.uNumMips; ++uMip)
+            {
+                uint32_t uRowPitch = 0u;
+                uint32_t uSlicePitch = 0u;
+                if (!ComputePitch(desc.uDxgiFormat, uWidth, uHeight, uRowPitch, uSlicePitch))
+                {
+                    aOutSubresources.clear();
+                    return false;
+                }
+
+                uint64_t uByteSize = static_cast<uint64_t>(uSlicePitch) * uDepth;
+                if (uOffset + uByteSize > uSize)
+                {
+                    aOutSubresources.clear();
+                    return false;
+                }
+
+                if (bIsSliceInRange && uMip >= range.uFirstMip && uMip < range.uFirstMip + uNumMips)
+                {
+                    aOutSubresources.push_back(
+                        DDSSubresource
+                        {
+                            .uWidth = uWidth,
+                            .uHeight = uHeight,
+                            .uDepth = uDepth,
+                            .uRowPitch = uRowPitch,
+                            .uSlicePitch = uSlicePitch,
+                            .uOffset = uOffset,
+                            .uByteSize = uByteSize
+                        }
+                    );
+                }
+
+                uOffset += uByteSize;
+                uWidth = uWidth > 1u ? uWidth / 2u : 1u;
+                uHeight = uHeight > 1u ? uHeight / 2u : 1u;
+                uDepth = uDepth > 1u ? uDepth / 2u : 1u;
+            }
+
+            // Nothing after the last selected slice needs to be present
+            if (uSlice + 1u == (range.uFirstSlice + uNumSlices) * uNumFaces)
+            {
+                break;
+            }
+        }
+
+        const DDSSubresource& first = aOutSubresources.front();
+
+        outRangeDesc = desc;
+        outRangeDesc.uWidth = first.uWidth;
+        outRangeDesc.uHeight = first.uHeight;
+        outRangeDesc.uDepth = first.uDepth;
+        outRangeDesc.uArraySize = uNumSlices;
+        outRangeDesc.uNumMips = uNumMips;
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSLayout::GetFormatInfo
+      Summary:  Returns the storage unit of a DXGI format: a single
+                pixel, or a 4x4 block for block compressed formats
+      Args:     uint32_t uDxgiFormat
+                  DXGI_FORMAT value
+                uint32_t& uOutBitsPerBlock
+                  Size of a pixel or a block in bits
+                uint32_t& uOutBlockDimension
+                  1 for pixels, 4 for blocks
+      Returns:  bool
+                  false for unknown, packed and video formats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DDSLayout::GetFormatInfo(uint32_t uDxgiFormat, uint32_t& uOutBitsPerBlock, uint32_t& uOutBlockDimension)
+    {
+        uOutBitsPerBlock = 0u;
+        uOutBlockDimension = 1u;
+
+        if (uDxgiFormat >= 1u && uDxgiFormat <= 4u)
+        {
+            uOutBitsPerBlock = 128u; // R32G32B32A32
+        }
+        else if (uDxgiFormat >= 5u && uDxgiFormat <= 8u)
+        {
+            uOutBitsPerBlock = 96u; // R32G32B32
+        }
+        else if (uDxgiFormat >= 9u && uDxgiFormat <= 22u)
+        {
+            uOutBitsPerBlock = 64u; // R16G16B16A16, R32G32, R32G8X24
+        }
+        else if ((uDxgiFormat >= 23u && uDxgiFormat <= 47u) || uDxgiFormat == 67u || (uDxgiFormat >= 87u && uDxgiFormat <= 93u))
+        {
+            uOutBitsPerBlock = 32u; // R10G10B10A2, R11G11B10, R8G8B8A8, R16G16, R32, R24G8, R9G9B9E5, B8G8R8A8, B8G8R8X8
+        }
+        else if ((uDxgiFormat >= 48u && uDxgiFormat <= 59u) || uDxgiFormat == 85u || uDxgiFormat == 86u || uDxgiFormat == 115u)
+        {
+            uOutBitsPerBlock = 16u; // R8G8, R16, B5G6R5, B5G5R5A1, B4G4R4A4
+        }
+        else if (uDxgiFormat >= 60u && uDxgiFormat <= 65u)
+        {
+            uOutBitsPerBlock = 8u; // R8, A8
+        }
+        else if ((uDxgiFormat >= 70u && uDxgiFormat <= 72u) || (uDxgiFormat >= 79u && uDxgiFormat <= 81u))
+        {
+            uOutBitsPerBlock = 64u; // BC1, BC4
+            uOutBlockDimension = 4u;
+        }
+        else if ((uDxgiFormat >= 73u && uDxgiFormat <= 78u) || (uDxgiFormat >= 82u && uDxgiFormat <= 84u) || (uDxgiFormat >= 94u && uDxgiFormat <= 99u))
+        {
+            uOutBitsPerBlock = 128u; // BC2, BC3, BC5, BC6H, BC7
+            uOutBlockDimension = 4u;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSLayout::ComputePitch
+      Summary:  Returns the size of a row of pixels or blocks and of a
+                whole 2D surface
+      Args:     uint32_t uDxgiFormat
+                  DXGI_FORMAT value
+                uint32_t uWidth
+                  Width of the surface
+                uint32_t uHeight
+                  Height of the surface
+                uint32_t& uOutRowPitch
+                  Bytes per row
+                uint32_t& uOutSlicePitch
+                  Bytes per surface
+      Returns:  bool
+                  false for unsupported formats and surfaces of 4 GB
+                  or more
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DDSLayout::ComputePitch(uint32_t uDxgiFormat, uint32_t uWidth, uint32_t uHeight, uint32_t& uOutRowPitch, uint32_t& uOutSlicePitch)
+    {
+        uOutRowPitch = 0u;
+        uOutSlicePitch = 0u;
+
+        uint32_t uBitsPerBlock = 0u;
+        uint32_t uBlockDimension = 0u;
+        if (!GetFormatInfo(uDxgiFormat, uBitsPerBlock, uBlockDimension))
+        {
+            return false;
+        }
+
+        uint64_t uNumBlocksWide = (static_cast<uint64_t>(uWidth) + uBlockDimension - 1u) / uBlockDimension;
+        uint64_t uNumBlocksHigh = (static_cast<uint64_t>(uHeight) + uBlockDimension - 1u) / uBlockDimension;
+        uint64_t uRowPitch = (uNumBlocksWide * uBitsPerBlock + 7u) / 8u;
+        uint64_t uSlicePitch = uRowPitch * uNumBlocksHigh;
+        if (uSlicePitch > UINT32_MAX)
+        {
+            return false;
+        }
+
+        uOutRowPitch = static_cast<uint32_t>(uRowPitch);
+        uOutSlicePitch = static_cast<uint32_t>(uSlicePitch);
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSLayout::legacyFormat
+      Summary:  Translates the pixel format of a file without the DX10
+                header to its DXGI format, following the conventions of
+                the D3DX writers
+      Args:     const DDSPixelFormat& pixelFormat
+                  Legacy pixel format
+      Returns:  uint32_t
+                  DXGI_FORMAT value, 0 if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t DDSLayout::legacyFormat(const DDSPixelFormat& pixelFormat)
+    {
+        if (pixelFormat.uFlags & DDS_PIXELFORMAT_RGB)
+        {
+            if (pixelFormat.uRGBBitCount == 32u)
+            {
+                if (hasMasks(pixelFormat, 0x000000FFu, 0x0000FF00u, 0x00FF0000u, 0xFF000000u))
+                {
+                    return 28u; // R8G8B8A8_UNORM
+                }
+                if (hasMasks(pixelFormat, 0x00FF0000u, 0x0000FF00u, 0x000000FFu, 0xFF000000u))
+                {
+                    return 87u; // B8G8R8A8_UNORM
+                }
+                if (hasMasks(pixelFormat, 0x00FF0000u, 0x0000FF00u, 0x000000FFu, 0x00000000u))
+                {
+                    return 88u; // B8G8R8X8_UNORM
+                }
+                if (hasMasks(pixelFormat, 0x3FF00000u, 0x000FFC00u, 0x000003FFu, 0xC0000000u))
+                {
+                    return 24u; // R10G10B10A2_UNORM, written with swapped masks by D3DX
+                }
+                if (hasMasks(pixelFormat, 0x0000FFFFu, 0xFFFF0000u, 0x00000000u, 0x00000000u))
+                {
+                    return 35u; // R16G16_UNORM
+                }
+                if (hasMasks(pixelFormat, 0xFFFFFFFFu, 0x00000000u, 0x00000000u, 0x00000000u))
+                {
+                    return 41u; // R32_FLOAT
+                }
+            }
+            else if (pixelFormat.uRGBBitCount == 16u)
+            {
+                if (hasMasks(pixelFormat, 0x7C00u, 0x03E0u, 0x001Fu, 0x8000u))
+                {
+                    return 86u; // B5G5R5A1_UNORM
+                }
+                if (hasMasks(pixelFormat, 0xF800u, 0x07E0u, 0x001Fu, 0x0000u))
+                {
+                    return 85u; // B5G6R5_UNORM
+                }
+                if (hasMasks(pixelFormat, 0x0F00u, 0x00F0u, 0x000Fu, 0xF000u))
+                {
+                    return 115u; // B4G4R4A4_UNORM
+                }
+            }
+        }
+        else if (pixelFormat.uFlags & DDS_PIXELFORMAT_LUMINANCE)
+        {
+            if (pixelFormat.uRGBBitCount == 8u && hasMasks(pixelFormat, 0xFFu, 0u, 0u, 0u))
+            {
+                return 61u; // R8_UNORM
+            }
+            if (pixelFormat.uRGBBitCount == 16u && hasMasks(pixelFormat, 0xFFFFu, 0u, 0u, 0u))
+            {
+                return 56u; // R16_UNORM
+            }
+            if (pixelFormat.uRGBBitCount == 16u && hasMasks(pixelFormat, 0x00FFu, 0u, 0u, 0xFF00u))
+            {
+                return 49u; // R8G8_UNORM
+            }
+        }
+        else if (pixelFormat.uFlags & DDS_PIXELFORMAT_ALPHA)
+        {
+            if (pixelFormat.uRGBBitCount == 8u)
+            {
+                return 65u; // A8_UNORM
+            }
+        }
+        else if (pixelFormat.uFlags & DDS_PIXELFORMAT_FOURCC)
+        {
+            switch (pixelFormat.uFourCC)
+            {
+            case makeFourCC('D', 'X', 'T', '1'):
+                return 71u; // BC1_UNORM
+            case makeFourCC('D', 'X', 'T', '2'):
+            case makeFourCC('D', 'X', 'T', '3'):
+                return 74u; // BC2_UNORM
+            case makeFourCC('D', 'X', 'T', '4'):
+            case makeFourCC('D', 'X', 'T', '5'):
+                return 77u; // BC3_UNORM
+            case makeFourCC('A', 'T', 'I', '1'):
+            case makeFourCC('B', 'C', '4', 'U'):
+                return 80u; // BC4_UNORM
+            case makeFourCC('B', 'C', '4', 'S'):
+                return 81u; // BC4_SNORM
+            case makeFourCC('A', 'T', 'I', '2'):
+            case makeFourCC('B', 'C', '5', 'U'):
+                return 83u; // BC5_UNORM
+            case makeFourCC('B', 'C', '5', 'S'):
+                return 84u; // BC5_SNORM
+            case 36u:
+                return 11u; // R16G16B16A16_UNORM
+            case 110u:
+                return 13u; // R16G16B16A16_SNORM
+            case 111u:
+                return 54u; // R16_FLOAT
+            case 112u:
+                return 34u; // R16G16_FLOAT
+            case 113u:
+                return 10u; // R16G16B16A16_FLOAT
+            case 114u:
+                return 41u; // R32_FLOAT
+            case 115u:
+                return 16u; // R32G32_FLOAT
+            case 116u:
+                return 2u; // R32G32B32A32_FLOAT
+            default:
+                break;
+            }
+        }
+
+        return 0u;
+    }
+}
@@ -0,0 +1,111 @@
+/*+===================================================================
+  File:      DDSLAYOUT.H
+
+  Summary:   DDSLayout header file contains declaration of class
+             DDSLayout used to parse DDS headers in place and locate
+             every subresource inside the file, so that loaders can
+             hand pointers into a mapped file to the GPU. It only
+             depends on the standard library.
+
+  Classes:  DDSTextureDesc, DDSRange, DDSSubresource, DDSLayout
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Texture/DDSFormat.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSTextureDesc
+      Summary:  Shape and format of the texture stored in a DDS file.
+                Cubemaps count every cube once in uArraySize
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSTextureDesc
+    {
+        uint32_t uDimension;
+        uint32_t uDxgiFormat;
+        uint32_t uWidth;
+        uint32_t uHeight;
+        uint32_t uDepth;
+        uint32_t uArraySize;
+        uint32_t uNumMips;
+        bool bIsCubemap;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSRange
+      Summary:  Mip levels and array slices to load. A count of 0
+                selects everything from the first one to the end
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSRange
+    {
+        uint32_t uFirstMip;
+        uint32_t uNumMips;
+        uint32_t uFirstSlice;
+        uint32_t uNumSlices;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSSubresource
+      Summary:  Size, pitches and position in the file of one mip level
+                of one array slice or cube face
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSSubresource
+    {
+        uint32_t uWidth;
+        uint32_t uHeight;
+        uint32_t uDepth;
+        uint32_t uRowPitch;
+        uint32_t uSlicePitch;
+        uint64_t uOffset;
+        uint64_t uByteSize;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DDSLayout
+      Summary:  Reads the legacy and the DX10 headers straight from the
+                file bytes and computes where each subresource lives,
+                checking every size against the end of the file. Legacy
+                pixel formats are translated to their DXGI format
+      Methods:  ReadHeader
+                  Parses the headers of a DDS file
+                GetSubresources
+                  Locates the subresources of a range
+                GetFormatInfo
+                  Returns the block size of a DXGI format
+                ComputePitch
+                  Returns the pitches of a surface
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DDSLayout
+    {
+    public:
+        DDSLayout() = delete;
+        DDSLayout(const DDSLayout& other) = delete;
+        DDSLayout(DDSLayout&& other) = delete;
+        DDSLayout& operator=(const DDSLayout& other) = delete;
+        DDSLayout& operator=(DDSLayout&& other) = delete;
+        ~DDSLayout() = delete;
+
+        static bool ReadHeader(const uint8_t* pData, size_t uSize, DDSTextureDesc& outDesc, size_t& uOutDataOffset);
+        static bool GetSubresources(
+            const DDSTextureDesc& desc,
+            size_t uDataOffset,
+            size_t uSize,
+            const DDSRange& range,
+            DDSTextureDesc& outRangeDesc,
+            std::vector<DDSSubresource>& aOutSubresources
+        );
+
+        static bool GetFormatInfo(uint32_t uDxgiFormat, uint32_t& uOutBitsPerBlock, uint32_t& uOutBlockDimension);
+        static bool ComputePitch(uint32_t uDxgiFormat, uint32_t uWidth, uint32_t uHeight, uint32_t& uOutRowPitch, uint32_t& uOutSlicePitch);
+
+    private:
+        static uint32_t legacyFormat(const DDSPixelFormat& pixelFormat);
+    };
+}
@@ -0,0 +1,176 @@
+#include "Texture/DDSWriter.h"
+
+#include <fstream>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSWriter::Write
+      Summary:  Writes the magic number, the headers and every mip
+                level, finest first
+      Args:     const std::filesystem::path& filePath
+                  Path to the DDS file
+                const DDSImageDesc& desc
+                  Size and format of the texture
+                const std::vector<std::vector<uint8_t>>& aMips
+                  Data of every mip level, tightly packed
+      Returns:  bool
+                  true if the whole file was written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DDSWriter::Write(const std::filesystem::path& filePath, const DDSImageDesc& desc, const std::vector<std::vector<uint8_t>>& aMips)
+    {
+        if (desc.uWidth == 0u || desc.uHeight == 0u || desc.uNumMips == 0u || aMips.size() != desc.uNumMips)
+        {
+            return false;
+        }
+
+        uint32_t uWidth = desc.uWidth;
+        uint32_t uHeight = desc.uHeight;
+        for (const std::vector<uint8_t>& aMip : aMips)
+        {
+            if (aMip.size() != ComputeSurfaceByteSize(desc.Format, uWidth, uHeight))
+            {
+                return false;
+            }
+
+            uWidth = uWidth > 1u ? uWidth / 2u : 1u;
+            uHeight = uHeight > 1u ? uHeight / 2u : 1u;
+        }
+
+        bool bIsBlockCompressed = IsBlockCompressed(desc.Format);
+
+        DDSHeader header = {};
+        header.uSize = sizeof(DDSHeader);
+        header.uFlags = DDS_HEADER_FLAGS_TEXTURE | (bIsBlockCompressed ? DDS_HEADER_FLAGS_LINEARSIZE : DDS_HEADER_FLAGS_PITCH);
+        header.uHeight = desc.uHeight;
+        header.uWidth = desc.uWidth;
+        header.uPitchOrLinearSize = bIsBlockCompressed
+            ? static_cast<uint32_t>(ComputeSurfaceByteSize(desc.Format, desc.uWidth, desc.uHeight))
+            : desc.uWidth * 4u;
+        header.uDepth = 1u;
+        header.uMipMapCount = desc.uNumMips;
+        header.PixelFormat.uSize = sizeof(DDSPixelFormat);
+        header.PixelFormat.uFlags = DDS_PIXELFORMAT_FOURCC;
+        header.PixelFormat.uFourCC = DDS_FOURCC_DX10;
+        header.uCaps = DDS_SURFACE_FLAGS_TEXTURE;
+        if (desc.uNumMips > 1u)
+        {
+            header.uFlags |= DDS_HEADER_FLAGS_MIPMAP;
+            header.uCaps |= DDS_SURFACE_FLAGS_MIPMAP;
+        }
+
+        DDSHeaderDXT10 headerDXT10 =
+        {
+            .uDxgiFormat = static_cast<uint32_t>(desc.Format),
+            .uResourceDimension = DDS_DIMENSION_TEXTURE2D,
+            .uMiscFlag = 0u,
+            .uArraySize = 1u,
+            .uMiscFlags2 = 0u
+        };
+
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&DDS_MAGIC), sizeof(DDS_MAGIC));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&headerDXT10), sizeof(headerDXT10));
+        for (const std::vector<uint8_t>& aMip : aMips)
+        {
+            file.write(reinterpret_cast<const char*>(aMip.data()), static_cast<std::streamsize>(aMip.size()));
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSWriter::ToDDSFormat
+      Summary:  Returns the DXGI format of a block format. BC5 has no
+                sRGB variant
+      Args:     eBlockFormat format
+                  Block format
+                bool bIsSrgb
+                  Whether the colour is stored in sRGB
+      Returns:  eDDSFormat
+                  DXGI format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eDDSFormat DDSWriter::ToDDSFormat(eBlockFormat format, bool bIsSrgb)
+    {
+        switch (format)
+        {
+        case eBlockFormat::BC1:
+            return bIsSrgb ? eDDSFormat::BC1_UNORM_SRGB : eDDSFormat::BC1_UNORM;
+
+        case eBlockFormat::BC3:
+            return bIsSrgb ? eDDSFormat::BC3_UNORM_SRGB : eDDSFormat::BC3_UNORM;
+
+        case eBlockFormat::BC5:
+            return eDDSFormat::BC5_UNORM;
+
+        default:
+            return eDDSFormat::UNKNOWN;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSWriter::IsBlockCompressed
+      Summary:  Returns whether the format stores 4x4 blocks
+      Args:     eDDSFormat format
+                  DXGI format
+      Returns:  bool
+                  true for the BC formats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DDSWriter::IsBlockCompressed(eDDSFormat format)
+    {
+        switch (format)
+        {
+        case eDDSFormat::BC1_UNORM:
+        case eDDSFormat::BC1_UNORM_SRGB:
+        case eDDSFormat::BC3_UNORM:
+        case eDDSFormat::BC3_UNORM_SRGB:
+        case eDDSFormat::BC5_UNORM:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DDSWriter::ComputeSurfaceByteSize
+      Summary:  Returns the size of a tightly packed surface
+      Args:     eDDSFormat format
+                  DXGI format
+                uint32_t uWidth
+                  Width of the surface
+                uint32_t uHeight
+                  Height of the surface
+      Returns:  uint64_t
+                  Size in bytes, 0 for unknown formats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t DDSWriter::ComputeSurfaceByteSize(eDDSFormat format, uint32_t uWidth, uint32_t uHeight)
+    {
+        switch (format)
+        {
+        case eDDSFormat::R8G8B8A8_UNORM:
+        case eDDSFormat::R8G8B8A8_UNORM_SRGB:
+            return static_cast<uint64_t>(uWidth) * uHeight * 4ull;
+
+        case eDDSFormat::BC1_UNORM:
+        case eDDSFormat::BC1_UNORM_SRGB:
+            return BlockCompressor::ComputeCompressedByteSize(eBlockFormat::BC1, uWidth, uHeight);
+
+        case eDDSFormat::BC3_UNORM:
+        case eDDSFormat::BC3_UNORM_SRGB:
+            return BlockCompressor::ComputeCompressedByteSize(eBlockFormat::BC3, uWidth, uHeight);
+
+        case eDDSFormat::BC5_UNORM:
+            return BlockCompressor::ComputeCompressedByteSize(eBlockFormat::BC5, uWidth, uHeight);
+
+        default:
+            return 0ull;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*+===================================================================
+  File:      DDSWRITER.H
+
+  Summary:   DDSWriter header file contains declaration of class
+             DDSWriter used by the offline tools to save processed
+             textures as DDS files readable by DDSTextureLoader.
+
+  Classes:  DDSImageDesc, DDSWriter
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/DDSFormat.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DDSImageDesc
+      Summary:  Size and format of a 2D texture to write
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DDSImageDesc
+    {
+        uint32_t uWidth;
+        uint32_t uHeight;
+        uint32_t uNumMips;
+        eDDSFormat Format;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DDSWriter
+      Summary:  Writes 2D textures with a DX10 extension header so the
+                exact DXGI format, including sRGB, survives the round
+                trip
+      Methods:  Write
+                  Writes the header and every mip level to a file
+                ToDDSFormat
+                  Returns the DXGI format of a block format
+                IsBlockCompressed
+                  Returns whether the format stores 4x4 blocks
+                ComputeSurfaceByteSize
+                  Returns the size of a surface of the format
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DDSWriter
+    {
+    public:
+        DDSWriter() = delete;
+        DDSWriter(const DDSWriter& other) = delete;
+        DDSWriter(DDSWriter&& other) = delete;
+        DDSWriter& operator=(const DDSWriter& other) = delete;
+        DDSWriter& operator=(DDSWriter&& other) = delete;
+        ~DDSWriter() = delete;
+
+        static bool Write(const std::filesystem::path& filePath, const DDSImageDesc& desc, const std::vector<std::vector<uint8_t>>& aMips);
+
+        static eDDSFormat ToDDSFormat(eBlockFormat format, bool bIsSrgb);
+        static bool IsBlockCompressed(eDDSFormat format);
+        static uint64_t ComputeSurfaceByteSize(eDDSFormat format, uint32_t uWidth, uint32_t uHeight);
+    };
+}
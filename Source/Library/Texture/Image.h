@@ -0,0 +1,30 @@
+/*+===================================================================
+  File:      IMAGE.H
+
+  Summary:   Image header file contains declaration of struct Image
+             holding decoded pixels on the CPU for offline texture
+             processing.
+
+  Classes:  Image
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Image
+      Summary:  Tightly packed 8-bit RGBA pixels, row by row from the
+                top left corner
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Image
+    {
+        uint32_t uWidth;
+        uint32_t uHeight;
+        std::vector<uint8_t> aPixels;
+    };
+}
@@ -0,0 +1,232 @@
+#include "Texture/MappedDDSLoader.h"
+
+#include "Utility/MappedFile.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedDDSLoader::CreateTexture
+      Summary:  Creates an immutable texture holding the given range of
+                a DDS file and a view of all of it. The mapping is
+                released once the device has taken its copy
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                const std::filesystem::path& filePath
+                  Path to the DDS file
+                const DDSRange& range
+                  Mip levels and array slices to load
+                ID3D11ShaderResourceView** ppOutTextureView
+                  View of the created texture
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MappedDDSLoader::CreateTexture(
+        _In_ ID3D11Device* pDevice,
+        _In_ const std::filesystem::path& filePath,
+        _In_ const DDSRange& range,
+        _Outptr_ ID3D11ShaderResourceView** ppOutTextureView
+    )
+    {
+        *ppOutTextureView = nullptr;
+
+        MappedFile file(filePath);
+        HRESULT hr = file.Initialize();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        if (!DDSLayout::ReadHeader(file.GetData(), file.GetSize(), desc, uDataOffset))
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        if (!DDSLayout::GetSubresources(desc, uDataOffset, file.GetSize(), range, rangeDesc, aSubresources))
+        {
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        }
+
+        // Direct3D requires the top level of block compressed textures to be whole blocks
+        UINT uBitsPerBlock = 0u;
+        UINT uBlockDimension = 0u;
+        DDSLayout::GetFormatInfo(rangeDesc.uDxgiFormat, uBitsPerBlock, uBlockDimension);
+        if (rangeDesc.uWidth % uBlockDimension != 0u || rangeDesc.uHeight % uBlockDimension != 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<D3D11_SUBRESOURCE_DATA> aInitialData(aSubresources.size());
+        for (size_t i = 0u; i < aSubresources.size(); ++i)
+        {
+            aInitialData[i] =
+            {
+                .pSysMem = file.GetData() + aSubresources[i].uOffset,
+                .SysMemPitch = aSubresources[i].uRowPitch,
+                .SysMemSlicePitch = aSubresources[i].uSlicePitch
+            };
+        }
+
+        DXGI_FORMAT format = static_cast<DXGI_FORMAT>(rangeDesc.uDxgiFormat);
+        ComPtr<ID3D11Resource> resource;
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc =
+        {
+            .Format = format
+        };
+
+        switch (rangeDesc.uDimension)
+        {
+        case DDS_DIMENSION_TEXTURE1D:
+        {
+            D3D11_TEXTURE1D_DESC textureDesc =
+            {
+                .Width = rangeDesc.uWidth,
+                .MipLevels = rangeDesc.uNumMips,
+                .ArraySize = rangeDesc.uArraySize,
+                .Format = format,
+                .Usage = D3D11_USAGE_IMMUTABLE,
+                .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+                .CPUAccessFlags = 0u,
+                .MiscFlags = 0u
+            };
+
+            ComPtr<ID3D11Texture1D> texture1D;
+            hr = pDevice->CreateTexture1D(&textureDesc, aInitialData.data(), texture1D.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            resource = texture1D;
+
+            if (rangeDesc.uArraySize > 1u)
+            {
+                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1DARRAY;
+                srvDesc.Texture1DArray.MipLevels = rangeDesc.uNumMips;
+                srvDesc.Texture1DArray.ArraySize = rangeDesc.uArraySize;
+            }
+            else
+            {
+                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE1D;
+                srvDesc.Texture1D.MipLevels = rangeDesc.uNumMips;
+            }
+            break;
+        }
+
+        case DDS_DIMENSION_TEXTURE2D:
+        {
+            D3D11_TEXTURE2D_DESC textureDesc =
+            {
+                .Width = rangeDesc.uWidth,
+                .Height = rangeDesc.uHeight,
+                .MipLevels = rangeDesc.uNumMips,
+                .ArraySize = rangeDesc.bIsCubemap ? rangeDesc.uArraySize * 6u : rangeDesc.uArraySize,
+                .Format = format,
+                .SampleDesc = {.Count = 1u, .Quality = 0u },
+                .Usage = D3D11_USAGE_IMMUTABLE,
+                .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+                .CPUAccessFlags = 0u,
+                .MiscFlags = rangeDesc.bIsCubemap ? static_cast<UINT>(D3D11_RESOURCE_MISC_TEXTURECUBE) : 0u
+            };
+
+            ComPtr<ID3D11Texture2D> texture2D;
+            hr = pDevice->CreateTexture2D(&textureDesc, aInitialData.data(), texture2D.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            resource = texture2D;
+
+            if (rangeDesc.bIsCubemap && rangeDesc.uArraySize > 1u)
+            {
+                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBEARRAY;
+                srvDesc.TextureCubeArray.MipLevels = rangeDesc.uNumMips;
+                srvDesc.TextureCubeArray.NumCubes = rangeDesc.uArraySize;
+            }
+            else if (rangeDesc.bIsCubemap)
+            {
+                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+                srvDesc.TextureCube.MipLevels = rangeDesc.uNumMips;
+            }
+            else if (rangeDesc.uArraySize > 1u)
+            {
+                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+                srvDesc.Texture2DArray.MipLevels = rangeDesc.uNumMips;
+                srvDesc.Texture2DArray.ArraySize = rangeDesc.uArraySize;
+            }
+            else
+            {
+                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+                srvDesc.Texture2D.MipLevels = rangeDesc.uNumMips;
+            }
+            break;
+        }
+
+        case DDS_DIMENSION_TEXTURE3D:
+        {
+            D3D11_TEXTURE3D_DESC textureDesc =
+            {
+                .Width = rangeDesc.uWidth,
+                .Height = rangeDesc.uHeight,
+                .Depth = rangeDesc.uDepth,
+                .MipLevels = rangeDesc.uNumMips,
+                .Format = format,
+                .Usage = D3D11_USAGE_IMMUTABLE,
+                .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+                .CPUAccessFlags = 0u,
+                .MiscFlags = 0u
+            };
+
+            ComPtr<ID3D11Texture3D> texture3D;
+            hr = pDevice->CreateTexture3D(&textureDesc, aInitialData.data(), texture3D.GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+            resource = texture3D;
+
+            srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE3D;
+            srvDesc.Texture3D.MipLevels = rangeDesc.uNumMips;
+            break;
+        }
+
+        default:
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        return pDevice->CreateShaderResourceView(resource.Get(), &srvDesc, ppOutTextureView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedDDSLoader::ReadDesc
+      Summary:  Returns the shape and format of a DDS file. Only the
+                page holding the headers is read from the disk
+      Args:     const std::filesystem::path& filePath
+                  Path to the DDS file
+                DDSTextureDesc& outDesc
+                  Shape and format of the texture
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MappedDDSLoader::ReadDesc(_In_ const std::filesystem::path& filePath, _Out_ DDSTextureDesc& outDesc)
+    {
+        outDesc = {};
+
+        MappedFile file(filePath);
+        HRESULT hr = file.Initialize();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        size_t uDataOffset = 0u;
+        if (!DDSLayout::ReadHeader(file.GetData(), file.GetSize(), outDesc, uDataOffset))
+        {
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+        }
+
+        return S_OK;
+    }
+}
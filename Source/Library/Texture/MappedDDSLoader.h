@@ -0,0 +1,50 @@
+/*+===================================================================
+  File:      MAPPEDDDSLOADER.H
+
+  Summary:   MappedDDSLoader header file contains declaration of class
+             MappedDDSLoader used to create textures from DDS files
+             without reading them into a heap buffer first.
+
+  Classes:  MappedDDSLoader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/DDSLayout.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MappedDDSLoader
+      Summary:  Maps the DDS file, parses its headers in place with
+                DDSLayout and points the initial data of the texture
+                straight into the mapping, so the only copy made is the
+                one of the driver. Any subset of the mip levels and
+                array slices can be loaded
+      Methods:  CreateTexture
+                  Creates an immutable texture and its view
+                ReadDesc
+                  Returns the shape and format of a DDS file
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MappedDDSLoader
+    {
+    public:
+        MappedDDSLoader() = delete;
+        MappedDDSLoader(const MappedDDSLoader& other) = delete;
+        MappedDDSLoader(MappedDDSLoader&& other) = delete;
+        MappedDDSLoader& operator=(const MappedDDSLoader& other) = delete;
+        MappedDDSLoader& operator=(MappedDDSLoader&& other) = delete;
+        ~MappedDDSLoader() = delete;
+
+        static HRESULT CreateTexture(
+            _In_ ID3D11Device* pDevice,
+            _In_ const std::filesystem::path& filePath,
+            _In_ const DDSRange& range,
+            _Outptr_ ID3D11ShaderResourceView** ppOutTextureView
+        );
+        static HRESULT ReadDesc(_In_ const std::filesystem::path& filePath, _Out_ DDSTextureDesc& outDesc);
+    };
+}
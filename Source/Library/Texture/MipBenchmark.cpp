@@ -0,0 +1,100 @@
+#include "Texture/MipBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
+
+#include "Utility/JobSystem.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipBenchmark::MakeImage
+      Summary:  Fills a 4096x4096 image with smooth gradients and a fine
+                checkerboard, so the filters have detail to remove
+      Args:     Image& outImage
+                  Synthetic image
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipBenchmark::MakeImage(Image& outImage)
+    {
+        outImage.uWidth = IMAGE_SIZE;
+        outImage.uHeight = IMAGE_SIZE;
+        outImage.aPixels.resize(static_cast<size_t>(IMAGE_SIZE) * IMAGE_SIZE * 4u);
+
+        for (uint32_t y = 0u; y < IMAGE_SIZE; ++y)
+        {
+            for (uint32_t x = 0u; x < IMAGE_SIZE; ++x)
+            {
+                uint8_t* pPixel = &outImage.aPixels[(static_cast<size_t>(y) * IMAGE_SIZE + x) * 4u];
+                bool bIsOdd = ((x >> 2u) ^ (y >> 2u)) & 1u;
+                pPixel[0] = static_cast<uint8_t>(x * 255u / (IMAGE_SIZE - 1u));
+                pPixel[1] = static_cast<uint8_t>(y * 255u / (IMAGE_SIZE - 1u));
+                pPixel[2] = bIsOdd ? 224u : 32u;
+                pPixel[3] = 255u;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipBenchmark::Run
+      Summary:  Builds the mip chain of the image NUM_REPETITIONS times
+                for every filter, colour mode and thread count and
+                keeps the best time of each
+      Args:     const Image& image
+                  Source image
+                std::vector<MipBenchmarkResult>& aOutResults
+                  Best time of every configuration
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipBenchmark::Run(const Image& image, std::vector<MipBenchmarkResult>& aOutResults)
+    {
+        static constexpr const char* FILTER_NAMES[] = { "box", "kaiser" };
+        static constexpr const char* MODE_NAMES[] = { "linear", "srgb", "normal" };
+
+        aOutResults.clear();
+
+        std::vector<Image> aMips;
+        for (uint32_t uFilter = 0u; uFilter < static_cast<uint32_t>(eMipFilter::COUNT); ++uFilter)
+        {
+            for (uint32_t uMode = 0u; uMode < std::size(MODE_NAMES); ++uMode)
+            {
+                for (uint32_t uNumThreads : { 1u, 0u })
+                {
+                    MipGenerator mipGenerator(static_cast<eMipFilter>(uFilter));
+                    mipGenerator.SetSrgb(uMode == 1u);
+                    mipGenerator.SetNormalMap(uMode == 2u);
+                    mipGenerator.SetNumThreads(uNumThreads);
+
+                    double bestSeconds = (std::numeric_limits<double>::max)();
+                    for (uint32_t i = 0u; i < NUM_REPETITIONS; ++i)
+                    {
+                        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                        mipGenerator.Generate(image, aMips);
+                        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                        bestSeconds = (std::min)(bestSeconds, elapsed.count());
+                    }
+
+                    aOutResults.push_back({
+                        .pszFilter = FILTER_NAMES[uFilter],
+                        .pszMode = MODE_NAMES[uMode],
+                        .uNumThreads = uNumThreads == 0u ? GetNumThreads() : uNumThreads,
+                        .milliseconds = bestSeconds * 1000.0,
+                        .megapixelsPerSecond = static_cast<double>(image.uWidth) * image.uHeight / (bestSeconds * 1.0e6),
+                    });
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipBenchmark::GetNumThreads
+      Summary:  Returns the number of threads filtering the rows when
+                the mip generator uses the whole job system
+      Returns:  uint32_t
+                  Workers of the default job system plus the caller
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t MipBenchmark::GetNumThreads()
+    {
+        return JobSystem::GetDefault().GetNumWorkers() + 1u;
+    }
+}
@@ -0,0 +1,66 @@
+/*+===================================================================
+  File:      MIPBENCHMARK.H
+
+  Summary:   MipBenchmark header file contains declaration of class
+             MipBenchmark used by the texture tool and the test
+             project to time the mip generator. It only depends on
+             the standard library.
+
+  Classes:  MipBenchmarkResult, MipBenchmark
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Texture/Image.h"
+#include "Texture/MipGenerator.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MipBenchmarkResult
+      Summary:  Best time of one filter, colour mode and thread count
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MipBenchmarkResult
+    {
+        const char* pszFilter;
+        const char* pszMode;
+        uint32_t uNumThreads;
+        double milliseconds;
+        double megapixelsPerSecond;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MipBenchmark
+      Summary:  Times the mip generator on one image with every filter,
+                colour mode and thread count. The throughput is counted
+                over the pixels of the source level
+      Methods:  MakeImage
+                  Fills the synthetic benchmark image
+                Run
+                  Times every configuration
+                GetNumThreads
+                  Returns the number of threads of a parallel run
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MipBenchmark
+    {
+    public:
+        static constexpr const uint32_t IMAGE_SIZE = 4096u;
+        static constexpr const uint32_t NUM_REPETITIONS = 3u;
+
+    public:
+        MipBenchmark() = delete;
+        MipBenchmark(const MipBenchmark& other) = delete;
+        MipBenchmark(MipBenchmark&& other) = delete;
+        MipBenchmark& operator=(const MipBenchmark& other) = delete;
+        MipBenchmark& operator=(MipBenchmark&& other) = delete;
+        ~MipBenchmark() = delete;
+
+        static void MakeImage(Image& outImage);
+        static void Run(const Image& image, std::vector<MipBenchmarkResult>& aOutResults);
+        static uint32_t GetNumThreads();
+    };
+}
@@ -0,0 +1,579 @@
+#include "Texture/MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cwctype>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define MIP_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "Utility/JobSystem.h"
+
+namespace library
+{
+    namespace
+    {
+        constexpr const uint32_t LINEAR_TO_SRGB_TABLE_SIZE = 4096u;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getSrgbToLinearTable
+          Summary:  Returns the linear value of every 8-bit sRGB value
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        const std::array<float, 256>& getSrgbToLinearTable()
+        {
+            static const std::array<float, 256> s_aTable = []()
+            {
+                std::array<float, 256> aTable = {};
+                for (uint32_t i = 0u; i < 256u; ++i)
+                {
+                    float value = static_cast<float>(i) / 255.0f;
+                    aTable[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+                return aTable;
+            }();
+
+            return s_aTable;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: getLinearToSrgbTable
+          Summary:  Returns the 8-bit sRGB value of linear values sampled
+                    at LINEAR_TO_SRGB_TABLE_SIZE points
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        const std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE>& getLinearToSrgbTable()
+        {
+            static const std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE> s_aTable = []()
+            {
+                std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE> aTable = {};
+                for (uint32_t i = 0u; i < LINEAR_TO_SRGB_TABLE_SIZE; ++i)
+                {
+                    float value = static_cast<float>(i) / static_cast<float>(LINEAR_TO_SRGB_TABLE_SIZE - 1u);
+                    float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                    aTable[i] = static_cast<uint8_t>(std::clamp(encoded * 255.0f + 0.5f, 0.0f, 255.0f));
+                }
+                return aTable;
+            }();
+
+            return s_aTable;
+        }
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: besselI0
+          Summary:  Zeroth order modified Bessel function of the first
+                    kind used by the Kaiser window
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        double besselI0(double x)
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            double halfX = x * 0.5;
+            for (uint32_t k = 1u; k < 32u; ++k)
+            {
+                term *= (halfX / static_cast<double>(k)) * (halfX / static_cast<double>(k));
+                sum += term;
+                if (term < sum * 1.0e-12)
+                {
+                    break;
+                }
+            }
+
+            return sum;
+        }
+
+        float sinc(float x)
+        {
+            static constexpr const float PI = 3.14159265358979f;
+
+            if (std::fabs(x) < 1.0e-5f)
+            {
+                return 1.0f;
+            }
+
+            return std::sin(PI * x) / (PI * x);
+        }
+
+        float uint8ToUnorm(uint8_t uValue)
+        {
+            return static_cast<float>(uValue) * (1.0f / 255.0f);
+        }
+
+        uint8_t unormToUint8(float value)
+        {
+            return static_cast<uint8_t>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::MipGenerator
+      Summary:  Constructor
+      Args:     eMipFilter filter
+                  Downsampling filter
+      Modifies: [m_filter, m_bIsSrgb, m_bIsNormalMap, m_uNumThreads,
+                 m_uMaxNumMips].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MipGenerator::MipGenerator(eMipFilter filter)
+        : m_filter(filter)
+        , m_bIsSrgb(true)
+        , m_bIsNormalMap(false)
+        , m_uNumThreads(0u)
+        , m_uMaxNumMips(0u)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::Generate
+      Summary:  Builds the mip chain of the image down to 1x1, or to
+                the maximum number of levels. The first level is a copy
+                of the image
+      Args:     const Image& image
+                  RGBA8 image
+                std::vector<Image>& aOutMips
+                  Every mip level, finest first
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::Generate(const Image& image, std::vector<Image>& aOutMips) const
+    {
+        aOutMips.clear();
+        if (image.uWidth == 0u || image.uHeight == 0u)
+        {
+            return;
+        }
+
+        uint32_t uNumMips = ComputeNumMips(image.uWidth, image.uHeight);
+        if (m_uMaxNumMips != 0u)
+        {
+            uNumMips = std::min(uNumMips, m_uMaxNumMips);
+        }
+
+        aOutMips.resize(uNumMips);
+        aOutMips[0] = image;
+        if (uNumMips == 1u)
+        {
+            return;
+        }
+
+        std::vector<float> aSource;
+        std::vector<float> aDestination;
+        std::vector<float> aScratch;
+        toLinear(image, aSource);
+
+        uint32_t uWidth = image.uWidth;
+        uint32_t uHeight = image.uHeight;
+        for (uint32_t uMip = 1u; uMip < uNumMips; ++uMip)
+        {
+            uint32_t uNextWidth = std::max(uWidth / 2u, 1u);
+            uint32_t uNextHeight = std::max(uHeight / 2u, 1u);
+
+            downsample(aSource, uWidth, uHeight, uNextWidth, uNextHeight, aScratch, aDestination);
+            fromLinear(aDestination, uNextWidth, uNextHeight, aOutMips[uMip]);
+
+            std::swap(aSource, aDestination);
+            uWidth = uNextWidth;
+            uHeight = uNextHeight;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::SetSrgb
+      Summary:  Sets whether the colour channels are sRGB encoded and
+                must be filtered in linear light. Alpha is always
+                linear
+      Args:     bool bIsSrgb
+                  Whether colour is sRGB encoded
+      Modifies: [m_bIsSrgb].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::SetSrgb(bool bIsSrgb)
+    {
+        m_bIsSrgb = bIsSrgb;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::SetNormalMap
+      Summary:  Sets whether the colour channels store unit vectors that
+                are renormalised after filtering. Overrides sRGB
+      Args:     bool bIsNormalMap
+                  Whether the image is a normal map
+      Modifies: [m_bIsNormalMap].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::SetNormalMap(bool bIsNormalMap)
+    {
+        m_bIsNormalMap = bIsNormalMap;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::SetNumThreads
+      Summary:  Sets the number of threads filtering the rows. The rows
+                run as jobs of the default job system
+      Args:     uint32_t uNumThreads
+                  Number of threads, 0 for every worker of the job
+                  system plus the calling thread
+      Modifies: [m_uNumThreads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::SetNumThreads(uint32_t uNumThreads)
+    {
+        m_uNumThreads = uNumThreads;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::SetMaxNumMips
+      Summary:  Limits the number of generated levels
+      Args:     uint32_t uMaxNumMips
+                  Maximum number of levels, 0 for the full chain
+      Modifies: [m_uMaxNumMips].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::SetMaxNumMips(uint32_t uMaxNumMips)
+    {
+        m_uMaxNumMips = uMaxNumMips;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::GetFilter
+      Summary:  Returns the downsampling filter
+      Returns:  eMipFilter
+                  Filter
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eMipFilter MipGenerator::GetFilter() const
+    {
+        return m_filter;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::ComputeNumMips
+      Summary:  Returns the number of levels down to 1x1
+      Args:     uint32_t uWidth
+                  Width of the finest level
+                uint32_t uHeight
+                  Height of the finest level
+      Returns:  uint32_t
+                  Number of levels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t MipGenerator::ComputeNumMips(uint32_t uWidth, uint32_t uHeight)
+    {
+        uint32_t uNumMips = 1u;
+        for (uint32_t uSize = std::max(uWidth, uHeight); uSize > 1u; uSize /= 2u)
+        {
+            ++uNumMips;
+        }
+
+        return uNumMips;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::IsNormalMapPath
+      Summary:  Returns whether the file name follows the normal map
+                naming of the content ("_ddn" or "normal")
+      Args:     const std::filesystem::path& filePath
+                  Path to the image
+      Returns:  bool
+                  true if the image is a normal map
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool MipGenerator::IsNormalMapPath(const std::filesystem::path& filePath)
+    {
+        std::wstring szStem = filePath.stem().wstring();
+        for (wchar_t& ch : szStem)
+        {
+            ch = static_cast<wchar_t>(std::towlower(ch));
+        }
+
+        return szStem.find(L"_ddn") != std::wstring::npos || szStem.find(L"normal") != std::wstring::npos;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::buildTaps
+      Summary:  Computes the source indices and weights of every
+                destination pixel along one axis. Indices outside the
+                image are clamped to the edge
+      Args:     uint32_t uSourceSize
+                  Number of source pixels
+                uint32_t uDestinationSize
+                  Number of destination pixels
+                FilterTaps& outTaps
+                  Taps, uNumTaps per destination pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::buildTaps(uint32_t uSourceSize, uint32_t uDestinationSize, FilterTaps& outTaps) const
+    {
+        float scale = static_cast<float>(uSourceSize) / static_cast<float>(uDestinationSize);
+        float radius = m_filter == eMipFilter::KAISER ? KAISER_RADIUS * scale : 0.5f * scale;
+        double kaiserNormalization = 1.0 / besselI0(KAISER_ALPHA);
+
+        outTaps.uNumTaps = static_cast<uint32_t>(std::ceil(2.0f * radius)) + 1u;
+        outTaps.aIndices.assign(static_cast<size_t>(uDestinationSize) * outTaps.uNumTaps, 0u);
+        outTaps.aWeights.assign(static_cast<size_t>(uDestinationSize) * outTaps.uNumTaps, 0.0f);
+
+        for (uint32_t i = 0u; i < uDestinationSize; ++i)
+        {
+            float center = (static_cast<float>(i) + 0.5f) * scale;
+            int first = static_cast<int>(std::floor(center - radius));
+
+            uint32_t* pIndices = &outTaps.aIndices[static_cast<size_t>(i) * outTaps.uNumTaps];
+            float* pWeights = &outTaps.aWeights[static_cast<size_t>(i) * outTaps.uNumTaps];
+
+            float totalWeight = 0.0f;
+            for (uint32_t k = 0u; k < outTaps.uNumTaps; ++k)
+            {
+                int source = first + static_cast<int>(k);
+                float weight = 0.0f;
+
+                if (m_filter == eMipFilter::KAISER)
+                {
+                    float distance = (static_cast<float>(source) + 0.5f - center) / scale;
+                    float x = distance / KAISER_RADIUS;
+                    if (std::fabs(x) < 1.0f)
+                    {
+                        double window = besselI0(KAISER_ALPHA * std::sqrt(1.0 - static_cast<double>(x) * x)) * kaiserNormalization;
+                        weight = sinc(distance) * static_cast<float>(window);
+                    }
+                }
+                else
+                {
+                    float overlapBegin = std::max(static_cast<float>(source), center - radius);
+                    float overlapEnd = std::min(static_cast<float>(source) + 1.0f, center + radius);
+                    weight = std::max(overlapEnd - overlapBegin, 0.0f);
+                }
+
+                pIndices[k] = static_cast<uint32_t>(std::clamp(source, 0, static_cast<int>(uSourceSize) - 1));
+                pWeights[k] = weight;
+                totalWeight += weight;
+            }
+
+            if (totalWeight > 0.0f)
+            {
+                for (uint32_t k = 0u; k < outTaps.uNumTaps; ++k)
+                {
+                    pWeights[k] /= totalWeight;
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::toLinear
+      Summary:  Converts RGBA8 pixels to float RGBA in the space the
+                filter works in: linear light for sRGB colour, [-1, 1]
+                vectors for normal maps
+      Args:     const Image& image
+                  RGBA8 image
+                std::vector<float>& aOutPixels
+                  Float RGBA pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::toLinear(const Image& image, std::vector<float>& aOutPixels) const
+    {
+        const std::array<float, 256>& aSrgbToLinear = getSrgbToLinearTable();
+
+        size_t uNumPixels = static_cast<size_t>(image.uWidth) * image.uHeight;
+        aOutPixels.resize(uNumPixels * 4u);
+
+        JobSystem::GetDefault().ParallelFor(image.uHeight, std::max(16384u / image.uWidth, 1u), [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (size_t i = static_cast<size_t>(uBegin) * image.uWidth; i < static_cast<size_t>(uEnd) * image.uWidth; ++i)
+            {
+                const uint8_t* pPixel = &image.aPixels[i * 4u];
+                float* pOut = &aOutPixels[i * 4u];
+
+                for (uint32_t c = 0u; c < 3u; ++c)
+                {
+                    if (m_bIsNormalMap)
+                    {
+                        pOut[c] = uint8ToUnorm(pPixel[c]) * 2.0f - 1.0f;
+                    }
+                    else if (m_bIsSrgb)
+                    {
+                        pOut[c] = aSrgbToLinear[pPixel[c]];
+                    }
+                    else
+                    {
+                        pOut[c] = uint8ToUnorm(pPixel[c]);
+                    }
+                }
+                pOut[3] = uint8ToUnorm(pPixel[3]);
+            }
+        }, m_uNumThreads);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::fromLinear
+      Summary:  Converts filtered float pixels back to RGBA8. Normal
+                vectors are renormalised in place first so that the
+                next level is filtered from unit vectors
+      Args:     std::vector<float>& aPixels
+                  Float RGBA pixels
+                uint32_t uWidth
+                  Width of the level
+                uint32_t uHeight
+                  Height of the level
+                Image& outImage
+                  RGBA8 level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::fromLinear(std::vector<float>& aPixels, uint32_t uWidth, uint32_t uHeight, Image& outImage) const
+    {
+        const std::array<uint8_t, LINEAR_TO_SRGB_TABLE_SIZE>& aLinearToSrgb = getLinearToSrgbTable();
+
+        size_t uNumPixels = static_cast<size_t>(uWidth) * uHeight;
+        outImage.uWidth = uWidth;
+        outImage.uHeight = uHeight;
+        outImage.aPixels.resize(uNumPixels * 4u);
+
+        JobSystem::GetDefault().ParallelFor(uHeight, std::max(16384u / uWidth, 1u), [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (size_t i = static_cast<size_t>(uBegin) * uWidth; i < static_cast<size_t>(uEnd) * uWidth; ++i)
+            {
+                float* pPixel = &aPixels[i * 4u];
+                uint8_t* pOut = &outImage.aPixels[i * 4u];
+
+                if (m_bIsNormalMap)
+                {
+                    float length = std::sqrt(pPixel[0] * pPixel[0] + pPixel[1] * pPixel[1] + pPixel[2] * pPixel[2]);
+                    if (length > 1.0e-6f)
+                    {
+                        pPixel[0] /= length;
+                        pPixel[1] /= length;
+                        pPixel[2] /= length;
+                    }
+                    else
+                    {
+                        pPixel[0] = 0.0f;
+                        pPixel[1] = 0.0f;
+                        pPixel[2] = 1.0f;
+                    }
+
+                    for (uint32_t c = 0u; c < 3u; ++c)
+                    {
+                        pOut[c] = unormToUint8(pPixel[c] * 0.5f + 0.5f);
+                    }
+                }
+                else if (m_bIsSrgb)
+                {
+                    for (uint32_t c = 0u; c < 3u; ++c)
+                    {
+                        float value = std::clamp(pPixel[c], 0.0f, 1.0f);
+                        pOut[c] = aLinearToSrgb[static_cast<size_t>(value * static_cast<float>(LINEAR_TO_SRGB_TABLE_SIZE - 1u) + 0.5f)];
+                    }
+                }
+                else
+                {
+                    for (uint32_t c = 0u; c < 3u; ++c)
+                    {
+                        pOut[c] = unormToUint8(pPixel[c]);
+                    }
+                }
+                pOut[3] = unormToUint8(pPixel[3]);
+            }
+        }, m_uNumThreads);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::downsample
+      Summary:  Filters a level to the next one, first along the rows
+                into the scratch buffer, then along the columns
+      Args:     const std::vector<float>& aSource
+                  Float RGBA pixels of the finer level
+                uint32_t uSourceWidth
+                  Width of the finer level
+                uint32_t uSourceHeight
+                  Height of the finer level
+                uint32_t uDestinationWidth
+                  Width of the coarser level
+                uint32_t uDestinationHeight
+                  Height of the coarser level
+                std::vector<float>& aScratch
+                  Buffer of the horizontally filtered rows
+                std::vector<float>& aOutDestination
+                  Float RGBA pixels of the coarser level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::downsample(
+        const std::vector<float>& aSource,
+        uint32_t uSourceWidth,
+        uint32_t uSourceHeight,
+        uint32_t uDestinationWidth,
+        uint32_t uDestinationHeight,
+        std::vector<float>& aScratch,
+        std::vector<float>& aOutDestination
+    ) const
+    {
+        FilterTaps horizontalTaps;
+        FilterTaps verticalTaps;
+        buildTaps(uSourceWidth, uDestinationWidth, horizontalTaps);
+        buildTaps(uSourceHeight, uDestinationHeight, verticalTaps);
+
+        aScratch.resize(static_cast<size_t>(uDestinationWidth) * uSourceHeight * 4u);
+        aOutDestination.resize(static_cast<size_t>(uDestinationWidth) * uDestinationHeight * 4u);
+
+        uint32_t uRowGrain = std::max(16384u / std::max(uDestinationWidth, 1u), 1u);
+
+        // Rows: every destination pixel gathers its taps from one source row
+        JobSystem::GetDefault().ParallelFor(uSourceHeight, uRowGrain, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t y = uBegin; y < uEnd; ++y)
+            {
+                const float* pSourceRow = &aSource[static_cast<size_t>(y) * uSourceWidth * 4u];
+                float* pScratchRow = &aScratch[static_cast<size_t>(y) * uDestinationWidth * 4u];
+
+                for (uint32_t x = 0u; x < uDestinationWidth; ++x)
+                {
+                    const uint32_t* pIndices = &horizontalTaps.aIndices[static_cast<size_t>(x) * horizontalTaps.uNumTaps];
+                    const float* pWeights = &horizontalTaps.aWeights[static_cast<size_t>(x) * horizontalTaps.uNumTaps];
+#if defined(MIP_GENERATOR_SSE2)
+                    __m128 sum = _mm_setzero_ps();
+                    for (uint32_t k = 0u; k < horizontalTaps.uNumTaps; ++k)
+                    {
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&pSourceRow[pIndices[k] * 4u]), _mm_set1_ps(pWeights[k])));
+                    }
+                    _mm_storeu_ps(&pScratchRow[x * 4u], sum);
+#else
+                    float aSum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                    for (uint32_t k = 0u; k < horizontalTaps.uNumTaps; ++k)
+                    {
+                        for (uint32_t c = 0u; c < 4u; ++c)
+                        {
+                            aSum[c] += pSourceRow[pIndices[k] * 4u + c] * pWeights[k];
+                        }
+                    }
+                    for (uint32_t c = 0u; c < 4u; ++c)
+                    {
+                        pScratchRow[x * 4u + c] = aSum[c];
+                    }
+#endif
+                }
+            }
+        }, m_uNumThreads);
+
+        // Columns: every destination row is a weighted sum of whole scratch rows
+        JobSystem::GetDefault().ParallelFor(uDestinationHeight, uRowGrain, [&](uint32_t uBegin, uint32_t uEnd)
+        {
+            for (uint32_t y = uBegin; y < uEnd; ++y)
+            {
+                const uint32_t* pIndices = &verticalTaps.aIndices[static_cast<size_t>(y) * verticalTaps.uNumTaps];
+                const float* pWeights = &verticalTaps.aWeights[static_cast<size_t>(y) * verticalTaps.uNumTaps];
+                float* pDestinationRow = &aOutDestination[static_cast<size_t>(y) * uDestinationWidth * 4u];
+
+                for (uint32_t x = 0u; x < uDestinationWidth; ++x)
+                {
+#if defined(MIP_GENERATOR_SSE2)
+                    __m128 sum = _mm_setzero_ps();
+                    for (uint32_t k = 0u; k < verticalTaps.uNumTaps; ++k)
+                    {
+                        const float* pScratch = &aScratch[(static_cast<size_t>(pIndices[k]) * uDestinationWidth + x) * 4u];
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pScratch), _mm_set1_ps(pWeights[k])));
+                    }
+                    _mm_storeu_ps(&pDestinationRow[x * 4u], sum);
+#else
+                    float aSum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                    for (uint32_t k = 0u; k < verticalTaps.uNumTaps; ++k)
+                    {
+                        const float* pScratch = &aScratch[(static_cast<size_t>(pIndices[k]) * uDestinationWidth + x) * 4u];
+                        for (uint32_t c = 0u; c < 4u; ++c)
+                        {
+                            aSum[c] += pScratch[c] * pWeights[k];
+                        }
+                    }
+                    for (uint32_t c = 0u; c < 4u; ++c)
+                    {
+                        pDestinationRow[x * 4u + c] = aSum[c];
+                    }
+#endif
+                }
+            }
+        }, m_uNumThreads);
+    }
+}
@@ -0,0 +1,120 @@
+/*+===================================================================
+  File:      MIPGENERATOR.H
+
+  Summary:   MipGenerator header file contains declaration of class
+             MipGenerator used to build mip chains of decoded images
+             on the CPU, both when textures are uploaded and when the
+             texture tool writes DDS files. It only depends on the
+             standard library.
+
+  Classes:  MipGenerator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Texture/Image.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eMipFilter
+      Summary:  Downsampling filters of the mip generator
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMipFilter : uint32_t
+    {
+        BOX,
+        KAISER,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MipGenerator
+      Summary:  Builds every mip level of an RGBA8 image with a
+                separable filter. Colour is filtered in linear light
+                when the image is sRGB encoded, and normal maps are
+                filtered as vectors and renormalised on every level.
+                Each level is filtered from the previous one in 32-bit
+                float, one whole RGBA pixel per SSE register, with the
+                rows split into jobs of the job system
+      Methods:  Generate
+                  Builds the mip chain of an image
+                SetSrgb
+                  Sets whether colour is sRGB encoded
+                SetNormalMap
+                  Sets whether the image stores unit vectors
+                SetNumThreads
+                  Sets the number of threads
+                SetMaxNumMips
+                  Limits the length of the chain
+                GetFilter
+                  Returns the filter
+                ComputeNumMips
+                  Returns the length of a full mip chain
+                IsNormalMapPath
+                  Returns whether a file name denotes a normal map
+                MipGenerator
+                  Constructor.
+                ~MipGenerator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MipGenerator
+    {
+    public:
+        static constexpr const float KAISER_ALPHA = 4.0f;
+        static constexpr const float KAISER_RADIUS = 1.5f;
+
+    public:
+        MipGenerator() = delete;
+        explicit MipGenerator(eMipFilter filter);
+        MipGenerator(const MipGenerator& other) = delete;
+        MipGenerator(MipGenerator&& other) = delete;
+        MipGenerator& operator=(const MipGenerator& other) = delete;
+        MipGenerator& operator=(MipGenerator&& other) = delete;
+        virtual ~MipGenerator() = default;
+
+        void Generate(const Image& image, std::vector<Image>& aOutMips) const;
+
+        void SetSrgb(bool bIsSrgb);
+        void SetNormalMap(bool bIsNormalMap);
+        void SetNumThreads(uint32_t uNumThreads);
+        void SetMaxNumMips(uint32_t uMaxNumMips);
+
+        eMipFilter GetFilter() const;
+
+        static uint32_t ComputeNumMips(uint32_t uWidth, uint32_t uHeight);
+        static bool IsNormalMapPath(const std::filesystem::path& filePath);
+
+    private:
+        struct FilterTaps
+        {
+            uint32_t uNumTaps;
+            std::vector<uint32_t> aIndices;
+            std::vector<float> aWeights;
+        };
+
+        void buildTaps(uint32_t uSourceSize, uint32_t uDestinationSize, FilterTaps& outTaps) const;
+        void toLinear(const Image& image, std::vector<float>& aOutPixels) const;
+        void fromLinear(std::vector<float>& aPixels, uint32_t uWidth, uint32_t uHeight, Image& outImage) const;
+        void downsample(
+            const std::vector<float>& aSource,
+            uint32_t uSourceWidth,
+            uint32_t uSourceHeight,
+            uint32_t uDestinationWidth,
+            uint32_t uDestinationHeight,
+            std::vector<float>& aScratch,
+            std::vector<float>& aOutDestination
+        ) const;
+
+    private:
+        eMipFilter m_filter;
+        bool m_bIsSrgb;
+        bool m_bIsNormalMap;
+        uint32_t m_uNumThreads;
+        uint32_t m_uMaxNumMips;
+    };
+}
@@ -0,0 +1,354 @@
+#include "Texture/StreamingTexture.h"
+
+#include <chrono>
+
+#include "Texture/MappedDDSLoader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::StreamingTexture
+      Summary:  Constructor
+      Args:     const std::filesystem::path& filePath
+                  Path to the DDS file
+                eTextureSamplerType textureSamplerType
+                  Texture sampler type of this texture
+                const std::shared_ptr<TextureResidencyManager>& pResidencyManager
+                  Residency manager deciding which levels to keep
+      Modifies: [m_pResidencyManager, m_pendingLoad, m_uResidencyHandle,
+                 m_uWidth, m_uHeight, m_uNumMips, m_uResidentMip,
+                 m_uPendingMip].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StreamingTexture::StreamingTexture(
+        _In_ const std::filesystem::path& filePath,
+        _In_ eTextureSamplerType textureSamplerType,
+        _In_ const std::shared_ptr<TextureResidencyManager>& pResidencyManager
+    )
+        : Texture(filePath, textureSamplerType)
+        , m_pResidencyManager(pResidencyManager)
+        , m_pendingLoad()
+        , m_uResidencyHandle(TextureResidencyManager::INVALID_HANDLE)
+        , m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uNumMips(0u)
+        , m_uResidentMip(0u)
+        , m_uPendingMip(0u)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::~StreamingTexture
+      Summary:  Destructor. Waits for the load in flight and leaves the
+                residency set
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StreamingTexture::~StreamingTexture()
+    {
+        if (m_pendingLoad.valid())
+        {
+            m_pendingLoad.wait();
+        }
+
+        if (m_uResidencyHandle != TextureResidencyManager::INVALID_HANDLE)
+        {
+            m_pResidencyManager->UnregisterTexture(m_uResidencyHandle);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::Initialize
+      Summary:  Loads the mip tail of the texture and registers it to
+                the residency manager. Textures that cannot be streamed
+                are loaded whole
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to create the texture
+      Modifies: [m_textureRV, m_uByteSize, m_uResidencyHandle, m_uWidth,
+                 m_uHeight, m_uNumMips, m_uResidentMip, m_uPendingMip].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StreamingTexture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (m_textureRV)
+        {
+            return S_OK;
+        }
+
+        DDSTextureDesc ddsDesc = {};
+        HRESULT hr = MappedDDSLoader::ReadDesc(m_filePath, ddsDesc);
+        if (FAILED(hr) || ddsDesc.uDimension != DDS_DIMENSION_TEXTURE2D || ddsDesc.bIsCubemap || ddsDesc.uNumMips <= 1u || !m_pResidencyManager)
+        {
+            return Texture::Initialize(pDevice, pImmediateContext);
+        }
+
+        m_uWidth = ddsDesc.uWidth;
+        m_uHeight = ddsDesc.uHeight;
+        m_uNumMips = ddsDesc.uNumMips;
+
+        // Same rule as the residency manager uses to find the tail
+        UINT uTailDimension = m_pResidencyManager->GetTailDimension();
+        UINT uTailMip = m_uNumMips - 1u;
+        for (UINT uMip = 0u; uMip < m_uNumMips; ++uMip)
+        {
+            if ((std::max)(m_uWidth >> uMip, 1u) <= uTailDimension && (std::max)(m_uHeight >> uMip, 1u) <= uTailDimension)
+            {
+                uTailMip = uMip;
+                break;
+            }
+        }
+
+        LoadResult result = loadMips(pDevice, m_filePath, uTailMip);
+        if (FAILED(result.hr))
+        {
+            OutputDebugString(L"Can't load texture from \"");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L"\n");
+            return result.hr;
+        }
+        m_textureRV = result.textureRV;
+
+        ComPtr<ID3D11Resource> resource;
+        m_textureRV->GetResource(resource.GetAddressOf());
+
+        ComPtr<ID3D11Texture2D> texture2D;
+        hr = resource.As(&texture2D);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        texture2D->GetDesc(&desc);
+
+        TextureResidencyDesc residencyDesc =
+        {
+            .uWidth = m_uWidth,
+            .uHeight = m_uHeight,
+            .aMipByteSizes = std::vector<uint64_t>(m_uNumMips)
+        };
+        for (UINT uMip = 0u; uMip < m_uNumMips; ++uMip)
+        {
+            residencyDesc.aMipByteSizes[uMip] = ComputeSurfaceByteSize(desc.Format, (std::max)(m_uWidth >> uMip, 1u), (std::max)(m_uHeight >> uMip, 1u)) * desc.ArraySize;
+        }
+
+        m_uResidencyHandle = m_pResidencyManager->RegisterTexture(residencyDesc);
+        m_uResidentMip = m_pResidencyManager->GetTailMip(m_uResidencyHandle);
+        m_uPendingMip = m_uResidentMip;
+        m_uByteSize = computeByteSize(m_textureRV.Get());
+
+        return createSamplers(pDevice);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::ReportProjectedSize
+      Summary:  Forwards the projected size of the texture on screen to
+                the residency manager
+      Args:     FLOAT projectedSize
+                  Projected size of the texture in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StreamingTexture::ReportProjectedSize(_In_ FLOAT projectedSize)
+    {
+        if (m_uResidencyHandle != TextureResidencyManager::INVALID_HANDLE)
+        {
+            m_pResidencyManager->ReportProjectedSize(m_uResidencyHandle, projectedSize);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::BeginLoad
+      Summary:  Starts creating a texture holding the levels from the
+                given one to the end of the chain on a worker thread.
+                The device is free threaded, so the resource is
+                created there as well
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                UINT uMostDetailedMip
+                  Finest level to load
+      Modifies: [m_pendingLoad, m_uPendingMip].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StreamingTexture::BeginLoad(_In_ ID3D11Device* pDevice, _In_ UINT uMostDetailedMip)
+    {
+        if (m_pendingLoad.valid())
+        {
+            return HRESULT_FROM_WIN32(ERROR_BUSY);
+        }
+
+        m_uPendingMip = uMostDetailedMip;
+        m_pendingLoad = std::async(
+            std::launch::async,
+            &StreamingTexture::loadMips,
+            ComPtr<ID3D11Device>(pDevice),
+            m_filePath,
+            uMostDetailedMip
+        );
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::EndLoad
+      Summary:  Swaps in the texture of a finished load without
+                blocking. Must be called at a frame boundary
+      Args:     BOOL& bOutCompleted
+                  Whether a load finished, successfully or not
+      Modifies: [m_textureRV, m_uByteSize, m_pendingLoad,
+                 m_uResidentMip, m_uPendingMip].
+      Returns:  HRESULT
+                  Status code of the finished load
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StreamingTexture::EndLoad(_Out_ BOOL& bOutCompleted)
+    {
+        bOutCompleted = FALSE;
+
+        if (!m_pendingLoad.valid() || m_pendingLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return S_OK;
+        }
+
+        LoadResult result = m_pendingLoad.get();
+        bOutCompleted = TRUE;
+
+        if (FAILED(result.hr))
+        {
+            m_uPendingMip = m_uResidentMip;
+            m_pResidencyManager->OnLoadFailed(m_uResidencyHandle);
+            return result.hr;
+        }
+
+        m_textureRV = result.textureRV;
+        m_uResidentMip = m_uPendingMip;
+        m_uByteSize = computeByteSize(m_textureRV.Get());
+        m_pResidencyManager->OnLoadCompleted(m_uResidencyHandle, m_uResidentMip);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::Evict
+      Summary:  Replaces the texture with one holding only the levels
+                from the given one onwards, copied on the GPU
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the levels
+                UINT uMostDetailedMip
+                  Finest level to keep
+      Modifies: [m_textureRV, m_uByteSize, m_uResidentMip,
+                 m_uPendingMip].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StreamingTexture::Evict(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uMostDetailedMip)
+    {
+        if (uMostDetailedMip <= m_uResidentMip || uMostDetailedMip >= m_uNumMips || m_pendingLoad.valid())
+        {
+            return S_OK;
+        }
+
+        ComPtr<ID3D11Resource> resource;
+        m_textureRV->GetResource(resource.GetAddressOf());
+
+        ComPtr<ID3D11Texture2D> source;
+        HRESULT hr = resource.As(&source);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_TEXTURE2D_DESC sourceDesc = {};
+        source->GetDesc(&sourceDesc);
+
+        D3D11_TEXTURE2D_DESC desc = sourceDesc;
+        desc.Width = (std::max)(m_uWidth >> uMostDetailedMip, 1u);
+        desc.Height = (std::max)(m_uHeight >> uMostDetailedMip, 1u);
+        desc.MipLevels = m_uNumMips - uMostDetailedMip;
+
+        ComPtr<ID3D11Texture2D> destination;
+        hr = pDevice->CreateTexture2D(&desc, nullptr, destination.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        UINT uSkippedMips = uMostDetailedMip - m_uResidentMip;
+        for (UINT uSlice = 0u; uSlice < desc.ArraySize; ++uSlice)
+        {
+            for (UINT uMip = 0u; uMip < desc.MipLevels; ++uMip)
+            {
+                pImmediateContext->CopySubresourceRegion(
+                    destination.Get(),
+                    D3D11CalcSubresource(uMip, uSlice, desc.MipLevels),
+                    0u, 0u, 0u,
+                    source.Get(),
+                    D3D11CalcSubresource(uMip + uSkippedMips, uSlice, sourceDesc.MipLevels),
+                    nullptr
+                );
+            }
+        }
+
+        ComPtr<ID3D11ShaderResourceView> textureRV;
+        hr = pDevice->CreateShaderResourceView(destination.Get(), nullptr, textureRV.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_textureRV = textureRV;
+        m_uResidentMip = uMostDetailedMip;
+        m_uPendingMip = uMostDetailedMip;
+        m_uByteSize = computeByteSize(m_textureRV.Get());
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::GetResidencyHandle
+      Summary:  Returns the handle in the residency manager
+      Returns:  UINT
+                  Handle, INVALID_HANDLE if the texture is not streamed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StreamingTexture::GetResidencyHandle() const
+    {
+        return m_uResidencyHandle;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StreamingTexture::loadMips
+      Summary:  Creates a texture from the levels of a DDS file from
+                the given one onwards, read straight from a mapping of
+                the file. Runs on worker threads
+      Args:     ComPtr<ID3D11Device> device
+                  The Direct3D device to create the texture
+                std::filesystem::path filePath
+                  Path to the DDS file
+                UINT uMostDetailedMip
+                  Finest level to keep
+      Returns:  LoadResult
+                  Status code and the shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StreamingTexture::LoadResult StreamingTexture::loadMips(
+        _In_ ComPtr<ID3D11Device> device,
+        _In_ std::filesystem::path filePath,
+        _In_ UINT uMostDetailedMip
+    )
+    {
+        LoadResult result =
+        {
+            .hr = S_OK,
+            .textureRV = nullptr
+        };
+
+        DDSRange range =
+        {
+            .uFirstMip = uMostDetailedMip,
+            .uNumMips = 0u,
+            .uFirstSlice = 0u,
+            .uNumSlices = 0u
+        };
+        result.hr = MappedDDSLoader::CreateTexture(device.Get(), filePath, range, result.textureRV.GetAddressOf());
+
+        return result;
+    }
+}
@@ -0,0 +1,94 @@
+/*+===================================================================
+  File:      STREAMINGTEXTURE.H
+
+  Summary:   StreamingTexture header file contains declaration of
+             class StreamingTexture used to keep only the mip levels
+             a texture needs on screen in video memory.
+
+  Classes:  StreamingTexture
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <future>
+
+#include "Texture/Texture.h"
+#include "Texture/TextureResidencyManager.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StreamingTexture
+      Summary:  Texture loaded from a mipmapped DDS file with only its
+                mip tail resident at first. Finer levels are loaded on
+                a worker thread when the residency manager asks for
+                them and swapped in at the next frame boundary.
+                Cubemaps and files without mips are loaded whole
+      Methods:  Initialize
+                  Loads the mip tail and registers the texture
+                ReportProjectedSize
+                  Forwards the on-screen size to the residency manager
+                BeginLoad
+                  Starts loading the levels from the given one onwards
+                EndLoad
+                  Swaps in a finished load
+                Evict
+                  Drops the levels finer than the given one
+                GetResidencyHandle
+                  Returns the handle in the residency manager
+                StreamingTexture
+                  Constructor.
+                ~StreamingTexture
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StreamingTexture : public Texture
+    {
+    public:
+        StreamingTexture() = delete;
+        StreamingTexture(
+            _In_ const std::filesystem::path& filePath,
+            _In_ eTextureSamplerType textureSamplerType,
+            _In_ const std::shared_ptr<TextureResidencyManager>& pResidencyManager
+        );
+        StreamingTexture(const StreamingTexture& other) = delete;
+        StreamingTexture(StreamingTexture&& other) = delete;
+        StreamingTexture& operator=(const StreamingTexture& other) = delete;
+        StreamingTexture& operator=(StreamingTexture&& other) = delete;
+        virtual ~StreamingTexture();
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override;
+        virtual void ReportProjectedSize(_In_ FLOAT projectedSize) override;
+
+        HRESULT BeginLoad(_In_ ID3D11Device* pDevice, _In_ UINT uMostDetailedMip);
+        HRESULT EndLoad(_Out_ BOOL& bOutCompleted);
+        HRESULT Evict(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uMostDetailedMip);
+
+        UINT GetResidencyHandle() const;
+
+    private:
+        struct LoadResult
+        {
+            HRESULT hr;
+            ComPtr<ID3D11ShaderResourceView> textureRV;
+        };
+
+        static LoadResult loadMips(
+            _In_ ComPtr<ID3D11Device> device,
+            _In_ std::filesystem::path filePath,
+            _In_ UINT uMostDetailedMip
+        );
+
+    private:
+        std::shared_ptr<TextureResidencyManager> m_pResidencyManager;
+        std::future<LoadResult> m_pendingLoad;
+        UINT m_uResidencyHandle;
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uNumMips;
+        UINT m_uResidentMip;
+        UINT m_uPendingMip;
+    };
+}
@@ -1,7 +1,12 @@
 #include "Texture.h"
 
+#include <cwctype>
+
 #include "Texture/DDSTextureLoader.h"
+#include "Texture/MappedDDSLoader.h"
+#include "Texture/MipGenerator.h"
 #include "Texture/WICTextureLoader.h"
+#include "Texture/WicImageLoader.h"
 
 namespace library
 {
@@ -14,12 +19,14 @@ namespace library
                   Path to the texture to use
                 eTextureSamplerType textureSamplerType
                   Texture sampler type of this texture
-      Modifies: [m_filePath, m_textureRV, m_textureSamplerType].
+      Modifies: [m_filePath, m_textureRV, m_textureSamplerType,
+                 m_uByteSize].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Texture::Texture(_In_ const std::filesystem::path& filePath, _In_opt_ eTextureSamplerType textureSamplerType)
         : m_filePath(filePath)
         , m_textureRV(nullptr)
         , m_textureSamplerType(textureSamplerType)
+        , m_uByteSize(0ull)
     { }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -29,17 +36,33 @@ namespace library
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
-      Modifies: [m_textureRV].
+      Modifies: [m_textureRV, m_uByteSize].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
-        HRESULT hr = CreateWICTextureFromFile(
-            pDevice,
-            pImmediateContext,
-            m_filePath.c_str(),
-            nullptr,
-            m_textureRV.GetAddressOf()
-        );
+        // Textures shared through the cache may be initialized by several owners
+        if (m_textureRV)
+        {
+            return S_OK;
+        }
+
+        // Build the mips on the CPU so their quality does not depend on the driver
+        HRESULT hr = createFromImage(pDevice);
+        if (FAILED(hr))
+        {
+            // DDS files are uploaded straight from a mapping of the file
+            hr = MappedDDSLoader::CreateTexture(pDevice, m_filePath, DDSRange{}, m_textureRV.GetAddressOf());
+        }
+        if (FAILED(hr))
+        {
+            hr = CreateWICTextureFromFile(
+                pDevice,
+                pImmediateContext,
+                m_filePath.c_str(),
+                nullptr,
+                m_textureRV.GetAddressOf()
+            );
+        }
         if (FAILED(hr))
         {
             hr = CreateDDSTextureFromFile(pDevice, m_filePath.c_str(), nullptr, m_textureRV.GetAddressOf());
@@ -52,7 +75,256 @@ namespace library
             }
         }
 
+        m_uByteSize = computeByteSize(m_textureRV.Get());
+
         // Create the sample state
+        return createSamplers(pDevice);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetTextureResourceView
+      Summary:  Returns the TRV
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& Texture::GetTextureResourceView()
+    {
+        return m_textureRV;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetSamplerType
+      Summary:  Returns the sampler type
+      Returns:  eTextureSamplerType
+                  Sampler type
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eTextureSamplerType Texture::GetSamplerType() const
+    {
+        return m_textureSamplerType;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetFilePath
+      Summary:  Returns the path of the texture file
+      Returns:  const std::filesystem::path&
+                  Path to the texture file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Texture::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetByteSize
+      Summary:  Returns the video memory used by the texture including
+                every mip level and array slice
+      Returns:  UINT64
+                  Size of the texture in bytes, 0 if not initialized
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Texture::GetByteSize() const
+    {
+        return m_uByteSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::ReportProjectedSize
+      Summary:  Receives the projected size of the texture on screen.
+                Fully resident textures ignore it
+      Args:     FLOAT projectedSize
+                  Projected size of the texture in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::ReportProjectedSize(_In_ FLOAT projectedSize)
+    {
+        UNREFERENCED_PARAMETER(projectedSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::ReplaceWith
+      Summary:  Swaps the view with the one of a copy loaded from the
+                changed file. Materials keep pointing at this texture,
+                and the old view is released with the copy
+      Args:     Texture& other
+                  Texture loaded from the same file
+      Modifies: [m_textureRV, m_uByteSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::ReplaceWith(_Inout_ Texture& other)
+    {
+        m_textureRV.Swap(other.m_textureRV);
+        std::swap(m_uByteSize, other.m_uByteSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::ComputeSurfaceByteSize
+      Summary:  Returns the size of one 2D surface of the given format
+      Args:     DXGI_FORMAT format
+                  Format of the surface
+                UINT uWidth
+                  Width of the surface
+                UINT uHeight
+                  Height of the surface
+      Returns:  UINT64
+                  Size of the surface in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Texture::ComputeSurfaceByteSize(_In_ DXGI_FORMAT format, _In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        UINT64 uBlockBytes = 0ull;
+        UINT64 uBitsPerPixel = 32ull;
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            uBlockBytes = 8ull;
+            break;
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            uBlockBytes = 16ull;
+            break;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            uBitsPerPixel = 128ull;
+            break;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+            uBitsPerPixel = 64ull;
+            break;
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_B5G6R5_UNORM:
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            uBitsPerPixel = 16ull;
+            break;
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_A8_UNORM:
+            uBitsPerPixel = 8ull;
+            break;
+        default:
+            break;
+        }
+
+        if (uBlockBytes > 0ull)
+        {
+            return ((static_cast<UINT64>(uWidth) + 3ull) / 4ull) * ((static_cast<UINT64>(uHeight) + 3ull) / 4ull) * uBlockBytes;
+        }
+
+        return (static_cast<UINT64>(uWidth) * static_cast<UINT64>(uHeight) * uBitsPerPixel) / 8ull;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::createFromImage
+      Summary:  Decodes the image on the CPU, generates its full mip
+                chain with a box filter in linear light (normal maps
+                are renormalised instead) and creates an immutable
+                texture from all levels. DDS files are left to the DDS
+                loader so that their own mips and format are kept
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+      Modifies: [m_textureRV].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::createFromImage(_In_ ID3D11Device* pDevice)
+    {
+        std::wstring szExtension = m_filePath.extension().wstring();
+        for (WCHAR& ch : szExtension)
+        {
+            ch = static_cast<WCHAR>(std::towlower(ch));
+        }
+
+        if (szExtension == L".dds")
+        {
+            return E_NOTIMPL;
+        }
+
+        WicImageLoader loader;
+        HRESULT hr = loader.Initialize();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        Image image;
+        hr = loader.Load(m_filePath, image);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        if (image.uWidth > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION || image.uHeight > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION)
+        {
+            return E_INVALIDARG;
+        }
+
+        MipGenerator mipGenerator(eMipFilter::BOX);
+        mipGenerator.SetNormalMap(MipGenerator::IsNormalMapPath(m_filePath));
+
+        std::vector<Image> aMips;
+        mipGenerator.Generate(image, aMips);
+
+        std::vector<D3D11_SUBRESOURCE_DATA> aSubresourceData(aMips.size());
+        for (size_t i = 0u; i < aMips.size(); ++i)
+        {
+            aSubresourceData[i] =
+            {
+                .pSysMem = aMips[i].aPixels.data(),
+                .SysMemPitch = aMips[i].uWidth * 4u,
+                .SysMemSlicePitch = 0u
+            };
+        }
+
+        D3D11_TEXTURE2D_DESC textureDesc =
+        {
+            .Width = image.uWidth,
+            .Height = image.uHeight,
+            .MipLevels = static_cast<UINT>(aMips.size()),
+            .ArraySize = 1u,
+            .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+            .SampleDesc = {.Count = 1u, .Quality = 0u },
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u
+        };
+
+        ComPtr<ID3D11Texture2D> texture;
+        hr = pDevice->CreateTexture2D(&textureDesc, aSubresourceData.data(), texture.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return pDevice->CreateShaderResourceView(texture.Get(), nullptr, m_textureRV.ReleaseAndGetAddressOf());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::createSamplers
+      Summary:  Creates the shared sampler states if not created yet
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the samplers
+      Modifies: [s_samplers].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::createSamplers(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
         if (!s_samplers[static_cast<size_t>(eTextureSamplerType::TRILINEAR_WRAP)].Get())
         {
             D3D11_SAMPLER_DESC sampDesc =
@@ -95,24 +367,34 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Texture::GetTextureResourceView
-      Summary:  Returns the TRV
-      Returns:  ComPtr<ID3D11ShaderResourceView>&
-                  Shader resource view
+      Method:   Texture::computeByteSize
+      Summary:  Sums the size of every subresource of the 2D texture
+                behind the given shader resource view
+      Args:     ID3D11ShaderResourceView* pTextureRV
+                  Shader resource view of the texture
+      Returns:  UINT64
+                  Size of the texture in bytes
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11ShaderResourceView>& Texture::GetTextureResourceView()
+    UINT64 Texture::computeByteSize(_In_ ID3D11ShaderResourceView* pTextureRV)
     {
-        return m_textureRV;
-    }
+        ComPtr<ID3D11Resource> resource;
+        pTextureRV->GetResource(resource.GetAddressOf());
 
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Texture::GetSamplerType
-      Summary:  Returns the sampler type
-      Returns:  eTextureSamplerType
-                  Sampler type
-    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    eTextureSamplerType Texture::GetSamplerType() const
-    {
-        return m_textureSamplerType;
+        ComPtr<ID3D11Texture2D> texture2D;
+        if (FAILED(resource.As(&texture2D)))
+        {
+            return 0ull;
+        }
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        texture2D->GetDesc(&desc);
+
+        UINT64 uByteSize = 0ull;
+        for (UINT uMip = 0u; uMip < desc.MipLevels; ++uMip)
+        {
+            uByteSize += ComputeSurfaceByteSize(desc.Format, (std::max)(desc.Width >> uMip, 1u), (std::max)(desc.Height >> uMip, 1u));
+        }
+
+        return uByteSize * desc.ArraySize;
     }
 }
\ No newline at end of file
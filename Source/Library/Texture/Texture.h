@@ -37,13 +37,29 @@ namespace library
 
         ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
         eTextureSamplerType GetSamplerType() const;
+        const std::filesystem::path& GetFilePath() const;
+        UINT64 GetByteSize() const;
+
+        // Feedback from the renderer, only used by streamed textures
+        virtual void ReportProjectedSize(_In_ FLOAT projectedSize);
+
+        // Takes over the view of a reloaded copy of the texture, between two frames
+        void ReplaceWith(_Inout_ Texture& other);
+
+        static UINT64 ComputeSurfaceByteSize(_In_ DXGI_FORMAT format, _In_ UINT uWidth, _In_ UINT uHeight);
 
     public:
         static ComPtr<ID3D11SamplerState> s_samplers[static_cast<size_t>(eTextureSamplerType::COUNT)];
 
-    private:
+    protected:
+        HRESULT createFromImage(_In_ ID3D11Device* pDevice);
+        static HRESULT createSamplers(_In_ ID3D11Device* pDevice);
+        static UINT64 computeByteSize(_In_ ID3D11ShaderResourceView* pTextureRV);
+
+    protected:
         std::filesystem::path m_filePath;
         ComPtr<ID3D11ShaderResourceView> m_textureRV;
         eTextureSamplerType m_textureSamplerType;
+        UINT64 m_uByteSize;
     };
 }
\ No newline at end of file
@@ -0,0 +1,370 @@
+#include "Texture/TextureCache.h"
+
+#include <cwctype>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::TextureCache
+      Summary:  Constructor
+      Modifies: [m_mutex, m_textures, m_pResidencyManager,
+                 m_streamingTextures, m_aLoadCommands,
+                 m_aEvictionCommands, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCache::TextureCache()
+        : m_mutex()
+        , m_textures()
+        , m_pResidencyManager()
+        , m_streamingTextures()
+        , m_aLoadCommands()
+        , m_aEvictionCommands()
+        , m_stats()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetOrLoad
+      Summary:  Returns the texture of the given file and sampler type,
+                loading and initializing it if it is not cached yet.
+                The first caller
+                of a key loads it without holding the lock, later
+                callers wait for that load and share its result; a
+                failed load is forgotten so the next call retries
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to create the texture
+                const std::filesystem::path& filePath
+                  Path to the texture file
+                eTextureSamplerType textureSamplerType
+                  Sampler type of the texture
+                std::shared_ptr<Texture>& outTexture
+                  Shared handle to the cached texture
+      Modifies: [m_textures, m_stats].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureCache::GetOrLoad(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::filesystem::path& filePath,
+        _In_ eTextureSamplerType textureSamplerType,
+        _Out_ std::shared_ptr<Texture>& outTexture
+    )
+    {
+        outTexture = nullptr;
+
+        std::wstring szKey = makeKey(filePath, textureSamplerType);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto it = m_textures.find(szKey);
+        if (it != m_textures.end())
+        {
+            std::shared_ptr<Texture> texture = it->second.texture;
+            std::shared_future<HRESULT> loaded = it->second.loaded;
+            ++m_stats.uNumHits;
+            lock.unlock();
+
+            HRESULT hr = loaded.get();
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            lock.lock();
+            m_stats.uSavedBytes += texture->GetByteSize();
+
+            outTexture = texture;
+            return S_OK;
+        }
+
+        ++m_stats.uNumMisses;
+
+        std::shared_ptr<Texture> texture;
+        std::shared_ptr<StreamingTexture> streamingTexture;
+        if (m_pResidencyManager && isStreamable(filePath))
+        {
+            streamingTexture = std::make_shared<StreamingTexture>(filePath, textureSamplerType, m_pResidencyManager);
+            texture = streamingTexture;
+        }
+        else
+        {
+            texture = std::make_shared<Texture>(filePath, textureSamplerType);
+        }
+
+        std::promise<HRESULT> loadPromise;
+        m_textures.emplace(szKey, Entry{ .texture = texture, .loaded = loadPromise.get_future().share(), .uByteSize = 0ull });
+        lock.unlock();
+
+        HRESULT hr = texture->Initialize(pDevice, pImmediateContext);
+
+        lock.lock();
+
+        // Clear may have dropped the entry meanwhile, it is then only handed to the callers
+        it = m_textures.find(szKey);
+        BOOL bIsCached = it != m_textures.end() && it->second.texture == texture;
+        if (FAILED(hr))
+        {
+            if (bIsCached)
+            {
+                m_textures.erase(it);
+            }
+        }
+        else
+        {
+            if (streamingTexture && streamingTexture->GetResidencyHandle() != TextureResidencyManager::INVALID_HANDLE)
+            {
+                m_streamingTextures[streamingTexture->GetResidencyHandle()] = streamingTexture;
+            }
+
+            if (bIsCached)
+            {
+                it->second.uByteSize = texture->GetByteSize();
+                m_stats.uResidentBytes += it->second.uByteSize;
+            }
+        }
+        m_stats.uNumResidentTextures = m_textures.size();
+
+        lock.unlock();
+        loadPromise.set_value(hr);
+
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        outTexture = texture;
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::EvictUnused
+      Summary:  Releases every texture that is referenced only by the
+                cache itself. Textures still being loaded are kept.
+                The resident bytes drop by the size counted at load,
+                since streamed textures change size afterwards
+      Modifies: [m_textures, m_stats].
+      Returns:  UINT
+                  Number of textures evicted
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureCache::EvictUnused()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        UINT uNumEvicted = 0u;
+        for (auto it = m_textures.begin(); it != m_textures.end();)
+        {
+            BOOL bIsLoaded = it->second.loaded.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            if (bIsLoaded && it->second.texture.use_count() == 1l)
+            {
+                m_stats.uResidentBytes -= it->second.uByteSize;
+                it = m_textures.erase(it);
+                ++uNumEvicted;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        m_stats.uNumEvictions += uNumEvicted;
+        m_stats.uNumResidentTextures = m_textures.size();
+
+        return uNumEvicted;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::Clear
+      Summary:  Drops the references of the cache to every texture.
+                Textures still held by materials stay alive until the
+                materials release them, loads in flight finish for
+                the callers waiting on them
+      Modifies: [m_textures, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stats.uNumEvictions += m_textures.size();
+        m_stats.uNumResidentTextures = 0ull;
+        m_stats.uResidentBytes = 0ull;
+
+        m_textures.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::EnableStreaming
+      Summary:  Creates the residency manager. Mipmapped DDS textures
+                loaded afterwards start with only their mip tail
+                resident and stream finer levels under the budget
+      Args:     UINT64 uBudgetBytes
+                  Memory budget of the streamed textures in bytes
+      Modifies: [m_pResidencyManager].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::EnableStreaming(_In_ UINT64 uBudgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_pResidencyManager)
+        {
+            m_pResidencyManager->SetBudget(uBudgetBytes);
+            return;
+        }
+
+        m_pResidencyManager = std::make_shared<TextureResidencyManager>(uBudgetBytes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::UpdateStreaming
+      Summary:  Swaps in finished loads, then lets the residency manager
+                turn the projected sizes reported during the last frame
+                into evictions and new loads. Call once per frame
+                before rendering
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the textures
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the kept levels
+      Modifies: [m_streamingTextures, m_aLoadCommands,
+                 m_aEvictionCommands].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureCache::UpdateStreaming(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_pResidencyManager)
+        {
+            return S_OK;
+        }
+
+        for (auto it = m_streamingTextures.begin(); it != m_streamingTextures.end();)
+        {
+            std::shared_ptr<StreamingTexture> texture = it->second.lock();
+            if (!texture)
+            {
+                it = m_streamingTextures.erase(it);
+                continue;
+            }
+
+            BOOL bCompleted = FALSE;
+            if (FAILED(texture->EndLoad(bCompleted)))
+            {
+                OutputDebugString(L"Can't stream texture \"");
+                OutputDebugString(texture->GetFilePath().c_str());
+                OutputDebugString(L"\"\n");
+            }
+            ++it;
+        }
+
+        m_pResidencyManager->Update(m_aLoadCommands, m_aEvictionCommands);
+
+        HRESULT hr = S_OK;
+        for (const TextureResidencyCommand& command : m_aEvictionCommands)
+        {
+            auto it = m_streamingTextures.find(command.uHandle);
+            if (it == m_streamingTextures.end())
+            {
+                continue;
+            }
+
+            if (std::shared_ptr<StreamingTexture> texture = it->second.lock())
+            {
+                hr = texture->Evict(pDevice, pImmediateContext, command.uMostDetailedMip);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+        }
+
+        for (const TextureResidencyCommand& command : m_aLoadCommands)
+        {
+            auto it = m_streamingTextures.find(command.uHandle);
+            std::shared_ptr<StreamingTexture> texture = it != m_streamingTextures.end() ? it->second.lock() : nullptr;
+            if (!texture || FAILED(texture->BeginLoad(pDevice, command.uMostDetailedMip)))
+            {
+                m_pResidencyManager->OnLoadFailed(command.uHandle);
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetResidencyManager
+      Summary:  Returns the residency manager of streamed textures
+      Returns:  const std::shared_ptr<TextureResidencyManager>&
+                  Residency manager, null if streaming is disabled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<TextureResidencyManager>& TextureCache::GetResidencyManager() const
+    {
+        return m_pResidencyManager;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetStats
+      Summary:  Returns the counters of the cache
+      Returns:  TextureCacheStats
+                  Copy of the counters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCacheStats TextureCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::makeKey
+      Summary:  Builds the cache key from the canonical, case folded
+                path and the sampler type, so that "a/../B.png" and
+                "b.png" map to the same entry
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture file
+                eTextureSamplerType textureSamplerType
+                  Sampler type of the texture
+      Returns:  std::wstring
+                  Cache key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::wstring TextureCache::makeKey(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType)
+    {
+        std::error_code errorCode;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, errorCode);
+        if (errorCode)
+        {
+            canonicalPath = filePath.lexically_normal();
+        }
+
+        std::wstring szKey = canonicalPath.make_preferred().wstring();
+        for (WCHAR& ch : szKey)
+        {
+            ch = static_cast<WCHAR>(std::towlower(ch));
+        }
+
+        szKey += L'|';
+        szKey += std::to_wstring(static_cast<size_t>(textureSamplerType));
+
+        return szKey;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::isStreamable
+      Summary:  Returns whether the file may be streamed. Only DDS files
+                carry their own mip chain
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture file
+      Returns:  BOOL
+                  TRUE if the file is a DDS file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TextureCache::isStreamable(_In_ const std::filesystem::path& filePath)
+    {
+        std::wstring szExtension = filePath.extension().wstring();
+        for (WCHAR& ch : szExtension)
+        {
+            ch = static_cast<WCHAR>(std::towlower(ch));
+        }
+
+        return szExtension == L".dds";
+    }
+}
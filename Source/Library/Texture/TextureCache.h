@@ -0,0 +1,121 @@
+/*+===================================================================
+  File:      TEXTURECACHE.H
+
+  Summary:   TextureCache header file contains declaration of class
+             TextureCache used to share texture data between
+             materials and models.
+
+  Classes:  TextureCache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <future>
+#include <mutex>
+
+#include "Texture/StreamingTexture.h"
+#include "Texture/Texture.h"
+#include "Texture/TextureResidencyManager.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureCacheStats
+      Summary:  Counters exposed by the texture cache
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureCacheStats
+    {
+        UINT64 uNumHits;
+        UINT64 uNumMisses;
+        UINT64 uNumEvictions;
+        UINT64 uNumResidentTextures;
+        UINT64 uResidentBytes;
+        UINT64 uSavedBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureCache
+      Summary:  TextureCache hands out shared texture handles keyed by
+                the canonical path of the file and the sampler type,
+                so that a file referenced by several materials is
+                loaded to the video memory only once. Loads run
+                outside the lock: a key being loaded has an in-flight
+                entry, and other threads asking for it wait on that
+                entry instead of loading the file again
+      Methods:  GetOrLoad
+                  Returns the cached texture or loads it on a miss
+                EvictUnused
+                  Releases textures nobody but the cache refers to
+                Clear
+                  Releases every texture held by the cache
+                EnableStreaming
+                  Streams mips of DDS textures loaded afterwards
+                UpdateStreaming
+                  Executes the residency decisions of the frame
+                GetResidencyManager
+                  Returns the residency manager of streamed textures
+                GetStats
+                  Returns the hit, miss and memory counters
+                TextureCache
+                  Constructor.
+                ~TextureCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureCache
+    {
+    public:
+        TextureCache();
+        TextureCache(const TextureCache& other) = delete;
+        TextureCache(TextureCache&& other) = delete;
+        TextureCache& operator=(const TextureCache& other) = delete;
+        TextureCache& operator=(TextureCache&& other) = delete;
+        virtual ~TextureCache() = default;
+
+        HRESULT GetOrLoad(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::filesystem::path& filePath,
+            _In_ eTextureSamplerType textureSamplerType,
+            _Out_ std::shared_ptr<Texture>& outTexture
+        );
+        UINT EvictUnused();
+        void Clear();
+
+        void EnableStreaming(_In_ UINT64 uBudgetBytes);
+        HRESULT UpdateStreaming(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        const std::shared_ptr<TextureResidencyManager>& GetResidencyManager() const;
+
+        TextureCacheStats GetStats() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Entry
+          Summary:  Cached texture and the result of its load, ready
+                    once the thread that created the entry initialized
+                    the texture, with the bytes it added to the
+                    resident bytes
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Entry
+        {
+            std::shared_ptr<Texture> texture;
+            std::shared_future<HRESULT> loaded;
+            UINT64 uByteSize;
+        };
+
+    private:
+        static std::wstring makeKey(_In_ const std::filesystem::path& filePath, _In_ eTextureSamplerType textureSamplerType);
+        static BOOL isStreamable(_In_ const std::filesystem::path& filePath);
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::wstring, Entry> m_textures;
+        std::shared_ptr<TextureResidencyManager> m_pResidencyManager;
+        std::unordered_map<UINT, std::weak_ptr<StreamingTexture>> m_streamingTextures;
+        std::vector<TextureResidencyCommand> m_aLoadCommands;
+        std::vector<TextureResidencyCommand> m_aEvictionCommands;
+        TextureCacheStats m_stats;
+    };
+}
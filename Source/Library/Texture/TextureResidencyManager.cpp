@@ -0,0 +1,630 @@
+#include "Texture/TextureResidencyManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const uint32_t NO_REQUEST = 0xFFFFFFFFu;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::TextureResidencyManager
+      Summary:  Constructor
+      Args:     uint64_t uBudgetBytes
+                  Memory budget of the streamed textures in bytes
+      Modifies: [m_aEntries, m_aFreeHandles, m_aEvictedMips,
+                 m_uBudgetBytes, m_uCommittedBytes, m_uFrameIndex,
+                 m_uTailDimension, m_uMaxLoadsPerFrame,
+                 m_uNumGraceFrames, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureResidencyManager::TextureResidencyManager(uint64_t uBudgetBytes)
+        : m_aEntries()
+        , m_aFreeHandles()
+        , m_aEvictedMips()
+        , m_uBudgetBytes(uBudgetBytes)
+        , m_uCommittedBytes(0ull)
+        , m_uFrameIndex(0ull)
+        , m_uTailDimension(DEFAULT_TAIL_DIMENSION)
+        , m_uMaxLoadsPerFrame(DEFAULT_MAX_LOADS_PER_FRAME)
+        , m_uNumGraceFrames(DEFAULT_NUM_GRACE_FRAMES)
+        , m_stats()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::RegisterTexture
+      Summary:  Adds a texture to the residency set. Only its mip tail
+                is considered resident; the tail is never evicted
+      Args:     const TextureResidencyDesc& desc
+                  Dimensions and mip sizes of the texture
+      Modifies: [m_aEntries, m_aFreeHandles, m_uCommittedBytes,
+                 m_stats].
+      Returns:  uint32_t
+                  Handle of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::RegisterTexture(const TextureResidencyDesc& desc)
+    {
+        uint32_t uHandle = INVALID_HANDLE;
+        if (!m_aFreeHandles.empty())
+        {
+            uHandle = m_aFreeHandles.back();
+            m_aFreeHandles.pop_back();
+        }
+        else
+        {
+            uHandle = static_cast<uint32_t>(m_aEntries.size());
+            m_aEntries.emplace_back();
+        }
+
+        Entry& entry = m_aEntries[uHandle];
+        entry.Desc = desc;
+        entry.uLastUsedFrame = m_uFrameIndex;
+        entry.uTailMip = computeTailMip(desc);
+        entry.uResidentMip = entry.uTailMip;
+        entry.uPendingMip = entry.uTailMip;
+        entry.uDesiredMip = entry.uTailMip;
+        entry.uRequestedMip = NO_REQUEST;
+        entry.bRegistered = true;
+
+        m_uCommittedBytes += committedBytes(entry);
+        m_stats.uCommittedBytes = m_uCommittedBytes;
+        m_stats.uPeakCommittedBytes = std::max(m_stats.uPeakCommittedBytes, m_uCommittedBytes);
+
+        return uHandle;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::UnregisterTexture
+      Summary:  Removes a texture from the residency set and releases
+                its committed memory
+      Args:     uint32_t uHandle
+                  Handle of the texture
+      Modifies: [m_aEntries, m_aFreeHandles, m_uCommittedBytes,
+                 m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::UnregisterTexture(uint32_t uHandle)
+    {
+        if (uHandle >= m_aEntries.size() || !m_aEntries[uHandle].bRegistered)
+        {
+            return;
+        }
+
+        Entry& entry = m_aEntries[uHandle];
+        m_uCommittedBytes -= committedBytes(entry);
+        m_stats.uCommittedBytes = m_uCommittedBytes;
+
+        entry = Entry();
+        m_aFreeHandles.push_back(uHandle);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::ReportProjectedSize
+      Summary:  Records that the texture was drawn this frame covering
+                the given number of pixels along its larger axis. The
+                largest report of a frame wins
+      Args:     uint32_t uHandle
+                  Handle of the texture
+                float projectedSize
+                  Projected size of the texture in pixels
+      Modifies: [m_aEntries].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::ReportProjectedSize(uint32_t uHandle, float projectedSize)
+    {
+        if (uHandle >= m_aEntries.size() || !m_aEntries[uHandle].bRegistered)
+        {
+            return;
+        }
+
+        Entry& entry = m_aEntries[uHandle];
+        uint32_t uMip = ComputeDesiredMip(
+            entry.Desc.uWidth,
+            entry.Desc.uHeight,
+            static_cast<uint32_t>(entry.Desc.aMipByteSizes.size()),
+            projectedSize
+        );
+        entry.uRequestedMip = std::min(entry.uRequestedMip, std::min(uMip, entry.uTailMip));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::Update
+      Summary:  Resolves the reports of the frame into load and
+                eviction commands and advances the frame counter.
+                Evictions are applied immediately and must be executed
+                by the caller before the loads; loads reserve their
+                memory until OnLoadCompleted or OnLoadFailed
+      Args:     std::vector<TextureResidencyCommand>& aOutLoads
+                  Textures to stream in, finest level requested
+                std::vector<TextureResidencyCommand>& aOutEvictions
+                  Textures to shrink, new finest resident level
+      Modifies: [m_aEntries, m_aEvictedMips, m_uCommittedBytes,
+                 m_uFrameIndex, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::Update(std::vector<TextureResidencyCommand>& aOutLoads, std::vector<TextureResidencyCommand>& aOutEvictions)
+    {
+        aOutLoads.clear();
+        aOutEvictions.clear();
+
+        m_aEvictedMips.resize(m_aEntries.size());
+
+        for (uint32_t uHandle = 0u; uHandle < m_aEntries.size(); ++uHandle)
+        {
+            Entry& entry = m_aEntries[uHandle];
+            m_aEvictedMips[uHandle] = entry.uResidentMip;
+
+            if (!entry.bRegistered)
+            {
+                continue;
+            }
+
+            if (entry.uRequestedMip != NO_REQUEST)
+            {
+                entry.uDesiredMip = entry.uRequestedMip;
+                entry.uLastUsedFrame = m_uFrameIndex;
+            }
+            else if (m_uFrameIndex - entry.uLastUsedFrame > m_uNumGraceFrames)
+            {
+                entry.uDesiredMip = entry.uTailMip;
+            }
+            entry.uRequestedMip = NO_REQUEST;
+        }
+
+        // The budget may have been lowered since the last frame
+        if (m_uCommittedBytes > m_uBudgetBytes)
+        {
+            evict(m_uCommittedBytes - m_uBudgetBytes, INVALID_HANDLE, true);
+        }
+
+        // Only textures drawn this frame may stream in, coarsest first
+        std::vector<uint32_t> aCandidates;
+        for (uint32_t uHandle = 0u; uHandle < m_aEntries.size(); ++uHandle)
+        {
+            const Entry& entry = m_aEntries[uHandle];
+            if (entry.bRegistered && !isLoading(entry) && entry.uLastUsedFrame == m_uFrameIndex && entry.uDesiredMip < entry.uResidentMip)
+            {
+                aCandidates.push_back(uHandle);
+            }
+        }
+
+        std::sort(aCandidates.begin(), aCandidates.end(),
+            [this](uint32_t uLeft, uint32_t uRight)
+            {
+                const Entry& left = m_aEntries[uLeft];
+                const Entry& right = m_aEntries[uRight];
+                uint32_t uLeftDeficit = left.uResidentMip - left.uDesiredMip;
+                uint32_t uRightDeficit = right.uResidentMip - right.uDesiredMip;
+                if (uLeftDeficit != uRightDeficit)
+                {
+                    return uLeftDeficit > uRightDeficit;
+                }
+                return uLeft < uRight;
+            }
+        );
+
+        uint32_t uNumLoads = 0u;
+        for (uint32_t uHandle : aCandidates)
+        {
+            Entry& entry = m_aEntries[uHandle];
+            if (uNumLoads >= m_uMaxLoadsPerFrame)
+            {
+                ++m_stats.uNumRequestsDeferred;
+                continue;
+            }
+
+            // Fall back to coarser levels if the desired one does not fit
+            uint32_t uTargetMip = entry.uDesiredMip;
+            uint64_t uExtraBytes = 0ull;
+            while (uTargetMip < entry.uResidentMip)
+            {
+                uExtraBytes = bytesFromMip(entry, uTargetMip) - bytesFromMip(entry, entry.uResidentMip);
+                if (m_uCommittedBytes + uExtraBytes > m_uBudgetBytes)
+                {
+                    evict(m_uCommittedBytes + uExtraBytes - m_uBudgetBytes, uHandle, false);
+                }
+
+                if (m_uCommittedBytes + uExtraBytes <= m_uBudgetBytes)
+                {
+                    break;
+                }
+                ++uTargetMip;
+            }
+
+            if (uTargetMip >= entry.uResidentMip)
+            {
+                ++m_stats.uNumRequestsDeferred;
+                continue;
+            }
+
+            entry.uPendingMip = uTargetMip;
+            m_uCommittedBytes += uExtraBytes;
+            ++m_stats.uNumLoadsIssued;
+            ++uNumLoads;
+
+            aOutLoads.push_back({ .uHandle = uHandle, .uMostDetailedMip = uTargetMip });
+        }
+
+        for (uint32_t uHandle = 0u; uHandle < m_aEntries.size(); ++uHandle)
+        {
+            const Entry& entry = m_aEntries[uHandle];
+            if (entry.bRegistered && entry.uResidentMip > m_aEvictedMips[uHandle])
+            {
+                aOutEvictions.push_back({ .uHandle = uHandle, .uMostDetailedMip = entry.uResidentMip });
+            }
+        }
+
+        m_stats.uCommittedBytes = m_uCommittedBytes;
+        m_stats.uPeakCommittedBytes = std::max(m_stats.uPeakCommittedBytes, m_uCommittedBytes);
+
+        ++m_uFrameIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::OnLoadCompleted
+      Summary:  Marks the streamed-in levels of a texture as resident
+      Args:     uint32_t uHandle
+                  Handle of the texture
+                uint32_t uMostDetailedMip
+                  Finest level now resident
+      Modifies: [m_aEntries, m_uCommittedBytes, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::OnLoadCompleted(uint32_t uHandle, uint32_t uMostDetailedMip)
+    {
+        if (uHandle >= m_aEntries.size() || !m_aEntries[uHandle].bRegistered)
+        {
+            return;
+        }
+
+        Entry& entry = m_aEntries[uHandle];
+        m_uCommittedBytes -= committedBytes(entry);
+
+        entry.uResidentMip = std::min(uMostDetailedMip, entry.uTailMip);
+        entry.uPendingMip = entry.uResidentMip;
+
+        m_uCommittedBytes += committedBytes(entry);
+        ++m_stats.uNumLoadsCompleted;
+        m_stats.uCommittedBytes = m_uCommittedBytes;
+        m_stats.uPeakCommittedBytes = std::max(m_stats.uPeakCommittedBytes, m_uCommittedBytes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::OnLoadFailed
+      Summary:  Cancels the load in flight of a texture and releases
+                its reserved memory
+      Args:     uint32_t uHandle
+                  Handle of the texture
+      Modifies: [m_aEntries, m_uCommittedBytes, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::OnLoadFailed(uint32_t uHandle)
+    {
+        if (uHandle >= m_aEntries.size() || !m_aEntries[uHandle].bRegistered)
+        {
+            return;
+        }
+
+        Entry& entry = m_aEntries[uHandle];
+        m_uCommittedBytes -= committedBytes(entry);
+
+        entry.uPendingMip = entry.uResidentMip;
+
+        m_uCommittedBytes += committedBytes(entry);
+        ++m_stats.uNumLoadsFailed;
+        m_stats.uCommittedBytes = m_uCommittedBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::SetBudget
+      Summary:  Changes the memory budget, enforced on the next Update
+      Args:     uint64_t uBudgetBytes
+                  Memory budget of the streamed textures in bytes
+      Modifies: [m_uBudgetBytes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::SetBudget(uint64_t uBudgetBytes)
+    {
+        m_uBudgetBytes = uBudgetBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::SetTailDimension
+      Summary:  Changes the size below which mips are always resident.
+                Affects textures registered afterwards
+      Args:     uint32_t uTailDimension
+                  Largest dimension of the first mip of the tail
+      Modifies: [m_uTailDimension].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::SetTailDimension(uint32_t uTailDimension)
+    {
+        m_uTailDimension = std::max(uTailDimension, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::SetMaxLoadsPerFrame
+      Summary:  Limits how many loads one Update may issue
+      Args:     uint32_t uMaxLoadsPerFrame
+                  Maximum number of loads per frame
+      Modifies: [m_uMaxLoadsPerFrame].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::SetMaxLoadsPerFrame(uint32_t uMaxLoadsPerFrame)
+    {
+        m_uMaxLoadsPerFrame = uMaxLoadsPerFrame;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::SetNumGraceFrames
+      Summary:  Sets how many frames an unused texture keeps asking for
+                its last desired level before falling back to its tail
+      Args:     uint32_t uNumGraceFrames
+                  Number of frames
+      Modifies: [m_uNumGraceFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureResidencyManager::SetNumGraceFrames(uint32_t uNumGraceFrames)
+    {
+        m_uNumGraceFrames = uNumGraceFrames;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetBudget
+      Summary:  Returns the memory budget
+      Returns:  uint64_t
+                  Memory budget in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t TextureResidencyManager::GetBudget() const
+    {
+        return m_uBudgetBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetCommittedBytes
+      Summary:  Returns the memory of resident levels and loads in
+                flight
+      Returns:  uint64_t
+                  Committed memory in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t TextureResidencyManager::GetCommittedBytes() const
+    {
+        return m_uCommittedBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetTailDimension
+      Summary:  Returns the size below which mips are always resident
+      Returns:  uint32_t
+                  Largest dimension of the first mip of the tail
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::GetTailDimension() const
+    {
+        return m_uTailDimension;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetTailMip
+      Summary:  Returns the first level of the always resident tail
+      Args:     uint32_t uHandle
+                  Handle of the texture
+      Returns:  uint32_t
+                  Mip level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::GetTailMip(uint32_t uHandle) const
+    {
+        return m_aEntries[uHandle].uTailMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetResidentMip
+      Summary:  Returns the finest resident level of a texture
+      Args:     uint32_t uHandle
+                  Handle of the texture
+      Returns:  uint32_t
+                  Mip level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::GetResidentMip(uint32_t uHandle) const
+    {
+        return m_aEntries[uHandle].uResidentMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetDesiredMip
+      Summary:  Returns the level a texture wants resident
+      Args:     uint32_t uHandle
+                  Handle of the texture
+      Returns:  uint32_t
+                  Mip level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::GetDesiredMip(uint32_t uHandle) const
+    {
+        return m_aEntries[uHandle].uDesiredMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetFrameIndex
+      Summary:  Returns the number of Update calls so far
+      Returns:  uint64_t
+                  Frame index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t TextureResidencyManager::GetFrameIndex() const
+    {
+        return m_uFrameIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::GetStats
+      Summary:  Returns the counters of the manager
+      Returns:  const TextureResidencyStats&
+                  Counters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TextureResidencyStats& TextureResidencyManager::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::ComputeDesiredMip
+      Summary:  Returns the finest level whose resolution does not
+                exceed the projected size, so that one texel covers
+                about one pixel
+      Args:     uint32_t uWidth
+                  Width of the top level
+                uint32_t uHeight
+                  Height of the top level
+                uint32_t uNumMips
+                  Number of levels of the texture
+                float projectedSize
+                  Projected size of the texture in pixels
+      Returns:  uint32_t
+                  Mip level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::ComputeDesiredMip(uint32_t uWidth, uint32_t uHeight, uint32_t uNumMips, float projectedSize)
+    {
+        if (uNumMips == 0u)
+        {
+            return 0u;
+        }
+
+        if (!(projectedSize > 0.0f))
+        {
+            return uNumMips - 1u;
+        }
+
+        float ratio = static_cast<float>(std::max(uWidth, uHeight)) / projectedSize;
+        if (ratio <= 1.0f)
+        {
+            return 0u;
+        }
+
+        uint32_t uMip = static_cast<uint32_t>(std::floor(std::log2(ratio)));
+        return std::min(uMip, uNumMips - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::bytesFromMip
+      Summary:  Returns the size of the levels from uMip to the end of
+                the chain
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t TextureResidencyManager::bytesFromMip(const Entry& entry, uint32_t uMip) const
+    {
+        uint64_t uBytes = 0ull;
+        for (size_t i = uMip; i < entry.Desc.aMipByteSizes.size(); ++i)
+        {
+            uBytes += entry.Desc.aMipByteSizes[i];
+        }
+
+        return uBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::committedBytes
+      Summary:  Returns the memory of the resident levels of a texture
+                including the levels of its load in flight
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t TextureResidencyManager::committedBytes(const Entry& entry) const
+    {
+        return bytesFromMip(entry, std::min(entry.uResidentMip, entry.uPendingMip));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::computeTailMip
+      Summary:  Returns the first level whose dimensions both fit in
+                the tail dimension
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TextureResidencyManager::computeTailMip(const TextureResidencyDesc& desc) const
+    {
+        uint32_t uNumMips = static_cast<uint32_t>(desc.aMipByteSizes.size());
+        for (uint32_t uMip = 0u; uMip < uNumMips; ++uMip)
+        {
+            uint32_t uWidth = std::max(desc.uWidth >> uMip, 1u);
+            uint32_t uHeight = std::max(desc.uHeight >> uMip, 1u);
+            if (uWidth <= m_uTailDimension && uHeight <= m_uTailDimension)
+            {
+                return uMip;
+            }
+        }
+
+        return uNumMips > 0u ? uNumMips - 1u : 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::isLoading
+      Summary:  Returns whether a load of the texture is in flight
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool TextureResidencyManager::isLoading(const Entry& entry) const
+    {
+        return entry.uPendingMip < entry.uResidentMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureResidencyManager::evict
+      Summary:  Drops resident levels one at a time until enough memory
+                is freed. Levels finer than what their texture wants
+                go first, then textures in least recently used order.
+                Textures drawn this frame keep their desired level
+                unless bAllowUsedThisFrame is set
+      Args:     uint64_t uBytesNeeded
+                  Memory to free in bytes
+                uint32_t uExcludedHandle
+                  Texture that must not be evicted
+                bool bAllowUsedThisFrame
+                  Whether textures drawn this frame may lose levels
+                  they need
+      Modifies: [m_aEntries, m_uCommittedBytes, m_stats].
+      Returns:  uint64_t
+                  Memory freed in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t TextureResidencyManager::evict(uint64_t uBytesNeeded, uint32_t uExcludedHandle, bool bAllowUsedThisFrame)
+    {
+        std::vector<uint32_t> aVictims;
+        for (uint32_t uHandle = 0u; uHandle < m_aEntries.size(); ++uHandle)
+        {
+            const Entry& entry = m_aEntries[uHandle];
+            if (entry.bRegistered && uHandle != uExcludedHandle && !isLoading(entry) && entry.uResidentMip < entry.uTailMip)
+            {
+                aVictims.push_back(uHandle);
+            }
+        }
+
+        std::sort(aVictims.begin(), aVictims.end(),
+            [this](uint32_t uLeft, uint32_t uRight)
+            {
+                if (m_aEntries[uLeft].uLastUsedFrame != m_aEntries[uRight].uLastUsedFrame)
+                {
+                    return m_aEntries[uLeft].uLastUsedFrame < m_aEntries[uRight].uLastUsedFrame;
+                }
+                return uLeft < uRight;
+            }
+        );
+
+        uint64_t uFreedBytes = 0ull;
+        for (uint32_t uPass = 0u; uPass < 2u && uFreedBytes < uBytesNeeded; ++uPass)
+        {
+            for (uint32_t uHandle : aVictims)
+            {
+                Entry& entry = m_aEntries[uHandle];
+
+                uint32_t uFloorMip = entry.uDesiredMip;
+                if (uPass == 1u)
+                {
+                    bool bUsedThisFrame = entry.uLastUsedFrame == m_uFrameIndex;
+                    uFloorMip = (bAllowUsedThisFrame || !bUsedThisFrame) ? entry.uTailMip : entry.uDesiredMip;
+                }
+                uFloorMip = std::min(uFloorMip, entry.uTailMip);
+
+                while (entry.uResidentMip < uFloorMip && uFreedBytes < uBytesNeeded)
+                {
+                    uint64_t uMipBytes = entry.Desc.aMipByteSizes[entry.uResidentMip];
+                    ++entry.uResidentMip;
+                    entry.uPendingMip = entry.uResidentMip;
+
+                    m_uCommittedBytes -= uMipBytes;
+                    uFreedBytes += uMipBytes;
+                    ++m_stats.uNumMipsEvicted;
+                }
+
+                if (uFreedBytes >= uBytesNeeded)
+                {
+                    break;
+                }
+            }
+        }
+
+        return uFreedBytes;
+    }
+}
@@ -0,0 +1,160 @@
+/*+===================================================================
+  File:      TEXTURERESIDENCYMANAGER.H
+
+  Summary:   TextureResidencyManager header file contains declaration
+             of class TextureResidencyManager used to decide which
+             mip levels of streamed textures stay in video memory.
+             It only depends on the standard library so the policy
+             can be simulated without a Direct3D device.
+
+  Classes:  TextureResidencyManager
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureResidencyDesc
+      Summary:  Size of every mip level of a streamed texture
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureResidencyDesc
+    {
+        uint32_t uWidth;
+        uint32_t uHeight;
+        std::vector<uint64_t> aMipByteSizes;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureResidencyCommand
+      Summary:  Request to change the most detailed resident mip level
+                of a texture, either by streaming in finer levels or by
+                evicting them
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureResidencyCommand
+    {
+        uint32_t uHandle;
+        uint32_t uMostDetailedMip;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureResidencyStats
+      Summary:  Counters exposed by the residency manager
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureResidencyStats
+    {
+        uint64_t uNumLoadsIssued;
+        uint64_t uNumLoadsCompleted;
+        uint64_t uNumLoadsFailed;
+        uint64_t uNumMipsEvicted;
+        uint64_t uNumRequestsDeferred;
+        uint64_t uCommittedBytes;
+        uint64_t uPeakCommittedBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureResidencyManager
+      Summary:  Keeps the mip tail of every registered texture resident
+                and streams finer levels on demand. Each frame the
+                renderer reports the projected screen size of the
+                textures it draws; Update turns these reports into load
+                and eviction commands so that the committed memory
+                (resident levels plus loads in flight) never exceeds
+                the budget. Least recently used textures lose their
+                finest levels first.
+      Methods:  RegisterTexture
+                  Adds a texture with only its mip tail resident
+                UnregisterTexture
+                  Removes a texture from the residency set
+                ReportProjectedSize
+                  Records the on-screen size of a texture this frame
+                Update
+                  Produces the load and eviction commands of the frame
+                OnLoadCompleted
+                  Marks a streamed-in mip range as resident
+                OnLoadFailed
+                  Cancels a load in flight
+                ComputeDesiredMip
+                  Returns the mip level matching a projected size
+                TextureResidencyManager
+                  Constructor.
+                ~TextureResidencyManager
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureResidencyManager
+    {
+    public:
+        static constexpr const uint32_t INVALID_HANDLE = 0xFFFFFFFFu;
+        static constexpr const uint32_t DEFAULT_TAIL_DIMENSION = 64u;
+        static constexpr const uint32_t DEFAULT_MAX_LOADS_PER_FRAME = 4u;
+        static constexpr const uint32_t DEFAULT_NUM_GRACE_FRAMES = 120u;
+
+    public:
+        TextureResidencyManager() = delete;
+        explicit TextureResidencyManager(uint64_t uBudgetBytes);
+        TextureResidencyManager(const TextureResidencyManager& other) = delete;
+        TextureResidencyManager(TextureResidencyManager&& other) = delete;
+        TextureResidencyManager& operator=(const TextureResidencyManager& other) = delete;
+        TextureResidencyManager& operator=(TextureResidencyManager&& other) = delete;
+        virtual ~TextureResidencyManager() = default;
+
+        uint32_t RegisterTexture(const TextureResidencyDesc& desc);
+        void UnregisterTexture(uint32_t uHandle);
+
+        void ReportProjectedSize(uint32_t uHandle, float projectedSize);
+        void Update(std::vector<TextureResidencyCommand>& aOutLoads, std::vector<TextureResidencyCommand>& aOutEvictions);
+        void OnLoadCompleted(uint32_t uHandle, uint32_t uMostDetailedMip);
+        void OnLoadFailed(uint32_t uHandle);
+
+        void SetBudget(uint64_t uBudgetBytes);
+        void SetTailDimension(uint32_t uTailDimension);
+        void SetMaxLoadsPerFrame(uint32_t uMaxLoadsPerFrame);
+        void SetNumGraceFrames(uint32_t uNumGraceFrames);
+
+        uint64_t GetBudget() const;
+        uint64_t GetCommittedBytes() const;
+        uint32_t GetTailDimension() const;
+        uint32_t GetTailMip(uint32_t uHandle) const;
+        uint32_t GetResidentMip(uint32_t uHandle) const;
+        uint32_t GetDesiredMip(uint32_t uHandle) const;
+        uint64_t GetFrameIndex() const;
+        const TextureResidencyStats& GetStats() const;
+
+        static uint32_t ComputeDesiredMip(uint32_t uWidth, uint32_t uHeight, uint32_t uNumMips, float projectedSize);
+
+    private:
+        struct Entry
+        {
+            TextureResidencyDesc Desc;
+            uint64_t uLastUsedFrame;
+            uint32_t uTailMip;
+            uint32_t uResidentMip;
+            uint32_t uPendingMip;
+            uint32_t uDesiredMip;
+            uint32_t uRequestedMip;
+            bool bRegistered;
+        };
+
+        uint64_t bytesFromMip(const Entry& entry, uint32_t uMip) const;
+        uint64_t committedBytes(const Entry& entry) const;
+        uint32_t computeTailMip(const TextureResidencyDesc& desc) const;
+        bool isLoading(const Entry& entry) const;
+        uint64_t evict(uint64_t uBytesNeeded, uint32_t uExcludedHandle, bool bAllowUsedThisFrame);
+
+    private:
+        std::vector<Entry> m_aEntries;
+        std::vector<uint32_t> m_aFreeHandles;
+        std::vector<uint32_t> m_aEvictedMips;
+        uint64_t m_uBudgetBytes;
+        uint64_t m_uCommittedBytes;
+        uint64_t m_uFrameIndex;
+        uint32_t m_uTailDimension;
+        uint32_t m_uMaxLoadsPerFrame;
+        uint32_t m_uNumGraceFrames;
+        TextureResidencyStats m_stats;
+    };
+}
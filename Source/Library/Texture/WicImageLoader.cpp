@@ -0,0 +1,96 @@
+#include "Texture/WicImageLoader.h"
+
+#pragma comment(lib, "windowscodecs.lib")
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WicImageLoader::WicImageLoader
+      Summary:  Constructor
+      Modifies: [m_factory].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WicImageLoader::WicImageLoader()
+        : m_factory(nullptr)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WicImageLoader::Initialize
+      Summary:  Creates the imaging factory. COM must be initialized on
+                the calling thread
+      Modifies: [m_factory].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT WicImageLoader::Initialize()
+    {
+        return CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(m_factory.GetAddressOf()));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WicImageLoader::Load
+      Summary:  Decodes the first frame of an image file to RGBA8
+      Args:     const std::filesystem::path& filePath
+                  Path to the image file
+                Image& outImage
+                  Decoded image
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT WicImageLoader::Load(_In_ const std::filesystem::path& filePath, _Out_ Image& outImage) const
+    {
+        outImage = Image();
+
+        if (!m_factory)
+        {
+            return E_UNEXPECTED;
+        }
+
+        ComPtr<IWICBitmapDecoder> decoder;
+        HRESULT hr = m_factory->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        ComPtr<IWICBitmapFrameDecode> frame;
+        hr = decoder->GetFrame(0u, frame.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        UINT uWidth = 0u;
+        UINT uHeight = 0u;
+        hr = frame->GetSize(&uWidth, &uHeight);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        ComPtr<IWICFormatConverter> converter;
+        hr = m_factory->CreateFormatConverter(converter.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        outImage.uWidth = uWidth;
+        outImage.uHeight = uHeight;
+        outImage.aPixels.resize(static_cast<size_t>(uWidth) * uHeight * 4u);
+
+        hr = converter->CopyPixels(nullptr, uWidth * 4u, static_cast<UINT>(outImage.aPixels.size()), outImage.aPixels.data());
+        if (FAILED(hr))
+        {
+            outImage = Image();
+            return hr;
+        }
+
+        return S_OK;
+    }
+}
@@ -0,0 +1,50 @@
+/*+===================================================================
+  File:      WICIMAGELOADER.H
+
+  Summary:   WicImageLoader header file contains declaration of class
+             WicImageLoader used to decode image files to RGBA8
+             pixels on the CPU, so that mips can be generated before
+             the texture is uploaded.
+
+  Classes:  WicImageLoader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/Image.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    WicImageLoader
+      Summary:  Decodes any image format Windows Imaging Component reads
+                and converts it to 8-bit RGBA
+      Methods:  Initialize
+                  Creates the imaging factory
+                Load
+                  Decodes an image file
+                WicImageLoader
+                  Constructor.
+                ~WicImageLoader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class WicImageLoader final
+    {
+    public:
+        WicImageLoader();
+        WicImageLoader(const WicImageLoader& other) = delete;
+        WicImageLoader(WicImageLoader&& other) = delete;
+        WicImageLoader& operator=(const WicImageLoader& other) = delete;
+        WicImageLoader& operator=(WicImageLoader&& other) = delete;
+        ~WicImageLoader() = default;
+
+        HRESULT Initialize();
+        HRESULT Load(_In_ const std::filesystem::path& filePath, _Out_ Image& outImage) const;
+
+    private:
+        ComPtr<IWICImagingFactory> m_factory;
+    };
+}
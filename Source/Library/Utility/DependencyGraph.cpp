@@ -0,0 +1,257 @@
+#include "Utility/DependencyGraph.h"
+
+#include <deque>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::DependencyGraph
+      Summary:  Constructor of an empty graph
+      Modifies: [m_resourceFiles, m_fileResources, m_includes,
+                 m_includers].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DependencyGraph::DependencyGraph()
+        : m_resourceFiles()
+        , m_fileResources()
+        , m_includes()
+        , m_includers()
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::SetDependencies
+      Summary:  Replaces the files a resource is built from. Includes
+                of those files are set separately with SetIncludes
+      Args:     uint32_t uResource
+                  Identifier of the resource, chosen by the caller
+                const std::vector<std::filesystem::path>& aFilePaths
+                  Files the resource is built from
+      Modifies: [m_resourceFiles, m_fileResources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DependencyGraph::SetDependencies(uint32_t uResource, const std::vector<std::filesystem::path>& aFilePaths)
+    {
+        RemoveResource(uResource);
+
+        std::vector<std::filesystem::path>& aResourceFiles = m_resourceFiles[uResource];
+        aResourceFiles.reserve(aFilePaths.size());
+        for (const std::filesystem::path& filePath : aFilePaths)
+        {
+            std::filesystem::path normalizedPath = Normalize(filePath);
+            if (m_fileResources[normalizedPath].insert(uResource).second)
+            {
+                aResourceFiles.push_back(normalizedPath);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::SetIncludes
+      Summary:  Replaces the files a file includes directly
+      Args:     const std::filesystem::path& filePath
+                  Including file
+                const std::vector<std::filesystem::path>& aIncludedFilePaths
+                  Files it includes
+      Modifies: [m_includes, m_includers].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DependencyGraph::SetIncludes(const std::filesystem::path& filePath, const std::vector<std::filesystem::path>& aIncludedFilePaths)
+    {
+        std::filesystem::path normalizedPath = Normalize(filePath);
+
+        std::set<std::filesystem::path>& includes = m_includes[normalizedPath];
+        for (const std::filesystem::path& includedFilePath : includes)
+        {
+            auto it = m_includers.find(includedFilePath);
+            if (it != m_includers.end())
+            {
+                it->second.erase(normalizedPath);
+                if (it->second.empty())
+                {
+                    m_includers.erase(it);
+                }
+            }
+        }
+        includes.clear();
+
+        for (const std::filesystem::path& includedFilePath : aIncludedFilePaths)
+        {
+            std::filesystem::path normalizedIncludedPath = Normalize(includedFilePath);
+            includes.insert(normalizedIncludedPath);
+            m_includers[normalizedIncludedPath].insert(normalizedPath);
+        }
+
+        if (includes.empty())
+        {
+            m_includes.erase(normalizedPath);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::RemoveResource
+      Summary:  Forgets the files of a resource. Include edges are kept
+                since other resources may share them
+      Args:     uint32_t uResource
+                  Identifier of the resource
+      Modifies: [m_resourceFiles, m_fileResources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DependencyGraph::RemoveResource(uint32_t uResource)
+    {
+        auto it = m_resourceFiles.find(uResource);
+        if (it == m_resourceFiles.end())
+        {
+            return;
+        }
+
+        for (const std::filesystem::path& filePath : it->second)
+        {
+            auto file = m_fileResources.find(filePath);
+            if (file != m_fileResources.end())
+            {
+                file->second.erase(uResource);
+                if (file->second.empty())
+                {
+                    m_fileResources.erase(file);
+                }
+            }
+        }
+
+        m_resourceFiles.erase(it);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::GetAffectedResources
+      Summary:  Walks from every changed file up to the files including
+                it and collects the resources built from any of them.
+                Include cycles are visited once
+      Args:     const std::vector<std::filesystem::path>& aChangedFilePaths
+                  Files that changed
+                std::vector<uint32_t>& aOutResources
+                  Resources to rebuild, sorted, without duplicates
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DependencyGraph::GetAffectedResources(const std::vector<std::filesystem::path>& aChangedFilePaths, std::vector<uint32_t>& aOutResources) const
+    {
+        aOutResources.clear();
+
+        std::set<std::filesystem::path> visited;
+        std::deque<std::filesystem::path> queue;
+        for (const std::filesystem::path& filePath : aChangedFilePaths)
+        {
+            std::filesystem::path normalizedPath = Normalize(filePath);
+            if (visited.insert(normalizedPath).second)
+            {
+                queue.push_back(normalizedPath);
+            }
+        }
+
+        std::set<uint32_t> resources;
+        while (!queue.empty())
+        {
+            std::filesystem::path filePath = std::move(queue.front());
+            queue.pop_front();
+
+            auto file = m_fileResources.find(filePath);
+            if (file != m_fileResources.end())
+            {
+                resources.insert(file->second.begin(), file->second.end());
+            }
+
+            auto includers = m_includers.find(filePath);
+            if (includers != m_includers.end())
+            {
+                for (const std::filesystem::path& includerPath : includers->second)
+                {
+                    if (visited.insert(includerPath).second)
+                    {
+                        queue.push_back(includerPath);
+                    }
+                }
+            }
+        }
+
+        aOutResources.assign(resources.begin(), resources.end());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::GetFilePaths
+      Summary:  Returns the files of every resource and everything they
+                include, the set of files worth watching
+      Args:     std::vector<std::filesystem::path>& aOutFilePaths
+                  Normalized paths, sorted, without duplicates
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DependencyGraph::GetFilePaths(std::vector<std::filesystem::path>& aOutFilePaths) const
+    {
+        std::set<std::filesystem::path> filePaths;
+        for (const auto& [filePath, resources] : m_fileResources)
+        {
+            collectFilePaths(filePath, filePaths);
+        }
+
+        aOutFilePaths.assign(filePaths.begin(), filePaths.end());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::GetNumResources
+      Summary:  Returns the number of resources with dependencies
+      Returns:  size_t
+                  Number of resources
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    size_t DependencyGraph::GetNumResources() const
+    {
+        return m_resourceFiles.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::Normalize
+      Summary:  Makes a path absolute and removes its dot segments, so
+                that the spellings of one file share a key
+      Args:     const std::filesystem::path& filePath
+                  Path to normalize
+      Returns:  std::filesystem::path
+                  Normalized path
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path DependencyGraph::Normalize(const std::filesystem::path& filePath)
+    {
+        std::error_code errorCode;
+        std::filesystem::path absolutePath = std::filesystem::absolute(filePath, errorCode);
+        if (errorCode)
+        {
+            return filePath.lexically_normal();
+        }
+
+        return absolutePath.lexically_normal();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DependencyGraph::collectFilePaths
+      Summary:  Adds a file and everything it includes
+      Args:     const std::filesystem::path& filePath
+                  Normalized path of the file
+                std::set<std::filesystem::path>& outFilePaths
+                  Files collected so far
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DependencyGraph::collectFilePaths(const std::filesystem::path& filePath, std::set<std::filesystem::path>& outFilePaths) const
+    {
+        std::deque<std::filesystem::path> queue;
+        if (outFilePaths.insert(filePath).second)
+        {
+            queue.push_back(filePath);
+        }
+
+        while (!queue.empty())
+        {
+            auto includes = m_includes.find(queue.front());
+            queue.pop_front();
+
+            if (includes == m_includes.end())
+            {
+                continue;
+            }
+
+            for (const std::filesystem::path& includedFilePath : includes->second)
+            {
+                if (outFilePaths.insert(includedFilePath).second)
+                {
+                    queue.push_back(includedFilePath);
+                }
+            }
+        }
+    }
+}
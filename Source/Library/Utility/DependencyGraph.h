@@ -0,0 +1,77 @@
+/*+===================================================================
+  File:      DEPENDENCYGRAPH.H
+
+  Summary:   DependencyGraph header file contains declaration of class
+             DependencyGraph used to find the resources to rebuild
+             when files change on the disk. It only depends on the
+             standard library.
+
+  Classes:  DependencyGraph
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DependencyGraph
+      Summary:  Records which files every resource is built from, and
+                which files every file includes. A changed file affects
+                the resources built from it and from every file that
+                includes it, directly or through other includes
+      Methods:  SetDependencies
+                  Replaces the files a resource is built from
+                SetIncludes
+                  Replaces the files a file includes
+                RemoveResource
+                  Forgets a resource
+                GetAffectedResources
+                  Returns the resources to rebuild for changed files
+                GetFilePaths
+                  Returns every file the resources depend on
+                GetNumResources
+                  Returns the number of resources
+                Normalize
+                  Returns the key a path is stored under
+                DependencyGraph
+                  Constructor.
+                ~DependencyGraph
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DependencyGraph
+    {
+    public:
+        DependencyGraph();
+        DependencyGraph(const DependencyGraph& other) = delete;
+        DependencyGraph(DependencyGraph&& other) = delete;
+        DependencyGraph& operator=(const DependencyGraph& other) = delete;
+        DependencyGraph& operator=(DependencyGraph&& other) = delete;
+        virtual ~DependencyGraph() = default;
+
+        void SetDependencies(uint32_t uResource, const std::vector<std::filesystem::path>& aFilePaths);
+        void SetIncludes(const std::filesystem::path& filePath, const std::vector<std::filesystem::path>& aIncludedFilePaths);
+        void RemoveResource(uint32_t uResource);
+
+        void GetAffectedResources(const std::vector<std::filesystem::path>& aChangedFilePaths, std::vector<uint32_t>& aOutResources) const;
+        void GetFilePaths(std::vector<std::filesystem::path>& aOutFilePaths) const;
+        size_t GetNumResources() const;
+
+        static std::filesystem::path Normalize(const std::filesystem::path& filePath);
+
+    private:
+        void collectFilePaths(const std::filesystem::path& filePath, std::set<std::filesystem::path>& outFilePaths) const;
+
+    private:
+        std::map<uint32_t, std::vector<std::filesystem::path>> m_resourceFiles;
+        std::map<std::filesystem::path, std::set<uint32_t>> m_fileResources;
+        std::map<std::filesystem::path, std::set<std::filesystem::path>> m_includes;
+        std::map<std::filesystem::path, std::set<std::filesystem::path>> m_includers;
+    };
+}
@@ -0,0 +1,201 @@
+#include "Utility/FileWatcher.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::FileWatcher
+      Summary:  Constructor
+      Args:     std::chrono::milliseconds interval
+                  Time between two checks of the polling thread
+      Modifies: [m_interval, m_mutex, m_stopCondition, m_thread,
+                 m_files, m_aChangedFilePaths, m_bIsRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FileWatcher::FileWatcher(std::chrono::milliseconds interval)
+        : m_interval(interval)
+        , m_mutex()
+        , m_stopCondition()
+        , m_thread()
+        , m_files()
+        , m_aChangedFilePaths()
+        , m_bIsRunning(false)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::~FileWatcher
+      Summary:  Destructor. Joins the polling thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FileWatcher::~FileWatcher()
+    {
+        Stop();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::Watch
+      Summary:  Replaces the set of watched files. Files watched before
+                keep their last write time, new ones start from their
+                current one
+      Args:     const std::vector<std::filesystem::path>& aFilePaths
+                  Files to watch
+      Modifies: [m_files].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FileWatcher::Watch(const std::vector<std::filesystem::path>& aFilePaths)
+    {
+        std::map<std::filesystem::path, WatchedFile> files;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const std::filesystem::path& filePath : aFilePaths)
+            {
+                auto it = m_files.find(filePath);
+                if (it != m_files.end())
+                {
+                    files.insert(*it);
+                }
+            }
+        }
+
+        for (const std::filesystem::path& filePath : aFilePaths)
+        {
+            if (!files.contains(filePath))
+            {
+                files[filePath] = WatchedFile{ .lastWriteTime = getLastWriteTime(filePath), .bIsSettling = false };
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_files = std::move(files);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::Start
+      Summary:  Starts the thread calling Poll every interval
+      Modifies: [m_thread, m_bIsRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FileWatcher::Start()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_bIsRunning)
+        {
+            return;
+        }
+
+        m_bIsRunning = true;
+        m_thread = std::thread([this]()
+        {
+            std::unique_lock<std::mutex> threadLock(m_mutex);
+            while (!m_stopCondition.wait_for(threadLock, m_interval, [this]() { return !m_bIsRunning; }))
+            {
+                threadLock.unlock();
+                Poll();
+                threadLock.lock();
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::Stop
+      Summary:  Wakes the polling thread up and joins it
+      Modifies: [m_thread, m_bIsRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FileWatcher::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bIsRunning = false;
+        }
+        m_stopCondition.notify_all();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::Poll
+      Summary:  Reads the last write time of every watched file. The
+                file system is queried without holding the lock
+      Modifies: [m_files, m_aChangedFilePaths].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FileWatcher::Poll()
+    {
+        std::vector<std::filesystem::path> aFilePaths;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            aFilePaths.reserve(m_files.size());
+            for (const auto& [filePath, watchedFile] : m_files)
+            {
+                aFilePaths.push_back(filePath);
+            }
+        }
+
+        std::vector<std::filesystem::file_time_type> aLastWriteTimes;
+        aLastWriteTimes.reserve(aFilePaths.size());
+        for (const std::filesystem::path& filePath : aFilePaths)
+        {
+            aLastWriteTimes.push_back(getLastWriteTime(filePath));
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0u; i < aFilePaths.size(); ++i)
+        {
+            auto it = m_files.find(aFilePaths[i]);
+            if (it == m_files.end())
+            {
+                continue;
+            }
+
+            WatchedFile& watchedFile = it->second;
+            if (watchedFile.lastWriteTime != aLastWriteTimes[i])
+            {
+                watchedFile.lastWriteTime = aLastWriteTimes[i];
+                watchedFile.bIsSettling = true;
+            }
+            else if (watchedFile.bIsSettling)
+            {
+                watchedFile.bIsSettling = false;
+                if (std::find(m_aChangedFilePaths.begin(), m_aChangedFilePaths.end(), aFilePaths[i]) == m_aChangedFilePaths.end())
+                {
+                    m_aChangedFilePaths.push_back(aFilePaths[i]);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::ConsumeChanges
+      Summary:  Returns the files that changed since the last call
+      Args:     std::vector<std::filesystem::path>& aOutFilePaths
+                  Changed files, each reported once
+      Modifies: [m_aChangedFilePaths].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FileWatcher::ConsumeChanges(std::vector<std::filesystem::path>& aOutFilePaths)
+    {
+        aOutFilePaths.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        aOutFilePaths.swap(m_aChangedFilePaths);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FileWatcher::getLastWriteTime
+      Summary:  Returns the last write time of a file
+      Args:     const std::filesystem::path& filePath
+                  File to query
+      Returns:  std::filesystem::file_time_type
+                  Last write time, the minimum when the file is missing
+                  or locked by the program saving it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::file_time_type FileWatcher::getLastWriteTime(const std::filesystem::path& filePath)
+    {
+        std::error_code errorCode;
+        std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(filePath, errorCode);
+        if (errorCode)
+        {
+            return std::filesystem::file_time_type::min();
+        }
+
+        return lastWriteTime;
+    }
+}
@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      FILEWATCHER.H
+
+  Summary:   FileWatcher header file contains declaration of class
+             FileWatcher used to notice files edited while the game
+             runs. It only depends on the standard library.
+
+  Classes:  FileWatcher
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FileWatcher
+      Summary:  Polls the last write time of a set of files on a
+                background thread. A change is only reported once the
+                time stayed the same for a whole interval, so a file
+                that is still being saved is not picked up half written
+      Methods:  Watch
+                  Replaces the set of watched files
+                Start
+                  Starts the polling thread
+                Stop
+                  Stops the polling thread
+                Poll
+                  Checks every watched file once
+                ConsumeChanges
+                  Returns and forgets the files that changed
+                FileWatcher
+                  Constructor.
+                ~FileWatcher
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FileWatcher
+    {
+    public:
+        FileWatcher(std::chrono::milliseconds interval);
+        FileWatcher(const FileWatcher& other) = delete;
+        FileWatcher(FileWatcher&& other) = delete;
+        FileWatcher& operator=(const FileWatcher& other) = delete;
+        FileWatcher& operator=(FileWatcher&& other) = delete;
+        virtual ~FileWatcher();
+
+        void Watch(const std::vector<std::filesystem::path>& aFilePaths);
+        void Start();
+        void Stop();
+        void Poll();
+        void ConsumeChanges(std::vector<std::filesystem::path>& aOutFilePaths);
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   WatchedFile
+          Summary:  Last write time seen and whether it still has to
+                    settle before being reported
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct WatchedFile
+        {
+            std::filesystem::file_time_type lastWriteTime;
+            bool bIsSettling;
+        };
+
+        static std::filesystem::file_time_type getLastWriteTime(const std::filesystem::path& filePath);
+
+    private:
+        std::chrono::milliseconds m_interval;
+        std::mutex m_mutex;
+        std::condition_variable m_stopCondition;
+        std::thread m_thread;
+        std::map<std::filesystem::path, WatchedFile> m_files;
+        std::vector<std::filesystem::path> m_aChangedFilePaths;
+        bool m_bIsRunning;
+    };
+}
@@ -0,0 +1,359 @@
+#include "Utility/FixedTimestep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::FixedTimestep
+      Summary:  Constructor
+      Args:     double tickRate
+                  Number of ticks per second
+                uint32_t uMaxTicksPerAdvance
+                  Most ticks a single Advance hands out
+      Modifies: [m_tickSeconds, m_uMaxTicksPerAdvance,
+                 m_accumulatedSeconds, m_uNumTicks, m_droppedSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FixedTimestep::FixedTimestep(double tickRate, uint32_t uMaxTicksPerAdvance)
+        : m_tickSeconds(1.0)
+        , m_uMaxTicksPerAdvance(1u)
+        , m_accumulatedSeconds(0.0)
+        , m_uNumTicks(0u)
+        , m_droppedSeconds(0.0)
+    {
+        SetTickRate(tickRate);
+        SetMaxTicksPerAdvance(uMaxTicksPerAdvance);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::Advance
+      Summary:  Adds elapsed time and takes the whole ticks out of it.
+                Whole ticks past the catch-up limit are dropped; the
+                fraction of a tick is always kept
+      Args:     double elapsedSeconds
+                  Time since the last call, negative counts as zero
+      Modifies: [m_accumulatedSeconds, m_uNumTicks, m_droppedSeconds].
+      Returns:  uint32_t
+                  Number of ticks to run
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t FixedTimestep::Advance(double elapsedSeconds)
+    {
+        m_accumulatedSeconds += (std::max)(elapsedSeconds, 0.0);
+
+        double numDueTicks = std::floor(m_accumulatedSeconds / m_tickSeconds);
+        if (numDueTicks > static_cast<double>(m_uMaxTicksPerAdvance))
+        {
+            double droppedSeconds = (numDueTicks - static_cast<double>(m_uMaxTicksPerAdvance)) * m_tickSeconds;
+            m_droppedSeconds += droppedSeconds;
+            m_accumulatedSeconds -= droppedSeconds;
+            numDueTicks = static_cast<double>(m_uMaxTicksPerAdvance);
+        }
+
+        uint32_t uNumTicks = static_cast<uint32_t>(numDueTicks);
+        m_accumulatedSeconds = (std::max)(m_accumulatedSeconds - numDueTicks * m_tickSeconds, 0.0);
+        m_uNumTicks += uNumTicks;
+
+        return uNumTicks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::SetTickRate
+      Summary:  Changes the number of ticks per second. The accumulated
+                time is kept
+      Args:     double tickRate
+                  Number of ticks per second, clamped to at least 1
+      Modifies: [m_tickSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FixedTimestep::SetTickRate(double tickRate)
+    {
+        m_tickSeconds = 1.0 / (std::max)(tickRate, 1.0);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::SetMaxTicksPerAdvance
+      Summary:  Changes the catch-up limit
+      Args:     uint32_t uMaxTicksPerAdvance
+                  Most ticks a single Advance hands out, at least 1
+      Modifies: [m_uMaxTicksPerAdvance].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FixedTimestep::SetMaxTicksPerAdvance(uint32_t uMaxTicksPerAdvance)
+    {
+        m_uMaxTicksPerAdvance = (std::max)(uMaxTicksPerAdvance, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::GetTickSeconds
+      Summary:  Returns the length of a tick
+      Returns:  double
+                  Seconds simulated by one tick
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double FixedTimestep::GetTickSeconds() const
+    {
+        return m_tickSeconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::GetAlpha
+      Summary:  Returns the fraction of a tick accumulated, the weight
+                of the newest state when interpolating with the one
+                before it
+      Returns:  double
+                  Fraction in [0, 1]
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double FixedTimestep::GetAlpha() const
+    {
+        return (std::min)(m_accumulatedSeconds / m_tickSeconds, 1.0);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::GetNumTicks
+      Summary:  Returns the number of ticks handed out
+      Returns:  uint64_t
+                  Ticks since construction or the last Reset
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t FixedTimestep::GetNumTicks() const
+    {
+        return m_uNumTicks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::GetDroppedSeconds
+      Summary:  Returns the time the catch-up limit dropped
+      Returns:  double
+                  Seconds never simulated
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double FixedTimestep::GetDroppedSeconds() const
+    {
+        return m_droppedSeconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::Reset
+      Summary:  Forgets the accumulated time and the counters
+      Modifies: [m_accumulatedSeconds, m_uNumTicks, m_droppedSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FixedTimestep::Reset()
+    {
+        m_accumulatedSeconds = 0.0;
+        m_uNumTicks = 0u;
+        m_droppedSeconds = 0.0;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::SimulationLoop
+      Summary:  Constructor
+      Args:     double tickRate
+                  Number of ticks per second
+                uint32_t uMaxTicksPerAdvance
+                  Most ticks a single pump runs
+                std::function<double()> clock
+                  Returns the current time in seconds, the steady clock
+                  when null
+      Modifies: [m_clock, m_tickFunction, m_mutex, m_stateMutex,
+                 m_stopCondition, m_thread, m_timestep, m_lastPumpTime,
+                 m_bHasPumped, m_bIsRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SimulationLoop::SimulationLoop(double tickRate, uint32_t uMaxTicksPerAdvance, std::function<double()> clock)
+        : m_clock(std::move(clock))
+        , m_tickFunction()
+        , m_mutex()
+        , m_stateMutex()
+        , m_stopCondition()
+        , m_thread()
+        , m_timestep(tickRate, uMaxTicksPerAdvance)
+        , m_lastPumpTime(0.0)
+        , m_bHasPumped(false)
+        , m_bIsRunning(false)
+    {
+        if (!m_clock)
+        {
+            m_clock = []()
+            {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            };
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::~SimulationLoop
+      Summary:  Destructor. Joins the thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SimulationLoop::~SimulationLoop()
+    {
+        Stop();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::SetTickFunction
+      Summary:  Sets the function called every tick. Must not be called
+                while the thread runs
+      Args:     std::function<void(double)> tickFunction
+                  Called with the length of a tick in seconds
+      Modifies: [m_tickFunction].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SimulationLoop::SetTickFunction(std::function<void(double tickSeconds)> tickFunction)
+    {
+        m_tickFunction = std::move(tickFunction);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::SetTickRate
+      Summary:  Changes the number of ticks per second
+      Args:     double tickRate
+                  Number of ticks per second
+      Modifies: [m_timestep].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SimulationLoop::SetTickRate(double tickRate)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_timestep.SetTickRate(tickRate);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::SetMaxTicksPerAdvance
+      Summary:  Changes the catch-up limit
+      Args:     uint32_t uMaxTicksPerAdvance
+                  Most ticks a single pump runs
+      Modifies: [m_timestep].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SimulationLoop::SetMaxTicksPerAdvance(uint32_t uMaxTicksPerAdvance)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_timestep.SetMaxTicksPerAdvance(uMaxTicksPerAdvance);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::Pump
+      Summary:  Runs the ticks due since the last pump while holding the
+                state mutex. The first pump only starts the clock
+      Modifies: [m_timestep, m_lastPumpTime, m_bHasPumped].
+      Returns:  uint32_t
+                  Number of ticks run
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t SimulationLoop::Pump()
+    {
+        std::lock_guard<std::mutex> stateLock(m_stateMutex);
+
+        uint32_t uNumTicks = 0u;
+        double tickSeconds = 0.0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            double now = m_clock();
+            if (m_bHasPumped)
+            {
+                uNumTicks = m_timestep.Advance(now - m_lastPumpTime);
+            }
+            m_lastPumpTime = now;
+            m_bHasPumped = true;
+            tickSeconds = m_timestep.GetTickSeconds();
+        }
+
+        if (m_tickFunction)
+        {
+            for (uint32_t i = 0u; i < uNumTicks; ++i)
+            {
+                m_tickFunction(tickSeconds);
+            }
+        }
+
+        return uNumTicks;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::Start
+      Summary:  Starts a thread that pumps and sleeps until the next
+                tick is due. The sleep uses the real time, whatever the
+                clock is
+      Modifies: [m_thread, m_bIsRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SimulationLoop::Start()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_bIsRunning)
+        {
+            return;
+        }
+
+        m_bIsRunning = true;
+        m_thread = std::thread([this]()
+        {
+            std::unique_lock<std::mutex> threadLock(m_mutex);
+            while (m_bIsRunning)
+            {
+                threadLock.unlock();
+                Pump();
+                threadLock.lock();
+
+                std::chrono::duration<double> untilNextTick((1.0 - m_timestep.GetAlpha()) * m_timestep.GetTickSeconds());
+                m_stopCondition.wait_for(threadLock, untilNextTick, [this]() { return !m_bIsRunning; });
+            }
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::Stop
+      Summary:  Wakes the thread up and joins it
+      Modifies: [m_thread, m_bIsRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SimulationLoop::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bIsRunning = false;
+        }
+        m_stopCondition.notify_all();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::GetAlpha
+      Summary:  Returns how far the clock is past the last tick, in
+                ticks. Includes the time since the last pump, so a
+                reader on another thread still moves smoothly between
+                two pumps
+      Returns:  double
+                  Fraction in [0, 1]
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double SimulationLoop::GetAlpha() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_bHasPumped)
+        {
+            return 1.0;
+        }
+
+        double sincePump = (std::max)(m_clock() - m_lastPumpTime, 0.0);
+        return (std::min)(m_timestep.GetAlpha() + sincePump / m_timestep.GetTickSeconds(), 1.0);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::GetNumTicks
+      Summary:  Returns the number of ticks run
+      Returns:  uint64_t
+                  Ticks since construction
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t SimulationLoop::GetNumTicks() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_timestep.GetNumTicks();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SimulationLoop::GetStateMutex
+      Summary:  Returns the mutex held while ticking. Lock it to read
+                the simulation states and GetAlpha together
+      Returns:  std::mutex&
+                  State mutex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::mutex& SimulationLoop::GetStateMutex()
+    {
+        return m_stateMutex;
+    }
+}
@@ -0,0 +1,144 @@
+/*+===================================================================
+  File:      FIXEDTIMESTEP.H
+
+  Summary:   FixedTimestep header file contains declaration of class
+             FixedTimestep used to turn variable frame times into
+             simulation ticks of a fixed length, and of class
+             SimulationLoop that runs those ticks from a clock. It only
+             depends on the standard library.
+
+  Classes:  FixedTimestep, SimulationLoop
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FixedTimestep
+      Summary:  Accumulates elapsed time and hands it out in whole
+                ticks. The time left over is the fraction of a tick the
+                display is ahead of the simulation, used to interpolate
+                between the last two simulation states. When more ticks
+                are due than the catch-up limit, the excess time is
+                dropped so a long stall does not snowball into longer
+                and longer frames
+      Methods:  Advance
+                  Adds elapsed time and returns the ticks to run
+                SetTickRate
+                  Changes the number of ticks per second
+                SetMaxTicksPerAdvance
+                  Changes the catch-up limit
+                GetTickSeconds
+                  Returns the length of a tick
+                GetAlpha
+                  Returns the fraction of a tick accumulated
+                GetNumTicks
+                  Returns the number of ticks handed out
+                GetDroppedSeconds
+                  Returns the time dropped by the catch-up limit
+                Reset
+                  Forgets the accumulated time
+                FixedTimestep
+                  Constructor.
+                ~FixedTimestep
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FixedTimestep
+    {
+    public:
+        FixedTimestep(double tickRate, uint32_t uMaxTicksPerAdvance);
+        FixedTimestep(const FixedTimestep& other) = default;
+        FixedTimestep(FixedTimestep&& other) = default;
+        FixedTimestep& operator=(const FixedTimestep& other) = default;
+        FixedTimestep& operator=(FixedTimestep&& other) = default;
+        ~FixedTimestep() = default;
+
+        uint32_t Advance(double elapsedSeconds);
+        void SetTickRate(double tickRate);
+        void SetMaxTicksPerAdvance(uint32_t uMaxTicksPerAdvance);
+        double GetTickSeconds() const;
+        double GetAlpha() const;
+        uint64_t GetNumTicks() const;
+        double GetDroppedSeconds() const;
+        void Reset();
+
+    private:
+        double m_tickSeconds;
+        uint32_t m_uMaxTicksPerAdvance;
+        double m_accumulatedSeconds;
+        uint64_t m_uNumTicks;
+        double m_droppedSeconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SimulationLoop
+      Summary:  Reads a clock and calls the tick function once per due
+                tick, either from Pump on the calling thread or from a
+                thread of its own. Ticks run while holding the state
+                mutex; a reader locks it to see the states and the
+                alpha of the same tick. The clock is a function so the
+                loop can be driven by a synthetic time
+      Methods:  SetTickFunction
+                  Sets the function called every tick
+                SetTickRate
+                  Changes the number of ticks per second
+                SetMaxTicksPerAdvance
+                  Changes the catch-up limit
+                Pump
+                  Runs the ticks due since the last pump
+                Start
+                  Starts pumping on a thread
+                Stop
+                  Stops the thread
+                GetAlpha
+                  Returns how far the clock is into the next tick
+                GetNumTicks
+                  Returns the number of ticks run
+                GetStateMutex
+                  Returns the mutex held while ticking
+                SimulationLoop
+                  Constructor.
+                ~SimulationLoop
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SimulationLoop
+    {
+    public:
+        SimulationLoop(double tickRate, uint32_t uMaxTicksPerAdvance, std::function<double()> clock = nullptr);
+        SimulationLoop(const SimulationLoop& other) = delete;
+        SimulationLoop(SimulationLoop&& other) = delete;
+        SimulationLoop& operator=(const SimulationLoop& other) = delete;
+        SimulationLoop& operator=(SimulationLoop&& other) = delete;
+        virtual ~SimulationLoop();
+
+        void SetTickFunction(std::function<void(double tickSeconds)> tickFunction);
+        void SetTickRate(double tickRate);
+        void SetMaxTicksPerAdvance(uint32_t uMaxTicksPerAdvance);
+        uint32_t Pump();
+        void Start();
+        void Stop();
+        double GetAlpha() const;
+        uint64_t GetNumTicks() const;
+        std::mutex& GetStateMutex();
+
+    private:
+        std::function<double()> m_clock;
+        std::function<void(double tickSeconds)> m_tickFunction;
+        mutable std::mutex m_mutex;
+        std::mutex m_stateMutex;
+        std::condition_variable m_stopCondition;
+        std::thread m_thread;
+        FixedTimestep m_timestep;
+        double m_lastPumpTime;
+        bool m_bHasPumped;
+        bool m_bIsRunning;
+    };
+}
@@ -0,0 +1,66 @@
+#include "Utility/Hash.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Hash::Fnv1a
+      Summary:  Continues an FNV-1a hash over a range of bytes
+      Args:     const void* pData
+                  First byte
+                size_t uSize
+                  Number of bytes
+                uint64_t uHash
+                  Running hash, the offset basis to start a new one
+      Returns:  uint64_t
+                  Hash
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t Hash::Fnv1a(const void* pData, size_t uSize, uint64_t uHash)
+    {
+        const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+        for (size_t i = 0u; i < uSize; ++i)
+        {
+            uHash ^= pBytes[i];
+            uHash *= FNV_PRIME;
+        }
+
+        return uHash;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Hash::Fnv1a
+      Summary:  Continues an FNV-1a hash over the characters of a
+                string
+      Args:     std::string_view sz
+                  String to hash
+                uint64_t uHash
+                  Running hash, the offset basis to start a new one
+      Returns:  uint64_t
+                  Hash
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t Hash::Fnv1a(std::string_view sz, uint64_t uHash)
+    {
+        return Fnv1a(sz.data(), sz.size(), uHash);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Hash::Combine
+      Summary:  Mixes the little endian bytes of a value into a running
+                hash
+      Args:     uint64_t uHash
+                  Running hash
+                uint64_t uValue
+                  Value to mix in
+      Returns:  uint64_t
+                  Hash
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t Hash::Combine(uint64_t uHash, uint64_t uValue)
+    {
+        for (uint32_t i = 0u; i < sizeof(uValue); ++i)
+        {
+            uHash ^= (uValue >> (i * 8u)) & 0xFFu;
+            uHash *= FNV_PRIME;
+        }
+
+        return uHash;
+    }
+}
@@ -0,0 +1,49 @@
+/*+===================================================================
+  File:      HASH.H
+
+  Summary:   Hash header file contains declaration of class Hash used
+             to build stable 64-bit keys of data that is persisted or
+             compared across runs. It only depends on the standard
+             library.
+
+  Classes:  Hash
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Hash
+      Summary:  64-bit FNV-1a hashing. The result only depends on the
+                bytes, never on the process or the platform, so it can
+                name files on disk
+      Methods:  Fnv1a
+                  Hashes a range of bytes
+                Combine
+                  Mixes a value into a running hash
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Hash
+    {
+    public:
+        static constexpr const uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+        static constexpr const uint64_t FNV_PRIME = 0x00000100000001B3ull;
+
+    public:
+        Hash() = delete;
+        Hash(const Hash& other) = delete;
+        Hash(Hash&& other) = delete;
+        Hash& operator=(const Hash& other) = delete;
+        Hash& operator=(Hash&& other) = delete;
+        ~Hash() = delete;
+
+        static uint64_t Fnv1a(const void* pData, size_t uSize, uint64_t uHash = FNV_OFFSET_BASIS);
+        static uint64_t Fnv1a(std::string_view sz, uint64_t uHash = FNV_OFFSET_BASIS);
+        static uint64_t Combine(uint64_t uHash, uint64_t uValue);
+    };
+}
@@ -0,0 +1,437 @@
+#include "Utility/JobSystem.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Utility/Profiler.h"
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   WorkerIdentity
+          Summary:  Job system the calling thread works for and the
+                    deque it owns there
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct WorkerIdentity
+        {
+            const JobSystem* pJobSystem = nullptr;
+            uint32_t uQueue = 0u;
+        };
+
+        thread_local WorkerIdentity t_worker;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::JobSystem
+      Summary:  Constructor. Starts the workers
+      Args:     uint32_t uNumWorkers
+                  Number of worker threads, 0 for one less than the
+                  hardware threads since the calling thread helps while
+                  waiting
+      Modifies: [m_aQueues, m_aWorkers, m_uNumQueued, m_uNumSleeping,
+                 m_uNumWaiting, m_sleepMutex, m_wakeCondition,
+                 m_bIsStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobSystem::JobSystem(uint32_t uNumWorkers)
+        : m_aQueues()
+        , m_aWorkers()
+        , m_uNumQueued(0u)
+        , m_uNumSleeping(0u)
+        , m_uNumWaiting(0u)
+        , m_sleepMutex()
+        , m_wakeCondition()
+        , m_bIsStopping(false)
+    {
+        if (uNumWorkers == 0u)
+        {
+            uNumWorkers = (std::max)(std::thread::hardware_concurrency(), 2u) - 1u;
+        }
+
+        // Deque 0 is shared by the threads outside the pool
+        m_aQueues.reserve(uNumWorkers + 1u);
+        for (uint32_t i = 0u; i <= uNumWorkers; ++i)
+        {
+            m_aQueues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        m_aWorkers.reserve(uNumWorkers);
+        for (uint32_t i = 0u; i < uNumWorkers; ++i)
+        {
+            m_aWorkers.emplace_back(&JobSystem::workerMain, this, i + 1u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::~JobSystem
+      Summary:  Destructor. Lets the workers drain the queued jobs and
+                joins them
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_bIsStopping = true;
+        }
+        m_wakeCondition.notify_all();
+
+        for (std::thread& worker : m_aWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::Schedule
+      Summary:  Creates a job that is queued once all its dependencies
+                are done, right away when they already are
+      Args:     std::function<void()> function
+                  Work of the job
+                const std::vector<JobHandle>& aDependencies
+                  Jobs that must finish first
+      Returns:  JobHandle
+                  Handle to wait on the job or depend on it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobHandle JobSystem::Schedule(std::function<void()> function, const std::vector<JobHandle>& aDependencies)
+    {
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+        job->function = std::move(function);
+        job->uNumPending.store(static_cast<uint32_t>(aDependencies.size()) + 1u, std::memory_order_relaxed);
+
+        for (const JobHandle& dependency : aDependencies)
+        {
+            bool bIsDone = true;
+            if (dependency.m_job)
+            {
+                std::lock_guard<std::mutex> lock(dependency.m_job->mutex);
+                bIsDone = dependency.m_job->bIsDone.load(std::memory_order_relaxed);
+                if (!bIsDone)
+                {
+                    dependency.m_job->aDependents.push_back(job);
+                }
+            }
+
+            if (bIsDone)
+            {
+                job->uNumPending.fetch_sub(1u, std::memory_order_acq_rel);
+            }
+        }
+
+        if (job->uNumPending.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        {
+            push(job);
+        }
+
+        return JobHandle(job);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::Wait
+      Summary:  Runs queued jobs on the calling thread until the job is
+                done. When nothing is queued, the thread sleeps like an
+                idle worker until a job is queued or a job finishes.
+                The waiter count is raised before the job is checked,
+                and finish reads it after marking the job done, so one
+                of the two always sees the other
+      Args:     const JobHandle& handle
+                  Job to wait on
+      Modifies: [m_uNumSleeping, m_uNumWaiting].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::Wait(const JobHandle& handle)
+    {
+        while (!handle.IsDone())
+        {
+            if (runOne())
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_uNumSleeping.fetch_add(1u);
+            m_uNumWaiting.fetch_add(1u);
+            m_wakeCondition.wait(lock, [this, &handle]() { return handle.IsDone() || m_uNumQueued.load() > 0u; });
+            m_uNumWaiting.fetch_sub(1u);
+            m_uNumSleeping.fetch_sub(1u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::ParallelFor
+      Summary:  Calls the function on every chunk of [0, uCount) and
+                returns once all are done. One job per thread claims
+                chunks until none are left, so uneven chunks balance
+                themselves. The calling thread takes part
+      Args:     uint32_t uCount
+                  Number of work items
+                uint32_t uGrainSize
+                  Number of items handed out at once
+                const std::function<void(uint32_t, uint32_t)>& function
+                  Function called with the begin and end of a chunk
+                uint32_t uMaxNumJobs
+                  Number of jobs including the caller, 0 for one per
+                  worker plus the caller
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::ParallelFor(uint32_t uCount, uint32_t uGrainSize, const std::function<void(uint32_t uBegin, uint32_t uEnd)>& function, uint32_t uMaxNumJobs)
+    {
+        if (uCount == 0u)
+        {
+            return;
+        }
+
+        uGrainSize = (std::max)(uGrainSize, 1u);
+        uint32_t uNumChunks = (uCount + uGrainSize - 1u) / uGrainSize;
+        if (uMaxNumJobs == 0u)
+        {
+            uMaxNumJobs = GetNumWorkers() + 1u;
+        }
+        uint32_t uNumJobs = (std::min)(uNumChunks, uMaxNumJobs);
+
+        if (uNumJobs <= 1u)
+        {
+            function(0u, uCount);
+            return;
+        }
+
+        std::atomic<uint32_t> uNextChunk(0u);
+        auto body = [&]()
+        {
+            for (uint32_t uChunk = uNextChunk.fetch_add(1u); uChunk < uNumChunks; uChunk = uNextChunk.fetch_add(1u))
+            {
+                uint32_t uBegin = uChunk * uGrainSize;
+                function(uBegin, (std::min)(uBegin + uGrainSize, uCount));
+            }
+        };
+
+        std::vector<JobHandle> aJobs;
+        aJobs.reserve(uNumJobs - 1u);
+        for (uint32_t i = 1u; i < uNumJobs; ++i)
+        {
+            aJobs.push_back(Schedule(body));
+        }
+
+        body();
+
+        for (const JobHandle& job : aJobs)
+        {
+            Wait(job);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::GetNumWorkers
+      Summary:  Returns the number of worker threads
+      Returns:  uint32_t
+                  Number of workers, not counting waiting threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t JobSystem::GetNumWorkers() const
+    {
+        return static_cast<uint32_t>(m_aWorkers.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::GetDefault
+      Summary:  Returns the job system shared by the library, created on
+                first use with one worker per spare hardware thread
+      Returns:  JobSystem&
+                  Shared job system
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobSystem& JobSystem::GetDefault()
+    {
+        static JobSystem jobSystem;
+        return jobSystem;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::push
+      Summary:  Queues a ready job on the deque of the calling thread
+                and wakes a sleeping thread. The job count changes
+                under the lock of the deque with the job itself, so it
+                never counts a job that was already taken. The sleeper
+                count is read after the job count is raised, and a
+                sleeper raises its count before reading the job count,
+                so one of the two always sees the other
+      Args:     std::shared_ptr<Job> job
+                  Job whose dependencies are done
+      Modifies: [m_aQueues, m_uNumQueued].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::push(std::shared_ptr<Job> job)
+    {
+        WorkQueue& queue = *m_aQueues[getQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+            m_uNumQueued.fetch_add(1u);
+        }
+
+        if (m_uNumSleeping.load() > 0u)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sleepMutex);
+            }
+            m_wakeCondition.notify_one();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::runOne
+      Summary:  Takes a job from the deque of the calling thread or
+                steals one, then runs it
+      Returns:  bool
+                  False when no job was queued anywhere
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool JobSystem::runOne()
+    {
+        std::shared_ptr<Job> job = take(getQueue());
+        if (!job)
+        {
+            return false;
+        }
+
+        job->function();
+        finish(job);
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::take
+      Summary:  Pops the newest job of a deque, or steals the oldest job
+                of the next deque that has one, and lowers the job
+                count under the same lock
+      Args:     uint32_t uQueue
+                  Deque of the calling thread
+      Modifies: [m_aQueues, m_uNumQueued].
+      Returns:  std::shared_ptr<Job>
+                  Job to run, null when every deque is empty
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<JobSystem::Job> JobSystem::take(uint32_t uQueue)
+    {
+        {
+            WorkQueue& queue = *m_aQueues[uQueue];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                std::shared_ptr<Job> job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                m_uNumQueued.fetch_sub(1u);
+                return job;
+            }
+        }
+
+        uint32_t uNumQueues = static_cast<uint32_t>(m_aQueues.size());
+        for (uint32_t i = 1u; i < uNumQueues; ++i)
+        {
+            WorkQueue& victim = *m_aQueues[(uQueue + i) % uNumQueues];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty())
+            {
+                std::shared_ptr<Job> job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                m_uNumQueued.fetch_sub(1u);
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::finish
+      Summary:  Marks a job done, wakes the threads sleeping in Wait
+                so the ones waiting on it return, and queues the
+                dependents it was the last dependency of
+      Args:     const std::shared_ptr<Job>& job
+                  Job that ran
+      Modifies: [job].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::finish(const std::shared_ptr<Job>& job)
+    {
+        std::vector<std::shared_ptr<Job>> aDependents;
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->function = nullptr;
+            aDependents.swap(job->aDependents);
+            job->bIsDone.store(true);
+        }
+
+        if (m_uNumWaiting.load() > 0u)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sleepMutex);
+            }
+            m_wakeCondition.notify_all();
+        }
+
+        for (std::shared_ptr<Job>& dependent : aDependents)
+        {
+            if (dependent->uNumPending.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            {
+                push(std::move(dependent));
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::workerMain
+      Summary:  Runs jobs, and sleeps while none are queued
+      Args:     uint32_t uQueue
+                  Deque owned by the worker
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::workerMain(uint32_t uQueue)
+    {
+        t_worker = WorkerIdentity{ .pJobSystem = this, .uQueue = uQueue };
+        Profiler::SetThreadName(("Worker " + std::to_string(uQueue)).c_str());
+
+        for (;;)
+        {
+            if (runOne())
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_uNumSleeping.fetch_add(1u);
+            m_wakeCondition.wait(lock, [this]() { return m_bIsStopping || m_uNumQueued.load() > 0u; });
+            m_uNumSleeping.fetch_sub(1u);
+
+            if (m_bIsStopping && m_uNumQueued.load() == 0u)
+            {
+                return;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::getQueue
+      Summary:  Returns the deque of the calling thread
+      Returns:  uint32_t
+                  Deque of the worker, 0 for threads outside the pool
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t JobSystem::getQueue() const
+    {
+        return t_worker.pJobSystem == this ? t_worker.uQueue : 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobHandle::JobHandle
+      Summary:  Constructor
+      Args:     std::shared_ptr<JobSystem::Job> job
+                  Scheduled job
+      Modifies: [m_job].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobHandle::JobHandle(std::shared_ptr<JobSystem::Job> job)
+        : m_job(std::move(job))
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobHandle::IsDone
+      Summary:  Returns whether the job ran
+      Returns:  bool
+                  True once the job finished, or for an empty handle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool JobHandle::IsDone() const
+    {
+        return !m_job || m_job->bIsDone.load();
+    }
+}
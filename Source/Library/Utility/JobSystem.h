@@ -0,0 +1,150 @@
+/*+===================================================================
+  File:      JOBSYSTEM.H
+
+  Summary:   JobSystem header file contains declaration of class
+             JobSystem used to run small jobs with dependencies on a
+             pool of worker threads, and of class JobHandle used to
+             wait on them. It only depends on the standard library.
+
+  Classes:  JobSystem, JobHandle
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace library
+{
+    class JobHandle;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    JobSystem
+      Summary:  Work-stealing scheduler. Every worker owns a deque: it
+                pushes and pops its own jobs at the back, so the most
+                recent and cache-warm work runs first, while idle
+                workers steal the oldest jobs from the front of the
+                others. Threads outside the pool share one more deque.
+                A job waits for its dependencies and is queued by the
+                last one to finish. Waiting threads run jobs while any
+                are queued and sleep otherwise, so jobs may schedule
+                and wait on other jobs
+      Methods:  Schedule
+                  Queues a job once its dependencies are done
+                Wait
+                  Runs jobs until the given one is done
+                ParallelFor
+                  Runs a function over a range on every worker
+                GetNumWorkers
+                  Returns the number of worker threads
+                GetDefault
+                  Returns the job system shared by the library
+                JobSystem
+                  Constructor.
+                ~JobSystem
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class JobSystem
+    {
+    public:
+        explicit JobSystem(uint32_t uNumWorkers = 0u);
+        JobSystem(const JobSystem& other) = delete;
+        JobSystem(JobSystem&& other) = delete;
+        JobSystem& operator=(const JobSystem& other) = delete;
+        JobSystem& operator=(JobSystem&& other) = delete;
+        virtual ~JobSystem();
+
+        JobHandle Schedule(std::function<void()> function, const std::vector<JobHandle>& aDependencies = {});
+        void Wait(const JobHandle& handle);
+        void ParallelFor(uint32_t uCount, uint32_t uGrainSize, const std::function<void(uint32_t uBegin, uint32_t uEnd)>& function, uint32_t uMaxNumJobs = 0u);
+        uint32_t GetNumWorkers() const;
+
+        static JobSystem& GetDefault();
+
+    private:
+        friend class JobHandle;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Job
+          Summary:  Function to run and the jobs waiting for it.
+                    uNumPending counts the unfinished dependencies plus
+                    one held while scheduling
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Job
+        {
+            std::function<void()> function;
+            std::atomic<uint32_t> uNumPending{ 0u };
+            std::atomic<bool> bIsDone{ false };
+            std::mutex mutex;
+            std::vector<std::shared_ptr<Job>> aDependents;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   WorkQueue
+          Summary:  Deque of ready jobs. The owner works at the back,
+                    thieves at the front
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Job>> jobs;
+        };
+
+        void push(std::shared_ptr<Job> job);
+        bool runOne();
+        std::shared_ptr<Job> take(uint32_t uQueue);
+        void finish(const std::shared_ptr<Job>& job);
+        void workerMain(uint32_t uQueue);
+        uint32_t getQueue() const;
+
+    private:
+        std::vector<std::unique_ptr<WorkQueue>> m_aQueues;
+        std::vector<std::thread> m_aWorkers;
+        std::atomic<uint32_t> m_uNumQueued;
+        std::atomic<uint32_t> m_uNumSleeping;
+        std::atomic<uint32_t> m_uNumWaiting;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeCondition;
+        bool m_bIsStopping;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    JobHandle
+      Summary:  Refers to a scheduled job, to wait on it or to make it a
+                dependency. A default constructed handle counts as done
+      Methods:  IsDone
+                  Returns whether the job ran
+                JobHandle
+                  Constructor.
+                ~JobHandle
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+        JobHandle(const JobHandle& other) = default;
+        JobHandle(JobHandle&& other) = default;
+        JobHandle& operator=(const JobHandle& other) = default;
+        JobHandle& operator=(JobHandle&& other) = default;
+        ~JobHandle() = default;
+
+        bool IsDone() const;
+
+    private:
+        friend class JobSystem;
+
+        explicit JobHandle(std::shared_ptr<JobSystem::Job> job);
+
+    private:
+        std::shared_ptr<JobSystem::Job> m_job;
+    };
+}
@@ -0,0 +1,122 @@
+#include "Utility/MappedFile.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::MappedFile
+      Summary:  Constructor
+      Args:     const std::filesystem::path& filePath
+                  Path to the file to map
+      Modifies: [m_filePath, m_hFile, m_hMapping, m_pData, m_uSize].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MappedFile::MappedFile(_In_ const std::filesystem::path& filePath)
+        : m_filePath(filePath)
+        , m_hFile(INVALID_HANDLE_VALUE)
+        , m_hMapping(nullptr)
+        , m_pData(nullptr)
+        , m_uSize(0u)
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::~MappedFile
+      Summary:  Destructor. Unmaps the view and closes the handles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MappedFile::~MappedFile()
+    {
+        if (m_pData)
+        {
+            UnmapViewOfFile(m_pData);
+        }
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::Initialize
+      Summary:  Opens the file for shared reading and maps all of it.
+                The sequential scan hint lets the OS read ahead while
+                the pages are consumed
+      Modifies: [m_hFile, m_hMapping, m_pData, m_uSize].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MappedFile::Initialize()
+    {
+        if (m_pData)
+        {
+            return S_OK;
+        }
+
+        m_hFile = CreateFile(
+            m_filePath.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        // Empty files cannot be mapped, and larger than the address space cannot be viewed whole
+        if (fileSize.QuadPart == 0 || static_cast<ULONGLONG>(fileSize.QuadPart) > static_cast<ULONGLONG>(SIZE_MAX))
+        {
+            return E_FAIL;
+        }
+
+        m_hMapping = CreateFileMapping(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        m_pData = static_cast<const BYTE*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pData)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        m_uSize = static_cast<SIZE_T>(fileSize.QuadPart);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::GetData
+      Summary:  Returns the first byte of the view
+      Returns:  const BYTE*
+                  View of the file, nullptr before Initialize succeeds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BYTE* MappedFile::GetData() const
+    {
+        return m_pData;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MappedFile::GetSize
+      Summary:  Returns the size of the file
+      Returns:  SIZE_T
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SIZE_T MappedFile::GetSize() const
+    {
+        return m_uSize;
+    }
+}
@@ -0,0 +1,58 @@
+/*+===================================================================
+  File:      MAPPEDFILE.H
+
+  Summary:   MappedFile header file contains declaration of class
+             MappedFile used to read files through a read-only memory
+             mapping instead of copying them to the heap.
+
+  Classes:  MappedFile
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MappedFile
+      Summary:  Maps a whole file read-only into the address space.
+                Pages are brought in by the OS on first touch, so the
+                file is never copied into a buffer of ours. The view
+                stays valid until the object is destroyed
+      Methods:  Initialize
+                  Opens and maps the file
+                GetData
+                  Returns the first byte of the view
+                GetSize
+                  Returns the size of the file
+                MappedFile
+                  Constructor.
+                ~MappedFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MappedFile
+    {
+    public:
+        MappedFile() = delete;
+        explicit MappedFile(_In_ const std::filesystem::path& filePath);
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile(MappedFile&& other) = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+        MappedFile& operator=(MappedFile&& other) = delete;
+        virtual ~MappedFile();
+
+        HRESULT Initialize();
+
+        const BYTE* GetData() const;
+        SIZE_T GetSize() const;
+
+    private:
+        std::filesystem::path m_filePath;
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+        const BYTE* m_pData;
+        SIZE_T m_uSize;
+    };
+}
@@ -0,0 +1,86 @@
+#include "Utility/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Parallel::For
+      Summary:  Calls the function on every chunk of [0, uCount). The
+                call returns once every chunk is done. Runs inline when
+                the range fits in a single chunk
+      Args:     uint32_t uCount
+                  Number of work items
+                uint32_t uGrainSize
+                  Number of items handed to a thread at once
+                const std::function<void(uint32_t, uint32_t)>& function
+                  Function called with the begin and end of a chunk
+                uint32_t uNumThreads
+                  Number of threads to use, 0 for GetNumWorkers
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Parallel::For(
+        uint32_t uCount,
+        uint32_t uGrainSize,
+        const std::function<void(uint32_t uBegin, uint32_t uEnd)>& function,
+        uint32_t uNumThreads
+    )
+    {
+        if (uCount == 0u)
+        {
+            return;
+        }
+
+        uGrainSize = std::max(uGrainSize, 1u);
+        uint32_t uNumChunks = (uCount + uGrainSize - 1u) / uGrainSize;
+
+        if (uNumThreads == 0u)
+        {
+            uNumThreads = GetNumWorkers();
+        }
+        uNumThreads = std::min(uNumThreads, uNumChunks);
+
+        if (uNumThreads <= 1u)
+        {
+            function(0u, uCount);
+            return;
+        }
+
+        std::atomic<uint32_t> uNextChunk(0u);
+        auto worker = [&]()
+        {
+            for (uint32_t uChunk = uNextChunk.fetch_add(1u); uChunk < uNumChunks; uChunk = uNextChunk.fetch_add(1u))
+            {
+                uint32_t uBegin = uChunk * uGrainSize;
+                function(uBegin, std::min(uBegin + uGrainSize, uCount));
+            }
+        };
+
+        std::vector<std::thread> aThreads;
+        aThreads.reserve(uNumThreads - 1u);
+        for (uint32_t i = 1u; i < uNumThreads; ++i)
+        {
+            aThreads.emplace_back(worker);
+        }
+
+        worker();
+
+        for (std::thread& thread : aThreads)
+        {
+            thread.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Parallel::GetNumWorkers
+      Summary:  Returns the number of hardware threads
+      Returns:  uint32_t
+                  Number of threads, at least 1
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t Parallel::GetNumWorkers()
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+}
@@ -0,0 +1,49 @@
+/*+===================================================================
+  File:      PARALLEL.H
+
+  Summary:   Parallel header file contains declaration of class
+             Parallel used to split CPU work such as texture encoding
+             over the hardware threads. It only depends on the
+             standard library.
+
+  Classes:  Parallel
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Parallel
+      Summary:  Runs a range of independent work items on worker
+                threads. The range is cut into chunks of the grain size
+                that the workers and the calling thread claim one after
+                another, so uneven items balance themselves
+      Methods:  For
+                  Calls the function on every chunk of the range
+                GetNumWorkers
+                  Returns the number of threads For uses by default
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Parallel
+    {
+    public:
+        Parallel() = delete;
+        Parallel(const Parallel& other) = delete;
+        Parallel(Parallel&& other) = delete;
+        Parallel& operator=(const Parallel& other) = delete;
+        Parallel& operator=(Parallel&& other) = delete;
+        ~Parallel() = delete;
+
+        static void For(
+            uint32_t uCount,
+            uint32_t uGrainSize,
+            const std::function<void(uint32_t uBegin, uint32_t uEnd)>& function,
+            uint32_t uNumThreads = 0u
+        );
+        static uint32_t GetNumWorkers();
+    };
+}
@@ -0,0 +1,485 @@
+#include "Utility/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ZoneEvent
+          Summary:  Closed zone, in nanoseconds since the profiler epoch
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ZoneEvent
+        {
+            const char* pszName;
+            uint64_t uBeginNs;
+            uint64_t uEndNs;
+            uint32_t uDepth;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Track
+          Summary:  Ring buffer of the zones of one timeline and the stack
+                    of its open zones. The ring and its counters are
+                    guarded by the mutex of the track, which only the
+                    export contends with the recording thread; the
+                    stack is only used by that thread. uNumWritten
+                    counts every zone ever recorded; the ring keeps the
+                    last uCapacity of them
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Track
+        {
+            explicit Track(uint32_t uTrackCapacity)
+                : szName()
+                , mutex()
+                , aEvents(std::make_unique<ZoneEvent[]>(uTrackCapacity))
+                , uCapacity(uTrackCapacity)
+                , uNumWritten(0u)
+                , uNumCleared(0u)
+                , bIsInUse(true)
+                , apszOpenNames{ nullptr }
+                , auOpenBeginNs{ 0u }
+                , uDepth(0u)
+            { }
+
+            std::string szName;
+            std::mutex mutex;
+            std::unique_ptr<ZoneEvent[]> aEvents;
+            uint32_t uCapacity;
+            uint64_t uNumWritten;
+            uint64_t uNumCleared;
+            std::atomic<bool> bIsInUse;
+            const char* apszOpenNames[Profiler::MAX_DEPTH];
+            uint64_t auOpenBeginNs[Profiler::MAX_DEPTH];
+            uint32_t uDepth;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ProfilerState
+          Summary:  Tracks of every thread that recorded a zone. Tracks
+                    are never freed; the track of an exited thread is
+                    handed to the next new thread, so short lived
+                    workers do not grow the list
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ProfilerState
+        {
+            std::atomic<bool> bIsEnabled{ false };
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Track>> aTracks;
+            std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   ThreadTrack
+          Summary:  Track of the calling thread, given back when the
+                    thread exits
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct ThreadTrack
+        {
+            ~ThreadTrack()
+            {
+                if (pTrack)
+                {
+                    pTrack->bIsInUse.store(false, std::memory_order_release);
+                }
+            }
+
+            Track* pTrack = nullptr;
+        };
+
+        thread_local ThreadTrack t_threadTrack;
+
+        ProfilerState& getState()
+        {
+            static ProfilerState state;
+            return state;
+        }
+
+        Track& getThreadTrack()
+        {
+            if (t_threadTrack.pTrack)
+            {
+                return *t_threadTrack.pTrack;
+            }
+
+            ProfilerState& state = getState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            for (const std::unique_ptr<Track>& track : state.aTracks)
+            {
+                bool bIsInUse = false;
+                if (track->bIsInUse.compare_exchange_strong(bIsInUse, true, std::memory_order_acquire))
+                {
+                    track->szName = "Thread";
+                    track->uDepth = 0u;
+                    t_threadTrack.pTrack = track.get();
+                    return *track;
+                }
+            }
+
+            state.aTracks.push_back(std::make_unique<Track>(Profiler::NUM_EVENTS_PER_TRACK));
+            state.aTracks.back()->szName = "Thread";
+            t_threadTrack.pTrack = state.aTracks.back().get();
+            return *t_threadTrack.pTrack;
+        }
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   TrackSnapshot
+          Summary:  Copy of the name and the zones of a track, taken
+                    under its lock so the export never reads a zone
+                    being written
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct TrackSnapshot
+        {
+            std::string szName;
+            std::vector<ZoneEvent> aEvents;
+        };
+
+        void record(Track& track, const char* pszName, uint64_t uBeginNs, uint64_t uEndNs, uint32_t uDepth)
+        {
+            std::lock_guard<std::mutex> lock(track.mutex);
+            track.aEvents[track.uNumWritten % track.uCapacity] = ZoneEvent{ .pszName = pszName, .uBeginNs = uBeginNs, .uEndNs = uEndNs, .uDepth = uDepth };
+            ++track.uNumWritten;
+        }
+
+        void beginZone(Track& track, const char* pszName)
+        {
+            if (track.uDepth < Profiler::MAX_DEPTH)
+            {
+                track.apszOpenNames[track.uDepth] = pszName;
+                track.auOpenBeginNs[track.uDepth] = Profiler::GetTimeNs();
+            }
+            ++track.uDepth;
+        }
+
+        void endZone(Track& track)
+        {
+            if (track.uDepth == 0u)
+            {
+                return;
+            }
+
+            --track.uDepth;
+            if (track.uDepth < Profiler::MAX_DEPTH)
+            {
+                record(track, track.apszOpenNames[track.uDepth], track.auOpenBeginNs[track.uDepth], Profiler::GetTimeNs(), track.uDepth);
+            }
+        }
+
+        void writeJsonString(std::ofstream& stream, const char* psz)
+        {
+            stream << '"';
+            for (; *psz != '\0'; ++psz)
+            {
+                char c = *psz;
+                if (c == '"' || c == '\\')
+                {
+                    stream << '\\' << c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20u)
+                {
+                    stream << ' ';
+                }
+                else
+                {
+                    stream << c;
+                }
+            }
+            stream << '"';
+        }
+
+        void writeMicroseconds(std::ofstream& stream, uint64_t uNs)
+        {
+            // Trace times are microseconds; keep the nanoseconds as exact decimals
+            char szFraction[4] =
+            {
+                static_cast<char>('0' + uNs / 100u % 10u),
+                static_cast<char>('0' + uNs / 10u % 10u),
+                static_cast<char>('0' + uNs % 10u),
+                '\0'
+            };
+            stream << uNs / 1000u << '.' << szFraction;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::SetEnabled
+      Summary:  Starts or stops recording zones
+      Args:     bool bIsEnabled
+                  Whether zones are recorded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::SetEnabled(bool bIsEnabled)
+    {
+        getState().bIsEnabled.store(bIsEnabled, std::memory_order_relaxed);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::IsEnabled
+      Summary:  Returns whether zones are recorded
+      Returns:  bool
+                  True when enabled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool Profiler::IsEnabled()
+    {
+        return getState().bIsEnabled.load(std::memory_order_relaxed);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::BeginZone
+      Summary:  Opens a zone nested in the open zones of the calling
+                thread. Zones deeper than MAX_DEPTH are not recorded
+      Args:     const char* pszName
+                  Name of the zone, kept as a pointer
+      Returns:  bool
+                  True when the zone was opened and EndZone has to be
+                  called, false when the profiler is disabled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool Profiler::BeginZone(const char* pszName)
+    {
+        if (!IsEnabled())
+        {
+            return false;
+        }
+
+        beginZone(getThreadTrack(), pszName);
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::EndZone
+      Summary:  Closes the innermost open zone of the calling thread and
+                records it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::EndZone()
+    {
+        endZone(getThreadTrack());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::SetThreadName
+      Summary:  Names the track of the calling thread in the trace
+      Args:     const char* pszName
+                  Name of the thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::SetThreadName(const char* pszName)
+    {
+        Track& track = getThreadTrack();
+
+        std::lock_guard<std::mutex> lock(getState().mutex);
+        track.szName = pszName;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::AddTrack
+      Summary:  Creates a track that no thread records into, for zones
+                timed by something else such as the GPU
+      Args:     const char* pszName
+                  Name of the track
+      Returns:  uint32_t
+                  Track to pass to AddZone
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t Profiler::AddTrack(const char* pszName)
+    {
+        ProfilerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        state.aTracks.push_back(std::make_unique<Track>(NUM_EVENTS_PER_TRACK));
+        state.aTracks.back()->szName = pszName;
+        return static_cast<uint32_t>(state.aTracks.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::AddZone
+      Summary:  Records a zone timed elsewhere
+      Args:     uint32_t uTrack
+                  Track returned by AddTrack
+                const char* pszName
+                  Name of the zone, kept as a pointer
+                uint64_t uBeginNs
+                  Start, in the time base of GetTimeNs
+                uint64_t uEndNs
+                  End, in the time base of GetTimeNs
+                uint32_t uDepth
+                  Number of zones the zone is nested in
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::AddZone(uint32_t uTrack, const char* pszName, uint64_t uBeginNs, uint64_t uEndNs, uint32_t uDepth)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        ProfilerState& state = getState();
+        Track* pTrack = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (uTrack >= state.aTracks.size())
+            {
+                return;
+            }
+            pTrack = state.aTracks[uTrack].get();
+        }
+
+        record(*pTrack, pszName, uBeginNs, uEndNs, uDepth);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::GetTimeNs
+      Summary:  Returns the time zones are measured with
+      Returns:  uint64_t
+                  Nanoseconds since the profiler was first used
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint64_t Profiler::GetTimeNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - getState().epoch).count());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::MeasureZoneOverhead
+      Summary:  Times empty zones recorded into a scratch track, so the
+                trace of the calling thread is left untouched
+      Args:     uint32_t uNumZones
+                  Number of zones to average over
+      Returns:  double
+                  Nanoseconds spent opening and closing one zone
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double Profiler::MeasureZoneOverhead(uint32_t uNumZones)
+    {
+        if (uNumZones == 0u)
+        {
+            return 0.0;
+        }
+
+        Track scratch(256u);
+        Track* pThreadTrack = t_threadTrack.pTrack;
+        t_threadTrack.pTrack = &scratch;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0u; i < uNumZones; ++i)
+        {
+            beginZone(getThreadTrack(), "ProfilerOverhead");
+            endZone(getThreadTrack());
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        t_threadTrack.pTrack = pThreadTrack;
+
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / static_cast<double>(uNumZones);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::ExportChromeTrace
+      Summary:  Writes the zones of every track as complete events of
+                the Chrome trace format, readable by chrome://tracing
+                and Perfetto. Threads may keep recording meanwhile:
+                each track is copied under its lock first, and the
+                copies are written once every lock is released. The
+                measured zone overhead is written with the trace
+      Args:     const std::filesystem::path& filePath
+                  File to write
+      Returns:  bool
+                  False when the file can't be written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool Profiler::ExportChromeTrace(const std::filesystem::path& filePath)
+    {
+        double zoneOverheadNs = MeasureZoneOverhead(10000u);
+
+        std::vector<TrackSnapshot> aSnapshots;
+        {
+            ProfilerState& state = getState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+
+            aSnapshots.resize(state.aTracks.size());
+            for (size_t i = 0u; i < state.aTracks.size(); ++i)
+            {
+                Track& track = *state.aTracks[i];
+                TrackSnapshot& snapshot = aSnapshots[i];
+                snapshot.szName = track.szName;
+
+                std::lock_guard<std::mutex> trackLock(track.mutex);
+                uint64_t uFirst = (std::max)(track.uNumCleared, track.uNumWritten > track.uCapacity ? track.uNumWritten - track.uCapacity : 0u);
+                snapshot.aEvents.reserve(static_cast<size_t>(track.uNumWritten - uFirst));
+                for (uint64_t uIndex = uFirst; uIndex < track.uNumWritten; ++uIndex)
+                {
+                    snapshot.aEvents.push_back(track.aEvents[uIndex % track.uCapacity]);
+                }
+            }
+        }
+
+        std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            return false;
+        }
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"zoneOverheadNs\":" << zoneOverheadNs << "},\"traceEvents\":[";
+
+        for (size_t i = 0u; i < aSnapshots.size(); ++i)
+        {
+            stream << (i == 0u ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":";
+            writeJsonString(stream, aSnapshots[i].szName.c_str());
+            stream << "}}";
+            stream << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"sort_index\":" << i << "}}";
+
+            for (const ZoneEvent& event : aSnapshots[i].aEvents)
+            {
+                stream << ",\n{\"name\":";
+                writeJsonString(stream, event.pszName);
+                stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << i << ",\"ts\":";
+                writeMicroseconds(stream, event.uBeginNs);
+                stream << ",\"dur\":";
+                writeMicroseconds(stream, event.uEndNs - event.uBeginNs);
+                stream << ",\"args\":{\"depth\":" << event.uDepth << "}}";
+            }
+        }
+
+        stream << "\n]}\n";
+        return static_cast<bool>(stream);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Profiler::Clear
+      Summary:  Forgets the zones recorded so far. Open zones are kept
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Profiler::Clear()
+    {
+        ProfilerState& state = getState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        for (const std::unique_ptr<Track>& track : state.aTracks)
+        {
+            std::lock_guard<std::mutex> trackLock(track->mutex);
+            track->uNumCleared = track->uNumWritten;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ProfileZone::ProfileZone
+      Summary:  Constructor. Opens a zone
+      Args:     const char* pszName
+                  Name of the zone, a string literal
+      Modifies: [m_bIsOpen].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ProfileZone::ProfileZone(const char* pszName)
+        : m_bIsOpen(Profiler::BeginZone(pszName))
+    { }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ProfileZone::~ProfileZone
+      Summary:  Destructor. Closes the zone when it was opened
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ProfileZone::~ProfileZone()
+    {
+        if (m_bIsOpen)
+        {
+            Profiler::EndZone();
+        }
+    }
+}
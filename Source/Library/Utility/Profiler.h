@@ -0,0 +1,108 @@
+/*+===================================================================
+  File:      PROFILER.H
+
+  Summary:   Profiler header file contains declaration of class
+             Profiler used to record where the time of a frame goes,
+             and of class ProfileZone that times a scope. It only
+             depends on the standard library.
+
+  Classes:  Profiler, ProfileZone
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope. The name must be a string literal
+#define PROFILE_ZONE(pszName) library::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(pszName)
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Profiler
+      Summary:  Records nested timed zones into a ring buffer per
+                track, so only the oldest zones are lost when a buffer
+                wraps. Every thread records into its own track, whose
+                lock is only contended while the trace is exported.
+                Other tracks, such as the GPU timeline, are filled
+                with zones timed elsewhere. Zone names are kept as
+                pointers and must outlive the profiler
+      Methods:  SetEnabled
+                  Starts or stops recording
+                IsEnabled
+                  Returns whether zones are recorded
+                BeginZone
+                  Opens a zone on the track of the calling thread
+                EndZone
+                  Closes the innermost zone of the calling thread
+                SetThreadName
+                  Names the track of the calling thread
+                AddTrack
+                  Creates a track filled with AddZone
+                AddZone
+                  Records a zone timed elsewhere
+                GetTimeNs
+                  Returns the time zones are measured with
+                MeasureZoneOverhead
+                  Returns the cost of recording one zone
+                ExportChromeTrace
+                  Writes the recorded zones in the Chrome trace format
+                Clear
+                  Forgets the recorded zones
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Profiler
+    {
+    public:
+        static constexpr uint32_t MAX_DEPTH = 64u;
+        static constexpr uint32_t NUM_EVENTS_PER_TRACK = 1u << 16u;
+
+        Profiler() = delete;
+        Profiler(const Profiler& other) = delete;
+        Profiler(Profiler&& other) = delete;
+        Profiler& operator=(const Profiler& other) = delete;
+        Profiler& operator=(Profiler&& other) = delete;
+        ~Profiler() = delete;
+
+        static void SetEnabled(bool bIsEnabled);
+        static bool IsEnabled();
+        static bool BeginZone(const char* pszName);
+        static void EndZone();
+        static void SetThreadName(const char* pszName);
+        static uint32_t AddTrack(const char* pszName);
+        static void AddZone(uint32_t uTrack, const char* pszName, uint64_t uBeginNs, uint64_t uEndNs, uint32_t uDepth);
+        static uint64_t GetTimeNs();
+        static double MeasureZoneOverhead(uint32_t uNumZones);
+        static bool ExportChromeTrace(const std::filesystem::path& filePath);
+        static void Clear();
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ProfileZone
+      Summary:  Opens a zone on construction and closes it on
+                destruction. A zone opened while the profiler was
+                disabled is not closed either, so toggling the profiler
+                mid-frame keeps the nesting balanced
+      Methods:  ProfileZone
+                  Constructor.
+                ~ProfileZone
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ProfileZone
+    {
+    public:
+        explicit ProfileZone(const char* pszName);
+        ProfileZone(const ProfileZone& other) = delete;
+        ProfileZone(ProfileZone&& other) = delete;
+        ProfileZone& operator=(const ProfileZone& other) = delete;
+        ProfileZone& operator=(ProfileZone&& other) = delete;
+        ~ProfileZone();
+
+    private:
+        bool m_bIsOpen;
+    };
+}
@@ -0,0 +1,65 @@
+#include "Utility/StringId.h"
+
+#include <cassert>
+#include <mutex>
+#include <string>
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   InternTable
+          Summary:  Strings of the interned names by hash
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct InternTable
+        {
+            std::mutex mutex;
+            std::unordered_map<uint64_t, std::wstring> strings;
+        };
+
+        InternTable& getInternTable()
+        {
+            static InternTable internTable;
+            return internTable;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StringId::Intern
+      Summary:  Hashes a name and keeps its string for GetString. Meant
+                for load time; lookups only need the constructor
+      Args:     std::wstring_view szName
+                  Name
+      Returns:  StringId
+                  Id of the name
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StringId StringId::Intern(std::wstring_view szName)
+    {
+        StringId id(szName);
+
+        InternTable& internTable = getInternTable();
+        std::lock_guard<std::mutex> lock(internTable.mutex);
+
+        auto [it, bIsNew] = internTable.strings.try_emplace(id.m_uHash, szName);
+        assert((bIsNew || it->second == szName) && "Two names have the same StringId");
+        (void)it;
+
+        return id;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StringId::GetString
+      Summary:  Returns the string of an interned name
+      Returns:  const wchar_t*
+                  Name, empty when it was never interned
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const wchar_t* StringId::GetString() const
+    {
+        InternTable& internTable = getInternTable();
+        std::lock_guard<std::mutex> lock(internTable.mutex);
+
+        auto it = internTable.strings.find(m_uHash);
+        return it != internTable.strings.end() ? it->second.c_str() : L"";
+    }
+}
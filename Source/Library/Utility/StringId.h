@@ -0,0 +1,259 @@
+/*+===================================================================
+  File:      STRINGID.H
+
+  Summary:   StringId header file contains declaration of class
+             StringId used to name resources by a 64-bit hash instead
+             of a string, and of class ResourceTable that stores named
+             resources in a dense array. It only depends on the
+             standard library.
+
+  Classes:  StringId, ResourceTable
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StringId
+      Summary:  FNV-1a hash of the UTF-16 code units of a name, so that
+                comparing and hashing a name costs as much as an
+                integer. The hash is constexpr: names written as
+                literals, L"Name"_id, are hashed by the compiler.
+                Intern also keeps the string so it can be read back in
+                messages, and reports two names that hash alike
+      Methods:  Intern
+                  Hashes a name and keeps its string
+                GetString
+                  Returns the interned string of the name
+                GetHash
+                  Returns the hash
+                IsValid
+                  Returns whether the id names something
+                StringId
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StringId
+    {
+    public:
+        static constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+        static constexpr uint64_t FNV_PRIME = 0x00000100000001B3ull;
+
+    public:
+        constexpr StringId()
+            : m_uHash(0u)
+        { }
+
+        constexpr explicit StringId(std::wstring_view szName)
+            : m_uHash(hash(szName))
+        { }
+
+        constexpr StringId(const StringId& other) = default;
+        constexpr StringId& operator=(const StringId& other) = default;
+        ~StringId() = default;
+
+        static StringId Intern(std::wstring_view szName);
+        const wchar_t* GetString() const;
+
+        constexpr uint64_t GetHash() const
+        {
+            return m_uHash;
+        }
+
+        constexpr bool IsValid() const
+        {
+            return m_uHash != 0u;
+        }
+
+        constexpr bool operator==(const StringId& other) const = default;
+
+    private:
+        static constexpr uint64_t hash(std::wstring_view szName)
+        {
+            // Hash the code units as UTF-16 little endian, so a name has
+            // the same id whatever the size of wchar_t
+            uint64_t uHash = FNV_OFFSET_BASIS;
+            for (wchar_t ch : szName)
+            {
+                uHash = (uHash ^ (static_cast<uint64_t>(ch) & 0xFFu)) * FNV_PRIME;
+                uHash = (uHash ^ ((static_cast<uint64_t>(ch) >> 8u) & 0xFFu)) * FNV_PRIME;
+            }
+
+            return uHash;
+        }
+
+    private:
+        uint64_t m_uHash;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: operator""_id
+      Summary:  Hashes a name literal at compile time
+      Args:     const wchar_t* pszName
+                  Name
+                size_t uLength
+                  Number of characters
+      Returns:  StringId
+                  Id of the name
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    consteval StringId operator""_id(const wchar_t* pszName, size_t uLength)
+    {
+        return StringId(std::wstring_view(pszName, uLength));
+    }
+}
+
+template <>
+struct std::hash<library::StringId>
+{
+    size_t operator()(const library::StringId& id) const noexcept
+    {
+        return static_cast<size_t>(id.GetHash());
+    }
+};
+
+namespace library
+{
+    constexpr uint32_t INVALID_RESOURCE_HANDLE = 0xFFFFFFFFu;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ResourceTable
+      Summary:  Named resources in a dense array. Adding a resource
+                returns its handle, the index into the array, which
+                stays valid since resources are never removed. Names
+                are only looked up when resolving a handle; per frame
+                code iterates the array or indexes it by handle
+      Methods:  Add
+                  Adds a resource under a name
+                Find
+                  Returns the handle of a name
+                TryGet
+                  Returns the resource of a name, if any
+                Contains
+                  Returns whether a name is in the table
+                Get
+                  Returns the resource of a handle
+                GetName
+                  Returns the name of a handle
+                GetSize
+                  Returns the number of resources
+                begin
+                  Returns an iterator to the first resource
+                end
+                  Returns an iterator past the last resource
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <class T>
+    class ResourceTable
+    {
+    public:
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceTable::Add
+          Summary:  Adds a resource under a name
+          Args:     StringId name
+                      Name of the resource
+                    T resource
+                      Resource
+          Returns:  uint32_t
+                      Handle of the resource, INVALID_RESOURCE_HANDLE when the
+                      name is taken
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        uint32_t Add(StringId name, T resource)
+        {
+            uint32_t uHandle = static_cast<uint32_t>(m_aResources.size());
+            if (!m_handles.try_emplace(name, uHandle).second)
+            {
+                return INVALID_RESOURCE_HANDLE;
+            }
+
+            m_aResources.push_back(std::move(resource));
+            m_aNames.push_back(name);
+
+            return uHandle;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceTable::Find
+          Summary:  Returns the handle of a name
+          Args:     StringId name
+                      Name to look up
+          Returns:  uint32_t
+                      Handle, INVALID_RESOURCE_HANDLE when not found
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        uint32_t Find(StringId name) const
+        {
+            auto it = m_handles.find(name);
+            return it != m_handles.end() ? it->second : INVALID_RESOURCE_HANDLE;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceTable::TryGet
+          Summary:  Returns the resource of a name
+          Args:     StringId name
+                      Name to look up
+          Returns:  T*
+                      Resource, null when not found
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        T* TryGet(StringId name)
+        {
+            uint32_t uHandle = Find(name);
+            return uHandle != INVALID_RESOURCE_HANDLE ? &m_aResources[uHandle] : nullptr;
+        }
+
+        bool Contains(StringId name) const
+        {
+            return m_handles.contains(name);
+        }
+
+        T& Get(uint32_t uHandle)
+        {
+            return m_aResources[uHandle];
+        }
+
+        const T& Get(uint32_t uHandle) const
+        {
+            return m_aResources[uHandle];
+        }
+
+        StringId GetName(uint32_t uHandle) const
+        {
+            return m_aNames[uHandle];
+        }
+
+        uint32_t GetSize() const
+        {
+            return static_cast<uint32_t>(m_aResources.size());
+        }
+
+        typename std::vector<T>::iterator begin()
+        {
+            return m_aResources.begin();
+        }
+
+        typename std::vector<T>::iterator end()
+        {
+            return m_aResources.end();
+        }
+
+        typename std::vector<T>::const_iterator begin() const
+        {
+            return m_aResources.begin();
+        }
+
+        typename std::vector<T>::const_iterator end() const
+        {
+            return m_aResources.end();
+        }
+
+    private:
+        std::vector<T> m_aResources;
+        std::vector<StringId> m_aNames;
+        std::unordered_map<StringId, uint32_t> m_handles;
+    };
+}
@@ -0,0 +1,97 @@
+#include "Utility/TaskGraph.h"
+
+#include <cassert>
+
+#include "Utility/Profiler.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TaskGraph::AddTask
+      Summary:  Adds a task. A dependency on a task not added yet is a
+                wiring error: it asserts, and the task is not added
+      Args:     const char* pszName
+                  Name of the task in the profiler, a string literal
+                std::function<void()> function
+                  Work of the task
+                const std::vector<uint32_t>& auDependencies
+                  Indices of the tasks that must finish first
+      Modifies: [m_aTasks].
+      Returns:  uint32_t
+                  Index of the task, INVALID_TASK when a dependency is
+                  not an earlier task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TaskGraph::AddTask(const char* pszName, std::function<void()> function, const std::vector<uint32_t>& auDependencies)
+    {
+        uint32_t uTask = static_cast<uint32_t>(m_aTasks.size());
+
+        for (uint32_t uDependency : auDependencies)
+        {
+            if (uDependency >= uTask)
+            {
+                assert(!"A task may only depend on tasks added before it");
+                return INVALID_TASK;
+            }
+        }
+
+        m_aTasks.push_back(
+            Task
+            {
+                .pszName = pszName,
+                .function = std::move(function),
+                .auDependencies = auDependencies
+            }
+        );
+
+        return uTask;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TaskGraph::Run
+      Summary:  Schedules every task after the jobs of its dependencies
+                and waits for all of them, running jobs on the calling
+                thread meanwhile. The graph can be run again
+      Args:     JobSystem& jobSystem
+                  Job system to run the tasks on
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TaskGraph::Run(JobSystem& jobSystem)
+    {
+        std::vector<JobHandle> aJobs;
+        aJobs.reserve(m_aTasks.size());
+
+        std::vector<JobHandle> aDependencies;
+        for (const Task& task : m_aTasks)
+        {
+            aDependencies.clear();
+            for (uint32_t uDependency : task.auDependencies)
+            {
+                aDependencies.push_back(aJobs[uDependency]);
+            }
+
+            aJobs.push_back(jobSystem.Schedule(
+                [&task]()
+                {
+                    PROFILE_ZONE(task.pszName);
+                    task.function();
+                },
+                aDependencies
+            ));
+        }
+
+        for (const JobHandle& job : aJobs)
+        {
+            jobSystem.Wait(job);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TaskGraph::GetNumTasks
+      Summary:  Returns the number of tasks
+      Returns:  uint32_t
+                  Number of tasks added
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    uint32_t TaskGraph::GetNumTasks() const
+    {
+        return static_cast<uint32_t>(m_aTasks.size());
+    }
+}
@@ -0,0 +1,76 @@
+/*+===================================================================
+  File:      TASKGRAPH.H
+
+  Summary:   TaskGraph header file contains declaration of class
+             TaskGraph used to run the stages of a frame on a
+             JobSystem in dependency order. It only depends on the
+             standard library, the JobSystem and the Profiler.
+
+  Classes:  TaskGraph
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Utility/JobSystem.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TaskGraph
+      Summary:  Named tasks and the tasks each one waits for. Run
+                schedules every task as a job depending on the jobs of
+                its dependencies, so tasks that do not depend on each
+                other overlap, and returns once all are done. Each task
+                is timed as a profiler zone under its name. A task may
+                only depend on tasks added before it, which keeps the
+                graph acyclic. Any other dependency is rejected
+      Methods:  AddTask
+                  Adds a task and returns its index
+                Run
+                  Runs every task and waits for them
+                GetNumTasks
+                  Returns the number of tasks
+                TaskGraph
+                  Constructor.
+                ~TaskGraph
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TaskGraph
+    {
+    public:
+        static constexpr uint32_t INVALID_TASK = 0xFFFFFFFFu;
+
+    public:
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph& other) = delete;
+        TaskGraph(TaskGraph&& other) = delete;
+        TaskGraph& operator=(const TaskGraph& other) = delete;
+        TaskGraph& operator=(TaskGraph&& other) = delete;
+        ~TaskGraph() = default;
+
+        uint32_t AddTask(const char* pszName, std::function<void()> function, const std::vector<uint32_t>& auDependencies = {});
+        void Run(JobSystem& jobSystem);
+        uint32_t GetNumTasks() const;
+
+    private:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Task
+          Summary:  Work of a task and the indices of the tasks it waits
+                    for
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Task
+        {
+            const char* pszName;
+            std::function<void()> function;
+            std::vector<uint32_t> auDependencies;
+        };
+
+    private:
+        std::vector<Task> m_aTasks;
+    };
+}
@@ -91,6 +91,15 @@ namespace library
             {
                 m_mouseRelativeMovement.X = raw->data.mouse.lLastX;
                 m_mouseRelativeMovement.Y = raw->data.mouse.lLastY;
+
+                if (raw->data.mouse.usButtonFlags & RI_MOUSE_LEFT_BUTTON_DOWN)
+                {
+                    m_mouseRelativeMovement.bLeftClick = TRUE;
+                }
+                if (raw->data.mouse.usButtonFlags & RI_MOUSE_RIGHT_BUTTON_DOWN)
+                {
+                    m_mouseRelativeMovement.bRightClick = TRUE;
+                }
             }
             break;
         }
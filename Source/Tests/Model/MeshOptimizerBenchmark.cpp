@@ -0,0 +1,141 @@
+/*+===================================================================
+  File:      MESHOPTIMIZERBENCHMARK.CPP
+
+  Summary:   Optimizes the bob lamp meshes, a UV sphere and an open
+             terrain as loaded and with their triangles shuffled, and
+             prints the vertex cache misses before and after, the time
+             taken and whether the optimized mesh still draws the same
+             triangles and round-trips through the cache file
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Model/MeshOptimizer.h"
+#include "Model/TestMeshes.h"
+
+namespace
+{
+    using namespace library;
+
+    using Triangle = std::array<float, 9>;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: getTriangles
+      Summary:  Returns the triangles of a mesh by the positions of
+                their corners, each rotated to start at its smallest
+                corner, so two orders of the same triangles compare
+                equal
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::multiset<Triangle> getTriangles(const std::vector<SimpleVertex>& aVertices, const std::vector<uint16_t>& aIndices)
+    {
+        std::multiset<Triangle> triangles;
+        for (size_t i = 0u; i + 2u < aIndices.size(); i += 3u)
+        {
+            std::array<std::array<float, 3>, 3> aCorners;
+            for (size_t k = 0u; k < 3u; ++k)
+            {
+                const DirectX::XMFLOAT3& position = aVertices[aIndices[i + k]].Position;
+                aCorners[k] = { position.x, position.y, position.z };
+            }
+
+            size_t uFirst = static_cast<size_t>(std::min_element(aCorners.begin(), aCorners.end()) - aCorners.begin());
+            Triangle triangle;
+            for (size_t k = 0u; k < 3u; ++k)
+            {
+                std::copy(aCorners[(uFirst + k) % 3u].begin(), aCorners[(uFirst + k) % 3u].end(), triangle.begin() + k * 3u);
+            }
+            triangles.insert(triangle);
+        }
+        return triangles;
+    }
+
+    void optimize(const char* pszLabel, const TestMesh& mesh, const std::filesystem::path& cachePath)
+    {
+        uint32_t uNumVertices = static_cast<uint32_t>(mesh.aVertices.size());
+        uint32_t uNumIndices = static_cast<uint32_t>(mesh.aIndices.size());
+        VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(mesh.aIndices.data(), uNumIndices, uNumVertices);
+
+        std::vector<uint16_t> aIndices = mesh.aIndices;
+        std::vector<uint32_t> auClusters;
+        std::vector<uint32_t> auRemap;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        MeshOptimizer::OptimizeVertexCache(aIndices.data(), uNumIndices, uNumVertices, auClusters);
+        VertexCacheStats tipsify = MeshOptimizer::AnalyzeVertexCache(aIndices.data(), uNumIndices, uNumVertices);
+        MeshOptimizer::OptimizeOverdraw(mesh.aVertices.data(), aIndices.data(), uNumIndices, auClusters);
+        uint32_t uNumUsed = MeshOptimizer::OptimizeVertexFetch(aIndices.data(), uNumIndices, uNumVertices, auRemap);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        VertexCacheStats after = MeshOptimizer::AnalyzeVertexCache(aIndices.data(), uNumIndices, uNumVertices);
+
+        // The renumbering must be a permutation that moves vertices, not triangles
+        std::vector<SimpleVertex> aRemappedVertices(uNumVertices);
+        std::vector<uint32_t> auNumUses(uNumVertices, 0u);
+        for (uint32_t v = 0u; v < uNumVertices; ++v)
+        {
+            aRemappedVertices[auRemap[v]] = mesh.aVertices[v];
+            ++auNumUses[auRemap[v]];
+        }
+        bool bIsPermutation = std::all_of(auNumUses.begin(), auNumUses.end(), [](uint32_t uNumUses) { return uNumUses == 1u; });
+        bool bHasSameTriangles = getTriangles(aRemappedVertices, aIndices) == getTriangles(mesh.aVertices, mesh.aIndices);
+
+        std::vector<uint32_t> auCachedRemap;
+        std::vector<uint16_t> aCachedIndices;
+        bool bRoundTrips = MeshOptimizer::SaveCache(cachePath, 42u, auRemap, aIndices)
+            && MeshOptimizer::LoadCache(cachePath, 42u, auCachedRemap, aCachedIndices)
+            && auCachedRemap == auRemap && aCachedIndices == aIndices;
+        bool bRejectsOtherKey = !MeshOptimizer::LoadCache(cachePath, 43u, auCachedRemap, aCachedIndices);
+
+        std::printf("%-20s %-9s tris %5u ACMR %.3f -> %.3f (tipsify %.3f) ATVR %.3f -> %.3f runs %4zu used %5u %6.2f ms %s%s%s\n",
+            mesh.name.c_str(), pszLabel, uNumIndices / 3u, before.acmr, after.acmr, tipsify.acmr, before.atvr, after.atvr,
+            auClusters.size(), uNumUsed, milliseconds, bIsPermutation && bHasSameTriangles ? "ok" : "MISMATCH",
+            bRoundTrips ? "" : " CACHE FAILED", bRejectsOtherKey ? "" : " KEY IGNORED");
+    }
+}
+
+int main()
+{
+    std::vector<TestMesh> aMeshes = LoadMD5Meshes(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh");
+    if (aMeshes.empty())
+    {
+        std::printf("Could not read the bob lamp md5mesh\n");
+        return 1;
+    }
+
+    aMeshes.push_back(MakeSphere(128u, 64u));
+    aMeshes.push_back(MakeTerrain(120u));
+
+    std::filesystem::path cachePath = std::filesystem::temp_directory_path() / "MeshOptimizerBenchmark.mesh";
+    std::mt19937 random(1u);
+
+    for (const TestMesh& mesh : aMeshes)
+    {
+        optimize("as is", mesh, cachePath);
+
+        std::vector<uint32_t> auTriangles(mesh.aIndices.size() / 3u);
+        std::iota(auTriangles.begin(), auTriangles.end(), 0u);
+        std::shuffle(auTriangles.begin(), auTriangles.end(), random);
+
+        TestMesh shuffled = mesh;
+        for (size_t t = 0u; t < auTriangles.size(); ++t)
+        {
+            for (size_t k = 0u; k < 3u; ++k)
+            {
+                shuffled.aIndices[t * 3u + k] = mesh.aIndices[auTriangles[t] * 3u + k];
+            }
+        }
+        optimize("shuffled", shuffled, cachePath);
+    }
+
+    std::filesystem::remove(cachePath);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*+===================================================================
+  File:      MESHSIMPLIFIERBENCHMARK.CPP
+
+  Summary:   Builds three levels of detail of the bob lamp meshes, of
+             copies of them with one vertex per corner, of a UV sphere
+             and of an open terrain, and prints for each level the
+             triangles kept, the quadric error, the largest distance
+             from an original vertex to the simpler surface, the time
+             taken and whether a second run gave the same indices
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Model/MeshSimplifier.h"
+#include "Model/TestMeshes.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t NUM_LEVELS = 3u;
+    constexpr size_t MAX_NUM_MEASURED_VERTICES = 20000u;
+
+    using Vector = std::array<double, 3>;
+
+    Vector subtract(const XMFLOAT3& a, const XMFLOAT3& b)
+    {
+        return { static_cast<double>(a.x) - b.x, static_cast<double>(a.y) - b.y, static_cast<double>(a.z) - b.z };
+    }
+
+    double dot(const Vector& a, const Vector& b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    double segmentDistance(const XMFLOAT3& point, const XMFLOAT3& start, const XMFLOAT3& end)
+    {
+        Vector direction = subtract(end, start);
+        Vector offset = subtract(point, start);
+        double lengthSquared = dot(direction, direction);
+        double t = lengthSquared > 0.0 ? std::clamp(dot(offset, direction) / lengthSquared, 0.0, 1.0) : 0.0;
+        Vector rest = { offset[0] - t * direction[0], offset[1] - t * direction[1], offset[2] - t * direction[2] };
+        return std::sqrt(dot(rest, rest));
+    }
+
+    double triangleDistance(const XMFLOAT3& point, const XMFLOAT3& a, const XMFLOAT3& b, const XMFLOAT3& c)
+    {
+        Vector edge1 = subtract(b, a);
+        Vector edge2 = subtract(c, a);
+        Vector offset = subtract(point, a);
+        Vector normal = {
+            edge1[1] * edge2[2] - edge1[2] * edge2[1],
+            edge1[2] * edge2[0] - edge1[0] * edge2[2],
+            edge1[0] * edge2[1] - edge1[1] * edge2[0],
+        };
+        double normalLength = std::sqrt(dot(normal, normal));
+
+        if (normalLength > 0.0)
+        {
+            // Distance to the plane when the point projects inside the triangle
+            double distance = dot(offset, normal) / normalLength;
+            Vector projected = {
+                offset[0] - distance * normal[0] / normalLength,
+                offset[1] - distance * normal[1] / normalLength,
+                offset[2] - distance * normal[2] / normalLength,
+            };
+            double d00 = dot(edge1, edge1);
+            double d01 = dot(edge1, edge2);
+            double d11 = dot(edge2, edge2);
+            double d20 = dot(projected, edge1);
+            double d21 = dot(projected, edge2);
+            double denominator = d00 * d11 - d01 * d01;
+            double v = (d11 * d20 - d01 * d21) / denominator;
+            double w = (d00 * d21 - d01 * d20) / denominator;
+            if (v >= 0.0 && w >= 0.0 && v + w <= 1.0)
+            {
+                return std::fabs(distance);
+            }
+        }
+
+        return (std::min)({ segmentDistance(point, a, b), segmentDistance(point, b, c), segmentDistance(point, c, a) });
+    }
+
+    double hausdorffDistance(const TestMesh& mesh, const std::vector<uint16_t>& aLodIndices)
+    {
+        double largest = 0.0;
+        for (const SimpleVertex& vertex : mesh.aVertices)
+        {
+            double nearest = HUGE_VAL;
+            for (size_t i = 0u; i + 2u < aLodIndices.size(); i += 3u)
+            {
+                nearest = (std::min)(nearest, triangleDistance(vertex.Position, mesh.aVertices[aLodIndices[i]].Position, mesh.aVertices[aLodIndices[i + 1u]].Position, mesh.aVertices[aLodIndices[i + 2u]].Position));
+            }
+            largest = (std::max)(largest, nearest);
+        }
+        return largest;
+    }
+}
+
+int main()
+{
+    std::vector<TestMesh> aMeshes = LoadMD5Meshes(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh");
+    if (aMeshes.empty())
+    {
+        std::printf("Could not read the bob lamp md5mesh\n");
+        return 1;
+    }
+
+    size_t uNumLoadedMeshes = aMeshes.size();
+    for (size_t i = 0u; i < uNumLoadedMeshes; ++i)
+    {
+        aMeshes.push_back(Unweld(aMeshes[i]));
+    }
+    aMeshes.push_back(MakeSphere(128u, 64u));
+    aMeshes.push_back(MakeTerrain(120u));
+
+    for (const TestMesh& mesh : aMeshes)
+    {
+        uint32_t uNumIndices = static_cast<uint32_t>(mesh.aIndices.size());
+        MeshSimplifier simplifier(mesh.aVertices.data(), static_cast<uint32_t>(mesh.aVertices.size()));
+        std::printf("%-34s verts %5zu tris %5u locked %4u\n", mesh.name.c_str(), mesh.aVertices.size(), uNumIndices / 3u, simplifier.GetNumLockedVertices());
+
+        for (uint32_t uLevel = 1u; uLevel <= NUM_LEVELS; ++uLevel)
+        {
+            uint32_t uTargetNumIndices = uNumIndices >> uLevel;
+            std::vector<uint16_t> aLodIndices;
+            std::vector<uint16_t> aRepeatedIndices;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            float error = simplifier.Simplify(mesh.aIndices.data(), uNumIndices, uTargetNumIndices, aLodIndices);
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            float repeatedError = simplifier.Simplify(mesh.aIndices.data(), uNumIndices, uTargetNumIndices, aRepeatedIndices);
+
+            bool bIsDeterministic = aLodIndices == aRepeatedIndices && error == repeatedError;
+            bool bHasValidIndices = std::all_of(aLodIndices.begin(), aLodIndices.end(), [&mesh](uint16_t uIndex) { return uIndex < mesh.aVertices.size(); });
+            double hausdorff = mesh.aVertices.size() < MAX_NUM_MEASURED_VERTICES ? hausdorffDistance(mesh, aLodIndices) : -1.0;
+
+            std::printf("   level %u target %5u tris %5zu error %.4f hausdorff %.4f %7.2f ms %s%s\n",
+                uLevel, uTargetNumIndices / 3u, aLodIndices.size() / 3u, error, hausdorff, milliseconds,
+                bIsDeterministic ? "deterministic" : "NONDETERMINISTIC", bHasValidIndices ? "" : " INVALID INDEX");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*+===================================================================
+  File:      SKINWEIGHTBUILDERTESTS.CPP
+
+  Summary:   Skins the bob lamp md5mesh under a random pose with the
+             weights of the builder and with every weight of the file,
+             and checks how the builder keeps, drops, renormalizes and
+             renumbers weights
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Model/SkinWeightBuilder.h"
+#include "Model/TestMeshes.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SkinningErrors
+      Summary:  Largest distance between a vertex skinned with every
+                weight and with the kept ones
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SkinningErrors
+    {
+        float builder;
+        float firstFour;
+        float extent;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makePose
+      Summary:  Turns every joint by up to 0.35 radians around its bind
+                position and moves it by up to one unit
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<XMMATRIX> makePose(const std::vector<TestJoint>& aJoints, uint32_t uSeed)
+    {
+        std::mt19937 random(uSeed);
+        std::uniform_real_distribution<float> angle(-0.35f, 0.35f);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+        std::vector<XMMATRIX> aPose;
+        for (const TestJoint& joint : aJoints)
+        {
+            XMVECTOR rotation = XMQuaternionRotationRollPitchYaw(angle(random), angle(random), angle(random));
+            XMVECTOR translation = XMVectorAdd(XMLoadFloat3(&joint.position), XMVectorSet(offset(random), offset(random), offset(random), 0.0f));
+            aPose.push_back(XMMatrixMultiply(XMMatrixMultiply(XMMatrixTranslation(-joint.position.x, -joint.position.y, -joint.position.z),
+                XMMatrixRotationQuaternion(rotation)), XMMatrixTranslationFromVector(translation)));
+        }
+        return aPose;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: skin
+      Summary:  Blends the posed positions of a bind-pose vertex
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMVECTOR skin(const std::vector<XMMATRIX>& aPose, FXMVECTOR position, const uint32_t* auJoints, const float* aWeights, size_t uNumWeights)
+    {
+        XMVECTOR skinned = XMVectorZero();
+        for (size_t i = 0u; i < uNumWeights; ++i)
+        {
+            skinned = XMVectorAdd(skinned, XMVectorScale(XMVector3TransformCoord(position, aPose[auJoints[i]]), aWeights[i]));
+        }
+        return skinned;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: measureSkinning
+      Summary:  Feeds the weights of every mesh to a builder bone by
+                bone, the way Assimp lists them, and measures the
+                skinned positions of the built animation data and of the
+                first four weights of each vertex, which is what the
+                model kept before, against skinning with every weight
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    SkinningErrors measureSkinning(const TestSkinnedModel& model, uint32_t& uNumDroppedWeights, float& maxDroppedWeight)
+    {
+        std::vector<XMMATRIX> aPose = makePose(model.aJoints, 7u);
+        SkinningErrors errors = { .builder = 0.0f, .firstFour = 0.0f, .extent = 0.0f };
+        XMVECTOR minimum = XMVectorReplicate(HUGE_VALF);
+        XMVECTOR maximum = XMVectorReplicate(-HUGE_VALF);
+        uNumDroppedWeights = 0u;
+        maxDroppedWeight = 0.0f;
+
+        for (const TestSkinnedMesh& mesh : model.aMeshes)
+        {
+            std::vector<TestBoneWeight> aByBone = mesh.aWeights;
+            std::stable_sort(aByBone.begin(), aByBone.end(), [](const TestBoneWeight& a, const TestBoneWeight& b) { return a.uJoint < b.uJoint; });
+
+            uint32_t uNumVertices = static_cast<uint32_t>(mesh.mesh.aVertices.size());
+            SkinWeightBuilder builder;
+            builder.Resize(uNumVertices);
+            std::vector<std::vector<uint32_t>> aauJoints(uNumVertices);
+            std::vector<std::vector<float>> aaWeights(uNumVertices);
+            for (const TestBoneWeight& weight : aByBone)
+            {
+                builder.AddWeight(weight.uVertex, weight.uJoint, weight.weight);
+                aauJoints[weight.uVertex].push_back(weight.uJoint);
+                aaWeights[weight.uVertex].push_back(weight.weight);
+            }
+
+            std::vector<AnimationData> aAnimationData;
+            builder.Build(aAnimationData);
+            EXPECT_EQ(aAnimationData.size(), uNumVertices);
+            uNumDroppedWeights += builder.GetNumDroppedWeights();
+            maxDroppedWeight = (std::max)(maxDroppedWeight, builder.GetMaxDroppedWeight());
+
+            for (uint32_t v = 0u; v < uNumVertices; ++v)
+            {
+                const AnimationData& animationData = aAnimationData[v];
+                const uint32_t auJoints[] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+                const float aWeights[] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+                EXPECT_NEAR(aWeights[0] + aWeights[1] + aWeights[2] + aWeights[3], 1.0f, 1.0e-5f);
+                for (size_t k = 1u; k < MAX_NUM_BONES_PER_VERTEX; ++k)
+                {
+                    // Sorted before rounding, so ties may end one step apart
+                    EXPECT_LE(aWeights[k], aWeights[k - 1u] + 1.5f / 255.0f);
+                }
+
+                XMVECTOR position = XMLoadFloat3(&mesh.mesh.aVertices[v].Position);
+                minimum = XMVectorMin(minimum, position);
+                maximum = XMVectorMax(maximum, position);
+
+                size_t uNumWeights = aaWeights[v].size();
+                XMVECTOR reference = skin(aPose, position, aauJoints[v].data(), aaWeights[v].data(), uNumWeights);
+                XMVECTOR built = skin(aPose, position, auJoints, aWeights, MAX_NUM_BONES_PER_VERTEX);
+                XMVECTOR firstFour = skin(aPose, position, aauJoints[v].data(), aaWeights[v].data(), (std::min)(uNumWeights, size_t{ MAX_NUM_BONES_PER_VERTEX }));
+
+                errors.builder = (std::max)(errors.builder, XMVectorGetX(XMVector3Length(XMVectorSubtract(built, reference))));
+                errors.firstFour = (std::max)(errors.firstFour, XMVectorGetX(XMVector3Length(XMVectorSubtract(firstFour, reference))));
+            }
+        }
+
+        XMFLOAT3 size;
+        XMStoreFloat3(&size, XMVectorSubtract(maximum, minimum));
+        errors.extent = (std::max)({ size.x, size.y, size.z });
+        return errors;
+    }
+
+    TestSkinnedModel loadBobLamp()
+    {
+        return LoadMD5Model(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh");
+    }
+}
+
+TEST(SkinWeightBuilderTests, BobLampSkinsLikeEveryWeight)
+{
+    TestSkinnedModel model = loadBobLamp();
+    ASSERT_FALSE(model.aMeshes.empty());
+
+    // The bob lamp has at most four weights per vertex, so only the
+    // 8-bit rounding of the weights is left
+    uint32_t uNumDroppedWeights = 0u;
+    float maxDroppedWeight = 0.0f;
+    SkinningErrors errors = measureSkinning(model, uNumDroppedWeights, maxDroppedWeight);
+    EXPECT_EQ(uNumDroppedWeights, 0u);
+    EXPECT_EQ(maxDroppedWeight, 0.0f);
+    EXPECT_GT(errors.extent, 10.0f);
+    EXPECT_LT(errors.builder, errors.extent * 5.0e-4f);
+    EXPECT_LT(errors.firstFour, errors.extent * 1.0e-5f);
+}
+
+TEST(SkinWeightBuilderTests, ExtraInfluencesKeepTheLargestWeights)
+{
+    TestSkinnedModel model = loadBobLamp();
+    ASSERT_FALSE(model.aMeshes.empty());
+
+    // Four 3% weights on random joints after the weights of each vertex
+    std::mt19937 random(3u);
+    std::uniform_int_distribution<uint32_t> joint(0u, static_cast<uint32_t>(model.aJoints.size()) - 1u);
+    for (TestSkinnedMesh& mesh : model.aMeshes)
+    {
+        std::vector<TestBoneWeight> aWeights;
+        for (size_t i = 0u; i < mesh.aWeights.size(); ++i)
+        {
+            TestBoneWeight weight = mesh.aWeights[i];
+            weight.weight *= 0.88f;
+            aWeights.push_back(weight);
+
+            if (i + 1u == mesh.aWeights.size() || mesh.aWeights[i + 1u].uVertex != weight.uVertex)
+            {
+                for (uint32_t k = 0u; k < 4u; ++k)
+                {
+                    aWeights.push_back({ .uVertex = weight.uVertex, .uJoint = joint(random), .weight = 0.03f });
+                }
+            }
+        }
+        mesh.aWeights = std::move(aWeights);
+    }
+
+    uint32_t uNumDroppedWeights = 0u;
+    float maxDroppedWeight = 0.0f;
+    SkinningErrors errors = measureSkinning(model, uNumDroppedWeights, maxDroppedWeight);
+    EXPECT_GT(uNumDroppedWeights, 0u);
+    EXPECT_FLOAT_EQ(maxDroppedWeight, 0.03f);
+    EXPECT_LT(errors.builder * 10.0f, errors.firstFour);
+}
+
+TEST(SkinWeightBuilderTests, KeepsTheFourLargestSorted)
+{
+    SkinWeightBuilder builder;
+    builder.Resize(2u);
+    builder.AddWeight(0u, 10u, 0.1f);
+    builder.AddWeight(0u, 11u, 0.4f);
+    builder.AddWeight(0u, 12u, 0.05f);
+    builder.AddWeight(0u, 13u, 0.3f);
+    builder.AddWeight(0u, 14u, 0.15f);
+    builder.AddWeight(0u, 15u, 0.0f);
+    builder.AddWeight(0u, 16u, -0.2f);
+
+    EXPECT_EQ(builder.GetNumVertices(), 2u);
+    EXPECT_EQ(builder.GetNumDroppedWeights(), 1u);
+    EXPECT_FLOAT_EQ(builder.GetMaxDroppedWeight(), 0.05f);
+
+    std::vector<AnimationData> aAnimationData;
+    builder.Build(aAnimationData);
+    ASSERT_EQ(aAnimationData.size(), 2u);
+
+    const AnimationData& animationData = aAnimationData[0];
+    EXPECT_EQ(animationData.aBoneIndices.x, 11u);
+    EXPECT_EQ(animationData.aBoneIndices.y, 13u);
+    EXPECT_EQ(animationData.aBoneIndices.z, 14u);
+    EXPECT_EQ(animationData.aBoneIndices.w, 10u);
+
+    // Renormalized over 0.95 and rounded to multiples of 1/255
+    const float aWeights[] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+    const float aExpected[] = { 0.4f / 0.95f, 0.3f / 0.95f, 0.15f / 0.95f, 0.1f / 0.95f };
+    float sum = 0.0f;
+    for (size_t i = 0u; i < 4u; ++i)
+    {
+        EXPECT_NEAR(aWeights[i], aExpected[i], 1.0f / 255.0f);
+        EXPECT_NEAR(aWeights[i] * 255.0f, std::round(aWeights[i] * 255.0f), 1.0e-3f);
+        sum += aWeights[i];
+    }
+    EXPECT_NEAR(sum, 1.0f, 1.0e-5f);
+
+    EXPECT_EQ(aAnimationData[1].aBoneWeights.x, 0.0f);
+    EXPECT_EQ(aAnimationData[1].aBoneWeights.y, 0.0f);
+    EXPECT_EQ(aAnimationData[1].aBoneWeights.z, 0.0f);
+    EXPECT_EQ(aAnimationData[1].aBoneWeights.w, 0.0f);
+}
+
+TEST(SkinWeightBuilderTests, RemapMovesWeightsWithTheirVertices)
+{
+    SkinWeightBuilder builder;
+    builder.Resize(3u);
+    for (uint32_t v = 0u; v < 3u; ++v)
+    {
+        builder.AddWeight(v, v + 1u, 1.0f);
+    }
+
+    builder.Remap({ 2u, 0u, 1u });
+
+    std::vector<AnimationData> aAnimationData;
+    builder.Build(aAnimationData);
+    ASSERT_EQ(aAnimationData.size(), 3u);
+    EXPECT_EQ(aAnimationData[2].aBoneIndices.x, 1u);
+    EXPECT_EQ(aAnimationData[0].aBoneIndices.x, 2u);
+    EXPECT_EQ(aAnimationData[1].aBoneIndices.x, 3u);
+    for (const AnimationData& animationData : aAnimationData)
+    {
+        EXPECT_EQ(animationData.aBoneWeights.x, 1.0f);
+        EXPECT_EQ(animationData.aBoneWeights.y, 0.0f);
+    }
+}
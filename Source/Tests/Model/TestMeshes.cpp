@@ -0,0 +1,374 @@
+/*+===================================================================
+  File:      TESTMESHES.CPP
+
+  Summary:   Reads md5mesh bind poses and weights and generates test
+             meshes
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Model/TestMeshes.h"
+
+#include <cmath>
+#include <fstream>
+#include <numbers>
+#include <sstream>
+
+namespace library
+{
+    using namespace DirectX;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: LoadMD5Model
+      Summary:  Reads the joints and meshes of an md5mesh file in their
+                bind pose. A vertex is the sum of its weights, each a
+                position in the space of a joint moved to object space
+      Args:     const std::filesystem::path& filePath
+                  md5mesh file
+      Returns:  TestSkinnedModel
+                  Joints and meshes named after their shader, empty
+                  when the file can't be read
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    TestSkinnedModel LoadMD5Model(const std::filesystem::path& filePath)
+    {
+        struct Weight
+        {
+            uint32_t uJoint;
+            float bias;
+            XMFLOAT3 position;
+        };
+
+        struct Vertex
+        {
+            XMFLOAT2 texCoord;
+            uint32_t uFirstWeight;
+            uint32_t uNumWeights;
+        };
+
+        TestSkinnedModel model;
+        std::vector<Vertex> aVertices;
+        std::vector<Weight> aWeights;
+        TestSkinnedMesh mesh;
+        bool bIsInJoints = false;
+        bool bIsInMesh = false;
+
+        std::ifstream file(filePath);
+        std::string szLine;
+        while (std::getline(file, szLine))
+        {
+            for (char& ch : szLine)
+            {
+                if (ch == '(' || ch == ')' || ch == '\t')
+                {
+                    ch = ' ';
+                }
+            }
+
+            std::istringstream line(szLine);
+            std::string szToken;
+            line >> szToken;
+
+            if (szToken == "joints")
+            {
+                bIsInJoints = true;
+            }
+            else if (szToken == "mesh")
+            {
+                bIsInMesh = true;
+                mesh = TestSkinnedMesh();
+                aVertices.clear();
+                aWeights.clear();
+            }
+            else if (szToken == "}")
+            {
+                if (bIsInMesh)
+                {
+                    for (const Vertex& vertex : aVertices)
+                    {
+                        uint32_t uVertex = static_cast<uint32_t>(mesh.mesh.aVertices.size());
+                        XMVECTOR position = XMVectorZero();
+                        for (uint32_t i = vertex.uFirstWeight; i < vertex.uFirstWeight + vertex.uNumWeights; ++i)
+                        {
+                            const Weight& weight = aWeights[i];
+                            const TestJoint& joint = model.aJoints[weight.uJoint];
+                            XMVECTOR jointPosition = XMVectorAdd(XMLoadFloat3(&joint.position), XMVector3Rotate(XMLoadFloat3(&weight.position), XMLoadFloat4(&joint.orientation)));
+                            position = XMVectorAdd(position, XMVectorScale(jointPosition, weight.bias));
+                            mesh.aWeights.push_back({ .uVertex = uVertex, .uJoint = weight.uJoint, .weight = weight.bias });
+                        }
+
+                        SimpleVertex simpleVertex = {};
+                        XMStoreFloat3(&simpleVertex.Position, position);
+                        simpleVertex.TexCoord = vertex.texCoord;
+                        mesh.mesh.aVertices.push_back(simpleVertex);
+                    }
+
+                    ComputeNormals(mesh.mesh);
+                    model.aMeshes.push_back(std::move(mesh));
+                }
+
+                bIsInJoints = false;
+                bIsInMesh = false;
+            }
+            else if (bIsInJoints && !szToken.empty() && szToken[0] == '"')
+            {
+                int32_t iParent = 0;
+                TestJoint joint = {};
+                line >> iParent >> joint.position.x >> joint.position.y >> joint.position.z >> joint.orientation.x >> joint.orientation.y >> joint.orientation.z;
+
+                // Only the imaginary part is stored, with a non-positive w
+                float wSquared = 1.0f - joint.orientation.x * joint.orientation.x - joint.orientation.y * joint.orientation.y - joint.orientation.z * joint.orientation.z;
+                joint.orientation.w = wSquared < 0.0f ? 0.0f : -std::sqrt(wSquared);
+                model.aJoints.push_back(joint);
+            }
+            else if (bIsInMesh)
+            {
+                uint32_t uIndex = 0u;
+                if (szToken == "shader")
+                {
+                    std::string& name = mesh.mesh.name;
+                    line >> name;
+                    if (name.size() >= 2u && name.front() == '"')
+                    {
+                        name = name.substr(1u, name.size() - 2u);
+                    }
+                }
+                else if (szToken == "vert")
+                {
+                    Vertex vertex = {};
+                    line >> uIndex >> vertex.texCoord.x >> vertex.texCoord.y >> vertex.uFirstWeight >> vertex.uNumWeights;
+                    aVertices.push_back(vertex);
+                }
+                else if (szToken == "tri")
+                {
+                    uint32_t auCorners[3] = {};
+                    line >> uIndex >> auCorners[0] >> auCorners[1] >> auCorners[2];
+                    for (uint32_t uCorner : auCorners)
+                    {
+                        mesh.mesh.aIndices.push_back(static_cast<uint16_t>(uCorner));
+                    }
+                }
+                else if (szToken == "weight")
+                {
+                    Weight weight = {};
+                    line >> uIndex >> weight.uJoint >> weight.bias >> weight.position.x >> weight.position.y >> weight.position.z;
+                    aWeights.push_back(weight);
+                }
+            }
+        }
+
+        return model;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: LoadMD5Meshes
+      Summary:  Reads the meshes of an md5mesh file in their bind pose
+      Args:     const std::filesystem::path& filePath
+                  md5mesh file
+      Returns:  std::vector<TestMesh>
+                  Meshes named after their shader, empty when the file
+                  can't be read
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<TestMesh> LoadMD5Meshes(const std::filesystem::path& filePath)
+    {
+        std::vector<TestMesh> aMeshes;
+        for (TestSkinnedMesh& mesh : LoadMD5Model(filePath).aMeshes)
+        {
+            aMeshes.push_back(std::move(mesh.mesh));
+        }
+        return aMeshes;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MakeCube
+      Summary:  Builds the cube every voxel instance draws, from -1 to
+                1 with four vertices a face
+      Returns:  TestMesh
+                  Cube
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    TestMesh MakeCube()
+    {
+        TestMesh mesh = { .name = "voxel cube", .aVertices = {}, .aIndices = {} };
+        mesh.aVertices =
+        {
+            { .Position = XMFLOAT3(-1.0f, 1.0f, -1.0f), .TexCoord = XMFLOAT2(1.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, 1.0f, -1.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, 1.0f, 1.0f), .TexCoord = XMFLOAT2(0.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+            { .Position = XMFLOAT3(-1.0f, 1.0f, 1.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+
+            { .Position = XMFLOAT3(-1.0f, -1.0f, -1.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, -1.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, -1.0f, -1.0f), .TexCoord = XMFLOAT2(1.0f, 0.0f), .Normal = XMFLOAT3(0.0f, -1.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, -1.0f, 1.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(0.0f, -1.0f, 0.0f) },
+            { .Position = XMFLOAT3(-1.0f, -1.0f, 1.0f), .TexCoord = XMFLOAT2(0.0f, 1.0f), .Normal = XMFLOAT3(0.0f, -1.0f, 0.0f) },
+
+            { .Position = XMFLOAT3(-1.0f, -1.0f, 1.0f), .TexCoord = XMFLOAT2(0.0f, 1.0f), .Normal = XMFLOAT3(-1.0f, 0.0f, 0.0f) },
+            { .Position = XMFLOAT3(-1.0f, -1.0f, -1.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(-1.0f, 0.0f, 0.0f) },
+            { .Position = XMFLOAT3(-1.0f, 1.0f, -1.0f), .TexCoord = XMFLOAT2(1.0f, 0.0f), .Normal = XMFLOAT3(-1.0f, 0.0f, 0.0f) },
+            { .Position = XMFLOAT3(-1.0f, 1.0f, 1.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(-1.0f, 0.0f, 0.0f) },
+
+            { .Position = XMFLOAT3(1.0f, -1.0f, 1.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(1.0f, 0.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, -1.0f, -1.0f), .TexCoord = XMFLOAT2(0.0f, 1.0f), .Normal = XMFLOAT3(1.0f, 0.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, 1.0f, -1.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(1.0f, 0.0f, 0.0f) },
+            { .Position = XMFLOAT3(1.0f, 1.0f, 1.0f), .TexCoord = XMFLOAT2(1.0f, 0.0f), .Normal = XMFLOAT3(1.0f, 0.0f, 0.0f) },
+
+            { .Position = XMFLOAT3(-1.0f, -1.0f, -1.0f), .TexCoord = XMFLOAT2(0.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 0.0f, -1.0f) },
+            { .Position = XMFLOAT3(1.0f, -1.0f, -1.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 0.0f, -1.0f) },
+            { .Position = XMFLOAT3(1.0f, 1.0f, -1.0f), .TexCoord = XMFLOAT2(1.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, -1.0f) },
+            { .Position = XMFLOAT3(-1.0f, 1.0f, -1.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, -1.0f) },
+
+            { .Position = XMFLOAT3(-1.0f, -1.0f, 1.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 0.0f, 1.0f) },
+            { .Position = XMFLOAT3(1.0f, -1.0f, 1.0f), .TexCoord = XMFLOAT2(0.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 0.0f, 1.0f) },
+            { .Position = XMFLOAT3(1.0f, 1.0f, 1.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, 1.0f) },
+            { .Position = XMFLOAT3(-1.0f, 1.0f, 1.0f), .TexCoord = XMFLOAT2(1.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, 1.0f) }
+        };
+        mesh.aIndices =
+        {
+            3, 1, 0, 2, 1, 3,
+            6, 4, 5, 7, 4, 6,
+            11, 9, 8, 10, 9, 11,
+            14, 12, 13, 15, 12, 14,
+            19, 17, 16, 18, 17, 19,
+            22, 20, 21, 23, 20, 22
+        };
+
+        return mesh;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MakeSphere
+      Summary:  Builds a unit UV sphere. The first and last column
+                share positions but not texture coordinates, so the
+                sphere has a seam
+      Args:     uint32_t uNumSegments
+                  Number of columns around the axis
+                uint32_t uNumRings
+                  Number of rows from pole to pole
+      Returns:  TestMesh
+                  Sphere
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    TestMesh MakeSphere(uint32_t uNumSegments, uint32_t uNumRings)
+    {
+        TestMesh mesh = { .name = "uv sphere", .aVertices = {}, .aIndices = {} };
+        for (uint32_t uRing = 0u; uRing <= uNumRings; ++uRing)
+        {
+            for (uint32_t uSegment = 0u; uSegment <= uNumSegments; ++uSegment)
+            {
+                double theta = std::numbers::pi * uRing / uNumRings;
+                double phi = 2.0 * std::numbers::pi * uSegment / uNumSegments;
+
+                SimpleVertex vertex = {};
+                vertex.Position = XMFLOAT3(static_cast<float>(std::sin(theta) * std::cos(phi)), static_cast<float>(std::cos(theta)), static_cast<float>(std::sin(theta) * std::sin(phi)));
+                vertex.TexCoord = XMFLOAT2(static_cast<float>(uSegment) / uNumSegments, static_cast<float>(uRing) / uNumRings);
+                vertex.Normal = vertex.Position;
+                mesh.aVertices.push_back(vertex);
+            }
+        }
+
+        for (uint32_t uRing = 0u; uRing < uNumRings; ++uRing)
+        {
+            for (uint32_t uSegment = 0u; uSegment < uNumSegments; ++uSegment)
+            {
+                uint16_t a = static_cast<uint16_t>(uRing * (uNumSegments + 1u) + uSegment);
+                uint16_t b = static_cast<uint16_t>(a + 1u);
+                uint16_t c = static_cast<uint16_t>(a + uNumSegments + 1u);
+                uint16_t d = static_cast<uint16_t>(c + 1u);
+                mesh.aIndices.insert(mesh.aIndices.end(), { a, c, b, b, c, d });
+            }
+        }
+
+        return mesh;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MakeTerrain
+      Summary:  Builds a gently rolling unit square with an open border
+      Args:     uint32_t uNumCells
+                  Number of cells along each side
+      Returns:  TestMesh
+                  Terrain
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    TestMesh MakeTerrain(uint32_t uNumCells)
+    {
+        TestMesh mesh = { .name = "open terrain", .aVertices = {}, .aIndices = {} };
+        for (uint32_t uRow = 0u; uRow <= uNumCells; ++uRow)
+        {
+            for (uint32_t uColumn = 0u; uColumn <= uNumCells; ++uColumn)
+            {
+                float x = static_cast<float>(uColumn) / uNumCells;
+                float z = static_cast<float>(uRow) / uNumCells;
+
+                SimpleVertex vertex = {};
+                vertex.Position = XMFLOAT3(x, 0.05f * std::sin(x * 6.0f) * std::cos(z * 5.0f), z);
+                vertex.TexCoord = XMFLOAT2(x, z);
+                mesh.aVertices.push_back(vertex);
+            }
+        }
+
+        for (uint32_t uRow = 0u; uRow < uNumCells; ++uRow)
+        {
+            for (uint32_t uColumn = 0u; uColumn < uNumCells; ++uColumn)
+            {
+                uint16_t a = static_cast<uint16_t>(uRow * (uNumCells + 1u) + uColumn);
+                uint16_t b = static_cast<uint16_t>(a + 1u);
+                uint16_t c = static_cast<uint16_t>(a + uNumCells + 1u);
+                uint16_t d = static_cast<uint16_t>(c + 1u);
+                mesh.aIndices.insert(mesh.aIndices.end(), { a, c, b, b, c, d });
+            }
+        }
+
+        ComputeNormals(mesh);
+        return mesh;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: Unweld
+      Summary:  Gives every corner its own vertex, as an importer that
+                doesn't join identical vertices would
+      Args:     const TestMesh& mesh
+                  Indexed mesh
+      Returns:  TestMesh
+                  Mesh with one vertex per corner
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    TestMesh Unweld(const TestMesh& mesh)
+    {
+        TestMesh unwelded = { .name = mesh.name + " (per corner)", .aVertices = {}, .aIndices = {} };
+        for (uint16_t uIndex : mesh.aIndices)
+        {
+            unwelded.aIndices.push_back(static_cast<uint16_t>(unwelded.aVertices.size()));
+            unwelded.aVertices.push_back(mesh.aVertices[uIndex]);
+        }
+
+        return unwelded;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: ComputeNormals
+      Summary:  Sets each normal to the area weighted average of the
+                faces around the vertex
+      Args:     TestMesh& mesh
+                  Mesh to change
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void ComputeNormals(TestMesh& mesh)
+    {
+        std::vector<XMFLOAT3> aSums(mesh.aVertices.size(), XMFLOAT3(0.0f, 0.0f, 0.0f));
+        for (size_t i = 0u; i + 2u < mesh.aIndices.size(); i += 3u)
+        {
+            XMVECTOR p0 = XMLoadFloat3(&mesh.aVertices[mesh.aIndices[i]].Position);
+            XMVECTOR p1 = XMLoadFloat3(&mesh.aVertices[mesh.aIndices[i + 1u]].Position);
+            XMVECTOR p2 = XMLoadFloat3(&mesh.aVertices[mesh.aIndices[i + 2u]].Position);
+            XMVECTOR normal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+
+            for (size_t k = i; k < i + 3u; ++k)
+            {
+                XMFLOAT3& sum = aSums[mesh.aIndices[k]];
+                XMStoreFloat3(&sum, XMVectorAdd(XMLoadFloat3(&sum), normal));
+            }
+        }
+
+        for (size_t i = 0u; i < mesh.aVertices.size(); ++i)
+        {
+            XMVECTOR sum = XMLoadFloat3(&aSums[i]);
+            bool bIsDegenerate = XMVectorGetX(XMVector3LengthSq(sum)) == 0.0f;
+            XMStoreFloat3(&mesh.aVertices[i].Normal, bIsDegenerate ? XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f) : XMVector3Normalize(sum));
+        }
+    }
+}
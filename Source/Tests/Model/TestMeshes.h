@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      TESTMESHES.H
+
+  Summary:   Meshes the model tests and benchmarks run on: the bind
+             pose and bone weights of the bob lamp md5mesh, read
+             without Assimp, and generated cubes, spheres and terrains
+
+  Classes:  TestMesh, TestJoint, TestBoneWeight, TestSkinnedMesh,
+            TestSkinnedModel
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Renderer/VertexTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestMesh
+      Summary:  Indexed triangle list with smooth normals
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestMesh
+    {
+        std::string name;
+        std::vector<SimpleVertex> aVertices;
+        std::vector<uint16_t> aIndices;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestJoint
+      Summary:  Bind pose of a joint in object space
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestJoint
+    {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT4 orientation;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestBoneWeight
+      Summary:  Weight of a joint on a vertex
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestBoneWeight
+    {
+        uint32_t uVertex;
+        uint32_t uJoint;
+        float weight;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestSkinnedMesh
+      Summary:  Mesh in its bind pose with every weight of the file,
+                listed vertex by vertex
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestSkinnedMesh
+    {
+        TestMesh mesh;
+        std::vector<TestBoneWeight> aWeights;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestSkinnedModel
+      Summary:  Joints and skinned meshes of an md5mesh file
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestSkinnedModel
+    {
+        std::vector<TestJoint> aJoints;
+        std::vector<TestSkinnedMesh> aMeshes;
+    };
+
+    TestSkinnedModel LoadMD5Model(const std::filesystem::path& filePath);
+    std::vector<TestMesh> LoadMD5Meshes(const std::filesystem::path& filePath);
+    TestMesh MakeCube();
+    TestMesh MakeSphere(uint32_t uNumSegments, uint32_t uNumRings);
+    TestMesh MakeTerrain(uint32_t uNumCells);
+    TestMesh Unweld(const TestMesh& mesh);
+    void ComputeNormals(TestMesh& mesh);
+}
@@ -0,0 +1,141 @@
+/*+===================================================================
+  File:      BONEPALETTEBENCHMARK.CPP
+
+  Summary:   Skins random four-bone vertices with the 3x4 palette and
+             with the 4x4 matrices it replaced, and prints the largest
+             difference, the time taken to write each palette and the
+             bytes uploaded per skinned draw
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Renderer/BonePalette.h"
+#include "Shaders/ShaderConstants.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t NUM_BONES = 64u;
+    constexpr uint32_t NUM_VERTICES = 10000u;
+    constexpr uint32_t NUM_PALETTES = 200000u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: skinFull
+      Summary:  What the vertex shader did before: blends the 4x4 bone
+                matrices and multiplies the position as a row vector,
+                in double
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMFLOAT3 skinFull(const std::vector<XMFLOAT4X4>& aBones, const AnimationData& animationData, const XMFLOAT3& position)
+    {
+        const uint32_t auBoneIndices[] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+        const float aBoneWeights[] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+        const double aPosition[] = { position.x, position.y, position.z, 1.0 };
+
+        double aSkinned[3] = { 0.0, 0.0, 0.0 };
+        for (uint32_t i = 0u; i < MAX_NUM_BONES_PER_VERTEX; ++i)
+        {
+            const XMFLOAT4X4& bone = aBones[auBoneIndices[i]];
+            for (uint32_t uColumn = 0u; uColumn < 3u; ++uColumn)
+            {
+                for (uint32_t uRow = 0u; uRow < 4u; ++uRow)
+                {
+                    aSkinned[uColumn] += aBoneWeights[i] * aPosition[uRow] * bone.m[uRow][uColumn];
+                }
+            }
+        }
+        return XMFLOAT3(static_cast<float>(aSkinned[0]), static_cast<float>(aSkinned[1]), static_cast<float>(aSkinned[2]));
+    }
+}
+
+int main()
+{
+    std::mt19937 random(1u);
+    std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+
+    std::vector<XMFLOAT4X4> aBones(NUM_BONES);
+    std::vector<XMMATRIX> aBoneMatrices(NUM_BONES);
+    for (uint32_t uBone = 0u; uBone < NUM_BONES; ++uBone)
+    {
+        XMFLOAT4X4& bone = aBones[uBone];
+        for (uint32_t uRow = 0u; uRow < 4u; ++uRow)
+        {
+            for (uint32_t uColumn = 0u; uColumn < 4u; ++uColumn)
+            {
+                bone.m[uRow][uColumn] = uColumn == 3u ? (uRow == 3u ? 1.0f : 0.0f) : value(random);
+            }
+        }
+        aBoneMatrices[uBone] = XMLoadFloat4x4(&bone);
+    }
+
+    std::vector<BoneTransform3x4> aPalette(NUM_BONES);
+    for (uint32_t uBone = 0u; uBone < NUM_BONES; ++uBone)
+    {
+        BonePalette::StoreTransposed3x4(aBoneMatrices[uBone], aPalette[uBone]);
+    }
+
+    std::uniform_int_distribution<uint32_t> bone(0u, NUM_BONES - 1u);
+    float maxError = 0.0f;
+    for (uint32_t v = 0u; v < NUM_VERTICES; ++v)
+    {
+        float aWeights[4] = { std::fabs(value(random)), std::fabs(value(random)), std::fabs(value(random)), std::fabs(value(random)) };
+        float sum = aWeights[0] + aWeights[1] + aWeights[2] + aWeights[3];
+        AnimationData animationData =
+        {
+            .aBoneIndices = XMUINT4(bone(random), bone(random), bone(random), bone(random)),
+            .aBoneWeights = XMFLOAT4(aWeights[0] / sum, aWeights[1] / sum, aWeights[2] / sum, aWeights[3] / sum)
+        };
+        XMFLOAT3 position(value(random), value(random), value(random));
+
+        XMFLOAT3 expected = skinFull(aBones, animationData, position);
+        XMFLOAT3 skinned;
+        XMStoreFloat3(&skinned, BonePalette::SkinPosition(aPalette.data(), animationData, XMLoadFloat3(&position)));
+        maxError = (std::max)({ maxError, std::fabs(skinned.x - expected.x), std::fabs(skinned.y - expected.y), std::fabs(skinned.z - expected.z) });
+    }
+    std::printf("%u random four-bone vertices: largest difference to the 4x4 path %.3g %s\n", NUM_VERTICES, maxError, maxError < 1.0e-4f ? "ok" : "MISMATCH");
+
+    // The renderer used to write the transposes into a full 4x4 palette
+    std::vector<XMMATRIX> aFullPalette(MAX_NUM_BONES);
+    float sink = 0.0f;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t uPalette = 0u; uPalette < NUM_PALETTES; ++uPalette)
+    {
+        for (uint32_t uBone = 0u; uBone < NUM_BONES; ++uBone)
+        {
+            aFullPalette[uBone] = XMMatrixTranspose(aBoneMatrices[uBone]);
+        }
+        sink += XMVectorGetX(aFullPalette[uPalette % NUM_BONES].r[0]);
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (uint32_t uPalette = 0u; uPalette < NUM_PALETTES; ++uPalette)
+    {
+        for (uint32_t uBone = 0u; uBone < NUM_BONES; ++uBone)
+        {
+            BonePalette::StoreTransposed3x4(aBoneMatrices[uBone], aPalette[uBone]);
+        }
+        sink += aPalette[uPalette % NUM_BONES].Rows[0].x;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::printf("%u bones: 4x4 transpose %.1f ns/palette, 3x4 transpose %.1f ns/palette (checksum %g)\n", NUM_BONES,
+        std::chrono::duration<double, std::nano>(middle - start).count() / NUM_PALETTES,
+        std::chrono::duration<double, std::nano>(end - middle).count() / NUM_PALETTES, static_cast<double>(sink));
+
+    // The bob lamp has 33 bones
+    const size_t uFullPaletteBytes = sizeof(XMFLOAT4X4) * MAX_NUM_BONES;
+    for (uint32_t uNumBones : { 1u, 33u, 64u, 100u })
+    {
+        size_t uBytes = sizeof(BoneTransform3x4) * uNumBones;
+        std::printf("%3u bones: %5zu bytes per draw vs %zu (%.1fx less)\n", uNumBones, uBytes, uFullPaletteBytes, static_cast<double>(uFullPaletteBytes) / uBytes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLERBENCHMARK.CPP
+
+  Summary:   Rasterizes a 96x96 heightfield of occluder columns, merged
+             and one box per column, from random cameras, and prints
+             the time taken to rasterize and test, and how many of the
+             boxes a ray cast finds hidden the culler culls
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/TestScenes.h"
+#include "Utility/JobSystem.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t HEIGHTFIELD_SIZE = 96u;
+    constexpr uint32_t HEIGHTFIELD_HEIGHT = 24u;
+    constexpr uint32_t NUM_CAMERAS = 40u;
+    constexpr uint32_t NUM_CANDIDATES = 300u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: run
+      Summary:  Flies the cameras around the heightfield and tests
+                random boxes in and around it against the culler and
+                against the ray cast reference
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void run(const char* pszName, const std::vector<AxisAlignedBox>& aOccluders)
+    {
+        std::mt19937 random(7u);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float halfSize = 0.5f * HEIGHTFIELD_SIZE;
+
+        OcclusionCuller culler;
+        double rasterizeMilliseconds = 0.0;
+        double testNanoseconds = 0.0;
+        uint32_t uNumTriangles = 0u;
+        uint32_t uNumHidden = 0u;
+        uint32_t uNumCulled = 0u;
+        uint32_t uNumWronglyCulled = 0u;
+
+        for (uint32_t uCamera = 0u; uCamera < NUM_CAMERAS; ++uCamera)
+        {
+            float angle = uCamera * 0.157f;
+            float radius = 20.0f + unit(random) * 50.0f;
+            XMFLOAT3 eye(radius * std::cos(angle), 2.0f + unit(random) * 20.0f, radius * std::sin(angle));
+            TestCamera camera =
+            {
+                .Eye = eye,
+                .Direction = XMFLOAT3(-eye.x + unit(random) * 20.0f - 10.0f, -2.0f - 8.0f * unit(random), -eye.z + unit(random) * 20.0f - 10.0f)
+            };
+
+            culler.BeginFrame(GetViewProjection(camera));
+            culler.AddOccluders(aOccluders);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            culler.Rasterize();
+            rasterizeMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            uNumTriangles += culler.GetNumTriangles();
+
+            std::vector<AxisAlignedBox> aCandidates;
+            for (uint32_t i = 0u; i < NUM_CANDIDATES; ++i)
+            {
+                float size = 0.25f + unit(random) * 1.5f;
+                aCandidates.push_back({
+                    .Center = XMFLOAT3((unit(random) * 2.0f - 1.0f) * halfSize, (unit(random) * 1.4f - 0.2f) * HEIGHTFIELD_HEIGHT, (unit(random) * 2.0f - 1.0f) * halfSize),
+                    .Extents = XMFLOAT3(size, size, size)
+                });
+            }
+
+            std::vector<bool> abIsVisible(aCandidates.size());
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0u; i < aCandidates.size(); ++i)
+            {
+                abIsVisible[i] = culler.IsVisible(aCandidates[i]);
+            }
+            testNanoseconds += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / aCandidates.size();
+
+            for (size_t i = 0u; i < aCandidates.size(); ++i)
+            {
+                uint32_t uNumVisibleSamples = CountVisibleSamples(camera, aOccluders, aCandidates[i], OcclusionCuller::WIDTH, OcclusionCuller::HEIGHT);
+                uNumHidden += uNumVisibleSamples == 0u ? 1u : 0u;
+                uNumCulled += abIsVisible[i] ? 0u : 1u;
+                uNumWronglyCulled += !abIsVisible[i] && uNumVisibleSamples > 0u ? 1u : 0u;
+            }
+        }
+
+        std::printf("%-18s %5zu boxes %6u triangles/frame | rasterize %6.3f ms/frame | test %4.0f ns/box | culled %u of %u hidden (%.0f%%), %u wrongly\n",
+            pszName, aOccluders.size(), uNumTriangles / NUM_CAMERAS, rasterizeMilliseconds / NUM_CAMERAS, testNanoseconds / NUM_CAMERAS,
+            uNumCulled - uNumWronglyCulled, uNumHidden, 100.0 * (uNumCulled - uNumWronglyCulled) / (uNumHidden > 0u ? uNumHidden : 1u), uNumWronglyCulled);
+    }
+}
+
+int main()
+{
+    std::printf("%u cameras, %u boxes each, %u threads\n", NUM_CAMERAS, NUM_CANDIDATES, JobSystem::GetDefault().GetNumWorkers() + 1u);
+    run("merged columns", MakeHeightfieldOccluders(HEIGHTFIELD_SIZE, HEIGHTFIELD_SIZE, HEIGHTFIELD_HEIGHT, true));
+    run("one box a column", MakeHeightfieldOccluders(HEIGHTFIELD_SIZE, HEIGHTFIELD_SIZE, HEIGHTFIELD_HEIGHT, false));
+    return 0;
+}
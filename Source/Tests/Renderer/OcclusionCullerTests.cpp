@@ -0,0 +1,150 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLERTESTS.CPP
+
+  Summary:   Rasterizes walls, floors and heightfields of occluder
+             boxes and checks the depth buffer and the visibility of
+             boxes against what a ray cast through the scene sees
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/TestScenes.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    // Camera at the origin looking down +z
+    constexpr TestCamera FORWARD_CAMERA = { .Eye = XMFLOAT3(0.0f, 0.0f, 0.0f), .Direction = XMFLOAT3(0.0f, 0.0f, 1.0f) };
+
+    AxisAlignedBox makeBox(float x, float y, float z, float extentX, float extentY, float extentZ)
+    {
+        return { .Center = XMFLOAT3(x, y, z), .Extents = XMFLOAT3(extentX, extentY, extentZ) };
+    }
+
+    void rasterize(OcclusionCuller& culler, const TestCamera& camera, const std::vector<AxisAlignedBox>& aOccluders)
+    {
+        culler.BeginFrame(GetViewProjection(camera));
+        culler.AddOccluders(aOccluders);
+        culler.Rasterize();
+    }
+}
+
+TEST(OcclusionCullerTests, EmptyBufferHidesOnlyBoxesOffTheScreen)
+{
+    OcclusionCuller culler;
+    rasterize(culler, FORWARD_CAMERA, {});
+
+    EXPECT_EQ(culler.GetNumOccluders(), 0u);
+    EXPECT_EQ(culler.GetNumTriangles(), 0u);
+    for (uint32_t y = 0u; y < OcclusionCuller::HEIGHT; y += 7u)
+    {
+        for (uint32_t x = 0u; x < OcclusionCuller::WIDTH; x += 7u)
+        {
+            EXPECT_EQ(culler.GetDepth(x, y), 1.0f);
+        }
+    }
+
+    EXPECT_TRUE(culler.IsVisible(makeBox(0.0f, 0.0f, 50.0f, 1.0f, 1.0f, 1.0f)));
+    EXPECT_FALSE(culler.IsVisible(makeBox(100.0f, 0.0f, 50.0f, 1.0f, 1.0f, 1.0f)));
+}
+
+TEST(OcclusionCullerTests, WallHidesBoxesBehindIt)
+{
+    OcclusionCuller culler;
+    rasterize(culler, FORWARD_CAMERA, { makeBox(0.0f, 0.0f, 10.0f, 3.0f, 3.0f, 0.5f) });
+
+    EXPECT_EQ(culler.GetNumOccluders(), 1u);
+    EXPECT_GT(culler.GetNumTriangles(), 0u);
+
+    EXPECT_FALSE(culler.IsVisible(makeBox(0.0f, 0.0f, 20.0f, 1.0f, 1.0f, 1.0f)));
+    EXPECT_TRUE(culler.IsVisible(makeBox(0.0f, 0.0f, 5.0f, 1.0f, 1.0f, 1.0f)));
+    EXPECT_TRUE(culler.IsVisible(makeBox(8.0f, 0.0f, 20.0f, 1.0f, 1.0f, 1.0f)));
+
+    // A box that reaches in front of the wall is seen where it does
+    EXPECT_TRUE(culler.IsVisible(makeBox(0.0f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f)));
+}
+
+TEST(OcclusionCullerTests, WallDepthMatchesItsProjection)
+{
+    OcclusionCuller culler;
+    rasterize(culler, FORWARD_CAMERA, { makeBox(0.0f, 0.0f, 10.0f, 3.0f, 3.0f, 0.5f) });
+
+    // The front face is at z = 9.5, whose depth is f / (f - n) * (1 - n / z)
+    XMFLOAT4 clip;
+    XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(0.0f, 0.0f, 9.5f, 1.0f), GetViewProjection(FORWARD_CAMERA)));
+    float expectedDepth = clip.z / clip.w;
+
+    EXPECT_NEAR(culler.GetDepth(OcclusionCuller::WIDTH / 2u, OcclusionCuller::HEIGHT / 2u), expectedDepth, 1.0e-5f);
+    EXPECT_EQ(culler.GetDepth(0u, 0u), 1.0f);
+    EXPECT_EQ(culler.GetDepth(OcclusionCuller::WIDTH - 1u, OcclusionCuller::HEIGHT - 1u), 1.0f);
+}
+
+TEST(OcclusionCullerTests, FloorCrossingTheNearPlaneStillOccludes)
+{
+    // The floor reaches behind the camera, so its top face is clipped
+    OcclusionCuller culler;
+    rasterize(culler, FORWARD_CAMERA, { makeBox(0.0f, -2.0f, 20.0f, 40.0f, 1.0f, 40.0f) });
+
+    EXPECT_GT(culler.GetNumTriangles(), 0u);
+    EXPECT_FALSE(culler.IsVisible(makeBox(0.0f, -6.0f, 15.0f, 1.0f, 1.0f, 1.0f)));
+    EXPECT_TRUE(culler.IsVisible(makeBox(0.0f, 1.0f, 15.0f, 1.0f, 1.0f, 1.0f)));
+}
+
+TEST(OcclusionCullerTests, BoxesCrossingTheNearPlaneAreVisible)
+{
+    OcclusionCuller culler;
+    rasterize(culler, FORWARD_CAMERA, { makeBox(0.0f, 0.0f, 10.0f, 30.0f, 30.0f, 0.5f) });
+
+    EXPECT_TRUE(culler.IsVisible(makeBox(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f)));
+    EXPECT_FALSE(culler.IsVisible(makeBox(0.0f, 0.0f, 20.0f, 1.0f, 1.0f, 1.0f)));
+}
+
+TEST(OcclusionCullerTests, HeightfieldCullsOnlyWhatRaysCannotSee)
+{
+    std::vector<AxisAlignedBox> aOccluders = MakeHeightfieldOccluders(32u, 32u, 8u, true);
+    std::mt19937 random(7u);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    OcclusionCuller culler;
+    uint32_t uNumHidden = 0u;
+    uint32_t uNumCulled = 0u;
+    for (uint32_t uCamera = 0u; uCamera < 6u; ++uCamera)
+    {
+        float angle = uCamera * 1.05f;
+        float radius = 20.0f + unit(random) * 10.0f;
+        TestCamera camera =
+        {
+            .Eye = XMFLOAT3(radius * std::cos(angle), 4.0f + unit(random) * 6.0f, radius * std::sin(angle)),
+            .Direction = XMFLOAT3(-std::cos(angle), -0.2f - 0.2f * unit(random), -std::sin(angle))
+        };
+        rasterize(culler, camera, aOccluders);
+
+        for (uint32_t uBox = 0u; uBox < 40u; ++uBox)
+        {
+            float size = 0.25f + unit(random) * 0.75f;
+            AxisAlignedBox box = makeBox((unit(random) * 2.0f - 1.0f) * 20.0f, -size - unit(random) * 4.0f + 10.0f * unit(random), (unit(random) * 2.0f - 1.0f) * 20.0f, size, size, size);
+
+            // Rays through the pixel centers of the culler, where it samples the occluders
+            uint32_t uNumVisibleSamples = CountVisibleSamples(camera, aOccluders, box, OcclusionCuller::WIDTH, OcclusionCuller::HEIGHT);
+            bool bIsVisible = culler.IsVisible(box);
+            if (!bIsVisible)
+            {
+                EXPECT_EQ(uNumVisibleSamples, 0u) << "camera " << uCamera << " box " << uBox;
+                ++uNumCulled;
+            }
+            uNumHidden += uNumVisibleSamples == 0u ? 1u : 0u;
+        }
+    }
+
+    EXPECT_GT(uNumHidden, 20u);
+    EXPECT_GE(uNumCulled * 5u, uNumHidden * 4u);
+}
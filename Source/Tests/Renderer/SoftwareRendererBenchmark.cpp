@@ -0,0 +1,102 @@
+/*+===================================================================
+  File:      SOFTWARERENDERERBENCHMARK.CPP
+
+  Summary:   Draws voxel terrains of growing size at 1280x720 through
+             the software render backend and prints the time taken
+             per frame against the number of cubes and triangles
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Model/TestMeshes.h"
+#include "Renderer/SoftwareRenderer.h"
+#include "Renderer/TestScenes.h"
+#include "Utility/JobSystem.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t WIDTH = 1280u;
+    constexpr uint32_t HEIGHT = 720u;
+    constexpr uint32_t NUM_FRAMES = 5u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: run
+      Summary:  Draws a square voxel terrain of a size from a camera
+                that keeps it on the screen, and prints the fastest of
+                a few frames
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void run(SoftwareRenderer& renderer, const TestMesh& cube, int32_t iSize)
+    {
+        std::vector<InstanceData> aInstances;
+        for (int32_t z = -iSize / 2; z < iSize / 2; ++z)
+        {
+            for (int32_t x = -iSize / 2; x < iSize / 2; ++x)
+            {
+                int32_t iHeight = 1 + static_cast<int32_t>(4.0f + 3.0f * std::sin(x * 0.2f) * std::cos(z * 0.17f));
+                for (int32_t y = 0; y < iHeight; ++y)
+                {
+                    aInstances.push_back({ .Transformation = XMMatrixTranslation(2.0f * x, 2.0f * y - 10.0f, 2.0f * z) });
+                }
+            }
+        }
+
+        const float distance = 1.4f * iSize;
+        TestCamera camera = { .Eye = XMFLOAT3(0.0f, 0.6f * distance, -distance), .Direction = XMFLOAT3(0.0f, -0.6f, 1.0f) };
+        CBChangeOnCameraMovement cbCamera = { .View = XMMatrixTranspose(GetView(camera)), .CameraPosition = XMFLOAT4(camera.Eye.x, camera.Eye.y, camera.Eye.z, 1.0f) };
+        CBChangeOnResize cbResize = { .Projection = XMMatrixTranspose(GetProjection()) };
+        renderer.SetCamera(cbCamera, cbResize);
+
+        CBLights cbLights = {};
+        cbLights.LightPositions[0] = XMFLOAT4(0.0f, distance, -0.5f * distance, 1.0f);
+        cbLights.LightColors[0] = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        cbLights.LightAttenuationDistance[0] = XMFLOAT4(0.0f, 0.0f, 2.0f * distance * distance, 0.0f);
+        renderer.SetLights(cbLights);
+
+        DrawCommand draw = {};
+        draw.aVertices = cube.aVertices.data();
+        draw.uNumVertices = static_cast<uint32_t>(cube.aVertices.size());
+        draw.aIndices = cube.aIndices.data();
+        draw.uNumIndices = static_cast<uint32_t>(cube.aIndices.size());
+        draw.aInstanceData = aInstances.data();
+        draw.uNumInstances = static_cast<uint32_t>(aInstances.size());
+        draw.Constants.World = XMMatrixTranspose(XMMatrixIdentity());
+        draw.Constants.OutputColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        draw.Shading = eDrawShading::VOXEL;
+
+        double fastestMilliseconds = 1.0e9;
+        for (uint32_t uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+        {
+            renderer.BeginFrame(XMFLOAT4(0.098f, 0.098f, 0.439f, 1.0f));
+            renderer.Draw(draw);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            renderer.Render();
+            fastestMilliseconds = (std::min)(fastestMilliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::printf("%3dx%-3d terrain %7zu cubes %8zu triangles submitted %7u rasterized | %7.2f ms/frame\n",
+            iSize, iSize, aInstances.size(), aInstances.size() * cube.aIndices.size() / 3u, renderer.GetNumTriangles(), fastestMilliseconds);
+    }
+}
+
+int main()
+{
+    std::printf("%ux%u, %u threads, fastest of %u frames\n", WIDTH, HEIGHT, JobSystem::GetDefault().GetNumWorkers() + 1u, NUM_FRAMES);
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    TestMesh cube = MakeCube();
+    for (int32_t iSize : { 16, 32, 64, 128 })
+    {
+        run(renderer, cube, iSize);
+    }
+
+    return 0;
+}
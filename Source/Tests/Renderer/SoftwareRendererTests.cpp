@@ -0,0 +1,572 @@
+/*+===================================================================
+  File:      SOFTWARERENDERERTESTS.CPP
+
+  Summary:   Draws grids, floors and cubes through the software
+             render backend and checks coverage, culling, depth and
+             texture coordinates, then draws lit scenes, one of them a
+             skinned model in the packed vertex formats, and compares
+             them to the golden images next to this file. Setting
+             UPDATE_GOLDEN_IMAGES rewrites the golden images instead
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Model/SkinWeightBuilder.h"
+#include "Model/TestMeshes.h"
+#include "Renderer/BonePalette.h"
+#include "Renderer/SoftwareRenderer.h"
+#include "Renderer/TangentGenerator.h"
+#include "Renderer/TestScenes.h"
+#include "Texture/DDSLayout.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    // 16:9 like the test cameras
+    constexpr uint32_t WIDTH = 256u;
+    constexpr uint32_t HEIGHT = 144u;
+
+    // Compilers may contract the shading math differently, which moves a
+    // channel by one step or flips a pixel on an edge
+    constexpr int GOLDEN_CHANNEL_TOLERANCE = 2;
+    constexpr double GOLDEN_PIXEL_TOLERANCE = 0.005;
+
+    void setCamera(RenderBackend& backend, const TestCamera& camera)
+    {
+        CBChangeOnCameraMovement cbCamera = { .View = XMMatrixTranspose(GetView(camera)), .CameraPosition = XMFLOAT4(camera.Eye.x, camera.Eye.y, camera.Eye.z, 1.0f) };
+        CBChangeOnResize cbResize = { .Projection = XMMatrixTranspose(GetProjection()) };
+        backend.SetCamera(cbCamera, cbResize);
+    }
+
+    // The light is attenuated by attenuation / distance squared
+    CBLights makeLights(const XMFLOAT3& position, float attenuation)
+    {
+        CBLights cbLights = {};
+        cbLights.LightPositions[0] = XMFLOAT4(position.x, position.y, position.z, 1.0f);
+        cbLights.LightColors[0] = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        cbLights.LightAttenuationDistance[0] = XMFLOAT4(0.0f, 0.0f, attenuation, attenuation);
+        return cbLights;
+    }
+
+    DrawCommand makeDraw(const std::vector<SimpleVertex>& aVertices, const std::vector<uint16_t>& aIndices, eDrawShading shading)
+    {
+        DrawCommand draw = {};
+        draw.aVertices = aVertices.data();
+        draw.uNumVertices = static_cast<uint32_t>(aVertices.size());
+        draw.aIndices = aIndices.data();
+        draw.uNumIndices = static_cast<uint32_t>(aIndices.size());
+        draw.Constants.World = XMMatrixTranspose(XMMatrixIdentity());
+        draw.Constants.OutputColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        draw.Shading = shading;
+        return draw;
+    }
+
+    Image makeChecker(uint32_t uSize, uint32_t uCellSize, const XMUINT3& light, const XMUINT3& dark)
+    {
+        Image image = { .uWidth = uSize, .uHeight = uSize, .aPixels = std::vector<uint8_t>(static_cast<size_t>(uSize) * uSize * 4u) };
+        for (uint32_t y = 0u; y < uSize; ++y)
+        {
+            for (uint32_t x = 0u; x < uSize; ++x)
+            {
+                const XMUINT3& color = ((x / uCellSize + y / uCellSize) & 1u) ? light : dark;
+                uint8_t* pPixel = &image.aPixels[(static_cast<size_t>(y) * uSize + x) * 4u];
+                pPixel[0] = static_cast<uint8_t>(color.x);
+                pPixel[1] = static_cast<uint8_t>(color.y);
+                pPixel[2] = static_cast<uint8_t>(color.z);
+                pPixel[3] = 255u;
+            }
+        }
+        return image;
+    }
+
+    // Round bumps, stored the way BC5 stores x and y
+    Image makeBumps(uint32_t uSize, uint32_t uPeriod)
+    {
+        Image image = { .uWidth = uSize, .uHeight = uSize, .aPixels = std::vector<uint8_t>(static_cast<size_t>(uSize) * uSize * 4u) };
+        for (uint32_t y = 0u; y < uSize; ++y)
+        {
+            for (uint32_t x = 0u; x < uSize; ++x)
+            {
+                float slopeX = 0.6f * std::cos(x * XM_2PI / uPeriod);
+                float slopeY = 0.6f * std::cos(y * XM_2PI / uPeriod);
+                uint8_t* pPixel = &image.aPixels[(static_cast<size_t>(y) * uSize + x) * 4u];
+                pPixel[0] = static_cast<uint8_t>(std::lround((slopeX * 0.5f + 0.5f) * 255.0f));
+                pPixel[1] = static_cast<uint8_t>(std::lround((slopeY * 0.5f + 0.5f) * 255.0f));
+                pPixel[2] = 255u;
+                pPixel[3] = 255u;
+            }
+        }
+        return image;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: expectMatchesGoldenImage
+      Summary:  Compares the last frame of a backend to its golden DDS
+                image. A mismatching frame is written next to the test
+                binary as a PPM file to look at
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void expectMatchesGoldenImage(const RenderBackend& backend, const std::string& name)
+    {
+        const std::filesystem::path goldenPath = std::filesystem::path(GOLDEN_IMAGE_DIRECTORY) / (name + ".dds");
+        if (std::getenv("UPDATE_GOLDEN_IMAGES"))
+        {
+            ASSERT_TRUE(backend.WriteFrame(goldenPath)) << goldenPath;
+            return;
+        }
+
+        std::ifstream file(goldenPath, std::ios::binary);
+        ASSERT_TRUE(file) << goldenPath;
+        std::vector<uint8_t> aData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        DDSTextureDesc desc;
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aData.data(), aData.size(), desc, uDataOffset));
+        ASSERT_EQ(desc.uDxgiFormat, static_cast<uint32_t>(eDDSFormat::R8G8B8A8_UNORM));
+
+        const Image& frame = backend.GetFrame();
+        ASSERT_EQ(desc.uWidth, frame.uWidth);
+        ASSERT_EQ(desc.uHeight, frame.uHeight);
+        ASSERT_GE(aData.size(), uDataOffset + frame.aPixels.size());
+
+        size_t uNumMismatches = 0u;
+        int iLargestDifference = 0;
+        for (size_t uPixel = 0u; uPixel < frame.aPixels.size(); uPixel += 4u)
+        {
+            int iDifference = 0;
+            for (size_t uChannel = 0u; uChannel < 4u; ++uChannel)
+            {
+                iDifference = (std::max)(iDifference, std::abs(frame.aPixels[uPixel + uChannel] - aData[uDataOffset + uPixel + uChannel]));
+            }
+            uNumMismatches += iDifference > GOLDEN_CHANNEL_TOLERANCE ? 1u : 0u;
+            iLargestDifference = (std::max)(iLargestDifference, iDifference);
+        }
+
+        const size_t uNumPixels = frame.aPixels.size() / 4u;
+        const bool bMatches = uNumMismatches <= static_cast<size_t>(GOLDEN_PIXEL_TOLERANCE * uNumPixels);
+        EXPECT_TRUE(bMatches) << name << ": " << uNumMismatches << " of " << uNumPixels << " pixels differ, by up to " << iLargestDifference;
+        if (!bMatches)
+        {
+            backend.WriteFrame(name + ".ppm");
+        }
+    }
+}
+
+TEST(SoftwareRendererTests, ClosedGridLeavesNoCracks)
+{
+    // Jittered grid larger than the screen, facing the camera
+    constexpr uint32_t NUM_COLUMNS = 41u;
+    std::mt19937 random(3u);
+    std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+    std::vector<SimpleVertex> aVertices;
+    for (uint32_t uRow = 0u; uRow < NUM_COLUMNS; ++uRow)
+    {
+        for (uint32_t uColumn = 0u; uColumn < NUM_COLUMNS; ++uColumn)
+        {
+            bool bIsInside = uRow > 0u && uRow + 1u < NUM_COLUMNS && uColumn > 0u && uColumn + 1u < NUM_COLUMNS;
+            float x = -12.0f + 24.0f * (uColumn + (bIsInside ? jitter(random) : 0.0f)) / (NUM_COLUMNS - 1u);
+            float y = -7.0f + 14.0f * (uRow + (bIsInside ? jitter(random) : 0.0f)) / (NUM_COLUMNS - 1u);
+            aVertices.push_back({ .Position = XMFLOAT3(x, y, 0.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, -1.0f) });
+        }
+    }
+
+    std::vector<uint16_t> aIndices;
+    std::vector<uint16_t> aReversedIndices;
+    for (uint32_t uRow = 0u; uRow + 1u < NUM_COLUMNS; ++uRow)
+    {
+        for (uint32_t uColumn = 0u; uColumn + 1u < NUM_COLUMNS; ++uColumn)
+        {
+            uint16_t a = static_cast<uint16_t>(uRow * NUM_COLUMNS + uColumn);
+            uint16_t b = static_cast<uint16_t>(a + 1u);
+            uint16_t c = static_cast<uint16_t>(a + NUM_COLUMNS);
+            uint16_t d = static_cast<uint16_t>(c + 1u);
+            aIndices.insert(aIndices.end(), { a, c, b, b, c, d });
+            aReversedIndices.insert(aReversedIndices.end(), { a, b, c, b, d, c });
+        }
+    }
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    setCamera(renderer, { .Eye = XMFLOAT3(0.0f, 0.0f, -10.0f), .Direction = XMFLOAT3(0.0f, 0.0f, 1.0f) });
+
+    DrawCommand draw = makeDraw(aVertices, aIndices, eDrawShading::LIGHT_CUBE);
+    draw.Constants.OutputColor = XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
+    renderer.BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    renderer.Draw(draw);
+    renderer.Render();
+
+    EXPECT_GT(renderer.GetNumTriangles(), 0u);
+    uint32_t uNumUncovered = 0u;
+    for (size_t uPixel = 0u; uPixel < static_cast<size_t>(WIDTH) * HEIGHT; ++uPixel)
+    {
+        uNumUncovered += renderer.GetFrame().aPixels[uPixel * 4u] == 0u ? 1u : 0u;
+    }
+    EXPECT_EQ(uNumUncovered, 0u);
+
+    // Counterclockwise triangles face away
+    draw.aIndices = aReversedIndices.data();
+    renderer.BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    renderer.Draw(draw);
+    renderer.Render();
+
+    EXPECT_EQ(renderer.GetNumTriangles(), 0u);
+}
+
+TEST(SoftwareRendererTests, CubeDepthMatchesItsFrontFace)
+{
+    TestMesh cube = MakeCube();
+    InstanceData instance = { .Transformation = XMMatrixTranslation(0.0f, 0.0f, 10.0f) };
+    TestCamera camera = { .Eye = XMFLOAT3(0.0f, 0.0f, 0.0f), .Direction = XMFLOAT3(0.0f, 0.0f, 1.0f) };
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    setCamera(renderer, camera);
+    renderer.SetLights(makeLights(XMFLOAT3(0.0f, 10.0f, 0.0f), 100.0f));
+
+    DrawCommand draw = makeDraw(cube.aVertices, cube.aIndices, eDrawShading::VOXEL);
+    draw.aInstanceData = &instance;
+    draw.uNumInstances = 1u;
+    renderer.BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    renderer.Draw(draw);
+    renderer.Render();
+
+    // Only the face toward the camera is left
+    EXPECT_EQ(renderer.GetNumTriangles(), 2u);
+
+    XMFLOAT4 clip;
+    XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(0.0f, 0.0f, 9.0f, 1.0f), GetViewProjection(camera)));
+    EXPECT_NEAR(renderer.GetDepth(WIDTH / 2u, HEIGHT / 2u), clip.z / clip.w, 1.0e-5f);
+    EXPECT_EQ(renderer.GetDepth(0u, 0u), 1.0f);
+}
+
+TEST(SoftwareRendererTests, FloorThroughTheNearPlaneCoversTheBottomHalf)
+{
+    // Far larger than the guard band, and reaching behind the camera
+    const std::vector<SimpleVertex> aVertices =
+    {
+        { .Position = XMFLOAT3(-1.0e4f, 0.0f, -1.0e4f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+        { .Position = XMFLOAT3(1.0e4f, 0.0f, -1.0e4f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+        { .Position = XMFLOAT3(-1.0e4f, 0.0f, 1.0e4f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+        { .Position = XMFLOAT3(1.0e4f, 0.0f, 1.0e4f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) }
+    };
+    const std::vector<uint16_t> aIndices = { 0u, 2u, 1u, 1u, 2u, 3u };
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    setCamera(renderer, { .Eye = XMFLOAT3(0.0f, 2.0f, 0.0f), .Direction = XMFLOAT3(0.0f, 0.0f, 1.0f) });
+    renderer.BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    renderer.Draw(makeDraw(aVertices, aIndices, eDrawShading::LIGHT_CUBE));
+    renderer.Render();
+
+    uint32_t uNumWrong = 0u;
+    for (uint32_t y = 0u; y < HEIGHT; ++y)
+    {
+        for (uint32_t x = 0u; x < WIDTH; ++x)
+        {
+            bool bIsCovered = renderer.GetFrame().aPixels[(static_cast<size_t>(y) * WIDTH + x) * 4u] != 0u;
+            uNumWrong += bIsCovered != (y >= HEIGHT / 2u) ? 1u : 0u;
+        }
+    }
+    EXPECT_EQ(uNumWrong, 0u);
+}
+
+TEST(SoftwareRendererTests, TexturesArePerspectiveCorrect)
+{
+    // u goes along z, away from the texels that wrap around
+    Image gradient = { .uWidth = 256u, .uHeight = 1u, .aPixels = std::vector<uint8_t>(256u * 4u) };
+    for (uint32_t x = 0u; x < 256u; ++x)
+    {
+        gradient.aPixels[x * 4u] = static_cast<uint8_t>(x);
+        gradient.aPixels[x * 4u + 3u] = 255u;
+    }
+    const float firstU = 1.0f / 512.0f;
+    const float lastU = 1.0f - 1.0f / 512.0f;
+    const std::vector<SimpleVertex> aVertices =
+    {
+        { .Position = XMFLOAT3(-20.0f, 0.0f, 0.0f), .TexCoord = XMFLOAT2(firstU, 0.5f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+        { .Position = XMFLOAT3(20.0f, 0.0f, 0.0f), .TexCoord = XMFLOAT2(firstU, 0.5f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+        { .Position = XMFLOAT3(-20.0f, 0.0f, 40.0f), .TexCoord = XMFLOAT2(lastU, 0.5f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) },
+        { .Position = XMFLOAT3(20.0f, 0.0f, 40.0f), .TexCoord = XMFLOAT2(lastU, 0.5f), .Normal = XMFLOAT3(0.0f, 1.0f, 0.0f) }
+    };
+    const std::vector<uint16_t> aIndices = { 0u, 2u, 1u, 1u, 2u, 3u };
+    TestCamera camera = { .Eye = XMFLOAT3(0.0f, 2.0f, -1.0f), .Direction = XMFLOAT3(0.0f, -2.0f, 11.0f) };
+
+    // A light far above lights PSVoxel with exactly one, so the color is the albedo
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    setCamera(renderer, camera);
+    renderer.SetLights(makeLights(XMFLOAT3(0.0f, 1.0e4f, 20.0f), 1.0e8f / 1.1f));
+
+    DrawCommand draw = makeDraw(aVertices, aIndices, eDrawShading::VOXEL);
+    draw.pDiffuse = &gradient;
+    renderer.BeginFrame(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    renderer.Draw(draw);
+    renderer.Render();
+
+    // Ray through each pixel center to the floor
+    XMMATRIX inverseViewProjection = XMMatrixInverse(nullptr, GetViewProjection(camera));
+    uint32_t uNumSamples = 0u;
+    float largestError = 0.0f;
+    for (uint32_t y = HEIGHT / 2u + 4u; y < HEIGHT; y += 3u)
+    {
+        for (uint32_t x = 8u; x + 8u < WIDTH; x += 7u)
+        {
+            float ndcX = (x + 0.5f) / WIDTH * 2.0f - 1.0f;
+            float ndcY = 1.0f - (y + 0.5f) / HEIGHT * 2.0f;
+            XMFLOAT3 nearPoint;
+            XMFLOAT3 farPoint;
+            XMStoreFloat3(&nearPoint, XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), inverseViewProjection));
+            XMStoreFloat3(&farPoint, XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), inverseViewProjection));
+            float t = -nearPoint.y / (farPoint.y - nearPoint.y);
+            float z = nearPoint.z + (farPoint.z - nearPoint.z) * t;
+            if (z < 0.5f || z > 39.5f)
+            {
+                continue;
+            }
+
+            float expected = (firstU + (lastU - firstU) * z / 40.0f) * 256.0f - 0.5f;
+            float actual = renderer.GetFrame().aPixels[(static_cast<size_t>(y) * WIDTH + x) * 4u];
+            largestError = (std::max)(largestError, std::fabs(actual - expected));
+            ++uNumSamples;
+        }
+    }
+
+    EXPECT_GT(uNumSamples, 100u);
+    EXPECT_LT(largestError, 3.5f);
+}
+
+TEST(SoftwareRendererTests, InstancedSpheresMatchTheGoldenImage)
+{
+    // The sphere winds clockwise seen from inside
+    TestMesh sphere = MakeSphere(32u, 16u);
+    for (size_t i = 0u; i < sphere.aIndices.size(); i += 3u)
+    {
+        std::swap(sphere.aIndices[i + 1u], sphere.aIndices[i + 2u]);
+    }
+    Image checker = makeChecker(64u, 8u, XMUINT3(230u, 200u, 120u), XMUINT3(60u, 90u, 160u));
+
+    std::vector<InstanceData> aInstances;
+    for (uint32_t i = 0u; i < 6u; ++i)
+    {
+        float angle = i * XM_2PI / 6.0f;
+        float scale = 0.6f + 0.1f * i;
+        aInstances.push_back({ .Transformation = XMMatrixScaling(scale, scale, scale) * XMMatrixTranslation(3.0f * std::cos(angle), 0.0f, 3.0f * std::sin(angle)) });
+    }
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    RenderBackend& backend = renderer;
+    setCamera(backend, { .Eye = XMFLOAT3(0.0f, 3.0f, -8.0f), .Direction = XMFLOAT3(0.0f, -3.0f, 8.0f) });
+    backend.SetLights(makeLights(XMFLOAT3(-4.0f, 6.0f, -4.0f), 80.0f));
+
+    DrawCommand draw = makeDraw(sphere.aVertices, sphere.aIndices, eDrawShading::PHONG);
+    draw.aInstanceData = aInstances.data();
+    draw.uNumInstances = static_cast<uint32_t>(aInstances.size());
+    draw.pDiffuse = &checker;
+    backend.BeginFrame(XMFLOAT4(0.098f, 0.098f, 0.439f, 1.0f));
+    backend.Draw(draw);
+    backend.Render();
+
+    expectMatchesGoldenImage(backend, "InstancedSpheres");
+}
+
+TEST(SoftwareRendererTests, VoxelTerrainMatchesTheGoldenImage)
+{
+    TestMesh cube = MakeCube();
+    Image checker = makeChecker(32u, 8u, XMUINT3(120u, 200u, 90u), XMUINT3(90u, 150u, 70u));
+
+    // The bottom corners of every cube are half occluded
+    std::vector<uint8_t> aAmbientOcclusion;
+    for (const SimpleVertex& vertex : cube.aVertices)
+    {
+        aAmbientOcclusion.push_back(vertex.Position.y < 0.0f ? 128u : 255u);
+    }
+
+    std::vector<InstanceData> aInstances;
+    for (int32_t z = -8; z < 8; ++z)
+    {
+        for (int32_t x = -8; x < 8; ++x)
+        {
+            int32_t iHeight = 1 + static_cast<int32_t>(2.5f + 2.0f * std::sin(x * 0.5f) * std::cos(z * 0.4f));
+            for (int32_t y = 0; y < iHeight; ++y)
+            {
+                aInstances.push_back({ .Transformation = XMMatrixTranslation(2.0f * x, 2.0f * y, 2.0f * z) });
+            }
+        }
+    }
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    RenderBackend& backend = renderer;
+    setCamera(backend, { .Eye = XMFLOAT3(-6.0f, 22.0f, -34.0f), .Direction = XMFLOAT3(6.0f, -20.0f, 34.0f) });
+    backend.SetLights(makeLights(XMFLOAT3(10.0f, 30.0f, -10.0f), 1200.0f));
+
+    DrawCommand draw = makeDraw(cube.aVertices, cube.aIndices, eDrawShading::VOXEL);
+    draw.aAmbientOcclusion = aAmbientOcclusion.data();
+    draw.aInstanceData = aInstances.data();
+    draw.uNumInstances = static_cast<uint32_t>(aInstances.size());
+    draw.pDiffuse = &checker;
+    backend.BeginFrame(XMFLOAT4(0.098f, 0.098f, 0.439f, 1.0f));
+    backend.Draw(draw);
+    backend.Render();
+
+    expectMatchesGoldenImage(backend, "VoxelTerrain");
+}
+
+TEST(SoftwareRendererTests, NormalMappedTerrainMatchesTheGoldenImage)
+{
+    TestMesh terrain = MakeTerrain(32u);
+    Image checker = makeChecker(128u, 16u, XMUINT3(210u, 190u, 160u), XMUINT3(150u, 120u, 100u));
+
+    Image normalMap = makeBumps(64u, 16u);
+
+    // u goes along x and v along z
+    std::vector<NormalData> aNormalData(terrain.aVertices.size(), { .Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f), .Bitangent = XMFLOAT3(0.0f, 0.0f, 1.0f) });
+
+    SoftwareRenderer renderer(WIDTH, HEIGHT);
+    RenderBackend& backend = renderer;
+    setCamera(backend, { .Eye = XMFLOAT3(0.0f, 3.0f, -7.0f), .Direction = XMFLOAT3(0.0f, -3.0f, 8.0f) });
+    backend.SetLights(makeLights(XMFLOAT3(3.0f, 2.0f, 2.0f), 12.0f));
+
+    DrawCommand draw = makeDraw(terrain.aVertices, terrain.aIndices, eDrawShading::PHONG);
+    draw.aNormalData = aNormalData.data();
+    draw.Constants.World = XMMatrixTranspose(XMMatrixTranslation(-0.5f, 0.0f, -0.5f) * XMMatrixScaling(10.0f, 10.0f, 10.0f));
+    draw.Constants.HasNormalMap = 1;
+    draw.pDiffuse = &checker;
+    draw.pNormalMap = &normalMap;
+    backend.BeginFrame(XMFLOAT4(0.098f, 0.098f, 0.439f, 1.0f));
+    backend.Draw(draw);
+    backend.Render();
+
+    expectMatchesGoldenImage(backend, "NormalMappedTerrain");
+}
+
+TEST(SoftwareRendererTests, PackedSkinnedModelMatchesTheGoldenImage)
+{
+    TestSkinnedModel model = LoadMD5Model(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh");
+    ASSERT_FALSE(model.aMeshes.empty());
+    Image checker = makeChecker(64u, 8u, XMUINT3(220u, 180u, 140u), XMUINT3(110u, 80u, 70u));
+    Image normalMap = makeBumps(64u, 16u);
+
+    // A model is packed with the bounds of all its meshes
+    std::vector<SimpleVertex> aAllVertices;
+    for (const TestSkinnedMesh& mesh : model.aMeshes)
+    {
+        aAllVertices.insert(aAllVertices.end(), mesh.mesh.aVertices.begin(), mesh.mesh.aVertices.end());
+    }
+    XMFLOAT4 scale;
+    XMFLOAT4 offset;
+    VertexCompression::ComputePositionBounds(aAllVertices.data(), static_cast<uint32_t>(aAllVertices.size()), scale, offset);
+
+    // Every joint bends a little around its bind position
+    std::vector<BoneTransform3x4> aBoneTransforms(model.aJoints.size());
+    for (size_t i = 0u; i < model.aJoints.size(); ++i)
+    {
+        const XMFLOAT3& position = model.aJoints[i].position;
+        XMMATRIX bone = XMMatrixTranslation(-position.x, -position.y, -position.z) * XMMatrixRotationRollPitchYaw(0.15f * std::sin(i * 1.3f), 0.1f * std::cos(i * 0.7f), 0.2f * std::sin(i * 0.9f))
+            * XMMatrixTranslation(position.x, position.y, position.z);
+        BonePalette::StoreTransposed3x4(bone, aBoneTransforms[i]);
+    }
+
+    std::vector<std::vector<NormalData>> aaNormalData;
+    std::vector<std::vector<AnimationData>> aaAnimationData;
+    std::vector<std::vector<PackedVertex>> aaPackedVertices;
+    std::vector<std::vector<PackedNormalData>> aaPackedNormalData;
+    std::vector<std::vector<PackedAnimationData>> aaPackedAnimationData;
+    for (const TestSkinnedMesh& mesh : model.aMeshes)
+    {
+        const std::vector<SimpleVertex>& aVertices = mesh.mesh.aVertices;
+        const uint32_t uNumVertices = static_cast<uint32_t>(aVertices.size());
+
+        std::vector<NormalData>& aNormalData = aaNormalData.emplace_back(uNumVertices);
+        TangentGenerator::Generate(aVertices.data(), uNumVertices, mesh.mesh.aIndices.data(), static_cast<uint32_t>(mesh.mesh.aIndices.size()), aNormalData.data());
+
+        SkinWeightBuilder builder;
+        builder.Resize(uNumVertices);
+        for (const TestBoneWeight& weight : mesh.aWeights)
+        {
+            builder.AddWeight(weight.uVertex, weight.uJoint, weight.weight);
+        }
+        std::vector<AnimationData>& aAnimationData = aaAnimationData.emplace_back();
+        builder.Build(aAnimationData);
+
+        std::vector<PackedVertex>& aPackedVertices = aaPackedVertices.emplace_back();
+        std::vector<PackedNormalData>& aPackedNormalData = aaPackedNormalData.emplace_back();
+        std::vector<PackedAnimationData>& aPackedAnimationData = aaPackedAnimationData.emplace_back();
+        for (uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            aPackedVertices.push_back(VertexCompression::PackVertex(aVertices[i], scale, offset));
+            aPackedNormalData.push_back(VertexCompression::PackNormalData(aVertices[i].Normal, aNormalData[i]));
+            aPackedAnimationData.push_back(VertexCompression::PackAnimationData(aAnimationData[i]));
+        }
+    }
+
+    // The model stands 67 units tall along z and faces -y
+    const XMMATRIX world = XMMatrixRotationX(-XM_PIDIV2) * XMMatrixRotationY(XM_PI + 0.5f) * XMMatrixTranslation(0.0f, -34.0f, 0.0f);
+    auto render = [&](SoftwareRenderer& renderer, bool bIsPacked)
+    {
+        RenderBackend& backend = renderer;
+        setCamera(backend, { .Eye = XMFLOAT3(0.0f, 4.0f, -100.0f), .Direction = XMFLOAT3(0.0f, -0.05f, 1.0f) });
+        backend.SetLights(makeLights(XMFLOAT3(-40.0f, 50.0f, -60.0f), 12000.0f));
+        backend.BeginFrame(XMFLOAT4(0.098f, 0.098f, 0.439f, 1.0f));
+        for (size_t i = 0u; i < model.aMeshes.size(); ++i)
+        {
+            DrawCommand draw = makeDraw(model.aMeshes[i].mesh.aVertices, model.aMeshes[i].mesh.aIndices, eDrawShading::PHONG);
+            if (bIsPacked)
+            {
+                draw.aVertices = nullptr;
+                draw.aPackedVertices = aaPackedVertices[i].data();
+                draw.aPackedNormalData = aaPackedNormalData[i].data();
+                draw.aPackedAnimationData = aaPackedAnimationData[i].data();
+            }
+            else
+            {
+                draw.aNormalData = aaNormalData[i].data();
+                draw.aAnimationData = aaAnimationData[i].data();
+            }
+            draw.aBoneTransforms = aBoneTransforms.data();
+            draw.uNumBones = static_cast<uint32_t>(aBoneTransforms.size());
+            draw.Constants.World = XMMatrixTranspose(world);
+            draw.Constants.HasNormalMap = 1;
+            draw.Constants.PositionScale = scale;
+            draw.Constants.PositionOffset = offset;
+            draw.pDiffuse = &checker;
+            draw.pNormalMap = &normalMap;
+            backend.Draw(draw);
+        }
+        backend.Render();
+    };
+
+    SoftwareRenderer unpacked(WIDTH, HEIGHT);
+    render(unpacked, false);
+    SoftwareRenderer packed(WIDTH, HEIGHT);
+    render(packed, true);
+
+    // The packed vertices only move edges and shading by a step here and there
+    size_t uNumCovered = 0u;
+    size_t uNumMismatches = 0u;
+    const std::vector<uint8_t>& aBackground = unpacked.GetFrame().aPixels;
+    for (size_t uPixel = 0u; uPixel < aBackground.size(); uPixel += 4u)
+    {
+        uNumCovered += aBackground[uPixel + 2u] != 112u ? 1u : 0u;
+        for (size_t uChannel = 0u; uChannel < 3u; ++uChannel)
+        {
+            if (std::abs(unpacked.GetFrame().aPixels[uPixel + uChannel] - packed.GetFrame().aPixels[uPixel + uChannel]) > 8)
+            {
+                ++uNumMismatches;
+                break;
+            }
+        }
+    }
+    EXPECT_GT(uNumCovered, static_cast<size_t>(WIDTH) * HEIGHT / 20u);
+    EXPECT_LT(uNumMismatches, uNumCovered / 50u);
+
+    expectMatchesGoldenImage(packed, "PackedSkinnedModel");
+}
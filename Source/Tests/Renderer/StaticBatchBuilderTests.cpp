@@ -0,0 +1,285 @@
+/*+===================================================================
+  File:      STATICBATCHBUILDERTESTS.CPP
+
+  Summary:   Checks that static batches draw the same world space
+             triangles with the same materials as the objects they
+             merge, and reports the reduction in draws
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <map>
+
+#include "Renderer/StaticBatchBuilder.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    using Triangle = std::array<float, 18>;
+    using TrianglesByMaterial = std::map<uint32_t, std::vector<Triangle>>;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Box
+      Summary:  Geometry of a prop of six quads per mesh
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Box
+    {
+        std::vector<SimpleVertex> aVertices;
+        std::vector<uint16_t> aIndices;
+        std::vector<NormalData> aNormalData;
+    };
+
+    Box makeBox(uint32_t uNumMeshes, bool bHasNormalData)
+    {
+        Box box;
+        for (uint32_t uFace = 0u; uFace < 6u * uNumMeshes; ++uFace)
+        {
+            for (uint32_t uCorner = 0u; uCorner < 4u; ++uCorner)
+            {
+                box.aVertices.push_back(SimpleVertex{
+                    .Position = XMFLOAT3(static_cast<float>(uFace + uCorner), static_cast<float>(uCorner * uCorner), static_cast<float>(uFace) - uCorner),
+                    .TexCoord = XMFLOAT2(0.0f, 0.0f),
+                    .Normal = XMFLOAT3(0.0f, static_cast<float>(uCorner % 2u), 1.0f),
+                });
+                if (bHasNormalData)
+                {
+                    box.aNormalData.push_back(NormalData{ .Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f), .Bitangent = XMFLOAT3(0.0f, 1.0f, 0.0f) });
+                }
+            }
+        }
+
+        // Every mesh indexes from its own base vertex
+        for (uint32_t uFace = 0u; uFace < 6u; ++uFace)
+        {
+            for (uint16_t uCorner : { 0u, 1u, 2u, 0u, 2u, 3u })
+            {
+                box.aIndices.push_back(static_cast<uint16_t>(uFace * 4u + uCorner));
+            }
+        }
+        for (uint32_t uMesh = 1u; uMesh < uNumMeshes; ++uMesh)
+        {
+            box.aIndices.insert(box.aIndices.end(), box.aIndices.begin(), box.aIndices.begin() + 36);
+        }
+
+        return box;
+    }
+
+    StaticBatchSource makeSource(const Box& box, uint32_t uStateKey, FXMMATRIX world, const std::vector<uint32_t>& auMaterials)
+    {
+        StaticBatchSource source = {
+            .uStateKey = uStateKey,
+            .world = XMFLOAT4X4(),
+            .aVertices = box.aVertices,
+            .aIndices = box.aIndices,
+            .aNormalData = box.aNormalData,
+            .aMeshes = {},
+        };
+        XMStoreFloat4x4(&source.world, world);
+
+        for (uint32_t uMesh = 0u; uMesh < auMaterials.size(); ++uMesh)
+        {
+            source.aMeshes.push_back(StaticBatchMesh{ .uNumIndices = 36u, .uBaseVertex = uMesh * 24u, .uBaseIndex = uMesh * 36u, .uMaterial = auMaterials[uMesh] });
+        }
+
+        return source;
+    }
+
+    Triangle makeTriangle(const SimpleVertex* aVertices, uint32_t uA, uint32_t uB, uint32_t uC)
+    {
+        Triangle triangle;
+        uint32_t auCorners[3] = { uA, uB, uC };
+        for (uint32_t i = 0u; i < 3u; ++i)
+        {
+            const SimpleVertex& vertex = aVertices[auCorners[i]];
+            float afValues[6] = { vertex.Position.x, vertex.Position.y, vertex.Position.z, vertex.Normal.x, vertex.Normal.y, vertex.Normal.z };
+            std::copy(afValues, afValues + 6, triangle.begin() + i * 6u);
+        }
+        return triangle;
+    }
+
+    // Triangles the sources draw one by one, moved to world space the way the vertex shader would
+    TrianglesByMaterial drawSources(const std::vector<StaticBatchSource>& aSources, uint32_t& uNumDraws)
+    {
+        TrianglesByMaterial triangles;
+        uNumDraws = 0u;
+        for (const StaticBatchSource& source : aSources)
+        {
+            XMMATRIX world = XMLoadFloat4x4(&source.world);
+            std::vector<SimpleVertex> aVertices(source.aVertices.begin(), source.aVertices.end());
+            for (SimpleVertex& vertex : aVertices)
+            {
+                XMStoreFloat3(&vertex.Position, XMVector3TransformCoord(XMLoadFloat3(&vertex.Position), world));
+                XMStoreFloat3(&vertex.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&vertex.Normal), world)));
+            }
+
+            std::vector<StaticBatchMesh> aMeshes = source.aMeshes;
+            if (aMeshes.empty())
+            {
+                aMeshes.push_back(StaticBatchMesh{ .uNumIndices = static_cast<uint32_t>(source.aIndices.size()), .uBaseVertex = 0u, .uBaseIndex = 0u, .uMaterial = StaticBatchBuilder::NO_MATERIAL });
+            }
+
+            for (const StaticBatchMesh& mesh : aMeshes)
+            {
+                ++uNumDraws;
+                for (uint32_t i = mesh.uBaseIndex; i < mesh.uBaseIndex + mesh.uNumIndices; i += 3u)
+                {
+                    triangles[mesh.uMaterial].push_back(makeTriangle(
+                        aVertices.data(),
+                        mesh.uBaseVertex + source.aIndices[i],
+                        mesh.uBaseVertex + source.aIndices[i + 1u],
+                        mesh.uBaseVertex + source.aIndices[i + 2u]
+                    ));
+                }
+            }
+        }
+        return triangles;
+    }
+
+    TrianglesByMaterial drawBatches(const std::vector<StaticBatchGeometry>& aBatches, uint32_t& uNumDraws)
+    {
+        TrianglesByMaterial triangles;
+        uNumDraws = 0u;
+        for (const StaticBatchGeometry& batch : aBatches)
+        {
+            EXPECT_LE(batch.aVertices.size(), StaticBatchBuilder::MAX_NUM_VERTICES);
+            for (const StaticBatchMesh& mesh : batch.aMeshes)
+            {
+                ++uNumDraws;
+                for (uint32_t i = mesh.uBaseIndex; i < mesh.uBaseIndex + mesh.uNumIndices; i += 3u)
+                {
+                    triangles[mesh.uMaterial].push_back(makeTriangle(batch.aVertices.data(), batch.aIndices[i], batch.aIndices[i + 1u], batch.aIndices[i + 2u]));
+                }
+            }
+        }
+        return triangles;
+    }
+
+    void expectSameGeometry(const std::vector<StaticBatchSource>& aSources, const std::vector<StaticBatchGeometry>& aBatches)
+    {
+        uint32_t uNumDrawsBefore = 0u;
+        uint32_t uNumDrawsAfter = 0u;
+        TrianglesByMaterial expected = drawSources(aSources, uNumDrawsBefore);
+        TrianglesByMaterial actual = drawBatches(aBatches, uNumDrawsAfter);
+        for (auto& [uMaterial, aTriangles] : expected)
+        {
+            std::sort(aTriangles.begin(), aTriangles.end());
+        }
+        for (auto& [uMaterial, aTriangles] : actual)
+        {
+            std::sort(aTriangles.begin(), aTriangles.end());
+        }
+        EXPECT_TRUE(expected == actual);
+
+        size_t uNumSources = 0u;
+        for (const StaticBatchGeometry& batch : aBatches)
+        {
+            uNumSources += batch.auSources.size();
+            for (uint32_t uSource : batch.auSources)
+            {
+                EXPECT_EQ(aSources[uSource].uStateKey, batch.uStateKey);
+            }
+        }
+        EXPECT_EQ(uNumSources, aSources.size());
+
+        std::printf(
+            "  %zu objects in %zu batches, %u draws -> %u\n",
+            aSources.size(),
+            aBatches.size(),
+            uNumDrawsBefore,
+            uNumDrawsAfter
+        );
+    }
+
+    TEST(StaticBatchBuilder, MergesUntexturedProps)
+    {
+        Box box = makeBox(1u, false);
+        std::vector<StaticBatchSource> aSources;
+        for (uint32_t i = 0u; i < 200u; ++i)
+        {
+            XMMATRIX world = XMMatrixScaling(1.0f + i % 3u, 1.0f, 2.0f) * XMMatrixRotationY(0.1f * i) * XMMatrixTranslation(static_cast<float>(i), 0.0f, -static_cast<float>(i));
+            aSources.push_back(makeSource(box, 0u, world, {}));
+        }
+
+        std::vector<StaticBatchGeometry> aBatches;
+        ASSERT_TRUE(StaticBatchBuilder::Build(aSources, aBatches));
+        ASSERT_EQ(aBatches.size(), 1u);
+        EXPECT_EQ(aBatches[0].aMeshes.size(), 1u);
+        EXPECT_EQ(aBatches[0].aMeshes[0].uMaterial, StaticBatchBuilder::NO_MATERIAL);
+        expectSameGeometry(aSources, aBatches);
+    }
+
+    TEST(StaticBatchBuilder, GroupsMeshesByMaterialWithinAState)
+    {
+        Box box = makeBox(2u, true);
+        std::vector<StaticBatchSource> aSources;
+        for (uint32_t i = 0u; i < 100u; ++i)
+        {
+            XMMATRIX world = XMMatrixRotationX(0.3f * i) * XMMatrixTranslation(0.0f, static_cast<float>(i), 0.0f);
+            aSources.push_back(makeSource(box, i % 4u == 0u ? 1u : 0u, world, { i % 2u, (i + 1u) % 2u }));
+        }
+
+        std::vector<StaticBatchGeometry> aBatches;
+        ASSERT_TRUE(StaticBatchBuilder::Build(aSources, aBatches));
+        ASSERT_EQ(aBatches.size(), 2u);
+        for (const StaticBatchGeometry& batch : aBatches)
+        {
+            EXPECT_EQ(batch.aMeshes.size(), 2u);
+            EXPECT_EQ(batch.aNormalData.size(), batch.aVertices.size());
+        }
+        expectSameGeometry(aSources, aBatches);
+    }
+
+    TEST(StaticBatchBuilder, SplitsBatchesAt16BitIndices)
+    {
+        Box box = makeBox(1u, false);
+        std::vector<StaticBatchSource> aSources;
+        for (uint32_t i = 0u; i < 3000u; ++i)
+        {
+            aSources.push_back(makeSource(box, 0u, XMMatrixTranslation(static_cast<float>(i % 50u), 0.0f, static_cast<float>(i / 50u)), {}));
+        }
+
+        std::vector<StaticBatchGeometry> aBatches;
+        ASSERT_TRUE(StaticBatchBuilder::Build(aSources, aBatches));
+        EXPECT_EQ(aBatches.size(), 2u);
+        expectSameGeometry(aSources, aBatches);
+    }
+
+    TEST(StaticBatchBuilder, KeepsNormalDataOnlyWhenEverySourceHasIt)
+    {
+        Box withNormalData = makeBox(1u, true);
+        Box withoutNormalData = makeBox(1u, false);
+        std::vector<StaticBatchSource> aSources;
+        for (uint32_t i = 0u; i < 10u; ++i)
+        {
+            aSources.push_back(makeSource(i % 2u ? withNormalData : withoutNormalData, 0u, XMMatrixTranslation(static_cast<float>(i), 0.0f, 0.0f), {}));
+        }
+
+        std::vector<StaticBatchGeometry> aBatches;
+        ASSERT_TRUE(StaticBatchBuilder::Build(aSources, aBatches));
+        ASSERT_EQ(aBatches.size(), 2u);
+        EXPECT_TRUE(aBatches[0].aNormalData.empty());
+        EXPECT_EQ(aBatches[1].aNormalData.size(), aBatches[1].aVertices.size());
+        expectSameGeometry(aSources, aBatches);
+    }
+
+    TEST(StaticBatchBuilder, RejectsSourcesLargerThanABatch)
+    {
+        std::vector<SimpleVertex> aVertices(StaticBatchBuilder::MAX_NUM_VERTICES + 1u);
+        std::vector<uint16_t> aIndices = { 0u, 1u, 2u };
+
+        std::vector<StaticBatchSource> aSources(1u);
+        aSources[0].aVertices = aVertices;
+        aSources[0].aIndices = aIndices;
+        XMStoreFloat4x4(&aSources[0].world, XMMatrixIdentity());
+
+        std::vector<StaticBatchGeometry> aBatches;
+        EXPECT_FALSE(StaticBatchBuilder::Build(aSources, aBatches));
+    }
+}
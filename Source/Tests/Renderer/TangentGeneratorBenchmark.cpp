@@ -0,0 +1,118 @@
+/*+===================================================================
+  File:      TANGENTGENERATORBENCHMARK.CPP
+
+  Summary:   Times the tangent generator on the bob lamp meshes and on
+             UV spheres up to 65536 vertices, against the per-face
+             overwrite it replaced, on one job and on every worker
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "Model/TestMeshes.h"
+#include "Renderer/TangentGenerator.h"
+#include "Utility/JobSystem.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t NUM_REPETITIONS = 5u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: overwritePerFace
+      Summary:  What Renderable::calculateNormalMapVectors did before:
+                every face writes its own tangent and bitangent over
+                its three vertices, so the last face wins
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void overwritePerFace(const TestMesh& mesh, NormalData* aNormalData)
+    {
+        for (size_t i = 0u; i + 2u < mesh.aIndices.size(); i += 3u)
+        {
+            const SimpleVertex& v0 = mesh.aVertices[mesh.aIndices[i]];
+            const SimpleVertex& v1 = mesh.aVertices[mesh.aIndices[i + 1u]];
+            const SimpleVertex& v2 = mesh.aVertices[mesh.aIndices[i + 2u]];
+
+            XMVECTOR edge1 = XMVectorSubtract(XMLoadFloat3(&v1.Position), XMLoadFloat3(&v0.Position));
+            XMVECTOR edge2 = XMVectorSubtract(XMLoadFloat3(&v2.Position), XMLoadFloat3(&v0.Position));
+            float du1 = v1.TexCoord.x - v0.TexCoord.x;
+            float dv1 = v1.TexCoord.y - v0.TexCoord.y;
+            float du2 = v2.TexCoord.x - v0.TexCoord.x;
+            float dv2 = v2.TexCoord.y - v0.TexCoord.y;
+            float inverse = 1.0f / (du1 * dv2 - du2 * dv1);
+
+            NormalData normalData;
+            XMStoreFloat3(&normalData.Tangent, XMVector3Normalize(XMVectorScale(XMVectorSubtract(XMVectorScale(edge1, dv2), XMVectorScale(edge2, dv1)), inverse)));
+            XMStoreFloat3(&normalData.Bitangent, XMVector3Normalize(XMVectorScale(XMVectorSubtract(XMVectorScale(edge2, du1), XMVectorScale(edge1, du2)), inverse)));
+            for (size_t k = i; k < i + 3u; ++k)
+            {
+                aNormalData[mesh.aIndices[k]] = normalData;
+            }
+        }
+    }
+
+    double bestMilliseconds(uint32_t uNumRepetitions, const std::function<void()>& run)
+    {
+        double best = HUGE_VAL;
+        for (uint32_t uRepetition = 0u; uRepetition < uNumRepetitions; ++uRepetition)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            run();
+            best = (std::min)(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main()
+{
+    std::vector<TestMesh> aMeshes;
+    TestMesh bobLamp = { .name = "bob lamp (all meshes)", .aVertices = {}, .aIndices = {} };
+    for (const TestMesh& mesh : LoadMD5Meshes(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh"))
+    {
+        uint16_t uBaseVertex = static_cast<uint16_t>(bobLamp.aVertices.size());
+        bobLamp.aVertices.insert(bobLamp.aVertices.end(), mesh.aVertices.begin(), mesh.aVertices.end());
+        for (uint16_t uIndex : mesh.aIndices)
+        {
+            bobLamp.aIndices.push_back(static_cast<uint16_t>(uBaseVertex + uIndex));
+        }
+    }
+    if (bobLamp.aVertices.empty())
+    {
+        std::printf("Could not read the bob lamp md5mesh\n");
+        return 1;
+    }
+
+    aMeshes.push_back(std::move(bobLamp));
+    aMeshes.push_back(MakeSphere(64u, 32u));
+    aMeshes.push_back(MakeSphere(255u, 255u));
+
+    std::printf("best of %u runs, %u threads\n", NUM_REPETITIONS, JobSystem::GetDefault().GetNumWorkers() + 1u);
+    for (const TestMesh& mesh : aMeshes)
+    {
+        uint32_t uNumVertices = static_cast<uint32_t>(mesh.aVertices.size());
+        uint32_t uNumIndices = static_cast<uint32_t>(mesh.aIndices.size());
+        std::vector<NormalData> aNormalData(uNumVertices);
+
+        double overwriteMilliseconds = bestMilliseconds(NUM_REPETITIONS, [&]()
+        {
+            overwritePerFace(mesh, aNormalData.data());
+        });
+        double generateMilliseconds = bestMilliseconds(NUM_REPETITIONS, [&]()
+        {
+            TangentGenerator::Generate(mesh.aVertices.data(), uNumVertices, mesh.aIndices.data(), uNumIndices, aNormalData.data());
+        });
+
+        std::printf("%-22s verts %6u faces %6u | per-face overwrite %7.3f ms | generator %7.3f ms\n",
+            mesh.name.c_str(), uNumVertices, uNumIndices / 3u, overwriteMilliseconds, generateMilliseconds);
+    }
+
+    return 0;
+}
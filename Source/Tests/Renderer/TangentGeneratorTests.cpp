@@ -0,0 +1,278 @@
+/*+===================================================================
+  File:      TANGENTGENERATORTESTS.CPP
+
+  Summary:   Compares the tangent generator with a serial double
+             precision reference of the same accumulation, and checks
+             the frames of a UV sphere against its analytic tangents
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "Model/TestMeshes.h"
+#include "Renderer/TangentGenerator.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    using Vector = std::array<double, 3>;
+
+    constexpr double MAX_REFERENCE_DEGREES = 0.05;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ReferenceFrame
+      Summary:  Tangent frame of the reference. A frame whose summed
+                bitangent is almost perpendicular to cross(normal,
+                tangent) has no clear handedness
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ReferenceFrame
+    {
+        Vector tangent;
+        Vector bitangent;
+        bool bHasFaces;
+        bool bHasClearHandedness;
+    };
+
+    Vector toVector(const XMFLOAT3& value)
+    {
+        return { value.x, value.y, value.z };
+    }
+
+    double dot(const Vector& a, const Vector& b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    Vector cross(const Vector& a, const Vector& b)
+    {
+        return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    }
+
+    Vector normalize(const Vector& value)
+    {
+        double length = std::sqrt(dot(value, value));
+        return length > 1.0e-6 ? Vector{ value[0] / length, value[1] / length, value[2] / length } : Vector{ 0.0, 0.0, 0.0 };
+    }
+
+    Vector projectOnPlane(const Vector& value, const Vector& normal)
+    {
+        double distance = dot(normal, value);
+        return normalize({ value[0] - normal[0] * distance, value[1] - normal[1] * distance, value[2] - normal[2] * distance });
+    }
+
+    double angleDegrees(const Vector& a, const Vector& b)
+    {
+        return std::acos(std::clamp(dot(normalize(a), normalize(b)), -1.0, 1.0)) * 180.0 / std::numbers::pi;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: generateReference
+      Summary:  The accumulation TangentGenerator documents, face by
+                face in double precision
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<ReferenceFrame> generateReference(const TestMesh& mesh)
+    {
+        std::vector<Vector> aNormals;
+        for (const SimpleVertex& vertex : mesh.aVertices)
+        {
+            aNormals.push_back(normalize(toVector(vertex.Normal)));
+        }
+
+        std::vector<std::array<Vector, 2>> aSums(mesh.aVertices.size(), { Vector{ 0.0, 0.0, 0.0 }, Vector{ 0.0, 0.0, 0.0 } });
+        for (size_t i = 0u; i + 2u < mesh.aIndices.size(); i += 3u)
+        {
+            const SimpleVertex* apCorners[3] = { &mesh.aVertices[mesh.aIndices[i]], &mesh.aVertices[mesh.aIndices[i + 1u]], &mesh.aVertices[mesh.aIndices[i + 2u]] };
+            Vector p0 = toVector(apCorners[0]->Position);
+            Vector p1 = toVector(apCorners[1]->Position);
+            Vector p2 = toVector(apCorners[2]->Position);
+            Vector edge1 = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            Vector edge2 = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+            double du1 = static_cast<double>(apCorners[1]->TexCoord.x) - apCorners[0]->TexCoord.x;
+            double dv1 = static_cast<double>(apCorners[1]->TexCoord.y) - apCorners[0]->TexCoord.y;
+            double du2 = static_cast<double>(apCorners[2]->TexCoord.x) - apCorners[0]->TexCoord.x;
+            double dv2 = static_cast<double>(apCorners[2]->TexCoord.y) - apCorners[0]->TexCoord.y;
+            double determinant = du1 * dv2 - du2 * dv1;
+            if (std::fabs(determinant) <= 1.0e-12)
+            {
+                continue;
+            }
+
+            Vector faceTangent;
+            Vector faceBitangent;
+            for (size_t k = 0u; k < 3u; ++k)
+            {
+                faceTangent[k] = (edge1[k] * dv2 - edge2[k] * dv1) / determinant;
+                faceBitangent[k] = (edge2[k] * du1 - edge1[k] * du2) / determinant;
+            }
+
+            for (size_t uCorner = 0u; uCorner < 3u; ++uCorner)
+            {
+                uint16_t uVertex = mesh.aIndices[i + uCorner];
+                const Vector& normal = aNormals[uVertex];
+                Vector position = toVector(apCorners[uCorner]->Position);
+                Vector next = toVector(apCorners[(uCorner + 1u) % 3u]->Position);
+                Vector previous = toVector(apCorners[(uCorner + 2u) % 3u]->Position);
+
+                Vector toNext = projectOnPlane({ next[0] - position[0], next[1] - position[1], next[2] - position[2] }, normal);
+                Vector toPrevious = projectOnPlane({ previous[0] - position[0], previous[1] - position[1], previous[2] - position[2] }, normal);
+                double angle = std::acos(std::clamp(dot(toNext, toPrevious), -1.0, 1.0));
+
+                Vector tangent = projectOnPlane(faceTangent, normal);
+                Vector bitangent = projectOnPlane(faceBitangent, normal);
+                for (size_t k = 0u; k < 3u; ++k)
+                {
+                    aSums[uVertex][0][k] += tangent[k] * angle;
+                    aSums[uVertex][1][k] += bitangent[k] * angle;
+                }
+            }
+        }
+
+        std::vector<ReferenceFrame> aFrames(mesh.aVertices.size());
+        for (size_t i = 0u; i < mesh.aVertices.size(); ++i)
+        {
+            ReferenceFrame& frame = aFrames[i];
+            frame.tangent = projectOnPlane(aSums[i][0], aNormals[i]);
+            frame.bHasFaces = dot(frame.tangent, frame.tangent) > 0.0;
+            frame.bitangent = cross(aNormals[i], frame.tangent);
+
+            double handedness = dot(frame.bitangent, aSums[i][1]);
+            frame.bHasClearHandedness = std::fabs(handedness) > 1.0e-4 * std::sqrt(dot(aSums[i][1], aSums[i][1]));
+            if (handedness < 0.0)
+            {
+                frame.bitangent = { -frame.bitangent[0], -frame.bitangent[1], -frame.bitangent[2] };
+            }
+        }
+
+        return aFrames;
+    }
+
+    std::vector<NormalData> generate(const TestMesh& mesh)
+    {
+        std::vector<NormalData> aNormalData(mesh.aVertices.size());
+        TangentGenerator::Generate(mesh.aVertices.data(), static_cast<uint32_t>(mesh.aVertices.size()), mesh.aIndices.data(), static_cast<uint32_t>(mesh.aIndices.size()), aNormalData.data());
+        return aNormalData;
+    }
+
+    void expectMatchesReference(const TestMesh& mesh)
+    {
+        std::vector<NormalData> aNormalData = generate(mesh);
+        std::vector<ReferenceFrame> aReference = generateReference(mesh);
+
+        double maxTangentDegrees = 0.0;
+        double maxBitangentDegrees = 0.0;
+        for (size_t i = 0u; i < aNormalData.size(); ++i)
+        {
+            Vector normal = normalize(toVector(mesh.aVertices[i].Normal));
+            Vector tangent = toVector(aNormalData[i].Tangent);
+            Vector bitangent = toVector(aNormalData[i].Bitangent);
+
+            // Every frame is orthonormal, including the ones without faces
+            ASSERT_NEAR(dot(tangent, tangent), 1.0, 1.0e-5);
+            ASSERT_NEAR(dot(tangent, normal), 0.0, 1.0e-5);
+            ASSERT_NEAR(std::fabs(dot(bitangent, cross(normal, tangent))), 1.0, 1.0e-5);
+
+            if (!aReference[i].bHasFaces)
+            {
+                continue;
+            }
+
+            maxTangentDegrees = (std::max)(maxTangentDegrees, angleDegrees(tangent, aReference[i].tangent));
+            if (aReference[i].bHasClearHandedness)
+            {
+                maxBitangentDegrees = (std::max)(maxBitangentDegrees, angleDegrees(bitangent, aReference[i].bitangent));
+            }
+        }
+
+        EXPECT_LT(maxTangentDegrees, MAX_REFERENCE_DEGREES) << mesh.name;
+        EXPECT_LT(maxBitangentDegrees, MAX_REFERENCE_DEGREES) << mesh.name;
+    }
+}
+
+TEST(TangentGeneratorTests, BobLampMatchesReference)
+{
+    std::vector<TestMesh> aMeshes = LoadMD5Meshes(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh");
+    ASSERT_FALSE(aMeshes.empty());
+
+    for (const TestMesh& mesh : aMeshes)
+    {
+        expectMatchesReference(mesh);
+    }
+}
+
+TEST(TangentGeneratorTests, SpheresMatchReference)
+{
+    // The larger sphere has enough faces to be split across jobs
+    expectMatchesReference(MakeSphere(64u, 32u));
+    expectMatchesReference(MakeSphere(255u, 255u));
+}
+
+TEST(TangentGeneratorTests, SphereTangentsFollowLongitude)
+{
+    constexpr uint32_t NUM_SEGMENTS = 128u;
+    constexpr uint32_t NUM_RINGS = 64u;
+
+    TestMesh sphere = MakeSphere(NUM_SEGMENTS, NUM_RINGS);
+    std::vector<NormalData> aNormalData = generate(sphere);
+
+    // u grows with the longitude phi, so the tangent is d/dphi away from the poles
+    double maxDegrees = 0.0;
+    for (uint32_t uRing = 1u; uRing < NUM_RINGS; ++uRing)
+    {
+        for (uint32_t uSegment = 0u; uSegment <= NUM_SEGMENTS; ++uSegment)
+        {
+            double phi = 2.0 * std::numbers::pi * uSegment / NUM_SEGMENTS;
+            Vector expected = { -std::sin(phi), 0.0, std::cos(phi) };
+            maxDegrees = (std::max)(maxDegrees, angleDegrees(toVector(aNormalData[uRing * (NUM_SEGMENTS + 1u) + uSegment].Tangent), expected));
+        }
+    }
+
+    EXPECT_LT(maxDegrees, 1.5);
+}
+
+TEST(TangentGeneratorTests, MirroredTexCoordsFlipHandedness)
+{
+    TestMesh sphere = MakeSphere(32u, 16u);
+    TestMesh mirrored = sphere;
+    for (SimpleVertex& vertex : mirrored.aVertices)
+    {
+        vertex.TexCoord.x = 1.0f - vertex.TexCoord.x;
+    }
+
+    std::vector<NormalData> aNormalData = generate(sphere);
+    std::vector<NormalData> aMirroredNormalData = generate(mirrored);
+
+    // Pole vertices only touch faces that meet at a point, skip them
+    for (size_t i = 33u; i + 33u < sphere.aVertices.size(); ++i)
+    {
+        EXPECT_EQ(TangentGenerator::GetHandedness(sphere.aVertices[i].Normal, aNormalData[i]), -TangentGenerator::GetHandedness(mirrored.aVertices[i].Normal, aMirroredNormalData[i]));
+    }
+}
+
+TEST(TangentGeneratorTests, ZeroTexCoordsGivePerpendicularTangents)
+{
+    TestMesh sphere = MakeSphere(8u, 8u);
+    for (SimpleVertex& vertex : sphere.aVertices)
+    {
+        vertex.TexCoord = XMFLOAT2(0.0f, 0.0f);
+    }
+
+    std::vector<NormalData> aNormalData = generate(sphere);
+    for (size_t i = 0u; i < aNormalData.size(); ++i)
+    {
+        Vector tangent = toVector(aNormalData[i].Tangent);
+        Vector bitangent = toVector(aNormalData[i].Bitangent);
+        ASSERT_FALSE(std::isnan(tangent[0]) || std::isnan(bitangent[0]));
+        EXPECT_NEAR(dot(tangent, tangent), 1.0, 1.0e-5);
+        EXPECT_NEAR(dot(tangent, toVector(sphere.aVertices[i].Normal)), 0.0, 1.0e-5);
+    }
+}
@@ -0,0 +1,284 @@
+/*+===================================================================
+  File:      TESTSCENES.CPP
+
+  Summary:   Builds test cameras and heightfield occluders, and ray
+             casts what a camera sees of a box
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Renderer/TestScenes.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace library
+{
+    using namespace DirectX;
+
+    namespace
+    {
+        constexpr float FOV_Y = XM_PIDIV4;
+        constexpr float ASPECT_RATIO = 16.0f / 9.0f;
+        constexpr float NEAR_Z = 0.01f;
+        constexpr float FAR_Z = 1000.0f;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: rayHitsBox
+          Summary:  Slab test of a ray against a box, returning the
+                    distance along the ray where it enters, zero when
+                    it starts inside
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        bool rayHitsBox(const XMFLOAT3& origin, const XMFLOAT3& direction, const AxisAlignedBox& box, float& outDistance)
+        {
+            const float aOrigin[3] = { origin.x, origin.y, origin.z };
+            const float aDirection[3] = { direction.x, direction.y, direction.z };
+            const float aCenter[3] = { box.Center.x, box.Center.y, box.Center.z };
+            const float aExtents[3] = { box.Extents.x, box.Extents.y, box.Extents.z };
+
+            float enter = 0.0f;
+            float exit = FLT_MAX;
+            for (uint32_t uAxis = 0u; uAxis < 3u; ++uAxis)
+            {
+                float inverse = 1.0f / aDirection[uAxis];
+                float first = (aCenter[uAxis] - aExtents[uAxis] - aOrigin[uAxis]) * inverse;
+                float second = (aCenter[uAxis] + aExtents[uAxis] - aOrigin[uAxis]) * inverse;
+                enter = (std::max)(enter, (std::min)(first, second));
+                exit = (std::min)(exit, (std::max)(first, second));
+                if (enter > exit)
+                {
+                    return false;
+                }
+            }
+
+            outDistance = enter;
+            return true;
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetView
+      Summary:  Returns the view matrix of a camera
+      Args:     const TestCamera& camera
+                  Camera
+      Returns:  XMMATRIX
+                  View matrix
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMMATRIX GetView(const TestCamera& camera)
+    {
+        return XMMatrixLookToLH(XMVectorSetW(XMLoadFloat3(&camera.Eye), 1.0f), XMLoadFloat3(&camera.Direction), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetProjection
+      Summary:  Returns the projection matrix every test camera shares,
+                with a 45 degree vertical field of view
+      Returns:  XMMATRIX
+                  Projection matrix
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMMATRIX GetProjection()
+    {
+        return XMMatrixPerspectiveFovLH(FOV_Y, ASPECT_RATIO, NEAR_Z, FAR_Z);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: GetViewProjection
+      Summary:  Returns the view matrix times the projection matrix of
+                a camera
+      Args:     const TestCamera& camera
+                  Camera
+      Returns:  XMMATRIX
+                  View projection matrix
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    XMMATRIX GetViewProjection(const TestCamera& camera)
+    {
+        return XMMatrixMultiply(GetView(camera), GetProjection());
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MakeHeightfieldOccluders
+      Summary:  Builds solid unit columns standing on y = 0 over a
+                rolling heightfield centered on the origin. Merged
+                columns are joined greedily into rectangles of equal
+                height, the way Scene builds the voxel occluders
+      Args:     uint32_t uWidth
+                  Number of columns along x
+                uint32_t uDepth
+                  Number of columns along z
+                uint32_t uMaxHeight
+                  Height of the highest column
+                bool bMergeColumns
+                  Whether to merge columns of equal height
+      Returns:  std::vector<AxisAlignedBox>
+                  Occluder boxes
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<AxisAlignedBox> MakeHeightfieldOccluders(uint32_t uWidth, uint32_t uDepth, uint32_t uMaxHeight, bool bMergeColumns)
+    {
+        std::vector<uint32_t> auHeights(uWidth * uDepth);
+        for (uint32_t z = 0u; z < uDepth; ++z)
+        {
+            for (uint32_t x = 0u; x < uWidth; ++x)
+            {
+                float height = 0.45f + 0.25f * std::sin(x * 0.11f) * std::cos(z * 0.09f) + 0.15f * std::sin(x * 0.31f + z * 0.17f);
+                auHeights[z * uWidth + x] = static_cast<uint32_t>(std::clamp(height, 0.05f, 1.0f) * uMaxHeight);
+            }
+        }
+
+        std::vector<AxisAlignedBox> aOccluders;
+        std::vector<bool> abIsMerged(auHeights.size(), false);
+        for (uint32_t z = 0u; z < uDepth; ++z)
+        {
+            for (uint32_t x = 0u; x < uWidth; ++x)
+            {
+                uint32_t uHeight = auHeights[z * uWidth + x];
+                if (uHeight == 0u || abIsMerged[z * uWidth + x])
+                {
+                    continue;
+                }
+
+                uint32_t uEndX = x + 1u;
+                uint32_t uEndZ = z + 1u;
+                if (bMergeColumns)
+                {
+                    while (uEndX < uWidth && auHeights[z * uWidth + uEndX] == uHeight && !abIsMerged[z * uWidth + uEndX])
+                    {
+                        ++uEndX;
+                    }
+
+                    for (; uEndZ < uDepth; ++uEndZ)
+                    {
+                        bool bIsRowEqual = true;
+                        for (uint32_t uX = x; uX < uEndX && bIsRowEqual; ++uX)
+                        {
+                            bIsRowEqual = auHeights[uEndZ * uWidth + uX] == uHeight && !abIsMerged[uEndZ * uWidth + uX];
+                        }
+
+                        if (!bIsRowEqual)
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                for (uint32_t uZ = z; uZ < uEndZ; ++uZ)
+                {
+                    std::fill(abIsMerged.begin() + uZ * uWidth + x, abIsMerged.begin() + uZ * uWidth + uEndX, true);
+                }
+
+                float minX = static_cast<float>(x) - 0.5f * uWidth;
+                float minZ = static_cast<float>(z) - 0.5f * uDepth;
+                float sizeX = static_cast<float>(uEndX - x);
+                float sizeZ = static_cast<float>(uEndZ - z);
+                aOccluders.push_back({
+                    .Center = XMFLOAT3(minX + 0.5f * sizeX, 0.5f * uHeight, minZ + 0.5f * sizeZ),
+                    .Extents = XMFLOAT3(0.5f * sizeX, 0.5f * uHeight, 0.5f * sizeZ)
+                });
+            }
+        }
+
+        return aOccluders;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: CountVisibleSamples
+      Summary:  Casts a ray through the center of every pixel of a
+                screen of the given size that the box may cover, and
+                counts those that reach the box before any occluder
+      Args:     const TestCamera& camera
+                  Camera
+                const std::vector<AxisAlignedBox>& aOccluders
+                  Occluder boxes
+                const AxisAlignedBox& box
+                  Box to look for
+                uint32_t uWidth
+                  Number of samples across the screen
+                uint32_t uHeight
+                  Number of samples down the screen
+      Returns:  uint32_t
+                  Number of samples that see the box
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    uint32_t CountVisibleSamples(const TestCamera& camera, const std::vector<AxisAlignedBox>& aOccluders, const AxisAlignedBox& box, uint32_t uWidth, uint32_t uHeight)
+    {
+        // Only the samples inside the screen rectangle of the box can hit it
+        XMMATRIX viewProjection = GetViewProjection(camera);
+        float minX = 1.0f;
+        float maxX = -1.0f;
+        float minY = 1.0f;
+        float maxY = -1.0f;
+        bool bCrossesNearPlane = false;
+        for (uint32_t i = 0u; i < 8u; ++i)
+        {
+            XMVECTOR corner = XMVectorSet(
+                box.Center.x + ((i & 1u) ? box.Extents.x : -box.Extents.x),
+                box.Center.y + ((i & 2u) ? box.Extents.y : -box.Extents.y),
+                box.Center.z + ((i & 4u) ? box.Extents.z : -box.Extents.z),
+                1.0f
+            );
+            XMFLOAT4 clip;
+            XMStoreFloat4(&clip, XMVector4Transform(corner, viewProjection));
+            if (clip.w <= NEAR_Z)
+            {
+                bCrossesNearPlane = true;
+                break;
+            }
+
+            minX = (std::min)(minX, clip.x / clip.w);
+            maxX = (std::max)(maxX, clip.x / clip.w);
+            minY = (std::min)(minY, clip.y / clip.w);
+            maxY = (std::max)(maxY, clip.y / clip.w);
+        }
+
+        if (bCrossesNearPlane)
+        {
+            minX = -1.0f;
+            maxX = 1.0f;
+            minY = -1.0f;
+            maxY = 1.0f;
+        }
+
+        int32_t iBeginX = (std::max)(0, static_cast<int32_t>(std::floor((std::max)(minX, -1.0f) * 0.5f * uWidth + 0.5f * uWidth)));
+        int32_t iEndX = (std::min)(static_cast<int32_t>(uWidth) - 1, static_cast<int32_t>(std::floor((std::min)(maxX, 1.0f) * 0.5f * uWidth + 0.5f * uWidth)));
+        int32_t iBeginY = (std::max)(0, static_cast<int32_t>(std::floor((0.5f - 0.5f * (std::min)(maxY, 1.0f)) * uHeight)));
+        int32_t iEndY = (std::min)(static_cast<int32_t>(uHeight) - 1, static_cast<int32_t>(std::floor((0.5f - 0.5f * (std::max)(minY, -1.0f)) * uHeight)));
+
+        XMVECTOR forward = XMVector3Normalize(XMLoadFloat3(&camera.Direction));
+        XMVECTOR right = XMVector3Normalize(XMVector3Cross(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), forward));
+        XMVECTOR up = XMVector3Cross(forward, right);
+        float tanY = std::tan(FOV_Y * 0.5f);
+        float tanX = tanY * ASPECT_RATIO;
+
+        uint32_t uNumVisible = 0u;
+        for (int32_t y = iBeginY; y <= iEndY; ++y)
+        {
+            for (int32_t x = iBeginX; x <= iEndX; ++x)
+            {
+                float ndcX = ((static_cast<float>(x) + 0.5f) / uWidth * 2.0f - 1.0f) * tanX;
+                float ndcY = (1.0f - (static_cast<float>(y) + 0.5f) / uHeight * 2.0f) * tanY;
+                XMFLOAT3 direction;
+                XMStoreFloat3(&direction, XMVector3Normalize(XMVectorAdd(XMVectorAdd(XMVectorScale(right, ndcX), XMVectorScale(up, ndcY)), forward)));
+
+                float boxDistance = 0.0f;
+                if (!rayHitsBox(camera.Eye, direction, box, boxDistance))
+                {
+                    continue;
+                }
+
+                bool bIsBlocked = false;
+                for (const AxisAlignedBox& occluder : aOccluders)
+                {
+                    float occluderDistance = 0.0f;
+                    if (rayHitsBox(camera.Eye, direction, occluder, occluderDistance) && occluderDistance < boxDistance)
+                    {
+                        bIsBlocked = true;
+                        break;
+                    }
+                }
+
+                uNumVisible += bIsBlocked ? 0u : 1u;
+            }
+        }
+
+        return uNumVisible;
+    }
+}
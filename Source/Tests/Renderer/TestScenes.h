@@ -0,0 +1,37 @@
+/*+===================================================================
+  File:      TESTSCENES.H
+
+  Summary:   Scenes the occlusion culling and software rendering
+             tests and benchmarks run on: cameras, voxel-like
+             heightfields turned into occluder boxes, and a ray cast
+             reference of what a camera sees
+
+  Classes:  TestCamera
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Renderer/OcclusionCuller.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TestCamera
+      Summary:  Left-handed perspective camera with a 16:9 screen
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TestCamera
+    {
+        DirectX::XMFLOAT3 Eye;
+        DirectX::XMFLOAT3 Direction;
+    };
+
+    DirectX::XMMATRIX GetView(const TestCamera& camera);
+    DirectX::XMMATRIX GetProjection();
+    DirectX::XMMATRIX GetViewProjection(const TestCamera& camera);
+    std::vector<AxisAlignedBox> MakeHeightfieldOccluders(uint32_t uWidth, uint32_t uDepth, uint32_t uMaxHeight, bool bMergeColumns);
+    uint32_t CountVisibleSamples(const TestCamera& camera, const std::vector<AxisAlignedBox>& aOccluders, const AxisAlignedBox& box, uint32_t uWidth, uint32_t uHeight);
+}
@@ -0,0 +1,133 @@
+/*+===================================================================
+  File:      TRANSFORMSYSTEMBENCHMARK.CPP
+
+  Summary:   Times world matrix updates of 100k transforms, kept as
+             matrices in scattered heap objects like renderables did
+             before, and kept in the transform system with all, some
+             or none of them changed
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Renderer/TransformSystem.h"
+#include "Utility/JobSystem.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t NUM_TRANSFORMS = 100000u;
+    constexpr uint32_t NUM_FRAMES = 20u;
+    constexpr uint32_t NUM_REPETITIONS = 3u;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ScatteredObject
+      Summary:  Stand-in for a renderable that owns its world matrix,
+                with the unrelated state that sits next to it
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ScatteredObject
+    {
+        XMMATRIX world;
+        XMMATRIX transposedWorld;
+        uint8_t aOtherState[384];
+    };
+
+    double bestMilliseconds(const std::function<void()>& frame)
+    {
+        double best = 0.0;
+        for (uint32_t uRepetition = 0u; uRepetition < NUM_REPETITIONS; ++uRepetition)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32_t uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+            {
+                frame();
+            }
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / NUM_FRAMES;
+            best = uRepetition == 0u ? milliseconds : (std::min)(best, milliseconds);
+        }
+        return best;
+    }
+
+    void report(const char* pszName, double milliseconds)
+    {
+        std::printf("  %-34s %8.3f ms/frame %8.2f ns/transform\n", pszName, milliseconds, milliseconds * 1.0e6 / NUM_TRANSFORMS);
+    }
+}
+
+int main()
+{
+    std::printf("%u transforms, best of %u runs of %u frames, %u threads\n", NUM_TRANSFORMS, NUM_REPETITIONS, NUM_FRAMES, JobSystem::GetDefault().GetNumWorkers() + 1u);
+
+    std::mt19937 random(1u);
+    XMVECTOR rotation = XMQuaternionRotationNormal(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), 0.001f);
+    XMMATRIX rotationMatrix = XMMatrixRotationQuaternion(rotation);
+
+    {
+        std::vector<std::shared_ptr<ScatteredObject>> aObjects;
+        std::vector<std::shared_ptr<ScatteredObject>> aFreed;
+        for (uint32_t i = 0u; i < NUM_TRANSFORMS; ++i)
+        {
+            aObjects.push_back(std::make_shared<ScatteredObject>());
+            aObjects.back()->world = XMMatrixTranslation(static_cast<float>(i), 0.0f, 0.0f);
+            if (random() % 2u)
+            {
+                aFreed.push_back(std::make_shared<ScatteredObject>());
+            }
+        }
+        aFreed.clear();
+        std::shuffle(aObjects.begin(), aObjects.end(), random);
+
+        report("scattered matrices, all changed", bestMilliseconds([&]()
+        {
+            for (const std::shared_ptr<ScatteredObject>& pObject : aObjects)
+            {
+                pObject->world = XMMatrixMultiply(pObject->world, rotationMatrix);
+                pObject->transposedWorld = XMMatrixTranspose(pObject->world);
+            }
+        }));
+    }
+
+    TransformSystem transformSystem;
+    std::vector<TransformHandle> aHandles;
+    for (uint32_t i = 0u; i < NUM_TRANSFORMS; ++i)
+    {
+        bool bHasParent = !aHandles.empty() && random() % 4u == 0u;
+        aHandles.push_back(transformSystem.Create(bHasParent ? aHandles[random() % aHandles.size()] : TransformSystem::INVALID_HANDLE));
+        transformSystem.SetPosition(aHandles.back(), XMFLOAT3(static_cast<float>(i), 0.0f, 0.0f));
+    }
+    transformSystem.UpdateWorldMatrices();
+
+    std::vector<TransformHandle> aShuffled = aHandles;
+    std::shuffle(aShuffled.begin(), aShuffled.end(), random);
+
+    for (uint32_t uPercent : { 100u, 10u, 1u, 0u })
+    {
+        uint32_t uNumChanged = NUM_TRANSFORMS * uPercent / 100u;
+        uint32_t uNumUpdated = 0u;
+        double milliseconds = bestMilliseconds([&]()
+        {
+            for (uint32_t i = 0u; i < uNumChanged; ++i)
+            {
+                transformSystem.Rotate(aShuffled[i], rotation);
+            }
+            transformSystem.UpdateWorldMatrices();
+            uNumUpdated = transformSystem.GetNumUpdated();
+        });
+
+        char szName[64];
+        std::snprintf(szName, sizeof(szName), "transform system, %u%% changed", uPercent);
+        report(szName, milliseconds);
+        std::printf("  %-34s %8u rebuilt\n", "", uNumUpdated);
+    }
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+/*+===================================================================
+  File:      TRANSFORMSYSTEMTESTS.CPP
+
+  Summary:   Checks world matrix rebuilds, parent links, slot reuse
+             and that transforms never move while others are created
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Renderer/TransformSystem.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    void expectMatrixNear(FXMMATRIX actual, FXMMATRIX expected)
+    {
+        for (uint32_t uRow = 0u; uRow < 4u; ++uRow)
+        {
+            XMFLOAT4 actualRow;
+            XMFLOAT4 expectedRow;
+            XMStoreFloat4(&actualRow, actual.r[uRow]);
+            XMStoreFloat4(&expectedRow, expected.r[uRow]);
+            EXPECT_NEAR(actualRow.x, expectedRow.x, 1e-5f) << "row " << uRow;
+            EXPECT_NEAR(actualRow.y, expectedRow.y, 1e-5f) << "row " << uRow;
+            EXPECT_NEAR(actualRow.z, expectedRow.z, 1e-5f) << "row " << uRow;
+            EXPECT_NEAR(actualRow.w, expectedRow.w, 1e-5f) << "row " << uRow;
+        }
+    }
+
+    XMFLOAT4 rotationY(float angle)
+    {
+        XMFLOAT4 rotation;
+        XMStoreFloat4(&rotation, XMQuaternionRotationNormal(XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), angle));
+        return rotation;
+    }
+
+    TEST(TransformSystem, ChildWorldIncludesParent)
+    {
+        TransformSystem transformSystem;
+        TransformHandle parent = transformSystem.Create();
+        TransformHandle child = transformSystem.Create(parent);
+
+        transformSystem.SetPosition(parent, XMFLOAT3(1.0f, 2.0f, 3.0f));
+        transformSystem.SetRotation(parent, rotationY(0.5f));
+        transformSystem.SetScale(child, XMFLOAT3(2.0f, 2.0f, 2.0f));
+        transformSystem.SetPosition(child, XMFLOAT3(0.0f, 0.0f, 4.0f));
+        transformSystem.UpdateWorldMatrices();
+
+        XMMATRIX parentWorld = XMMatrixRotationY(0.5f) * XMMatrixTranslation(1.0f, 2.0f, 3.0f);
+        expectMatrixNear(transformSystem.GetWorldMatrix(parent), parentWorld);
+        expectMatrixNear(transformSystem.GetWorldMatrix(child), XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixTranslation(0.0f, 0.0f, 4.0f) * parentWorld);
+    }
+
+    TEST(TransformSystem, RebuildsOnlyDirtyTransformsAndDescendants)
+    {
+        TransformSystem transformSystem;
+        TransformHandle root = transformSystem.Create();
+        TransformHandle child = transformSystem.Create(root);
+        TransformHandle grandChild = transformSystem.Create(child);
+        TransformHandle other = transformSystem.Create();
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_EQ(transformSystem.GetNumUpdated(), 4u);
+
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_EQ(transformSystem.GetNumUpdated(), 0u);
+
+        transformSystem.Translate(root, XMVectorSet(0.0f, 5.0f, 0.0f, 0.0f));
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_EQ(transformSystem.GetNumUpdated(), 3u);
+        EXPECT_FLOAT_EQ(XMVectorGetY(transformSystem.GetWorldMatrix(grandChild).r[3]), 5.0f);
+
+        transformSystem.Translate(other, XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f));
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_EQ(transformSystem.GetNumUpdated(), 1u);
+        EXPECT_FLOAT_EQ(XMVectorGetY(transformSystem.GetWorldMatrix(grandChild).r[3]), 5.0f);
+    }
+
+    TEST(TransformSystem, DestroyMakesChildrenRoots)
+    {
+        TransformSystem transformSystem;
+        TransformHandle parent = transformSystem.Create();
+        TransformHandle child = transformSystem.Create(parent);
+        transformSystem.SetPosition(parent, XMFLOAT3(10.0f, 0.0f, 0.0f));
+        transformSystem.SetPosition(child, XMFLOAT3(1.0f, 0.0f, 0.0f));
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_FLOAT_EQ(XMVectorGetX(transformSystem.GetWorldMatrix(child).r[3]), 11.0f);
+
+        transformSystem.Destroy(parent);
+        EXPECT_FALSE(transformSystem.IsValid(parent));
+        EXPECT_TRUE(transformSystem.IsValid(child));
+
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_FLOAT_EQ(XMVectorGetX(transformSystem.GetWorldMatrix(child).r[3]), 1.0f);
+    }
+
+    TEST(TransformSystem, ReusesSlotsOnlyAfterTheParent)
+    {
+        TransformSystem transformSystem;
+        TransformHandle first = transformSystem.Create();
+        TransformHandle parent = transformSystem.Create();
+        transformSystem.Destroy(first);
+
+        TransformHandle child = transformSystem.Create(parent);
+        EXPECT_GT(child.uIndex, parent.uIndex);
+        EXPECT_EQ(transformSystem.GetNumTransforms(), 3u);
+
+        TransformHandle root = transformSystem.Create();
+        EXPECT_EQ(root.uIndex, first.uIndex);
+        EXPECT_NE(root.uGeneration, first.uGeneration);
+        EXPECT_FALSE(transformSystem.IsValid(first));
+        EXPECT_TRUE(transformSystem.IsValid(root));
+    }
+
+    TEST(TransformSystem, ScaleOfRotatedTransformStaysExact)
+    {
+        TransformSystem transformSystem;
+        TransformHandle handle = transformSystem.Create();
+        transformSystem.SetRotation(handle, rotationY(0.7f));
+        transformSystem.SetPosition(handle, XMFLOAT3(1.0f, 2.0f, 3.0f));
+
+        transformSystem.Scale(handle, XMVectorSet(2.0f, 3.0f, 4.0f, 1.0f));
+        transformSystem.UpdateWorldMatrices();
+
+        EXPECT_FLOAT_EQ(transformSystem.GetScale(handle).x, 2.0f);
+        EXPECT_FLOAT_EQ(transformSystem.GetScale(handle).y, 3.0f);
+        EXPECT_FLOAT_EQ(transformSystem.GetScale(handle).z, 4.0f);
+        expectMatrixNear(
+            transformSystem.GetWorldMatrix(handle),
+            XMMatrixScaling(2.0f, 3.0f, 4.0f) * XMMatrixRotationY(0.7f) * XMMatrixTranslation(2.0f, 6.0f, 12.0f)
+        );
+    }
+
+    TEST(TransformSystem, ZeroScaleIsKept)
+    {
+        TransformSystem transformSystem;
+        TransformHandle handle = transformSystem.Create();
+        transformSystem.SetRotation(handle, rotationY(0.3f));
+
+        transformSystem.Scale(handle, XMVectorSet(0.0f, 1.0f, 1.0f, 1.0f));
+        transformSystem.Scale(handle, XMVectorSet(1.0f, 2.0f, 1.0f, 1.0f));
+        transformSystem.UpdateWorldMatrices();
+
+        EXPECT_FLOAT_EQ(transformSystem.GetScale(handle).x, 0.0f);
+        EXPECT_FLOAT_EQ(transformSystem.GetScale(handle).y, 2.0f);
+        expectMatrixNear(transformSystem.GetWorldMatrix(handle), XMMatrixScaling(0.0f, 2.0f, 1.0f) * XMMatrixRotationY(0.3f));
+    }
+
+    TEST(TransformSystem, TransformsStayInPlaceWhenChunksAreAdded)
+    {
+        TransformSystem transformSystem;
+        TransformHandle handle = transformSystem.Create();
+        transformSystem.SetPosition(handle, XMFLOAT3(7.0f, 8.0f, 9.0f));
+        transformSystem.UpdateWorldMatrices();
+
+        const XMFLOAT3* pPosition = &transformSystem.GetPosition(handle);
+        const XMMATRIX* pWorld = &transformSystem.GetWorldMatrix(handle);
+
+        for (uint32_t i = 0u; i < TransformSystem::CHUNK_SIZE * 3u; ++i)
+        {
+            transformSystem.Create();
+        }
+
+        EXPECT_EQ(&transformSystem.GetPosition(handle), pPosition);
+        EXPECT_EQ(&transformSystem.GetWorldMatrix(handle), pWorld);
+        EXPECT_FLOAT_EQ(pPosition->z, 9.0f);
+    }
+
+    TEST(TransformSystem, CreatesWhileOtherThreadsSetAndRead)
+    {
+        TransformSystem transformSystem;
+        std::vector<TransformHandle> aHandles;
+        for (uint32_t i = 0u; i < 4u; ++i)
+        {
+            aHandles.push_back(transformSystem.Create());
+        }
+
+        std::atomic<bool> bIsDone(false);
+        std::vector<std::thread> aThreads;
+        for (uint32_t i = 0u; i < aHandles.size(); ++i)
+        {
+            aThreads.emplace_back([&transformSystem, &bIsDone, handle = aHandles[i]]()
+            {
+                float value = 0.0f;
+                while (!bIsDone.load())
+                {
+                    value += 1.0f;
+                    transformSystem.SetPosition(handle, XMFLOAT3(value, value, value));
+                    EXPECT_FLOAT_EQ(transformSystem.GetPosition(handle).x, value);
+                }
+            });
+        }
+
+        for (uint32_t i = 0u; i < TransformSystem::CHUNK_SIZE * 4u; ++i)
+        {
+            transformSystem.Create(aHandles[i % aHandles.size()]);
+        }
+        bIsDone.store(true);
+
+        for (std::thread& thread : aThreads)
+        {
+            thread.join();
+        }
+
+        transformSystem.UpdateWorldMatrices();
+        EXPECT_EQ(transformSystem.GetNumUpdated(), TransformSystem::CHUNK_SIZE * 4u + 4u);
+    }
+}
@@ -0,0 +1,248 @@
+/*+===================================================================
+  File:      VERTEXCOMPRESSIONTESTS.CPP
+
+  Summary:   Round-trips vertices, tangent frames and bone weights
+             through the packed formats and checks that the decoded
+             values stay within the precision of each format
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "Model/TestMeshes.h"
+#include "Renderer/VertexCompression.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    static_assert(sizeof(PackedVertex) == 16u);
+    static_assert(sizeof(PackedNormalData) == 4u);
+    static_assert(sizeof(PackedAnimationData) == 8u);
+
+    // Octahedral directions are 16-bit, tangents 10-bit
+    constexpr double MAX_NORMAL_DEGREES = 0.01;
+    constexpr double MAX_TANGENT_DEGREES = 0.25;
+
+    double angleDegrees(const XMFLOAT3& a, const XMFLOAT3& b)
+    {
+        double dot = static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z;
+        double lengths = std::sqrt((static_cast<double>(a.x) * a.x + static_cast<double>(a.y) * a.y + static_cast<double>(a.z) * a.z)
+            * (static_cast<double>(b.x) * b.x + static_cast<double>(b.y) * b.y + static_cast<double>(b.z) * b.z));
+        return std::acos(std::clamp(dot / lengths, -1.0, 1.0)) * 180.0 / std::numbers::pi;
+    }
+
+    XMFLOAT3 randomDirection(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        XMFLOAT3 direction;
+        do
+        {
+            direction = XMFLOAT3(distribution(random), distribution(random), distribution(random));
+        } while (XMVectorGetX(XMVector3LengthSq(XMLoadFloat3(&direction))) < 1.0e-4f);
+
+        XMStoreFloat3(&direction, XMVector3Normalize(XMLoadFloat3(&direction)));
+        return direction;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: expectVerticesRoundTrip
+      Summary:  Packs and unpacks vertices with the bounds of the whole
+                set, and checks the position against half a step of the
+                16-bit grid, the texture coordinates against half a
+                step of a half float and the normal against
+                MAX_NORMAL_DEGREES
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void expectVerticesRoundTrip(const std::vector<SimpleVertex>& aVertices)
+    {
+        XMFLOAT4 scale;
+        XMFLOAT4 offset;
+        VertexCompression::ComputePositionBounds(aVertices.data(), static_cast<uint32_t>(aVertices.size()), scale, offset);
+
+        // Half a quantization step, plus the rounding of the float decode
+        const float aMaxPositionErrors[3] = {
+            scale.x / 65535.0f * 0.5f + std::fabs(offset.x) * 1.0e-6f + 1.0e-6f,
+            scale.y / 65535.0f * 0.5f + std::fabs(offset.y) * 1.0e-6f + 1.0e-6f,
+            scale.z / 65535.0f * 0.5f + std::fabs(offset.z) * 1.0e-6f + 1.0e-6f,
+        };
+
+        double maxNormalDegrees = 0.0;
+        for (const SimpleVertex& vertex : aVertices)
+        {
+            SimpleVertex decoded = VertexCompression::UnpackVertex(VertexCompression::PackVertex(vertex, scale, offset), scale, offset);
+
+            ASSERT_LE(std::fabs(decoded.Position.x - vertex.Position.x), aMaxPositionErrors[0]);
+            ASSERT_LE(std::fabs(decoded.Position.y - vertex.Position.y), aMaxPositionErrors[1]);
+            ASSERT_LE(std::fabs(decoded.Position.z - vertex.Position.z), aMaxPositionErrors[2]);
+
+            // A half float keeps 11 significant bits
+            ASSERT_LE(std::fabs(decoded.TexCoord.x - vertex.TexCoord.x), (std::max)(std::fabs(vertex.TexCoord.x), 6.1e-5f) / 2048.0f);
+            ASSERT_LE(std::fabs(decoded.TexCoord.y - vertex.TexCoord.y), (std::max)(std::fabs(vertex.TexCoord.y), 6.1e-5f) / 2048.0f);
+
+            maxNormalDegrees = (std::max)(maxNormalDegrees, angleDegrees(decoded.Normal, vertex.Normal));
+        }
+
+        EXPECT_LT(maxNormalDegrees, MAX_NORMAL_DEGREES);
+    }
+}
+
+TEST(VertexCompressionTests, OctahedralMappingKeepsAxesAndDiagonals)
+{
+    const XMFLOAT3 aDirections[] = {
+        XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT3(-1.0f, 0.0f, 0.0f),
+        XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, -1.0f, 0.0f),
+        XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 0.0f, -1.0f),
+        XMFLOAT3(0.57735027f, -0.57735027f, -0.57735027f),
+        XMFLOAT3(-0.57735027f, 0.57735027f, -0.57735027f),
+    };
+
+    for (const XMFLOAT3& direction : aDirections)
+    {
+        XMFLOAT2 encoded = VertexCompression::EncodeOctahedral(direction);
+        EXPECT_LE(std::fabs(encoded.x), 1.0f);
+        EXPECT_LE(std::fabs(encoded.y), 1.0f);
+        EXPECT_LT(angleDegrees(VertexCompression::DecodeOctahedral(encoded), direction), 1.0e-3);
+    }
+}
+
+TEST(VertexCompressionTests, OctahedralMappingOfZeroDecodesToZ)
+{
+    XMFLOAT3 decoded = VertexCompression::DecodeOctahedral(VertexCompression::EncodeOctahedral(XMFLOAT3(0.0f, 0.0f, 0.0f)));
+
+    EXPECT_EQ(decoded.x, 0.0f);
+    EXPECT_EQ(decoded.y, 0.0f);
+    EXPECT_EQ(decoded.z, 1.0f);
+}
+
+TEST(VertexCompressionTests, RandomVerticesRoundTrip)
+{
+    std::mt19937 random(7u);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // Off-center and flat boxes, and texture coordinates that tile
+    const float aTexCoordRanges[] = { 1.0f, 4.0f, 32.0f };
+    for (float texCoordRange : aTexCoordRanges)
+    {
+        std::vector<SimpleVertex> aVertices(50000u);
+        for (SimpleVertex& vertex : aVertices)
+        {
+            vertex.Position = XMFLOAT3(distribution(random) * 50.0f, distribution(random) * 5.0f + 100.0f, distribution(random) * 0.5f);
+            vertex.TexCoord = XMFLOAT2(distribution(random) * texCoordRange, distribution(random) * texCoordRange);
+            vertex.Normal = randomDirection(random);
+        }
+
+        expectVerticesRoundTrip(aVertices);
+    }
+}
+
+TEST(VertexCompressionTests, FlatAxisDecodesToItsOffset)
+{
+    std::vector<SimpleVertex> aVertices = {
+        SimpleVertex{ .Position = XMFLOAT3(-1.0f, 2.0f, 3.0f), .TexCoord = XMFLOAT2(0.0f, 0.0f), .Normal = XMFLOAT3(0.0f, 0.0f, 1.0f) },
+        SimpleVertex{ .Position = XMFLOAT3(1.0f, 2.0f, 3.0f), .TexCoord = XMFLOAT2(1.0f, 1.0f), .Normal = XMFLOAT3(0.0f, 0.0f, -1.0f) },
+    };
+
+    XMFLOAT4 scale;
+    XMFLOAT4 offset;
+    VertexCompression::ComputePositionBounds(aVertices.data(), static_cast<uint32_t>(aVertices.size()), scale, offset);
+    EXPECT_EQ(scale.y, 0.0f);
+    EXPECT_EQ(scale.z, 0.0f);
+
+    expectVerticesRoundTrip(aVertices);
+}
+
+TEST(VertexCompressionTests, BobLampVerticesRoundTrip)
+{
+    std::vector<TestMesh> aMeshes = LoadMD5Meshes(CONTENT_DIRECTORY "/BobLampClean/boblampclean.md5mesh");
+    ASSERT_FALSE(aMeshes.empty());
+
+    // A model is packed with the bounds of all its meshes
+    std::vector<SimpleVertex> aVertices;
+    for (const TestMesh& mesh : aMeshes)
+    {
+        aVertices.insert(aVertices.end(), mesh.aVertices.begin(), mesh.aVertices.end());
+    }
+
+    expectVerticesRoundTrip(aVertices);
+}
+
+TEST(VertexCompressionTests, TangentFramesKeepTheirHandedness)
+{
+    std::mt19937 random(7u);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    double maxTangentDegrees = 0.0;
+    double maxBitangentDegrees = 0.0;
+    for (uint32_t i = 0u; i < 100000u; ++i)
+    {
+        XMFLOAT3 normal = randomDirection(random);
+        XMFLOAT3 decodedNormal = VertexCompression::DecodeOctahedral(VertexCompression::EncodeOctahedral(normal));
+
+        // Random frame around the normal with a random handedness
+        XMFLOAT3 axis = randomDirection(random);
+        XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(XMLoadFloat3(&normal), XMLoadFloat3(&axis)));
+        XMVECTOR bitangent = XMVectorScale(XMVector3Cross(XMLoadFloat3(&normal), tangent), distribution(random) < 0.0f ? -1.0f : 1.0f);
+
+        NormalData normalData;
+        XMStoreFloat3(&normalData.Tangent, tangent);
+        XMStoreFloat3(&normalData.Bitangent, bitangent);
+
+        NormalData decoded = VertexCompression::UnpackNormalData(decodedNormal, VertexCompression::PackNormalData(normal, normalData));
+        maxTangentDegrees = (std::max)(maxTangentDegrees, angleDegrees(decoded.Tangent, normalData.Tangent));
+        maxBitangentDegrees = (std::max)(maxBitangentDegrees, angleDegrees(decoded.Bitangent, normalData.Bitangent));
+    }
+
+    EXPECT_LT(maxTangentDegrees, MAX_TANGENT_DEGREES);
+    EXPECT_LT(maxBitangentDegrees, MAX_TANGENT_DEGREES);
+}
+
+TEST(VertexCompressionTests, BoneWeightsAddUpTo255)
+{
+    std::mt19937 random(7u);
+    std::uniform_real_distribution<float> distribution(1.0e-4f, 1.0f);
+    std::uniform_int_distribution<uint32_t> boneDistribution(0u, MAX_NUM_BONES - 1u);
+    std::uniform_int_distribution<uint32_t> countDistribution(1u, MAX_NUM_BONES_PER_VERTEX);
+
+    for (uint32_t i = 0u; i < 100000u; ++i)
+    {
+        float aWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float sum = 0.0f;
+        uint32_t uNumWeights = countDistribution(random);
+        for (uint32_t k = 0u; k < uNumWeights; ++k)
+        {
+            aWeights[k] = distribution(random);
+            sum += aWeights[k];
+        }
+        for (float& weight : aWeights)
+        {
+            weight /= sum;
+        }
+
+        AnimationData animationData;
+        animationData.aBoneIndices = XMUINT4(boneDistribution(random), boneDistribution(random), boneDistribution(random), boneDistribution(random));
+        animationData.aBoneWeights = XMFLOAT4(aWeights[0], aWeights[1], aWeights[2], aWeights[3]);
+
+        PackedAnimationData packed = VertexCompression::PackAnimationData(animationData);
+        ASSERT_EQ(packed.aBoneWeights.x + packed.aBoneWeights.y + packed.aBoneWeights.z + packed.aBoneWeights.w, 255);
+
+        AnimationData decoded = VertexCompression::UnpackAnimationData(packed);
+        ASSERT_EQ(decoded.aBoneIndices.x, animationData.aBoneIndices.x);
+        ASSERT_EQ(decoded.aBoneIndices.y, animationData.aBoneIndices.y);
+        ASSERT_EQ(decoded.aBoneIndices.z, animationData.aBoneIndices.z);
+        ASSERT_EQ(decoded.aBoneIndices.w, animationData.aBoneIndices.w);
+
+        // Rounding moves at most one step, and the remainder of all four onto the largest
+        ASSERT_LE(std::fabs(decoded.aBoneWeights.x - aWeights[0]), 2.0f / 255.0f);
+        ASSERT_LE(std::fabs(decoded.aBoneWeights.y - aWeights[1]), 2.0f / 255.0f);
+        ASSERT_LE(std::fabs(decoded.aBoneWeights.z - aWeights[2]), 2.0f / 255.0f);
+        ASSERT_LE(std::fabs(decoded.aBoneWeights.w - aWeights[3]), 2.0f / 255.0f);
+    }
+}
@@ -0,0 +1,68 @@
+/*+===================================================================
+  File:      TESTWORLDS.CPP
+
+  Summary:   Fills voxel worlds with test terrain
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Scene/TestWorlds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace library
+{
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: MakeTestTerrain
+      Summary:  Resizes a world and fills it with rolling hills of sand,
+                grassland and snow, reaching about a third of its
+                height, then empties random blocks in the lower half
+                and fills random ones anywhere with ocean. The same
+                seed gives the same world
+      Args:     VoxelWorld& world
+                  World to fill
+                uint32_t uWidth
+                  Number of blocks along x
+                uint32_t uHeight
+                  Number of blocks along y
+                uint32_t uDepth
+                  Number of blocks along z
+                uint32_t uSeed
+                  Seed of the caves and floating blocks
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void MakeTestTerrain(VoxelWorld& world, uint32_t uWidth, uint32_t uHeight, uint32_t uDepth, uint32_t uSeed)
+    {
+        world.Resize(uWidth, uHeight, uDepth);
+
+        const float baseHeight = 0.32f * static_cast<float>(uHeight);
+        for (int32_t z = 0; z < static_cast<int32_t>(uDepth); ++z)
+        {
+            for (int32_t x = 0; x < static_cast<int32_t>(uWidth); ++x)
+            {
+                float height = baseHeight * (1.0f + 0.5f * std::sin(x * 0.11f) * std::cos(z * 0.07f) + 0.3f * std::sin((x + z) * 0.23f));
+                int32_t iHeight = std::clamp(static_cast<int32_t>(height), 1, static_cast<int32_t>(uHeight));
+                for (int32_t y = 0; y < iHeight; ++y)
+                {
+                    eBlockType blockType = y < 0.6f * baseHeight ? eBlockType::SAND : (y < 1.1f * baseHeight ? eBlockType::GRASSLAND : eBlockType::SNOW);
+                    world.SetBlock(x, y, z, blockType);
+                }
+            }
+        }
+
+        std::mt19937 random(uSeed);
+        std::uniform_int_distribution<int32_t> randomX(0, static_cast<int32_t>(uWidth) - 1);
+        std::uniform_int_distribution<int32_t> randomY(0, static_cast<int32_t>(uHeight) - 1);
+        std::uniform_int_distribution<int32_t> randomZ(0, static_cast<int32_t>(uDepth) - 1);
+        const uint32_t uNumBlocks = uWidth * uHeight * uDepth;
+        for (uint32_t i = 0u; i < uNumBlocks / 350u; ++i)
+        {
+            world.ClearBlock(randomX(random), randomY(random) / 2, randomZ(random));
+        }
+        for (uint32_t i = 0u; i < uNumBlocks / 1300u; ++i)
+        {
+            world.SetBlock(randomX(random), randomY(random), randomZ(random), eBlockType::OCEAN);
+        }
+    }
+}
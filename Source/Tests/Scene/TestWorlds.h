@@ -0,0 +1,19 @@
+/*+===================================================================
+  File:      TESTWORLDS.H
+
+  Summary:   Voxel worlds the voxel tests and benchmarks run on: hilly
+             terrain of a few block types with caves dug into it and
+             blocks floating above it
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+#include "Scene/VoxelWorld.h"
+
+namespace library
+{
+    void MakeTestTerrain(VoxelWorld& world, uint32_t uWidth, uint32_t uHeight, uint32_t uDepth, uint32_t uSeed);
+}
@@ -0,0 +1,147 @@
+/*+===================================================================
+  File:      VOXELAMBIENTOCCLUSIONBENCHMARK.CPP
+
+  Summary:   Meshes voxel worlds whose faces are occluded more and
+             more often on one thread, and prints the time taken per
+             chunk against how far greedy merging still joins faces,
+             how many vertices are occluded and how many quads flip
+             their diagonal
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Scene/TestWorlds.h"
+#include "Scene/VoxelWorld.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr uint32_t SIZE = 128u;
+    constexpr uint32_t NUM_REPEATS = 10u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makePlain
+      Summary:  Fills a world with a flat floor, with pillars two
+                blocks high standing on random blocks of it
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void makePlain(VoxelWorld& world, uint32_t uNumPillars)
+    {
+        world.Resize(SIZE, VoxelWorld::CHUNK_SIZE, SIZE);
+        for (int32_t z = 0; z < static_cast<int32_t>(SIZE); ++z)
+        {
+            for (int32_t x = 0; x < static_cast<int32_t>(SIZE); ++x)
+            {
+                world.SetBlock(x, 0, z, eBlockType::GRASSLAND);
+            }
+        }
+
+        std::mt19937 random(13u);
+        std::uniform_int_distribution<int32_t> randomCoordinate(0, static_cast<int32_t>(SIZE) - 1);
+        for (uint32_t i = 0u; i < uNumPillars; ++i)
+        {
+            const int32_t x = randomCoordinate(random);
+            const int32_t z = randomCoordinate(random);
+            world.SetBlock(x, 1, z, eBlockType::BARE);
+            world.SetBlock(x, 2, z, eBlockType::BARE);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: countExposedFaces
+      Summary:  Returns the number of faces between a solid block and
+                an empty one, which meshing without merging would emit
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    size_t countExposedFaces(const VoxelWorld& world)
+    {
+        size_t uNumFaces = 0u;
+        for (int32_t y = 0; y < static_cast<int32_t>(world.GetHeight()); ++y)
+        {
+            for (int32_t z = 0; z < static_cast<int32_t>(world.GetDepth()); ++z)
+            {
+                for (int32_t x = 0; x < static_cast<int32_t>(world.GetWidth()); ++x)
+                {
+                    if (world.GetBlock(x, y, z) == VoxelWorld::EMPTY_BLOCK)
+                    {
+                        continue;
+                    }
+
+                    uNumFaces += (world.GetBlock(x - 1, y, z) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u) + (world.GetBlock(x + 1, y, z) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u)
+                        + (world.GetBlock(x, y - 1, z) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u) + (world.GetBlock(x, y + 1, z) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u)
+                        + (world.GetBlock(x, y, z - 1) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u) + (world.GetBlock(x, y, z + 1) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u);
+                }
+            }
+        }
+
+        return uNumFaces;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: run
+      Summary:  Meshes every chunk of a world a few times and prints
+                the fastest run with what the meshes hold
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void run(const char* pszName, const VoxelWorld& world)
+    {
+        std::vector<std::vector<VoxelMesh>> aChunkMeshes(world.GetNumChunks());
+
+        double fastestMilliseconds = 1.0e9;
+        for (uint32_t uRepeat = 0u; uRepeat < NUM_REPEATS; ++uRepeat)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32_t uChunk = 0u; uChunk < world.GetNumChunks(); ++uChunk)
+            {
+                world.MeshChunk(uChunk, aChunkMeshes[uChunk]);
+            }
+            fastestMilliseconds = (std::min)(fastestMilliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        size_t uNumQuads = 0u;
+        size_t uNumOccludedVertices = 0u;
+        size_t uNumFlippedQuads = 0u;
+        for (const std::vector<VoxelMesh>& aMeshes : aChunkMeshes)
+        {
+            for (const VoxelMesh& mesh : aMeshes)
+            {
+                uNumQuads += mesh.aIndices.size() / 6u;
+                uNumOccludedVertices += static_cast<size_t>(std::count_if(mesh.aAmbientOcclusion.begin(), mesh.aAmbientOcclusion.end(), [](uint8_t ambientOcclusion)
+                {
+                    return ambientOcclusion < VoxelWorld::AMBIENT_OCCLUSION_LEVELS[3];
+                }));
+
+                // A flipped quad starts its first triangle at its second corner
+                for (size_t i = 0u; i < mesh.aIndices.size(); i += 6u)
+                {
+                    uNumFlippedQuads += mesh.aIndices[i] % 4u == 1u ? 1u : 0u;
+                }
+            }
+        }
+
+        const size_t uNumFaces = countExposedFaces(world);
+        std::printf("%-14s %4u chunks | %6.2f ms, %5.1f us/chunk | %7zu faces in %6zu quads (%4.1f per quad) | %4.1f%% vertices occluded, %4.1f%% quads flipped\n",
+            pszName, world.GetNumChunks(), fastestMilliseconds, 1000.0 * fastestMilliseconds / world.GetNumChunks(), uNumFaces, uNumQuads,
+            static_cast<double>(uNumFaces) / (uNumQuads > 0u ? uNumQuads : 1u), 100.0 * uNumOccludedVertices / (uNumQuads > 0u ? 4u * uNumQuads : 1u), 100.0 * uNumFlippedQuads / (uNumQuads > 0u ? uNumQuads : 1u));
+    }
+}
+
+int main()
+{
+    std::printf("%ux%u worlds, fastest of %u runs on one thread\n", SIZE, SIZE, NUM_REPEATS);
+
+    VoxelWorld world;
+    makePlain(world, 0u);
+    run("flat plain", world);
+    makePlain(world, 200u);
+    run("200 pillars", world);
+    makePlain(world, 2000u);
+    run("2000 pillars", world);
+    MakeTestTerrain(world, SIZE, 64u, SIZE, 1u);
+    run("terrain", world);
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*+===================================================================
+  File:      VOXELWORLDBENCHMARK.CPP
+
+  Summary:   Casts random rays through 128x64x128 test terrain, edits
+             blocks and remeshes the chunks they dirty, and meshes the
+             whole world on one thread and on the job system, printing
+             the time taken by each
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Scene/TestWorlds.h"
+#include "Scene/VoxelWorld.h"
+#include "Utility/JobSystem.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t WIDTH = 128u;
+    constexpr uint32_t HEIGHT = 64u;
+    constexpr uint32_t DEPTH = 128u;
+    constexpr uint32_t NUM_RAYS = 200000u;
+    constexpr uint32_t NUM_EDITS = 200u;
+    constexpr uint32_t NUM_REPEATS = 10u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: runRaycasts
+      Summary:  Casts rays from above the terrain towards random points
+                of it, the way picking looks down at it, and prints the
+                time per ray
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void runRaycasts(const VoxelWorld& world)
+    {
+        std::mt19937 random(5u);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<XMFLOAT3> aOrigins(NUM_RAYS);
+        std::vector<XMFLOAT3> aDirections(NUM_RAYS);
+        for (uint32_t i = 0u; i < NUM_RAYS; ++i)
+        {
+            XMVECTOR origin = world.GetBlockCenter(static_cast<int32_t>(unit(random) * WIDTH), static_cast<int32_t>(HEIGHT) + 4, static_cast<int32_t>(unit(random) * DEPTH));
+            XMVECTOR target = world.GetBlockCenter(static_cast<int32_t>(unit(random) * WIDTH), static_cast<int32_t>(unit(random) * HEIGHT / 2u), static_cast<int32_t>(unit(random) * DEPTH));
+            XMStoreFloat3(&aOrigins[i], origin);
+            XMStoreFloat3(&aDirections[i], target - origin);
+        }
+
+        const float maxDistance = 2.0f * VoxelWorld::BLOCK_SIZE * static_cast<float>(WIDTH + HEIGHT + DEPTH);
+        uint32_t uNumHits = 0u;
+        double totalDistance = 0.0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0u; i < NUM_RAYS; ++i)
+        {
+            VoxelHit hit;
+            if (world.Raycast(XMLoadFloat3(&aOrigins[i]), XMLoadFloat3(&aDirections[i]), maxDistance, hit))
+            {
+                ++uNumHits;
+                totalDistance += hit.distance / VoxelWorld::BLOCK_SIZE;
+            }
+        }
+        const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("raycast  %7u rays | %6.1f ns/ray | %u hits, %.1f blocks to the hit on average\n",
+            NUM_RAYS, nanoseconds / NUM_RAYS, uNumHits, totalDistance / (uNumHits > 0u ? uNumHits : 1u));
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: runEdits
+      Summary:  Clears and fills random blocks one at a time and
+                remeshes the chunks each edit dirties on the job
+                system, like Scene::UpdateVoxels does every frame
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void runEdits(VoxelWorld& world)
+    {
+        std::mt19937 random(9u);
+        std::uniform_int_distribution<int32_t> randomX(0, static_cast<int32_t>(WIDTH) - 1);
+        std::uniform_int_distribution<int32_t> randomY(0, static_cast<int32_t>(HEIGHT) / 2);
+        std::uniform_int_distribution<int32_t> randomZ(0, static_cast<int32_t>(DEPTH) - 1);
+
+        std::vector<uint32_t> auChunks;
+        world.TakeDirtyChunks(auChunks);
+
+        std::vector<std::vector<VoxelMesh>> aChunkMeshes;
+        double totalMilliseconds = 0.0;
+        double slowestMilliseconds = 0.0;
+        size_t uNumChunks = 0u;
+        for (uint32_t uEdit = 0u; uEdit < NUM_EDITS; ++uEdit)
+        {
+            if (uEdit % 2u == 0u)
+            {
+                world.ClearBlock(randomX(random), randomY(random), randomZ(random));
+            }
+            else
+            {
+                world.SetBlock(randomX(random), randomY(random), randomZ(random), eBlockType::TUNDRA);
+            }
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            world.TakeDirtyChunks(auChunks);
+            aChunkMeshes.resize((std::max)(aChunkMeshes.size(), auChunks.size()));
+            JobSystem::GetDefault().ParallelFor(static_cast<uint32_t>(auChunks.size()), 1u, [&](uint32_t uBegin, uint32_t uEnd)
+            {
+                for (uint32_t i = uBegin; i < uEnd; ++i)
+                {
+                    world.MeshChunk(auChunks[i], aChunkMeshes[i]);
+                }
+            });
+            const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            totalMilliseconds += milliseconds;
+            slowestMilliseconds = (std::max)(slowestMilliseconds, milliseconds);
+            uNumChunks += auChunks.size();
+        }
+
+        std::printf("edit     %7u edits | %6.3f ms/edit, %6.3f ms at worst | %.2f chunks remeshed per edit\n",
+            NUM_EDITS, totalMilliseconds / NUM_EDITS, slowestMilliseconds, static_cast<double>(uNumChunks) / NUM_EDITS);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: runMeshing
+      Summary:  Meshes every chunk of the world and prints the fastest
+                of a few runs, with the size of the meshes
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void runMeshing(const VoxelWorld& world, bool bIsParallel)
+    {
+        std::vector<std::vector<VoxelMesh>> aChunkMeshes(world.GetNumChunks());
+
+        double fastestMilliseconds = 1.0e9;
+        for (uint32_t uRepeat = 0u; uRepeat < NUM_REPEATS; ++uRepeat)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if (bIsParallel)
+            {
+                JobSystem::GetDefault().ParallelFor(world.GetNumChunks(), 4u, [&](uint32_t uBegin, uint32_t uEnd)
+                {
+                    for (uint32_t uChunk = uBegin; uChunk < uEnd; ++uChunk)
+                    {
+                        world.MeshChunk(uChunk, aChunkMeshes[uChunk]);
+                    }
+                });
+            }
+            else
+            {
+                for (uint32_t uChunk = 0u; uChunk < world.GetNumChunks(); ++uChunk)
+                {
+                    world.MeshChunk(uChunk, aChunkMeshes[uChunk]);
+                }
+            }
+            fastestMilliseconds = (std::min)(fastestMilliseconds, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        size_t uNumQuads = 0u;
+        for (const std::vector<VoxelMesh>& aMeshes : aChunkMeshes)
+        {
+            for (const VoxelMesh& mesh : aMeshes)
+            {
+                uNumQuads += mesh.aIndices.size() / 6u;
+            }
+        }
+
+        std::printf("mesh     %7u chunks | %6.2f ms, %6.1f us/chunk %-11s | %zu quads\n",
+            world.GetNumChunks(), fastestMilliseconds, 1000.0 * fastestMilliseconds / world.GetNumChunks(), bIsParallel ? "(jobs)" : "(1 thread)", uNumQuads);
+    }
+}
+
+int main()
+{
+    std::printf("%ux%ux%u terrain, %u threads\n", WIDTH, HEIGHT, DEPTH, JobSystem::GetDefault().GetNumWorkers() + 1u);
+
+    VoxelWorld world;
+    MakeTestTerrain(world, WIDTH, HEIGHT, DEPTH, 1u);
+
+    runRaycasts(world);
+    runMeshing(world, false);
+    runMeshing(world, true);
+    runEdits(world);
+    return 0;
+}
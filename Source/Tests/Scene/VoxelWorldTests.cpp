@@ -0,0 +1,385 @@
+/*+===================================================================
+  File:      VOXELWORLDTESTS.CPP
+
+  Summary:   Casts rays through test terrain against a fine march
+             along the same rays, checks which chunks edits mark dirty,
+             and checks the chunk meshes cover exactly the faces
+             between solid and empty blocks, with the ambient occlusion
+             of the corner rule at every vertex
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "Scene/TestWorlds.h"
+#include "Scene/VoxelWorld.h"
+
+namespace
+{
+    using namespace library;
+    using namespace DirectX;
+
+    constexpr uint32_t WIDTH = 40u;
+    constexpr uint32_t HEIGHT = 24u;
+    constexpr uint32_t DEPTH = 36u;
+    constexpr float MARCH_STEP = 0.002f * VoxelWorld::BLOCK_SIZE;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: march
+      Summary:  Steps along a ray MARCH_STEP at a time and returns
+                the distance to the first solid block it is in
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool march(const VoxelWorld& world, const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, float& outDistance)
+    {
+        XMFLOAT3 corner;
+        XMStoreFloat3(&corner, world.GetBlockCenter(0, 0, 0) - XMVectorReplicate(0.5f * VoxelWorld::BLOCK_SIZE));
+
+        for (uint32_t uStep = 0u; uStep * MARCH_STEP <= maxDistance; ++uStep)
+        {
+            const float distance = uStep * MARCH_STEP;
+            const int32_t x = static_cast<int32_t>(std::floor((origin.x + direction.x * distance - corner.x) / VoxelWorld::BLOCK_SIZE));
+            const int32_t y = static_cast<int32_t>(std::floor((origin.y + direction.y * distance - corner.y) / VoxelWorld::BLOCK_SIZE));
+            const int32_t z = static_cast<int32_t>(std::floor((origin.z + direction.z * distance - corner.z) / VoxelWorld::BLOCK_SIZE));
+            if (world.GetBlock(x, y, z) != VoxelWorld::EMPTY_BLOCK)
+            {
+                outDistance = distance;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: takeDirtyChunks
+      Summary:  Returns the sorted dirty chunks of a world
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<uint32_t> takeDirtyChunks(VoxelWorld& world)
+    {
+        std::vector<uint32_t> auChunks;
+        world.TakeDirtyChunks(auChunks);
+        std::sort(auChunks.begin(), auChunks.end());
+        return auChunks;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: getBlockCorner
+      Summary:  Returns the grid point of the blocks a mesh vertex lies
+                on, in blocks
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void getBlockCorner(const VoxelWorld& world, const XMFLOAT3& position, int32_t* aiOutCorner)
+    {
+        XMFLOAT3 corner;
+        XMStoreFloat3(&corner, world.GetBlockCenter(0, 0, 0) - XMVectorReplicate(0.5f * VoxelWorld::BLOCK_SIZE));
+
+        aiOutCorner[0] = static_cast<int32_t>(std::lround((position.x - corner.x) / VoxelWorld::BLOCK_SIZE));
+        aiOutCorner[1] = static_cast<int32_t>(std::lround((position.y - corner.y) / VoxelWorld::BLOCK_SIZE));
+        aiOutCorner[2] = static_cast<int32_t>(std::lround((position.z - corner.z) / VoxelWorld::BLOCK_SIZE));
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: getLevel
+      Summary:  Returns which of AMBIENT_OCCLUSION_LEVELS a vertex has,
+                0 being the darkest, or -1 for any other value
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    int32_t getLevel(uint8_t ambientOcclusion)
+    {
+        const uint8_t* pLevel = std::find(std::begin(VoxelWorld::AMBIENT_OCCLUSION_LEVELS), std::end(VoxelWorld::AMBIENT_OCCLUSION_LEVELS), ambientOcclusion);
+        return pLevel == std::end(VoxelWorld::AMBIENT_OCCLUSION_LEVELS) ? -1 : static_cast<int32_t>(pLevel - std::begin(VoxelWorld::AMBIENT_OCCLUSION_LEVELS));
+    }
+}
+
+TEST(VoxelWorldTests, RaycastMatchesAFineMarch)
+{
+    VoxelWorld world;
+    MakeTestTerrain(world, WIDTH, HEIGHT, DEPTH, 3u);
+
+    std::mt19937 random(11u);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float maxDistance = 2.0f * VoxelWorld::BLOCK_SIZE * static_cast<float>(WIDTH + HEIGHT + DEPTH);
+    const XMVECTOR corner = world.GetBlockCenter(0, 0, 0) - XMVectorReplicate(0.5f * VoxelWorld::BLOCK_SIZE);
+    const XMVECTOR size = XMVectorSet(WIDTH, HEIGHT, DEPTH, 0.0f) * VoxelWorld::BLOCK_SIZE;
+
+    uint32_t uNumHits = 0u;
+    uint32_t uNumMisses = 0u;
+    for (uint32_t uRay = 0u; uRay < 300u; ++uRay)
+    {
+        // Half of the rays start inside the world, the others around it, all aim at a point inside it
+        const float spread = uRay % 2u == 0u ? 1.0f : 3.0f;
+        XMFLOAT3 origin;
+        XMStoreFloat3(&origin, corner + size * XMVectorSet(spread * unit(random), spread * unit(random), spread * unit(random), 0.0f) - size * (0.5f * spread - 0.5f));
+        const XMVECTOR target = corner + size * XMVectorSet(unit(random), unit(random), unit(random), 0.0f);
+        XMFLOAT3 direction;
+        XMStoreFloat3(&direction, XMVector3Normalize(target - XMLoadFloat3(&origin)));
+
+        VoxelHit hit;
+        const bool bIsHit = world.Raycast(XMLoadFloat3(&origin), XMLoadFloat3(&direction), maxDistance, hit);
+
+        float marchedDistance = 0.0f;
+        const bool bIsMarchedHit = march(world, origin, direction, maxDistance, marchedDistance);
+        ASSERT_EQ(bIsHit, bIsMarchedHit) << "ray " << uRay;
+        if (!bIsHit)
+        {
+            ++uNumMisses;
+            continue;
+        }
+
+        // Rays grazing an edge may enter either block, so the distances are compared rather than the blocks
+        ++uNumHits;
+        EXPECT_NE(world.GetBlock(hit.Block.x, hit.Block.y, hit.Block.z), VoxelWorld::EMPTY_BLOCK) << "ray " << uRay;
+        EXPECT_NEAR(hit.distance, marchedDistance, 2.0f * MARCH_STEP) << "ray " << uRay;
+
+        // The hit point lies on the block, and the normal points to the empty block the ray came from
+        XMVECTOR point = XMLoadFloat3(&origin) + XMLoadFloat3(&direction) * hit.distance;
+        XMFLOAT3 offset;
+        XMStoreFloat3(&offset, XMVectorAbs(point - world.GetBlockCenter(hit.Block.x, hit.Block.y, hit.Block.z)));
+        EXPECT_LE((std::max)({ offset.x, offset.y, offset.z }), 0.5f * VoxelWorld::BLOCK_SIZE + 1.0e-3f) << "ray " << uRay;
+
+        const int32_t iNormalLength = std::abs(hit.Normal.x) + std::abs(hit.Normal.y) + std::abs(hit.Normal.z);
+        if (iNormalLength > 0)
+        {
+            EXPECT_EQ(iNormalLength, 1) << "ray " << uRay;
+            EXPECT_EQ(world.GetBlock(hit.Block.x + hit.Normal.x, hit.Block.y + hit.Normal.y, hit.Block.z + hit.Normal.z), VoxelWorld::EMPTY_BLOCK) << "ray " << uRay;
+        }
+    }
+
+    EXPECT_GT(uNumHits, 50u);
+    EXPECT_GT(uNumMisses, 10u);
+}
+
+TEST(VoxelWorldTests, RaycastStopsAtItsLength)
+{
+    VoxelWorld world;
+    world.Resize(8u, 8u, 8u);
+    ASSERT_TRUE(world.SetBlock(4, 4, 6, eBlockType::SAND));
+
+    const XMVECTOR origin = world.GetBlockCenter(4, 4, 1);
+    const XMVECTOR direction = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+
+    VoxelHit hit;
+    ASSERT_TRUE(world.Raycast(origin, direction, 100.0f, hit));
+    EXPECT_EQ(hit.Block.z, 6);
+    EXPECT_EQ(hit.Normal.z, -1);
+    EXPECT_FLOAT_EQ(hit.distance, 4.5f * VoxelWorld::BLOCK_SIZE);
+
+    EXPECT_FALSE(world.Raycast(origin, direction, 4.0f * VoxelWorld::BLOCK_SIZE, hit));
+    EXPECT_FALSE(world.Raycast(origin, -direction, 100.0f, hit));
+    EXPECT_FALSE(world.Raycast(origin, XMVectorZero(), 100.0f, hit));
+}
+
+TEST(VoxelWorldTests, EditsDirtyTheChunksAroundTheBlock)
+{
+    VoxelWorld world;
+    world.Resize(3u * VoxelWorld::CHUNK_SIZE, 2u * VoxelWorld::CHUNK_SIZE, 3u * VoxelWorld::CHUNK_SIZE);
+    EXPECT_EQ(takeDirtyChunks(world).size(), world.GetNumChunks());
+    EXPECT_TRUE(takeDirtyChunks(world).empty());
+
+    // Chunks are numbered x fastest, then z, then y
+    const int32_t iMiddle = static_cast<int32_t>(VoxelWorld::CHUNK_SIZE) + 8;
+    ASSERT_TRUE(world.SetBlock(iMiddle, 8, iMiddle, eBlockType::SAND));
+    EXPECT_EQ(takeDirtyChunks(world), std::vector<uint32_t>({ 4u }));
+
+    // Setting the same type again changes nothing
+    ASSERT_TRUE(world.SetBlock(iMiddle, 8, iMiddle, eBlockType::SAND));
+    EXPECT_TRUE(takeDirtyChunks(world).empty());
+
+    // A block on the corner of a chunk shades the corners of its neighbours
+    const int32_t iEdge = static_cast<int32_t>(VoxelWorld::CHUNK_SIZE) - 1;
+    ASSERT_TRUE(world.SetBlock(iEdge, iEdge, iEdge, eBlockType::SNOW));
+    EXPECT_EQ(takeDirtyChunks(world), std::vector<uint32_t>({ 0u, 1u, 3u, 4u, 9u, 10u, 12u, 13u }));
+
+    ASSERT_TRUE(world.ClearBlock(iEdge, iEdge, iEdge));
+    EXPECT_EQ(takeDirtyChunks(world).size(), 8u);
+    EXPECT_EQ(world.GetBlock(iEdge, iEdge, iEdge), VoxelWorld::EMPTY_BLOCK);
+
+    EXPECT_FALSE(world.SetBlock(-1, 0, 0, eBlockType::SAND));
+    EXPECT_FALSE(world.ClearBlock(0, static_cast<int32_t>(world.GetHeight()), 0));
+    EXPECT_TRUE(takeDirtyChunks(world).empty());
+}
+
+TEST(VoxelWorldTests, MeshesCoverEveryExposedFaceOnce)
+{
+    VoxelWorld world;
+    MakeTestTerrain(world, WIDTH, HEIGHT, DEPTH, 5u);
+
+    uint32_t uNumExposedFaces = 0u;
+    for (int32_t y = 0; y < static_cast<int32_t>(HEIGHT); ++y)
+    {
+        for (int32_t z = 0; z < static_cast<int32_t>(DEPTH); ++z)
+        {
+            for (int32_t x = 0; x < static_cast<int32_t>(WIDTH); ++x)
+            {
+                if (world.GetBlock(x, y, z) == VoxelWorld::EMPTY_BLOCK)
+                {
+                    continue;
+                }
+
+                const int32_t aaiNeighbours[6][3] = { { x - 1, y, z }, { x + 1, y, z }, { x, y - 1, z }, { x, y + 1, z }, { x, y, z - 1 }, { x, y, z + 1 } };
+                for (const int32_t* aiNeighbour : aaiNeighbours)
+                {
+                    uNumExposedFaces += world.GetBlock(aiNeighbour[0], aiNeighbour[1], aiNeighbour[2]) == VoxelWorld::EMPTY_BLOCK ? 1u : 0u;
+                }
+            }
+        }
+    }
+
+    std::vector<VoxelMesh> aMeshes;
+    double meshedArea = 0.0;
+    uint32_t uNumQuads = 0u;
+    for (uint32_t uChunk = 0u; uChunk < world.GetNumChunks(); ++uChunk)
+    {
+        world.MeshChunk(uChunk, aMeshes);
+        for (const VoxelMesh& mesh : aMeshes)
+        {
+            ASSERT_EQ(mesh.aVertices.size(), mesh.aAmbientOcclusion.size());
+            ASSERT_EQ(mesh.aIndices.size() * 4u, mesh.aVertices.size() * 6u);
+
+            for (size_t i = 0u; i < mesh.aVertices.size(); i += 4u)
+            {
+                const XMVECTOR corner = XMLoadFloat3(&mesh.aVertices[i].Position);
+                const XMVECTOR area = XMVector3Length(XMVector3Cross(XMLoadFloat3(&mesh.aVertices[i + 1u].Position) - corner, XMLoadFloat3(&mesh.aVertices[i + 3u].Position) - corner));
+                meshedArea += XMVectorGetX(area) / (VoxelWorld::BLOCK_SIZE * VoxelWorld::BLOCK_SIZE);
+                ++uNumQuads;
+            }
+        }
+    }
+
+    EXPECT_NEAR(meshedArea, static_cast<double>(uNumExposedFaces), 1.0e-3 * uNumExposedFaces);
+
+    // Greedy merging must join faces, not just copy them
+    EXPECT_LT(uNumQuads, uNumExposedFaces / 2u);
+}
+
+TEST(VoxelWorldTests, AmbientOcclusionFollowsTheCornerRule)
+{
+    VoxelWorld world;
+    MakeTestTerrain(world, WIDTH, HEIGHT, DEPTH, 7u);
+
+    uint32_t aNumVerticesAtLevel[4] = { 0u, 0u, 0u, 0u };
+    uint32_t uNumFlippedQuads = 0u;
+    std::vector<VoxelMesh> aMeshes;
+    for (uint32_t uChunk = 0u; uChunk < world.GetNumChunks(); ++uChunk)
+    {
+        world.MeshChunk(uChunk, aMeshes);
+        for (const VoxelMesh& mesh : aMeshes)
+        {
+            for (size_t uQuad = 0u; uQuad < mesh.aVertices.size() / 4u; ++uQuad)
+            {
+                const SimpleVertex* aVertices = &mesh.aVertices[uQuad * 4u];
+                const int32_t d = aVertices[0].Normal.x != 0.0f ? 0 : (aVertices[0].Normal.y != 0.0f ? 1 : 2);
+                const float normal[3] = { aVertices[0].Normal.x, aVertices[0].Normal.y, aVertices[0].Normal.z };
+                const int32_t u = (d + 1) % 3;
+                const int32_t v = (d + 2) % 3;
+
+                int32_t aaiCorners[4][3];
+                for (uint32_t i = 0u; i < 4u; ++i)
+                {
+                    getBlockCorner(world, aVertices[i].Position, aaiCorners[i]);
+                }
+
+                int32_t aiLevels[4];
+                for (uint32_t i = 0u; i < 4u; ++i)
+                {
+                    // The empty block in front of the face at this corner, and the way out of the quad along u and v
+                    const int32_t iOutU = 2 * aaiCorners[i][u] > aaiCorners[0][u] + aaiCorners[2][u] ? 1 : -1;
+                    const int32_t iOutV = 2 * aaiCorners[i][v] > aaiCorners[0][v] + aaiCorners[2][v] ? 1 : -1;
+                    int32_t aiFront[3];
+                    aiFront[d] = aaiCorners[i][d] - (normal[d] > 0.0f ? 0 : 1);
+                    aiFront[u] = aaiCorners[i][u] - (iOutU > 0 ? 1 : 0);
+                    aiFront[v] = aaiCorners[i][v] - (iOutV > 0 ? 1 : 0);
+
+                    int32_t aiSideU[3] = { aiFront[0], aiFront[1], aiFront[2] };
+                    aiSideU[u] += iOutU;
+                    int32_t aiSideV[3] = { aiFront[0], aiFront[1], aiFront[2] };
+                    aiSideV[v] += iOutV;
+                    int32_t aiDiagonal[3] = { aiSideU[0], aiSideU[1], aiSideU[2] };
+                    aiDiagonal[v] += iOutV;
+
+                    const bool bIsSideUSolid = world.GetBlock(aiSideU[0], aiSideU[1], aiSideU[2]) != VoxelWorld::EMPTY_BLOCK;
+                    const bool bIsSideVSolid = world.GetBlock(aiSideV[0], aiSideV[1], aiSideV[2]) != VoxelWorld::EMPTY_BLOCK;
+                    const bool bIsDiagonalSolid = world.GetBlock(aiDiagonal[0], aiDiagonal[1], aiDiagonal[2]) != VoxelWorld::EMPTY_BLOCK;
+                    const int32_t iExpectedLevel = bIsSideUSolid && bIsSideVSolid ? 0 : 3 - bIsSideUSolid - bIsSideVSolid - bIsDiagonalSolid;
+
+                    ASSERT_EQ(world.GetBlock(aiFront[0], aiFront[1], aiFront[2]), VoxelWorld::EMPTY_BLOCK);
+                    aiLevels[i] = getLevel(mesh.aAmbientOcclusion[uQuad * 4u + i]);
+                    ASSERT_EQ(aiLevels[i], iExpectedLevel) << "chunk " << uChunk << " quad " << uQuad << " corner " << i;
+                    ++aNumVerticesAtLevel[aiLevels[i]];
+                }
+
+                // The two triangles share the diagonal joining the darker pair of opposite corners
+                const uint16_t* aIndices = &mesh.aIndices[uQuad * 6u];
+                uint32_t uNumShared = 0u;
+                int32_t iSharedLevels = 0;
+                for (uint32_t i = 0u; i < 3u; ++i)
+                {
+                    if (std::find(aIndices + 3, aIndices + 6, aIndices[i]) != aIndices + 6)
+                    {
+                        ++uNumShared;
+                        iSharedLevels += aiLevels[aIndices[i] % 4u];
+                    }
+                }
+                ASSERT_EQ(uNumShared, 2u);
+                EXPECT_LE(iSharedLevels, aiLevels[0] + aiLevels[1] + aiLevels[2] + aiLevels[3] - iSharedLevels);
+                uNumFlippedQuads += aIndices[0] % 4u == 1u ? 1u : 0u;
+            }
+        }
+    }
+
+    // The terrain must exercise every level and both diagonals
+    for (uint32_t uNumVertices : aNumVerticesAtLevel)
+    {
+        EXPECT_GT(uNumVertices, 0u);
+    }
+    EXPECT_GT(uNumFlippedQuads, 0u);
+}
+
+TEST(VoxelWorldTests, FacesMergeWhereTheirOcclusionMatches)
+{
+    VoxelWorld world;
+    world.Resize(2u * VoxelWorld::CHUNK_SIZE, VoxelWorld::CHUNK_SIZE, 2u * VoxelWorld::CHUNK_SIZE);
+    for (int32_t z = 0; z < static_cast<int32_t>(world.GetDepth()); ++z)
+    {
+        for (int32_t x = 0; x < static_cast<int32_t>(world.GetWidth()); ++x)
+        {
+            world.SetBlock(x, 0, z, eBlockType::GRASSLAND);
+        }
+    }
+
+    const auto countUpQuads = [&world]()
+    {
+        uint32_t uNumQuads = 0u;
+        std::vector<VoxelMesh> aMeshes;
+        for (uint32_t uChunk = 0u; uChunk < world.GetNumChunks(); ++uChunk)
+        {
+            world.MeshChunk(uChunk, aMeshes);
+            for (const VoxelMesh& mesh : aMeshes)
+            {
+                for (size_t i = 0u; i < mesh.aVertices.size(); i += 4u)
+                {
+                    uNumQuads += mesh.aVertices[i].Normal.y > 0.0f ? 1u : 0u;
+                }
+            }
+        }
+        return uNumQuads;
+    };
+
+    // An unoccluded floor is one quad per chunk
+    EXPECT_EQ(countUpQuads(), 4u);
+
+    // A wall along z darkens the floor on both sides of it. The floor faces touching it have the same
+    // occlusion along it, even across chunks, so they merge into a strip. Only the face at the end of the
+    // wall, which has no block on its diagonal, is lighter and splits off. The chunks the wall crosses hold
+    // the floor before it, two pieces of strip on each side, the floor after it and the top of the wall
+    for (int32_t z = 0; z < static_cast<int32_t>(world.GetDepth()); ++z)
+    {
+        world.SetBlock(8, 1, z, eBlockType::SNOW);
+    }
+    EXPECT_EQ(countUpQuads(), 2u * 7u + 2u);
+}
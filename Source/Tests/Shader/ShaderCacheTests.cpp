@@ -0,0 +1,176 @@
+/*+===================================================================
+  File:      SHADERCACHETESTS.CPP
+
+  Summary:   Checks that shader cache keys change with every input of
+             the compiler, that entries survive a save and a load, and
+             that damaged cache files are ignored
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "Shader/ShaderCache.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr const char* SOURCE = "float4 PSMain(float4 pos : SV_POSITION) : SV_TARGET { return pos; }";
+
+    uint64_t computeDefaultKey()
+    {
+        return ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "NUM_LIGHTS", "2" } }, 0x800u, 47u);
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShaderCacheTest
+      Summary:  Gives every test its own cache file in the temporary
+                directory
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShaderCacheTest : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            m_directory = std::filesystem::temp_directory_path() / "ShaderCacheTests" / testing::UnitTest::GetInstance()->current_test_info()->name();
+            std::filesystem::remove_all(m_directory);
+            m_filePath = m_directory / "Shaders.cache";
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        std::filesystem::path m_directory;
+        std::filesystem::path m_filePath;
+    };
+
+    TEST(ShaderCacheKey, ChangesWithEveryInput)
+    {
+        const uint64_t uKey = computeDefaultKey();
+        EXPECT_EQ(uKey, computeDefaultKey());
+
+        EXPECT_NE(uKey, ShaderCache::ComputeKey("float4 PSMain() : SV_TARGET { return 0; }", "PSMain", "ps_5_0", { { "NUM_LIGHTS", "2" } }, 0x800u, 47u));
+        EXPECT_NE(uKey, ShaderCache::ComputeKey(SOURCE, "PSMain2", "ps_5_0", { { "NUM_LIGHTS", "2" } }, 0x800u, 47u));
+        EXPECT_NE(uKey, ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_4_0", { { "NUM_LIGHTS", "2" } }, 0x800u, 47u));
+        EXPECT_NE(uKey, ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "NUM_LIGHTS", "3" } }, 0x800u, 47u));
+        EXPECT_NE(uKey, ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", {}, 0x800u, 47u));
+        EXPECT_NE(uKey, ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "NUM_LIGHTS", "2" } }, 0x801u, 47u));
+        EXPECT_NE(uKey, ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "NUM_LIGHTS", "2" } }, 0x800u, 43u));
+    }
+
+    TEST(ShaderCacheKey, DistinguishesStringBoundaries)
+    {
+        EXPECT_NE(
+            ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "AB", "C" } }, 0u, 0u),
+            ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "A", "BC" } }, 0u, 0u)
+        );
+        EXPECT_NE(
+            ShaderCache::ComputeKey(SOURCE, "PSMainp", "s_5_0", {}, 0u, 0u),
+            ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", {}, 0u, 0u)
+        );
+        EXPECT_NE(
+            ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "A", "1" }, { "B", "1" } }, 0u, 0u),
+            ShaderCache::ComputeKey(SOURCE, "PSMain", "ps_5_0", { { "B", "1" }, { "A", "1" } }, 0u, 0u)
+        );
+    }
+
+    TEST_F(ShaderCacheTest, WarmStartHitsEveryEntry)
+    {
+        const std::vector<uint8_t> aBytecode = { 'D', 'X', 'B', 'C', 1u, 2u, 3u, 4u };
+        const uint64_t uKey = computeDefaultKey();
+        {
+            ShaderCache cache(m_filePath);
+            EXPECT_FALSE(cache.Load());
+
+            std::vector<uint8_t> aFound;
+            EXPECT_FALSE(cache.Find(uKey, aFound));
+            cache.Store(uKey, aBytecode.data(), aBytecode.size(), 0.25);
+            cache.Store(uKey + 1u, aBytecode.data(), 4u, 0.25);
+            ASSERT_TRUE(cache.Save());
+
+            const ShaderCacheStats stats = cache.GetStats();
+            EXPECT_EQ(stats.uNumMisses, 1u);
+            EXPECT_EQ(stats.uNumEntries, 2u);
+            EXPECT_DOUBLE_EQ(stats.compileSeconds, 0.5);
+        }
+
+        ShaderCache cache(m_filePath);
+        ASSERT_TRUE(cache.Load());
+
+        std::vector<uint8_t> aFound;
+        ASSERT_TRUE(cache.Find(uKey, aFound));
+        EXPECT_EQ(aFound, aBytecode);
+        ASSERT_TRUE(cache.Find(uKey + 1u, aFound));
+        EXPECT_EQ(aFound.size(), 4u);
+
+        const ShaderCacheStats stats = cache.GetStats();
+        EXPECT_EQ(stats.uNumHits, 2u);
+        EXPECT_EQ(stats.uNumMisses, 0u);
+        EXPECT_EQ(stats.uNumEntries, 2u);
+        EXPECT_DOUBLE_EQ(stats.compileSeconds, 0.0);
+    }
+
+    TEST_F(ShaderCacheTest, SaveOnlyWritesChanges)
+    {
+        ShaderCache cache(m_filePath);
+        ASSERT_TRUE(cache.Save());
+        EXPECT_FALSE(std::filesystem::exists(m_filePath));
+
+        const uint8_t aBytecode[] = { 1u, 2u, 3u };
+        cache.Store(1u, aBytecode, sizeof(aBytecode), 0.0);
+        ASSERT_TRUE(cache.Save());
+        EXPECT_TRUE(std::filesystem::exists(m_filePath));
+        EXPECT_FALSE(std::filesystem::exists(m_filePath.string() + ".tmp"));
+
+        cache.Clear();
+        ASSERT_TRUE(cache.Save());
+
+        ShaderCache reloaded(m_filePath);
+        ASSERT_TRUE(reloaded.Load());
+        EXPECT_EQ(reloaded.GetStats().uNumEntries, 0u);
+    }
+
+    TEST_F(ShaderCacheTest, IgnoresDamagedFiles)
+    {
+        const std::vector<uint8_t> aBytecode(256u, 0xABu);
+        {
+            ShaderCache cache(m_filePath);
+            cache.Store(computeDefaultKey(), aBytecode.data(), aBytecode.size(), 0.0);
+            ASSERT_TRUE(cache.Save());
+        }
+        const uintmax_t uFileSize = std::filesystem::file_size(m_filePath);
+
+        // Flip one bytecode byte, which the checksum has to catch
+        {
+            std::fstream file(m_filePath, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(uFileSize - 10u));
+            file.put(0x12);
+        }
+        {
+            ShaderCache cache(m_filePath);
+            EXPECT_FALSE(cache.Load());
+            std::vector<uint8_t> aFound;
+            EXPECT_FALSE(cache.Find(computeDefaultKey(), aFound));
+        }
+
+        std::filesystem::resize_file(m_filePath, uFileSize / 2u);
+        {
+            ShaderCache cache(m_filePath);
+            EXPECT_FALSE(cache.Load());
+            EXPECT_EQ(cache.GetStats().uNumEntries, 0u);
+        }
+
+        {
+            std::ofstream file(m_filePath, std::ios::binary | std::ios::trunc);
+            file << "not a shader cache";
+        }
+        ShaderCache cache(m_filePath);
+        EXPECT_FALSE(cache.Load());
+    }
+}
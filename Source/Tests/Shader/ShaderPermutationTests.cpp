@@ -0,0 +1,121 @@
+/*+===================================================================
+  File:      SHADERPERMUTATIONTESTS.CPP
+
+  Summary:   Checks that every shader permutation has its own key, that
+             keys round-trip, and that different permutations never
+             share a compiled shader in the shader cache
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+
+#include "Shader/ShaderPermutation.h"
+
+namespace
+{
+    using namespace library;
+
+    std::vector<ShaderPermutation> makeAllPermutations()
+    {
+        std::vector<ShaderPermutation> aPermutations;
+        for (uint32_t uFeatures = 0u; uFeatures <= ShaderPermutation::FEATURE_MASK; ++uFeatures)
+        {
+            for (uint32_t uNumLights = 1u; uNumLights <= NUM_LIGHTS; uNumLights <<= 1u)
+            {
+                aPermutations.emplace_back(uFeatures, uNumLights);
+            }
+        }
+        return aPermutations;
+    }
+
+    TEST(ShaderPermutation, KeysAreUniqueAndRoundTrip)
+    {
+        std::set<uint32_t> keys;
+        for (const ShaderPermutation& permutation : makeAllPermutations())
+        {
+            const uint32_t uKey = permutation.GetKey();
+            EXPECT_TRUE(keys.insert(uKey).second) << "key " << uKey;
+
+            const ShaderPermutation unpacked = ShaderPermutation::FromKey(uKey);
+            EXPECT_EQ(unpacked.GetKey(), uKey);
+            EXPECT_EQ(unpacked.GetNumLights(), permutation.GetNumLights());
+            for (eShaderFeature feature : { eShaderFeature::NORMAL_MAP, eShaderFeature::SKINNING, eShaderFeature::SHADOWS, eShaderFeature::PACKED_VERTICES })
+            {
+                EXPECT_EQ(unpacked.HasFeature(feature), permutation.HasFeature(feature));
+            }
+        }
+    }
+
+    TEST(ShaderPermutation, FeaturesDecideTheKey)
+    {
+        ShaderPermutation permutation;
+        const uint32_t uDefaultKey = permutation.GetKey();
+
+        permutation.Enable(eShaderFeature::SKINNING);
+        permutation.Enable(eShaderFeature::NORMAL_MAP);
+        EXPECT_TRUE(permutation.HasFeature(eShaderFeature::SKINNING));
+        EXPECT_NE(permutation.GetKey(), uDefaultKey);
+        EXPECT_EQ(permutation.GetKey(), ShaderPermutation(static_cast<uint32_t>(eShaderFeature::SKINNING) | static_cast<uint32_t>(eShaderFeature::NORMAL_MAP), NUM_LIGHTS).GetKey());
+
+        permutation.Disable(eShaderFeature::SKINNING);
+        permutation.Disable(eShaderFeature::NORMAL_MAP);
+        EXPECT_EQ(permutation.GetKey(), uDefaultKey);
+
+        // Bits outside the known features are dropped
+        EXPECT_EQ(ShaderPermutation(0xF0u, NUM_LIGHTS).GetKey(), uDefaultKey);
+    }
+
+    TEST(ShaderPermutation, LightCountsShareBuckets)
+    {
+        ShaderPermutation permutation;
+        EXPECT_EQ(permutation.GetNumLights(), static_cast<uint32_t>(NUM_LIGHTS));
+
+        permutation.SetNumLights(0u);
+        EXPECT_EQ(permutation.GetNumLights(), 1u);
+
+        for (uint32_t uNumLights = 1u; uNumLights <= NUM_LIGHTS + 2u; ++uNumLights)
+        {
+            permutation.SetNumLights(uNumLights);
+            const uint32_t uBucket = permutation.GetNumLights();
+            EXPECT_GE(uBucket, (std::min)(uNumLights, static_cast<uint32_t>(NUM_LIGHTS)));
+            EXPECT_LE(uBucket, static_cast<uint32_t>(NUM_LIGHTS));
+            EXPECT_TRUE(uBucket == NUM_LIGHTS || (uBucket & (uBucket - 1u)) == 0u);
+        }
+    }
+
+    TEST(ShaderPermutation, DefinesHaveAFixedLayout)
+    {
+        std::vector<ShaderDefine> aDefaultDefines;
+        ShaderPermutation().GetDefines(aDefaultDefines);
+
+        std::vector<ShaderDefine> aDefines;
+        ShaderPermutation(ShaderPermutation::FEATURE_MASK, 1u).GetDefines(aDefines);
+
+        ASSERT_EQ(aDefines.size(), aDefaultDefines.size());
+        for (size_t i = 0u; i < aDefines.size(); ++i)
+        {
+            EXPECT_EQ(aDefines[i].szName, aDefaultDefines[i].szName);
+        }
+        EXPECT_EQ(aDefines.front().szName, "NORMAL_MAP");
+        EXPECT_EQ(aDefines.front().szValue, "1");
+        EXPECT_EQ(aDefaultDefines.front().szValue, "0");
+        EXPECT_EQ(aDefines.back().szName, "NUM_ACTIVE_LIGHTS");
+        EXPECT_EQ(aDefines.back().szValue, "1");
+    }
+
+    TEST(ShaderPermutation, PermutationsNeverShareCacheEntries)
+    {
+        std::set<uint64_t> cacheKeys;
+        std::vector<ShaderDefine> aDefines;
+        for (const ShaderPermutation& permutation : makeAllPermutations())
+        {
+            permutation.GetDefines(aDefines);
+            const uint64_t uCacheKey = ShaderCache::ComputeKey("#include \"Shaders.fxh\"", "PSPhong", "ps_5_0", aDefines, 0u, 47u);
+            EXPECT_TRUE(cacheKeys.insert(uCacheKey).second) << "permutation " << permutation.GetKey();
+        }
+    }
+}
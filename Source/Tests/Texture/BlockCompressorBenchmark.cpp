@@ -0,0 +1,69 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSORBENCHMARK.CPP
+
+  Summary:   Encodes the 4096x4096 image of TextureTool -benchmark to
+             every block format on one thread and on every hardware
+             thread, printing the throughput and the PSNR of each
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/MipBenchmark.h"
+#include "Utility/Parallel.h"
+
+namespace
+{
+    using namespace library;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: run
+      Summary:  Encodes the image NUM_REPETITIONS times and prints the
+                best time with the PSNR of the decoded result over the
+                channels the format stores
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void run(const char* pszFormat, eBlockFormat format, uint32_t uChannelMask, uint32_t uNumThreads, const Image& image)
+    {
+        BlockCompressor compressor(format);
+        compressor.SetNumThreads(uNumThreads);
+
+        std::vector<uint8_t> aBlocks;
+        double bestSeconds = 1.0e9;
+        for (uint32_t i = 0u; i < MipBenchmark::NUM_REPETITIONS; ++i)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            compressor.Compress(image, aBlocks);
+            bestSeconds = (std::min)(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        Image decoded;
+        compressor.Decompress(image.uWidth, image.uHeight, aBlocks.data(), decoded);
+
+        std::printf("  %-3s %2u threads %8.1f ms %8.1f MPix/s %6.2f dB %5.1fx smaller\n",
+            pszFormat, uNumThreads == 0u ? Parallel::GetNumWorkers() : uNumThreads, bestSeconds * 1000.0,
+            static_cast<double>(image.uWidth) * image.uHeight / (bestSeconds * 1.0e6), BlockCompressor::ComputePsnr(image, decoded, uChannelMask),
+            static_cast<double>(image.aPixels.size()) / static_cast<double>(aBlocks.size()));
+    }
+}
+
+int main()
+{
+    Image image;
+    MipBenchmark::MakeImage(image);
+
+    std::printf("Block compression of %ux%u, best of %u runs, %u threads\n", image.uWidth, image.uHeight, MipBenchmark::NUM_REPETITIONS, Parallel::GetNumWorkers());
+
+    const uint32_t uRgb = BlockCompressor::CHANNEL_R | BlockCompressor::CHANNEL_G | BlockCompressor::CHANNEL_B;
+    for (uint32_t uNumThreads : { 1u, 0u })
+    {
+        run("bc1", eBlockFormat::BC1, uRgb, uNumThreads, image);
+        run("bc3", eBlockFormat::BC3, uRgb | BlockCompressor::CHANNEL_A, uNumThreads, image);
+        run("bc5", eBlockFormat::BC5, BlockCompressor::CHANNEL_R | BlockCompressor::CHANNEL_G, uNumThreads, image);
+    }
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSORTESTS.CPP
+
+  Summary:   Decodes hand written BC1, BC3 and BC5 blocks, checks
+             that the encoder reproduces blocks it can represent
+             exactly, and holds every format to a PSNR floor on a
+             synthetic image, with BC5 keeping its two channels
+             apart
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "Texture/BlockCompressor.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr uint32_t IMAGE_SIZE = 256u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeImage
+      Summary:  Fills an image with smooth colour gradients, a soft
+                alpha ramp, hard edged squares and a little noise, the
+                mix of content a block encoder meets in practice
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    Image makeImage(uint32_t uWidth, uint32_t uHeight)
+    {
+        Image image = { uWidth, uHeight, std::vector<uint8_t>(static_cast<size_t>(uWidth) * uHeight * 4u) };
+
+        std::mt19937 random(7u);
+        std::uniform_int_distribution<int32_t> noise(-6, 6);
+        for (uint32_t y = 0u; y < uHeight; ++y)
+        {
+            for (uint32_t x = 0u; x < uWidth; ++x)
+            {
+                uint8_t* pPixel = &image.aPixels[(static_cast<size_t>(y) * uWidth + x) * 4u];
+                bool bIsInSquare = ((x / 32u) + (y / 32u)) % 3u == 0u;
+                int32_t iRed = static_cast<int32_t>(x * 255u / (uWidth - 1u));
+                int32_t iGreen = static_cast<int32_t>(y * 255u / (uHeight - 1u));
+                int32_t iBlue = bIsInSquare ? 200 : 40;
+                int32_t iAlpha = static_cast<int32_t>(127.5f + 127.5f * std::sin(static_cast<float>(x + y) * 0.05f));
+
+                pPixel[0] = static_cast<uint8_t>(std::clamp(iRed + noise(random), 0, 255));
+                pPixel[1] = static_cast<uint8_t>(std::clamp(iGreen + noise(random), 0, 255));
+                pPixel[2] = static_cast<uint8_t>(std::clamp(iBlue + noise(random), 0, 255));
+                pPixel[3] = static_cast<uint8_t>(iAlpha);
+            }
+        }
+
+        return image;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeNormalMap
+      Summary:  Fills an image with the tangent space normals of a
+                rippled height field, x in red and y in green, with
+                blue and alpha left at 0 as BC5 does not store them
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    Image makeNormalMap(uint32_t uWidth, uint32_t uHeight)
+    {
+        Image image = { uWidth, uHeight, std::vector<uint8_t>(static_cast<size_t>(uWidth) * uHeight * 4u) };
+        for (uint32_t y = 0u; y < uHeight; ++y)
+        {
+            for (uint32_t x = 0u; x < uWidth; ++x)
+            {
+                float slopeX = 0.6f * std::cos(static_cast<float>(x) * 0.11f) * std::sin(static_cast<float>(y) * 0.03f);
+                float slopeY = 0.6f * std::sin(static_cast<float>(x) * 0.02f) * std::cos(static_cast<float>(y) * 0.13f);
+                float length = std::sqrt(slopeX * slopeX + slopeY * slopeY + 1.0f);
+
+                uint8_t* pPixel = &image.aPixels[(static_cast<size_t>(y) * uWidth + x) * 4u];
+                pPixel[0] = static_cast<uint8_t>(std::lround(127.5f - 127.5f * slopeX / length));
+                pPixel[1] = static_cast<uint8_t>(std::lround(127.5f - 127.5f * slopeY / length));
+                pPixel[2] = 0u;
+                pPixel[3] = 0u;
+            }
+        }
+
+        return image;
+    }
+
+    Image roundTrip(eBlockFormat format, const Image& image)
+    {
+        BlockCompressor compressor(format);
+
+        std::vector<uint8_t> aBlocks;
+        compressor.Compress(image, aBlocks);
+        EXPECT_EQ(aBlocks.size(), BlockCompressor::ComputeCompressedByteSize(format, image.uWidth, image.uHeight));
+
+        Image decoded;
+        compressor.Decompress(image.uWidth, image.uHeight, aBlocks.data(), decoded);
+        return decoded;
+    }
+
+    TEST(BlockCompressor, DecodesHandWrittenBlocks)
+    {
+        // White and black endpoints, pixel i picks palette entry i % 4
+        const uint8_t aBC1Block[8] = { 0xFFu, 0xFFu, 0x00u, 0x00u, 0xE4u, 0xE4u, 0xE4u, 0xE4u };
+        uint8_t aRgba[BlockCompressor::NUM_BLOCK_PIXELS * 4u];
+        BlockCompressor::DecodeBlock(eBlockFormat::BC1, aBC1Block, aRgba);
+
+        const uint8_t aExpectedLevels[4] = { 255u, 0u, 170u, 85u };
+        for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+        {
+            EXPECT_EQ(aRgba[i * 4u + 0u], aExpectedLevels[i % 4u]) << "pixel " << i;
+            EXPECT_EQ(aRgba[i * 4u + 1u], aExpectedLevels[i % 4u]) << "pixel " << i;
+            EXPECT_EQ(aRgba[i * 4u + 2u], aExpectedLevels[i % 4u]) << "pixel " << i;
+            EXPECT_EQ(aRgba[i * 4u + 3u], 255u) << "pixel " << i;
+        }
+
+        // Swapped endpoints select three colours and transparent black
+        const uint8_t aBC1PunchThroughBlock[8] = { 0x00u, 0x00u, 0xFFu, 0xFFu, 0xE4u, 0xE4u, 0xE4u, 0xE4u };
+        BlockCompressor::DecodeBlock(eBlockFormat::BC1, aBC1PunchThroughBlock, aRgba);
+        EXPECT_EQ(aRgba[2u * 4u + 0u], 127u);
+        EXPECT_EQ(aRgba[2u * 4u + 3u], 255u);
+        EXPECT_EQ(aRgba[3u * 4u + 0u], 0u);
+        EXPECT_EQ(aRgba[3u * 4u + 3u], 0u);
+
+        // The colour part of BC3 always has four colours, the alpha
+        // block interpolates six values between 255 and 0
+        uint8_t aBC3Block[16] = { 0xFFu, 0x00u, 0x88u, 0xC6u, 0xFAu, 0x88u, 0xC6u, 0xFAu };
+        std::memcpy(&aBC3Block[8], aBC1PunchThroughBlock, sizeof(aBC1PunchThroughBlock));
+        BlockCompressor::DecodeBlock(eBlockFormat::BC3, aBC3Block, aRgba);
+
+        const uint8_t aExpectedAlphas[8] = { 255u, 0u, 219u, 182u, 146u, 109u, 73u, 36u };
+        for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+        {
+            EXPECT_EQ(aRgba[i * 4u + 3u], aExpectedAlphas[i % 8u]) << "pixel " << i;
+        }
+        EXPECT_EQ(aRgba[2u * 4u + 0u], 85u);
+        EXPECT_EQ(aRgba[3u * 4u + 0u], 170u);
+
+        // BC5 holds red and green as two BC4 blocks, with blue at 0
+        uint8_t aBC5Block[16] = {};
+        aBC5Block[0] = 200u;
+        aBC5Block[1] = 200u;
+        aBC5Block[8] = 10u;
+        aBC5Block[9] = 10u;
+        BlockCompressor::DecodeBlock(eBlockFormat::BC5, aBC5Block, aRgba);
+        for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+        {
+            EXPECT_EQ(aRgba[i * 4u + 0u], 200u);
+            EXPECT_EQ(aRgba[i * 4u + 1u], 10u);
+            EXPECT_EQ(aRgba[i * 4u + 2u], 0u);
+            EXPECT_EQ(aRgba[i * 4u + 3u], 255u);
+        }
+    }
+
+    TEST(BlockCompressor, ReproducesBlocksItCanRepresent)
+    {
+        // Two RGB565 colours and alpha 0 and 255 survive every format unchanged
+        uint8_t aRgba[BlockCompressor::NUM_BLOCK_PIXELS * 4u];
+        for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS; ++i)
+        {
+            bool bIsFirst = (i * 7u) % 3u == 0u;
+            aRgba[i * 4u + 0u] = bIsFirst ? 255u : 0u;
+            aRgba[i * 4u + 1u] = bIsFirst ? 0u : 255u;
+            aRgba[i * 4u + 2u] = bIsFirst ? 0u : 255u;
+            aRgba[i * 4u + 3u] = bIsFirst ? 0u : 255u;
+        }
+
+        uint8_t aBlock[16];
+        uint8_t aDecoded[BlockCompressor::NUM_BLOCK_PIXELS * 4u];
+        BlockCompressor::EncodeBC1Block(aRgba, aBlock);
+        BlockCompressor::DecodeBlock(eBlockFormat::BC1, aBlock, aDecoded);
+        for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS * 4u; i += 4u)
+        {
+            EXPECT_EQ(aDecoded[i + 0u], aRgba[i + 0u]);
+            EXPECT_EQ(aDecoded[i + 1u], aRgba[i + 1u]);
+            EXPECT_EQ(aDecoded[i + 2u], aRgba[i + 2u]);
+        }
+
+        BlockCompressor::EncodeBC3Block(aRgba, aBlock);
+        BlockCompressor::DecodeBlock(eBlockFormat::BC3, aBlock, aDecoded);
+        EXPECT_EQ(0, std::memcmp(aDecoded, aRgba, sizeof(aRgba)));
+
+        BlockCompressor::EncodeBC5Block(aRgba, aBlock);
+        BlockCompressor::DecodeBlock(eBlockFormat::BC5, aBlock, aDecoded);
+        for (uint32_t i = 0u; i < BlockCompressor::NUM_BLOCK_PIXELS * 4u; i += 4u)
+        {
+            EXPECT_EQ(aDecoded[i + 0u], aRgba[i + 0u]);
+            EXPECT_EQ(aDecoded[i + 1u], aRgba[i + 1u]);
+        }
+    }
+
+    TEST(BlockCompressor, MeetsThePsnrFloorOfEachFormat)
+    {
+        const Image image = makeImage(IMAGE_SIZE, IMAGE_SIZE);
+        const uint32_t uRgb = BlockCompressor::CHANNEL_R | BlockCompressor::CHANNEL_G | BlockCompressor::CHANNEL_B;
+
+        const Image bc1 = roundTrip(eBlockFormat::BC1, image);
+        EXPECT_GT(BlockCompressor::ComputePsnr(image, bc1, uRgb), 36.0);
+
+        const Image bc3 = roundTrip(eBlockFormat::BC3, image);
+        EXPECT_GT(BlockCompressor::ComputePsnr(image, bc3, uRgb), 36.0);
+        EXPECT_GT(BlockCompressor::ComputePsnr(image, bc3, BlockCompressor::CHANNEL_A), 45.0);
+
+        const Image bc5 = roundTrip(eBlockFormat::BC5, image);
+        EXPECT_GT(BlockCompressor::ComputePsnr(image, bc5, BlockCompressor::CHANNEL_R | BlockCompressor::CHANNEL_G), 48.0);
+    }
+
+    TEST(BlockCompressor, KeepsTheTwoChannelsOfBC5Apart)
+    {
+        const Image normalMap = makeNormalMap(IMAGE_SIZE, IMAGE_SIZE);
+        const Image bc5 = roundTrip(eBlockFormat::BC5, normalMap);
+        const Image bc1 = roundTrip(eBlockFormat::BC1, normalMap);
+
+        // Each channel gets its own eight level palette per block
+        const double redPsnr = BlockCompressor::ComputePsnr(normalMap, bc5, BlockCompressor::CHANNEL_R);
+        const double greenPsnr = BlockCompressor::ComputePsnr(normalMap, bc5, BlockCompressor::CHANNEL_G);
+        EXPECT_GT(redPsnr, 50.0);
+        EXPECT_GT(greenPsnr, 50.0);
+        EXPECT_GT(BlockCompressor::ComputePsnr(normalMap, bc5, BlockCompressor::CHANNEL_R | BlockCompressor::CHANNEL_G),
+            BlockCompressor::ComputePsnr(normalMap, bc1, BlockCompressor::CHANNEL_R | BlockCompressor::CHANNEL_G) + 6.0);
+
+        int32_t iMaxError = 0;
+        for (size_t i = 0u; i < normalMap.aPixels.size(); i += 4u)
+        {
+            iMaxError = (std::max)(iMaxError, std::abs(static_cast<int32_t>(normalMap.aPixels[i + 0u]) - static_cast<int32_t>(bc5.aPixels[i + 0u])));
+            iMaxError = (std::max)(iMaxError, std::abs(static_cast<int32_t>(normalMap.aPixels[i + 1u]) - static_cast<int32_t>(bc5.aPixels[i + 1u])));
+        }
+        EXPECT_LE(iMaxError, 4);
+
+        // A constant green channel stays exact however much red varies
+        Image stripes = normalMap;
+        for (size_t i = 0u; i < stripes.aPixels.size(); i += 4u)
+        {
+            stripes.aPixels[i + 1u] = 77u;
+        }
+        const Image decodedStripes = roundTrip(eBlockFormat::BC5, stripes);
+        EXPECT_TRUE(std::isinf(BlockCompressor::ComputePsnr(stripes, decodedStripes, BlockCompressor::CHANNEL_G)));
+        EXPECT_NEAR(BlockCompressor::ComputePsnr(stripes, decodedStripes, BlockCompressor::CHANNEL_R), redPsnr, 1.0e-9);
+    }
+
+    TEST(BlockCompressor, EncodesPartialBlocksAndMatchesOneThread)
+    {
+        const Image image = makeImage(IMAGE_SIZE - 3u, 37u);
+        for (eBlockFormat format : { eBlockFormat::BC1, eBlockFormat::BC3, eBlockFormat::BC5 })
+        {
+            BlockCompressor serialCompressor(format);
+            serialCompressor.SetNumThreads(1u);
+            std::vector<uint8_t> aSerialBlocks;
+            serialCompressor.Compress(image, aSerialBlocks);
+
+            BlockCompressor parallelCompressor(format);
+            std::vector<uint8_t> aParallelBlocks;
+            parallelCompressor.Compress(image, aParallelBlocks);
+
+            ASSERT_EQ(aSerialBlocks.size(), BlockCompressor::ComputeCompressedByteSize(format, image.uWidth, image.uHeight));
+            EXPECT_EQ(aParallelBlocks, aSerialBlocks);
+
+            Image decoded;
+            parallelCompressor.Decompress(image.uWidth, image.uHeight, aParallelBlocks.data(), decoded);
+            EXPECT_EQ(decoded.uWidth, image.uWidth);
+            EXPECT_EQ(decoded.uHeight, image.uHeight);
+            EXPECT_EQ(decoded.aPixels.size(), image.aPixels.size());
+        }
+    }
+}
@@ -0,0 +1,306 @@
+/*+===================================================================
+  File:      DDSLAYOUTTESTS.CPP
+
+  Summary:   Builds DDS files in memory and checks the descriptions
+             and subresource layouts DDSLayout reads from them, and
+             that it rejects truncated and malformed files
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+
+#include "Texture/DDSLayout.h"
+#include "Texture/DDSWriter.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr uint32_t makeFourCC(char ch0, char ch1, char ch2, char ch3)
+    {
+        return static_cast<uint32_t>(static_cast<uint8_t>(ch0))
+            | (static_cast<uint32_t>(static_cast<uint8_t>(ch1)) << 8u)
+            | (static_cast<uint32_t>(static_cast<uint8_t>(ch2)) << 16u)
+            | (static_cast<uint32_t>(static_cast<uint8_t>(ch3)) << 24u);
+    }
+
+    DDSHeader makeHeader(uint32_t uWidth, uint32_t uHeight, uint32_t uNumMips)
+    {
+        DDSHeader header = {};
+        header.uSize = sizeof(DDSHeader);
+        header.uFlags = DDS_HEADER_FLAGS_TEXTURE | (uNumMips > 1u ? DDS_HEADER_FLAGS_MIPMAP : 0u);
+        header.uWidth = uWidth;
+        header.uHeight = uHeight;
+        header.uMipMapCount = uNumMips;
+        header.PixelFormat.uSize = sizeof(DDSPixelFormat);
+        header.uCaps = DDS_SURFACE_FLAGS_TEXTURE | (uNumMips > 1u ? DDS_SURFACE_FLAGS_MIPMAP : 0u);
+        return header;
+    }
+
+    DDSHeader makeFourCCHeader(uint32_t uWidth, uint32_t uHeight, uint32_t uNumMips, uint32_t uFourCC)
+    {
+        DDSHeader header = makeHeader(uWidth, uHeight, uNumMips);
+        header.PixelFormat.uFlags = DDS_PIXELFORMAT_FOURCC;
+        header.PixelFormat.uFourCC = uFourCC;
+        return header;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: makeFile
+      Summary:  Returns the magic number, the headers and uDataSize
+                bytes counting up from 0, so offsets can be checked
+                against the contents
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<uint8_t> makeFile(const DDSHeader& header, const std::optional<DDSHeaderDXT10>& headerDxt10, size_t uDataSize)
+    {
+        const size_t uDataOffset = sizeof(uint32_t) + sizeof(DDSHeader) + (headerDxt10 ? sizeof(DDSHeaderDXT10) : 0u);
+        std::vector<uint8_t> aBytes(uDataOffset + uDataSize);
+        memcpy(aBytes.data(), &DDS_MAGIC, sizeof(uint32_t));
+        memcpy(aBytes.data() + sizeof(uint32_t), &header, sizeof(DDSHeader));
+        if (headerDxt10)
+        {
+            memcpy(aBytes.data() + sizeof(uint32_t) + sizeof(DDSHeader), &*headerDxt10, sizeof(DDSHeaderDXT10));
+        }
+
+        for (size_t i = 0u; i < uDataSize; ++i)
+        {
+            aBytes[uDataOffset + i] = static_cast<uint8_t>(i);
+        }
+        return aBytes;
+    }
+
+    uint64_t computeChainSize(uint32_t uDxgiFormat, uint32_t uWidth, uint32_t uHeight, uint32_t uNumMips)
+    {
+        uint64_t uSize = 0u;
+        for (uint32_t uMip = 0u; uMip < uNumMips; ++uMip)
+        {
+            uint32_t uRowPitch = 0u;
+            uint32_t uSlicePitch = 0u;
+            EXPECT_TRUE(DDSLayout::ComputePitch(uDxgiFormat, (std::max)(uWidth >> uMip, 1u), (std::max)(uHeight >> uMip, 1u), uRowPitch, uSlicePitch));
+            uSize += uSlicePitch;
+        }
+        return uSize;
+    }
+
+    TEST(DDSLayout, ReadsLegacyBlockCompressedChain)
+    {
+        const std::vector<uint8_t> aFile = makeFile(makeFourCCHeader(256u, 128u, 9u, makeFourCC('D', 'X', 'T', '1')), std::nullopt, 21864u);
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+        EXPECT_EQ(uDataOffset, 128u);
+        EXPECT_EQ(desc.uDimension, DDS_DIMENSION_TEXTURE2D);
+        EXPECT_EQ(desc.uDxgiFormat, static_cast<uint32_t>(eDDSFormat::BC1_UNORM));
+        EXPECT_EQ(desc.uWidth, 256u);
+        EXPECT_EQ(desc.uHeight, 128u);
+        EXPECT_EQ(desc.uNumMips, 9u);
+        EXPECT_FALSE(desc.bIsCubemap);
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        ASSERT_TRUE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{}, rangeDesc, aSubresources));
+        ASSERT_EQ(aSubresources.size(), 9u);
+
+        // 64x32 blocks of 8 bytes, then every level down to a single block
+        EXPECT_EQ(aSubresources[0].uRowPitch, 512u);
+        EXPECT_EQ(aSubresources[0].uByteSize, 16384u);
+        EXPECT_EQ(aSubresources[1].uOffset, 128u + 16384u);
+        EXPECT_EQ(aSubresources[8].uWidth, 1u);
+        EXPECT_EQ(aSubresources[8].uHeight, 1u);
+        EXPECT_EQ(aSubresources[8].uRowPitch, 8u);
+        EXPECT_EQ(aSubresources[8].uByteSize, 8u);
+        EXPECT_EQ(aSubresources[8].uOffset + aSubresources[8].uByteSize, aFile.size());
+        EXPECT_EQ(computeChainSize(desc.uDxgiFormat, 256u, 128u, 9u), 21864u);
+    }
+
+    TEST(DDSLayout, ReadsLegacyUncompressedCubemap)
+    {
+        DDSHeader header = makeHeader(16u, 16u, 5u);
+        header.PixelFormat.uFlags = DDS_PIXELFORMAT_RGB | DDS_PIXELFORMAT_ALPHA;
+        header.PixelFormat.uRGBBitCount = 32u;
+        header.PixelFormat.uRBitMask = 0x00FF0000u;
+        header.PixelFormat.uGBitMask = 0x0000FF00u;
+        header.PixelFormat.uBBitMask = 0x000000FFu;
+        header.PixelFormat.uABitMask = 0xFF000000u;
+        header.uCaps2 = DDS_CUBEMAP | DDS_CUBEMAP_ALLFACES;
+
+        const uint64_t uFaceSize = computeChainSize(87u, 16u, 16u, 5u);
+        const std::vector<uint8_t> aFile = makeFile(header, std::nullopt, uFaceSize * 6u);
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+        EXPECT_EQ(desc.uDxgiFormat, 87u);
+        EXPECT_TRUE(desc.bIsCubemap);
+        EXPECT_EQ(desc.uArraySize, 1u);
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        ASSERT_TRUE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{ 1u, 2u, 0u, 0u }, rangeDesc, aSubresources));
+        ASSERT_EQ(aSubresources.size(), 12u);
+        EXPECT_EQ(rangeDesc.uWidth, 8u);
+        EXPECT_EQ(rangeDesc.uNumMips, 2u);
+
+        // Every face stores its whole chain before the next face
+        for (uint32_t uFace = 0u; uFace < 6u; ++uFace)
+        {
+            EXPECT_EQ(aSubresources[uFace * 2u].uOffset, uDataOffset + uFace * uFaceSize + 16u * 16u * 4u);
+            EXPECT_EQ(aSubresources[uFace * 2u + 1u].uWidth, 4u);
+        }
+
+        header.uCaps2 = DDS_CUBEMAP | 0x00000400u;
+        const std::vector<uint8_t> aPartialFile = makeFile(header, std::nullopt, uFaceSize * 6u);
+        EXPECT_FALSE(DDSLayout::ReadHeader(aPartialFile.data(), aPartialFile.size(), desc, uDataOffset));
+    }
+
+    TEST(DDSLayout, SelectsSlicesOfDX10Array)
+    {
+        constexpr const uint32_t FORMAT = static_cast<uint32_t>(eDDSFormat::BC3_UNORM_SRGB);
+        const DDSHeaderDXT10 headerDxt10 = { FORMAT, DDS_DIMENSION_TEXTURE2D, 0u, 4u, 0u };
+        const uint64_t uSliceSize = computeChainSize(FORMAT, 64u, 64u, 7u);
+
+        // The last slice is missing, which only matters when it is selected
+        const std::vector<uint8_t> aFile = makeFile(makeFourCCHeader(64u, 64u, 7u, DDS_FOURCC_DX10), headerDxt10, uSliceSize * 3u);
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+        EXPECT_EQ(uDataOffset, 148u);
+        EXPECT_EQ(desc.uDxgiFormat, FORMAT);
+        EXPECT_EQ(desc.uArraySize, 4u);
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        ASSERT_TRUE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{ 2u, 0u, 1u, 2u }, rangeDesc, aSubresources));
+        ASSERT_EQ(aSubresources.size(), 10u);
+        EXPECT_EQ(rangeDesc.uArraySize, 2u);
+        EXPECT_EQ(rangeDesc.uNumMips, 5u);
+        EXPECT_EQ(rangeDesc.uWidth, 16u);
+
+        const uint64_t uFirstOffset = uDataOffset + uSliceSize + 64u * 64u + 32u * 32u;
+        EXPECT_EQ(aSubresources[0].uOffset, uFirstOffset);
+        EXPECT_EQ(aFile[aSubresources[0].uOffset], static_cast<uint8_t>(uFirstOffset - uDataOffset));
+        EXPECT_EQ(aSubresources[5].uOffset, uFirstOffset + uSliceSize);
+
+        EXPECT_FALSE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{ 0u, 0u, 3u, 1u }, rangeDesc, aSubresources));
+        EXPECT_TRUE(aSubresources.empty());
+    }
+
+    TEST(DDSLayout, ReadsVolumeTexture)
+    {
+        DDSHeader header = makeFourCCHeader(8u, 8u, 4u, DDS_FOURCC_DX10);
+        header.uFlags |= DDS_HEADER_FLAGS_VOLUME;
+        header.uDepth = 4u;
+        const DDSHeaderDXT10 headerDxt10 = { static_cast<uint32_t>(eDDSFormat::R8G8B8A8_UNORM), DDS_DIMENSION_TEXTURE3D, 0u, 1u, 0u };
+        const std::vector<uint8_t> aFile = makeFile(header, headerDxt10, 8u * 8u * 4u * 4u + 4u * 4u * 4u * 2u + 2u * 2u * 4u + 4u);
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+        EXPECT_EQ(desc.uDepth, 4u);
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        ASSERT_TRUE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{}, rangeDesc, aSubresources));
+        ASSERT_EQ(aSubresources.size(), 4u);
+        EXPECT_EQ(aSubresources[0].uByteSize, 1024u);
+        EXPECT_EQ(aSubresources[1].uDepth, 2u);
+        EXPECT_EQ(aSubresources[3].uByteSize, 4u);
+
+        const DDSHeaderDXT10 arrayHeader = { static_cast<uint32_t>(eDDSFormat::R8G8B8A8_UNORM), DDS_DIMENSION_TEXTURE3D, 0u, 2u, 0u };
+        const std::vector<uint8_t> aArrayFile = makeFile(header, arrayHeader, 2048u);
+        EXPECT_FALSE(DDSLayout::ReadHeader(aArrayFile.data(), aArrayFile.size(), desc, uDataOffset));
+    }
+
+    TEST(DDSLayout, RejectsMalformedFiles)
+    {
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+
+        const DDSHeader header = makeFourCCHeader(64u, 64u, 7u, makeFourCC('D', 'X', 'T', '5'));
+        std::vector<uint8_t> aFile = makeFile(header, std::nullopt, 0u);
+        ASSERT_TRUE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+
+        // The header fits but the levels are missing
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        EXPECT_FALSE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{}, rangeDesc, aSubresources));
+        EXPECT_FALSE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{ 7u, 0u, 0u, 0u }, rangeDesc, aSubresources));
+
+        EXPECT_FALSE(DDSLayout::ReadHeader(aFile.data(), aFile.size() - 1u, desc, uDataOffset));
+        EXPECT_FALSE(DDSLayout::ReadHeader(nullptr, aFile.size(), desc, uDataOffset));
+
+        std::vector<uint8_t> aBadMagic = aFile;
+        aBadMagic[0] = 'X';
+        EXPECT_FALSE(DDSLayout::ReadHeader(aBadMagic.data(), aBadMagic.size(), desc, uDataOffset));
+
+        DDSHeader tooManyMips = header;
+        tooManyMips.uMipMapCount = 8u;
+        aFile = makeFile(tooManyMips, std::nullopt, 8192u);
+        EXPECT_FALSE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+
+        DDSHeader unknownFormat = makeFourCCHeader(64u, 64u, 1u, makeFourCC('A', 'T', 'I', '9'));
+        aFile = makeFile(unknownFormat, std::nullopt, 8192u);
+        EXPECT_FALSE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+
+        // The DX10 header itself is cut off
+        aFile = makeFile(makeFourCCHeader(64u, 64u, 1u, DDS_FOURCC_DX10), std::nullopt, 8u);
+        EXPECT_FALSE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+    }
+
+    TEST(DDSLayout, ReadsUnalignedViews)
+    {
+        const std::vector<uint8_t> aFile = makeFile(makeFourCCHeader(8u, 8u, 4u, makeFourCC('D', 'X', 'T', '1')), std::nullopt, 32u + 8u + 8u + 8u);
+        std::vector<uint8_t> aShifted(aFile.size() + 1u);
+        memcpy(aShifted.data() + 1u, aFile.data(), aFile.size());
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aShifted.data() + 1u, aFile.size(), desc, uDataOffset));
+        EXPECT_EQ(desc.uWidth, 8u);
+        EXPECT_EQ(desc.uNumMips, 4u);
+    }
+
+    TEST(DDSLayout, ReadsFilesOfDDSWriter)
+    {
+        const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "DDSLayoutTests.dds";
+
+        std::vector<std::vector<uint8_t>> aMips;
+        for (uint32_t uSize = 32u; uSize >= 1u; uSize /= 2u)
+        {
+            aMips.emplace_back(DDSWriter::ComputeSurfaceByteSize(eDDSFormat::BC1_UNORM_SRGB, uSize, uSize), static_cast<uint8_t>(uSize));
+        }
+        const DDSImageDesc imageDesc = { 32u, 32u, static_cast<uint32_t>(aMips.size()), eDDSFormat::BC1_UNORM_SRGB };
+        ASSERT_TRUE(DDSWriter::Write(filePath, imageDesc, aMips));
+
+        std::ifstream file(filePath, std::ios::binary);
+        ASSERT_TRUE(file.is_open());
+        const std::vector<uint8_t> aFile((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::filesystem::remove(filePath);
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aFile.data(), aFile.size(), desc, uDataOffset));
+        EXPECT_EQ(desc.uDxgiFormat, static_cast<uint32_t>(eDDSFormat::BC1_UNORM_SRGB));
+        EXPECT_EQ(desc.uNumMips, imageDesc.uNumMips);
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        ASSERT_TRUE(DDSLayout::GetSubresources(desc, uDataOffset, aFile.size(), DDSRange{}, rangeDesc, aSubresources));
+        ASSERT_EQ(aSubresources.size(), aMips.size());
+        for (size_t i = 0u; i < aMips.size(); ++i)
+        {
+            ASSERT_EQ(aSubresources[i].uByteSize, aMips[i].size());
+            EXPECT_TRUE(std::equal(aMips[i].begin(), aMips[i].end(), aFile.begin() + static_cast<ptrdiff_t>(aSubresources[i].uOffset))) << "level " << i;
+        }
+    }
+}
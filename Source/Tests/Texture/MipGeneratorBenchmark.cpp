@@ -0,0 +1,38 @@
+/*+===================================================================
+  File:      MIPGENERATORBENCHMARK.CPP
+
+  Summary:   Times the mip generator on the 4096x4096 image of
+             TextureTool -benchmark with every filter, colour mode and
+             thread count
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <cstdio>
+
+#include "Texture/MipBenchmark.h"
+
+int main()
+{
+    library::Image image;
+    library::MipBenchmark::MakeImage(image);
+
+    std::printf("Mip chain of %ux%u, best of %u runs, %u threads\n", image.uWidth, image.uHeight, library::MipBenchmark::NUM_REPETITIONS, library::MipBenchmark::GetNumThreads());
+
+    std::vector<library::MipBenchmarkResult> aResults;
+    library::MipBenchmark::Run(image, aResults);
+
+    for (const library::MipBenchmarkResult& result : aResults)
+    {
+        std::printf(
+            "  %-6s %-6s %2u threads %8.1f ms %8.1f MPix/s\n",
+            result.pszFilter,
+            result.pszMode,
+            result.uNumThreads,
+            result.milliseconds,
+            result.megapixelsPerSecond
+        );
+    }
+
+    return 0;
+}
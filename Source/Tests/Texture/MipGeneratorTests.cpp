@@ -0,0 +1,60 @@
+/*+===================================================================
+  File:      MIPGENERATORTESTS.CPP
+
+  Summary:   Checks that the mip generator builds the same chain on
+             one thread and on the job system
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include "Texture/MipGenerator.h"
+
+namespace
+{
+    using namespace library;
+
+    Image makeImage(uint32_t uWidth, uint32_t uHeight)
+    {
+        Image image = { uWidth, uHeight, std::vector<uint8_t>(static_cast<size_t>(uWidth) * uHeight * 4u) };
+        for (uint32_t y = 0u; y < uHeight; ++y)
+        {
+            for (uint32_t x = 0u; x < uWidth; ++x)
+            {
+                uint8_t* pPixel = &image.aPixels[(static_cast<size_t>(y) * uWidth + x) * 4u];
+                pPixel[0] = static_cast<uint8_t>(x * 7u);
+                pPixel[1] = static_cast<uint8_t>(y * 5u);
+                pPixel[2] = ((x ^ y) & 1u) ? 224u : 32u;
+                pPixel[3] = static_cast<uint8_t>(x + y);
+            }
+        }
+        return image;
+    }
+
+    TEST(MipGenerator, JobSystemMatchesSingleThread)
+    {
+        const Image image = makeImage(512u, 256u);
+
+        for (eMipFilter filter : { eMipFilter::BOX, eMipFilter::KAISER })
+        {
+            std::vector<Image> aSerialMips;
+            MipGenerator serialGenerator(filter);
+            serialGenerator.SetNumThreads(1u);
+            serialGenerator.Generate(image, aSerialMips);
+
+            std::vector<Image> aParallelMips;
+            MipGenerator parallelGenerator(filter);
+            parallelGenerator.Generate(image, aParallelMips);
+
+            ASSERT_EQ(aSerialMips.size(), MipGenerator::ComputeNumMips(image.uWidth, image.uHeight));
+            ASSERT_EQ(aParallelMips.size(), aSerialMips.size());
+            for (size_t i = 0u; i < aSerialMips.size(); ++i)
+            {
+                EXPECT_EQ(aParallelMips[i].uWidth, aSerialMips[i].uWidth);
+                EXPECT_EQ(aParallelMips[i].uHeight, aSerialMips[i].uHeight);
+                EXPECT_EQ(aParallelMips[i].aPixels, aSerialMips[i].aPixels) << "level " << i;
+            }
+        }
+    }
+}
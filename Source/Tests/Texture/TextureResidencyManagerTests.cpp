@@ -0,0 +1,198 @@
+/*+===================================================================
+  File:      TEXTURERESIDENCYMANAGERTESTS.CPP
+
+  Summary:   Replays request streams through TextureResidencyManager
+             and checks that the committed memory stays within the
+             budget, including the diffuse map of the nanosuit
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "Texture/DDSLayout.h"
+#include "Texture/TextureResidencyManager.h"
+
+namespace
+{
+    using namespace library;
+
+    TextureResidencyDesc makeDesc(uint32_t uDimension)
+    {
+        TextureResidencyDesc desc = { uDimension, uDimension, {} };
+        for (uint32_t uSize = uDimension; ; uSize /= 2u)
+        {
+            desc.aMipByteSizes.push_back(static_cast<uint64_t>(uSize) * uSize * 4u);
+            if (uSize == 1u)
+            {
+                break;
+            }
+        }
+        return desc;
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StreamingSimulation
+      Summary:  Stands in for the renderer: loads issued in one frame
+                complete at the start of the next one
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StreamingSimulation
+    {
+    public:
+        explicit StreamingSimulation(TextureResidencyManager& manager)
+            : m_manager(manager)
+            , m_aLoads()
+            , m_aEvictions()
+            , m_aInFlight()
+        {
+        }
+
+        void Step()
+        {
+            for (const TextureResidencyCommand& load : m_aInFlight)
+            {
+                m_manager.OnLoadCompleted(load.uHandle, load.uMostDetailedMip);
+            }
+            m_aInFlight.clear();
+
+            m_manager.Update(m_aLoads, m_aEvictions);
+            m_aInFlight = m_aLoads;
+        }
+
+    private:
+        TextureResidencyManager& m_manager;
+        std::vector<TextureResidencyCommand> m_aLoads;
+        std::vector<TextureResidencyCommand> m_aEvictions;
+        std::vector<TextureResidencyCommand> m_aInFlight;
+    };
+
+    TEST(TextureResidencyManager, RandomRequestsStayWithinBudget)
+    {
+        constexpr const uint32_t NUM_TEXTURES = 40u;
+        constexpr const uint32_t NUM_FRAMES = 2000u;
+
+        TextureResidencyManager manager(64ull << 20);
+        std::vector<uint32_t> aHandles;
+        for (uint32_t i = 0u; i < NUM_TEXTURES; ++i)
+        {
+            aHandles.push_back(manager.RegisterTexture(makeDesc(2048u)));
+        }
+
+        StreamingSimulation simulation(manager);
+        std::mt19937 generator(1u);
+        for (uint32_t uFrame = 0u; uFrame < NUM_FRAMES; ++uFrame)
+        {
+            if (uFrame == NUM_FRAMES / 2u)
+            {
+                manager.SetBudget(16ull << 20);
+            }
+
+            for (uint32_t i = 0u; i < 10u; ++i)
+            {
+                manager.ReportProjectedSize(aHandles[generator() % NUM_TEXTURES], static_cast<float>(generator() % 3000u));
+            }
+            simulation.Step();
+
+            ASSERT_LE(manager.GetCommittedBytes(), manager.GetBudget()) << "frame " << uFrame;
+        }
+
+        const TextureResidencyStats& stats = manager.GetStats();
+        EXPECT_GT(stats.uNumLoadsIssued, 0u);
+        EXPECT_GT(stats.uNumMipsEvicted, 0u);
+        EXPECT_GT(stats.uNumRequestsDeferred, 0u);
+        EXPECT_LE(stats.uPeakCommittedBytes, 64ull << 20);
+    }
+
+    TEST(TextureResidencyManager, VisibleTextureReachesDesiredMip)
+    {
+        TextureResidencyManager manager(64ull << 20);
+        const uint32_t uHandle = manager.RegisterTexture(makeDesc(1024u));
+        EXPECT_EQ(manager.GetResidentMip(uHandle), manager.GetTailMip(uHandle));
+
+        StreamingSimulation simulation(manager);
+        for (uint32_t uFrame = 0u; uFrame < 4u; ++uFrame)
+        {
+            manager.ReportProjectedSize(uHandle, 256.0f);
+            simulation.Step();
+        }
+
+        EXPECT_EQ(manager.GetDesiredMip(uHandle), 2u);
+        EXPECT_EQ(manager.GetResidentMip(uHandle), 2u);
+    }
+
+    TEST(TextureResidencyManager, UnusedTextureKeepsLevelsUntilNeeded)
+    {
+        TextureResidencyManager manager(64ull << 20);
+        manager.SetNumGraceFrames(4u);
+        const uint32_t uHandle = manager.RegisterTexture(makeDesc(1024u));
+
+        StreamingSimulation simulation(manager);
+        manager.ReportProjectedSize(uHandle, 1024.0f);
+        simulation.Step();
+        simulation.Step();
+        EXPECT_EQ(manager.GetResidentMip(uHandle), 0u);
+
+        for (uint32_t uFrame = 0u; uFrame < 8u; ++uFrame)
+        {
+            simulation.Step();
+        }
+
+        // Past the grace period the texture only wants its tail but its
+        // levels stay resident until another texture needs the memory
+        EXPECT_EQ(manager.GetDesiredMip(uHandle), manager.GetTailMip(uHandle));
+        EXPECT_EQ(manager.GetResidentMip(uHandle), 0u);
+    }
+
+    TEST(TextureResidencyManager, StreamsNanosuitDiffuseMap)
+    {
+        std::ifstream file(CONTENT_DIRECTORY "/Nanosuit/body_dif.dds", std::ios::binary);
+        ASSERT_TRUE(file.is_open());
+        const std::vector<uint8_t> aBytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        DDSTextureDesc desc = {};
+        size_t uDataOffset = 0u;
+        ASSERT_TRUE(DDSLayout::ReadHeader(aBytes.data(), aBytes.size(), desc, uDataOffset));
+
+        DDSTextureDesc rangeDesc = {};
+        std::vector<DDSSubresource> aSubresources;
+        ASSERT_TRUE(DDSLayout::GetSubresources(desc, uDataOffset, aBytes.size(), DDSRange{ 0u, 0u, 0u, 0u }, rangeDesc, aSubresources));
+        ASSERT_EQ(aSubresources.size(), desc.uNumMips);
+
+        TextureResidencyDesc residencyDesc = { desc.uWidth, desc.uHeight, {} };
+        for (const DDSSubresource& subresource : aSubresources)
+        {
+            residencyDesc.aMipByteSizes.push_back(subresource.uByteSize);
+        }
+
+        // The whole chain of one texture fits in the budget but not the
+        // chains of both
+        TextureResidencyManager manager(2ull << 20);
+        const uint32_t uBody = manager.RegisterTexture(residencyDesc);
+        const uint32_t uOther = manager.RegisterTexture(residencyDesc);
+        EXPECT_GT(manager.GetTailMip(uBody), 0u);
+
+        StreamingSimulation simulation(manager);
+        for (uint32_t uFrame = 0u; uFrame < 4u; ++uFrame)
+        {
+            manager.ReportProjectedSize(uBody, static_cast<float>(desc.uWidth));
+            simulation.Step();
+            ASSERT_LE(manager.GetCommittedBytes(), manager.GetBudget());
+        }
+        EXPECT_EQ(manager.GetResidentMip(uBody), 0u);
+
+        // Another texture needing the whole budget takes the place of
+        // the one that is no longer drawn
+        for (uint32_t uFrame = 0u; uFrame < 4u; ++uFrame)
+        {
+            manager.ReportProjectedSize(uOther, static_cast<float>(desc.uWidth));
+            simulation.Step();
+            ASSERT_LE(manager.GetCommittedBytes(), manager.GetBudget());
+        }
+        EXPECT_EQ(manager.GetResidentMip(uOther), 0u);
+        EXPECT_GT(manager.GetResidentMip(uBody), 0u);
+    }
+}
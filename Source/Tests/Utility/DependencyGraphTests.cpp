@@ -0,0 +1,113 @@
+/*+===================================================================
+  File:      DEPENDENCYGRAPHTESTS.CPP
+
+  Summary:   Builds include graphs of shader-like files and checks the
+             resources the dependency graph rebuilds when files change,
+             through chains, diamonds and cycles of includes, and after
+             resources and includes are removed
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include "Utility/DependencyGraph.h"
+
+namespace
+{
+    using namespace library;
+
+    std::vector<uint32_t> getAffected(const DependencyGraph& graph, const std::vector<std::filesystem::path>& aChangedFilePaths)
+    {
+        std::vector<uint32_t> aResources;
+        graph.GetAffectedResources(aChangedFilePaths, aResources);
+        return aResources;
+    }
+
+    TEST(DependencyGraph, ChangesReachResourcesThroughIncludeChains)
+    {
+        DependencyGraph graph;
+        graph.SetDependencies(1u, { "Shaders/Phong.fxh" });
+        graph.SetDependencies(2u, { "Shaders/Skinning.fxh" });
+        graph.SetIncludes("Shaders/Phong.fxh", { "Shaders/Lights.fxh" });
+        graph.SetIncludes("Shaders/Lights.fxh", { "Shaders/Constants.fxh" });
+
+        EXPECT_EQ(getAffected(graph, { "Shaders/Constants.fxh" }), std::vector<uint32_t>({ 1u }));
+        EXPECT_EQ(getAffected(graph, { "Shaders/Lights.fxh" }), std::vector<uint32_t>({ 1u }));
+        EXPECT_EQ(getAffected(graph, { "Shaders/Skinning.fxh" }), std::vector<uint32_t>({ 2u }));
+        EXPECT_EQ(getAffected(graph, { "Shaders/Constants.fxh", "Shaders/Skinning.fxh" }), std::vector<uint32_t>({ 1u, 2u }));
+        EXPECT_TRUE(getAffected(graph, { "Shaders/Unrelated.fxh" }).empty());
+
+        // Spellings of one file share a key
+        EXPECT_EQ(getAffected(graph, { "Shaders/../Shaders/./Constants.fxh" }), std::vector<uint32_t>({ 1u }));
+    }
+
+    TEST(DependencyGraph, DiamondsReportEachResourceOnce)
+    {
+        // Both halves of the diamond include Common, which two resources reach
+        DependencyGraph graph;
+        graph.SetDependencies(3u, { "Top.fxh" });
+        graph.SetDependencies(1u, { "Left.fxh", "Right.fxh" });
+        graph.SetIncludes("Top.fxh", { "Left.fxh", "Right.fxh" });
+        graph.SetIncludes("Left.fxh", { "Common.fxh" });
+        graph.SetIncludes("Right.fxh", { "Common.fxh" });
+
+        EXPECT_EQ(getAffected(graph, { "Common.fxh" }), std::vector<uint32_t>({ 1u, 3u }));
+        EXPECT_EQ(getAffected(graph, { "Common.fxh", "Left.fxh", "Right.fxh" }), std::vector<uint32_t>({ 1u, 3u }));
+
+        std::vector<std::filesystem::path> aFilePaths;
+        graph.GetFilePaths(aFilePaths);
+        EXPECT_EQ(aFilePaths.size(), 4u);
+    }
+
+    TEST(DependencyGraph, CyclesAreVisitedOnce)
+    {
+        DependencyGraph graph;
+        graph.SetDependencies(7u, { "A.fxh" });
+        graph.SetIncludes("A.fxh", { "B.fxh" });
+        graph.SetIncludes("B.fxh", { "C.fxh" });
+        graph.SetIncludes("C.fxh", { "A.fxh" });
+        graph.SetIncludes("D.fxh", { "D.fxh" });
+
+        EXPECT_EQ(getAffected(graph, { "C.fxh" }), std::vector<uint32_t>({ 7u }));
+        EXPECT_EQ(getAffected(graph, { "A.fxh" }), std::vector<uint32_t>({ 7u }));
+        EXPECT_TRUE(getAffected(graph, { "D.fxh" }).empty());
+
+        std::vector<std::filesystem::path> aFilePaths;
+        graph.GetFilePaths(aFilePaths);
+        EXPECT_EQ(aFilePaths, std::vector<std::filesystem::path>({ DependencyGraph::Normalize("A.fxh"), DependencyGraph::Normalize("B.fxh"), DependencyGraph::Normalize("C.fxh") }));
+    }
+
+    TEST(DependencyGraph, RemovedResourcesAndIncludesStopBeingAffected)
+    {
+        DependencyGraph graph;
+        graph.SetDependencies(1u, { "Shared.fxh" });
+        graph.SetDependencies(2u, { "Shared.fxh", "Own.fxh" });
+        graph.SetIncludes("Shared.fxh", { "Old.fxh" });
+        ASSERT_EQ(graph.GetNumResources(), 2u);
+
+        graph.RemoveResource(2u);
+        EXPECT_EQ(graph.GetNumResources(), 1u);
+        EXPECT_EQ(getAffected(graph, { "Shared.fxh" }), std::vector<uint32_t>({ 1u }));
+        EXPECT_TRUE(getAffected(graph, { "Own.fxh" }).empty());
+        EXPECT_EQ(getAffected(graph, { "Old.fxh" }), std::vector<uint32_t>({ 1u }));
+
+        // Replacing the includes drops the edges to the old ones
+        graph.SetIncludes("Shared.fxh", { "New.fxh" });
+        EXPECT_TRUE(getAffected(graph, { "Old.fxh" }).empty());
+        EXPECT_EQ(getAffected(graph, { "New.fxh" }), std::vector<uint32_t>({ 1u }));
+
+        // Replacing the dependencies of a resource forgets its old files
+        graph.SetDependencies(1u, { "Other.fxh" });
+        EXPECT_TRUE(getAffected(graph, { "New.fxh" }).empty());
+        EXPECT_EQ(getAffected(graph, { "Other.fxh" }), std::vector<uint32_t>({ 1u }));
+
+        graph.RemoveResource(1u);
+        graph.RemoveResource(1u);
+        EXPECT_EQ(graph.GetNumResources(), 0u);
+
+        std::vector<std::filesystem::path> aFilePaths;
+        graph.GetFilePaths(aFilePaths);
+        EXPECT_TRUE(aFilePaths.empty());
+    }
+}
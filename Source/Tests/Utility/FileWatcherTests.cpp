@@ -0,0 +1,67 @@
+/*+===================================================================
+  File:      FILEWATCHERTESTS.CPP
+
+  Summary:   Moves the last write time of temporary files by hand and
+             polls the file watcher, checking that a change is only
+             reported once the file stopped changing, and only once
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "Utility/FileWatcher.h"
+
+namespace
+{
+    using namespace library;
+
+    TEST(FileWatcher, ReportsChangesOnceTheySettle)
+    {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "FileWatcherTests";
+        std::filesystem::create_directories(directory);
+        const std::filesystem::path edited = directory / "Edited.fxh";
+        const std::filesystem::path untouched = directory / "Untouched.fxh";
+        std::ofstream(edited) << "edited";
+        std::ofstream(untouched) << "untouched";
+
+        // The interval is only used by the polling thread, which stays stopped
+        FileWatcher watcher(std::chrono::milliseconds(1000));
+        watcher.Watch({ edited, untouched });
+
+        std::vector<std::filesystem::path> aChangedFilePaths;
+        watcher.Poll();
+        watcher.ConsumeChanges(aChangedFilePaths);
+        EXPECT_TRUE(aChangedFilePaths.empty());
+
+        // A save in progress keeps moving the time, nothing is reported until it stops
+        const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(edited);
+        std::filesystem::last_write_time(edited, lastWriteTime + std::chrono::seconds(1));
+        watcher.Poll();
+        std::filesystem::last_write_time(edited, lastWriteTime + std::chrono::seconds(2));
+        watcher.Poll();
+        watcher.ConsumeChanges(aChangedFilePaths);
+        EXPECT_TRUE(aChangedFilePaths.empty());
+
+        watcher.Poll();
+        watcher.Poll();
+        watcher.ConsumeChanges(aChangedFilePaths);
+        EXPECT_EQ(aChangedFilePaths, std::vector<std::filesystem::path>({ edited }));
+
+        watcher.Poll();
+        watcher.ConsumeChanges(aChangedFilePaths);
+        EXPECT_TRUE(aChangedFilePaths.empty());
+
+        // Watching a new set keeps the time seen for the files still in it
+        std::filesystem::last_write_time(untouched, lastWriteTime + std::chrono::seconds(3));
+        watcher.Watch({ untouched });
+        watcher.Poll();
+        watcher.Poll();
+        watcher.ConsumeChanges(aChangedFilePaths);
+        EXPECT_EQ(aChangedFilePaths, std::vector<std::filesystem::path>({ untouched }));
+
+        std::filesystem::remove_all(directory);
+    }
+}
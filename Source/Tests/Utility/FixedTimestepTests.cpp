@@ -0,0 +1,160 @@
+/*+===================================================================
+  File:      FIXEDTIMESTEPTESTS.CPP
+
+  Summary:   Drives FixedTimestep and SimulationLoop with a synthetic
+             clock, so tick counts, interpolation and the catch-up
+             limit are checked without a window or real waiting
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "Utility/FixedTimestep.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr const double TICK_RATE = 60.0;
+    constexpr const double TICK_SECONDS = 1.0 / TICK_RATE;
+
+    TEST(FixedTimestep, HandsOutWholeTicks)
+    {
+        FixedTimestep timestep(TICK_RATE, 8u);
+        EXPECT_DOUBLE_EQ(timestep.GetTickSeconds(), TICK_SECONDS);
+
+        EXPECT_EQ(timestep.Advance(TICK_SECONDS * 0.5), 0u);
+        EXPECT_NEAR(timestep.GetAlpha(), 0.5, 1.0e-9);
+
+        EXPECT_EQ(timestep.Advance(TICK_SECONDS * 2.0), 2u);
+        EXPECT_NEAR(timestep.GetAlpha(), 0.5, 1.0e-9);
+        EXPECT_EQ(timestep.GetNumTicks(), 2u);
+
+        // Clocks that step back never remove ticks already due
+        EXPECT_EQ(timestep.Advance(-1.0), 0u);
+        EXPECT_NEAR(timestep.GetAlpha(), 0.5, 1.0e-9);
+
+        timestep.Reset();
+        EXPECT_EQ(timestep.GetNumTicks(), 0u);
+        EXPECT_DOUBLE_EQ(timestep.GetAlpha(), 0.0);
+    }
+
+    TEST(FixedTimestep, DropsTimePastTheCatchUpLimit)
+    {
+        FixedTimestep timestep(TICK_RATE, 4u);
+
+        // A one second stall only runs the limit and keeps the fraction
+        EXPECT_EQ(timestep.Advance(1.0 + TICK_SECONDS * 0.25), 4u);
+        EXPECT_NEAR(timestep.GetDroppedSeconds(), 56.0 * TICK_SECONDS, 1.0e-9);
+        EXPECT_NEAR(timestep.GetAlpha(), 0.25, 1.0e-6);
+
+        EXPECT_EQ(timestep.Advance(TICK_SECONDS), 1u);
+        EXPECT_EQ(timestep.GetNumTicks(), 5u);
+    }
+
+    TEST(FixedTimestep, FrameRateDoesNotChangeTheSimulation)
+    {
+        constexpr const double DURATION = 10.0;
+
+        std::mt19937 generator(7u);
+        std::uniform_real_distribution<double> frameTimes(0.001, 0.05);
+
+        FixedTimestep timestep(TICK_RATE, 8u);
+        double elapsed = 0.0;
+        uint64_t uNumTicks = 0u;
+        while (elapsed < DURATION)
+        {
+            const double frameSeconds = (std::min)(frameTimes(generator), DURATION - elapsed);
+            elapsed += frameSeconds;
+            uNumTicks += timestep.Advance(frameSeconds);
+        }
+
+        EXPECT_NEAR(static_cast<double>(uNumTicks), DURATION * TICK_RATE, 1.0);
+        EXPECT_EQ(uNumTicks, timestep.GetNumTicks());
+        EXPECT_DOUBLE_EQ(timestep.GetDroppedSeconds(), 0.0);
+    }
+
+    TEST(FixedTimestep, ClampsSettings)
+    {
+        FixedTimestep timestep(0.0, 0u);
+        EXPECT_DOUBLE_EQ(timestep.GetTickSeconds(), 1.0);
+        EXPECT_EQ(timestep.Advance(3.0), 1u);
+
+        timestep.SetTickRate(120.0);
+        timestep.SetMaxTicksPerAdvance(1000u);
+        EXPECT_EQ(timestep.Advance(0.5), 60u);
+    }
+
+    TEST(SimulationLoop, PumpsTheTicksOfASyntheticClock)
+    {
+        double now = 100.0;
+        SimulationLoop loop(TICK_RATE, 8u, [&now]() { return now; });
+
+        uint32_t uNumCalls = 0u;
+        double simulatedSeconds = 0.0;
+        loop.SetTickFunction([&](double tickSeconds)
+        {
+            ++uNumCalls;
+            simulatedSeconds += tickSeconds;
+        });
+
+        EXPECT_DOUBLE_EQ(loop.GetAlpha(), 1.0);
+
+        // The first pump only starts the clock
+        EXPECT_EQ(loop.Pump(), 0u);
+        EXPECT_DOUBLE_EQ(loop.GetAlpha(), 0.0);
+
+        now += TICK_SECONDS * 3.5;
+        EXPECT_EQ(loop.Pump(), 3u);
+        EXPECT_EQ(uNumCalls, 3u);
+        EXPECT_NEAR(simulatedSeconds, TICK_SECONDS * 3.0, 1.0e-12);
+
+        // Between pumps the alpha follows the clock and saturates
+        EXPECT_NEAR(loop.GetAlpha(), 0.5, 1.0e-6);
+        now += TICK_SECONDS * 0.25;
+        EXPECT_NEAR(loop.GetAlpha(), 0.75, 1.0e-6);
+        now += TICK_SECONDS;
+        EXPECT_DOUBLE_EQ(loop.GetAlpha(), 1.0);
+
+        EXPECT_EQ(loop.Pump(), 1u);
+        EXPECT_EQ(loop.GetNumTicks(), 4u);
+
+        now += 10.0;
+        EXPECT_EQ(loop.Pump(), 8u);
+        EXPECT_EQ(loop.GetNumTicks(), 12u);
+    }
+
+    TEST(SimulationLoop, ThreadTicksAndStops)
+    {
+        std::atomic<double> now(0.0);
+        SimulationLoop loop(TICK_RATE, 8u, [&now]() { return now.load(); });
+
+        std::atomic<uint32_t> uNumCalls(0u);
+        loop.SetTickFunction([&uNumCalls](double) { ++uNumCalls; });
+
+        // The thread reads the clock at its own pace, so keep it moving
+        loop.Start();
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (uNumCalls.load() < 30u && std::chrono::steady_clock::now() < deadline)
+        {
+            now = now.load() + TICK_SECONDS;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        loop.Stop();
+
+        const uint32_t uNumCallsAtStop = uNumCalls.load();
+        EXPECT_GE(uNumCallsAtStop, 30u);
+        EXPECT_EQ(loop.GetNumTicks(), uNumCallsAtStop);
+
+        // Nothing ticks once the thread is stopped
+        now = now.load() + 1.0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(uNumCalls.load(), uNumCallsAtStop);
+    }
+}
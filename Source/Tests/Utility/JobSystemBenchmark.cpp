@@ -0,0 +1,187 @@
+/*+===================================================================
+  File:      JOBSYSTEMBENCHMARK.CPP
+
+  Summary:   Times the throughput of empty jobs scheduled from outside
+             and inside the pool and of ParallelFor, and the latency
+             from scheduling a job to a sleeping worker starting it and
+             of running a small frame-shaped task graph
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "Utility/JobSystem.h"
+#include "Utility/TaskGraph.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr uint32_t NUM_JOBS = 100000u;
+    constexpr uint32_t NUM_LATENCY_SAMPLES = 500u;
+    constexpr uint32_t NUM_REPEATS = 5u;
+
+    using Clock = std::chrono::steady_clock;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: elapsedNs
+      Summary:  Returns the nanoseconds between two time points
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double elapsedNs(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: timeJobs
+      Summary:  Returns the fastest time per job of a few runs that
+                schedule NUM_JOBS empty jobs and wait for them, from the
+                calling thread or from a job on a worker
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double timeJobs(JobSystem& jobSystem, bool bIsFromWorker)
+    {
+        auto run = [&jobSystem]()
+        {
+            std::vector<JobHandle> aJobs;
+            aJobs.reserve(NUM_JOBS);
+            for (uint32_t i = 0u; i < NUM_JOBS; ++i)
+            {
+                aJobs.push_back(jobSystem.Schedule([]() { }));
+            }
+            for (const JobHandle& job : aJobs)
+            {
+                jobSystem.Wait(job);
+            }
+        };
+
+        double fastestNs = 1.0e12;
+        for (uint32_t uRepeat = 0u; uRepeat < NUM_REPEATS; ++uRepeat)
+        {
+            Clock::time_point start = Clock::now();
+            if (bIsFromWorker)
+            {
+                jobSystem.Wait(jobSystem.Schedule(run));
+            }
+            else
+            {
+                run();
+            }
+            fastestNs = (std::min)(fastestNs, elapsedNs(start, Clock::now()) / NUM_JOBS);
+        }
+
+        return fastestNs;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: timeParallelFor
+      Summary:  Returns the fastest time per item of a few ParallelFor
+                calls summing uCount items in chunks of uGrainSize
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double timeParallelFor(JobSystem& jobSystem, uint32_t uCount, uint32_t uGrainSize)
+    {
+        std::vector<uint32_t> auItems(uCount, 1u);
+        std::atomic<uint64_t> uSum(0u);
+
+        double fastestNs = 1.0e12;
+        for (uint32_t uRepeat = 0u; uRepeat < NUM_REPEATS; ++uRepeat)
+        {
+            Clock::time_point start = Clock::now();
+            jobSystem.ParallelFor(uCount, uGrainSize, [&auItems, &uSum](uint32_t uBegin, uint32_t uEnd)
+            {
+                uint64_t uChunkSum = 0u;
+                for (uint32_t i = uBegin; i < uEnd; ++i)
+                {
+                    uChunkSum += auItems[i];
+                }
+                uSum.fetch_add(uChunkSum);
+            });
+            fastestNs = (std::min)(fastestNs, elapsedNs(start, Clock::now()) / uCount);
+        }
+
+        return uSum.load() == static_cast<uint64_t>(uCount) * NUM_REPEATS ? fastestNs : -1.0;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printPercentiles
+      Summary:  Prints the median and 99th percentile of the samples in
+                microseconds
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void printPercentiles(const char* pszName, std::vector<double>& aNs)
+    {
+        std::sort(aNs.begin(), aNs.end());
+        std::printf("%-28s median %7.1f us, p99 %7.1f us\n", pszName, aNs[aNs.size() / 2u] / 1000.0, aNs[aNs.size() * 99u / 100u] / 1000.0);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: timeWakeLatency
+      Summary:  Schedules one job at a time while the workers sleep and
+                the calling thread blocks outside Wait, so a worker has
+                to wake up to run it, and prints the time from Schedule
+                to the start of the job
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void timeWakeLatency(JobSystem& jobSystem)
+    {
+        std::vector<double> aNs;
+        aNs.reserve(NUM_LATENCY_SAMPLES);
+        for (uint32_t i = 0u; i < NUM_LATENCY_SAMPLES; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            std::promise<Clock::time_point> started;
+            Clock::time_point start = Clock::now();
+            JobHandle job = jobSystem.Schedule([&started]() { started.set_value(Clock::now()); });
+            aNs.push_back(elapsedNs(start, started.get_future().get()));
+            jobSystem.Wait(job);
+        }
+
+        printPercentiles("schedule to start", aNs);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: timeTaskGraph
+      Summary:  Runs a graph of empty tasks shaped like the frame graph
+                of the renderer and prints the time per run
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void timeTaskGraph(JobSystem& jobSystem)
+    {
+        TaskGraph graph;
+        const uint32_t uUpdate = graph.AddTask("Update", []() { });
+        const uint32_t uCull = graph.AddTask("Cull", []() { }, { uUpdate });
+        const uint32_t uAnimate = graph.AddTask("Animate", []() { }, { uUpdate });
+        const uint32_t uDrawLists = graph.AddTask("DrawLists", []() { }, { uCull, uAnimate });
+        graph.AddTask("Submit", []() { }, { uDrawLists });
+
+        std::vector<double> aNs;
+        aNs.reserve(NUM_LATENCY_SAMPLES);
+        for (uint32_t i = 0u; i < NUM_LATENCY_SAMPLES; ++i)
+        {
+            Clock::time_point start = Clock::now();
+            graph.Run(jobSystem);
+            aNs.push_back(elapsedNs(start, Clock::now()));
+        }
+
+        printPercentiles("task graph of 5 tasks", aNs);
+    }
+}
+
+int main()
+{
+    JobSystem jobSystem;
+    std::printf("%u workers, %u jobs per run, fastest of %u runs\n", jobSystem.GetNumWorkers(), NUM_JOBS, NUM_REPEATS);
+
+    std::printf("%-28s %7.1f ns/job\n", "empty jobs from outside", timeJobs(jobSystem, false));
+    std::printf("%-28s %7.1f ns/job\n", "empty jobs from a worker", timeJobs(jobSystem, true));
+    std::printf("%-28s %7.2f ns/item\n", "ParallelFor, grain 64", timeParallelFor(jobSystem, 1u << 20u, 64u));
+    std::printf("%-28s %7.2f ns/item\n", "ParallelFor, grain 4096", timeParallelFor(jobSystem, 1u << 20u, 4096u));
+
+    timeWakeLatency(jobSystem);
+    timeTaskGraph(jobSystem);
+    return 0;
+}
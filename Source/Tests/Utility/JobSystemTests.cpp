@@ -0,0 +1,171 @@
+/*+===================================================================
+  File:      JOBSYSTEMTESTS.CPP
+
+  Summary:   Runs jobs on small job systems and checks that ParallelFor
+             visits every item once, that jobs start after their
+             dependencies, that idle workers steal queued jobs and that
+             a waiting thread sleeps instead of spinning
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <set>
+
+#include "Utility/JobSystem.h"
+
+namespace
+{
+    using namespace library;
+
+    TEST(JobSystem, ParallelForVisitsEveryItemOnce)
+    {
+        JobSystem jobSystem(3u);
+        for (uint32_t uCount : { 0u, 1u, 7u, 1000u, 4097u })
+        {
+            for (uint32_t uGrainSize : { 0u, 1u, 16u, 1000u })
+            {
+                for (uint32_t uMaxNumJobs : { 0u, 1u, 2u, 64u })
+                {
+                    std::vector<std::atomic<uint32_t>> auNumVisits(uCount);
+                    jobSystem.ParallelFor(uCount, uGrainSize, [&auNumVisits](uint32_t uBegin, uint32_t uEnd)
+                    {
+                        for (uint32_t i = uBegin; i < uEnd; ++i)
+                        {
+                            auNumVisits[i].fetch_add(1u);
+                        }
+                    }, uMaxNumJobs);
+
+                    for (uint32_t i = 0u; i < uCount; ++i)
+                    {
+                        ASSERT_EQ(auNumVisits[i].load(), 1u) << "item " << i << " of " << uCount << ", grain " << uGrainSize << ", " << uMaxNumJobs << " jobs";
+                    }
+                }
+            }
+        }
+    }
+
+    TEST(JobSystem, JobsStartAfterTheirDependencies)
+    {
+        JobSystem jobSystem(3u);
+        for (uint32_t uRepeat = 0u; uRepeat < 100u; ++uRepeat)
+        {
+            // A diamond hanging off a chain, each job stamping the order it ran in
+            std::atomic<uint32_t> uNextStamp(0u);
+            uint32_t auStamps[6] = {};
+            auto stamp = [&uNextStamp, &auStamps](uint32_t uJob)
+            {
+                return [&uNextStamp, &auStamps, uJob]() { auStamps[uJob] = uNextStamp.fetch_add(1u); };
+            };
+
+            JobHandle first = jobSystem.Schedule(stamp(0u));
+            JobHandle second = jobSystem.Schedule(stamp(1u), { first });
+            JobHandle left = jobSystem.Schedule(stamp(2u), { second });
+            JobHandle right = jobSystem.Schedule(stamp(3u), { second });
+            JobHandle bottom = jobSystem.Schedule(stamp(4u), { left, right, JobHandle() });
+            JobHandle last = jobSystem.Schedule(stamp(5u), { bottom, first });
+            jobSystem.Wait(last);
+
+            ASSERT_TRUE(first.IsDone() && second.IsDone() && left.IsDone() && right.IsDone() && bottom.IsDone());
+            EXPECT_LT(auStamps[0], auStamps[1]);
+            EXPECT_LT(auStamps[1], auStamps[2]);
+            EXPECT_LT(auStamps[1], auStamps[3]);
+            EXPECT_LT(auStamps[2], auStamps[4]);
+            EXPECT_LT(auStamps[3], auStamps[4]);
+            EXPECT_EQ(auStamps[5], 5u);
+        }
+
+        // Depending on a job that is long done queues the new job at once
+        JobHandle done = jobSystem.Schedule([]() { });
+        jobSystem.Wait(done);
+        bool bHasRun = false;
+        jobSystem.Wait(jobSystem.Schedule([&bHasRun]() { bHasRun = true; }, { done }));
+        EXPECT_TRUE(bHasRun);
+    }
+
+    TEST(JobSystem, JobsWaitOnJobsTheySchedule)
+    {
+        JobSystem jobSystem(2u);
+        std::atomic<uint32_t> uNumLeaves(0u);
+        std::function<void(uint32_t)> spawn = [&](uint32_t uDepth)
+        {
+            if (uDepth == 0u)
+            {
+                uNumLeaves.fetch_add(1u);
+                return;
+            }
+
+            JobHandle left = jobSystem.Schedule([&spawn, uDepth]() { spawn(uDepth - 1u); });
+            JobHandle right = jobSystem.Schedule([&spawn, uDepth]() { spawn(uDepth - 1u); });
+            jobSystem.Wait(left);
+            jobSystem.Wait(right);
+        };
+
+        jobSystem.Wait(jobSystem.Schedule([&spawn]() { spawn(8u); }));
+        EXPECT_EQ(uNumLeaves.load(), 256u);
+    }
+
+    TEST(JobSystem, IdleWorkersStealQueuedJobs)
+    {
+        // The parent queues its children on the deque of its own worker, so
+        // any child run by another thread was stolen
+        JobSystem jobSystem(3u);
+        std::mutex mutex;
+        std::set<std::thread::id> threadIds;
+        std::thread::id parentThreadId;
+
+        std::promise<void> started;
+        JobHandle parent = jobSystem.Schedule([&]()
+        {
+            parentThreadId = std::this_thread::get_id();
+            started.set_value();
+
+            std::vector<JobHandle> aChildren;
+            for (uint32_t i = 0u; i < 32u; ++i)
+            {
+                aChildren.push_back(jobSystem.Schedule([&]()
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threadIds.insert(std::this_thread::get_id());
+                }));
+            }
+            for (const JobHandle& child : aChildren)
+            {
+                jobSystem.Wait(child);
+            }
+        });
+
+        // Blocking here, not in Wait, keeps the calling thread from running the parent
+        started.get_future().wait();
+        jobSystem.Wait(parent);
+
+        EXPECT_GT(threadIds.size(), 1u);
+        threadIds.erase(parentThreadId);
+        EXPECT_FALSE(threadIds.empty());
+    }
+
+    TEST(JobSystem, WaitSleepsWhileNothingIsQueued)
+    {
+        JobSystem jobSystem(1u);
+        std::promise<void> started;
+        JobHandle job = jobSystem.Schedule([&started]()
+        {
+            started.set_value();
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        });
+        started.get_future().wait();
+
+        // Every thread sleeps during the job, so the process uses almost no CPU time
+        const std::clock_t start = std::clock();
+        jobSystem.Wait(job);
+        const double milliseconds = 1000.0 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+        EXPECT_TRUE(job.IsDone());
+        EXPECT_LT(milliseconds, 50.0);
+    }
+}
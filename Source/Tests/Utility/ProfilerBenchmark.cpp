@@ -0,0 +1,100 @@
+/*+===================================================================
+  File:      PROFILERBENCHMARK.CPP
+
+  Summary:   Times the cost of a profile zone with the profiler
+             disabled and enabled, on one thread and on several
+             threads at once, and the export of full rings to a Chrome
+             trace
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "Utility/Profiler.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr uint32_t NUM_ZONES = 1000000u;
+    constexpr uint32_t NUM_REPEATS = 5u;
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: timeZones
+      Summary:  Returns the fastest time per PROFILE_ZONE of a few runs
+                of NUM_ZONES zones, each nested in a frame zone the way
+                the frame code nests them
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double timeZones()
+    {
+        double fastestNs = 1.0e9;
+        for (uint32_t uRepeat = 0u; uRepeat < NUM_REPEATS; ++uRepeat)
+        {
+            PROFILE_ZONE("Frame");
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0u; i < NUM_ZONES; ++i)
+            {
+                PROFILE_ZONE("Zone");
+            }
+            fastestNs = (std::min)(fastestNs, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / NUM_ZONES);
+        }
+
+        return fastestNs;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: timeThreads
+      Summary:  Records zones on several threads at once and returns
+                the slowest of their times per zone
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double timeThreads(uint32_t uNumThreads)
+    {
+        std::vector<double> aNs(uNumThreads);
+        std::vector<std::thread> aThreads;
+        for (uint32_t i = 0u; i < uNumThreads; ++i)
+        {
+            aThreads.emplace_back([&aNs, i]()
+            {
+                aNs[i] = timeZones();
+            });
+        }
+        for (std::thread& thread : aThreads)
+        {
+            thread.join();
+        }
+
+        return *std::max_element(aNs.begin(), aNs.end());
+    }
+}
+
+int main()
+{
+    const uint32_t uNumThreads = (std::max)(std::thread::hardware_concurrency(), 2u);
+    std::printf("%u zones per run, fastest of %u runs\n", NUM_ZONES, NUM_REPEATS);
+
+    Profiler::SetEnabled(false);
+    std::printf("disabled             %6.1f ns/zone\n", timeZones());
+
+    Profiler::SetEnabled(true);
+    std::printf("enabled              %6.1f ns/zone\n", timeZones());
+    std::printf("MeasureZoneOverhead  %6.1f ns/zone\n", Profiler::MeasureZoneOverhead(NUM_ZONES));
+    std::printf("enabled, %2u threads  %6.1f ns/zone\n", uNumThreads, timeThreads(uNumThreads));
+
+    // Every ring is full by now
+    const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "ProfilerBenchmark.json";
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const bool bIsExported = Profiler::ExportChromeTrace(filePath);
+    const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::error_code errorCode;
+    std::printf("export               %6.1f ms, %.1f MB%s\n", milliseconds, static_cast<double>(std::filesystem::file_size(filePath, errorCode)) / (1024.0 * 1024.0), bIsExported ? "" : " (failed)");
+    std::filesystem::remove(filePath, errorCode);
+    return 0;
+}
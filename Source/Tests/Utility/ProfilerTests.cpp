@@ -0,0 +1,473 @@
+/*+===================================================================
+  File:      PROFILERTESTS.CPP
+
+  Summary:   Records zones on test threads and tracks, exports them
+             and parses the trace back, checking that it is valid JSON
+             while threads keep recording, that nested zones stay
+             inside their parents and that the rings keep the newest
+             zones when they wrap
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utility/Profiler.h"
+
+namespace
+{
+    using namespace library;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   JsonValue
+      Summary:  Parsed JSON value, enough of it to read a trace back
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct JsonValue
+    {
+        enum class eType { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT } type = eType::NUL;
+        double number = 0.0;
+        std::string szString;
+        std::vector<JsonValue> aElements;
+        std::map<std::string, JsonValue> members;
+
+        const JsonValue& operator[](const std::string& szKey) const
+        {
+            static const JsonValue NUL;
+            auto it = members.find(szKey);
+            return it != members.end() ? it->second : NUL;
+        }
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    JsonParser
+      Summary:  Strict recursive descent parser of RFC 8259 JSON. Any
+                deviation, including trailing content, fails the parse
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class JsonParser
+    {
+    public:
+        explicit JsonParser(const std::string& szText)
+            : m_szText(szText)
+            , m_uPosition(0u)
+        { }
+
+        bool Parse(JsonValue& outValue)
+        {
+            return parseValue(outValue) && (skipSpace(), m_uPosition == m_szText.size());
+        }
+
+    private:
+        void skipSpace()
+        {
+            while (m_uPosition < m_szText.size() && (m_szText[m_uPosition] == ' ' || m_szText[m_uPosition] == '\n' || m_szText[m_uPosition] == '\r' || m_szText[m_uPosition] == '\t'))
+            {
+                ++m_uPosition;
+            }
+        }
+
+        bool consume(char c)
+        {
+            skipSpace();
+            if (m_uPosition < m_szText.size() && m_szText[m_uPosition] == c)
+            {
+                ++m_uPosition;
+                return true;
+            }
+            return false;
+        }
+
+        bool consumeWord(const char* pszWord)
+        {
+            const std::string szWord(pszWord);
+            if (m_szText.compare(m_uPosition, szWord.size(), szWord) != 0)
+            {
+                return false;
+            }
+            m_uPosition += szWord.size();
+            return true;
+        }
+
+        bool parseString(std::string& outString)
+        {
+            if (!consume('"'))
+            {
+                return false;
+            }
+
+            outString.clear();
+            while (m_uPosition < m_szText.size())
+            {
+                char c = m_szText[m_uPosition++];
+                if (c == '"')
+                {
+                    return true;
+                }
+                if (static_cast<unsigned char>(c) < 0x20u)
+                {
+                    return false;
+                }
+                if (c == '\\')
+                {
+                    if (m_uPosition >= m_szText.size())
+                    {
+                        return false;
+                    }
+                    c = m_szText[m_uPosition++];
+                    if (c != '"' && c != '\\' && c != '/')
+                    {
+                        // The profiler never writes other escapes
+                        return false;
+                    }
+                }
+                outString += c;
+            }
+            return false;
+        }
+
+        bool parseNumber(double& outNumber)
+        {
+            const size_t uStart = m_uPosition;
+            if (m_uPosition < m_szText.size() && m_szText[m_uPosition] == '-')
+            {
+                ++m_uPosition;
+            }
+            const size_t uDigits = m_uPosition;
+            while (m_uPosition < m_szText.size() && (std::isdigit(static_cast<unsigned char>(m_szText[m_uPosition])) || m_szText[m_uPosition] == '.'
+                || m_szText[m_uPosition] == 'e' || m_szText[m_uPosition] == 'E' || m_szText[m_uPosition] == '+' || m_szText[m_uPosition] == '-'))
+            {
+                ++m_uPosition;
+            }
+            if (m_uPosition == uDigits || !std::isdigit(static_cast<unsigned char>(m_szText[uDigits])) || (m_szText[uDigits] == '0' && m_uPosition > uDigits + 1u && m_szText[uDigits + 1u] != '.'))
+            {
+                return false;
+            }
+
+            std::istringstream stream(m_szText.substr(uStart, m_uPosition - uStart));
+            stream >> outNumber;
+            return !stream.fail() && stream.peek() == std::char_traits<char>::eof();
+        }
+
+        bool parseValue(JsonValue& outValue)
+        {
+            skipSpace();
+            if (m_uPosition >= m_szText.size())
+            {
+                return false;
+            }
+
+            switch (m_szText[m_uPosition])
+            {
+            case '{':
+                outValue.type = JsonValue::eType::OBJECT;
+                ++m_uPosition;
+                if (consume('}'))
+                {
+                    return true;
+                }
+                do
+                {
+                    std::string szKey;
+                    if (!parseString(szKey) || !consume(':') || !parseValue(outValue.members[szKey]))
+                    {
+                        return false;
+                    }
+                } while (consume(','));
+                return consume('}');
+
+            case '[':
+                outValue.type = JsonValue::eType::ARRAY;
+                ++m_uPosition;
+                if (consume(']'))
+                {
+                    return true;
+                }
+                do
+                {
+                    if (!parseValue(outValue.aElements.emplace_back()))
+                    {
+                        return false;
+                    }
+                } while (consume(','));
+                return consume(']');
+
+            case '"':
+                outValue.type = JsonValue::eType::STRING;
+                return parseString(outValue.szString);
+
+            case 't':
+            case 'f':
+                outValue.type = JsonValue::eType::BOOLEAN;
+                return consumeWord(m_szText[m_uPosition] == 't' ? "true" : "false");
+
+            case 'n':
+                return consumeWord("null");
+
+            default:
+                outValue.type = JsonValue::eType::NUMBER;
+                return parseNumber(outValue.number);
+            }
+        }
+
+    private:
+        const std::string& m_szText;
+        size_t m_uPosition;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: exportTrace
+      Summary:  Exports the trace to a temporary file and parses it
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool exportTrace(JsonValue& outTrace)
+    {
+        const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "ProfilerTests.json";
+        if (!Profiler::ExportChromeTrace(filePath))
+        {
+            return false;
+        }
+
+        std::ifstream file(filePath, std::ios::binary);
+        const std::string szText((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::filesystem::remove(filePath);
+
+        outTrace = JsonValue();
+        return JsonParser(szText).Parse(outTrace);
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: getZones
+      Summary:  Returns the complete events of the track named by the
+                thread_name metadata of the trace
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    std::vector<const JsonValue*> getZones(const JsonValue& trace, const std::string& szTrackName)
+    {
+        double tid = -1.0;
+        for (const JsonValue& event : trace["traceEvents"].aElements)
+        {
+            if (event["name"].szString == "thread_name" && event["args"]["name"].szString == szTrackName)
+            {
+                tid = event["tid"].number;
+            }
+        }
+
+        std::vector<const JsonValue*> aZones;
+        for (const JsonValue& event : trace["traceEvents"].aElements)
+        {
+            if (event["ph"].szString == "X" && event["tid"].number == tid)
+            {
+                aZones.push_back(&event);
+            }
+        }
+        return aZones;
+    }
+
+    TEST(Profiler, NestedZonesStayInsideTheirParents)
+    {
+        Profiler::SetEnabled(true);
+        Profiler::Clear();
+
+        std::thread([]()
+        {
+            Profiler::SetThreadName("NestingTest");
+            PROFILE_ZONE("Outer");
+            {
+                PROFILE_ZONE("Middle");
+                {
+                    PROFILE_ZONE("Inner");
+                }
+            }
+            {
+                PROFILE_ZONE("Sibling");
+            }
+        }).join();
+
+        JsonValue trace;
+        ASSERT_TRUE(exportTrace(trace));
+        const std::vector<const JsonValue*> aZones = getZones(trace, "NestingTest");
+        ASSERT_EQ(aZones.size(), 4u);
+
+        // Zones are recorded as they close, innermost first
+        const char* apszNames[] = { "Inner", "Middle", "Sibling", "Outer" };
+        const double aDepths[] = { 2.0, 1.0, 1.0, 0.0 };
+        for (size_t i = 0u; i < aZones.size(); ++i)
+        {
+            EXPECT_EQ((*aZones[i])["name"].szString, apszNames[i]);
+            EXPECT_EQ((*aZones[i])["args"]["depth"].number, aDepths[i]);
+            EXPECT_GE((*aZones[i])["dur"].number, 0.0);
+        }
+
+        auto contains = [](const JsonValue& parent, const JsonValue& child)
+        {
+            return parent["ts"].number <= child["ts"].number && child["ts"].number + child["dur"].number <= parent["ts"].number + parent["dur"].number;
+        };
+        EXPECT_TRUE(contains(*aZones[1], *aZones[0]));
+        EXPECT_TRUE(contains(*aZones[3], *aZones[1]));
+        EXPECT_TRUE(contains(*aZones[3], *aZones[2]));
+        EXPECT_LE((*aZones[1])["ts"].number + (*aZones[1])["dur"].number, (*aZones[2])["ts"].number);
+    }
+
+    TEST(Profiler, ZonesDeeperThanMaxDepthAreDropped)
+    {
+        Profiler::SetEnabled(true);
+        Profiler::Clear();
+
+        std::thread([]()
+        {
+            Profiler::SetThreadName("DepthTest");
+            for (uint32_t i = 0u; i < Profiler::MAX_DEPTH + 4u; ++i)
+            {
+                Profiler::BeginZone("Deep");
+            }
+            for (uint32_t i = 0u; i < Profiler::MAX_DEPTH + 4u; ++i)
+            {
+                Profiler::EndZone();
+            }
+
+            // A zone opened while disabled is not closed, so the nesting stays balanced
+            Profiler::SetEnabled(false);
+            {
+                ProfileZone hidden("Hidden");
+                Profiler::SetEnabled(true);
+            }
+            PROFILE_ZONE("After");
+        }).join();
+
+        JsonValue trace;
+        ASSERT_TRUE(exportTrace(trace));
+        const std::vector<const JsonValue*> aZones = getZones(trace, "DepthTest");
+        ASSERT_EQ(aZones.size(), Profiler::MAX_DEPTH + 1u);
+        for (uint32_t i = 0u; i < Profiler::MAX_DEPTH; ++i)
+        {
+            EXPECT_EQ((*aZones[i])["name"].szString, "Deep");
+            EXPECT_EQ((*aZones[i])["args"]["depth"].number, static_cast<double>(Profiler::MAX_DEPTH - 1u - i));
+        }
+        EXPECT_EQ((*aZones.back())["name"].szString, "After");
+        EXPECT_EQ((*aZones.back())["args"]["depth"].number, 0.0);
+    }
+
+    TEST(Profiler, RingsKeepTheNewestZones)
+    {
+        Profiler::SetEnabled(true);
+        Profiler::Clear();
+
+        // Zone i starts at i microseconds, so the trace tells which zones survived
+        const uint32_t uTrack = Profiler::AddTrack("RingTest");
+        const uint32_t uNumZones = Profiler::NUM_EVENTS_PER_TRACK + 1000u;
+        for (uint32_t i = 0u; i < uNumZones; ++i)
+        {
+            Profiler::AddZone(uTrack, "Ring", i * 1000ull, i * 1000ull + 500ull, 0u);
+        }
+
+        JsonValue trace;
+        ASSERT_TRUE(exportTrace(trace));
+        std::vector<const JsonValue*> aZones = getZones(trace, "RingTest");
+        ASSERT_EQ(aZones.size(), Profiler::NUM_EVENTS_PER_TRACK);
+        for (size_t i = 0u; i < aZones.size(); ++i)
+        {
+            ASSERT_EQ((*aZones[i])["ts"].number, static_cast<double>(uNumZones - Profiler::NUM_EVENTS_PER_TRACK + i));
+            ASSERT_EQ((*aZones[i])["dur"].number, 0.5);
+        }
+
+        // Clearing forgets the wrapped ring, later zones are kept
+        Profiler::Clear();
+        Profiler::AddZone(uTrack, "Ring", 1000ull, 3000ull, 1u);
+        ASSERT_TRUE(exportTrace(trace));
+        aZones = getZones(trace, "RingTest");
+        ASSERT_EQ(aZones.size(), 1u);
+        EXPECT_EQ((*aZones[0])["dur"].number, 2.0);
+        EXPECT_EQ((*aZones[0])["args"]["depth"].number, 1.0);
+    }
+
+    TEST(Profiler, ExportsValidJsonWhileThreadsRecord)
+    {
+        Profiler::SetEnabled(true);
+        Profiler::Clear();
+
+        // Every writer wraps its ring many times during the exports
+        std::atomic<bool> bIsRunning = true;
+        std::atomic<uint32_t> uNumStarted = 0u;
+        std::vector<std::thread> aWriters;
+        for (uint32_t i = 0u; i < 2u; ++i)
+        {
+            aWriters.emplace_back([&bIsRunning, &uNumStarted]()
+            {
+                Profiler::SetThreadName("Writer \"quoted\\\"");
+                {
+                    PROFILE_ZONE("Frame");
+                }
+                ++uNumStarted;
+
+                while (bIsRunning.load(std::memory_order_relaxed))
+                {
+                    PROFILE_ZONE("Frame");
+                    PROFILE_ZONE("Work");
+                }
+            });
+        }
+
+        while (uNumStarted.load() < aWriters.size())
+        {
+            std::this_thread::yield();
+        }
+
+        for (uint32_t uExport = 0u; uExport < 3u; ++uExport)
+        {
+            JsonValue trace;
+            ASSERT_TRUE(exportTrace(trace));
+            EXPECT_GT(trace["otherData"]["zoneOverheadNs"].number, 0.0);
+            EXPECT_EQ(trace["displayTimeUnit"].szString, "ms");
+
+            for (const JsonValue& event : trace["traceEvents"].aElements)
+            {
+                if (event["ph"].szString != "X")
+                {
+                    continue;
+                }
+
+                EXPECT_TRUE(event["name"].szString == "Frame" || event["name"].szString == "Work") << event["name"].szString;
+                EXPECT_GE(event["dur"].number, 0.0);
+                EXPECT_LE(event["args"]["depth"].number, 1.0);
+            }
+            EXPECT_FALSE(getZones(trace, "Writer \"quoted\\\"").empty());
+        }
+
+        bIsRunning = false;
+        for (std::thread& writer : aWriters)
+        {
+            writer.join();
+        }
+    }
+
+    TEST(Profiler, MeasuresTheZoneOverheadAside)
+    {
+        Profiler::SetEnabled(true);
+        Profiler::Clear();
+
+        std::thread([]()
+        {
+            Profiler::SetThreadName("OverheadTest");
+            PROFILE_ZONE("Open");
+            EXPECT_GT(Profiler::MeasureZoneOverhead(1000u), 0.0);
+            EXPECT_EQ(Profiler::MeasureZoneOverhead(0u), 0.0);
+        }).join();
+
+        // The scratch zones go neither to the thread track nor to its open zone
+        JsonValue trace;
+        ASSERT_TRUE(exportTrace(trace));
+        const std::vector<const JsonValue*> aZones = getZones(trace, "OverheadTest");
+        ASSERT_EQ(aZones.size(), 1u);
+        EXPECT_EQ((*aZones[0])["name"].szString, "Open");
+        EXPECT_EQ((*aZones[0])["args"]["depth"].number, 0.0);
+    }
+}
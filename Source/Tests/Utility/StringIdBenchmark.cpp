@@ -0,0 +1,78 @@
+/*+===================================================================
+  File:      STRINGIDBENCHMARK.CPP
+
+  Summary:   Times resource lookups by wide string, as the scene did
+             before, by StringId and by dense handle
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Utility/StringId.h"
+
+namespace
+{
+    using namespace library;
+
+    constexpr uint32_t NUM_NAMES = 64u;
+    constexpr uint32_t NUM_LOOKUPS = 2000000u;
+
+    template <class Lookup>
+    void run(const char* pszName, Lookup lookup)
+    {
+        uint64_t uSum = 0u;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0u; i < NUM_LOOKUPS; ++i)
+        {
+            uSum += lookup(i % NUM_NAMES);
+        }
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / NUM_LOOKUPS;
+
+        std::printf("  %-28s %8.1f ns (checksum %llu)\n", pszName, nanoseconds, static_cast<unsigned long long>(uSum));
+    }
+}
+
+int main()
+{
+    std::vector<std::wstring> aszNames;
+    std::vector<StringId> aIds;
+    std::vector<uint32_t> auHandles;
+    std::unordered_map<std::wstring, uint32_t> stringMap;
+    std::unordered_map<StringId, uint32_t> idMap;
+    ResourceTable<uint32_t> table;
+
+    for (uint32_t i = 0u; i < NUM_NAMES; ++i)
+    {
+        aszNames.push_back(L"Renderable" + std::to_wstring(i));
+        aIds.push_back(StringId::Intern(aszNames.back()));
+        stringMap.emplace(aszNames.back(), i);
+        idMap.emplace(aIds.back(), i);
+        auHandles.push_back(table.Add(aIds.back(), i));
+    }
+
+    std::printf("%u names, %u lookups\n", NUM_NAMES, NUM_LOOKUPS);
+
+    run("wstring map from PCWSTR", [&](uint32_t i)
+    {
+        return stringMap[aszNames[i].c_str()];
+    });
+    run("StringId unordered_map", [&](uint32_t i)
+    {
+        return idMap.find(aIds[i])->second;
+    });
+    run("ResourceTable::TryGet", [&](uint32_t i)
+    {
+        return *table.TryGet(aIds[i]);
+    });
+    run("ResourceTable::Get(handle)", [&](uint32_t i)
+    {
+        return table.Get(auHandles[i]);
+    });
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*+===================================================================
+  File:      STRINGIDTESTS.CPP
+
+  Summary:   Checks name hashing, interning and resource tables
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "Utility/StringId.h"
+
+namespace
+{
+    using namespace library;
+
+    static_assert(L""_id.GetHash() == StringId::FNV_OFFSET_BASIS);
+    static_assert(!StringId().IsValid());
+    static_assert(L"Sponza"_id == StringId(std::wstring_view(L"Sponza")));
+
+    TEST(StringId, HashesUtf16LittleEndian)
+    {
+        // FNV-1a 64 of the UTF-16LE bytes, worked out independently
+        EXPECT_EQ(L"a"_id.GetHash(), 0x089BE207B544F1E4ull);
+        EXPECT_EQ(L"Sponza"_id.GetHash(), 0x707E173543C49EB4ull);
+        EXPECT_EQ(L"\u4E2D\u00E9"_id.GetHash(), 0x45A4198F08EC3203ull);
+    }
+
+    TEST(StringId, RuntimeMatchesLiteral)
+    {
+        std::wstring szName = L"Nanosuit";
+        EXPECT_EQ(StringId(szName), L"Nanosuit"_id);
+        EXPECT_NE(StringId(szName), L"nanosuit"_id);
+        EXPECT_EQ(std::hash<StringId>()(StringId(szName)), static_cast<size_t>(L"Nanosuit"_id.GetHash()));
+    }
+
+    TEST(StringId, GeneratedNamesDoNotCollide)
+    {
+        std::unordered_set<uint64_t> hashes;
+        for (uint32_t i = 0u; i < 100000u; ++i)
+        {
+            std::wstring szName = L"Cube" + std::to_wstring(i);
+            EXPECT_TRUE(hashes.insert(StringId(szName).GetHash()).second) << i;
+        }
+    }
+
+    TEST(StringId, InternKeepsTheString)
+    {
+        StringId id = StringId::Intern(L"StringIdTests.InternKeepsTheString");
+        EXPECT_EQ(id, L"StringIdTests.InternKeepsTheString"_id);
+        EXPECT_STREQ(id.GetString(), L"StringIdTests.InternKeepsTheString");
+        EXPECT_EQ(StringId::Intern(L"StringIdTests.InternKeepsTheString"), id);
+
+        EXPECT_STREQ(L"StringIdTests.NeverInterned"_id.GetString(), L"");
+    }
+
+    TEST(ResourceTable, HandlesAreDenseAndStable)
+    {
+        ResourceTable<std::unique_ptr<int>> table;
+        EXPECT_EQ(table.Add(L"First"_id, std::make_unique<int>(1)), 0u);
+        EXPECT_EQ(table.Add(L"Second"_id, std::make_unique<int>(2)), 1u);
+        int* pFirst = table.Get(0u).get();
+
+        for (int i = 0; i < 100; ++i)
+        {
+            table.Add(StringId(L"Filler" + std::to_wstring(i)), std::make_unique<int>(i));
+        }
+
+        EXPECT_EQ(table.GetSize(), 102u);
+        EXPECT_EQ(table.Find(L"First"_id), 0u);
+        EXPECT_EQ(table.Get(0u).get(), pFirst);
+        EXPECT_EQ(*table.Get(table.Find(L"Second"_id)), 2);
+        EXPECT_EQ(table.GetName(1u), L"Second"_id);
+
+        int sum = 0;
+        for (const std::unique_ptr<int>& pValue : table)
+        {
+            sum += *pValue;
+        }
+        EXPECT_EQ(sum, 3 + 99 * 100 / 2);
+    }
+
+    TEST(ResourceTable, RejectsTakenNamesAndMissesUnknownOnes)
+    {
+        ResourceTable<int> table;
+        EXPECT_EQ(table.Add(L"Cube"_id, 1), 0u);
+        EXPECT_EQ(table.Add(L"Cube"_id, 2), INVALID_RESOURCE_HANDLE);
+        EXPECT_EQ(table.GetSize(), 1u);
+        EXPECT_EQ(table.Get(0u), 1);
+
+        EXPECT_TRUE(table.Contains(L"Cube"_id));
+        EXPECT_FALSE(table.Contains(L"Sphere"_id));
+        EXPECT_EQ(table.Find(L"Sphere"_id), INVALID_RESOURCE_HANDLE);
+        EXPECT_EQ(table.TryGet(L"Sphere"_id), nullptr);
+        ASSERT_NE(table.TryGet(L"Cube"_id), nullptr);
+        EXPECT_EQ(*table.TryGet(L"Cube"_id), 1);
+    }
+}
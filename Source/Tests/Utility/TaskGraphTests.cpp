@@ -0,0 +1,77 @@
+/*+===================================================================
+  File:      TASKGRAPHTESTS.CPP
+
+  Summary:   Runs task graphs shaped like the stages of a frame and
+             checks that every task starts after the tasks it depends
+             on, on every run, and that a dependency on a task not
+             added before is rejected
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <gtest/gtest.h>
+
+#include "Utility/TaskGraph.h"
+
+namespace
+{
+    using namespace library;
+
+    TEST(TaskGraph, TasksStartAfterTheirDependencies)
+    {
+        JobSystem jobSystem(3u);
+        std::atomic<uint32_t> uNextStamp(0u);
+        std::vector<uint32_t> auStamps(7u);
+        auto stamp = [&uNextStamp, &auStamps](uint32_t uTask)
+        {
+            return [&uNextStamp, &auStamps, uTask]() { auStamps[uTask] = uNextStamp.fetch_add(1u); };
+        };
+
+        // Update fans out to culling and animation, which both feed the draw
+        // lists, and audio runs on its own
+        TaskGraph graph;
+        const uint32_t uUpdate = graph.AddTask("Update", stamp(0u));
+        const uint32_t uCull = graph.AddTask("Cull", stamp(1u), { uUpdate });
+        const uint32_t uAnimate = graph.AddTask("Animate", stamp(2u), { uUpdate });
+        const uint32_t uAudio = graph.AddTask("Audio", stamp(3u));
+        const uint32_t uDrawLists = graph.AddTask("DrawLists", stamp(4u), { uCull, uAnimate });
+        const uint32_t uSort = graph.AddTask("Sort", stamp(5u), { uDrawLists });
+        const uint32_t uSubmit = graph.AddTask("Submit", stamp(6u), { uSort, uAudio, uUpdate });
+        ASSERT_EQ(graph.GetNumTasks(), 7u);
+        ASSERT_EQ(uSubmit, 6u);
+
+        for (uint32_t uRun = 0u; uRun < 100u; ++uRun)
+        {
+            uNextStamp.store(0u);
+            graph.Run(jobSystem);
+
+            EXPECT_EQ(uNextStamp.load(), 7u);
+            EXPECT_LT(auStamps[uUpdate], auStamps[uCull]);
+            EXPECT_LT(auStamps[uUpdate], auStamps[uAnimate]);
+            EXPECT_LT(auStamps[uCull], auStamps[uDrawLists]);
+            EXPECT_LT(auStamps[uAnimate], auStamps[uDrawLists]);
+            EXPECT_LT(auStamps[uDrawLists], auStamps[uSort]);
+            EXPECT_LT(auStamps[uAudio], auStamps[uSubmit]);
+            EXPECT_EQ(auStamps[uSubmit], 6u);
+        }
+    }
+
+    TEST(TaskGraph, RejectsDependenciesOnLaterTasks)
+    {
+        TaskGraph graph;
+        const uint32_t uFirst = graph.AddTask("First", []() { });
+
+        uint32_t uSelf = 0u;
+        uint32_t uLater = 0u;
+        EXPECT_DEBUG_DEATH(uSelf = graph.AddTask("Self", []() { }, { uFirst, 1u }), "tasks added before it");
+        EXPECT_DEBUG_DEATH(uLater = graph.AddTask("Later", []() { }, { 5u }), "tasks added before it");
+#ifdef NDEBUG
+        EXPECT_EQ(uSelf, TaskGraph::INVALID_TASK);
+        EXPECT_EQ(uLater, TaskGraph::INVALID_TASK);
+#else
+        (void)uSelf;
+        (void)uLater;
+#endif
+        EXPECT_EQ(graph.GetNumTasks(), 1u);
+    }
+}
@@ -0,0 +1,512 @@
+/*+===================================================================
+  File:      MAIN.CPP
+
+  Summary:   Texture tool converts the PNG and JPG images of the
+             content directory to block compressed DDS files with full
+             mip chains, written next to the images for the materials
+             to refer to.
+             Reports the size, the PSNR and the encoding throughput of
+             every image, and benchmarks the mip generator.
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cwctype>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/DDSWriter.h"
+#include "Texture/MipBenchmark.h"
+#include "Texture/MipGenerator.h"
+#include "Texture/WicImageLoader.h"
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   ConversionOptions
+
+  Summary:  Options given on the command line
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct ConversionOptions
+{
+    library::eBlockFormat Format;
+    BOOL bAutoFormat;
+    BOOL bIsSrgb;
+    BOOL bOverwrite;
+    BOOL bGenerateMips;
+    library::eMipFilter MipFilter;
+    UINT uNumThreads;
+    UINT uNumRefinements;
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: printUsage
+
+  Summary:  Prints the command line usage
+-----------------------------------------------------------------F-F*/
+static void printUsage()
+{
+    wprintf(
+        L"Usage: TextureTool <image> [<output.dds>] [options]\n"
+        L"       TextureTool -batch <directory> [options]\n"
+        L"       TextureTool -benchmark [<image>]\n"
+        L"Options:\n"
+        L"  -format bc1|bc3|bc5  Block format, chosen per image by default:\n"
+        L"                       bc5 for normal maps, bc3 with alpha, bc1 otherwise\n"
+        L"  -srgb                Store colour formats as sRGB\n"
+        L"  -threads <n>         Number of encoding threads, 0 for all\n"
+        L"  -refine <n>          Least squares iterations of the colour endpoints\n"
+        L"  -mips kaiser|box|none  Mip filter, kaiser by default\n"
+        L"  -force               Convert images whose DDS file is up to date\n"
+    );
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: toLower
+
+  Summary:  Returns the lower case copy of a string
+
+  Args:     std::wstring sz
+              String to convert
+
+  Returns:  std::wstring
+              Lower case string
+-----------------------------------------------------------------F-F*/
+static std::wstring toLower(_In_ std::wstring sz)
+{
+    for (WCHAR& ch : sz)
+    {
+        ch = static_cast<WCHAR>(std::towlower(ch));
+    }
+
+    return sz;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: isImageFile
+
+  Summary:  Returns whether the file is an image the tool converts
+
+  Args:     const std::filesystem::path& filePath
+              Path to the file
+
+  Returns:  BOOL
+              TRUE for PNG, JPG, BMP and TGA files
+-----------------------------------------------------------------F-F*/
+static BOOL isImageFile(_In_ const std::filesystem::path& filePath)
+{
+    std::wstring szExtension = toLower(filePath.extension().wstring());
+
+    return szExtension == L".png" || szExtension == L".jpg" || szExtension == L".jpeg" || szExtension == L".bmp" || szExtension == L".tga";
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: chooseFormat
+
+  Summary:  Picks BC5 for normal maps, BC3 for images with alpha and
+            BC1 for everything else
+
+  Args:     const std::filesystem::path& filePath
+              Path to the image
+            const library::Image& image
+              Decoded image
+
+  Returns:  library::eBlockFormat
+              Block format
+-----------------------------------------------------------------F-F*/
+static library::eBlockFormat chooseFormat(_In_ const std::filesystem::path& filePath, _In_ const library::Image& image)
+{
+    if (library::MipGenerator::IsNormalMapPath(filePath))
+    {
+        return library::eBlockFormat::BC5;
+    }
+
+    for (size_t i = 3u; i < image.aPixels.size(); i += 4u)
+    {
+        if (image.aPixels[i] != 255u)
+        {
+            return library::eBlockFormat::BC3;
+        }
+    }
+
+    return library::eBlockFormat::BC1;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: convertFile
+
+  Summary:  Builds the mip chain of an image, encodes every level,
+            measures the result and writes the DDS file
+
+  Args:     const library::WicImageLoader& loader
+              Image decoder
+            const std::filesystem::path& inputPath
+              Path to the image
+            const std::filesystem::path& outputPath
+              Path to the DDS file
+            const ConversionOptions& options
+              Command line options
+
+  Returns:  HRESULT
+              Status code
+-----------------------------------------------------------------F-F*/
+static HRESULT convertFile(
+    _In_ const library::WicImageLoader& loader,
+    _In_ const std::filesystem::path& inputPath,
+    _In_ const std::filesystem::path& outputPath,
+    _In_ const ConversionOptions& options
+)
+{
+    library::Image image;
+    HRESULT hr = loader.Load(inputPath, image);
+    if (FAILED(hr))
+    {
+        fwprintf(stderr, L"%s: can't decode the image (0x%08lX)\n", inputPath.c_str(), static_cast<unsigned long>(hr));
+        return hr;
+    }
+
+    library::eBlockFormat format = options.bAutoFormat ? chooseFormat(inputPath, image) : options.Format;
+
+    library::BlockCompressor compressor(format);
+    compressor.SetNumThreads(options.uNumThreads);
+    compressor.SetNumRefinements(options.uNumRefinements);
+
+    library::MipGenerator mipGenerator(options.MipFilter);
+    mipGenerator.SetSrgb(format != library::eBlockFormat::BC5);
+    mipGenerator.SetNormalMap(format == library::eBlockFormat::BC5);
+    mipGenerator.SetNumThreads(options.uNumThreads);
+    mipGenerator.SetMaxNumMips(options.bGenerateMips ? 0u : 1u);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<library::Image> aImages;
+    mipGenerator.Generate(image, aImages);
+    std::chrono::duration<double> mipElapsed = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::vector<uint8_t>> aMips(aImages.size());
+    UINT64 uNumEncodedPixels = 0u;
+    for (size_t i = 0u; i < aImages.size(); ++i)
+    {
+        compressor.Compress(aImages[i], aMips[i]);
+        uNumEncodedPixels += static_cast<UINT64>(aImages[i].uWidth) * aImages[i].uHeight;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    library::Image decoded;
+    compressor.Decompress(image.uWidth, image.uHeight, aMips[0].data(), decoded);
+
+    UINT uChannelMask = library::BlockCompressor::CHANNEL_R | library::BlockCompressor::CHANNEL_G;
+    if (format != library::eBlockFormat::BC5)
+    {
+        uChannelMask |= library::BlockCompressor::CHANNEL_B;
+    }
+    if (format == library::eBlockFormat::BC3)
+    {
+        uChannelMask |= library::BlockCompressor::CHANNEL_A;
+    }
+
+    library::DDSImageDesc desc =
+    {
+        .uWidth = image.uWidth,
+        .uHeight = image.uHeight,
+        .uNumMips = static_cast<uint32_t>(aMips.size()),
+        .Format = library::DDSWriter::ToDDSFormat(format, options.bIsSrgb)
+    };
+
+    if (!library::DDSWriter::Write(outputPath, desc, aMips))
+    {
+        fwprintf(stderr, L"%s: can't write \"%s\"\n", inputPath.c_str(), outputPath.c_str());
+        return E_FAIL;
+    }
+
+    static constexpr const PCWSTR FORMAT_NAMES[] = { L"BC1", L"BC3", L"BC5" };
+
+    double sourceKiloBytes = static_cast<double>(image.aPixels.size()) / 1024.0;
+    double compressedKiloBytes = static_cast<double>(aMips[0].size()) / 1024.0;
+    double megaPixelsPerSecond = static_cast<double>(uNumEncodedPixels) / (elapsed.count() * 1.0e6);
+
+    wprintf(
+        L"%s: %ux%u %s %.1f KB -> %.1f KB (%.1fx), PSNR %.2f dB, %.1f MPix/s, %zu mips in %.1f ms\n",
+        inputPath.filename().c_str(),
+        image.uWidth,
+        image.uHeight,
+        FORMAT_NAMES[static_cast<size_t>(format)],
+        sourceKiloBytes,
+        compressedKiloBytes,
+        sourceKiloBytes / compressedKiloBytes,
+        library::BlockCompressor::ComputePsnr(image, decoded, uChannelMask),
+        megaPixelsPerSecond,
+        aMips.size(),
+        mipElapsed.count() * 1000.0
+    );
+
+    return S_OK;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: runBenchmark
+
+  Summary:  Times the mip generator on one image with every filter,
+            colour mode and thread count, and prints the time and the
+            throughput over the pixels of the source level
+
+  Args:     const library::Image& image
+              Source image
+
+  Returns:  INT
+              0
+-----------------------------------------------------------------F-F*/
+static INT runBenchmark(_In_ const library::Image& image)
+{
+    wprintf(L"Mip chain of %ux%u, best of %u runs, %u threads\n", image.uWidth, image.uHeight, library::MipBenchmark::NUM_REPETITIONS, library::MipBenchmark::GetNumThreads());
+
+    std::vector<library::MipBenchmarkResult> aResults;
+    library::MipBenchmark::Run(image, aResults);
+
+    for (const library::MipBenchmarkResult& result : aResults)
+    {
+        wprintf(
+            L"  %-6hs %-6hs %2u threads %8.1f ms %8.1f MPix/s\n",
+            result.pszFilter,
+            result.pszMode,
+            result.uNumThreads,
+            result.milliseconds,
+            result.megapixelsPerSecond
+        );
+    }
+
+    return 0;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: isUpToDate
+
+  Summary:  Returns whether the DDS file is newer than the image
+
+  Args:     const std::filesystem::path& inputPath
+              Path to the image
+            const std::filesystem::path& outputPath
+              Path to the DDS file
+
+  Returns:  BOOL
+              TRUE if the image needs no conversion
+-----------------------------------------------------------------F-F*/
+static BOOL isUpToDate(_In_ const std::filesystem::path& inputPath, _In_ const std::filesystem::path& outputPath)
+{
+    std::error_code errorCode;
+    if (!std::filesystem::exists(outputPath, errorCode))
+    {
+        return FALSE;
+    }
+
+    std::filesystem::file_time_type outputTime = std::filesystem::last_write_time(outputPath, errorCode);
+    if (errorCode)
+    {
+        return FALSE;
+    }
+
+    return std::filesystem::last_write_time(inputPath, errorCode) <= outputTime && !errorCode;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+
+  Summary:  Entry point of the texture tool
+
+  Args:     INT argc
+              Number of arguments
+            WCHAR* argv[]
+              Arguments
+
+  Returns:  INT
+              0 if every image was converted
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+    ConversionOptions options =
+    {
+        .Format = library::eBlockFormat::BC1,
+        .bAutoFormat = TRUE,
+        .bIsSrgb = FALSE,
+        .bOverwrite = FALSE,
+        .bGenerateMips = TRUE,
+        .MipFilter = library::eMipFilter::KAISER,
+        .uNumThreads = 0u,
+        .uNumRefinements = library::BlockCompressor::DEFAULT_NUM_REFINEMENTS
+    };
+
+    std::vector<std::filesystem::path> aPaths;
+    BOOL bBatch = FALSE;
+    BOOL bBenchmark = FALSE;
+
+    for (INT i = 1; i < argc; ++i)
+    {
+        std::wstring szArgument = toLower(argv[i]);
+
+        if (szArgument == L"-batch")
+        {
+            bBatch = TRUE;
+        }
+        else if (szArgument == L"-benchmark")
+        {
+            bBenchmark = TRUE;
+        }
+        else if (szArgument == L"-srgb")
+        {
+            options.bIsSrgb = TRUE;
+        }
+        else if (szArgument == L"-force")
+        {
+            options.bOverwrite = TRUE;
+        }
+        else if (szArgument == L"-format" && i + 1 < argc)
+        {
+            std::wstring szFormat = toLower(argv[++i]);
+            options.bAutoFormat = FALSE;
+            if (szFormat == L"bc1")
+            {
+                options.Format = library::eBlockFormat::BC1;
+            }
+            else if (szFormat == L"bc3")
+            {
+                options.Format = library::eBlockFormat::BC3;
+            }
+            else if (szFormat == L"bc5")
+            {
+                options.Format = library::eBlockFormat::BC5;
+            }
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (szArgument == L"-mips" && i + 1 < argc)
+        {
+            std::wstring szFilter = toLower(argv[++i]);
+            options.bGenerateMips = szFilter != L"none";
+            if (szFilter == L"kaiser")
+            {
+                options.MipFilter = library::eMipFilter::KAISER;
+            }
+            else if (szFilter == L"box")
+            {
+                options.MipFilter = library::eMipFilter::BOX;
+            }
+            else if (szFilter != L"none")
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (szArgument == L"-threads" && i + 1 < argc)
+        {
+            options.uNumThreads = static_cast<UINT>(_wtoi(argv[++i]));
+        }
+        else if (szArgument == L"-refine" && i + 1 < argc)
+        {
+            options.uNumRefinements = static_cast<UINT>(_wtoi(argv[++i]));
+        }
+        else if (!szArgument.empty() && szArgument[0] == L'-')
+        {
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            aPaths.emplace_back(argv[i]);
+        }
+    }
+
+    if (bBenchmark && aPaths.empty())
+    {
+        library::Image image;
+        library::MipBenchmark::MakeImage(image);
+
+        return runBenchmark(image);
+    }
+
+    if (aPaths.empty() || (!bBatch && aPaths.size() > 2u) || (bBenchmark && (bBatch || aPaths.size() > 1u)))
+    {
+        printUsage();
+        return 1;
+    }
+
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(hr))
+    {
+        return 1;
+    }
+
+    INT nResult = 0;
+    {
+        library::WicImageLoader loader;
+        hr = loader.Initialize();
+        if (FAILED(hr))
+        {
+            fwprintf(stderr, L"Can't create the WIC imaging factory\n");
+            CoUninitialize();
+            return 1;
+        }
+
+        if (bBenchmark)
+        {
+            library::Image image;
+            hr = loader.Load(aPaths[0], image);
+            if (FAILED(hr))
+            {
+                fwprintf(stderr, L"%s: can't decode the image (0x%08lX)\n", aPaths[0].c_str(), static_cast<unsigned long>(hr));
+                nResult = 1;
+            }
+            else
+            {
+                nResult = runBenchmark(image);
+            }
+        }
+        else if (bBatch)
+        {
+            for (const std::filesystem::path& directory : aPaths)
+            {
+                std::error_code errorCode;
+                for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(directory, errorCode))
+                {
+                    if (!entry.is_regular_file() || !isImageFile(entry.path()))
+                    {
+                        continue;
+                    }
+
+                    std::filesystem::path outputPath = entry.path();
+                    outputPath.replace_extension(L".dds");
+
+                    if (!options.bOverwrite && isUpToDate(entry.path(), outputPath))
+                    {
+                        continue;
+                    }
+
+                    if (FAILED(convertFile(loader, entry.path(), outputPath, options)))
+                    {
+                        nResult = 1;
+                    }
+                }
+            }
+        }
+        else
+        {
+            std::filesystem::path outputPath = aPaths.size() > 1u ? aPaths[1] : aPaths[0];
+            if (aPaths.size() == 1u)
+            {
+                outputPath.replace_extension(L".dds");
+            }
+
+            if (FAILED(convertFile(loader, aPaths[0], outputPath, options)))
+            {
+                nResult = 1;
+            }
+        }
+    }
+
+    CoUninitialize();
+
+    return nResult;
+}